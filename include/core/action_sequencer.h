@@ -0,0 +1,133 @@
+/**
+ * @file action_sequencer.h
+ * @brief Cooperative, timer-driven sequencer for plugin op lists.
+ *
+ * Plugin actions are compiled at load time (PluginManager) into a flat
+ * list of 8-byte SeqOp records.  The sequencer runs several such lists at
+ * once: poll() executes every op that is due and returns how long the
+ * caller may sleep until the next one, so a one-shot timer re-armed with
+ * that value drives it without ever blocking the Core task.
+ *
+ * Waits are scheduled from the previous deadline rather than from the
+ * time poll() happened to run, so a late wake-up shortens the next wait
+ * instead of accumulating: a 100 × 500 µs toggle train ends within one
+ * timer latency of 50 ms.
+ *
+ * Hardware access goes through SeqBackend, so the sequencer runs on the
+ * host against a fake backend (tools/action_sequencer_bench.cpp).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::core {
+
+// ── Ops ──────────────────────────────────────────────────────────────────────
+
+enum class SeqOpCode : uint8_t
+{
+    PIN_HIGH,     ///< Drive pin HIGH
+    PIN_LOW,      ///< Drive pin LOW
+    PIN_TOGGLE,   ///< Invert the pin's output level
+    TONE,         ///< Square wave of arg Hz on pin (0 = off)
+    WAIT_US,      ///< Resume arg µs after the previous deadline
+    NOTE,         ///< Informational (log / frequency), arg passed through
+};
+
+/// @brief One compiled op.
+struct SeqOp
+{
+    SeqOpCode code;
+    uint8_t pin;
+    uint16_t aux;    ///< NOTE: caller-defined (e.g. source action index)
+    uint32_t arg;
+};
+
+/// @brief Hardware seen by the sequencer.
+class SeqBackend
+{
+public:
+    virtual ~SeqBackend() = default;
+    /// Free-running µs clock (wraps; only differences are used).
+    virtual uint32_t nowUs() = 0;
+    virtual void pinWrite(uint8_t pin, bool high) = 0;
+    virtual bool pinLevel(uint8_t pin) = 0;
+    /// @return false if no tone generator is free for @p pin.
+    virtual bool tone(uint8_t pin, uint32_t hz) = 0;
+    virtual void note(uint16_t tag, const SeqOp &op) { (void)tag; (void)op; }
+};
+
+// ── ActionSequencer ──────────────────────────────────────────────────────────
+
+class ActionSequencer
+{
+public:
+    static constexpr size_t MAX_TASKS = 4U;
+    static constexpr uint32_t IDLE = UINT32_MAX;   ///< poll(): nothing pending
+    static constexpr int INVALID = -1;
+
+    explicit ActionSequencer(SeqBackend &backend);
+
+    /**
+     * @brief Start running @p ops (valid until it finishes or is cancelled).
+     * @param tag  Caller id for cancelTag() / running() / notes.
+     * @return Task handle, or INVALID when all MAX_TASKS slots are busy.
+     *
+     * The first ops run on the next poll().
+     */
+    int start(const SeqOp *ops, size_t count, uint16_t tag);
+
+    /**
+     * @brief Stop a task; tones it started are switched off.
+     *
+     * A task that runs to its end leaves its pins as they are, so a TONE
+     * without a following TONE 0 keeps sounding (like a single action).
+     */
+    void cancel(int handle);
+
+    /// @brief Cancel every task started with @p tag.
+    void cancelTag(uint16_t tag);
+
+    void cancelAll();
+
+    bool running(int handle) const;
+    bool runningTag(uint16_t tag) const;
+    size_t active() const;
+
+    /**
+     * @brief Execute everything that is due.
+     * @return µs until the next deadline (0 = call again now), or IDLE.
+     */
+    uint32_t poll();
+
+    /// @brief Largest lateness of any wait so far (µs), for diagnostics.
+    uint32_t maxLateUs() const { return maxLateUs_; }
+
+private:
+    struct Task
+    {
+        const SeqOp *ops;
+        size_t count;
+        size_t pc;
+        uint32_t due;        ///< Deadline of the next op
+        uint64_t tonePins;   ///< Pins with a tone started by this task
+        uint16_t tag;
+        uint16_t gen;        ///< Bumped per start so stale handles miss
+        bool busy;
+    };
+
+    /// Run @p t until it waits or ends; false when it ended.
+    bool step(Task &t, uint32_t now);
+    /// Free the slot; @p silence switches off the task's tones (cancel).
+    void stop(Task &t, bool silence);
+    Task *lookup(int handle);
+    const Task *lookup(int handle) const;
+
+    SeqBackend &backend_;
+    Task tasks_[MAX_TASKS];
+    uint32_t maxLateUs_;
+};
+
+} // namespace hackos::core
@@ -0,0 +1,55 @@
+/**
+ * @file container_check.h
+ * @brief Debug-only precondition checks for the fixed-capacity containers.
+ *
+ * HACKOS_CONTAINER_CHECK(cond, what) compiles to nothing in normal builds
+ * and to "log and abort" when HACKOS_CONTAINER_CHECKS is 1 – by default
+ * when HACKOS_DEBUG is defined (the esp32dev-debug environment).  Only
+ * programming errors are checked this way: an index past size(), front()
+ * of an empty container, linking a node twice.  Running out of capacity
+ * is an expected condition and is reported by the bool return of the
+ * inserting call instead.
+ *
+ * The checks sit in constexpr functions too; a failing one in a constant
+ * expression is a compile error because containerCheckFailed() is not
+ * constexpr.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef HACKOS_CONTAINER_CHECKS
+#ifdef HACKOS_DEBUG
+#define HACKOS_CONTAINER_CHECKS 1
+#else
+#define HACKOS_CONTAINER_CHECKS 0
+#endif
+#endif
+
+namespace hackos::core {
+
+[[noreturn]] inline void containerCheckFailed(const char *what, const char *file, int line)
+{
+    std::printf("container check failed: %s (%s:%d)\n", what, file, line);
+    std::abort();
+}
+
+} // namespace hackos::core
+
+#if HACKOS_CONTAINER_CHECKS
+#define HACKOS_CONTAINER_CHECK(cond, what)                                      \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            ::hackos::core::containerCheckFailed(what, __FILE__, __LINE__);     \
+        }                                                                       \
+    } while (false)
+#else
+#define HACKOS_CONTAINER_CHECK(cond, what) \
+    do                                     \
+    {                                      \
+    } while (false)
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file fixed_hash_map.h
+ * @brief Open-addressing hash map in a fixed slot array: O(1) expected
+ *        lookup, insert and erase, no heap.
+ *
+ *  - N slots, a power of two; at most MAX_SIZE = 3/4 N entries so probe
+ *    chains stay short – insert() returns false beyond that
+ *  - linear probing; erase() shifts the following chain back instead of
+ *    leaving tombstones, so lookups never slow down with churn
+ *  - FixedHash<K> covers integers, enums, pointers and InlineString;
+ *    pass another Hash for other keys
+ *
+ * Keys and values must be trivially copyable.  Iteration order is the
+ * slot order, i.e. unspecified.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "core/containers/inline_string.h"
+
+namespace hackos::core {
+
+// ── FixedHash ────────────────────────────────────────────────────────────────
+
+/// @brief 32-bit finaliser (murmur3 fmix32): every input bit moves every
+///        output bit, so sequential ids spread over the slots.
+constexpr uint32_t hashMix(uint32_t h)
+{
+    h ^= h >> 16U;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13U;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16U;
+    return h;
+}
+
+template <typename K>
+struct FixedHash
+{
+    constexpr uint32_t operator()(const K &key) const
+    {
+        if constexpr (std::is_pointer<K>::value)
+        {
+            return hashMix(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(key)));
+        }
+        else if constexpr (std::is_enum<K>::value)
+        {
+            return hashMix(static_cast<uint32_t>(key));
+        }
+        else
+        {
+            static_assert(std::is_integral<K>::value, "no FixedHash for this key type");
+            if constexpr (sizeof(K) > sizeof(uint32_t))
+            {
+                const uint64_t v = static_cast<uint64_t>(key);
+                return hashMix(static_cast<uint32_t>(v) ^ hashMix(static_cast<uint32_t>(v >> 32U)));
+            }
+            else
+            {
+                return hashMix(static_cast<uint32_t>(key));
+            }
+        }
+    }
+};
+
+/// FNV-1a over the characters.
+template <size_t M>
+struct FixedHash<InlineString<M>>
+{
+    constexpr uint32_t operator()(const InlineString<M> &key) const
+    {
+        uint32_t h = 2166136261U;
+        for (const char c : key)
+        {
+            h = (h ^ static_cast<uint8_t>(c)) * 16777619U;
+        }
+        return h;
+    }
+};
+
+// ── FixedHashMap ─────────────────────────────────────────────────────────────
+
+template <typename K, typename V, size_t N, typename Hash = FixedHash<K>,
+          typename Eq = std::equal_to<K>>
+class FixedHashMap
+{
+    static_assert(N >= 4U && (N & (N - 1U)) == 0U, "FixedHashMap slots must be a power of two >= 4");
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "FixedHashMap keys and values must be trivially copyable");
+
+public:
+    static constexpr size_t SLOTS = N;
+    static constexpr size_t MAX_SIZE = N - N / 4U;
+
+    constexpr FixedHashMap() : keys_{}, values_{}, used_{}, size_(0U) {}
+
+    // ── Capacity ─────────────────────────────────────────────────────────
+
+    static constexpr size_t capacity() { return MAX_SIZE; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0U; }
+    constexpr bool full() const { return size_ == MAX_SIZE; }
+
+    // ── Lookup ───────────────────────────────────────────────────────────
+
+    /// @return The value of @p key, nullptr if absent.
+    constexpr V *find(const K &key)
+    {
+        const size_t s = slotOf(key);
+        return (s < N) ? &values_[s] : nullptr;
+    }
+
+    constexpr const V *find(const K &key) const
+    {
+        const size_t s = slotOf(key);
+        return (s < N) ? &values_[s] : nullptr;
+    }
+
+    constexpr bool contains(const K &key) const { return slotOf(key) < N; }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    /// @brief Add @p key if absent.
+    /// @return false if @p key is present or the map is full.
+    constexpr bool insert(const K &key, const V &value)
+    {
+        size_t s = home(key);
+        for (; used_[s]; s = (s + 1U) & MASK)
+        {
+            if (Eq()(keys_[s], key))
+            {
+                return false;
+            }
+        }
+        if (size_ == MAX_SIZE)
+        {
+            return false;
+        }
+        keys_[s] = key;
+        values_[s] = value;
+        used_[s] = true;
+        ++size_;
+        return true;
+    }
+
+    /// @brief Add or overwrite @p key.
+    /// @return false only if @p key is absent and the map is full.
+    constexpr bool set(const K &key, const V &value)
+    {
+        V *v = find(key);
+        if (v != nullptr)
+        {
+            *v = value;
+            return true;
+        }
+        return insert(key, value);
+    }
+
+    /// @return false if @p key was absent.
+    constexpr bool erase(const K &key)
+    {
+        size_t hole = slotOf(key);
+        if (hole >= N)
+        {
+            return false;
+        }
+        // Backward shift: a later entry of the chain moves into the hole
+        // if its home slot lies (cyclically) at or before the hole.
+        for (size_t s = (hole + 1U) & MASK; used_[s]; s = (s + 1U) & MASK)
+        {
+            const size_t h = home(keys_[s]);
+            if (((s - h) & MASK) >= ((s - hole) & MASK))
+            {
+                keys_[hole] = keys_[s];
+                values_[hole] = values_[s];
+                hole = s;
+            }
+        }
+        used_[hole] = false;
+        --size_;
+        return true;
+    }
+
+    constexpr void clear()
+    {
+        for (bool &u : used_)
+        {
+            u = false;
+        }
+        size_ = 0U;
+    }
+
+    // ── Iteration ────────────────────────────────────────────────────────
+
+    /// @brief Call @p fn(key, value) for every entry, in slot order.
+    template <typename Fn>
+    constexpr void forEach(Fn fn) const
+    {
+        for (size_t s = 0U; s < N; ++s)
+        {
+            if (used_[s])
+            {
+                fn(keys_[s], values_[s]);
+            }
+        }
+    }
+
+    /// @brief Longest probe distance of any entry (diagnostics).
+    constexpr size_t maxProbe() const
+    {
+        size_t worst = 0U;
+        for (size_t s = 0U; s < N; ++s)
+        {
+            if (used_[s])
+            {
+                const size_t d = (s - home(keys_[s])) & MASK;
+                worst = (d > worst) ? d : worst;
+            }
+        }
+        return worst;
+    }
+
+private:
+    static constexpr size_t MASK = N - 1U;
+
+    static constexpr size_t home(const K &key) { return static_cast<size_t>(Hash()(key)) & MASK; }
+
+    /// Slot holding @p key, N if absent.  A free slot ends the chain; the
+    /// load cap guarantees there is one.
+    constexpr size_t slotOf(const K &key) const
+    {
+        for (size_t s = home(key); used_[s]; s = (s + 1U) & MASK)
+        {
+            if (Eq()(keys_[s], key))
+            {
+                return s;
+            }
+        }
+        return N;
+    }
+
+    K keys_[N];
+    V values_[N];
+    bool used_[N];
+    size_t size_;
+};
+
+} // namespace hackos::core
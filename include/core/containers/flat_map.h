@@ -0,0 +1,132 @@
+/**
+ * @file flat_map.h
+ * @brief Sorted array map: O(log n) lookup, O(n) insert / erase, no heap.
+ *
+ * The right table for a few dozen entries that are looked up far more
+ * often than changed (device tables keyed by MAC, settings by name):
+ * entries sit contiguously in key order, lookup is a binary search and
+ * iteration is in order.  For large or churning tables use FixedHashMap.
+ *
+ * Keys and values must be trivially copyable (InlineString qualifies);
+ * Less orders the keys.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "core/containers/static_vector.h"
+
+namespace hackos::core {
+
+template <typename K, typename V, size_t N, typename Less = std::less<K>>
+class FlatMap
+{
+public:
+    struct Entry
+    {
+        K key;
+        V value;
+    };
+
+    constexpr FlatMap() : entries_() {}
+
+    // ── Capacity ─────────────────────────────────────────────────────────
+
+    static constexpr size_t capacity() { return N; }
+    constexpr size_t size() const { return entries_.size(); }
+    constexpr bool empty() const { return entries_.empty(); }
+    constexpr bool full() const { return entries_.full(); }
+
+    // ── Lookup ───────────────────────────────────────────────────────────
+
+    /// @return The value of @p key, nullptr if absent.
+    constexpr V *find(const K &key)
+    {
+        const size_t i = lowerBound(key);
+        return (i < size() && equal(entries_[i].key, key)) ? &entries_[i].value : nullptr;
+    }
+
+    constexpr const V *find(const K &key) const
+    {
+        const size_t i = lowerBound(key);
+        return (i < size() && equal(entries_[i].key, key)) ? &entries_[i].value : nullptr;
+    }
+
+    constexpr bool contains(const K &key) const { return find(key) != nullptr; }
+
+    /// @brief Index of the first entry not less than @p key.
+    constexpr size_t lowerBound(const K &key) const
+    {
+        size_t lo = 0U;
+        size_t hi = size();
+        while (lo < hi)
+        {
+            const size_t mid = lo + (hi - lo) / 2U;
+            if (Less()(entries_[mid].key, key))
+            {
+                lo = mid + 1U;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    /// @brief Entry @p i in key order.
+    constexpr const Entry &at(size_t i) const { return entries_[i]; }
+
+    constexpr const Entry *begin() const { return entries_.begin(); }
+    constexpr const Entry *end() const { return entries_.end(); }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    /// @brief Add @p key if absent.
+    /// @return false if @p key is present or the map is full.
+    constexpr bool insert(const K &key, const V &value)
+    {
+        const size_t i = lowerBound(key);
+        if (i < size() && equal(entries_[i].key, key))
+        {
+            return false;
+        }
+        return entries_.insert(i, Entry{key, value});
+    }
+
+    /// @brief Add or overwrite @p key.
+    /// @return false only if @p key is absent and the map is full.
+    constexpr bool set(const K &key, const V &value)
+    {
+        const size_t i = lowerBound(key);
+        if (i < size() && equal(entries_[i].key, key))
+        {
+            entries_[i].value = value;
+            return true;
+        }
+        return entries_.insert(i, Entry{key, value});
+    }
+
+    /// @return false if @p key was absent.
+    constexpr bool erase(const K &key)
+    {
+        const size_t i = lowerBound(key);
+        if (i < size() && equal(entries_[i].key, key))
+        {
+            entries_.erase(i);
+            return true;
+        }
+        return false;
+    }
+
+    constexpr void clear() { entries_.clear(); }
+
+private:
+    static constexpr bool equal(const K &a, const K &b) { return !Less()(a, b) && !Less()(b, a); }
+
+    StaticVector<Entry, N> entries_;
+};
+
+} // namespace hackos::core
@@ -0,0 +1,193 @@
+/**
+ * @file inline_string.h
+ * @brief Fixed-capacity NUL-terminated string stored in place.
+ *
+ * Replaces "char name_[N]; strncpy(name_, src, N - 1); name_[N - 1] = 0;".
+ * InlineString<N> holds up to N characters plus the terminator, always
+ * NUL-terminated; assign() / append() copy what fits and return false if
+ * they had to truncate, so callers that care can tell.  Comparison is
+ * against other InlineStrings and plain C strings.
+ *
+ * Everything except appendf() is constexpr.
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+#include "core/containers/container_check.h"
+
+namespace hackos::core {
+
+template <size_t N>
+class InlineString
+{
+    static_assert(N > 0U, "InlineString capacity must be > 0");
+
+public:
+    constexpr InlineString() : buf_{}, len_(0U) {}
+
+    /// @brief From a C string, truncated to N (implicit so C strings can
+    ///        be passed as keys).
+    constexpr InlineString(const char *s) : buf_{}, len_(0U)
+    {
+        (void)append(s);
+    }
+
+    // ── Capacity ─────────────────────────────────────────────────────────
+
+    static constexpr size_t capacity() { return N; }
+    constexpr size_t size() const { return len_; }
+    constexpr bool empty() const { return len_ == 0U; }
+    constexpr bool full() const { return len_ == N; }
+
+    // ── Access ───────────────────────────────────────────────────────────
+
+    constexpr const char *c_str() const { return buf_; }
+
+    constexpr char operator[](size_t i) const
+    {
+        HACKOS_CONTAINER_CHECK(i < len_, "InlineString index out of range");
+        return buf_[i];
+    }
+
+    constexpr const char *begin() const { return buf_; }
+    constexpr const char *end() const { return buf_ + len_; }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    /// @return false if @p s was truncated.
+    constexpr bool assign(const char *s)
+    {
+        clear();
+        return append(s);
+    }
+
+    /// @return false if @p s was truncated.
+    constexpr bool append(const char *s)
+    {
+        if (s == nullptr)
+        {
+            return true;
+        }
+        while (*s != '\0' && len_ < N)
+        {
+            buf_[len_++] = *s++;
+        }
+        buf_[len_] = '\0';
+        return *s == '\0';
+    }
+
+    /// @return false if full.
+    constexpr bool push(char c)
+    {
+        if (len_ == N || c == '\0')
+        {
+            return false;
+        }
+        buf_[len_++] = c;
+        buf_[len_] = '\0';
+        return true;
+    }
+
+    /// @brief printf-style append.
+    /// @return false if the output was truncated.
+    bool appendf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        const int n = std::vsnprintf(buf_ + len_, N + 1U - len_, fmt, ap);
+        va_end(ap);
+        if (n < 0)
+        {
+            buf_[len_] = '\0';
+            return false;
+        }
+        const size_t want = len_ + static_cast<size_t>(n);
+        len_ = (want > N) ? N : want;
+        return want <= N;
+    }
+
+    /// @brief Cut to @p len characters (no-op if already shorter).
+    constexpr void truncate(size_t len)
+    {
+        if (len < len_)
+        {
+            len_ = len;
+            buf_[len_] = '\0';
+        }
+    }
+
+    constexpr void clear() { truncate(0U); }
+
+    // ── Comparison ───────────────────────────────────────────────────────
+
+    constexpr bool equals(const char *s) const
+    {
+        if (s == nullptr)
+        {
+            return false;
+        }
+        size_t i = 0U;
+        for (; i < len_; ++i)
+        {
+            if (s[i] != buf_[i])
+            {
+                return false;
+            }
+        }
+        return s[i] == '\0';
+    }
+
+    constexpr bool startsWith(const char *prefix) const
+    {
+        if (prefix == nullptr)
+        {
+            return false;
+        }
+        for (size_t i = 0U; prefix[i] != '\0'; ++i)
+        {
+            if (i >= len_ || prefix[i] != buf_[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief strcmp() order.
+    template <size_t M>
+    constexpr int compare(const InlineString<M> &other) const
+    {
+        const char *a = c_str();
+        const char *b = other.c_str();
+        for (; *a != '\0' && *a == *b; ++a, ++b)
+        {
+        }
+        return static_cast<int>(static_cast<unsigned char>(*a)) -
+               static_cast<int>(static_cast<unsigned char>(*b));
+    }
+
+    constexpr bool operator==(const char *s) const { return equals(s); }
+    constexpr bool operator!=(const char *s) const { return !equals(s); }
+
+    template <size_t M>
+    constexpr bool operator==(const InlineString<M> &other) const
+    {
+        return len_ == other.size() && equals(other.c_str());
+    }
+
+    template <size_t M>
+    constexpr bool operator!=(const InlineString<M> &other) const { return !(*this == other); }
+
+    template <size_t M>
+    constexpr bool operator<(const InlineString<M> &other) const { return compare(other) < 0; }
+
+private:
+    char buf_[N + 1U];
+    size_t len_;
+};
+
+} // namespace hackos::core
@@ -0,0 +1,149 @@
+/**
+ * @file intrusive_list.h
+ * @brief Doubly linked list through a node embedded in the elements.
+ *
+ * For objects that already live somewhere else (static apps, plugins,
+ * timers) and need to be on a list: the links are an IntrusiveNode
+ * member, so linking never allocates or copies, and unlinking a known
+ * element is O(1) – no search, no shifting.  The list does not own its
+ * elements; an element must be removed before it is destroyed.
+ *
+ * @code
+ *  struct Plugin { IntrusiveNode link; const char *name; };
+ *  IntrusiveList<Plugin, &Plugin::link> loaded;
+ *  loaded.pushBack(p);
+ *  for (Plugin &q : loaded) { … }
+ *  loaded.remove(p);
+ * @endcode
+ *
+ * An element can be on one list per IntrusiveNode member.  Copying a
+ * linked element copies its links, so don't.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "core/containers/container_check.h"
+
+namespace hackos::core {
+
+/// @brief Link member for IntrusiveList.
+struct IntrusiveNode
+{
+    IntrusiveNode *prev = nullptr;
+    IntrusiveNode *next = nullptr;
+    void *owner = nullptr;   ///< Element while linked, nullptr otherwise
+};
+
+template <typename T, IntrusiveNode T::*Link>
+class IntrusiveList
+{
+public:
+    class Iterator
+    {
+    public:
+        constexpr explicit Iterator(IntrusiveNode *n) : node_(n) {}
+        T &operator*() const { return *owner(node_); }
+        T *operator->() const { return owner(node_); }
+        constexpr Iterator &operator++()
+        {
+            node_ = node_->next;
+            return *this;
+        }
+        constexpr bool operator!=(const Iterator &o) const { return node_ != o.node_; }
+        constexpr bool operator==(const Iterator &o) const { return node_ == o.node_; }
+
+    private:
+        IntrusiveNode *node_;
+    };
+
+    constexpr IntrusiveList() : head_(nullptr), tail_(nullptr), size_(0U) {}
+
+    IntrusiveList(const IntrusiveList &) = delete;
+    IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0U; }
+
+    T &front() const
+    {
+        HACKOS_CONTAINER_CHECK(head_ != nullptr, "IntrusiveList front of empty list");
+        return *owner(head_);
+    }
+
+    T &back() const
+    {
+        HACKOS_CONTAINER_CHECK(tail_ != nullptr, "IntrusiveList back of empty list");
+        return *owner(tail_);
+    }
+
+    constexpr Iterator begin() const { return Iterator(head_); }
+    constexpr Iterator end() const { return Iterator(nullptr); }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    constexpr void pushBack(T &item) { link(tail_, item); }
+    constexpr void pushFront(T &item) { link(nullptr, item); }
+
+    /// @brief Link @p item right after @p pos (already on this list).
+    constexpr void insertAfter(T &pos, T &item) { link(&node(pos), item); }
+
+    /// @brief Unlink @p item (on this list).
+    constexpr void remove(T &item)
+    {
+        IntrusiveNode &n = node(item);
+        HACKOS_CONTAINER_CHECK(n.owner == &item, "IntrusiveList remove of unlinked node");
+        (n.prev != nullptr ? n.prev->next : head_) = n.next;
+        (n.next != nullptr ? n.next->prev : tail_) = n.prev;
+        n.prev = nullptr;
+        n.next = nullptr;
+        n.owner = nullptr;
+        --size_;
+    }
+
+    /// @return The first element, unlinked; nullptr if empty.
+    T *popFront()
+    {
+        if (head_ == nullptr)
+        {
+            return nullptr;
+        }
+        T *item = owner(head_);
+        remove(*item);
+        return item;
+    }
+
+    /// @brief True if @p item is on a list through this node member.
+    static constexpr bool linked(const T &item) { return (item.*Link).owner != nullptr; }
+
+    void clear()
+    {
+        while (popFront() != nullptr)
+        {
+        }
+    }
+
+private:
+    static constexpr IntrusiveNode &node(T &item) { return item.*Link; }
+
+    static T *owner(IntrusiveNode *n) { return static_cast<T *>(n->owner); }
+
+    constexpr void link(IntrusiveNode *pos, T &item)
+    {
+        IntrusiveNode &n = node(item);
+        HACKOS_CONTAINER_CHECK(n.owner == nullptr, "IntrusiveList node already linked");
+        n.owner = &item;
+        n.prev = pos;
+        n.next = (pos != nullptr) ? pos->next : head_;
+        (n.next != nullptr ? n.next->prev : tail_) = &n;
+        (pos != nullptr ? pos->next : head_) = &n;
+        ++size_;
+    }
+
+    IntrusiveNode *head_;
+    IntrusiveNode *tail_;
+    size_t size_;
+};
+
+} // namespace hackos::core
@@ -0,0 +1,162 @@
+/**
+ * @file ring_deque.h
+ * @brief Fixed-capacity double-ended queue over a circular array.
+ *
+ * push / pop at both ends in O(1), indexed access from the front, and all
+ * N slots usable (a count, not a spare slot, tells full from empty).  The
+ * typical users are "last N" histories that drop the oldest entry
+ * (pushBackOverwrite()) and work queues that sometimes put an item back
+ * at the front.
+ *
+ * Single-threaded; for the ISR → task path use radio::RingBuffer.
+ * Elements must be trivially copyable; everything is constexpr.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "core/containers/container_check.h"
+
+namespace hackos::core {
+
+template <typename T, size_t N>
+class RingDeque
+{
+    static_assert(N > 0U, "RingDeque capacity must be > 0");
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "RingDeque elements must be trivially copyable");
+
+public:
+    constexpr RingDeque() : data_{}, head_(0U), size_(0U) {}
+
+    // ── Capacity ─────────────────────────────────────────────────────────
+
+    static constexpr size_t capacity() { return N; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0U; }
+    constexpr bool full() const { return size_ == N; }
+
+    // ── Access ───────────────────────────────────────────────────────────
+
+    /// @brief Element @p i counted from the front.
+    constexpr T &operator[](size_t i)
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "RingDeque index out of range");
+        return data_[wrap(head_ + i)];
+    }
+
+    constexpr const T &operator[](size_t i) const
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "RingDeque index out of range");
+        return data_[wrap(head_ + i)];
+    }
+
+    constexpr T &front() { return (*this)[0U]; }
+    constexpr const T &front() const { return (*this)[0U]; }
+    constexpr T &back() { return (*this)[size_ - 1U]; }
+    constexpr const T &back() const { return (*this)[size_ - 1U]; }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    /// @return false if full.
+    constexpr bool pushBack(const T &value)
+    {
+        if (size_ == N)
+        {
+            return false;
+        }
+        data_[wrap(head_ + size_)] = value;
+        ++size_;
+        return true;
+    }
+
+    /// @return false if full.
+    constexpr bool pushFront(const T &value)
+    {
+        if (size_ == N)
+        {
+            return false;
+        }
+        head_ = (head_ == 0U) ? N - 1U : head_ - 1U;
+        data_[head_] = value;
+        ++size_;
+        return true;
+    }
+
+    /// @brief Append, dropping the front element if full.
+    /// @return true if an element was dropped.
+    constexpr bool pushBackOverwrite(const T &value)
+    {
+        const bool dropped = size_ == N;
+        if (dropped)
+        {
+            (void)popFront();
+        }
+        (void)pushBack(value);
+        return dropped;
+    }
+
+    /// @return false if empty.
+    constexpr bool popFront()
+    {
+        if (size_ == 0U)
+        {
+            return false;
+        }
+        head_ = wrap(head_ + 1U);
+        --size_;
+        return true;
+    }
+
+    /// @brief Pop the front element into @p out.
+    /// @return false if empty.
+    constexpr bool popFront(T &out)
+    {
+        if (size_ == 0U)
+        {
+            return false;
+        }
+        out = data_[head_];
+        return popFront();
+    }
+
+    /// @return false if empty.
+    constexpr bool popBack()
+    {
+        if (size_ == 0U)
+        {
+            return false;
+        }
+        --size_;
+        return true;
+    }
+
+    /// @brief Pop the back element into @p out.
+    /// @return false if empty.
+    constexpr bool popBack(T &out)
+    {
+        if (size_ == 0U)
+        {
+            return false;
+        }
+        out = data_[wrap(head_ + size_ - 1U)];
+        return popBack();
+    }
+
+    constexpr void clear()
+    {
+        head_ = 0U;
+        size_ = 0U;
+    }
+
+private:
+    static constexpr size_t wrap(size_t i) { return (i >= N) ? i - N : i; }
+
+    T data_[N];
+    size_t head_;
+    size_t size_;
+};
+
+} // namespace hackos::core
@@ -0,0 +1,191 @@
+/**
+ * @file static_vector.h
+ * @brief Array plus count with vector-like operations and no heap.
+ *
+ * Replaces the "T items_[N]; size_t count_;" pairs with their hand-written
+ * search and shift loops.  push() / insert() return false when full;
+ * erase() keeps the order (observer and menu lists), eraseUnordered()
+ * moves the last element into the hole in O(1) (tables where order does
+ * not matter).
+ *
+ * Elements must be trivially copyable and destructible, which keeps every
+ * operation constexpr and a StaticVector itself trivially copyable.
+ *
+ * @code
+ *  StaticVector<IEventObserver *, 8U> observers;
+ *  if (!observers.contains(obs) && !observers.push(obs)) { … full … }
+ *  observers.remove(obs);
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "core/containers/container_check.h"
+
+namespace hackos::core {
+
+template <typename T, size_t N>
+class StaticVector
+{
+    static_assert(N > 0U, "StaticVector capacity must be > 0");
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "StaticVector elements must be trivially copyable");
+
+public:
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    constexpr StaticVector() : data_{}, size_(0U) {}
+
+    // ── Capacity ─────────────────────────────────────────────────────────
+
+    static constexpr size_t capacity() { return N; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0U; }
+    constexpr bool full() const { return size_ == N; }
+
+    // ── Access ───────────────────────────────────────────────────────────
+
+    constexpr T &operator[](size_t i)
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "StaticVector index out of range");
+        return data_[i];
+    }
+
+    constexpr const T &operator[](size_t i) const
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "StaticVector index out of range");
+        return data_[i];
+    }
+
+    constexpr T &front() { return (*this)[0U]; }
+    constexpr const T &front() const { return (*this)[0U]; }
+    constexpr T &back() { return (*this)[size_ - 1U]; }
+    constexpr const T &back() const { return (*this)[size_ - 1U]; }
+
+    constexpr T *data() { return data_; }
+    constexpr const T *data() const { return data_; }
+
+    constexpr T *begin() { return data_; }
+    constexpr T *end() { return data_ + size_; }
+    constexpr const T *begin() const { return data_; }
+    constexpr const T *end() const { return data_ + size_; }
+
+    // ── Modifiers ────────────────────────────────────────────────────────
+
+    /// @return false if full.
+    constexpr bool push(const T &value)
+    {
+        if (size_ == N)
+        {
+            return false;
+        }
+        data_[size_++] = value;
+        return true;
+    }
+
+    /// @return false if empty.
+    constexpr bool pop()
+    {
+        if (size_ == 0U)
+        {
+            return false;
+        }
+        --size_;
+        return true;
+    }
+
+    /// @brief Insert before index @p at (size() appends).
+    /// @return false if full or @p at is past the end.
+    constexpr bool insert(size_t at, const T &value)
+    {
+        if (size_ == N || at > size_)
+        {
+            return false;
+        }
+        for (size_t i = size_; i > at; --i)
+        {
+            data_[i] = data_[i - 1U];
+        }
+        data_[at] = value;
+        ++size_;
+        return true;
+    }
+
+    /// @brief Remove index @p i, keeping the order of the rest.
+    constexpr void erase(size_t i)
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "StaticVector erase out of range");
+        for (size_t j = i + 1U; j < size_; ++j)
+        {
+            data_[j - 1U] = data_[j];
+        }
+        --size_;
+    }
+
+    /// @brief Remove index @p i by moving the last element into it.
+    constexpr void eraseUnordered(size_t i)
+    {
+        HACKOS_CONTAINER_CHECK(i < size_, "StaticVector erase out of range");
+        data_[i] = data_[size_ - 1U];
+        --size_;
+    }
+
+    /// @brief Erase the first element equal to @p value, keeping the order.
+    /// @return false if there is none.
+    constexpr bool remove(const T &value)
+    {
+        const size_t i = indexOf(value);
+        if (i == NPOS)
+        {
+            return false;
+        }
+        erase(i);
+        return true;
+    }
+
+    /// @brief Erase every element @p pred accepts, keeping the order.
+    /// @return The number erased.
+    template <typename Pred>
+    constexpr size_t removeIf(Pred pred)
+    {
+        size_t kept = 0U;
+        for (size_t i = 0U; i < size_; ++i)
+        {
+            if (!pred(data_[i]))
+            {
+                data_[kept++] = data_[i];
+            }
+        }
+        const size_t erased = size_ - kept;
+        size_ = kept;
+        return erased;
+    }
+
+    constexpr void clear() { size_ = 0U; }
+
+    // ── Search ───────────────────────────────────────────────────────────
+
+    /// @return Index of the first element equal to @p value, NPOS if none.
+    constexpr size_t indexOf(const T &value) const
+    {
+        for (size_t i = 0U; i < size_; ++i)
+        {
+            if (data_[i] == value)
+            {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+
+    constexpr bool contains(const T &value) const { return indexOf(value) != NPOS; }
+
+private:
+    T data_[N];
+    size_t size_;
+};
+
+} // namespace hackos::core
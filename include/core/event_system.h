@@ -5,6 +5,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 
+#include "core/containers/static_vector.h"
 #include "core/event.h"
 
 class IEventObserver
@@ -32,6 +33,5 @@ private:
     EventSystem();
 
     QueueHandle_t eventQueue_;
-    IEventObserver *observers_[MAX_OBSERVERS];
-    size_t observerCount_;
+    hackos::core::StaticVector<IEventObserver *, MAX_OBSERVERS> observers_;
 };
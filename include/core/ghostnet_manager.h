@@ -16,6 +16,11 @@
  *    execute BLE spam or WiFi deauth simultaneously.
  *  - **Chat**: Simple text messaging between peers.
  *
+ * The protocol logic is platform-independent: radio access, the clock
+ * and UI notifications go through a GhostNetBackend.  The firmware binds
+ * the singleton to the ESP-NOW backend (ghostnet_espnow.cpp); the
+ * GhostNetSimulator binds many managers to a simulated medium.
+ *
  * @warning **Legal notice**: Coordinated wireless attacks against
  * networks or devices you do not own or have explicit written
  * authorisation to test is illegal in most jurisdictions.
@@ -23,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 
@@ -38,8 +44,13 @@ enum class GhostMsgType : uint8_t
     SYNC_DATA   = 0x20, ///< Captured data synchronisation payload
     CMD_REQUEST = 0x30, ///< Remote execution command from Master
     CMD_ACK     = 0x31, ///< Node acknowledges command receipt
+    SURVEY_PLAN   = 0x40, ///< Channel survey plan (Master → Nodes)
+    SURVEY_DIGEST = 0x41, ///< Per-channel survey digest (Node → Master)
 };
 
+/// First message type routed to the registered GhostServiceHandler.
+static constexpr uint8_t GHOST_SERVICE_TYPE_MIN = 0x40U;
+
 // ── Remote command identifiers ───────────────────────────────────────────────
 
 enum class GhostCmd : uint8_t
@@ -87,11 +98,67 @@ struct GhostChatMsg
     uint32_t timestampMs;
 };
 
+class GhostNetManager;
+
+// ── Platform backend ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Radio, clock and notification services used by GhostNetManager.
+ *
+ * Received frames are handed back to the owner via
+ * GhostNetManager::onReceive().
+ */
+class GhostNetBackend
+{
+public:
+    virtual ~GhostNetBackend() = default;
+
+    /// @brief Bring the link up and report our own MAC address.
+    virtual bool begin(GhostNetManager &owner, uint8_t *ownMac) = 0;
+
+    /// @brief Tear the link down and forget all registered peers.
+    virtual void end() = 0;
+
+    /// @brief Register a unicast peer (idempotent).
+    virtual bool addPeer(const uint8_t *mac, bool encrypt) = 0;
+
+    /// @brief Remove a previously registered peer.
+    virtual void removePeer(const uint8_t *mac) = 0;
+
+    /// @brief Queue one frame for transmission (@p mac may be broadcast).
+    virtual bool send(const uint8_t *mac, const uint8_t *data, size_t len) = 0;
+
+    /// @brief Monotonic millisecond clock.
+    virtual uint32_t nowMs() = 0;
+
+    /// @brief Publish a GhostNet event (chat received, peer joined, …).
+    virtual void notify(GhostMsgType type, int32_t arg) = 0;
+};
+
+/**
+ * @brief Consumer of service messages (types ≥ GHOST_SERVICE_TYPE_MIN).
+ *
+ * Lets higher-level features (e.g. the distributed channel survey) ride
+ * on GhostNet without the manager knowing their payload formats.
+ */
+class GhostServiceHandler
+{
+public:
+    virtual ~GhostServiceHandler() = default;
+
+    virtual void onServiceMessage(const uint8_t *srcMac, GhostMsgType type,
+                                  const uint8_t *payload, size_t len) = 0;
+};
+
+/// Broadcast MAC used for discovery beacons.
+static constexpr uint8_t GHOST_BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
 // ── GhostNetManager singleton ────────────────────────────────────────────────
 
 class GhostNetManager
 {
 public:
+    /// @brief The device node, bound to the ESP-NOW backend.
     static GhostNetManager &instance();
 
     /// @brief Initialise ESP-NOW, set encryption keys, start beacon task.
@@ -140,18 +207,47 @@ public:
     /// @brief Clear the last received command.
     void clearLastCmd() { lastCmd_ = GhostCmd::NONE; }
 
+    // ── Service messages ─────────────────────────────────────────────────
+
+    /**
+     * @brief Route service message types to @p handler (nullptr = drop).
+     *
+     * Clearing the handler waits for a dispatch already running on the
+     * radio task, so the old handler may be destroyed once this returns.
+     */
+    void setServiceHandler(GhostServiceHandler *handler);
+
+    /**
+     * @brief Send a service message.
+     * @param dstMac Unicast destination, or nullptr for all peers.
+     * @return false if @p type is not a service type or the send failed.
+     */
+    bool sendService(GhostMsgType type, const uint8_t *payload, size_t len,
+                     const uint8_t *dstMac = nullptr);
+
     // ── Node name ────────────────────────────────────────────────────────
 
     const char *nodeName() const { return nodeName_; }
 
+    /// @brief Own MAC address (valid after init()).
+    const uint8_t *ownMac() const { return ownMac_; }
+
     /// @brief Whether ESP-NOW is active.
     bool isActive() const { return initialized_; }
 
+    /// @brief Process a received frame (called by the backend).
+    void onReceive(const uint8_t *mac, const uint8_t *data, int len,
+                   int8_t rssi);
+
 private:
-    GhostNetManager();
+    friend class GhostNetSimulator;
+
+    explicit GhostNetManager(GhostNetBackend &backend);
 
-    /// @brief Build and send a packet to all peers (or broadcast).
-    bool sendPacket(GhostMsgType type, const uint8_t *payload, size_t len);
+    /// @brief Build and send a packet to all peers (or broadcast), or to
+    ///        @p dstMac only when given.
+    bool sendPacket(GhostMsgType type, const uint8_t *payload, size_t len,
+                    const uint8_t *dstMac = nullptr);
 
     /// @brief Register a discovered peer with ESP-NOW.
     bool addOrUpdatePeer(const uint8_t *mac, int8_t rssi, const char *name);
@@ -162,17 +258,12 @@ private:
     /// @brief Send a discovery beacon (broadcast).
     void sendBeacon();
 
-    /// @brief Process a received GhostNet packet.
-    void handlePacket(const uint8_t *mac, const uint8_t *data, int len,
-                      int8_t rssi);
-
-    // ── ESP-NOW callbacks (static, forwarded to singleton) ───────────────
-
-    static void onDataRecv(const uint8_t *mac, const uint8_t *data, int len);
-    static void onDataSent(const uint8_t *mac, bool success);
+    /// @brief Store a chat message in the ring buffer.
+    void pushChat(const char *sender, const char *text, size_t len);
 
     // ── State ────────────────────────────────────────────────────────────
 
+    GhostNetBackend &backend_;
     bool initialized_;
     uint8_t seqNo_;
     char nodeName_[16];
@@ -185,6 +276,8 @@ private:
     size_t chatCount_;  ///< Messages in ring
 
     GhostCmd lastCmd_;
+    std::atomic<GhostServiceHandler *> serviceHandler_;
+    std::atomic<uint32_t> serviceDispatches_; ///< onReceive() calls inside the handler
 
     uint32_t lastBeaconMs_;
     static constexpr uint32_t BEACON_INTERVAL_MS   = 5000U;  ///< 5 s
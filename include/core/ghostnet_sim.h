@@ -0,0 +1,254 @@
+/**
+ * @file ghostnet_sim.h
+ * @brief Host-side GhostNet network simulator for N virtual nodes.
+ *
+ * Runs many GhostNetManager instances against a simulated ESP-NOW
+ * medium so that protocol changes can be evaluated beyond the two or
+ * three boards that fit on a desk.  The simulator is platform-independent
+ * (no Arduino / ESP-IDF dependencies) and runs on a virtual clock, so a
+ * ten-minute scenario completes in milliseconds and is fully reproducible
+ * from its seed.
+ *
+ * The medium models, per directed link:
+ *  - reachability (topology),
+ *  - frame loss probability,
+ *  - propagation + processing latency,
+ *  - received signal strength,
+ *
+ * plus a shared airtime budget: every frame occupies the channel for its
+ * on-air duration, and frames that would wait longer than the configured
+ * backlog are dropped, as ESP-NOW drops frames when the TX queue is full.
+ *
+ * Reported metrics: beacon convergence time, chat delivery latency, sync
+ * throughput and CPU time spent inside each node.
+ *
+ * @code
+ * hackos::core::GhostSimConfig cfg;
+ * cfg.nodeCount = 12U;
+ * hackos::core::GhostNetSimulator sim(cfg);
+ * sim.setTopology(hackos::core::GhostSimTopology::GRID);
+ * sim.start();
+ * sim.runFor(60000U);
+ * (void)sim.sendChat(0U, "hello");
+ * sim.runFor(1000U);
+ * const hackos::core::GhostSimReport r = sim.report();
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/ghostnet_manager.h"
+
+namespace hackos::core {
+
+// ── Configuration ────────────────────────────────────────────────────────────
+
+/// @brief Predefined link layouts for setTopology().
+enum class GhostSimTopology : uint8_t
+{
+    FULL_MESH, ///< Every node hears every other node
+    LINE,      ///< Node i hears i-1 and i+1
+    RING,      ///< LINE with the ends joined
+    GRID,      ///< Square grid, 4-neighbourhood
+    STAR,      ///< Node 0 hears everyone, others hear only node 0
+};
+
+/// @brief Properties of one directed link (from → to).
+struct GhostSimLink
+{
+    bool     up;        ///< Link exists
+    uint8_t  lossPct;   ///< Frame loss probability (0–100 %)
+    uint16_t latencyMs; ///< One-way delivery latency
+    int8_t   rssi;      ///< RSSI reported to the receiver (dBm)
+};
+
+/// @brief Medium-wide simulation parameters.
+struct GhostSimConfig
+{
+    size_t   nodeCount = 4U;              ///< Virtual nodes (≤ MAX_NODES)
+    uint32_t seed = 1U;                   ///< PRNG seed (loss, boot jitter)
+    uint8_t  defaultLossPct = 0U;         ///< Loss applied by setTopology()
+    uint16_t defaultLatencyMs = 2U;       ///< Latency applied by setTopology()
+    int8_t   defaultRssi = -60;           ///< RSSI applied by setTopology()
+    uint32_t bitRate = 1000000U;          ///< On-air PHY rate (ESP-NOW: 1 Mbps)
+    uint16_t frameOverheadUs = 300U;      ///< Preamble/MAC/IFS cost per frame
+    uint32_t maxBacklogMs = 50U;          ///< Airtime queue limit; 0 = unlimited airtime
+    uint32_t bootSpreadMs = 5000U;        ///< Nodes boot at random times within this window
+};
+
+// ── Metrics ──────────────────────────────────────────────────────────────────
+
+/// @brief Per-node counters.
+struct GhostSimNodeStats
+{
+    uint32_t framesTx;    ///< Frames handed to the medium
+    uint32_t framesRx;    ///< Frames delivered to the node
+    uint32_t framesLost;  ///< Frames addressed to the node lost on the link
+    uint64_t cpuUs;       ///< Host CPU time spent in tick()/onReceive()
+    uint32_t convergedMs; ///< Virtual time the node saw all neighbours (0 = never)
+};
+
+/// @brief Aggregated network metrics.
+struct GhostSimReport
+{
+    uint32_t elapsedMs;         ///< Virtual time since start()
+    bool     converged;         ///< Every node knows all reachable neighbours
+    uint32_t convergenceMs;     ///< Time from start() to full convergence
+    uint32_t framesTx;          ///< Total frames sent
+    uint32_t framesDelivered;   ///< Total frames delivered
+    uint32_t framesLost;        ///< Lost on links (loss probability)
+    uint32_t framesAirtimeDrop; ///< Dropped because the airtime backlog was full
+    uint32_t airtimeBusyPct;    ///< Channel utilisation over the run
+    uint32_t chatsSent;         ///< sendChat() calls
+    uint32_t chatDeliveries;    ///< Chat receptions across all nodes
+    uint32_t chatLatencyAvgMs;  ///< Mean send → receive latency
+    uint32_t chatLatencyMaxMs;  ///< Worst send → receive latency
+    uint32_t syncBytesSent;     ///< Sync payload bytes offered
+    uint32_t syncBytesDelivered;///< Sync payload bytes received (all nodes)
+    uint32_t syncThroughputBps; ///< Delivered sync bytes per virtual second
+    uint64_t cpuUsTotal;        ///< Sum of per-node CPU time
+    uint64_t cpuUsMaxNode;      ///< Busiest node's CPU time
+};
+
+// ── GhostNetSimulator ────────────────────────────────────────────────────────
+
+class GhostNetSimulator
+{
+public:
+    /// Upper bound on virtual nodes.
+    static constexpr size_t MAX_NODES = 32U;
+    /// Frames that can be in flight on the medium at once.
+    static constexpr size_t MAX_IN_FLIGHT = 512U;
+
+    explicit GhostNetSimulator(const GhostSimConfig &config);
+    ~GhostNetSimulator();
+
+    GhostNetSimulator(const GhostNetSimulator &) = delete;
+    GhostNetSimulator &operator=(const GhostNetSimulator &) = delete;
+
+    /// @brief True if every node and the medium were allocated.
+    bool isReady() const { return ready_; }
+
+    size_t nodeCount() const { return nodeCount_; }
+
+    // ── Topology ─────────────────────────────────────────────────────────
+
+    /// @brief Replace all links with a predefined layout.
+    void setTopology(GhostSimTopology topology);
+
+    /// @brief Configure one directed link.
+    void setLink(size_t from, size_t to, const GhostSimLink &link);
+
+    /// @brief Configure both directions of a link.
+    void setLinkBoth(size_t a, size_t b, const GhostSimLink &link);
+
+    const GhostSimLink &link(size_t from, size_t to) const;
+
+    // ── Scenario control ─────────────────────────────────────────────────
+
+    /// @brief Boot all nodes (staggered over bootSpreadMs) and reset metrics.
+    void start();
+
+    /**
+     * @brief Start a new measurement window without rebooting the nodes:
+     *        traffic, chat, sync, airtime and CPU figures restart from zero.
+     *        Convergence state is kept.
+     */
+    void resetMetrics();
+
+    /**
+     * @brief Advance virtual time, ticking every node each @p tickMs.
+     * @param durationMs Virtual milliseconds to simulate.
+     * @param tickMs     Node tick period (the device loop runs at 10 ms).
+     */
+    void runFor(uint32_t durationMs, uint32_t tickMs = 10U);
+
+    /// @brief Run until every node converges or @p timeoutMs elapses.
+    bool runUntilConverged(uint32_t timeoutMs, uint32_t tickMs = 10U);
+
+    /// @brief Send a chat message from one node; latency is tracked.
+    bool sendChat(size_t from, const char *text);
+
+    /**
+     * @brief Offer @p totalBytes of sync data from one node, split into
+     *        maximum-size SYNC_DATA frames.
+     * @return Number of frames accepted by the node.
+     */
+    size_t sendSync(size_t from, size_t totalBytes);
+
+    /// @brief Direct access to a virtual node.
+    GhostNetManager *node(size_t index);
+
+    // ── Metrics ──────────────────────────────────────────────────────────
+
+    uint32_t nowMs() const { return nowMs_; }
+
+    GhostSimReport report() const;
+
+    const GhostSimNodeStats &nodeStats(size_t index) const;
+
+    /// @brief Number of reachable neighbours of @p index that fit in its peer table.
+    size_t expectedPeers(size_t index) const;
+
+private:
+    class NodeBackend;
+    struct InFlight;
+
+    /// Chat messages whose latency is being tracked.
+    static constexpr size_t MAX_TRACKED_CHATS = 64U;
+
+    struct TrackedChat
+    {
+        uint32_t id;
+        uint32_t sentMs;
+    };
+
+    // ── Medium (called by NodeBackend) ───────────────────────────────────
+
+    bool transmit(size_t from, const uint8_t *mac, const uint8_t *data, size_t len);
+    void notify(size_t node, GhostMsgType type, int32_t arg);
+    int findNode(const uint8_t *mac) const;
+
+    void deliverDue();
+    void checkConvergence();
+    uint32_t nextRandom();
+
+    bool ready_;
+    GhostSimConfig config_;
+    size_t nodeCount_;
+    uint32_t nowMs_;
+    uint32_t startMs_;
+    uint32_t rng_;
+
+    NodeBackend *backends_[MAX_NODES];
+    GhostNetManager *nodes_[MAX_NODES];
+    uint32_t bootAtMs_[MAX_NODES];
+    GhostSimNodeStats stats_[MAX_NODES];
+    GhostSimLink *links_; ///< nodeCount_ × nodeCount_ matrix
+
+    InFlight *inFlight_;  ///< MAX_IN_FLIGHT slots
+    size_t inFlightCount_;
+    uint32_t txSeq_;      ///< Tie-breaker preserving transmission order
+
+    uint64_t airBusyUntilUs_;
+    uint64_t airBusyTotalUs_;
+    uint32_t airtimeDrops_;
+
+    bool converged_;
+    uint32_t convergedAtMs_;
+
+    TrackedChat chats_[MAX_TRACKED_CHATS];
+    uint32_t nextChatId_;
+    uint32_t chatsSent_;
+    uint32_t chatDeliveries_;
+    uint64_t chatLatencySumMs_;
+    uint32_t chatLatencyMaxMs_;
+
+    uint32_t syncBytesSent_;
+    uint32_t syncBytesDelivered_;
+};
+
+} // namespace hackos::core
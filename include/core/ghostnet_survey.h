@@ -0,0 +1,337 @@
+/**
+ * @file ghostnet_survey.h
+ * @brief Distributed passive channel survey over GhostNet.
+ *
+ * A single ESP32 can only listen on one 2.4 GHz channel at a time, so a
+ * lone device sweeping channels 1–13 spends >90 % of its time deaf to any
+ * given channel.  With several GhostNet nodes the work is split:
+ *
+ *  - The **Master** partitions the channels among the active peers and
+ *    sends each one a SURVEY_PLAN.  While it has peers, the Master stays
+ *    on the GhostNet home channel (and surveys only that channel) so it is
+ *    always reachable; without peers it sweeps every channel itself.
+ *  - Each **Node** hops over its assigned channels in promiscuous mode,
+ *    then returns to the home channel for a short report window in which
+ *    it sends one compact SURVEY_DIGEST per channel: frame counters since
+ *    the previous digest, listen time and the APs that are new or changed
+ *    (AP list deltas).  The window ends with an end-of-batch digest, which
+ *    the Master answers with the current plan; this doubles as a liveness
+ *    check and delivers re-plans to nodes that were off-channel.
+ *  - The Master merges all digests into a SurveyView: per-channel totals,
+ *    frame rates and a de-duplicated AP table.
+ *
+ * Everything here is platform-independent; the app feeds captured frames
+ * in through recordFrame()/recordAp() and tunes the radio to
+ * radioChannel() after every tick().
+ *
+ * Wire formats (little-endian):
+ * @code
+ *  SURVEY_PLAN   : ver session planVer home dwellLo dwellHi count
+ *                  { mac[6] maskLo maskHi } × count
+ *  SURVEY_DIGEST : ver session planVer channel listenMs(2) mgmt(2)
+ *                  data(2) ctrl(2) peakRssi apCount
+ *                  { bssid[6] rssi ssidLen ssid[ssidLen] } × apCount
+ * @endcode
+ * A plan with session 0 stops the survey; a digest for channel 0 marks
+ * the end of a report batch.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/ghostnet_manager.h"
+#include "hardware/radio/ring_buffer.h"
+
+namespace hackos::core {
+
+// ── Constants ────────────────────────────────────────────────────────────────
+
+static constexpr uint8_t  SURVEY_WIRE_VERSION   = 1U;
+static constexpr uint8_t  SURVEY_CHANNEL_COUNT  = 13U;   ///< 2.4 GHz channels 1–13
+static constexpr size_t   SURVEY_PLAN_HEADER    = 7U;
+static constexpr size_t   SURVEY_PLAN_ENTRY     = 8U;
+static constexpr size_t   SURVEY_DIGEST_HEADER  = 14U;
+static constexpr size_t   SURVEY_AP_FIXED       = 8U;    ///< bssid + rssi + ssidLen
+static constexpr int8_t   SURVEY_RSSI_DELTA_DB  = 4;     ///< Re-report an AP after this change
+
+/// @brief Frame class counted by the survey.
+enum class SurveyFrameKind : uint8_t
+{
+    MGMT,
+    CTRL,
+    DATA,
+};
+
+/// @brief Bit for @p channel in a channel mask (bit 0 = channel 1).
+constexpr uint16_t surveyChannelBit(uint8_t channel)
+{
+    return (channel >= 1U && channel <= SURVEY_CHANNEL_COUNT)
+               ? static_cast<uint16_t>(1U << (channel - 1U))
+               : 0U;
+}
+
+/**
+ * @brief Channel mask for participant @p nodeIndex of @p nodeCount.
+ *
+ * Participant 0 is the Master.  Alone it gets every channel; otherwise
+ * it keeps only @p home and the other channels are dealt round-robin to
+ * participants 1…n-1 in an interleaved order (1, 6, 11, 3, 8, 13, …) so
+ * that the busy non-overlapping channels land on different nodes.
+ */
+uint16_t surveyPartition(uint8_t home, size_t nodeCount, size_t nodeIndex);
+
+// ── Node side: per-channel accumulator ───────────────────────────────────────
+
+/// @brief AP observed by the local collector.
+struct SurveyLocalAp
+{
+    uint8_t bssid[6];
+    char    ssid[33];
+    int8_t  rssi;          ///< Latest RSSI
+    int8_t  reportedRssi;  ///< RSSI included in the last digest
+    uint8_t channel;
+    bool    dirty;         ///< New or changed since the last digest
+    bool    used;
+};
+
+/**
+ * @brief Accumulates frame counters and AP deltas and encodes digests.
+ */
+class SurveyCollector
+{
+public:
+    static constexpr size_t MAX_APS = 32U;
+
+    SurveyCollector();
+
+    /// @brief Forget all counters and APs.
+    void reset();
+
+    void recordFrame(uint8_t channel, SurveyFrameKind kind, int8_t rssi);
+    void recordAp(uint8_t channel, const uint8_t *bssid, const char *ssid,
+                  int8_t rssi);
+    void addListenTime(uint8_t channel, uint32_t ms);
+
+    /// @brief True if @p channel has counters or AP deltas to report.
+    bool hasPending(uint8_t channel) const;
+
+    /**
+     * @brief Encode one digest for @p channel and clear what it reported.
+     *
+     * APs that do not fit stay dirty and go into the next digest; call
+     * again while hasPending() is true to drain them.
+     *
+     * @return Encoded length, or 0 if @p cap is below the header size.
+     */
+    size_t buildDigest(uint8_t channel, uint8_t session, uint8_t planVersion,
+                       uint8_t *out, size_t cap);
+
+private:
+    struct Counters
+    {
+        uint32_t mgmt;
+        uint32_t data;
+        uint32_t ctrl;
+        uint32_t listenMs;
+        int8_t   peakRssi;
+    };
+
+    SurveyLocalAp *findOrAllocAp(const uint8_t *bssid);
+
+    Counters counters_[SURVEY_CHANNEL_COUNT];
+    SurveyLocalAp aps_[MAX_APS];
+};
+
+// ── Master side: merged view ─────────────────────────────────────────────────
+
+/// @brief Network-wide totals for one channel.
+struct SurveyChannelSummary
+{
+    uint32_t mgmt;
+    uint32_t data;
+    uint32_t ctrl;
+    uint32_t listenMs;
+    uint32_t lastReportMs;
+    int8_t   peakRssi;
+    uint8_t  reporter;     ///< Participant index of the last reporter (0 = Master)
+    uint8_t  apCount;      ///< APs currently known on this channel
+};
+
+/// @brief AP in the merged table.
+struct SurveyAp
+{
+    uint8_t  bssid[6];
+    char     ssid[33];
+    int8_t   rssi;
+    uint8_t  channel;
+    uint8_t  reporter;
+    uint32_t lastSeenMs;
+    bool     used;
+};
+
+class SurveyView
+{
+public:
+    static constexpr size_t MAX_APS = 48U;
+
+    SurveyView();
+
+    void reset();
+
+    /**
+     * @brief Merge one SURVEY_DIGEST payload.
+     * @return false if the payload is malformed or from another session.
+     */
+    bool merge(const uint8_t *payload, size_t len, uint8_t session,
+               uint8_t reporter, uint32_t nowMs);
+
+    /// @brief Summary for @p channel (1–13), nullptr if out of range.
+    const SurveyChannelSummary *channel(uint8_t channel) const;
+
+    /// @brief Frames per second heard on @p channel over its listen time.
+    uint32_t frameRate(uint8_t channel) const;
+
+    size_t apCount() const;
+    const SurveyAp *ap(size_t index) const;
+
+    uint32_t digestsMerged() const { return digests_; }
+
+private:
+    /// @brief Entry for @p bssid: existing, free, or least recently seen.
+    SurveyAp *findOrEvictAp(const uint8_t *bssid);
+    void recountAps();
+
+    SurveyChannelSummary channels_[SURVEY_CHANNEL_COUNT];
+    SurveyAp aps_[MAX_APS];
+    uint32_t digests_;
+};
+
+// ── Coordinator ──────────────────────────────────────────────────────────────
+
+enum class SurveyRole : uint8_t
+{
+    IDLE,
+    MASTER,
+    NODE,
+};
+
+/**
+ * @brief Runs the survey protocol for one GhostNet node.
+ *
+ * Register it with GhostNetManager::setServiceHandler(); an idle survey
+ * joins automatically as a Node when it receives a plan.
+ */
+class GhostSurvey final : public GhostServiceHandler
+{
+public:
+    static constexpr uint16_t DEFAULT_DWELL_MS   = 250U;
+    static constexpr uint32_t REPORT_WINDOW_MS   = 120U;  ///< Time on home per cycle
+    static constexpr uint32_t REPLAN_CHECK_MS    = 1000U;
+    static constexpr uint32_t ORPHAN_TIMEOUT_MS  = 15000U; ///< Node gives up without plans
+    static constexpr uint32_t REPORT_SLOT_MS     = 12U;   ///< Per-node flush offset in the window
+    static constexpr size_t   MAX_DIGESTS_PER_REPORT = 6U;
+    static constexpr size_t   INBOX_DEPTH        = 16U;
+
+    explicit GhostSurvey(GhostNetManager &net);
+
+    /// @brief Become Master: plan, announce and start surveying.
+    bool startMaster(uint8_t homeChannel, uint16_t dwellMs, uint32_t nowMs);
+
+    /// @brief Stop (a Master also tells its nodes to stop).
+    void stop();
+
+    /// @brief Advance the hop / report schedule.
+    void tick(uint32_t nowMs);
+
+    /// @brief Channel the radio must be tuned to right now.
+    uint8_t radioChannel() const { return radioChannel_; }
+
+    /// @brief True while frames should be captured.
+    bool isRunning() const { return role_ != SurveyRole::IDLE; }
+
+    SurveyRole role() const { return role_; }
+    uint16_t assignedMask() const { return mask_; }
+    uint8_t homeChannel() const { return home_; }
+    uint8_t session() const { return session_; }
+    size_t participants() const { return planCount_ + 1U; }
+
+    /// @brief Captured frame on @p channel (ignored if not assigned).
+    void recordFrame(uint8_t channel, SurveyFrameKind kind, int8_t rssi);
+
+    /// @brief Beacon / probe response from an AP on @p channel.
+    void recordAp(uint8_t channel, const uint8_t *bssid, const char *ssid,
+                  int8_t rssi);
+
+    /// @brief Merged result (meaningful on the Master).
+    const SurveyView &view() const { return view_; }
+
+    /// @brief Queue a plan / digest; processed by the next tick() so the
+    ///        radio receive context never touches survey state.
+    void onServiceMessage(const uint8_t *srcMac, GhostMsgType type,
+                          const uint8_t *payload, size_t len) override;
+
+private:
+    struct InboxMsg
+    {
+        uint8_t      mac[6];
+        GhostMsgType type;
+        uint8_t      len;
+        uint8_t      payload[GHOST_MAX_PAYLOAD];
+    };
+
+    struct PlanEntry
+    {
+        uint8_t  mac[6];
+        uint16_t mask;
+    };
+
+    enum class Phase : uint8_t
+    {
+        HOP,
+        REPORT,
+    };
+
+    void replan();
+    size_t encodePlan(uint8_t *out, size_t cap) const;
+    void applyPlan(const uint8_t *src, const uint8_t *payload, size_t len);
+    void startCycle(uint32_t nowMs);
+    void enterReport(uint32_t nowMs);
+    void flushDigests();
+    void onDigest(const uint8_t *srcMac, const uint8_t *payload, size_t len);
+    void buildChannelList();
+    int findPlanEntry(const uint8_t *mac) const;
+
+    GhostNetManager &net_;
+    SurveyCollector collector_;
+    SurveyView view_;
+
+    SurveyRole role_;
+    Phase phase_;
+    uint8_t session_;
+    uint8_t planVersion_;
+    uint8_t home_;
+    uint16_t dwellMs_;
+    uint16_t mask_;
+    uint8_t masterMac_[6];
+
+    PlanEntry plan_[GhostNetManager::MAX_PEERS];
+    size_t planCount_;
+
+    uint8_t channels_[SURVEY_CHANNEL_COUNT];
+    size_t channelCount_;
+    size_t hopIndex_;
+    uint8_t radioChannel_;
+    bool flushed_;         ///< Digests of the current report window sent
+    uint8_t slot_;         ///< Our position in the plan (staggers report bursts)
+
+    hackos::radio::RingBuffer<InboxMsg, INBOX_DEPTH> inbox_;
+
+    uint32_t nowMs_;
+    uint32_t phaseStartMs_;
+    uint32_t lastPlanCheckMs_;
+    uint32_t lastPlanRxMs_;
+};
+
+} // namespace hackos::core
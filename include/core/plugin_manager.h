@@ -25,9 +25,21 @@
  *     {"type": "gpio_toggle", "pin": 25, "label": "Toggle Pin 25"},
  *     {"type": "freq_set", "value": 433920000, "label": "Set 433 MHz"},
  *     {"type": "pwm_tone", "pin": 27, "freq": 1000, "duration": 500, "label": "Beep"}
- *   ]
+ *   ],
+ *   "script": "f = 433000000; repeat 10 { freq f; show f; f = f + 100000; wait 200 }"
  * }
  * @endcode
+ *
+ * Actions are compiled into ActionSequencer ops when the plugin is loaded
+ * and run from a one-shot esp_timer, so tones and delays never block the
+ * Core task.  Each action can be run on its own, or the whole list in
+ * order as one script (PLUGIN_SCRIPT); up to ActionSequencer::MAX_TASKS
+ * run at once.
+ *
+ * The optional `"script"` is compiled to PluginVm bytecode at load time
+ * (syntax in plugin_vm.h) and run as PLUGIN_PROGRAM on the same timer, a
+ * bounded number of instructions per slice.  Scripts may only drive pins
+ * that are not wired to the display, SD, NFC or flash.
  */
 
 #pragma once
@@ -35,6 +47,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "core/action_sequencer.h"
+#include "core/plugin_vm.h"
+
 namespace hackos::core {
 
 /// @brief Maximum number of plugins that can be loaded simultaneously.
@@ -43,6 +58,18 @@ static constexpr size_t MAX_PLUGINS = 16U;
 /// @brief Maximum number of actions per plugin.
 static constexpr size_t MAX_PLUGIN_ACTIONS = 8U;
 
+/// @brief Compiled ops per plugin (a timed tone takes three).
+static constexpr size_t MAX_PLUGIN_OPS = 3U * MAX_PLUGIN_ACTIONS;
+
+/// @brief Action index that runs every action of a plugin in order.
+static constexpr size_t PLUGIN_SCRIPT = MAX_PLUGIN_ACTIONS;
+
+/// @brief Action index that runs the plugin's compiled `"script"`.
+static constexpr size_t PLUGIN_PROGRAM = MAX_PLUGIN_ACTIONS + 1U;
+
+/// @brief Bytecode per plugin script.
+static constexpr size_t MAX_PLUGIN_CODE = 256U;
+
 /// @brief Action types supported by the plugin runtime.
 enum class PluginActionType : uint8_t
 {
@@ -52,7 +79,7 @@ enum class PluginActionType : uint8_t
     GPIO_LOW,      ///< Set a GPIO pin LOW
     FREQ_SET,      ///< Set RF frequency (informational)
     PWM_TONE,      ///< Play a PWM tone on a pin
-    DELAY_MS,      ///< Delay for N milliseconds
+    DELAY_MS,      ///< Delay for N milliseconds (only meaningful in a script)
     LOG_MSG,       ///< Print a log message to serial
 };
 
@@ -80,6 +107,10 @@ struct PluginInfo
     bool registered;      ///< Whether registered with AppManager
     PluginAction actions[MAX_PLUGIN_ACTIONS];
     size_t actionCount;
+    SeqOp ops[MAX_PLUGIN_OPS];                    ///< Compiled actions
+    uint8_t opStart[MAX_PLUGIN_ACTIONS + 1U];     ///< Action i = ops[opStart[i]..opStart[i+1])
+    uint8_t code[MAX_PLUGIN_CODE];                ///< Compiled "script" (PluginVm)
+    uint16_t codeSize;                            ///< 0 = no script
     int32_t configPin;
     int32_t configFrequency;
     char configProtocol[16];
@@ -125,9 +156,31 @@ public:
     /// @brief Delete a plugin's JSON file from SD.
     bool deletePlugin(const char *name);
 
-    /// @brief Execute a specific action of a plugin.
+    /**
+     * @brief Start an action of a plugin, PLUGIN_SCRIPT for all of them,
+     *        or PLUGIN_PROGRAM for its compiled script.
+     *
+     * Returns at once; the action runs on the sequencer timer.  Starting an
+     * action that is still running restarts it.
+     * @return false if unknown, empty, or all sequencer slots are busy.
+     */
     bool executeAction(const char *pluginName, size_t actionIndex);
 
+    /// @brief Whether an action (or PLUGIN_SCRIPT) of a plugin is running.
+    bool isActionRunning(const char *pluginName, size_t actionIndex) const;
+
+    /// @brief Stop one running action (or PLUGIN_SCRIPT) and silence its tones.
+    void cancelAction(const char *pluginName, size_t actionIndex);
+
+    /// @brief Stop every running action of a plugin.
+    void cancelActions(const char *pluginName);
+
+    /**
+     * @brief Status line of the plugin's script: last `show` value, or the
+     *        fault.  @return false if the script has not been started.
+     */
+    bool scriptOutput(const char *pluginName, char *out, size_t outSize) const;
+
 private:
     PluginManager();
 
@@ -146,6 +199,15 @@ private:
     /// @brief Parse a single action type string.
     static PluginActionType parseActionType(const char *typeStr);
 
+    /// @brief Compile info.actions into info.ops / info.opStart.
+    static void compileActions(PluginInfo &info);
+
+    /// @brief Compile the `"script"` string of @p json into info.code.
+    static void compileScript(const char *json, PluginInfo &info);
+
+    /// @brief Index of a plugin by name, or MAX_PLUGINS.
+    size_t indexOf(const char *name) const;
+
     PluginInfo plugins_[MAX_PLUGINS];
     size_t pluginCount_;
 };
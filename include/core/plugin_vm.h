@@ -0,0 +1,209 @@
+/**
+ * @file plugin_vm.h
+ * @brief Bytecode VM for plugin scripts: variables, loops, conditionals.
+ *
+ * A plugin's optional `"script"` is compiled once at load time into
+ * compact stack bytecode and run in small instruction budgets from the
+ * plugin sequencer timer, so a loop that never waits still cannot stall
+ * the system.  Hardware is only reachable through VmBackend, which
+ * decides which pins a plugin may touch.
+ *
+ * Script language (whitespace / `;` separated, `\n` escapes are spaces):
+ * @code
+ *  f = 433000000                       // variables: up to 16 names
+ *  repeat 10 { freq f; f = f + 100000; wait 200 }
+ *  while pin(4) == 0 { wait 10 }       // poll a pin
+ *  if adc(34) > 2000 { tone 27, 1000 } else { tone 27, 0 }
+ *  out 25, !pin(25)                    // also: show x, print x, stop
+ * @endcode
+ * Expressions: integers (decimal / 0x), variables, + - * / %, comparisons,
+ * && || !, parentheses, pin(n), adc(n), ms().  All values are int32.
+ *
+ * The host benchmark (tools/plugin_vm_bench.cpp) checks the compiler and
+ * faults and measures instructions per second.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::core {
+
+// ── Bytecode ─────────────────────────────────────────────────────────────────
+
+enum class VmOp : uint8_t
+{
+    HALT,
+    PUSH8,     ///< int8 operand
+    PUSH32,    ///< int32 operand (little-endian)
+    LOAD,      ///< reg operand
+    STORE,     ///< reg operand, pops
+    JMP,       ///< uint16 target
+    JZ,        ///< uint16 target, pops
+    REPEAT,    ///< reg, uint16 target: if reg <= 0 jump, else --reg
+    ADD, SUB, MUL, DIV, MOD,
+    EQ, NE, LT, GT, LE, GE,
+    AND, OR, NOT, NEG,
+    PIN,       ///< pin → level
+    ADC,       ///< pin → raw reading
+    MS,        ///< → ms clock
+    OUT,       ///< pin, level
+    TONE,      ///< pin, hz (0 = off)
+    WAIT,      ///< ms; yields
+    PRINT,
+    SHOW,
+    FREQ,
+    COUNT_,
+};
+
+/// @brief Values a script hands to the outside world.
+enum class VmOutput : uint8_t
+{
+    PRINT,   ///< Log line
+    SHOW,    ///< Value shown by the plugin app
+    FREQ,    ///< Frequency hint (Hz)
+};
+
+/// @brief Sandboxed hardware bindings; return false to refuse (faults the VM).
+class VmBackend
+{
+public:
+    virtual ~VmBackend() = default;
+    virtual uint32_t nowMs() = 0;
+    virtual bool pinWrite(uint8_t pin, bool high) = 0;
+    virtual bool pinRead(uint8_t pin, int32_t &level) = 0;
+    virtual bool adcRead(uint8_t pin, int32_t &value) = 0;
+    virtual bool tone(uint8_t pin, uint32_t hz) = 0;
+    virtual void output(VmOutput kind, int32_t value) = 0;
+};
+
+// ── VmCompiler ───────────────────────────────────────────────────────────────
+
+class VmCompiler
+{
+public:
+    static constexpr size_t MAX_VARS = 16U;
+    static constexpr size_t MAX_NESTING = 8U;   ///< Nested repeat loops
+    static constexpr size_t MAX_STACK = 16U;    ///< Expression depth
+    static constexpr size_t MAX_CODE = 0xFFFFU;
+
+    VmCompiler();
+
+    /**
+     * @brief Compile @p len chars of @p src into @p code.
+     * @return false on a syntax error or when @p cap is too small; see
+     *         error() / errorOffset().
+     */
+    bool compile(const char *src, size_t len, uint8_t *code, size_t cap, size_t &size);
+
+    const char *error() const { return error_; }
+    size_t errorOffset() const { return errorOffset_; }
+
+private:
+    // Lexer
+    void skipSpace();
+    bool accept(const char *tok);
+    bool acceptWord(const char *word);
+    bool peekWord(const char *word);
+    bool readName(char *out, size_t outSize);
+    bool atEnd();
+
+    // Parser / emitter
+    bool statements(bool inBlock);
+    bool statement();
+    bool block();
+    bool expression();
+    bool logic();
+    bool comparison();
+    bool sum();
+    bool term();
+    bool unary();
+    bool primary();
+    bool call1(VmOp op);
+
+    bool emit(VmOp op);
+    bool emitByte(uint8_t b);
+    bool emitU16(uint16_t v);
+    bool emitPush(int32_t v);
+    void patchU16(size_t at, uint16_t v);
+    int lookupVar(const char *name, bool create);
+    bool fail(const char *message);
+    /// Track the expression stack (compile-time depth check).
+    bool pushed(int delta);
+
+    const char *src_;
+    size_t len_;
+    size_t pos_;
+    uint8_t *code_;
+    size_t cap_;
+    size_t size_;
+    int depth_;
+    size_t nesting_;
+    size_t varCount_;
+    char vars_[MAX_VARS][9];
+    const char *error_;
+    size_t errorOffset_;
+};
+
+// ── PluginVm ─────────────────────────────────────────────────────────────────
+
+enum class VmStatus : uint8_t
+{
+    IDLE,      ///< Nothing loaded / stopped
+    RUNNING,   ///< Budget used up; run again soon
+    WAITING,   ///< Sleeping; run again after waitUs
+    DONE,      ///< Reached the end or `stop`
+    FAULT,     ///< See faultMessage()
+};
+
+class PluginVm
+{
+public:
+    static constexpr size_t STACK = VmCompiler::MAX_STACK;
+    static constexpr size_t REGS = VmCompiler::MAX_VARS + VmCompiler::MAX_NESTING;
+
+    explicit PluginVm(VmBackend &backend);
+
+    /**
+     * @brief Verify and start @p code (kept by pointer, must stay valid).
+     *
+     * Checks opcodes, register numbers and that every jump lands on an
+     * instruction; stack depth is checked while running.
+     */
+    bool load(const uint8_t *code, size_t size);
+
+    /// @brief Stop and switch off tones this VM started.
+    void stop();
+
+    /**
+     * @brief Execute at most @p budget instructions.
+     * @param waitUs  Set when WAITING; add it to the previous deadline, not
+     *                to the current time, so lateness does not accumulate.
+     */
+    VmStatus run(uint32_t budget, uint32_t &waitUs);
+
+    VmStatus status() const { return status_; }
+    const char *faultMessage() const { return fault_; }
+    size_t faultPc() const { return faultPc_; }
+    uint32_t executed() const { return executed_; }
+    int32_t reg(size_t i) const { return (i < REGS) ? regs_[i] : 0; }
+
+private:
+    VmStatus trap(const char *message, size_t pc);
+
+    VmBackend &backend_;
+    const uint8_t *code_;
+    size_t size_;
+    size_t pc_;
+    size_t sp_;
+    int32_t stack_[STACK];
+    int32_t regs_[REGS];
+    uint64_t tonePins_;
+    uint32_t executed_;
+    VmStatus status_;
+    const char *fault_;
+    size_t faultPc_;
+};
+
+} // namespace hackos::core
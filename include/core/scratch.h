@@ -0,0 +1,133 @@
+/**
+ * @file scratch.h
+ * @brief System scratch RAM: one static block that subsystems borrow from
+ *        while they are active.
+ *
+ * The net forensics capture ring, the hardware bridge sniff ring, the
+ * RadioManager sample / transmit windows and the ViewAnimator scene
+ * snapshots used to be reserved for the whole uptime although only one
+ * sniffer app runs at a time.  They now lease their buffers here:
+ *
+ * @code
+ *  ScratchLease<CaptureRing> ring_;
+ *  if (!ring_.acquire("nf_ring")) { … refuse to start … }
+ *  ring_->push(…);
+ *  ring_.release();            // or when the lease goes out of scope
+ * @endcode
+ *
+ * Size accounting is done at compile time: ScratchLease<T> refuses a T
+ * that can never fit, and every borrower asserts scratchFootprint<> of
+ * the buffers it can be active together with against CAPACITY.  The
+ * largest such set is the capture ring plus a scene transition.
+ *
+ * Scratch is the device adapter of ScratchArena (scratch_arena.h): it
+ * owns the block, guards the arena with a spinlock (leases are taken from
+ * tasks, never from an ISR) and logs per-tag peaks.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <freertos/FreeRTOS.h>
+
+#include "core/scratch_arena.h"
+
+namespace hackos::core {
+
+/// @brief Arena bytes taken by leases of all of @p Ts at once.
+template <typename... Ts>
+constexpr size_t scratchFootprint()
+{
+    return (ScratchArena::footprint(sizeof(Ts)) + ... + 0U);
+}
+
+// ── Scratch ──────────────────────────────────────────────────────────────────
+
+class Scratch
+{
+public:
+    /// Net forensics ring (8.4 KiB) + ViewAnimator scenes (2 KiB).
+    static constexpr size_t CAPACITY = 10752U;
+
+    static Scratch &instance();
+
+    /// @brief See ScratchArena::lease().  Prefer ScratchLease<T>.
+    void *lease(const char *tag, size_t bytes);
+
+    void release(void *ptr);
+
+    size_t used() const;
+    size_t peak() const;
+
+    /// @brief Log arena use and per-tag leases, peaks and longest holds.
+    void logStats();
+
+private:
+    Scratch();
+
+    static uint32_t nowMs();
+
+    alignas(ScratchArena::ALIGN) uint8_t storage_[CAPACITY];
+    ScratchArena arena_;
+    mutable portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+};
+
+// ── ScratchLease ─────────────────────────────────────────────────────────────
+
+/**
+ * @brief Typed scratch lease: a value-initialised T placed in the arena
+ *        by acquire() and destroyed by release().
+ *
+ * Empty until acquire() succeeds; callers that may fail to get the block
+ * check the result and refuse to start.  Not copyable.
+ */
+template <typename T>
+class ScratchLease
+{
+    static_assert(alignof(T) <= ScratchArena::ALIGN, "scratch type over-aligned");
+    static_assert(scratchFootprint<T>() <= Scratch::CAPACITY, "scratch type larger than the arena");
+
+public:
+    ScratchLease() : ptr_(nullptr) {}
+    ~ScratchLease() { release(); }
+
+    ScratchLease(const ScratchLease &) = delete;
+    ScratchLease &operator=(const ScratchLease &) = delete;
+
+    /// @param tag  Static string the statistics are kept under.
+    /// @return true if held (also when it already was).
+    bool acquire(const char *tag)
+    {
+        if (ptr_ == nullptr)
+        {
+            void *p = Scratch::instance().lease(tag, sizeof(T));
+            if (p != nullptr)
+            {
+                ptr_ = new (p) T();
+            }
+        }
+        return ptr_ != nullptr;
+    }
+
+    void release()
+    {
+        if (ptr_ != nullptr)
+        {
+            ptr_->~T();
+            Scratch::instance().release(ptr_);
+            ptr_ = nullptr;
+        }
+    }
+
+    T *get() const { return ptr_; }
+    T *operator->() const { return ptr_; }
+    T &operator*() const { return *ptr_; }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+private:
+    T *ptr_;
+};
+
+} // namespace hackos::core
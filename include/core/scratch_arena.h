@@ -0,0 +1,112 @@
+/**
+ * @file scratch_arena.h
+ * @brief Lease-based allocator for the shared scratch RAM block.
+ *
+ * Several subsystems need kilobytes of working memory only while they are
+ * active – a capture ring while sniffing, two scene snapshots during a
+ * transition, a sample window while the radio captures.  Reserving each
+ * of them statically for the whole uptime adds up to more than any moment
+ * ever uses.  ScratchArena hands out leases from one block instead:
+ *
+ *  - lease(tag, bytes) places the block in the lowest gap that fits it,
+ *    which keeps the free space at the top of the arena in one piece
+ *  - release() returns it; neighbouring gaps merge implicitly because the
+ *    arena only keeps the live leases, sorted by offset
+ *  - every lease names a static tag; per tag it keeps lease / failure
+ *    counts, the bytes currently held, the peak and the longest hold
+ *
+ * Portable: the memory and the time are passed in, so
+ * tools/scratch_arena_bench.cpp replays app sessions against it.  Scratch
+ * (scratch.h) is the device adapter that owns the block and guards it
+ * with a spinlock.  Not thread-safe.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::core {
+
+// ── ScratchArena ─────────────────────────────────────────────────────────────
+
+class ScratchArena
+{
+public:
+    static constexpr size_t MAX_LEASES = 8U;
+    static constexpr size_t MAX_TAGS = 8U;
+    static constexpr size_t ALIGN = 8U;   ///< Every lease starts on this boundary
+
+    struct TagStats
+    {
+        const char *tag;         ///< nullptr for an unused entry
+        uint32_t leases;
+        uint32_t failures;       ///< Leases refused (no gap large enough)
+        uint32_t bytes;          ///< Held now
+        uint32_t peakBytes;
+        uint32_t maxHoldMs;
+    };
+
+    /// @brief Bytes a lease of @p bytes occupies in the arena.
+    static constexpr size_t footprint(size_t bytes)
+    {
+        return (bytes + ALIGN - 1U) & ~(ALIGN - 1U);
+    }
+
+    /// @param base  ALIGN-aligned block of @p capacity bytes.
+    ScratchArena(uint8_t *base, size_t capacity);
+
+    /**
+     * @brief Lease @p bytes.
+     * @param tag  Static string naming the borrower (compared by pointer
+     *             first, then by content).
+     * @return The block, or nullptr if no gap is large enough, the lease
+     *         table is full or @p bytes is 0.
+     */
+    void *lease(const char *tag, size_t bytes, uint32_t nowMs);
+
+    /// @brief Return a block from lease().
+    /// @return false if @p ptr is not a live lease.
+    bool release(void *ptr, uint32_t nowMs);
+
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Bytes held by live leases.
+    size_t used() const { return used_; }
+
+    /// @brief Most bytes ever held at once.
+    size_t peak() const { return peak_; }
+
+    size_t leases() const { return count_; }
+
+    /// @brief Largest block a lease could get right now.
+    size_t largestFree() const;
+
+    /// @brief Per-tag statistics, index < MAX_TAGS.
+    const TagStats &tagStats(size_t index) const { return tags_[index]; }
+
+    /// @brief Zero counters and peaks; bytes held stay.
+    void resetStats();
+
+private:
+    struct Lease
+    {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t sinceMs;
+        uint8_t tag;   ///< Index into tags_, MAX_TAGS if untracked
+    };
+
+    /// Stats entry of @p tag, created on first use; MAX_TAGS if full.
+    uint8_t tagIndex(const char *tag);
+
+    uint8_t *base_;
+    size_t capacity_;
+    Lease leases_[MAX_LEASES];   ///< Live leases sorted by offset
+    size_t count_;
+    size_t used_;
+    size_t peak_;
+    TagStats tags_[MAX_TAGS];
+};
+
+} // namespace hackos::core
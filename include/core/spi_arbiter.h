@@ -0,0 +1,157 @@
+/**
+ * @file spi_arbiter.h
+ * @brief Priority / deadline scheduling of the shared SPI bus.
+ *
+ * The SD card and the PN532 share VSPI.  With a plain mutex a 32 KiB SD
+ * flush keeps an NFC exchange waiting for tens of milliseconds, and a
+ * PN532 command waiting out its timeout keeps capture writes waiting just
+ * as long.  SpiArbiter decides who gets the bus next:
+ *
+ *  - every request names its client, a BusPriority and optionally a
+ *    deadline hint ("I need the bus within N µs")
+ *  - a request past its deadline outranks every priority class; among
+ *    equals the earliest deadline goes first, then arrival order
+ *  - the holder of a long transfer splits it into slices and checks
+ *    contended() between them; if a better-ranked request is waiting it
+ *    releases and re-queues, so an NFC exchange lands between two SD
+ *    sectors instead of after the whole flush
+ *
+ * Per client it keeps grant counts, log2 histograms of wait and hold
+ * times, the worst wait and the deadline misses; busyUs() against the
+ * stats window gives bus utilisation.
+ *
+ * Portable and non-blocking: time is passed in and nothing sleeps, so
+ * tools/spi_arbiter_bench.cpp drives it with simulated SD and PN532
+ * clients.  SpiBus (system_core.h) is the FreeRTOS adapter that blocks
+ * callers until their ticket is granted.  Not thread-safe.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::core {
+
+/// @brief Base rank of a bus request (higher wins).
+enum class BusPriority : uint8_t
+{
+    BULK = 0U,      ///< SD writes, waiting for an NFC card / reader
+    NORMAL = 1U,    ///< SD reads, open, directory walks
+    LATENCY = 2U,   ///< NFC exchanges with a card in the field
+};
+
+// ── SpiArbiter ───────────────────────────────────────────────────────────────
+
+class SpiArbiter
+{
+public:
+    static constexpr size_t MAX_CLIENTS = 4U;
+    static constexpr size_t MAX_REQUESTS = 8U;
+    /// Bucket b counts times below 64 µs << b; the last one is open-ended.
+    static constexpr size_t HIST_BUCKETS = 12U;
+    static constexpr uint32_t HIST_BASE_US = 64U;
+
+    struct ClientStats
+    {
+        uint32_t grants;
+        uint32_t cancels;          ///< Requests dropped before their grant
+        uint32_t deadlineMisses;   ///< Granted after their deadline
+        uint32_t maxWaitUs;
+        uint32_t maxHoldUs;
+        uint32_t busyUs;           ///< Total hold time
+        uint32_t waitHist[HIST_BUCKETS];
+        uint32_t holdHist[HIST_BUCKETS];
+    };
+
+    SpiArbiter();
+
+    /**
+     * @brief Queue a request for the bus.
+     * @param budgetUs  Deadline hint relative to @p nowUs; 0 for none.
+     * @return Ticket, or -1 if the queue is full or @p client is invalid.
+     */
+    int request(uint8_t client, BusPriority prio, uint32_t budgetUs, uint32_t nowUs);
+
+    /// @brief Hand a free bus to the best-ranked request.
+    /// @return The granted ticket, or -1 (bus held or queue empty).
+    int grant(uint32_t nowUs);
+
+    /// @brief Drop a queued request (e.g. its caller timed out).
+    /// @return false if @p ticket is not queued (already granted or unknown).
+    bool cancel(int ticket);
+
+    /// @brief End the hold of @p ticket; call grant() next.
+    void release(int ticket, uint32_t nowUs);
+
+    bool isGranted(int ticket) const;
+
+    /// @brief Ticket holding the bus, -1 if free.
+    int holder() const { return holder_; }
+
+    /// @brief Requests waiting for the bus.
+    size_t queued() const;
+
+    /**
+     * @brief Whether the holder should yield at its next slice boundary:
+     *        a queued request outranks it or has missed its deadline.
+     */
+    bool contended(uint32_t nowUs) const;
+
+    const ClientStats &stats(uint8_t client) const;
+
+    /// @brief Bus hold time, all clients, since resetStats().
+    uint32_t busyUs() const { return busyUs_; }
+
+    /// @brief Time since resetStats().
+    uint32_t windowUs(uint32_t nowUs) const { return nowUs - windowStartUs_; }
+
+    /// @brief Utilisation in per mille over the stats window.
+    uint32_t utilisationPermille(uint32_t nowUs) const;
+
+    /// @brief Zero the statistics and start a new window.
+    void resetStats(uint32_t nowUs);
+
+    static size_t bucketOf(uint32_t us);
+
+    /// @brief Upper edge of histogram bucket @p b (UINT32_MAX for the last).
+    static uint32_t bucketLimitUs(size_t b);
+
+    /// @brief Time below which @p permille of @p hist falls (bucket edge).
+    static uint32_t percentileUs(const uint32_t (&hist)[HIST_BUCKETS], uint32_t permille);
+
+private:
+    enum class Slot : uint8_t
+    {
+        FREE,
+        QUEUED,
+        GRANTED,
+    };
+
+    struct Request
+    {
+        Slot state;
+        uint8_t client;
+        BusPriority prio;
+        bool hasDeadline;
+        uint32_t seq;
+        uint32_t queuedUs;
+        uint32_t deadlineUs;
+        uint32_t grantedUs;
+    };
+
+    /// Effective class: the priority, or one above all if overdue.
+    uint8_t rankClass(const Request &r, uint32_t nowUs) const;
+    /// True if queued request @p a goes before queued request @p b.
+    bool before(const Request &a, const Request &b, uint32_t nowUs) const;
+    static bool overdue(const Request &r, uint32_t nowUs);
+
+    Request reqs_[MAX_REQUESTS];
+    int holder_;
+    uint32_t nextSeq_;
+    uint32_t busyUs_;
+    uint32_t windowStartUs_;
+    ClientStats stats_[MAX_CLIENTS];
+};
+
+} // namespace hackos::core
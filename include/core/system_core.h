@@ -5,8 +5,9 @@
  * ThreadManager  – creates the four main FreeRTOS tasks using
  *                  xTaskCreateStatic (zero heap fragmentation).
  *
- * HardwareBus    – strict mutexes for the shared I2C and SPI buses so
- *                  no app can corrupt ongoing transfers.
+ * HardwareBus    – a strict mutex for the I2C bus and a prioritised
+ *                  arbiter (SpiBus) for the SPI bus, so no app can
+ *                  corrupt ongoing transfers.
  *
  * @note Everything lives in the hackos::core namespace.
  */
@@ -19,6 +20,8 @@
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 
+#include "core/spi_arbiter.h"
+
 namespace hackos::core {
 
 // ── HardwareBus ──────────────────────────────────────────────────────────────
@@ -54,11 +57,96 @@ private:
     StaticSemaphore_t buffer_;
 };
 
+/// @brief Clients of the shared SPI bus (SpiArbiter client ids).
+enum class SpiClient : uint8_t
+{
+    SD = 0U,
+    NFC = 1U,
+};
+
+/**
+ * @brief SpiArbiter behind a FreeRTOS lock: acquire() blocks the caller
+ *        until its request is granted.
+ *
+ * Waiters sleep on a binary semaphore per arbiter ticket; release() grants
+ * the next request and wakes its task.  Not recursive – a task must not
+ * acquire the bus twice.  Long transfers take the bus once and call
+ * yieldIfContended() between slices.
+ */
+class SpiBus
+{
+public:
+    SpiBus();
+
+    /// @brief Create the lock and wake-up semaphores.
+    bool init();
+
+    /**
+     * @brief Queue for the bus and block until granted.
+     * @param budgetUs  Deadline hint (0 = none); past it the request
+     *                  outranks every priority.
+     * @return false on timeout, a full queue or before init().
+     */
+    bool acquire(SpiClient client, BusPriority prio, uint32_t budgetUs = 0U,
+                 TickType_t ticksToWait = pdMS_TO_TICKS(1000U));
+
+    /// @brief Release the bus and hand it to the best waiter.
+    void release();
+
+    /**
+     * @brief Slice boundary of a long transfer: if a better request is
+     *        waiting, let it run and queue again with the same client and
+     *        priority.
+     * @return false if the bus could not be re-acquired.
+     */
+    bool yieldIfContended(TickType_t ticksToWait = pdMS_TO_TICKS(1000U));
+
+    /// @brief Log per-client waits, holds and utilisation, then reset.
+    void logStats();
+
+private:
+    static uint32_t nowUs();
+
+    SemaphoreHandle_t lock_;
+    StaticSemaphore_t lockBuf_;
+    SemaphoreHandle_t wake_[SpiArbiter::MAX_REQUESTS];
+    StaticSemaphore_t wakeBuf_[SpiArbiter::MAX_REQUESTS];
+    SpiArbiter arbiter_;
+    int ticket_;   ///< Held ticket, -1 if none
+    SpiClient holderClient_;
+    BusPriority holderPrio_;
+};
+
+/**
+ * @brief Scoped SpiBus hold.
+ *
+ * If the bus cannot be had within the default timeout the lease is empty
+ * and the caller goes ahead anyway: Arduino SPI transactions still keep
+ * single transfers intact, only the scheduling is lost.
+ */
+class SpiLease
+{
+public:
+    SpiLease(SpiClient client, BusPriority prio, uint32_t budgetUs = 0U);
+    ~SpiLease();
+
+    SpiLease(const SpiLease &) = delete;
+    SpiLease &operator=(const SpiLease &) = delete;
+
+    /// @brief See SpiBus::yieldIfContended().
+    void yield();
+
+    explicit operator bool() const { return held_; }
+
+private:
+    bool held_;
+};
+
 /**
- * @brief Central access point for all hardware-bus mutexes.
+ * @brief Central access point for all hardware-bus locks.
  *
  * Call HardwareBus::init() once during boot.  Then use i2c() / spi()
- * to obtain the relevant mutex before touching a shared bus.
+ * to obtain the relevant lock before touching a shared bus.
  */
 class HardwareBus
 {
@@ -69,8 +157,8 @@ public:
     /// @brief Mutex guarding the I2C bus (OLED display).
     static BusMutex &i2c();
 
-    /// @brief Mutex guarding the SPI bus (SD card, NFC module).
-    static BusMutex &spi();
+    /// @brief Arbiter for the SPI bus (SD card, NFC module).
+    static SpiBus &spi();
 
 private:
     HardwareBus() = delete;
@@ -0,0 +1,149 @@
+/**
+ * @file time_series.h
+ * @brief Multi-resolution time-series store with LTTB downsampling.
+ *
+ * Keeps a long history of a regularly sampled value (voltage, RSSI,
+ * packets per second …) in a few KB.  Level 0 holds the newest raw
+ * samples; every @c factor buckets of a level roll up into one min / max /
+ * mean bucket of the next, coarser level.  With 7 levels × 128 buckets and
+ * a factor of 4, a 50 ms sample period reaches back 7 h in 5.25 KB while
+ * the last 6 s stay at full resolution, and any span is backed by at
+ * least 128 / 4 = 32 buckets.  Coarser levels trail the newest sample by
+ * up to one of their buckets.
+ *
+ * Readers never see more buckets than they can show:
+ *  - envelope() reads the finest level holding the span and folds it into
+ *    one min / max / mean column per pixel (OLED charts: a vertical line
+ *    per column keeps spikes visible at any zoom).
+ *  - downsample() runs Largest-Triangle-Three-Buckets over the bucket
+ *    means of the same level, for charts drawn as polylines (dashboard).
+ *
+ * @code
+ *  hackos::core::TimeSeriesBuffer<4, 96> rssi(1000U, 8U);  // 1 s, ~13 h
+ *  rssi.push(-67);
+ *  hackos::core::TsBucket cols[128];
+ *  const size_t n = rssi.envelope(3600000U, cols, 128U);  // last hour
+ * @endcode
+ *
+ * Not thread-safe; callers sharing a series between tasks guard it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::core {
+
+/// @brief One bucket (a single sample has min == max == mean).
+struct TsBucket
+{
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+};
+
+/// @brief One downsampled point.
+struct TsPoint
+{
+    uint32_t ageMs;   ///< Time before the newest sample (0 = newest)
+    int16_t value;
+};
+
+// ── TimeSeries ───────────────────────────────────────────────────────────────
+
+class TimeSeries
+{
+public:
+    static constexpr size_t MAX_LEVELS = 8U;
+
+    TimeSeries();
+
+    /**
+     * @brief Attach bucket storage and reset.
+     * @param storage   levels × capacity buckets, valid while in use.
+     * @param periodMs  Interval between push() calls.
+     * @param factor    Buckets of one level per bucket of the next (≥ 2).
+     */
+    bool begin(TsBucket *storage, size_t levels, size_t capacity, uint32_t periodMs,
+               uint8_t factor);
+
+    /// @brief Drop all history.
+    void clear();
+
+    /// @brief Append the sample for the next period.
+    void push(int16_t value);
+
+    size_t levels() const { return levels_; }
+    size_t capacity() const { return capacity_; }
+    size_t count(size_t level) const;
+    uint32_t bucketMs(size_t level) const;
+    uint32_t samples() const { return samples_; }
+
+    /// @brief Time covered by the retained history.
+    uint32_t historyMs() const;
+
+    /// @brief Bucket @p age of @p level (0 = newest, age < count(level)).
+    const TsBucket &at(size_t level, size_t age) const;
+
+    /**
+     * @brief Min / max / mean columns of spanMs / width each for the newest
+     *        @p spanMs, oldest first.
+     * @return Columns written: @p width, or fewer (right-aligned, the newest
+     *         last) while the history is shorter than the span.
+     */
+    size_t envelope(uint32_t spanMs, TsBucket *out, size_t width) const;
+
+    /**
+     * @brief LTTB-reduce the newest @p spanMs to at most @p maxPoints
+     *        points (≥ 3), oldest first, always keeping both ends.
+     * @return Points written.
+     */
+    size_t downsample(uint32_t spanMs, TsPoint *out, size_t maxPoints) const;
+
+private:
+    /// Partial bucket of the next level being accumulated.
+    struct Pending
+    {
+        int32_t sum;
+        int16_t min;
+        int16_t max;
+        uint8_t n;
+    };
+
+    void add(size_t level, const TsBucket &b);
+    /// Finest level whose history covers min(spanMs, historyMs()).
+    size_t coveringLevel(uint32_t spanMs) const;
+    size_t bucketsFor(size_t level, uint32_t spanMs) const;
+
+    TsBucket *storage_;
+    size_t levels_;
+    size_t capacity_;
+    uint32_t periodMs_;
+    uint8_t factor_;
+    uint32_t samples_;
+    size_t head_[MAX_LEVELS];    ///< Next write slot per level
+    size_t count_[MAX_LEVELS];
+    Pending pending_[MAX_LEVELS];
+};
+
+// ── TimeSeriesBuffer ─────────────────────────────────────────────────────────
+
+/// @brief TimeSeries with its bucket storage inline.
+template <size_t LEVELS, size_t CAPACITY>
+class TimeSeriesBuffer : public TimeSeries
+{
+    static_assert(LEVELS >= 1U && LEVELS <= MAX_LEVELS, "1..MAX_LEVELS levels");
+    static_assert(CAPACITY >= 2U, "at least two buckets per level");
+
+public:
+    TimeSeriesBuffer(uint32_t periodMs, uint8_t factor) : storage_{}
+    {
+        (void)begin(storage_, LEVELS, CAPACITY, periodMs, factor);
+    }
+
+private:
+    TsBucket storage_[LEVELS * CAPACITY];
+};
+
+} // namespace hackos::core
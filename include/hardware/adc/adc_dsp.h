@@ -0,0 +1,134 @@
+/**
+ * @file adc_dsp.h
+ * @brief Block-processing kernels for continuous ADC acquisition.
+ *
+ * The AdcStream worker hands every DMA block to these kernels.  They are
+ * integer-only, keep their state between blocks (so block boundaries are
+ * invisible in the output) and are platform-independent.
+ * tools/adc_dsp_bench.cpp checks and times them on the host.
+ *
+ *  - blockStats()     – min / max / mean / AC RMS of a block
+ *  - unpackI2sAdc()   – raw I2S built-in ADC words → 12-bit samples
+ *  - Oversampler      – sum 4^n samples → 12 + n bit result
+ *  - FirDecimator     – Q15 low-pass FIR, keeps every M-th output
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::adc {
+
+static constexpr uint16_t ADC_FULL_SCALE = 4095U;
+static constexpr uint8_t  ADC_BITS = 12U;
+
+// ── Block statistics ─────────────────────────────────────────────────────────
+
+struct AdcBlockStats
+{
+    uint16_t min;
+    uint16_t max;
+    uint16_t meanQ4;      ///< Mean in 1/16 LSB
+    uint16_t acRmsQ4;     ///< RMS about the mean (noise / ripple) in 1/16 LSB
+    uint32_t count;
+};
+
+/// @brief Statistics of @p count samples (all zero for an empty block).
+void blockStats(const uint16_t *samples, size_t count, AdcBlockStats *out);
+
+/**
+ * @brief Unpack I2S built-in ADC words in place.
+ *
+ * Each word carries the channel in bits 15-12 and the sample in bits 11-0,
+ * and the I2S FIFO hands them over with each pair swapped.  The pairs are
+ * put back into time order and the channel bits are cleared.
+ *
+ * @return Samples unpacked (@p count rounded down to even).
+ */
+size_t unpackI2sAdc(uint16_t *words, size_t count);
+
+// ── Oversampler ──────────────────────────────────────────────────────────────
+
+/**
+ * @brief Oversampling by 4^n with decimation (n extra bits).
+ *
+ * Sums groups of 4^n samples and shifts by n, so white noise of about one
+ * LSB turns into n extra bits of resolution at 1/4^n of the rate.
+ */
+class Oversampler
+{
+public:
+    static constexpr uint8_t MAX_EXTRA_BITS = 4U;
+
+    Oversampler() : bits_(0U), group_(1U), sum_(0U), have_(0U) {}
+
+    /// @return false if @p extraBits > MAX_EXTRA_BITS.
+    bool configure(uint8_t extraBits);
+    void reset();
+
+    /// @return Outputs written (at most count / 4^n + 1).
+    size_t process(const uint16_t *in, size_t count, uint16_t *out);
+
+    uint8_t extraBits() const { return bits_; }
+    uint32_t factor() const { return group_; }
+
+private:
+    uint8_t bits_;
+    uint32_t group_;
+    uint32_t sum_;
+    uint32_t have_;
+};
+
+// ── FIR decimator ────────────────────────────────────────────────────────────
+
+/**
+ * @brief Low-pass FIR filter followed by decimation.
+ *
+ * Only every M-th output is computed.  Samples are centred around
+ * mid-scale before the Q15 multiply, so a 32-bit accumulator cannot
+ * overflow for 16-bit inputs.  Tap sets are normalised to unity DC gain.
+ */
+class FirDecimator
+{
+public:
+    static constexpr size_t MAX_TAPS = 64U;
+
+    FirDecimator();
+
+    /**
+     * @brief Use caller taps (Q15, taps[0] weights the oldest sample).
+     * @param inputBits Resolution of the samples fed in (12-16).
+     * @return false if @p count is 0 or above MAX_TAPS, @p factor is 0 or
+     *         @p inputBits is out of range.
+     */
+    bool configure(const int16_t *taps, size_t count, uint8_t factor,
+                   uint8_t inputBits = ADC_BITS);
+
+    /**
+     * @brief Windowed-sinc (Blackman) low-pass with its cut-off at 80 % of
+     *        the post-decimation Nyquist frequency.
+     */
+    bool configureLowpass(size_t count, uint8_t factor, uint8_t inputBits = ADC_BITS);
+
+    /// @brief Clear the delay line (history fills with mid-scale).
+    void reset();
+
+    /// @return Outputs written (at most count / factor + 1).
+    size_t process(const uint16_t *in, size_t count, uint16_t *out);
+
+    size_t taps() const { return count_; }
+    uint8_t factor() const { return factor_; }
+
+private:
+    int16_t taps_[MAX_TAPS];
+    int32_t hist_[2U * MAX_TAPS];   ///< Mirrored ring: a window never wraps
+    size_t count_;
+    size_t pos_;
+    uint8_t factor_;
+    uint8_t phase_;
+    int32_t mid_;                   ///< Mid-scale of the input range
+    int32_t top_;                   ///< Largest output value
+};
+
+} // namespace hackos::adc
@@ -0,0 +1,133 @@
+/**
+ * @file adc_stream.h
+ * @brief Continuous DMA ADC acquisition with block processing on a worker
+ *        task.
+ *
+ * On the ESP32 the ADC streams through I2S0 in built-in ADC mode: the I2S
+ * DMA fills a ring of DMA_BUFFERS blocks of BLOCK_SAMPLES samples at a
+ * hardware-paced rate, with no CPU involvement per sample.  A worker task
+ * pinned to core 0 takes each finished block while the DMA fills the next
+ * one, and runs the adc_dsp.h kernels on it:
+ *
+ * @code
+ *  DMA block ─► unpack ─► blockStats ──────────────► latest()
+ *                  └────► Oversampler ─► FirDecimator ─► history ─► read()
+ * @endcode
+ *
+ * Apps poll the results instead of calling analogRead() in the UI task:
+ * latest() returns min / max / mean / RMS of the newest block, and read()
+ * pulls the processed sample stream from a history ring.  Each reader
+ * keeps its own cursor, so several views can read the same stream.
+ *
+ * Only ADC1 pins (GPIO 32-39) can be streamed; start() fails for others
+ * and callers keep their polled path.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "hardware/adc/adc_dsp.h"
+
+namespace hackos::adc {
+
+struct AdcStreamConfig
+{
+    uint8_t  pin = 36U;             ///< ADC1 pin
+    uint32_t rateHz = 20000U;       ///< Hardware sample rate
+    uint8_t  oversampleBits = 0U;   ///< 0-4: 4^n samples per output, 12 + n bits
+    uint8_t  decimation = 1U;       ///< > 1: FIR low-pass, then every n-th sample
+};
+
+struct AdcStreamStats
+{
+    uint32_t rateHz;         ///< Hardware sample rate
+    uint32_t outputHz;       ///< Rate of the processed stream
+    uint8_t  outputBits;     ///< Resolution of the processed stream
+    uint32_t blocks;         ///< DMA blocks processed
+    uint32_t overruns;       ///< DMA ring overflows (blocks lost)
+    uint16_t cpuPermille;    ///< Worker time per block / block duration
+};
+
+class AdcStream
+{
+public:
+    static constexpr size_t   BLOCK_SAMPLES   = 512U;
+    static constexpr size_t   DMA_BUFFERS     = 4U;
+    static constexpr size_t   HISTORY_SAMPLES = 4096U;   ///< Power of two
+    static constexpr size_t   FIR_TAPS        = 31U;
+    static constexpr uint32_t MIN_RATE_HZ     = 10000U;
+    static constexpr uint32_t MAX_RATE_HZ     = 500000U;
+
+    static AdcStream &instance();
+
+    /// @brief ADC1 channel of @p pin, or -1 if the pin is not on ADC1.
+    static int8_t adc1Channel(uint8_t pin);
+
+    /**
+     * @brief Start streaming.
+     * @return false if already running, the pin is not on ADC1, the rate
+     *         or processing options are out of range, or the driver / task
+     *         cannot be set up.
+     */
+    bool start(const AdcStreamConfig &config);
+
+    /// @brief Stop the worker and release I2S0 and the history ring.
+    void stop();
+
+    bool isRunning() const { return running_; }
+
+    /// @brief Statistics of the newest raw block; false before the first.
+    bool latest(AdcBlockStats *out) const;
+
+    /// @brief Samples produced so far (a cursor at the live end).
+    uint32_t produced() const { return head_; }
+
+    /**
+     * @brief Copy processed samples from @p *cursor on and advance it.
+     *
+     * A cursor that fell more than HISTORY_SAMPLES behind skips ahead to
+     * the oldest retained sample; the skipped count goes to @p lost.
+     *
+     * @return Samples copied (≤ @p max).
+     */
+    size_t read(uint32_t *cursor, uint16_t *out, size_t max, uint32_t *lost = nullptr) const;
+
+    /// @brief Copy the newest @p count processed samples (oldest first).
+    size_t newest(uint16_t *out, size_t count) const;
+
+    void stats(AdcStreamStats *out) const;
+
+private:
+    AdcStream();
+    AdcStream(const AdcStream &) = delete;
+    AdcStream &operator=(const AdcStream &) = delete;
+
+    static void taskEntry(void *arg);
+    void run();
+    void processBlock(size_t count);
+
+    AdcStreamConfig config_;
+    Oversampler oversampler_;
+    FirDecimator fir_;
+    QueueHandle_t events_;             ///< I2S driver events (overflows)
+
+    uint16_t block_[BLOCK_SAMPLES];
+    uint16_t *history_;
+    volatile uint32_t head_;
+
+    AdcBlockStats latest_;
+    bool haveLatest_;
+    mutable portMUX_TYPE latestMux_ = portMUX_INITIALIZER_UNLOCKED;
+
+    volatile bool running_;
+    volatile bool taskDone_;
+    volatile uint32_t blocks_;
+    volatile uint32_t overruns_;
+    volatile uint16_t cpuPermille_;
+};
+
+} // namespace hackos::adc
@@ -4,6 +4,24 @@
 #include <Adafruit_SSD1306.h>
 #include <cstddef>
 #include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "hardware/display/frame_pipeline.h"
+
+/// @brief Frame pipeline figures since the last logStats().
+struct DisplayStats
+{
+    uint32_t fpsTenths;            ///< Frames on the panel per second ×10
+    uint16_t occupancyPermille[hackos::display::FramePipeline::SLOTS + 1U];
+                                   ///< Share of time with 0 / 1 / 2 frames in flight
+    uint32_t pagesSent;
+    uint32_t pagesSkipped;         ///< Unchanged pages not sent
+    uint32_t waits;                ///< present() calls that waited for a slot
+    uint32_t dropped;              ///< Queued frames overwritten by a newer one
+    uint32_t errors;               ///< Pages the panel NAKed
+};
 
 class DisplayManager
 {
@@ -17,21 +35,55 @@ public:
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color = SSD1306_WHITE);
     void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color = SSD1306_WHITE);
     void drawText(int16_t x, int16_t y, const char *text, uint8_t textSize = 1U, uint16_t color = SSD1306_WHITE);
+
+    /**
+     * @brief Hand the frame to the I2C driver task and return.
+     *
+     * Only waits if two frames are already in flight (one on the wire,
+     * one queued).  After PRESENT_WAIT_MS it overwrites the queued frame
+     * that has not started sending, so the newest frame is never dropped.
+     */
     void present();
     bool isInitialized() const;
 
     /// @brief Direct access to the SSD1306 display buffer for DMA-style writes.
     uint8_t *getDisplayBuffer();
 
+    DisplayStats stats() const;
+
+    /// @brief Log stats() and start a new window.
+    void logStats();
+
 private:
     static constexpr int16_t WIDTH = 128;
     static constexpr int16_t HEIGHT = 64;
     static constexpr size_t BUFFER_SIZE = static_cast<size_t>(WIDTH) * static_cast<size_t>(HEIGHT) / 8U;
+    static constexpr uint32_t PRESENT_WAIT_MS = 100U;
+    static constexpr uint32_t TX_STACK = 2048U;
+    static constexpr UBaseType_t TX_PRIO = 3U;   ///< GUI_Task priority (system_core.h)
+
+    static_assert(BUFFER_SIZE == hackos::display::FramePipeline::FRAME_BYTES,
+                  "pipeline frame size");
 
     DisplayManager();
 
+    static void txTaskEntry(void *param);
+    void txLoop();
+    /// One SSD1306 page over I2C.
+    bool sendPage(uint8_t page, const uint8_t *data);
+    static uint32_t nowUs();
+
     Adafruit_SSD1306 display_;
     GFXcanvas1 backBuffer_;
-    uint8_t frontBuffer_[BUFFER_SIZE];
+    hackos::display::FramePipeline pipeline_;
+    SemaphoreHandle_t lock_;          ///< Guards pipeline_
+    StaticSemaphore_t lockBuf_;
+    SemaphoreHandle_t presentLock_;   ///< GUI and app tasks both present()
+    StaticSemaphore_t presentLockBuf_;
+    SemaphoreHandle_t slotFree_;
+    StaticSemaphore_t slotFreeBuf_;
+    TaskHandle_t txTask_;
+    StaticTask_t txTcb_;
+    StackType_t txStack_[TX_STACK];
     bool initialized_;
 };
@@ -0,0 +1,147 @@
+/**
+ * @file frame_pipeline.h
+ * @brief Double-buffered SSD1306 frame queue between the renderer and the
+ *        I2C driver task.
+ *
+ * A full 128×64 frame is 1 KiB on a 400 kHz I2C bus – about 26 ms on the
+ * wire.  Sending it from present() stalls the renderer for all of that;
+ * with FramePipeline the renderer copies the finished frame into a free
+ * slot, submits it and goes on composing the next one while a driver task
+ * sends the previous one page by page:
+ *
+ * @code
+ *  renderer:  acquire() ─► copy frame ─► submit() ─────► compose next …
+ *  driver:                      nextPage() ─► I2C ─► pageDone() ─► … ─► slot free
+ * @endcode
+ *
+ *  - SLOTS frames can be in flight (one on the wire, one queued); acquire()
+ *    returns nullptr while both are busy and the renderer waits.  A
+ *    renderer that cannot wait any longer takes the queued, not yet started
+ *    frame back with replaceQueued() and overwrites it: only that older
+ *    frame is lost, never the newest.
+ *  - Frames go out in order.  submit() compares each page with the frame
+ *    submitted before, which is exactly what the panel holds once the
+ *    queue ahead has drained, and only changed pages are sent.  After a
+ *    failed page the next frame goes out whole.
+ *  - Stats: frames submitted / sent / superseded, pages sent / skipped,
+ *    renderer waits, and how long 0, 1 or 2 frames were in flight
+ *    (pipeline occupancy); fpsTenths() is frames completed over the stats
+ *    window.
+ *
+ * Portable: time is passed in, the bus is the caller's business.  The
+ * device adapter (DisplayManager) guards it with a mutex and runs the
+ * driver side on its own task; tools/frame_pipeline_bench.cpp drives it
+ * against a simulated I2C bus with per-byte timings.  Not thread-safe.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::display {
+
+// ── FramePipeline ────────────────────────────────────────────────────────────
+
+class FramePipeline
+{
+public:
+    static constexpr size_t WIDTH = 128U;
+    static constexpr size_t PAGES = 8U;   ///< 8-pixel rows of the SSD1306
+    static constexpr size_t FRAME_BYTES = WIDTH * PAGES;
+    static constexpr size_t SLOTS = 2U;
+
+    struct Stats
+    {
+        uint32_t submitted;
+        uint32_t sent;             ///< Frames completed (including all-clean ones)
+        uint32_t superseded;       ///< Queued frames overwritten by replaceQueued()
+        uint32_t pagesSent;
+        uint32_t pagesSkipped;     ///< Unchanged pages not sent
+        uint32_t pageErrors;
+        uint32_t waits;            ///< acquire() calls that found no free slot
+        uint32_t occupancyUs[SLOTS + 1U];   ///< Time with n frames in flight
+    };
+
+    FramePipeline();
+
+    /// @brief Slot to copy the next frame into, nullptr while all are busy.
+    uint8_t *acquire();
+
+    /**
+     * @brief Take back the newest queued frame that has not started sending.
+     *
+     * Its slot is handed out as by acquire() – copy the new frame in and
+     * submit() – and the frame it held is dropped.
+     * @return nullptr if only the frame on the wire is queued.
+     */
+    uint8_t *replaceQueued(uint32_t nowUs);
+
+    /// @brief Queue the slot from acquire() or replaceQueued() for sending.
+    bool submit(uint32_t nowUs);
+
+    /**
+     * @brief Driver side: next page to send.
+     * @param[out] data  FRAME_BYTES / PAGES bytes, valid until pageDone().
+     * @return false if nothing is queued.
+     */
+    bool nextPage(uint8_t *page, const uint8_t **data);
+
+    /**
+     * @brief Driver side: the page from nextPage() is on the panel (or not).
+     * @return true if this completed a frame (a slot became free).
+     */
+    bool pageDone(bool ok, uint32_t nowUs);
+
+    /// @brief Send the next frame whole (panel content unknown).
+    void invalidate();
+
+    /// @brief Frames submitted but not yet completed.
+    size_t inFlight() const { return queued_; }
+
+    /// @brief Frames completed since construction; waiters compare it.
+    uint32_t completed() const { return completed_; }
+
+    const Stats &stats() const { return stats_; }
+
+    /// @brief Frames completed per second over the stats window, ×10.
+    uint32_t fpsTenths(uint32_t nowUs) const;
+
+    uint32_t windowUs(uint32_t nowUs) const { return nowUs - windowStartUs_; }
+
+    /// @brief Zero the statistics and start a new window.
+    void resetStats(uint32_t nowUs);
+
+private:
+    enum class Slot : uint8_t
+    {
+        FREE,
+        FILLING,
+        QUEUED,
+    };
+
+    /// Finish the head frame: free its slot and move on.
+    void completeHead(uint32_t nowUs);
+    /// Charge the time since the last change to the current occupancy.
+    void account(uint32_t nowUs);
+    /// Next dirty page of the head frame at or after @p from, PAGES if none.
+    uint8_t nextDirty(uint8_t from) const;
+
+    uint8_t frames_[SLOTS][FRAME_BYTES];
+    Slot state_[SLOTS];
+    uint8_t dirty_[SLOTS];   ///< Bit n: page n differs from the frame before
+    uint32_t seq_[SLOTS];    ///< Submit order
+    int filling_;            ///< Slot handed out by acquire(), -1 if none
+    int last_;               ///< Last submitted slot (diff base), -1 if none
+    size_t head_;            ///< Oldest queued slot
+    size_t queued_;
+    uint8_t page_;           ///< Page of the head frame being sent
+    bool full_;              ///< Next submitted frame goes out whole
+    uint32_t nextSeq_;
+    uint32_t completed_;
+    uint32_t lastChangeUs_;
+    uint32_t windowStartUs_;
+    Stats stats_;
+};
+
+} // namespace hackos::display
@@ -0,0 +1,100 @@
+/**
+ * @file edge_capture.h
+ * @brief Shared GPIO edge-capture service with cycle-counter timestamps.
+ *
+ * Apps used to install their own GPIO ISR on the RF RX pin, each with its
+ * own buffer and esp_timer_get_time() timestamps.  EdgeCapture owns one
+ * ISR per pin instead: the handler reads the CPU cycle counter and the
+ * GPIO input register directly (no driver calls) and pushes the edge into
+ * an EdgeRing.  Apps subscribe an EdgeReader to the pin and drain pulses
+ * at their own pace, so several views – and the RadioManager adapter –
+ * share one capture.
+ *
+ * The first subscriber installs the ISR with its EdgeCaptureConfig; later
+ * subscribers share that ring and filter.  The last unsubscribe removes
+ * the handler and frees the ring.  subscribe / unsubscribe / read are for
+ * task context only.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+
+#include "hardware/edge/edge_ring.h"
+
+namespace hackos::edge {
+
+struct EdgeCaptureConfig
+{
+    size_t   ringEdges = 1024U;   ///< Power of two
+    uint32_t glitchNs = 0U;       ///< Drop pulses shorter than this (0 = off)
+};
+
+struct EdgeCaptureStats
+{
+    EdgeRingStats ring;
+    uint8_t  pin;
+    uint8_t  subscribers;
+    uint32_t cyclesPerUs;
+    size_t   ringEdges;
+};
+
+class EdgeCapture
+{
+public:
+    static constexpr size_t MAX_PINS = 4U;
+    static constexpr size_t MAX_RING_EDGES = 8192U;
+
+    static EdgeCapture &instance();
+
+    /**
+     * @brief Attach @p reader to the edges of @p pin.
+     * @return false if the reader is already attached, all pin slots are
+     *         taken, @p config is out of range, or the ISR cannot be
+     *         installed.
+     */
+    bool subscribe(uint8_t pin, EdgeReader *reader,
+                   const EdgeCaptureConfig &config = EdgeCaptureConfig());
+
+    void unsubscribe(uint8_t pin, EdgeReader *reader);
+
+    /// @brief Settle the glitch filter, then EdgeReader::readPulses().
+    size_t readPulses(uint8_t pin, EdgeReader *reader, int32_t *out, size_t max,
+                      int32_t maxUs);
+
+    /// @brief Settle the glitch filter, then EdgeReader::readEdges().
+    size_t readEdges(uint8_t pin, EdgeReader *reader, EdgeStamp *out, size_t max);
+
+    /// @return false if nothing captures @p pin.
+    bool stats(uint8_t pin, EdgeCaptureStats *out) const;
+
+private:
+    struct Channel
+    {
+        EdgeRing ring;
+        uint32_t *buf = nullptr;
+        uint32_t bit = 0U;               ///< Pin mask in its input register
+        bool highBank = false;           ///< GPIO 32-39
+        uint8_t pin = 0U;
+        uint8_t subscribers = 0U;
+        volatile int32_t isrCore = -1;   ///< Core the handler last ran on
+        portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+    EdgeCapture();
+    EdgeCapture(const EdgeCapture &) = delete;
+    EdgeCapture &operator=(const EdgeCapture &) = delete;
+
+    static void isr(void *arg);
+
+    Channel *find(uint8_t pin);
+    const Channel *find(uint8_t pin) const;
+    void settle(Channel *ch);
+
+    Channel channels_[MAX_PINS];
+    uint32_t cyclesPerUs_;
+};
+
+} // namespace hackos::edge
@@ -0,0 +1,217 @@
+/**
+ * @file edge_ring.h
+ * @brief Glitch-filtered edge ring shared by several readers.
+ *
+ * One producer (the GPIO edge ISR) stores each accepted edge as a single
+ * 32-bit word – the CPU cycle count with its lowest bit replaced by the
+ * new pin level – so a slot is published with one store.  Any number of
+ * EdgeReaders consume the same ring, each with its own cursor; the
+ * producer never waits for them.  A reader that falls more than the ring
+ * capacity behind skips ahead and counts the edges it lost.
+ *
+ * Glitch filter: with a minimum pulse width set, the newest edge is held
+ * back as "pending" until it has lasted that long.  An opposite edge
+ * inside the window cancels both edges, so pulses shorter than the
+ * minimum never reach a reader.  settle() publishes a pending edge once
+ * it is old enough even if no further edge arrives.
+ *
+ * Timestamps are 32-bit cycle counts; gaps longer than 2^32 cycles
+ * (~17.9 s at 240 MHz) alias, which consumers clamping long gaps ignore.
+ *
+ * Everything here is platform-independent; EdgeCapture is the ESP32
+ * producer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__)
+#define HACKOS_EDGE_INLINE inline __attribute__((always_inline))
+#else
+#define HACKOS_EDGE_INLINE inline
+#endif
+
+namespace hackos::edge {
+
+struct EdgeStamp
+{
+    uint32_t cycles;   ///< CPU cycle count (bit 0 cleared)
+    uint8_t level;     ///< Pin level after the edge
+};
+
+struct EdgeRingStats
+{
+    uint32_t edges;       ///< Edges seen by the producer
+    uint32_t glitches;    ///< Edges dropped by the filter
+    uint32_t published;   ///< Edges made visible to readers
+};
+
+// ── EdgeRing (producer side) ─────────────────────────────────────────────────
+
+class EdgeRing
+{
+public:
+    static constexpr uint8_t LEVEL_UNKNOWN = 0xFFU;
+
+    EdgeRing();
+
+    /// @return false unless @p cap is a power of two ≥ 2.
+    bool attach(uint32_t *buf, size_t cap);
+
+    /// @brief Forget all edges and set the glitch window (0 = off).
+    void reset(uint32_t minPulseCycles);
+
+    size_t capacity() const { return cap_; }
+    uint32_t minPulseCycles() const { return min_; }
+
+    /// @brief Index one past the newest published edge.
+    uint32_t head() const { return head_; }
+
+    /// @brief Slot word of edge @p index (valid while within capacity).
+    uint32_t word(uint32_t index) const { return buf_[index & mask_]; }
+
+    void stats(EdgeRingStats *out) const;
+
+    /**
+     * @brief Record an edge (producer only, ISR-safe, no allocation).
+     *
+     * Calls from the producer and settle() must be serialised by the
+     * caller when the glitch filter is on.
+     */
+    HACKOS_EDGE_INLINE void onEdge(uint32_t cycles, uint8_t level)
+    {
+        edges_ = edges_ + 1U;
+        if (min_ == 0U)
+        {
+            if (level == level_)
+            {
+                glitches_ = glitches_ + 1U; // missed the opposite edge
+                return;
+            }
+            publish(cycles, level);
+            return;
+        }
+
+        if (pending_)
+        {
+            if (cycles - pendingCycles_ < min_)
+            {
+                // The pulse started by the pending edge is too short.
+                glitches_ = glitches_ + 1U;
+                if (level != pendingLevel_)
+                {
+                    pending_ = false;
+                    glitches_ = glitches_ + 1U;
+                }
+                return;
+            }
+            if (level == pendingLevel_)
+            {
+                glitches_ = glitches_ + 1U;
+                return;
+            }
+            publish(pendingCycles_, pendingLevel_);
+        }
+        else if (level == level_)
+        {
+            glitches_ = glitches_ + 1U;
+            return;
+        }
+        pendingCycles_ = cycles;
+        pendingLevel_ = level;
+        pending_ = true;
+    }
+
+    /**
+     * @brief Publish the pending edge if it is at least the glitch window
+     *        older than @p nowCycles (same clock as the producer).
+     */
+    HACKOS_EDGE_INLINE void settle(uint32_t nowCycles)
+    {
+        if (pending_ && nowCycles - pendingCycles_ >= min_)
+        {
+            pending_ = false;
+            publish(pendingCycles_, pendingLevel_);
+        }
+    }
+
+private:
+    HACKOS_EDGE_INLINE void publish(uint32_t cycles, uint8_t level)
+    {
+        const uint32_t h = head_;
+        buf_[h & mask_] = (cycles & ~1UL) | (level & 1U);
+        level_ = level;
+        published_ = published_ + 1U;
+        head_ = h + 1U; // publish after the slot
+    }
+
+    uint32_t *buf_;
+    size_t cap_;
+    uint32_t mask_;
+    volatile uint32_t head_;
+
+    uint32_t min_;
+    uint8_t level_;           ///< Level after the newest published edge
+    bool pending_;
+    uint8_t pendingLevel_;
+    uint32_t pendingCycles_;
+
+    volatile uint32_t edges_;
+    volatile uint32_t glitches_;
+    volatile uint32_t published_;
+};
+
+// ── EdgeReader (consumer side) ───────────────────────────────────────────────
+
+/**
+ * @brief Independent cursor over an EdgeRing.
+ *
+ * Pulses come out in the Flipper SubGhz RAW convention used across the
+ * RF apps: positive = HIGH (mark), negative = LOW (space), in µs.
+ */
+class EdgeReader
+{
+public:
+    EdgeReader();
+
+    /// @brief Start reading @p ring at its live end.
+    void attach(const EdgeRing *ring, uint32_t cyclesPerUs);
+    void detach();
+    bool attached() const { return ring_ != nullptr; }
+
+    /// @brief Follow a CPU clock change (pulses spanning it are mis-timed).
+    void setCyclesPerUs(uint32_t cyclesPerUs) { cyclesPerUs_ = (cyclesPerUs == 0U) ? 1U : cyclesPerUs; }
+
+    /// @brief Drop everything not yet read and restart pulse pairing.
+    void skipToLive();
+
+    /// @return Edges copied (≤ @p max), oldest first.
+    size_t readEdges(EdgeStamp *out, size_t max);
+
+    /**
+     * @brief Convert new edges into signed pulse durations.
+     *
+     * The pulse ending at each edge is emitted once both its edges are
+     * known; the first edge after attach / loss only seeds the timing.
+     * Durations above @p maxUs are clamped.
+     *
+     * @return Pulses written (≤ @p max).
+     */
+    size_t readPulses(int32_t *out, size_t max, int32_t maxUs);
+
+    /// @brief Edges skipped because the producer lapped this reader.
+    uint32_t lost() const { return lost_; }
+
+private:
+    const EdgeRing *ring_;
+    uint32_t cursor_;
+    uint32_t cyclesPerUs_;
+    uint32_t lost_;
+    uint32_t prevCycles_;
+    uint8_t prevLevel_;
+    bool primed_;
+};
+
+} // namespace hackos::edge
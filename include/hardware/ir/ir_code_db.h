@@ -0,0 +1,239 @@
+/**
+ * @file ir_code_db.h
+ * @brief Compiled binary IR code database: CSV compiler, streaming
+ *        reader and O(log n) reverse lookup.
+ *
+ * The text databases (`brand,protocol_id,hex_code,bits` per line, see
+ * data/ir/README_SD_FORMAT.md) are compiled into a `.irdb` file whose
+ * records are fixed-size and sorted by (protocol, value, bits).  A reader
+ * never loads the file: playback streams records in order through a small
+ * window, and a captured code is mapped back to its brand by binary
+ * search inside the protocol's slice of the file.
+ *
+ * File layout (little-endian):
+ * @code
+ *  header   32 B  "HIRD" ver:u16 protocols:u16 records:u32
+ *                 recordsOff:u32 stringsOff:u32 stringsSize:u32
+ *                 sourceBytes:u32 reserved:u32
+ *  index    12 B × protocols   protocol:u16 pad:u16 first:u32 count:u32
+ *  records  16 B × records     value:u64 protocol:u16 bits:u16 brandOff:u32
+ *  strings  NUL-terminated brand names (deduplicated)
+ * @endcode
+ *
+ * The compiler sorts with bounded memory: records are collected into a
+ * caller-supplied run buffer, each full buffer is sorted and spilled to a
+ * run file, and the runs are k-way merged into the output.  The same code
+ * compiles on the device (runs on SD) and on the host
+ * (tools/irdb_compile).
+ *
+ * Everything is platform-independent; I/O goes through IrByteSink and
+ * IrByteSource.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::ir {
+
+// ── Format ───────────────────────────────────────────────────────────────────
+
+static constexpr uint16_t IRDB_VERSION       = 1U;
+static constexpr size_t   IRDB_HEADER_SIZE   = 32U;
+static constexpr size_t   IRDB_INDEX_SIZE    = 12U;
+static constexpr size_t   IRDB_RECORD_SIZE   = 16U;
+static constexpr size_t   IRDB_MAX_PROTOCOLS = 64U;
+
+/// @brief One compiled code.
+struct IrCodeRecord
+{
+    uint64_t value;
+    uint16_t protocol;   ///< IRremoteESP8266 decode_type_t
+    uint16_t bits;
+    uint32_t brand;      ///< Offset of the brand name in the string table
+};
+
+/// @brief Slice of the record table holding one protocol.
+struct IrProtocolSlice
+{
+    uint16_t protocol;
+    uint32_t first;
+    uint32_t count;
+};
+
+// ── I/O interfaces ───────────────────────────────────────────────────────────
+
+/// @brief Sequential output (compiled file, run file).
+class IrByteSink
+{
+public:
+    virtual ~IrByteSink() = default;
+    virtual bool write(const uint8_t *data, size_t len) = 0;
+};
+
+/// @brief Random-access input.
+class IrByteSource
+{
+public:
+    virtual ~IrByteSource() = default;
+    virtual uint32_t size() const = 0;
+    /// @return Bytes read (short only at end of data or on error).
+    virtual size_t readAt(uint32_t offset, uint8_t *buf, size_t len) = 0;
+};
+
+// ── Compiler ─────────────────────────────────────────────────────────────────
+
+/**
+ * @brief CSV → .irdb compiler with an external merge sort.
+ *
+ * @code
+ *  IrCodeDbBuilder b(runBuf, RUN_RECORDS);
+ *  b.begin(runSink);
+ *  while (...) b.feed(text, n);
+ *  b.finish();                 // close the run file, reopen it as a source
+ *  b.write(outSink, runSource);
+ * @endcode
+ *
+ * Exact duplicates (same code, bits and brand) inside one run are dropped.
+ */
+class IrCodeDbBuilder
+{
+public:
+    static constexpr size_t MAX_RUNS    = 64U;
+    static constexpr size_t STRING_POOL = 4096U;
+
+    /// @param runBuf  Sort buffer; its capacity bounds the run length.
+    IrCodeDbBuilder(IrCodeRecord *runBuf, size_t runCap);
+
+    /// @brief Start a build; sorted runs are appended to @p runOut.
+    void begin(IrByteSink &runOut);
+
+    /**
+     * @brief Parse the next chunk of CSV text.
+     *
+     * Lines may be split across chunks.  Blank lines, `#` comments and
+     * malformed lines are skipped (counted in skippedLines()).
+     *
+     * @return false once the build has failed (run sink error, too many
+     *         runs, protocols or brand names).
+     */
+    bool feed(const char *text, size_t len);
+
+    /// @brief Parse a final line without newline and spill the last run.
+    bool finish();
+
+    /**
+     * @brief Merge the runs into the compiled database.
+     * @param out  Destination of the .irdb image.
+     * @param runs The bytes written to the run sink, read back.
+     */
+    bool write(IrByteSink &out, IrByteSource &runs);
+
+    uint32_t recordCount() const { return records_; }
+    size_t runCount() const { return runCount_; }
+    size_t protocolCount() const { return protoCount_; }
+    uint32_t skippedLines() const { return skipped_; }
+    /// @brief CSV bytes fed (stored in the header to detect a changed source).
+    uint32_t sourceBytes() const { return sourceBytes_; }
+
+private:
+    static constexpr size_t LINE_MAX = 128U;
+
+    bool parseLine();
+    bool spillRun();
+    int internBrand(const char *name);
+    bool countProtocol(uint16_t protocol);
+
+    IrCodeRecord *buf_;
+    size_t cap_;
+    size_t used_;
+    IrByteSink *runOut_;
+
+    uint32_t runStart_[MAX_RUNS];
+    uint32_t runLen_[MAX_RUNS];
+    size_t runCount_;
+    uint32_t records_;
+
+    IrProtocolSlice protos_[IRDB_MAX_PROTOCOLS];
+    size_t protoCount_;
+
+    char pool_[STRING_POOL];
+    size_t poolUsed_;
+    int lastBrand_;
+
+    char line_[LINE_MAX];
+    size_t lineLen_;
+    bool lineOverflow_;
+    uint32_t skipped_;
+    uint32_t sourceBytes_;
+    bool ok_;
+};
+
+// ── Reader ───────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Streaming access to a compiled database.
+ *
+ * Holds the header, the protocol index and a window of WINDOW_RECORDS
+ * records, so sequential playback costs one read per window and a lookup
+ * costs about log2(protocol slice) reads.
+ */
+class IrCodeDb
+{
+public:
+    static constexpr size_t WINDOW_RECORDS = 16U;
+
+    IrCodeDb();
+
+    /// @brief Validate the header and load the protocol index.
+    bool open(IrByteSource &source);
+    void close();
+
+    bool isOpen() const { return source_ != nullptr; }
+    uint32_t count() const { return count_; }
+    uint32_t sourceBytes() const { return sourceBytes_; }
+    size_t protocolCount() const { return protoCount_; }
+    const IrProtocolSlice &protocol(size_t index) const { return protos_[index]; }
+
+    /// @brief Record @p index in (protocol, value, bits) order.
+    bool record(uint32_t index, IrCodeRecord *out);
+
+    /**
+     * @brief Copy the brand name of @p rec (truncated to @p len - 1).
+     * @return false if the offset is outside the string table.
+     */
+    bool brand(const IrCodeRecord &rec, char *out, size_t len);
+
+    /**
+     * @brief Find the first record for a captured code.
+     *
+     * Further brands sharing the code follow at index + 1, … .
+     *
+     * @param bits 0 = match any bit length.
+     * @return false if the code is not in the database.
+     */
+    bool find(uint16_t protocol, uint64_t value, uint16_t bits, uint32_t *index);
+
+    /// @brief Source reads performed (window refills + lookups).
+    uint32_t reads() const { return reads_; }
+
+private:
+    bool loadWindow(uint32_t index);
+
+    IrByteSource *source_;
+    uint32_t count_;
+    uint32_t recordsOff_;
+    uint32_t stringsOff_;
+    uint32_t stringsSize_;
+    uint32_t sourceBytes_;
+    IrProtocolSlice protos_[IRDB_MAX_PROTOCOLS];
+    size_t protoCount_;
+
+    uint8_t window_[WINDOW_RECORDS * IRDB_RECORD_SIZE];
+    uint32_t windowFirst_;
+    uint32_t windowCount_;
+    uint32_t reads_;
+};
+
+} // namespace hackos::ir
@@ -0,0 +1,192 @@
+/**
+ * @file ir_raw_codec.h
+ * @brief Dictionary + back-reference compression for raw IR captures.
+ *
+ * Protocols IRremoteESP8266 cannot decode (air conditioners, odd TV
+ * remotes) only exist as a mark/space timing list of up to a few hundred
+ * entries.  Such lists are highly redundant: a handful of distinct
+ * durations, a handful of distinct (mark, space) pairs – one per bit value
+ * plus header and trailer – and a frame that is usually sent two or three
+ * times.  The codec exploits all three levels:
+ *
+ *  1. durations are clustered into a dictionary (exact values when the
+ *     tolerance is 0, otherwise the rounded mean of each cluster);
+ *  2. consecutive (mark, space) pairs of dictionary indices form a pair
+ *     table;
+ *  3. the sequence of pair indices is bit-packed, with repeated stretches
+ *     (bit runs, repeated frames) replaced by LZ77-style copies.
+ *
+ * A typical 200-timing AC frame shrinks to well under a tenth of its
+ * 16-bit array form.  The decoder regenerates the dictionary timings
+ * exactly, one duration at a time, straight from the blob.
+ *
+ * Blob layout (little-endian):
+ * @code
+ *  header  10 B           "HIRR" ver:u8 carrierKhz:u8 count:u16 dict:u8 pairs:u8
+ *  dict     2 B × dict    duration in µs, ascending
+ *  pairs    2 B × pairs   markIdx:u8 spaceIdx:u8
+ *  stream   bit-packed tokens, MSB first, zero-padded
+ *
+ *  token   = literal | copy
+ *  literal = pair index                      (w bits)
+ *  copy    = ESC distance:γ length:γ         (ESC = pairs, w bits)
+ *  w       = bits needed for 0 … pairs;  γ = Elias gamma code
+ * @endcode
+ *
+ * Timings alternate mark, space, mark, … starting with a mark.  An odd
+ * @c count ends on a mark; the space of the last pair is then not emitted.
+ *
+ * Everything is platform-independent and allocation-free.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::ir {
+
+// ── Format ───────────────────────────────────────────────────────────────────
+
+static constexpr uint8_t IR_RAW_VERSION     = 1U;
+static constexpr size_t  IR_RAW_HEADER_SIZE = 10U;
+
+/// Longest timing list (matches the IRrecv capture buffer).
+static constexpr size_t IR_RAW_MAX_TIMINGS = 1024U;
+static constexpr size_t IR_RAW_MAX_PAIRS   = IR_RAW_MAX_TIMINGS / 2U;
+static constexpr size_t IR_RAW_MAX_DICT    = 64U;
+static constexpr size_t IR_RAW_MAX_PAIR_TABLE = 255U;
+
+/// Upper bound of an encoded blob (every pair a literal of at most 8 bits).
+static constexpr size_t IR_RAW_MAX_BYTES =
+    IR_RAW_HEADER_SIZE + 2U * IR_RAW_MAX_DICT + 2U * IR_RAW_MAX_PAIR_TABLE +
+    IR_RAW_MAX_PAIRS;
+
+/// Spread of durations merged into one dictionary entry for IRrecv
+/// captures (µs).  IR Tools retries once doubled if a very noisy capture
+/// overflows the dictionary.
+static constexpr uint16_t IR_RAW_TOLERANCE_US = 150U;
+
+// ── Encoder ──────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Compress a mark/space timing list.
+ *
+ * @code
+ *  IrRawEncoder enc;
+ *  size_t len = 0U;
+ *  if (enc.encode(timings, count, 38U, 100U, blob, sizeof(blob), &len)) …
+ * @endcode
+ *
+ * The object holds about 1.5 KB of scratch; keep one around or allocate it
+ * for the duration of a save.
+ */
+class IrRawEncoder
+{
+public:
+    /// Shortest copy worth emitting (in pairs).
+    static constexpr size_t MIN_MATCH = 2U;
+
+    IrRawEncoder();
+
+    /**
+     * @param timings     Durations in µs, alternating mark / space.
+     * @param toleranceUs Widest spread merged into one dictionary entry
+     *                    (0 = lossless).
+     * @return false if the list is empty or too long, the dictionary or
+     *         pair table overflows (retry with a larger tolerance), or
+     *         @p cap is too small.
+     */
+    bool encode(const uint16_t *timings, size_t count, uint8_t carrierKhz,
+                uint16_t toleranceUs, uint8_t *out, size_t cap, size_t *outLen);
+
+    /// Statistics of the last successful encode().
+    size_t dictSize() const { return dictCount_; }
+    size_t pairTableSize() const { return pairCount_; }
+    size_t copies() const { return copies_; }
+    /// Largest |decoded - original| in µs.
+    uint16_t maxErrorUs() const { return maxError_; }
+
+private:
+    bool buildDictionary(const uint16_t *timings, size_t count, uint16_t toleranceUs);
+    uint8_t dictIndex(uint16_t us) const;
+    bool buildPairs(const uint16_t *timings, size_t count);
+    size_t longestMatch(size_t pos, size_t *distance) const;
+
+    uint16_t dict_[IR_RAW_MAX_DICT];
+    uint16_t dictLo_[IR_RAW_MAX_DICT];   ///< Smallest duration of each cluster
+    size_t dictCount_;
+    uint8_t pairs_[IR_RAW_MAX_PAIR_TABLE][2];
+    size_t pairCount_;
+    uint8_t seq_[IR_RAW_MAX_PAIRS];
+    size_t seqLen_;
+    size_t copies_;
+    uint16_t maxError_;
+};
+
+// ── Decoder ──────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Streaming decoder reading straight from the blob.
+ *
+ * @code
+ *  IrRawDecoder dec;
+ *  if (dec.begin(blob, len))
+ *      while (dec.next(&us)) …          // or dec.decode(buf, cap)
+ * @endcode
+ *
+ * The blob must stay valid while decoding.  A corrupt stream stops
+ * next() early and sets failed().
+ */
+class IrRawDecoder
+{
+public:
+    IrRawDecoder();
+
+    /// @brief Validate the header and tables and rewind to the first timing.
+    bool begin(const uint8_t *data, size_t len);
+
+    uint16_t count() const { return count_; }
+    uint8_t carrierKhz() const { return carrierKhz_; }
+    size_t dictSize() const { return dictCount_; }
+    bool failed() const { return failed_; }
+
+    /// @brief Next duration in µs; false at the end or on a corrupt stream.
+    bool next(uint16_t *us);
+
+    /**
+     * @brief Rewind and decode the whole list into @p out.
+     * @return Timings written (count() on success, 0 on error or if @p cap
+     *         is too small).
+     */
+    size_t decode(uint16_t *out, size_t cap);
+
+private:
+    bool rewind();
+    bool readBits(uint8_t n, uint32_t *v);
+    bool readGamma(uint32_t *v);
+    bool nextPair(uint8_t *pair);
+
+    const uint8_t *data_;
+    size_t len_;
+    uint16_t count_;
+    uint8_t carrierKhz_;
+    uint16_t dict_[IR_RAW_MAX_DICT];
+    size_t dictCount_;
+    const uint8_t *pairs_;
+    size_t pairCount_;
+    uint8_t width_;
+    size_t streamOff_;
+
+    size_t bitPos_;
+    uint8_t hist_[IR_RAW_MAX_PAIRS];
+    size_t histLen_;
+    uint32_t copyDist_;
+    uint32_t copyLeft_;
+    uint8_t curPair_;
+    bool spaceNext_;
+    uint16_t emitted_;
+    bool failed_;
+};
+
+} // namespace hackos::ir
@@ -28,11 +28,21 @@ public:
     /// Re-transmit the last decoded (or manually set) code.
     void send(uint64_t value, decode_type_t protocol, uint16_t bits);
 
+    /// Transmit a mark/space timing list (µs) on a @p khz carrier.
+    void sendRaw(const uint16_t *timings, uint16_t count, uint16_t khz);
+
     bool hasLastCode() const;
     uint64_t lastValue() const;
     decode_type_t lastProtocol() const;
     uint16_t lastBits() const;
 
+    /**
+     * @brief Mark/space timings (µs) of the last decoded frame, starting
+     *        with the first mark.  Kept for protocols that do not decode.
+     * @return nullptr when nothing has been captured.
+     */
+    const uint16_t *lastRaw(uint16_t *count) const;
+
 private:
     static constexpr uint16_t CAPTURE_BUF = 1024U;
     static constexpr uint8_t TIMEOUT_MS = 50U;
@@ -48,4 +58,6 @@ private:
     uint64_t lastValue_;
     decode_type_t lastProtocol_;
     uint16_t lastBits_;
+    uint16_t lastRaw_[CAPTURE_BUF];
+    uint16_t lastRawCount_;
 };
@@ -0,0 +1,275 @@
+/**
+ * @file bus_decoders.h
+ * @brief Streaming UART / I2C / SPI decoders and VCD export over a
+ *        transition stream.
+ *
+ * The decoders consume LogicEdge records (see transition_log.h) in time
+ * order, one at a time, and never look at the pins.  They run live on the
+ * edges the GpioSampler produces, after a capture on a recorded stream, or
+ * on the host against synthetic waveforms (tools/logic_decode_bench.cpp).
+ *
+ * Decoded items are reported as annotated BusEvents (tick range, value,
+ * flags) to a BusEventSink.  Channel numbers are bit positions in
+ * LogicEdge::state.
+ *
+ *  - UartDecoder – 5-9 data bits, optional parity, fixed baud or auto-baud
+ *    (estimated from the first edges, snapped to a standard rate).
+ *  - I2cDecoder  – START / repeated START / address + R/W / data / ACK /
+ *    STOP.
+ *  - SpiDecoder  – any CPOL/CPHA, optional MISO and chip select, 1-16 bit
+ *    words, MSB or LSB first.
+ *
+ * VcdWriter writes the same stream as a Value Change Dump.  PulseView and
+ * sigrok-cli open it with the sigrok `vcd` input module.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/logic/transition_log.h"
+
+namespace hackos::logic {
+
+/// Channel slot left unused (SPI MISO / CS).
+static constexpr uint8_t LOGIC_NO_CHANNEL = 0xFFU;
+
+// ── Events ───────────────────────────────────────────────────────────────────
+
+enum class BusEventType : uint8_t
+{
+    UART_BYTE,     ///< value = data
+    I2C_START,
+    I2C_RESTART,
+    I2C_ADDRESS,   ///< value = 7-bit address
+    I2C_DATA,      ///< value = byte
+    I2C_STOP,
+    SPI_WORD,      ///< value = MOSI word, value2 = MISO word
+};
+
+static constexpr uint8_t BUS_FLAG_FRAMING = 1U << 0; ///< UART: stop bit low
+static constexpr uint8_t BUS_FLAG_PARITY  = 1U << 1; ///< UART: parity mismatch
+static constexpr uint8_t BUS_FLAG_NACK    = 1U << 2; ///< I2C: 9th bit high
+static constexpr uint8_t BUS_FLAG_READ    = 1U << 3; ///< I2C address: R/W = 1
+static constexpr uint8_t BUS_FLAG_PARTIAL = 1U << 4; ///< SPI: CS ended the word early
+
+struct BusEvent
+{
+    BusEventType type;
+    uint8_t flags;
+    uint16_t value;
+    uint16_t value2;
+    uint64_t startTick;
+    uint64_t endTick;
+};
+
+class BusEventSink
+{
+public:
+    virtual ~BusEventSink() = default;
+    virtual void onBusEvent(const BusEvent &event) = 0;
+};
+
+// ── Decoder base ─────────────────────────────────────────────────────────────
+
+class BusDecoder
+{
+public:
+    explicit BusDecoder(BusEventSink &sink) : sink_(sink), events_(0U) {}
+    virtual ~BusDecoder() = default;
+
+    /// @brief Forget any partial frame (new capture).
+    virtual void reset() = 0;
+
+    /// @brief Next record of the stream (ticks must not decrease).
+    virtual void feed(const LogicEdge &edge) = 0;
+
+    /// @brief End of capture at @p endTick: complete frames still waiting
+    ///        for sample points past the last edge.
+    virtual void finish(uint64_t endTick) { (void)endTick; }
+
+    uint32_t events() const { return events_; }
+
+protected:
+    void emit(const BusEvent &event)
+    {
+        ++events_;
+        sink_.onBusEvent(event);
+    }
+
+    static bool level(uint8_t state, uint8_t channel)
+    {
+        return ((state >> channel) & 1U) != 0U;
+    }
+
+private:
+    BusEventSink &sink_;
+    uint32_t events_;
+};
+
+// ── UART ─────────────────────────────────────────────────────────────────────
+
+enum class UartParity : uint8_t
+{
+    NONE,
+    EVEN,
+    ODD,
+};
+
+struct UartConfig
+{
+    uint8_t channel = 0U;
+    uint32_t baud = 0U;            ///< 0 = auto-detect
+    uint8_t dataBits = 8U;         ///< 5-9, LSB first
+    UartParity parity = UartParity::NONE;
+    bool inverted = false;         ///< Idle low (e.g. after a level shifter)
+};
+
+class UartDecoder final : public BusDecoder
+{
+public:
+    /// Edges buffered to estimate the bit time in auto-baud mode.
+    static constexpr size_t AUTOBAUD_EDGES = 48U;
+
+    /// @param rateHz Sample rate of the stream.
+    UartDecoder(BusEventSink &sink, const UartConfig &config, uint32_t rateHz);
+
+    void reset() override;
+    void feed(const LogicEdge &edge) override;
+    void finish(uint64_t endTick) override;
+
+    /// @brief Baud rate in use (0 while auto-baud is still collecting).
+    uint32_t baud() const { return baud_; }
+
+private:
+    void setBaud(uint32_t baud);
+    bool detectBaud();
+    void lineEdge(uint64_t tick, bool high);
+    void sampleUntil(uint64_t tick);
+    void endFrame();
+
+    UartConfig config_;
+    uint32_t rateHz_;
+    uint32_t baud_;
+    uint64_t bitQ8_;          ///< Bit time in ticks × 256
+
+    bool line_;               ///< Current logical level (true = idle / mark)
+    bool inFrame_;
+    uint64_t frameStart_;
+    uint8_t bitIndex_;        ///< 0 = start bit
+    uint16_t shift_;
+    uint8_t flags_;
+
+    uint64_t pendingTick_[AUTOBAUD_EDGES];
+    bool pendingHigh_[AUTOBAUD_EDGES];
+    size_t pendingCount_;
+};
+
+// ── I2C ──────────────────────────────────────────────────────────────────────
+
+class I2cDecoder final : public BusDecoder
+{
+public:
+    I2cDecoder(BusEventSink &sink, uint8_t sdaChannel, uint8_t sclChannel);
+
+    void reset() override;
+    void feed(const LogicEdge &edge) override;
+
+private:
+    uint8_t sda_;
+    uint8_t scl_;
+    bool active_;             ///< Between START and STOP
+    bool addressPhase_;
+    uint8_t bitCount_;        ///< 0-8; the 9th bit is ACK
+    uint8_t byte_;
+    uint64_t byteStart_;
+};
+
+// ── SPI ──────────────────────────────────────────────────────────────────────
+
+struct SpiConfig
+{
+    uint8_t clk = 0U;
+    uint8_t mosi = 1U;
+    uint8_t miso = LOGIC_NO_CHANNEL;
+    uint8_t cs = LOGIC_NO_CHANNEL;   ///< Active low when present
+    bool cpol = false;               ///< Clock idle level
+    bool cpha = false;               ///< false = sample on the leading edge
+    uint8_t wordBits = 8U;           ///< 1-16
+    bool msbFirst = true;
+};
+
+class SpiDecoder final : public BusDecoder
+{
+public:
+    SpiDecoder(BusEventSink &sink, const SpiConfig &config);
+
+    void reset() override;
+    void feed(const LogicEdge &edge) override;
+
+    /// @brief Switch CPOL/CPHA (drops a partial word).
+    void setMode(bool cpol, bool cpha);
+
+    const SpiConfig &config() const { return config_; }
+
+private:
+    void endWord(uint64_t tick, uint8_t flags);
+
+    SpiConfig config_;
+    bool sampleLevel_;        ///< Clock level right after a sampling edge
+    bool primed_;             ///< First record seen (it only sets levels)
+    uint8_t bits_;
+    uint16_t mosi_;
+    uint16_t miso_;
+    uint64_t wordStart_;
+};
+
+// ── VCD export ───────────────────────────────────────────────────────────────
+
+/// @brief Text output of the exporters.
+class LogicTextSink
+{
+public:
+    virtual ~LogicTextSink() = default;
+    virtual bool write(const char *text, size_t len) = 0;
+};
+
+/**
+ * @brief Value Change Dump writer (1 ns timescale).
+ *
+ * @code
+ *  VcdWriter vcd(out, rateHz);
+ *  vcd.begin(names, 3U, firstEdge.state);
+ *  vcd.edge(e) …;
+ *  vcd.finish(endTick);
+ * @endcode
+ */
+class VcdWriter
+{
+public:
+    VcdWriter(LogicTextSink &out, uint32_t rateHz);
+
+    /// @param names  One signal name per channel.
+    bool begin(const char *const *names, size_t channels, uint8_t initialState);
+
+    /// @brief Write the channels of @p edge that changed.
+    bool edge(const LogicEdge &edge);
+
+    /// @brief Close the dump with a final timestamp.
+    bool finish(uint64_t endTick);
+
+    /// @brief Tick → nanoseconds at the configured rate.
+    uint64_t tickToNs(uint64_t tick) const;
+
+private:
+    bool print(const char *fmt, ...);
+
+    LogicTextSink &out_;
+    uint32_t rateHz_;
+    size_t channels_;
+    uint8_t state_;
+    bool ok_;
+};
+
+} // namespace hackos::logic
@@ -0,0 +1,91 @@
+/**
+ * @file gpio_sampler.h
+ * @brief Fixed-rate GPIO sampler feeding the logic analyser transition log.
+ *
+ * A task pinned to core 0 reads the GPIO input registers in a tight loop
+ * paced by the CPU cycle counter and hands every change of the selected
+ * pins to a TransitionEncoder.  Idle lines cost no memory, so a 16 KiB
+ * ring holds thousands of edges regardless of the sample rate.
+ *
+ * The loop samples in windows of SAMPLE_WINDOW_MS and yields one tick
+ * between windows so the idle task and Wi-Fi keep running.  The timebase
+ * is resynchronised after each yield.  Edges during the yield are not
+ * seen, and that blind time is reported in SamplerStats.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/logic/transition_log.h"
+
+namespace hackos::logic {
+
+/// @brief Throughput figures of the current / last capture.
+struct SamplerStats
+{
+    uint32_t rateHz;         ///< Requested sample rate
+    uint32_t achievedHz;     ///< Samples taken / time spent sampling
+    uint64_t samples;        ///< Samples actually taken
+    uint64_t blindTicks;     ///< Sample slots skipped while yielding
+    uint32_t elapsedMs;
+    TransitionStats log;
+    size_t ringBytes;
+};
+
+class GpioSampler
+{
+public:
+    static constexpr uint32_t DEFAULT_RATE_HZ  = 2000000U;
+    static constexpr size_t   RING_BYTES       = 16384U;
+    static constexpr uint32_t SAMPLE_WINDOW_MS = 10U;
+
+    static GpioSampler &instance();
+
+    /**
+     * @brief Start sampling @p pins (channel n = pins[n]).
+     * @return false if already running, @p count is 0 or above
+     *         LOGIC_MAX_CHANNELS, or the ring / task cannot be allocated.
+     */
+    bool start(const uint8_t *pins, size_t count, uint32_t rateHz = DEFAULT_RATE_HZ);
+
+    /// @brief Stop the task and free the ring (records not read are lost).
+    void stop();
+
+    bool isRunning() const { return running_; }
+
+    /// @brief Consumer side of the transition ring (valid while running).
+    TransitionRing &ring() { return ring_; }
+
+    void stats(SamplerStats *out) const;
+
+private:
+    GpioSampler();
+    GpioSampler(const GpioSampler &) = delete;
+    GpioSampler &operator=(const GpioSampler &) = delete;
+
+    static void taskEntry(void *arg);
+    void run();
+    uint8_t pack(uint32_t in, uint32_t in1) const;
+
+    TransitionRing ring_;
+    TransitionEncoder encoder_;
+    uint8_t *ringBuf_;
+
+    uint8_t pins_[LOGIC_MAX_CHANNELS];
+    size_t channels_;
+    uint32_t mask0_;   ///< GPIO 0-31
+    uint32_t mask1_;   ///< GPIO 32-39
+    uint32_t rateHz_;
+
+    volatile bool running_;
+    volatile bool taskDone_;
+    volatile uint32_t achievedHz_;
+    volatile uint64_t samples_;
+    volatile uint64_t blindTicks_;
+    uint32_t startMs_;
+    uint32_t stopMs_;
+};
+
+} // namespace hackos::logic
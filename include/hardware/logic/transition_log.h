@@ -0,0 +1,171 @@
+/**
+ * @file transition_log.h
+ * @brief Run-length transition log for the logic analyser.
+ *
+ * A sampler reads up to eight channels at a fixed rate, but buses are idle
+ * most of the time.  Instead of storing every sample, TransitionEncoder
+ * stores one record per change of the port state:
+ *
+ * @code
+ *  record = state:u8  delta:LEB128   // delta = samples since the previous record
+ * @endcode
+ *
+ * An edge costs 2 bytes while edges are less than 128 samples apart and at
+ * most 6 bytes; idle time costs nothing.  Records go into a TransitionRing
+ * – a single-producer / single-consumer byte ring in the style of
+ * hackos::radio::RingBuffer – which the sampler task fills and the app
+ * drains with a TransitionReader.
+ *
+ * When the ring is full the record is dropped and counted.  The next stored
+ * record still carries the full delta, so timestamps stay exact and only
+ * the dropped intermediate states are lost.
+ *
+ * Everything here is platform-independent; GpioSampler is the ESP32
+ * producer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::logic {
+
+static constexpr size_t LOGIC_MAX_CHANNELS = 8U;
+
+/// Largest encoded record (state + 5-byte LEB128).
+static constexpr size_t LOGIC_MAX_RECORD = 6U;
+
+// ── TransitionRing ───────────────────────────────────────────────────────────
+
+/**
+ * @brief SPSC byte ring of transition records over a caller buffer.
+ *
+ * Indices run freely and are masked, so the capacity must be a power of
+ * two.  A record is published only once all its bytes are written.
+ */
+class TransitionRing
+{
+public:
+    TransitionRing();
+
+    /// @return false unless @p cap is a power of two ≥ LOGIC_MAX_RECORD.
+    bool attach(uint8_t *buf, size_t cap);
+
+    /// @brief Discard all records (no producer or consumer may be active).
+    void reset();
+
+    size_t capacity() const { return cap_; }
+    size_t used() const { return head_ - tail_; }
+
+    // ── Producer ─────────────────────────────────────────────────────────
+
+    /// @return Bytes written; 0 (nothing written) if the record does not fit.
+    size_t push(uint32_t delta, uint8_t state);
+
+    // ── Consumer ─────────────────────────────────────────────────────────
+
+    bool pop(uint32_t *delta, uint8_t *state);
+
+private:
+    uint8_t *buf_;
+    size_t cap_;
+    size_t mask_;
+    volatile size_t head_;
+    volatile size_t tail_;
+};
+
+// ── TransitionEncoder (producer side) ────────────────────────────────────────
+
+struct TransitionStats
+{
+    uint32_t records;    ///< Records stored
+    uint32_t bytes;      ///< Bytes stored
+    uint32_t dropped;    ///< Records lost to a full ring
+    size_t highWater;    ///< Peak ring occupancy in bytes
+};
+
+/**
+ * @brief Turns port states into records.
+ *
+ * Ticks are sample indices.  A register-loop sampler calls edge() only when
+ * the port changed; block-oriented sources (DMA buffers, host tests) call
+ * feed(), which keeps its own tick count.
+ */
+class TransitionEncoder
+{
+public:
+    /// A same-state record is forced before a delta could overflow.
+    static constexpr uint32_t KEEPALIVE_TICKS = 1UL << 30;
+
+    explicit TransitionEncoder(TransitionRing &ring);
+
+    /// @brief Start a capture; stores (0, @p state) as the first record.
+    void begin(uint8_t state, uint32_t tick = 0U);
+
+    /// @brief The port reads @p state from sample @p tick on.
+    void edge(uint32_t tick, uint8_t state)
+    {
+        if (state != last_)
+        {
+            store(tick, state);
+        }
+    }
+
+    /// @brief Append consecutive samples starting at tick().
+    void feed(const uint8_t *states, size_t count);
+
+    /// @brief Call periodically while idle; keeps deltas below 2^30.
+    void keepAlive(uint32_t tick)
+    {
+        if (tick - lastTick_ >= KEEPALIVE_TICKS)
+        {
+            store(tick, last_);
+        }
+    }
+
+    /// @brief Next tick feed() will use.
+    uint32_t tick() const { return tick_; }
+    uint8_t state() const { return last_; }
+    const TransitionStats &stats() const { return stats_; }
+
+private:
+    void store(uint32_t tick, uint8_t state);
+
+    TransitionRing &ring_;
+    uint8_t last_;
+    uint32_t lastTick_;   ///< Tick of the last stored record
+    uint32_t tick_;
+    TransitionStats stats_;
+};
+
+// ── TransitionReader (consumer side) ─────────────────────────────────────────
+
+/// @brief One decoded record with an absolute timestamp.
+struct LogicEdge
+{
+    uint64_t tick;     ///< Samples since begin()
+    uint8_t state;     ///< Port state from this tick on (bit n = channel n)
+    uint8_t changed;   ///< Channels that differ from the previous record
+};
+
+class TransitionReader
+{
+public:
+    explicit TransitionReader(TransitionRing &ring);
+
+    /// @brief Forget the running time and state (new capture).
+    void reset();
+
+    bool next(LogicEdge *edge);
+
+    uint64_t tick() const { return tick_; }
+    uint8_t state() const { return state_; }
+
+private:
+    TransitionRing &ring_;
+    uint64_t tick_;
+    uint8_t state_;
+};
+
+} // namespace hackos::logic
@@ -0,0 +1,221 @@
+/**
+ * @file mifare_keys.h
+ * @brief Frequency-ordered Mifare Classic key dictionary and per-card
+ *        sector key cache.
+ *
+ * Every failed Mifare Classic authentication leaves the card in the HALT
+ * state, so the reader has to re-select it before the next attempt.  With
+ * a flat key list tried in fixed order, a card keyed with the 6th key
+ * costs five failed auths and five re-selects per sector.  Two structures
+ * cut that down for the cards we dump repeatedly:
+ *
+ *  - **MifareKeyDictionary** – the candidate keys, kept sorted by how
+ *    often each one has opened a sector.  Keys are loaded from a text
+ *    file (one 12-hex-digit key per line, `#` comments) with a streaming
+ *    parser, and the hit counters persist in a small binary side file.
+ *  - **MifareUidCache** – the key that last opened each sector of the
+ *    most recently seen cards, keyed by UID.  A re-dump of a known card
+ *    authenticates every sector on the first try.
+ *
+ * Both are platform-independent; NFCReader owns one instance of each and
+ * handles the file I/O.
+ *
+ * Binary formats (little-endian):
+ * @code
+ *  hits file  : { key[6] hitsLo hitsHi } × n
+ *  cache file : { uid[7] uidLen maskLo maskHi key[6] × 16 } × n   (MRU first)
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::nfc {
+
+// ── Constants ────────────────────────────────────────────────────────────────
+
+static constexpr size_t  MF_KEY_LEN      = 6U;
+static constexpr size_t  MF_MAX_UID_LEN  = 7U;
+static constexpr uint8_t MF_SECTORS_1K   = 16U;
+
+/// @brief Sector that holds absolute block @p block (1K and 4K layouts).
+constexpr uint8_t mifareSectorOf(uint8_t block)
+{
+    return (block < 128U) ? static_cast<uint8_t>(block / 4U)
+                          : static_cast<uint8_t>(32U + (block - 128U) / 16U);
+}
+
+// ── MifareKeyDictionary ──────────────────────────────────────────────────────
+
+/// @brief One candidate key and the number of sectors it has opened.
+struct MifareKeyEntry
+{
+    uint8_t  key[MF_KEY_LEN];
+    uint16_t hits;
+};
+
+/**
+ * @brief Candidate keys ordered by hit count (most successful first).
+ *
+ * Keys with equal hit counts keep their insertion order, so the built-in
+ * defaults stay ahead of dictionary keys until the statistics say otherwise.
+ */
+class MifareKeyDictionary
+{
+public:
+    static constexpr size_t MAX_KEYS          = 64U;
+    static constexpr size_t STATS_RECORD_SIZE = MF_KEY_LEN + 2U;
+
+    MifareKeyDictionary();
+
+    /// @brief Remove every key.
+    void clear();
+
+    /**
+     * @brief Append @p key (duplicates are ignored).
+     * @return false only if the dictionary is full.
+     */
+    bool add(const uint8_t *key);
+
+    /// @brief Index of @p key, or -1.
+    int find(const uint8_t *key) const;
+
+    size_t count() const { return count_; }
+
+    /// @brief Entry @p index in try order (0 = most hits).
+    const MifareKeyEntry &at(size_t index) const { return entries_[index]; }
+
+    /**
+     * @brief Credit @p key with one opened sector and move it forward.
+     *
+     * A key that is not in the dictionary (e.g. from the UID cache after
+     * the dictionary file changed) is added first.
+     */
+    void recordHit(const uint8_t *key);
+
+    // ── Text dictionary parsing (streaming) ─────────────────────────────
+
+    /// @brief Reset the line parser.
+    void beginParse();
+
+    /**
+     * @brief Feed the next chunk of a key file.
+     *
+     * Lines may be split across chunks.  Blank lines, `#` comments and
+     * lines that are not exactly 12 hex digits (surrounding whitespace
+     * allowed) are skipped.
+     *
+     * @return Keys added by this chunk.
+     */
+    size_t feed(const char *data, size_t len);
+
+    /// @brief Flush a final line without a newline.
+    /// @return Keys added.
+    size_t finishParse();
+
+    // ── Persistent hit counters ─────────────────────────────────────────
+
+    /**
+     * @brief Encode the counters of keys with at least one hit.
+     * @return Bytes written (a multiple of STATS_RECORD_SIZE).
+     */
+    size_t encodeStats(uint8_t *out, size_t cap) const;
+
+    /**
+     * @brief Apply hit counters produced by encodeStats().
+     *
+     * Records may arrive in any number of calls.  Unknown keys are added;
+     * the try order is rebuilt after every call.
+     *
+     * @return Records applied.
+     */
+    size_t applyStats(const uint8_t *in, size_t len);
+
+    /// @brief Counters changed since the last clearDirty().
+    bool isDirty() const { return dirty_; }
+    void clearDirty() { dirty_ = false; }
+
+private:
+    static constexpr size_t LINE_MAX = 32U;
+
+    size_t parseLine();
+    void sortByHits();
+
+    MifareKeyEntry entries_[MAX_KEYS];
+    size_t count_;
+    bool dirty_;
+
+    char line_[LINE_MAX];
+    size_t lineLen_;
+    bool lineOverflow_;
+};
+
+// ── MifareUidCache ───────────────────────────────────────────────────────────
+
+/**
+ * @brief Last working key per sector for the most recently seen cards.
+ *
+ * Entries are kept in most-recently-used order; storing a key for a new
+ * UID when the cache is full evicts the least recently used card.
+ */
+class MifareUidCache
+{
+public:
+    static constexpr size_t MAX_UIDS    = 8U;
+    static constexpr size_t RECORD_SIZE = MF_MAX_UID_LEN + 3U + MF_SECTORS_1K * MF_KEY_LEN;
+
+    MifareUidCache();
+
+    void clear();
+
+    /**
+     * @brief Key that last opened @p sector of this card.
+     * @return false if the card or sector is unknown.
+     */
+    bool lookup(const uint8_t *uid, uint8_t uidLen, uint8_t sector,
+                uint8_t *keyOut);
+
+    /// @brief Remember @p key for @p sector of this card.
+    void store(const uint8_t *uid, uint8_t uidLen, uint8_t sector,
+               const uint8_t *key);
+
+    /// @brief Drop a cached key that no longer works (card re-keyed).
+    void forget(const uint8_t *uid, uint8_t uidLen, uint8_t sector);
+
+    /// @brief Number of sectors with a cached key for this card.
+    uint8_t knownSectors(const uint8_t *uid, uint8_t uidLen) const;
+
+    size_t count() const { return count_; }
+
+    /// @brief Encode all entries, most recently used first.
+    size_t encode(uint8_t *out, size_t cap) const;
+
+    /// @brief Replace the cache with records produced by encode().
+    /// @return Entries loaded.
+    size_t decode(const uint8_t *in, size_t len);
+
+    bool isDirty() const { return dirty_; }
+    void clearDirty() { dirty_ = false; }
+
+private:
+    struct Entry
+    {
+        uint8_t  uid[MF_MAX_UID_LEN];
+        uint8_t  uidLen;
+        uint16_t knownMask;
+        uint8_t  keys[MF_SECTORS_1K][MF_KEY_LEN];
+    };
+
+    int findEntry(const uint8_t *uid, uint8_t uidLen) const;
+
+    /// @brief Move entry @p index to the front; returns the new index (0).
+    size_t touch(size_t index);
+
+    Entry entries_[MAX_UIDS];
+    size_t count_;
+    bool dirty_;
+};
+
+} // namespace hackos::nfc
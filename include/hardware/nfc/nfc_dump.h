@@ -0,0 +1,295 @@
+/**
+ * @file nfc_dump.h
+ * @brief Streaming NFC dump conversion (.bin ↔ Flipper .nfc), block diff
+ *        engine and constant-memory hex pager.
+ *
+ * Raw `.bin` dumps are the card memory as-is: 16-byte blocks for Mifare
+ * Classic, 4-byte pages for NTAG/Ultralight.  The Flipper `.nfc` format
+ * is a line-oriented text file with a small header and one
+ * `Block N: XX XX …` / `Page N: XX XX XX XX` line per unit.
+ *
+ * Every class here works on arbitrarily sized chunks and holds at most
+ * one text line or one unit of state, so files of any size are converted,
+ * compared or displayed in constant memory.  Output goes to an
+ * NfcByteSink and random-access input comes from an NfcPageSource; the
+ * app supplies SD-backed implementations, tests can use memory ones.
+ *
+ * Everything is platform-independent.
+ *
+ * @code
+ *  NfcBinToFlipper enc(sink);
+ *  enc.begin(info);
+ *  while ((n = reader.readChunk(buf, sizeof(buf))) > 0) enc.feed(buf, n);
+ *  enc.finish();
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::nfc {
+
+// ── Dump description ─────────────────────────────────────────────────────────
+
+enum class NfcDumpKind : uint8_t
+{
+    MIFARE_CLASSIC_1K,
+    MIFARE_CLASSIC_4K,
+    NTAG,              ///< NTAG21x / Ultralight (4-byte pages)
+};
+
+static constexpr size_t NFC_BLOCK_SIZE = 16U;
+static constexpr size_t NFC_PAGE_SIZE  = 4U;
+
+/// @brief Bytes per unit (block or page) for @p kind.
+constexpr size_t nfcUnitSize(NfcDumpKind kind)
+{
+    return (kind == NfcDumpKind::NTAG) ? NFC_PAGE_SIZE : NFC_BLOCK_SIZE;
+}
+
+/// @brief True if @p block is a Mifare Classic sector trailer (1K/4K layout).
+constexpr bool mifareIsTrailer(uint16_t block)
+{
+    return (block < 128U) ? ((block & 3U) == 3U) : ((block & 15U) == 15U);
+}
+
+/// @brief Card identity carried in the .nfc header.
+struct NfcDumpInfo
+{
+    NfcDumpKind kind;
+    uint8_t  uid[7];
+    uint8_t  uidLen;
+    uint8_t  atqa[2];
+    uint8_t  sak;
+    uint16_t units;    ///< Blocks / pages in the dump (0 = unknown)
+};
+
+/**
+ * @brief Decode a Mifare Classic value block.
+ *
+ * Layout: value, ~value, value (int32 LE), then addr, ~addr, addr, ~addr.
+ * @return false if the redundancy checks fail (not a value block).
+ */
+bool mifareDecodeValue(const uint8_t *block, int32_t *value, uint8_t *addr);
+
+// ── I/O interfaces ───────────────────────────────────────────────────────────
+
+/// @brief Destination for converter output.
+class NfcByteSink
+{
+public:
+    virtual ~NfcByteSink() = default;
+    virtual bool write(const uint8_t *data, size_t len) = 0;
+};
+
+/// @brief Random-access read-only dump data.
+class NfcPageSource
+{
+public:
+    virtual ~NfcPageSource() = default;
+    virtual uint32_t size() const = 0;
+    /// @return Bytes read (short only at end of data or on error).
+    virtual size_t readAt(uint32_t offset, uint8_t *buf, size_t len) = 0;
+};
+
+/// @brief NfcPageSource over a RAM buffer.
+class NfcMemorySource final : public NfcPageSource
+{
+public:
+    NfcMemorySource(const uint8_t *data, uint32_t len) : data_(data), len_(len) {}
+
+    uint32_t size() const override { return len_; }
+    size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override;
+
+private:
+    const uint8_t *data_;
+    uint32_t len_;
+};
+
+// ── .bin → .nfc ──────────────────────────────────────────────────────────────
+
+class NfcBinToFlipper
+{
+public:
+    explicit NfcBinToFlipper(NfcByteSink &out);
+
+    /// @brief Write the header for @p info.
+    bool begin(const NfcDumpInfo &info);
+
+    /// @brief Convert the next chunk of raw dump bytes.
+    bool feed(const uint8_t *data, size_t len);
+
+    /// @brief Emit one unit that could not be read (all bytes `??`).
+    bool feedUnknown();
+
+    /**
+     * @brief Emit a trailing partial unit with the missing bytes as `??`.
+     * @return false if any sink write failed.
+     */
+    bool finish();
+
+    uint16_t unitsWritten() const { return unit_; }
+
+private:
+    bool emitUnit(const uint8_t *data, size_t have);
+    bool writeText(const char *text);
+
+    NfcByteSink &out_;
+    NfcDumpKind kind_;
+    uint8_t partial_[NFC_BLOCK_SIZE];
+    size_t partialLen_;
+    uint16_t unit_;
+    bool ok_;
+};
+
+// ── .nfc → .bin ──────────────────────────────────────────────────────────────
+
+class NfcFlipperToBin
+{
+public:
+    explicit NfcFlipperToBin(NfcByteSink &out);
+
+    void begin();
+
+    /**
+     * @brief Parse the next chunk of .nfc text.
+     *
+     * Header fields fill info(); every `Block N:` / `Page N:` line is
+     * written to the sink in order.  Missing units are zero-filled and
+     * unknown bytes (`??`) become 0x00; both are counted in unknownUnits().
+     */
+    bool feed(const char *text, size_t len);
+
+    /// @brief Parse a final line without newline.
+    bool finish();
+
+    const NfcDumpInfo &info() const { return info_; }
+    uint16_t unitsWritten() const { return next_; }
+    uint16_t unknownUnits() const { return unknown_; }
+    /// @brief True once a Device type line was recognised.
+    bool sawHeader() const { return sawHeader_; }
+
+private:
+    static constexpr size_t LINE_MAX = 96U;
+
+    bool parseLine();
+    bool emitUnits(uint16_t index, const char *hex);
+
+    NfcByteSink &out_;
+    NfcDumpInfo info_;
+    char line_[LINE_MAX];
+    size_t lineLen_;
+    bool lineOverflow_;
+    uint16_t next_;
+    uint16_t unknown_;
+    bool sawHeader_;
+    bool ok_;
+};
+
+// ── Block diff ───────────────────────────────────────────────────────────────
+
+/// @brief One changed unit.
+struct NfcBlockDelta
+{
+    uint16_t unit;
+    uint16_t byteMask;  ///< Bit i set = byte i differs
+    bool     trailer;   ///< Mifare sector trailer (keys / access bits)
+    bool     value;     ///< Both sides are valid value blocks
+    int32_t  before;
+    int32_t  after;
+};
+
+/**
+ * @brief Streaming unit-by-unit comparison of two dumps.
+ *
+ * Feed both sides in lock-step (equal-length chunks of any size).  A
+ * changed-unit bitmap covers up to MAX_UNITS; the first MAX_DELTAS changes
+ * are kept in detail, and once full a value-block delta displaces the
+ * newest plain change.
+ */
+class NfcDumpDiff
+{
+public:
+    static constexpr size_t MAX_UNITS  = 256U;
+    static constexpr size_t MAX_DELTAS = 16U;
+
+    NfcDumpDiff();
+
+    void begin(NfcDumpKind kind);
+
+    /// @brief Compare the next @p len bytes of both dumps.
+    void feed(const uint8_t *a, const uint8_t *b, size_t len);
+
+    /// @brief Compare one whole unit at @p unit (e.g. a block read live).
+    void compareUnit(uint16_t unit, const uint8_t *a, const uint8_t *b);
+
+    uint16_t unitsCompared() const { return units_; }
+    uint16_t changedUnits() const { return changed_; }
+    uint16_t valueDeltas() const { return valueDeltas_; }
+    uint16_t trailerChanges() const { return trailers_; }
+
+    bool isChanged(uint16_t unit) const;
+
+    size_t deltaCount() const { return deltaCount_; }
+    const NfcBlockDelta &delta(size_t index) const { return deltas_[index]; }
+
+private:
+    void keep(const NfcBlockDelta &d);
+
+    NfcDumpKind kind_;
+    size_t unitSize_;
+    uint8_t partialA_[NFC_BLOCK_SIZE];
+    uint8_t partialB_[NFC_BLOCK_SIZE];
+    size_t partialLen_;
+    uint16_t units_;
+    uint16_t changed_;
+    uint16_t valueDeltas_;
+    uint16_t trailers_;
+    uint8_t bitmap_[MAX_UNITS / 8U];
+    NfcBlockDelta deltas_[MAX_DELTAS];
+    size_t deltaCount_;
+};
+
+// ── Hex pager ────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Windowed row cache over an NfcPageSource.
+ *
+ * Holds WINDOW_ROWS rows of ROW_BYTES; a row outside the window reloads
+ * it around that row, so scrolling costs one read per half window.
+ */
+class NfcHexPager
+{
+public:
+    static constexpr size_t ROW_BYTES   = 16U;
+    static constexpr size_t WINDOW_ROWS = 8U;
+
+    NfcHexPager();
+
+    /// @brief Page over @p source (nullptr detaches).
+    void attach(NfcPageSource *source);
+
+    uint32_t rowCount() const;
+
+    /**
+     * @brief Bytes of row @p index.
+     * @param[out] len Valid bytes in the row (last row may be short).
+     * @return nullptr if out of range or the read failed.
+     */
+    const uint8_t *row(uint32_t index, size_t *len);
+
+    /// @brief Source reads performed (window refills).
+    uint32_t loads() const { return loads_; }
+
+private:
+    NfcPageSource *source_;
+    uint8_t window_[WINDOW_ROWS * ROW_BYTES];
+    uint32_t firstRow_;
+    size_t windowLen_;
+    bool valid_;
+    uint32_t loads_;
+};
+
+} // namespace hackos::nfc
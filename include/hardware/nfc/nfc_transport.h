@@ -0,0 +1,76 @@
+/**
+ * @file nfc_transport.h
+ * @brief PN532 command transport used by NFCReader.
+ *
+ * NFCReader builds every card command itself (Mifare auth/read/write,
+ * NTAG READ/FAST_READ/WRITE/GET_VERSION, Type 2 target responses) and
+ * hands the raw frames to one of these primitives, which map one-to-one
+ * onto PN532 commands.  The device uses the Adafruit_PN532 SPI driver
+ * (src/hardware/nfc/pn532_spi_transport.cpp); host builds use
+ * Pn532Simulator (hardware/nfc/pn532_sim.h).
+ *
+ * Buffers follow the PN532 frame limit: commands and responses never
+ * exceed NFC_MAX_FRAME bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::nfc {
+
+/// Largest InDataExchange / TgSetData payload we send or accept.
+static constexpr size_t NFC_MAX_FRAME = 64U;
+
+class NfcTransport
+{
+public:
+    virtual ~NfcTransport() = default;
+
+    /// @brief Bring the bus up and wake the PN532.
+    virtual void begin() = 0;
+
+    /// @brief GetFirmwareVersion (0 = no PN532 answered).
+    virtual uint32_t firmwareVersion() = 0;
+
+    /// @brief SAMConfiguration: normal mode, no SAM.
+    virtual bool samConfig() = 0;
+
+    /**
+     * @brief InListPassiveTarget, 106 kbps type A.
+     *
+     * Selects the card in the field; it stays selected until the next
+     * call or until it NAKs a command.
+     *
+     * @param uid    Buffer of at least 7 bytes.
+     * @param uidLen Receives the UID length (4 or 7).
+     */
+    virtual bool inListPassiveTarget(uint8_t *uid, uint8_t *uidLen,
+                                     uint16_t timeoutMs) = 0;
+
+    /**
+     * @brief InDataExchange with the selected card.
+     *
+     * @param[in,out] respLen Capacity on entry, bytes received on return.
+     * @return false on a PN532 error status (timeout, NAK, auth failure).
+     */
+    virtual bool inDataExchange(const uint8_t *cmd, uint8_t cmdLen,
+                                uint8_t *resp, uint8_t *respLen) = 0;
+
+    /// @brief TgInitAsTarget as a passive 106 kbps Type 2 tag.
+    /// @return true once a reader activated us.
+    virtual bool tgInitAsTarget() = 0;
+
+    /// @brief TgGetData: next command from the external reader.
+    /// @param[in,out] cmdLen Capacity on entry, bytes received on return.
+    virtual bool tgGetData(uint8_t *cmd, uint8_t *cmdLen) = 0;
+
+    /// @brief TgSetData: answer the external reader.
+    virtual bool tgSetData(const uint8_t *data, uint8_t len) = 0;
+
+    /// @brief Monotonic microsecond clock used for NtagOpStats.
+    virtual uint32_t nowUs() = 0;
+};
+
+} // namespace hackos::nfc
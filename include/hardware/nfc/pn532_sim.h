@@ -0,0 +1,225 @@
+/**
+ * @file pn532_sim.h
+ * @brief Host-side PN532 simulator answering NFCReader frames from a
+ *        virtual tag image.
+ *
+ * Pn532Simulator implements NfcTransport, so an NFCReader constructed on
+ * it runs the real dump / write / emulation flows without hardware.  The
+ * simulator is platform-independent and keeps a virtual microsecond
+ * clock: every command advances it by a configurable latency, which makes
+ * NtagOpStats and whole-flow timings deterministic and lets command
+ * batching changes be compared on the host.
+ *
+ * Modelled commands:
+ *  - InListPassiveTarget – selects the tag in the field.
+ *  - InDataExchange, Mifare Classic 1K – AUTH A/B (0x60/0x61) against the
+ *    sector trailers, READ (0x30, key A reads back as zeros), WRITE
+ *    (0xA0).  A failed auth, or access to a sector that is not
+ *    authenticated, drops the card to IDLE until it is selected again.
+ *    Block 0 is writable only on a "magic" card.
+ *  - InDataExchange, NTAG21x / Ultralight – GET_VERSION (0x60), READ
+ *    (0x30, wraps at the end of memory), FAST_READ (0x3A), WRITE (0xA2,
+ *    page 3 is OTP) and PWD_AUTH (0x1B).  Ultralight NAKs GET_VERSION and
+ *    FAST_READ.  Any NAK drops the tag to IDLE.
+ *  - TgInitAsTarget / TgGetData / TgSetData – an external reader replays
+ *    the queued commands and every response is recorded.
+ *
+ * NFCReader itself only needs an <esp_log.h> shim on the host.
+ *
+ * @code
+ *  hackos::nfc::Pn532Simulator sim;
+ *  sim.loadNtag(hackos::nfc::SimTagType::NTAG215, uid);
+ *  NFCReader reader(sim);
+ *  reader.init();
+ *  reader.readUID(buf, &len);
+ *  reader.readNtagPages(0U, 135U, dump);
+ *  // sim.stats().exchanges, reader.lastNtagRead().elapsedUs
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/nfc/nfc_transport.h"
+
+namespace hackos::nfc {
+
+// ── Configuration ────────────────────────────────────────────────────────────
+
+enum class SimTagType : uint8_t
+{
+    MIFARE_CLASSIC_1K,
+    NTAG213,
+    NTAG215,
+    NTAG216,
+    ULTRALIGHT,        ///< 16 pages, no GET_VERSION / FAST_READ
+};
+
+/// @brief Virtual time charged per PN532 command.
+struct Pn532SimTiming
+{
+    uint32_t frameUs = 1000U;   ///< Host ↔ PN532 frame, ACK and status per command
+    uint32_t byteUs = 85U;      ///< RF time per byte each way (106 kbps)
+    uint32_t selectUs = 5000U;  ///< REQA + anticollision + SELECT
+    uint32_t authUs = 1500U;    ///< Mifare three-pass authentication
+    uint32_t writeUs = 4100U;   ///< EEPROM programming per write
+    uint32_t timeoutUs = 5000U; ///< No answer / NAK until the PN532 gives up
+    uint32_t targetUs = 2000U;  ///< Reader turnaround in target mode
+};
+
+/// @brief Command counters since the last resetStats().
+struct Pn532SimStats
+{
+    uint32_t commands;      ///< Every transport call
+    uint32_t selects;       ///< InListPassiveTarget
+    uint32_t exchanges;     ///< InDataExchange
+    uint32_t failures;      ///< InDataExchange that returned an error
+    uint32_t auths;         ///< Mifare auth attempts
+    uint32_t authFailures;  ///< … of which rejected
+    uint32_t writes;        ///< Blocks / pages programmed
+    uint32_t targetFrames;  ///< TgGetData + TgSetData
+    uint64_t busyUs;        ///< Virtual time spent in commands
+};
+
+// ── Pn532Simulator ───────────────────────────────────────────────────────────
+
+class Pn532Simulator final : public NfcTransport
+{
+public:
+    /// Largest tag image (Mifare Classic 1K).
+    static constexpr size_t MAX_TAG_BYTES = 1024U;
+    /// Reader commands that can be queued for target mode.
+    static constexpr size_t MAX_TARGET_FRAMES = 32U;
+    /// Byte pool for queued commands plus recorded responses.
+    static constexpr size_t TARGET_POOL_BYTES = 1024U;
+
+    explicit Pn532Simulator(const Pn532SimTiming &timing = Pn532SimTiming());
+
+    // ── Virtual tags ─────────────────────────────────────────────────────
+
+    /**
+     * @brief Place a factory-blank Mifare Classic 1K in the field.
+     *
+     * Every sector uses key A = key B = FF…FF with transport access bits.
+     * @param uidLen 4 or 7.
+     * @param magic  Gen1-style card that accepts writes to block 0.
+     */
+    bool loadMifare1k(const uint8_t *uid, uint8_t uidLen, bool magic = false);
+
+    /// @brief Mifare Classic 1K from a 1024-byte image (4-byte UID in block 0).
+    bool loadMifare1kImage(const uint8_t *image, bool magic = false);
+
+    /// @brief Set key A of @p sector in the loaded Mifare image.
+    bool setSectorKeyA(uint8_t sector, const uint8_t *key);
+
+    /// @brief Place a blank NTAG/Ultralight with a 7-byte @p uid in the field.
+    bool loadNtag(SimTagType type, const uint8_t *uid);
+
+    /// @brief NTAG/Ultralight from a full image (pages × 4 bytes, UID in pages 0-1).
+    bool loadNtagImage(SimTagType type, const uint8_t *image);
+
+    /// @brief Take the tag out of the field.
+    void removeTag();
+
+    bool hasTag() const { return present_; }
+    SimTagType tagType() const { return type_; }
+
+    /// @brief Current tag memory (writes are applied here).
+    const uint8_t *tagMemory() const { return mem_; }
+    size_t tagSize() const { return memSize_; }
+
+    /// @brief Let the next @p count InDataExchange calls time out (tag
+    ///        briefly out of range).  The tag must then be selected again.
+    void dropExchanges(uint8_t count) { dropCount_ = count; }
+
+    // ── External reader (target mode) ────────────────────────────────────
+
+    /// @brief Forget queued commands and recorded responses.
+    void clearTargetScript();
+
+    /// @brief Queue one command the external reader sends after activation.
+    bool queueReaderCommand(const uint8_t *cmd, uint8_t len);
+
+    size_t targetResponseCount() const { return respCount_; }
+
+    /// @brief Response @p index recorded from TgSetData (nullptr if absent).
+    const uint8_t *targetResponse(size_t index, uint8_t *len) const;
+
+    // ── Clock and statistics ─────────────────────────────────────────────
+
+    void setTiming(const Pn532SimTiming &timing) { timing_ = timing; }
+    const Pn532SimTiming &timing() const { return timing_; }
+
+    /// @brief Advance the virtual clock outside any command.
+    void advanceUs(uint32_t us) { clockUs_ += us; }
+
+    const Pn532SimStats &stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+    // ── NfcTransport ─────────────────────────────────────────────────────
+
+    void begin() override;
+    uint32_t firmwareVersion() override;
+    bool samConfig() override;
+    bool inListPassiveTarget(uint8_t *uid, uint8_t *uidLen, uint16_t timeoutMs) override;
+    bool inDataExchange(const uint8_t *cmd, uint8_t cmdLen,
+                        uint8_t *resp, uint8_t *respLen) override;
+    bool tgInitAsTarget() override;
+    bool tgGetData(uint8_t *cmd, uint8_t *cmdLen) override;
+    bool tgSetData(const uint8_t *data, uint8_t len) override;
+    uint32_t nowUs() override { return static_cast<uint32_t>(clockUs_); }
+
+private:
+    /// ISO 14443-3 card state.
+    enum class CardState : uint8_t
+    {
+        IDLE,           ///< Needs InListPassiveTarget
+        ACTIVE,         ///< Selected
+        AUTHENTICATED,  ///< Mifare: authSector_ is open
+    };
+
+    struct Frame
+    {
+        uint16_t offset;
+        uint8_t  len;
+    };
+
+    void charge(uint32_t us);
+    bool isMifare() const { return type_ == SimTagType::MIFARE_CLASSIC_1K; }
+    uint16_t ntagPages() const;
+
+    /// Tag answer; *extraUs receives auth / programming time.
+    bool exchangeMifare(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp,
+                        uint8_t *respLen, uint32_t *extraUs);
+    bool exchangeNtag(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp,
+                      uint8_t *respLen, uint32_t *extraUs);
+
+    bool storeFrame(Frame *frames, size_t *count, const uint8_t *data, uint8_t len);
+
+    Pn532SimTiming timing_;
+    Pn532SimStats stats_;
+    uint64_t clockUs_;
+
+    bool present_;
+    bool magic_;
+    SimTagType type_;
+    uint8_t uid_[7];
+    uint8_t uidLen_;
+    uint8_t mem_[MAX_TAG_BYTES];
+    size_t memSize_;
+    CardState state_;
+    uint8_t authSector_;
+    uint8_t dropCount_;
+
+    uint8_t pool_[TARGET_POOL_BYTES];
+    size_t poolUsed_;
+    Frame cmds_[MAX_TARGET_FRAMES];
+    size_t cmdCount_;
+    size_t cmdNext_;
+    Frame resps_[MAX_TARGET_FRAMES];
+    size_t respCount_;
+};
+
+} // namespace hackos::nfc
@@ -1,6 +1,6 @@
 /**
  * @file nfc_reader.h
- * @brief HAL wrapper for PN532 NFC/RFID using Adafruit_PN532 (SPI).
+ * @brief HAL wrapper for PN532 NFC/RFID.
  *
  * Phase 11 additions:
  *  - Multiple default-key authentication for Mifare Classic sector dumps.
@@ -10,14 +10,69 @@
  * Phase 12 additions:
  *  - Full NTAG215 (540-byte) Amiibo emulation via tgInitAsTarget.
  *  - NTAG215 binary dump writing to blank physical tags.
+ *
+ * NTAG bulk access:
+ *  - readNtagPages() issues FAST_READ (0x3A) for up to
+ *    NTAG_FAST_READ_MAX_PAGES pages per InDataExchange, falling back to
+ *    READ (0x30, 4 pages per exchange) on tags without FAST_READ.
+ *  - writeNtagPages() bulk-reads the target range first and only sends
+ *    WRITE (0xA2) for pages whose content differs.  NTAG21x has no
+ *    multi-page write command, so skipping unchanged pages is the only
+ *    way to batch.
+ *  - Each bulk operation records an NtagOpStats (time, exchanges, pages).
+ *
+ * Mifare Classic key ordering:
+ *  - authenticateBlockWithKeys() tries the key cached for this UID and
+ *    sector first, then the key that opened the previous sector, then
+ *    the key dictionary in hit-count order.  Every failed attempt costs a
+ *    re-select, so the order matters more than the key count.
+ *  - loadKeyStore() / saveKeyStore() persist the dictionary statistics
+ *    and the UID cache on the SD card (see hardware/nfc/mifare_keys.h).
+ *
+ * Transport:
+ *  - All card traffic is framed here and sent through an NfcTransport
+ *    (InListPassiveTarget, InDataExchange, TgInitAsTarget/TgGetData/
+ *    TgSetData).  instance() runs on the Adafruit_PN532 SPI transport;
+ *    a reader constructed on a Pn532Simulator runs the same flows on the
+ *    host against virtual tags (see hardware/nfc/pn532_sim.h).
  */
 
 #pragma once
 
-#include <Adafruit_PN532.h>
 #include <cstddef>
 #include <cstdint>
 
+#include "hardware/nfc/mifare_keys.h"
+#include "hardware/nfc/nfc_transport.h"
+
+/// @brief Timing and traffic of the last NTAG bulk operation.
+struct NtagOpStats
+{
+    uint32_t elapsedUs;  ///< Wall time of the whole operation
+    uint16_t exchanges;  ///< PN532 InDataExchange round trips
+    uint16_t pages;      ///< Pages requested
+    uint16_t written;    ///< Pages actually written (writes only)
+    bool     fastRead;   ///< FAST_READ was used (false = READ fallback)
+    bool     ok;
+};
+
+/// @brief Where the key of the last Mifare Classic authentication came from.
+enum class MifareKeySource : uint8_t
+{
+    NONE,        ///< No key worked
+    UID_CACHE,   ///< Cached for this card and sector
+    PREV_SECTOR, ///< Same key as the previous sector
+    DICTIONARY,  ///< Key dictionary (hit-count order)
+};
+
+/// @brief Outcome of the last authenticateBlockWithKeys() call.
+struct MifareAuthStats
+{
+    MifareKeySource source;
+    uint8_t attempts;  ///< Auth commands sent (each failure costs a re-select)
+    uint8_t key[6];    ///< Key that succeeded
+};
+
 class NFCReader
 {
 public:
@@ -33,9 +88,29 @@ public:
     static constexpr uint8_t NUM_DEFAULT_KEYS = 6U;
     /// Maximum NDEF URL payload length for NTAG213 emulation.
     static constexpr uint8_t MAX_NDEF_URL_LEN = 64U;
+    /// Bytes per NTAG page.
+    static constexpr uint8_t NTAG_PAGE_SIZE = 4U;
+    /// Pages returned by one NTAG READ command.
+    static constexpr uint8_t NTAG_READ_PAGES = 4U;
+    /// Pages per FAST_READ exchange (bounded by the PN532 64-byte frame).
+    static constexpr uint8_t NTAG_FAST_READ_MAX_PAGES = 12U;
 
+    /// Mifare key dictionary (one 12-hex-digit key per line).
+    static constexpr const char *KEY_DICT_PATH  = "/ext/nfc/mifare_default_keys.txt";
+    /// Persisted key hit counters.
+    static constexpr const char *KEY_HITS_PATH  = "/ext/nfc/.mf_key_hits.bin";
+    /// Persisted per-UID sector key cache.
+    static constexpr const char *UID_CACHE_PATH = "/ext/nfc/.mf_uid_cache.bin";
+
+    /// @brief Reader on the board's PN532 (SPI).
     static NFCReader &instance();
 
+    /// @brief Reader on an arbitrary transport (host simulation).
+    explicit NFCReader(hackos::nfc::NfcTransport &transport);
+
+    NFCReader(const NFCReader &) = delete;
+    NFCReader &operator=(const NFCReader &) = delete;
+
     bool init();
     void deinit();
     bool isReady() const;
@@ -58,12 +133,18 @@ public:
     bool authenticateBlock(const uint8_t *uid, uint8_t uidLen, uint8_t blockAddr);
 
     /**
-     * @brief Authenticate a block trying all well-known default keys.
+     * @brief Authenticate a block with key A, trying cached and dictionary keys.
+     *
+     * Order: the key cached for this UID/sector, the key that opened the
+     * previous sector of the same card, then the dictionary by hit count.
+     * A working key is credited in the dictionary and cached for the UID.
+     *
      * @param uid       Card UID.
      * @param uidLen    Card UID length.
      * @param blockAddr Absolute block address.
      * @param[out] keyIdx  If non-null, receives the index of the key that
-     *                     succeeded (0..NUM_DEFAULT_KEYS-1).
+     *                     succeeded in defaultKeys(), or NUM_DEFAULT_KEYS
+     *                     for a key from the dictionary file.
      * @return true if any key succeeded.
      */
     bool authenticateBlockWithKeys(const uint8_t *uid, uint8_t uidLen,
@@ -139,24 +220,110 @@ public:
      * Writes pages 4–129 (user data area) of the dump to the tag.
      * Pages 0–3 (UID/manufacturer) and 130–134 (config/password) are
      * skipped as they are typically read-only or require special auth.
+     * Pages that already hold the dump's content are not rewritten.
      *
      * @param dump Pointer to a 540-byte NTAG215 binary image.
      * @return true if all writable pages were written successfully.
      */
     bool writeNtag215(const uint8_t *dump);
 
+    // ── NTAG bulk access ────────────────────────────────────────────────
+
+    /**
+     * @brief Identify an NTAG21x via GET_VERSION.
+     * @return Total page count (45 / 135 / 231), or 0 if the tag in the
+     *         field did not answer as an NTAG21x.  A tag that NAKs
+     *         GET_VERSION is then read with plain READ.
+     */
+    uint8_t ntagPageCount();
+
+    /**
+     * @brief Read @p pageCount pages starting at @p startPage.
+     *
+     * The tag must already be selected (readUID()).
+     *
+     * @param out Buffer of at least pageCount × NTAG_PAGE_SIZE bytes.
+     * @return true if every page was read.
+     */
+    bool readNtagPages(uint8_t startPage, uint16_t pageCount, uint8_t *out);
+
+    /**
+     * @brief Write @p pageCount pages starting at @p startPage.
+     *
+     * The tag must already be selected.  When @p skipUnchanged is set the
+     * range is bulk-read first and matching pages are not rewritten.
+     *
+     * @param data pageCount × NTAG_PAGE_SIZE bytes.
+     * @return true if every differing page was written.
+     */
+    bool writeNtagPages(uint8_t startPage, uint16_t pageCount,
+                        const uint8_t *data, bool skipUnchanged = true);
+
+    const NtagOpStats &lastNtagRead() const { return lastRead_; }
+    const NtagOpStats &lastNtagWrite() const { return lastWrite_; }
+
+    // ── Mifare key store ────────────────────────────────────────────────
+
+    /**
+     * @brief Load the key dictionary, hit counters and UID cache from SD.
+     *
+     * The built-in default keys are always present.  Safe to call again;
+     * the files are only read once per mount.
+     *
+     * @return true if the dictionary file was read.
+     */
+    bool loadKeyStore();
+
+    /// @brief Write hit counters and UID cache back if they changed.
+    bool saveKeyStore();
+
+    const MifareAuthStats &lastMifareAuth() const { return lastAuth_; }
+    const hackos::nfc::MifareKeyDictionary &keyDictionary() const { return keys_; }
+    const hackos::nfc::MifareUidCache &uidCache() const { return uidCache_; }
+
     /// @brief Access the table of default keys (6 bytes each).
     static const uint8_t (*defaultKeys())[6] { return DEFAULT_KEYS; }
 
 private:
     static const uint8_t DEFAULT_KEYS[NUM_DEFAULT_KEYS][6];
 
-    NFCReader();
-
     /// Build an NDEF Type-2 Tag TLV payload with a single URI record.
     static size_t buildNdefUrl(const char *url, uint8_t prefixCode,
                                uint8_t *buf, size_t bufLen);
 
-    Adafruit_PN532 nfc_;
+    /// One InDataExchange round trip.
+    bool exchange(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp, uint8_t *respLen);
+
+    /// Mifare Classic key-A auth frame: 0x60 <block> <key[6]> <uid[last 4]>.
+    bool mifareAuth(const uint8_t *uid, uint8_t uidLen, uint8_t blockAddr,
+                    const uint8_t *key);
+
+    /// TgSetData for the emulation loops.
+    bool sendTargetResponse(const uint8_t *data, uint8_t len);
+
+    /// Re-select the tag after a NAK left it in the IDLE state.
+    bool reselect();
+
+    /// Seed the dictionary with DEFAULT_KEYS.
+    void seedDefaultKeys();
+
+    /// One key-A auth attempt; re-selects first unless it is the first try.
+    bool tryAuthKey(const uint8_t *uid, uint8_t uidLen, uint8_t blockAddr,
+                    const uint8_t *key);
+
+    hackos::nfc::NfcTransport &transport_;
     bool initialized_;
+    bool fastReadSupported_; ///< Cleared when the selected tag NAKs FAST_READ
+    NtagOpStats lastRead_;
+    NtagOpStats lastWrite_;
+
+    hackos::nfc::MifareKeyDictionary keys_;
+    hackos::nfc::MifareUidCache uidCache_;
+    bool keyStoreLoaded_;
+    MifareAuthStats lastAuth_;
+    /// Card and key of the last successful auth (previous-sector hint).
+    uint8_t lastAuthUid_[hackos::nfc::MF_MAX_UID_LEN];
+    uint8_t lastAuthUidLen_;
+    uint8_t prevKey_[6];
+    bool cardLost_;        ///< Re-select failed during the current auth
 };
@@ -0,0 +1,48 @@
+/**
+ * @file edge_rx_device.h
+ * @brief Receive-only IRxTxDevice over the shared EdgeCapture service.
+ *
+ * Lets the RadioManager ingest OOK pulses from the same edge capture the
+ * RF apps subscribe to, instead of a capture path of its own.  read()
+ * delivers signed int32_t pulse durations in µs (positive = mark), the
+ * layout RadioManager::processBuffer() expects.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/edge/edge_ring.h"
+#include "hardware/radio/irxtx_device.h"
+
+namespace hackos::radio {
+
+class EdgeRxDevice final : public IRxTxDevice
+{
+public:
+    /// Longest pulse reported; longer silences are clamped.
+    static constexpr int32_t MAX_PULSE_US = 100000;
+
+    EdgeRxDevice(const char *name, uint8_t pin, Modulation modulation = Modulation::OOK);
+
+    bool startReceive() override;
+    bool startTransmit() override { return false; }
+    void stop() override;
+    bool isReceiving() const override { return reader_.attached(); }
+    bool isTransmitting() const override { return false; }
+
+    size_t read(uint8_t *buffer, size_t maxLen) override;
+    bool write(const uint8_t * /*data*/, size_t /*len*/) override { return false; }
+
+    const char *name() const override { return name_; }
+    Modulation modulation() const override { return modulation_; }
+
+private:
+    const char *name_;
+    uint8_t pin_;
+    Modulation modulation_;
+    hackos::edge::EdgeReader reader_;
+};
+
+} // namespace hackos::radio
@@ -0,0 +1,132 @@
+/**
+ * @file pulse_spectrum.h
+ * @brief Fixed-point spectral analysis of OOK pulse trains.
+ *
+ * Estimates the timing of an unknown signal from its raw pulse durations
+ * (positive = mark, negative = space, µs):
+ *
+ *  1. The edges are binned into an edge-density signal at a resolution of
+ *     a quarter of the short pulses, zero-padded to FFT_SIZE.
+ *  2. A Q15 radix-2 FFT → power spectrum → inverse FFT gives the
+ *     autocorrelation of the edge positions.  Its first strong peak is
+ *     the symbol clock; the strongest long-lag peak is the frame
+ *     repetition period (re-binned over the whole capture if needed, then
+ *     snapped to the pulse lag whose frames match best).
+ *  3. A Goertzel bank evaluates GOERTZEL_BANK clock frequencies within
+ *     half a bin of that peak, and a least-squares fit over the pulses
+ *     polishes the winner.
+ *  4. Pulse widths in clock units give a coding hint (PWM / PPM /
+ *     Manchester / NRZ) and with it the bit rate.
+ *
+ * The signal path is integer-only (libm is used once for the twiddle
+ * table and for the Goertzel coefficients).  The FFT uses block floating
+ * point: a stage halves its outputs only when an input could overflow,
+ * and the number of halvings is returned.  Samples are stored as packed
+ * 16-bit re/im pairs so each butterfly leg is a single 32-bit load /
+ * store.
+ *
+ * Platform-independent; tools/pulse_spectrum_bench.cpp compares it with
+ * a float reference and times it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::radio {
+
+// ── Fixed-point kernels ──────────────────────────────────────────────────────
+
+/// Packed Q15 complex sample.
+struct Cq15
+{
+    int16_t re;
+    int16_t im;
+};
+
+static constexpr uint8_t FFT_MAX_LOG2 = 10U;
+
+/**
+ * @brief In-place radix-2 FFT with block floating point.
+ *
+ * Inputs must stay within ±16383 per component.  The result is the
+ * transform divided by 2^return value (the inverse transform is
+ * unnormalised otherwise).
+ *
+ * @param log2n 1..FFT_MAX_LOG2
+ * @return Number of stages that halved their outputs (-1 on bad size).
+ */
+int fftQ15(Cq15 *x, uint8_t log2n, bool inverse);
+
+/// @brief 2·cos(2π / period) in Q14 for a Goertzel filter (period in
+///        samples, Q8).
+int32_t goertzelCoeffQ14(uint32_t periodQ8);
+
+/// @brief Goertzel power of @p x at the frequency of @p coeffQ14 (relative).
+uint64_t goertzelPower(const int16_t *x, size_t n, int32_t coeffQ14);
+
+// ── Pulse-train analysis ─────────────────────────────────────────────────────
+
+enum class ModulationHint : uint8_t
+{
+    UNKNOWN,
+    PWM,          ///< Two mark widths, constant bit period
+    PPM,          ///< One mark width, space carries the bit
+    MANCHESTER,   ///< Marks and spaces of one or two half-bits
+    NRZ,          ///< Arbitrary runs of whole bits
+};
+
+const char *modulationHintName(ModulationHint hint);
+
+struct PulseSpectrumResult
+{
+    uint32_t symbolUs;         ///< Elementary clock period (0 = none found)
+    uint32_t bitRateBps;       ///< Bit rate for the hinted coding
+    uint32_t bitUs;            ///< Bit period for the hinted coding
+    uint32_t repeatUs;         ///< Frame repetition period (0 = none)
+    uint16_t clockPermille;    ///< Autocorrelation at the clock / at lag 0
+    uint16_t repeatPermille;   ///< Autocorrelation at the repeat / at lag 0
+    uint32_t binUs;            ///< Edge-density resolution used
+    ModulationHint hint;
+};
+
+class PulseSpectrum
+{
+public:
+    static constexpr uint8_t  FFT_LOG2      = 9U;
+    static constexpr size_t   FFT_SIZE      = 1U << FFT_LOG2;
+    static constexpr size_t   WINDOW_BINS   = FFT_SIZE / 2U;   ///< Rest is zero padding
+    static constexpr size_t   GOERTZEL_BANK = 16U;
+    static constexpr size_t   MIN_PULSES    = 16U;
+
+    PulseSpectrum();
+
+    /**
+     * @brief Analyse @p count signed pulse durations.
+     * @return false if there are fewer than MIN_PULSES pulses or no clock
+     *         period stands out (@p out is then zeroed apart from binUs).
+     */
+    bool analyse(const int32_t *pulses, size_t count, PulseSpectrumResult *out);
+
+private:
+    /// Bin the edge times into density_ (scaled to Q15 range).
+    void binEdges(const int32_t *pulses, size_t count, uint32_t binUs);
+
+    /// Autocorrelation of density_ into autocorr_ (relative scale).
+    void autocorrelate();
+
+    /// Goertzel bank within half a bin of @p lagQ8; returns the best
+    /// clock period in bins (Q8).
+    uint32_t refineClock(uint32_t lagQ8) const;
+
+    union
+    {
+        Cq15 bins[FFT_SIZE];
+        uint32_t durations[FFT_SIZE];
+    } work_;
+    int16_t density_[WINDOW_BINS];
+    int32_t autocorr_[WINDOW_BINS];
+};
+
+} // namespace hackos::radio
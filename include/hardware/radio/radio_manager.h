@@ -80,7 +80,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "core/scratch.h"
 #include "irxtx_device.h"
+#include "pulse_spectrum.h"
 #include "ring_buffer.h"
 #include "signal_format.h"
 
@@ -120,10 +122,13 @@ public:
      * @brief Start capturing from the specified device.
      *
      * The device is placed in receive mode and incoming samples are routed
-     * into the internal RingBuffer for asynchronous protocol matching.
+     * into the internal RingBuffer for asynchronous protocol matching.  The
+     * worker's sample window is leased from the system scratch arena until
+     * stopCapture().
      *
      * @param device  A previously registered device.
-     * @return true if capture was started successfully.
+     * @return true if capture was started successfully (false also when
+     *         the scratch arena has no room).
      */
     bool startCapture(IRxTxDevice *device);
 
@@ -157,6 +162,14 @@ public:
     /// @brief Reference to the most recently decoded SignalRecord.
     const SignalRecord &lastRecord() const;
 
+    // ── Unknown-signal analysis ──────────────────────────────────────────
+
+    /// @brief True once a full buffer that no protocol matched was analysed.
+    bool hasAnalysis() const;
+
+    /// @brief Timing estimate of the most recent unmatched buffer.
+    const PulseSpectrumResult &lastAnalysis() const;
+
     // ── Worker task ──────────────────────────────────────────────────────
 
     /**
@@ -186,12 +199,21 @@ private:
     /// Ring buffer fed by the capture ISR / polling loop.
     RingBuffer<int32_t, RAW_RING_CAPACITY> rawRing_;
 
-    /// Scratch buffer used by the worker to batch-pop samples.
-    int32_t workerBuf_[MAX_RAW_SAMPLES];
-    size_t workerBufLen_;
+    /// Worker state leased for the duration of a capture.
+    struct CaptureScratch
+    {
+        int32_t samples[MAX_RAW_SAMPLES];   ///< Batch popped from rawRing_
+        SignalRecord decoded;               ///< tryDecodeAll() output
+    };
 
-    /// Scratch buffer for transmit encoding (avoids large stack allocs).
-    int32_t txBuf_[MAX_RAW_SAMPLES];
+    /// Transmit encoding buffer, leased for the duration of transmit().
+    struct TxScratch
+    {
+        int32_t timings[MAX_RAW_SAMPLES];
+    };
+
+    core::ScratchLease<CaptureScratch> capture_;
+    size_t workerBufLen_;
 
     /// Scratch buffer for device reads in the worker loop.
     uint8_t readBuf_[256U];
@@ -200,6 +222,11 @@ private:
     SignalRecord lastRecord_;
     bool hasLast_;
 
+    /// Clock / bit-rate estimator for buffers no protocol recognises.
+    PulseSpectrum spectrum_;
+    PulseSpectrumResult lastAnalysis_;
+    bool hasAnalysis_;
+
     /// @brief Internal: drain the ring buffer and attempt protocol decode.
     void processBuffer();
 };
@@ -0,0 +1,214 @@
+/**
+ * @file waterfall_log.h
+ * @brief Compact waterfall recording (.wfl) with a keyframe index.
+ *
+ * The waterfall apps draw packed rows of 1- or 2-bit intensity, LSB-first
+ * within each byte.  WaterfallRecorder appends those rows to a log and
+ * WaterfallPlayer reads them back at any row, aggregated in time.
+ *
+ * File layout (little-endian):
+ * @code
+ *  header   16 B  "HWFL" ver:u8 bpp:u8 width:u16 keyEvery:u16 reserved:u16
+ *                 startMs:u32
+ *  records  one per row, or per run of identical rows:
+ *    0xFF            KEY   ms:u32 row[rowBytes]     self-contained
+ *    0xFE            RAW   row[rowBytes]
+ *    0x80 + (n - 1)  SAME  previous row repeated n = 1..126 times
+ *    m (1..0x7F)     DELTA m × (byte:u8 xor:u8) against the previous row
+ *  index    12 B × count   row:u32 offset:u32 ms:u32   (KEY records)
+ *  footer   16 B  indexOff:u32 count:u32 rows:u32 "WFIX"
+ * @endcode
+ *
+ * Every keyEvery-th row is a KEY record, so decoding can start there.  An
+ * idle band costs one byte per 126 rows and sparse activity two bytes per
+ * changed byte; a row is never stored larger than RAW.
+ *
+ * The index lives in a caller-supplied table.  When it fills up, every
+ * other entry is dropped and only every second keyframe is indexed from
+ * then on, so a recording of any length fits; seeking simply decodes a
+ * little further.  A file without footer (power loss, card pulled) is
+ * re-indexed by one sequential scan on open.
+ *
+ * Everything here is platform-independent; WaterfallTape stores the log
+ * through VirtualFS.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::radio {
+
+// ── Format ───────────────────────────────────────────────────────────────────
+
+static constexpr uint8_t  WFL_VERSION      = 1U;
+static constexpr size_t   WFL_HEADER_SIZE  = 16U;
+static constexpr size_t   WFL_FOOTER_SIZE  = 16U;
+static constexpr size_t   WFL_INDEX_SIZE   = 12U;
+static constexpr size_t   WFL_MAX_ROW_BYTES = 64U;
+static constexpr uint16_t WFL_KEY_EVERY    = 256U;
+
+/// @brief One indexed keyframe.
+struct WfIndexEntry
+{
+    uint32_t row;      ///< Row number of the KEY record
+    uint32_t offset;   ///< File offset of the KEY record
+    uint32_t ms;       ///< Timestamp stored in the KEY record
+};
+
+/// @brief How rows merged by a time zoom combine per pixel.
+enum class WfAggregate : uint8_t
+{
+    MAX,    ///< Brightest sample (short bursts stay visible)
+    MEAN,   ///< Rounded average (1-bit: lit if at least half were)
+};
+
+// ── I/O interfaces ───────────────────────────────────────────────────────────
+
+/// @brief Sequential output of the recorder.
+class WfByteSink
+{
+public:
+    virtual ~WfByteSink() = default;
+    virtual bool write(const uint8_t *data, size_t len) = 0;
+};
+
+/// @brief Random-access input of the player.
+class WfByteSource
+{
+public:
+    virtual ~WfByteSource() = default;
+    virtual uint32_t size() const = 0;
+    /// @return Bytes read (short only at end of data or on error).
+    virtual size_t readAt(uint32_t offset, uint8_t *buf, size_t len) = 0;
+};
+
+// ── WaterfallRecorder ────────────────────────────────────────────────────────
+
+class WaterfallRecorder
+{
+public:
+    WaterfallRecorder();
+
+    /**
+     * @brief Write the header and start a recording.
+     * @param bpp       1 or 2 bits per pixel.
+     * @param width     Pixels per row (rowBytes ≤ WFL_MAX_ROW_BYTES).
+     * @param index     Keyframe table, valid until finish().
+     * @param indexCap  Entries in @p index (≥ 2).
+     */
+    bool begin(WfByteSink &sink, uint8_t bpp, uint16_t width, uint16_t keyEvery,
+               uint32_t startMs, WfIndexEntry *index, size_t indexCap);
+
+    /// @brief Append one packed row taken at @p ms.
+    bool pushRow(const uint8_t *row, uint32_t ms);
+
+    /// @brief Flush the pending run and write index + footer.
+    bool finish();
+
+    bool active() const { return sink_ != nullptr; }
+    uint32_t rows() const { return rows_; }
+    uint32_t bytes() const { return bytes_; }
+    size_t rowBytes() const { return rowBytes_; }
+
+private:
+    bool put(const uint8_t *data, size_t len);
+    bool flushSame();
+
+    WfByteSink *sink_;
+    WfIndexEntry *index_;
+    size_t indexCap_;
+    size_t indexCount_;
+    uint32_t keyStride_;   ///< Index every keyStride_-th keyframe
+    uint32_t keyframes_;
+    uint16_t keyEvery_;
+    size_t rowBytes_;
+    uint32_t rows_;
+    uint32_t bytes_;
+    uint8_t same_;         ///< Pending SAME run length
+    uint8_t prev_[WFL_MAX_ROW_BYTES];
+};
+
+// ── WaterfallPlayer ──────────────────────────────────────────────────────────
+
+class WaterfallPlayer
+{
+public:
+    WaterfallPlayer();
+
+    /**
+     * @brief Open a recording: read its index, or rebuild it by scanning
+     *        when the footer is missing.
+     * @param index     Keyframe table, valid while the player is open.
+     * @param indexCap  Entries in @p index (≥ 2).
+     */
+    bool open(WfByteSource &source, WfIndexEntry *index, size_t indexCap);
+    void close();
+
+    bool isOpen() const { return source_ != nullptr; }
+    uint32_t rows() const { return rows_; }
+    uint8_t bitsPerPixel() const { return bpp_; }
+    uint16_t width() const { return width_; }
+    size_t rowBytes() const { return rowBytes_; }
+    uint32_t startMs() const { return startMs_; }
+    size_t indexCount() const { return indexCount_; }
+
+    /// @brief True if the index came from a scan (recording not finished).
+    bool recovered() const { return recovered_; }
+
+    /// @brief Timestamp of the last keyframe at or before @p row.
+    uint32_t msAt(uint32_t row) const;
+
+    /**
+     * @brief Decode @p count display rows starting at @p first, each the
+     *        aggregate of @p zoom recorded rows.
+     *
+     * Output rows are packed like the input (rowBytes() each).  Rows past
+     * the end are zero.
+     *
+     * @return Rows that held recorded data.
+     */
+    size_t render(uint32_t first, uint16_t zoom, WfAggregate mode, uint8_t *out, size_t count);
+
+    /// @brief Byte reads issued to the source since open (cost metric).
+    uint32_t reads() const { return reads_; }
+
+private:
+    bool scanIndex();
+    bool addIndex(uint32_t keyNo, uint32_t row, uint32_t offset, uint32_t ms);
+    /// Last indexed keyframe at or before @p row (nullptr if none).
+    const WfIndexEntry *keyBefore(uint32_t row) const;
+    bool seek(uint32_t row);
+    bool nextRow(uint8_t *row);
+    bool byteAt(uint32_t offset, uint8_t *b);
+    bool bytesAt(uint32_t offset, uint8_t *buf, size_t len);
+
+    static constexpr size_t WINDOW = 128U;
+
+    WfByteSource *source_;
+    WfIndexEntry *index_;
+    size_t indexCap_;
+    size_t indexCount_;
+    uint32_t keyStride_;
+    uint8_t bpp_;
+    uint16_t width_;
+    size_t rowBytes_;
+    uint32_t startMs_;
+    uint32_t rows_;
+    uint32_t dataEnd_;
+    bool recovered_;
+    uint32_t reads_;
+
+    // Decoder cursor: the next row to decode and where its record starts.
+    uint32_t curRow_;
+    uint32_t curOff_;
+    uint8_t sameLeft_;
+    uint8_t prev_[WFL_MAX_ROW_BYTES];
+
+    uint8_t window_[WINDOW];
+    uint32_t windowOff_;
+    size_t windowLen_;
+};
+
+} // namespace hackos::radio
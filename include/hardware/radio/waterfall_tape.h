@@ -0,0 +1,123 @@
+/**
+ * @file waterfall_tape.h
+ * @brief Record / play back a waterfall view through VirtualFS.
+ *
+ * Glue between the waterfall apps and the .wfl format (waterfall_log.h):
+ * recordings go to `/ext/captures/waterfall/<prefix>_NNN.wfl` through a
+ * BufferedWriter (one SD write per 512 B, i.e. every few seconds at the
+ * usual rates), and playback keeps a position, a time zoom and an
+ * aggregate mode so an app only has to forward keys and draw the rows
+ * fill() hands back.
+ *
+ * Playback is newest-at-top like the live view: the position is the row
+ * shown in the top line, older rows follow downwards, and with a zoom of
+ * N each line aggregates N recorded rows.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <FS.h>
+
+#include "hardware/radio/waterfall_log.h"
+#include "storage/buffered_stream.h"
+
+namespace hackos::radio {
+
+class WaterfallTape
+{
+public:
+    static constexpr size_t   INDEX_ENTRIES = 64U;
+    static constexpr unsigned MAX_FILES     = 100U;
+    static constexpr uint16_t MAX_ZOOM      = 64U;
+
+    /// @param prefix  File name prefix, e.g. "sa" (static string).
+    explicit WaterfallTape(const char *prefix);
+    ~WaterfallTape();
+
+    WaterfallTape(const WaterfallTape &) = delete;
+    WaterfallTape &operator=(const WaterfallTape &) = delete;
+
+    // ── Recording ────────────────────────────────────────────────────────
+
+    /// @brief Open the next free file and write the header.
+    bool startRecording(uint8_t bpp, uint16_t width);
+
+    /// @brief Append one packed row (stops recording on a write error).
+    void pushRow(const uint8_t *row);
+
+    /// @brief Write the index and close the file.
+    void stopRecording();
+
+    bool recording() const { return recorder_.active(); }
+    uint32_t recordedRows() const { return recorder_.rows(); }
+
+    // ── Playback ─────────────────────────────────────────────────────────
+
+    /// @brief Open the newest recording with this prefix at its end.
+    bool startPlayback();
+    void stopPlayback();
+    bool playing() const { return player_.isOpen(); }
+
+    /// @brief Move by @p lines display lines (positive = towards newer).
+    void scrub(int32_t lines);
+
+    /// @brief Cycle the time zoom 1, 2, 4 … MAX_ZOOM, 1.
+    void cycleZoom();
+
+    void toggleAggregate();
+
+    uint16_t zoom() const { return zoom_; }
+    WfAggregate aggregate() const { return mode_; }
+
+    /// @brief Seconds from the start of the recording to the top line.
+    uint32_t positionSec() const;
+
+    /**
+     * @brief Decode @p count display lines, newest first, into @p rows
+     *        (rowBytes each, matching the recording's packing).
+     */
+    void fill(uint8_t *rows, size_t rowBytes, size_t count);
+
+    const char *path() const { return path_; }
+
+private:
+    /// WfByteSink over a BufferedWriter.
+    class WriterSink final : public WfByteSink
+    {
+    public:
+        bool write(const uint8_t *data, size_t len) override { return writer.write(data, len); }
+        storage::BufferedWriter writer;
+    };
+
+    /// WfByteSource over an open VirtualFS file (seek + read).
+    class FileSource final : public WfByteSource
+    {
+    public:
+        FileSource() : size_(0U) {}
+        bool open(const char *path);
+        void close();
+        uint32_t size() const override { return size_; }
+        size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override;
+
+    private:
+        fs::File file_;
+        uint32_t size_;
+    };
+
+    bool newestPath(char *out, size_t len) const;
+
+    const char *prefix_;
+    char path_[48];
+    WriterSink sink_;
+    FileSource source_;
+    WaterfallRecorder recorder_;
+    WaterfallPlayer player_;
+    WfIndexEntry index_[INDEX_ENTRIES];   ///< Recorder and player never overlap
+    uint32_t top_;                        ///< Row shown on the top line
+    uint16_t zoom_;
+    WfAggregate mode_;
+};
+
+} // namespace hackos::radio
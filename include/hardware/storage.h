@@ -43,13 +43,34 @@ public:
     /**
      * @brief Append a chunk to an existing file (or create it).
      *
-     * Designed for iterative / chunked writes so the caller can yield between
-     * chunks and keep the UI responsive.
+     * Goes through a pool of open handles (storage/file_pool.h): the file
+     * stays open and small chunks are coalesced in RAM, so a log record
+     * costs a memcpy instead of an open / seek / close.  Data reaches the
+     * card when the buffer fills, on sync(), or from tick() within a few
+     * seconds; writeFile() / readFile() / listDir() / unmount() flush
+     * first.  The pool is locked, so any task may call this; the
+     * write-back journal migrates its batches to SD through it.
      *
      * @return true on success.
      */
     bool appendChunk(const char *path, const uint8_t *data, size_t len);
 
+    /// @brief Commit pending appends of @p path to the card.
+    bool sync(const char *path);
+
+    /// @brief Commit pending appends of every pooled file.
+    bool syncAll();
+
+    /// @brief Flush and close the pooled handle of @p path (before it is
+    ///        replaced or removed through another handle).
+    bool close(const char *path);
+
+    /// @brief Periodic pool upkeep (idle close, age-based sync); main loop.
+    void tick();
+
+    /// @brief Log append-pool counters and per-append latency.
+    void logStats() const;
+
     /**
      * @brief Read an entire file into a caller-supplied buffer.
      *
@@ -66,4 +87,7 @@ private:
 
     bool mounted_;
     const char *lastError_;
+    uint32_t appendCount_;
+    uint32_t appendMaxUs_;
+    uint64_t appendTotalUs_;
 };
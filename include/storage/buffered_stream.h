@@ -17,6 +17,11 @@
  * }
  * writer.close();                           // flushes remaining data
  * @endcode
+ *
+ * DurableWriter adds a DurabilityPolicy (durable_log.h) for captures that
+ * must survive a brown-out: large buffer, syncs on the policy's triggers
+ * and a sidecar on `/int` from which VirtualFS trims a torn capture to its
+ * last complete record on the next boot.
  */
 
 #pragma once
@@ -25,6 +30,8 @@
 #include <cstdint>
 #include <FS.h>
 
+#include "storage/durable_log.h"
+
 namespace hackos::storage {
 
 // ── BufferedReader ────────────────────────────────────────────────────────────
@@ -126,4 +133,78 @@ private:
     bool open_;
 };
 
+// ── DurableWriter ────────────────────────────────────────────────────────────
+
+/**
+ * @brief Capture writer with a durability policy and crash recovery.
+ *
+ * @code
+ * DurableWriter w;
+ * w.begin("/ext/pcap/cap_0001.pcap", DurabilityPolicy::every(32768U, 1000U));
+ * w.write(globalHeader, 24U);
+ * w.endRecord();
+ * while (capturing) {
+ *     w.write(pktHeader, 16U);
+ *     w.write(pkt, len);
+ *     w.endRecord();                        // syncs when the policy says so
+ * }
+ * w.close();                                // sync, drop the sidecar
+ * @endcode
+ */
+class DurableWriter
+{
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 4096U;
+
+    DurableWriter();
+    ~DurableWriter();
+
+    /**
+     * @brief Open (or create) @p path for durable writing.
+     * @param bufferSize  Heap buffer; falls back to unbuffered if it cannot
+     *                    be allocated.
+     * @return true if the file was opened successfully.
+     */
+    bool begin(const char *path, const DurabilityPolicy &policy, bool append = false,
+               size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    bool write(const uint8_t *data, size_t len);
+
+    /// @brief Everything written so far is whole records.
+    bool endRecord();
+
+    /// @brief Apply the time trigger while no records arrive.
+    bool poll();
+
+    /// @brief Sync now regardless of the policy.
+    bool sync();
+
+    /// @brief Sync, close and drop the sidecar (safe to call twice).
+    void close();
+
+    bool isOpen() const;
+    const DurableLog::Stats &stats() const;
+
+private:
+    /// fs::File capture + sidecar behind the log.
+    class FileSink final : public CaptureSink
+    {
+    public:
+        FileSink() : tracked(false) {}
+
+        bool write(const uint8_t *data, size_t len) override;
+        bool sync() override;
+        bool mark(uint32_t offset, const uint8_t *data, size_t len) override;
+
+        fs::File file;
+        fs::File sidecar;
+        bool tracked;   ///< false for `/ram` captures: nothing to recover
+    };
+
+    FileSink sink_;
+    DurableLog log_;
+    uint8_t *buffer_;
+    char sidecarPath_[32];
+};
+
 } // namespace hackos::storage
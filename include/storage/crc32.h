@@ -0,0 +1,34 @@
+/**
+ * @file crc32.h
+ * @brief CRC-32 (IEEE 802.3, reflected) shared by the storage formats.
+ *
+ * Nibble-table variant: 64 bytes of table instead of 1 KiB.  Chainable –
+ * pass the previous result as @p crc to continue over more data; start
+ * with 0.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::storage {
+
+inline uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    static constexpr uint32_t TABLE[16] = {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+        0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+        0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+    };
+    crc = ~crc;
+    for (size_t i = 0U; i < len; ++i)
+    {
+        crc = TABLE[(crc ^ data[i]) & 0x0FU] ^ (crc >> 4);
+        crc = TABLE[(crc ^ (data[i] >> 4)) & 0x0FU] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+} // namespace hackos::storage
@@ -0,0 +1,180 @@
+/**
+ * @file durable_log.h
+ * @brief Per-file durability policy and crash-safe capture files.
+ *
+ * A capture written through a large RAM buffer loses everything since the
+ * last sync on a brown-out, and a sync that lands mid-record leaves a torn
+ * packet at the end of the file.  DurableLog sits between a capture
+ * writer and its file:
+ *
+ *  - a DurabilityPolicy decides when to sync: every N bytes, when the
+ *    oldest unsynced byte is T ms old, and/or at every record boundary
+ *  - after each sync a self-describing *block trailer* is written to a
+ *    sidecar file, covering the capture up to the last endRecord():
+ *
+ *      header  = magic "DUR1" | start u32 | pathLen u16 | 0 u16 | crc32 u32
+ *                | path                                  (little endian)
+ *      trailer = magic "DBT1" | start u32 | end u32 | blockCrc u32 | crc32 u32
+ *
+ *    blockCrc covers capture bytes [start, end); the last crc32 covers the
+ *    trailer's own first 16 bytes.
+ *
+ * The header is followed by TRAILER_SLOTS fixed slots used as a ring: the
+ * Nth trailer overwrites slot N % TRAILER_SLOTS, so the sidecar never
+ * grows past MAX_SIDECAR however long the capture runs (a 1 s policy
+ * would otherwise add ~72 KB/h to `/int`).  A torn slot write costs only
+ * the oldest trailer.
+ *
+ * Trailers live in a sidecar rather than inside the capture so PCAP and
+ * `.sub` files stay readable by Wireshark and the Flipper.  The capture
+ * is synced before its trailer is written, so a trailer on flash means its
+ * block is on the medium.  On the next mount recover() tries the slots
+ * from the highest block end down to the first whose block still checks
+ * out; the capture is then cut to that length – the last complete record –
+ * and the sidecar dropped.  A clean close drops the sidecar at once.
+ *
+ * Portable: the file behind the log is a CaptureSink and recovery reads
+ * through TierVolume (write_back.h), so tools/durable_log_bench.cpp runs
+ * the protocol on the host with power cuts injected.  VirtualFS and
+ * DurableWriter (buffered_stream.h) are the device adapters.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "storage/write_back.h"
+
+namespace hackos::storage {
+
+/// @brief When a DurableLog syncs; the triggers combine.
+struct DurabilityPolicy
+{
+    uint32_t syncBytes;   ///< Sync once this many bytes are unsynced (0 = off)
+    uint32_t syncMs;      ///< Sync once the oldest unsynced byte is this old (0 = off)
+    bool syncOnRecord;    ///< Sync at every endRecord()
+
+    /// Every record is on the medium before endRecord() returns.
+    static constexpr DurabilityPolicy everyRecord() { return {0U, 0U, true}; }
+
+    /// Bounded loss: at most @p bytes or @p ms worth of records.
+    static constexpr DurabilityPolicy every(uint32_t bytes, uint32_t ms)
+    {
+        return {bytes, ms, false};
+    }
+};
+
+/// @brief The open capture file and its sidecar.
+class CaptureSink
+{
+public:
+    virtual ~CaptureSink() = default;
+    /// Write capture bytes (the medium may still cache them).
+    virtual bool write(const uint8_t *data, size_t len) = 0;
+    /// Make every written capture byte and the file size durable.
+    virtual bool sync() = 0;
+    /// Write @p len bytes at @p offset in the sidecar and make them durable.
+    virtual bool mark(uint32_t offset, const uint8_t *data, size_t len) = 0;
+};
+
+// ── DurableLog ───────────────────────────────────────────────────────────────
+
+class DurableLog
+{
+public:
+    static constexpr size_t MAX_PATH = 64U;
+    static constexpr size_t HEADER_SIZE = 16U;   ///< Followed by the path
+    static constexpr size_t TRAILER_SIZE = 20U;
+    static constexpr size_t TRAILER_SLOTS = 8U;   ///< Ring of trailers after the header
+    /// Largest sidecar ever written.
+    static constexpr size_t MAX_SIDECAR = HEADER_SIZE + MAX_PATH + TRAILER_SLOTS * TRAILER_SIZE;
+
+    struct Stats
+    {
+        uint32_t bytes;         ///< Capture bytes written since begin()
+        uint32_t syncs;
+        uint32_t trailers;
+        uint32_t failures;      ///< Sink write / sync / mark errors
+        uint32_t maxUnsynced;   ///< Most bytes ever at risk at once
+    };
+
+    /// @brief What recover() found for one sidecar.
+    struct Recovered
+    {
+        char path[MAX_PATH];   ///< Capture the sidecar belongs to
+        int32_t size;          ///< Its current size, -1 if missing
+        uint32_t keep;         ///< Length to cut it to (<= size)
+        uint32_t verified;     ///< Trailers checked before one matched
+    };
+
+    DurableLog();
+
+    /**
+     * @brief Start logging to @p sink.
+     * @param capturePath  Recorded in the sidecar header for recovery.
+     * @param startOffset  Capture size now (non-zero when appending).
+     * @param buffer       Write buffer owned by the caller; nullptr for
+     *                     unbuffered.
+     */
+    bool begin(CaptureSink &sink, const char *capturePath, uint32_t startOffset,
+               const DurabilityPolicy &policy, uint8_t *buffer, size_t bufferSize,
+               uint32_t nowMs);
+
+    bool write(const uint8_t *data, size_t len, uint32_t nowMs);
+
+    /// @brief The bytes written so far form complete records.
+    bool endRecord(uint32_t nowMs);
+
+    /// @brief Apply the time trigger; call when no writes are coming.
+    bool poll(uint32_t nowMs);
+
+    /// @brief Flush, sync and append a trailer now.
+    bool sync();
+
+    /// @brief Final sync; the caller then removes the sidecar.
+    bool end();
+
+    bool isOpen() const { return open_; }
+
+    /// @brief Capture size including buffered bytes.
+    uint32_t size() const { return pos_; }
+
+    /// @brief Capture length a power cut now would keep.
+    uint32_t durableSize() const { return blockStart_; }
+
+    const Stats &stats() const { return stats_; }
+
+    /**
+     * @brief Work out how much of a capture survives, from its sidecar.
+     * @param meta      Volume holding @p sidecarPath.
+     * @param captures  Volume resolving the capture path in the header.
+     * @return false if the sidecar header is missing or corrupt.
+     */
+    static bool recover(TierVolume &meta, const char *sidecarPath,
+                        TierVolume &captures, Recovered &out);
+
+private:
+    bool flushBuffer();
+    bool due(uint32_t nowMs) const;
+
+    CaptureSink *sink_;
+    DurabilityPolicy policy_;
+    uint8_t *buf_;
+    size_t bufSize_;
+    size_t buffered_;
+    uint32_t start_;
+    uint32_t pos_;           ///< Capture offset after the last byte written
+    uint32_t syncedPos_;
+    uint32_t unsyncedSinceMs_;
+    uint32_t blockStart_;    ///< End of the last block with a trailer
+    uint32_t recordEnd_;
+    uint32_t runCrc_;        ///< Bytes [blockStart_, pos_)
+    uint32_t recordCrc_;     ///< Bytes [blockStart_, recordEnd_)
+    uint32_t tailCrc_;       ///< Bytes [recordEnd_, pos_)
+    uint32_t slotBase_;      ///< Sidecar offset of trailer slot 0
+    bool open_;
+    Stats stats_;
+};
+
+} // namespace hackos::storage
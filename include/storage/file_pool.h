@@ -0,0 +1,114 @@
+/**
+ * @file file_pool.h
+ * @brief Pool of open append handles with coalescing buffers.
+ *
+ * Opening a FAT file for append walks the directory and the file's whole
+ * cluster chain, and closing it rewrites the directory entry, so the old
+ * open / write / close per record cost several sector transfers for a
+ * 100-byte log line.  FileHandlePool keeps up to SLOTS files open, keyed
+ * by path, and collects small appends in a per-file buffer:
+ *
+ *  - a full buffer (or a record larger than it) is written through
+ *  - the least recently used file is flushed and closed to make room
+ *  - tick() syncs files with data older than SYNC_MS and closes files idle
+ *    for IDLE_CLOSE_MS, so a power loss costs at most a few seconds
+ *  - sync() / close() are explicit durability points (and must precede
+ *    reading or rewriting a pooled path)
+ *
+ * File access goes through PoolFs so the pool runs on the host against a
+ * FAT cost model (tools/file_pool_bench.cpp).  Not thread-safe; the owner
+ * serialises calls.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::storage {
+
+/// @brief Backend file operations, one open file per pool slot.
+class PoolFs
+{
+public:
+    virtual ~PoolFs() = default;
+    /// Open (create) @p path for appending in @p slot.
+    virtual bool open(size_t slot, const char *path) = 0;
+    virtual size_t write(size_t slot, const uint8_t *data, size_t len) = 0;
+    /// Commit written data and the file size to the medium.
+    virtual bool sync(size_t slot) = 0;
+    virtual void close(size_t slot) = 0;
+};
+
+// ── FileHandlePool ───────────────────────────────────────────────────────────
+
+class FileHandlePool
+{
+public:
+    static constexpr size_t SLOTS = 4U;
+    static constexpr size_t BUFFER_SIZE = 512U;
+    static constexpr size_t MAX_PATH = 64U;
+    static constexpr uint32_t IDLE_CLOSE_MS = 2000U;
+    static constexpr uint32_t SYNC_MS = 5000U;
+
+    struct Stats
+    {
+        uint32_t appends;
+        uint32_t opens;
+        uint32_t evictions;
+        uint32_t writes;   ///< Backend write calls
+        uint32_t syncs;
+    };
+
+    explicit FileHandlePool(PoolFs &fs);
+
+    /**
+     * @brief Append @p len bytes to @p path (created if missing).
+     * @return false if the file cannot be opened or written; buffered
+     *         data of that file is dropped with it.
+     */
+    bool append(const char *path, const uint8_t *data, size_t len, uint32_t nowMs);
+
+    /// @brief Write out buffered data of @p path and commit it (no-op if not open).
+    bool sync(const char *path);
+
+    /// @brief sync() every open file.
+    bool syncAll();
+
+    /// @brief Flush and close @p path if it is open.
+    bool close(const char *path);
+
+    /// @brief Flush and close everything (before unmount).
+    bool closeAll();
+
+    /// @brief Periodic sync / idle close; call every few hundred ms.
+    void tick(uint32_t nowMs);
+
+    size_t openCount() const;
+    const Stats &stats() const { return stats_; }
+
+private:
+    struct Slot
+    {
+        char path[MAX_PATH];
+        uint8_t buffer[BUFFER_SIZE];
+        size_t buffered;
+        uint32_t lastUseMs;
+        uint32_t dirtySinceMs;   ///< First write not yet synced
+        bool open;
+        bool dirty;              ///< Written to the backend but not synced
+    };
+
+    int find(const char *path) const;
+    /// Open @p path in a free or evicted slot.
+    int acquire(const char *path, uint32_t nowMs);
+    bool flush(Slot &s, size_t index);
+    bool syncSlot(Slot &s, size_t index);
+    bool closeSlot(Slot &s, size_t index);
+
+    PoolFs &fs_;
+    Slot slots_[SLOTS];
+    Stats stats_;
+};
+
+} // namespace hackos::storage
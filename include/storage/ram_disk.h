@@ -0,0 +1,134 @@
+/**
+ * @file ram_disk.h
+ * @brief Bounded in-memory file store behind VirtualFS `/ram/…`.
+ *
+ * Scratch data (sort runs, decode intermediates, upload staging) does not
+ * need to survive a reboot, and writing it to SD or LittleFS costs card
+ * time and flash wear.  RamDisk keeps up to MAX_FILES files in heap
+ * buffers under a byte budget:
+ *
+ *  - file buffers grow in GRANULE steps (doubling) and count against the
+ *    budget by capacity, so the budget bounds the real heap use
+ *  - when a write needs room, the least recently used file that is neither
+ *    open nor pinned is deleted; if nothing can go, the write comes up
+ *    short, exactly like a full card
+ *  - directories are implied by paths (`/a/b` makes `/a` exist) and
+ *    mkdir() always succeeds
+ *  - a file removed while open disappears from listings at once and is
+ *    freed when its last handle is released
+ *
+ * Files are addressed by handle (slot index).  The fs::FS adapter lives in
+ * ram_fs.h; this class has no Arduino dependencies so the host bench
+ * (tools/ram_disk_bench.cpp) runs it as is.  Not thread-safe: on the
+ * device every call is made under RamDiskLock (ram_fs.h).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::storage {
+
+class RamDisk
+{
+public:
+    static constexpr size_t MAX_FILES = 16U;
+    static constexpr size_t MAX_PATH = 48U;
+    static constexpr size_t GRANULE = 256U;
+
+    struct Stats
+    {
+        uint32_t evictions;
+        uint32_t shortWrites;   ///< Writes cut short by the budget or heap
+        size_t peakBytes;       ///< Highest usedBytes()
+    };
+
+    explicit RamDisk(size_t budgetBytes);
+    ~RamDisk();
+
+    RamDisk(const RamDisk &) = delete;
+    RamDisk &operator=(const RamDisk &) = delete;
+
+    /// @brief Change the budget; shrinking evicts down to it where possible.
+    void setBudget(size_t bytes);
+    size_t budget() const { return budget_; }
+    /// @brief Bytes of file capacity currently allocated.
+    size_t usedBytes() const { return used_; }
+    const Stats &stats() const { return stats_; }
+
+    // ── Handles ──────────────────────────────────────────────────────────
+
+    /**
+     * @brief Open @p path and take a reference on it.
+     * @param create    Create the file if it does not exist.
+     * @param truncate  Drop existing contents.
+     * @return Handle (>= 0), or -1 if missing / no free slot / bad path.
+     */
+    int open(const char *path, bool create, bool truncate);
+
+    /// @brief Drop a reference taken by open().
+    void release(int handle);
+
+    size_t read(int handle, size_t pos, uint8_t *buf, size_t len);
+
+    /// @brief Write at @p pos (a gap past the end reads back as zeros).
+    /// @return Bytes written; less than @p len when out of room.
+    size_t write(int handle, size_t pos, const uint8_t *data, size_t len);
+
+    size_t size(int handle) const;
+    const char *path(int handle) const;
+
+    // ── Paths ────────────────────────────────────────────────────────────
+
+    bool exists(const char *path) const;
+    bool isDir(const char *path) const;
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+
+    /// @brief Protect @p path from eviction (or release the protection).
+    bool pin(const char *path, bool pinned);
+
+    /**
+     * @brief Iterate the direct children of directory @p dir.
+     * @param cursor  Start at 0; advanced past the returned entry.
+     * @param name    Receives the child name (no slashes).
+     * @return false when there are no more entries.
+     */
+    bool nextEntry(const char *dir, size_t &cursor, char *name, size_t nameCap,
+                   bool &isDir, uint32_t &size) const;
+
+private:
+    struct File
+    {
+        char path[MAX_PATH];
+        uint8_t *data;
+        size_t size;
+        size_t capacity;
+        uint32_t lastUse;
+        uint8_t refs;
+        bool used;
+        bool pinned;
+        bool removed;   ///< Unlinked, waiting for the last release()
+    };
+
+    int find(const char *path) const;
+    bool valid(int handle) const;
+    void touch(File &f);
+    void freeFile(File &f);
+    /// Grow @p f to hold @p need bytes, evicting other files for room.
+    bool reserve(File &f, size_t need);
+    /// LRU file that may be evicted (optionally only ones holding memory).
+    File *victim(const File *keep, bool holdingBytes);
+    void evict(File &f);
+    /// Evict LRU files (except @p keep) until @p bytes more fit.
+    bool makeRoom(size_t bytes, const File *keep);
+
+    File files_[MAX_FILES];
+    size_t budget_;
+    size_t used_;
+    uint32_t clock_;
+    Stats stats_;
+};
+
+} // namespace hackos::storage
@@ -0,0 +1,59 @@
+/**
+ * @file ram_fs.h
+ * @brief fs::FSImpl over a RamDisk, so `/ram/…` paths yield plain fs::File.
+ *
+ * VirtualFS wraps this in an fs::FS; callers (BufferedWriter, FileSource,
+ * listDir) then use the same open / read / write / seek / openNextFile
+ * calls as on SD or LittleFS.  Opening a directory path in "r" mode gives
+ * a directory handle whose openNextFile() walks RamDisk::nextEntry().
+ *
+ * RamDisk itself is not thread-safe, and `/ram/` paths are reachable from
+ * every task that goes through VirtualFS.  Every call into it therefore
+ * runs under one static mutex, taken with RamDiskLock: the adapters here
+ * take it themselves; direct users of VirtualFS::ramDisk() take it around
+ * their calls.
+ */
+
+#pragma once
+
+#include <FSImpl.h>
+
+#include "storage/ram_disk.h"
+
+namespace hackos::storage {
+
+// ── RamDiskLock ──────────────────────────────────────────────────────────────
+
+/// @brief Holds the `/ram/` mutex for its scope (not recursive).
+class RamDiskLock
+{
+public:
+    RamDiskLock();
+    ~RamDiskLock();
+
+    RamDiskLock(const RamDiskLock &) = delete;
+    RamDiskLock &operator=(const RamDiskLock &) = delete;
+};
+
+// ── RamFs ────────────────────────────────────────────────────────────────────
+
+class RamFs final : public fs::FSImpl
+{
+public:
+    explicit RamFs(RamDisk &disk);
+
+    /// @p mode is an fopen() mode: "r", "w", "a", optionally with '+'.
+    fs::FileImplPtr open(const char *path, const char *mode, const bool create) override;
+    bool exists(const char *path) override;
+    bool rename(const char *pathFrom, const char *pathTo) override;
+    bool remove(const char *path) override;
+    /// Directories are implied by file paths; always succeeds.
+    bool mkdir(const char *path) override;
+    /// Succeeds once nothing is left under @p path.
+    bool rmdir(const char *path) override;
+
+private:
+    RamDisk &disk_;
+};
+
+} // namespace hackos::storage
@@ -0,0 +1,52 @@
+/**
+ * @file spi_fs.h
+ * @brief SD card fs::FS that schedules every access on the SPI arbiter.
+ *
+ * The SD library runs its own SPI transactions, which only keep single
+ * transfers intact; between two of them the PN532 may get the bus or
+ * not, whatever its deadline.  SpiFs wraps the SD fs::FS so each file
+ * operation holds an SpiLease (core/system_core.h):
+ *
+ *  - data writes and flush / close run at BusPriority::BULK; writes are
+ *    cut into SLICE_BYTES pieces and the lease yields between them when a
+ *    better-ranked request waits, so an NFC exchange waits for one sector,
+ *    not a whole capture buffer
+ *  - reads (sliced the same way), open, directory walks and metadata run
+ *    at BusPriority::NORMAL
+ *
+ * StorageManager, VirtualFS (/ext) and the write-back journal all reach
+ * the card through sdFs().  Leases are taken at this leaf level only, so
+ * callers must not hold one themselves while calling in.
+ */
+
+#pragma once
+
+#include <FSImpl.h>
+
+namespace hackos::storage {
+
+// ── SpiFs ────────────────────────────────────────────────────────────────────
+
+class SpiFs final : public fs::FSImpl
+{
+public:
+    /// One SD sector: the longest the card holds the bus between yields.
+    static constexpr size_t SLICE_BYTES = 512U;
+
+    explicit SpiFs(fs::FS &inner);
+
+    fs::FileImplPtr open(const char *path, const char *mode, const bool create) override;
+    bool exists(const char *path) override;
+    bool rename(const char *pathFrom, const char *pathTo) override;
+    bool remove(const char *path) override;
+    bool mkdir(const char *path) override;
+    bool rmdir(const char *path) override;
+
+private:
+    fs::FS &inner_;
+};
+
+/// @brief The SD card behind SpiFs (the library's `SD` underneath).
+fs::FS &sdFs();
+
+} // namespace hackos::storage
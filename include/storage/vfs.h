@@ -3,8 +3,20 @@
  * @brief Virtual File System – unified access to SD card and internal flash.
  *
  * The VirtualFS singleton routes file operations through a path prefix:
- *  - `/ext/…` → SD card (FAT32, via the Arduino SD library).
+ *  - `/ext/…` → SD card (FAT32, via the Arduino SD library behind SpiFs).
  *  - `/int/…` → Internal flash (LittleFS partition).
+ *  - `/ram/…` → Bounded RAM disk for scratch files (ram_disk.h); always
+ *    available, lost on reboot, unpinned files may be evicted.
+ *
+ * append() to a write-back path (default `/ext/captures/`) lands in a
+ * LittleFS journal (write_back.h) and a low-priority IO task moves it to
+ * the SD in batches once the card is present and has been idle for a
+ * moment.  Opening or listing SD paths first drains the journal, so
+ * readers always see every appended byte.
+ *
+ * init() also runs capture recovery: every DurableWriter sidecar left in
+ * `/int/dur` by a power cut trims its capture to the last complete record
+ * (durable_log.h).
  *
  * Callers interact with a single API regardless of the underlying storage
  * backend, keeping application code storage-agnostic.
@@ -21,6 +33,12 @@
 #include <cstddef>
 #include <cstdint>
 #include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "storage/ram_disk.h"
+#include "storage/write_back.h"
 
 namespace hackos::storage {
 
@@ -31,6 +49,7 @@ enum class StorageType : uint8_t
 {
     SD_CARD, ///< External SD card (`/ext/…`)
     FLASH,   ///< Internal LittleFS flash (`/int/…`)
+    RAM,     ///< In-memory scratch disk (`/ram/…`)
     UNKNOWN, ///< Path prefix not recognised
 };
 
@@ -44,6 +63,10 @@ class VirtualFS
 public:
     static VirtualFS &instance();
 
+    /// Default `/ram/` byte budget; change with ramDisk().setBudget()
+    /// under a RamDiskLock.
+    static constexpr size_t RAM_DISK_BUDGET = 32U * 1024U;
+
     /**
      * @brief Mount both storage back-ends (SD + LittleFS).
      *
@@ -58,7 +81,7 @@ public:
 
     /**
      * @brief Open a file using a virtual path.
-     * @param path  Virtual path (must start with `/ext/` or `/int/`).
+     * @param path  Virtual path (`/ext/…`, `/int/…` or `/ram/…`).
      * @param mode  Arduino file-open mode string (`"r"`, `"w"`, `"a"`).
      * @return An open `fs::File`, or an invalid File (operator bool == false).
      */
@@ -73,6 +96,40 @@ public:
     /// @brief Delete a file.
     bool remove(const char *path);
 
+    // ── Write-back appends ───────────────────────────────────────────────
+
+    static constexpr size_t MAX_WRITE_BACK_PREFIXES = 4U;
+
+    /// @brief Route append() of `/ext/…` paths under @p prefix via the journal.
+    bool addWriteBack(const char *prefix);
+
+    /**
+     * @brief Append @p len bytes to @p path.
+     *
+     * Write-back paths are journaled on flash (works without a card); other
+     * paths, records over WriteBackJournal::MAX_RECORD_DATA and a full
+     * journal fall back to a direct open / write / close.
+     */
+    bool append(const char *path, const uint8_t *data, size_t len);
+
+    /// @brief Move every journaled record to the SD now (blocks).
+    bool syncWriteBack();
+
+    /// @brief Journal bytes not yet on the SD.
+    uint32_t writeBackPending();
+
+    // ── Capture recovery ─────────────────────────────────────────────────
+
+    /// Sidecars of open DurableWriter captures (see durable_log.h).
+    static constexpr const char *DURABLE_DIR = "/int/dur";
+
+    /**
+     * @brief Trim captures interrupted by a power cut to their last
+     *        complete record; sidecars of unavailable storage are kept.
+     * @return Number of captures trimmed.
+     */
+    size_t recoverCaptures();
+
     // ── Directory listing ────────────────────────────────────────────────
 
     /// @brief Metadata for a single directory entry.
@@ -95,12 +152,16 @@ public:
     bool flashMounted() const;
     const char *lastError() const;
 
+    /// @brief The `/ram/` store (budget, pinning, eviction stats).
+    /// Hold a RamDiskLock (ram_fs.h) across every call into it.
+    RamDisk &ramDisk();
+
     // ── Path helpers (public for testability) ────────────────────────────
 
     /// @brief Determine which back-end a virtual path maps to.
     static StorageType resolveStorage(const char *path);
 
-    /// @brief Strip the `/ext` or `/int` prefix, returning the FS-local path.
+    /// @brief Strip the `/ext`, `/int` or `/ram` prefix, returning the FS-local path.
     static const char *stripPrefix(const char *path);
 
 private:
@@ -109,9 +170,32 @@ private:
     /// @brief Return the `fs::FS` reference for the given back-end.
     fs::FS *getFS(StorageType type);
 
+    bool isWriteBack(const char *path) const;
+    /// POSIX truncate through the back-end's mount point.
+    bool truncateFile(const char *path, uint32_t len);
+    void startWriteBack();
+    /// Migrate one batch if due (or if @p force); true if one moved.
+    bool migrateStep(bool force);
+    /// SD access through this class (the migrator waits for a quiet card).
+    void noteSdUse(StorageType type);
+    static void writeBackTask(void *arg);
+
     bool sdMounted_;
     bool flashMounted_;
     const char *lastError_;
+    RamDisk ramDisk_;
+    fs::FS ramFs_;
+
+    WriteBackJournal *journal_;
+    SemaphoreHandle_t journalMutex_;    ///< append / prepare / commit
+    StaticSemaphore_t journalMutexBuf_;
+    SemaphoreHandle_t migrateMutex_;    ///< One migrator at a time
+    StaticSemaphore_t migrateMutexBuf_;
+    TaskHandle_t writeBackTask_;
+    const char *writeBack_[MAX_WRITE_BACK_PREFIXES];
+    size_t writeBackCount_;
+    volatile uint32_t lastSdUseMs_;
+    uint32_t oldestPendingMs_;
 };
 
 } // namespace hackos::storage
@@ -0,0 +1,143 @@
+/**
+ * @file write_back.h
+ * @brief Flash journal for small SD appends, migrated to SD in batches.
+ *
+ * Short log records (decode logs, scan results) cost an SD transaction
+ * each, and the card may not even be inserted.  WriteBackJournal lands
+ * them in a LittleFS journal instead and moves them to their SD files
+ * later, several KiB at a time:
+ *
+ *   record = magic "WB" | pathLen u8 | 0 | dataLen u16 | 0 u16 | crc32 u32
+ *            | path | data                          (little endian, 12 B header)
+ *
+ * Migration runs in three steps so the journal lock is not held while the
+ * SD is written:
+ *
+ *  1. prepare()  – read up to BATCH_BYTES of records (at most BATCH_PATHS
+ *                  target files) and persist an *intent* in the state file:
+ *                  batch end offset plus each target's SD size before
+ *  2. writeOut() – per target, gather its data, append it to SD and
+ *                  sync it, skipping bytes the SD file already grew by
+ *  3. commit()   – advance the committed offset; drop the journal once
+ *                  it is fully migrated
+ *
+ * A crash anywhere replays the pending intent on the next begin(): the
+ * size-before comparison in writeOut() makes the replay exactly-once as
+ * long as nothing else appends to those SD files.  A record torn by a
+ * crash fails its CRC and is skipped byte by byte until the next valid
+ * record.  The state file is rewritten whole, which LittleFS commits
+ * atomically.
+ *
+ * Volumes are abstract so the protocol runs on the host with crash
+ * injection (tools/write_back_bench.cpp).  Not thread-safe; VirtualFS
+ * serialises append() / prepare() / commit() and runs writeOut() on the
+ * migration task alone.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hackos::storage {
+
+/// @brief Minimal file access the journal needs from a volume.
+class TierVolume
+{
+public:
+    virtual ~TierVolume() = default;
+    virtual bool available() = 0;
+    /// @return File size, or -1 if it does not exist.
+    virtual int32_t size(const char *path) = 0;
+    virtual size_t read(const char *path, uint32_t offset, uint8_t *buf, size_t len) = 0;
+    /// Append (create if missing); may stay buffered until sync().
+    virtual bool append(const char *path, const uint8_t *data, size_t len) = 0;
+    /// Make earlier appends to @p path durable.
+    virtual bool sync(const char *path) = 0;
+    /// Replace the whole file atomically.
+    virtual bool replace(const char *path, const uint8_t *data, size_t len) = 0;
+    virtual bool remove(const char *path) = 0;
+};
+
+// ── WriteBackJournal ─────────────────────────────────────────────────────────
+
+class WriteBackJournal
+{
+public:
+    static constexpr size_t MAX_PATH = 48U;
+    static constexpr size_t MAX_RECORD_DATA = 512U;
+    static constexpr size_t HEADER_SIZE = 12U;
+    static constexpr size_t BATCH_BYTES = 4096U;
+    static constexpr size_t BATCH_PATHS = 4U;
+    static constexpr uint32_t JOURNAL_LIMIT = 64U * 1024U;
+
+    struct Stats
+    {
+        uint32_t appends;
+        uint32_t rejected;       ///< Journal full or bad arguments
+        uint32_t batches;
+        uint32_t migratedBytes;
+        uint32_t skippedBytes;   ///< Corrupt / torn journal bytes dropped
+        uint32_t replays;        ///< Intents found at begin()
+    };
+
+    WriteBackJournal(TierVolume &flash, TierVolume &sd,
+                     const char *journalPath, const char *statePath);
+
+    /// @brief Load the state file and reconcile it with the journal.
+    bool begin();
+
+    /**
+     * @brief Journal @p len bytes for SD file @p path as one record.
+     * @return false if @p len exceeds MAX_RECORD_DATA or the journal is
+     *         full; the caller then writes the SD directly.
+     */
+    bool append(const char *path, const uint8_t *data, size_t len);
+
+    /// @brief Journal bytes not yet on SD (headers included).
+    uint32_t pendingBytes() const { return end_ - committed_; }
+
+    bool prepare();
+    bool writeOut();
+    bool commit();
+
+    /// @brief prepare / writeOut / commit until drained or the SD fails.
+    bool migrateAll();
+
+    const Stats &stats() const { return stats_; }
+
+private:
+    struct Target
+    {
+        char path[MAX_PATH];
+        int32_t sizeBefore;
+    };
+
+    bool loadState();
+    bool saveState();
+    void reset();
+    /// Parse the record at @p pos of batch_: its length, 0 if it runs past
+    /// @p avail (more to read), -1 if invalid (or torn, when @p atEnd).
+    int recordAt(size_t pos, size_t avail, bool atEnd, const char **path,
+                 size_t *pathLen, const uint8_t **data, size_t *dataLen) const;
+
+    TierVolume &flash_;
+    TierVolume &sd_;
+    const char *journalPath_;
+    const char *statePath_;
+
+    uint32_t committed_;   ///< Journal offset fully on SD
+    uint32_t end_;         ///< Journal size
+    bool intent_;          ///< targets_ / intentEnd_ describe a batch in flight
+    uint32_t intentEnd_;
+    size_t targetCount_;
+    Target targets_[BATCH_PATHS];
+
+    size_t batchLen_;
+    uint8_t batch_[BATCH_BYTES + HEADER_SIZE + MAX_PATH + MAX_RECORD_DATA];
+    uint8_t out_[BATCH_BYTES + MAX_RECORD_DATA];
+    uint8_t record_[HEADER_SIZE + MAX_PATH + MAX_RECORD_DATA];
+    Stats stats_;
+};
+
+} // namespace hackos::storage
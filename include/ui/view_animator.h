@@ -8,6 +8,10 @@
  * During an animation tick the two buffers are alpha-blended (pixel
  * shift) onto the output canvas.
  *
+ * The two snapshots are leased from the system scratch arena by the
+ * first capture and returned when the slide ends or is cancelled; if the
+ * arena has no room the transition is skipped.
+ *
  * Usage:
  * @code
  *   hackos::ui::ViewAnimator anim;
@@ -23,6 +27,8 @@
 #include <cstdint>
 #include <cstddef>
 
+#include "core/scratch.h"
+
 namespace hackos {
 namespace ui {
 
@@ -40,6 +46,13 @@ public:
     static constexpr int16_t SCREEN_H = 64;
     static constexpr size_t  BUF_SIZE = static_cast<size_t>(SCREEN_W) * static_cast<size_t>(SCREEN_H) / 8U;
 
+    /// Scene snapshots, held in the scratch arena during a transition.
+    struct Scenes
+    {
+        uint8_t out[BUF_SIZE];   ///< Outgoing scene snapshot.
+        uint8_t in[BUF_SIZE];    ///< Incoming scene snapshot.
+    };
+
     ViewAnimator();
 
     /**
@@ -56,6 +69,9 @@ public:
 
     /**
      * @brief Begin a horizontal slide animation.
+     *
+     * Does nothing if no scene was captured (no scratch room).
+     *
      * @param dir        Slide direction.
      * @param durationMs Total animation time in milliseconds.
      */
@@ -86,8 +102,10 @@ private:
     /// Write a single pixel into an SSD1306 page-addressed buffer.
     static void writePixel(uint8_t *buf, int16_t x, int16_t y, bool on);
 
-    uint8_t  bufOut_[BUF_SIZE];   ///< Outgoing scene snapshot.
-    uint8_t  bufIn_[BUF_SIZE];    ///< Incoming scene snapshot.
+    /// Leases the snapshots; false if the arena has no room.
+    bool holdScenes();
+
+    core::ScratchLease<Scenes> scenes_;
     Direction dir_;
     uint16_t durationMs_;
     uint16_t elapsedMs_;
@@ -494,9 +494,18 @@ private:
         transitionTo(AmiiboState::WRITING);
 
         const bool ok = NFCReader::instance().writeNtag215(dumpBuf_);
+        const NtagOpStats &st = NFCReader::instance().lastNtagWrite();
 
-        std::snprintf(statusLine_, sizeof(statusLine_),
-                      ok ? "Write complete!" : "Write failed");
+        if (ok)
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Done %upg %lums",
+                          static_cast<unsigned>(st.written),
+                          static_cast<unsigned long>(st.elapsedUs / 1000U));
+        }
+        else
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Write failed");
+        }
         needsRedraw_ = true;
     }
 
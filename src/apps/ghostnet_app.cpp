@@ -10,6 +10,9 @@
  *  - **Sync**: Broadcast captured WiFi/NFC/IR/RF data to all peers.
  *  - **Remote Exec**: Issue BLE spam or WiFi deauth commands to all
  *    peers (Master mode), or display incoming commands (Node mode).
+ *  - **Survey**: Distributed passive channel survey – the Master splits
+ *    channels 1–13 across peers, nodes sniff their share and stream
+ *    per-channel digests back (see ghostnet_survey.h).
  *
  * Uses the AppBase lifecycle so all work runs cooperatively inside the
  * Core_Task loop.
@@ -26,13 +29,17 @@
 #include <new>
 
 #include <esp_log.h>
+#include <esp_wifi.h>
 #include <freertos/FreeRTOS.h>
 
 #include "core/event.h"
 #include "core/event_system.h"
 #include "core/ghostnet_manager.h"
+#include "core/ghostnet_survey.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
+#include "hardware/radio/frame_parser_80211.h"
+#include "hardware/radio/ring_buffer.h"
 #include "ui/widgets.h"
 
 static constexpr const char *TAG_GNA = "GhostNetApp";
@@ -42,12 +49,14 @@ namespace
 
 // ── Tunables ─────────────────────────────────────────────────────────────────
 
-static constexpr size_t MENU_ITEM_COUNT      = 5U;
+static constexpr size_t MENU_ITEM_COUNT      = 6U;
 static constexpr size_t VISIBLE_ROWS         = 4U;
 static constexpr size_t CHAT_VISIBLE_ROWS    = 4U;
 static constexpr size_t CMD_MENU_ITEMS       = 4U;
 static constexpr uint32_t RADAR_REFRESH_MS   = 500U;
 static constexpr size_t LABEL_BUF_LEN        = 32U;
+static constexpr uint32_t SURVEY_REFRESH_MS  = 500U;
+static constexpr size_t SURVEY_FRAME_RING    = 32U;
 
 // ── App states ───────────────────────────────────────────────────────────────
 
@@ -58,8 +67,71 @@ enum class GhostState : uint8_t
     CHAT_VIEW,
     REMOTE_EXEC,
     SYNC_VIEW,
+    SURVEY_VIEW,
 };
 
+// ── Survey capture (promiscuous callback → app loop) ─────────────────────────
+
+struct SurveyFrame
+{
+    uint8_t channel;
+    hackos::core::SurveyFrameKind kind;
+    int8_t  rssi;
+    bool    isAp;        ///< Beacon / probe response: bssid + ssid valid
+    uint8_t bssid[6];
+    char    ssid[33];
+};
+
+static hackos::radio::RingBuffer<SurveyFrame, SURVEY_FRAME_RING> g_surveyFrames;
+
+static void IRAM_ATTR surveyPromiscuousRxCb(void *buf, wifi_promiscuous_pkt_type_t type)
+{
+    if (buf == nullptr)
+    {
+        return;
+    }
+
+    const auto *pkt = static_cast<const wifi_promiscuous_pkt_t *>(buf);
+
+    SurveyFrame frame;
+    frame.channel = static_cast<uint8_t>(pkt->rx_ctrl.channel);
+    frame.rssi = static_cast<int8_t>(pkt->rx_ctrl.rssi);
+    frame.isAp = false;
+
+    switch (type)
+    {
+    case WIFI_PKT_MGMT:
+    {
+        frame.kind = hackos::core::SurveyFrameKind::MGMT;
+        using namespace hackos::radio;
+        const size_t len = static_cast<size_t>(pkt->rx_ctrl.sig_len);
+        if (isMgmtFrame(pkt->payload, len))
+        {
+            const MgmtFrameInfo info = parseMgmtFrame(pkt->payload, len, frame.rssi);
+            if (info.valid &&
+                (info.subtype == SUBTYPE_BEACON ||
+                 info.subtype == SUBTYPE_PROBE_RESP))
+            {
+                frame.isAp = true;
+                std::memcpy(frame.bssid, info.addr3, sizeof(frame.bssid));
+                std::memcpy(frame.ssid, info.ssid, sizeof(frame.ssid));
+            }
+        }
+        break;
+    }
+    case WIFI_PKT_CTRL:
+        frame.kind = hackos::core::SurveyFrameKind::CTRL;
+        break;
+    case WIFI_PKT_DATA:
+        frame.kind = hackos::core::SurveyFrameKind::DATA;
+        break;
+    default:
+        return;
+    }
+
+    (void)g_surveyFrames.push(frame); // Dropped when the loop falls behind.
+}
+
 // ── Quick-send chat messages ─────────────────────────────────────────────────
 
 static constexpr size_t QUICK_MSG_COUNT = 4U;
@@ -85,6 +157,10 @@ public:
         , chatScrollOffset_(0U)
         , quickMsgIdx_(0U)
         , cmdMenuIdx_(0U)
+        , survey_(hackos::core::GhostNetManager::instance())
+        , surveyPromisc_(false)
+        , surveyChannel_(0U)
+        , lastSurveyDrawMs_(0U)
     {
     }
 
@@ -105,10 +181,13 @@ public:
         }
 
         static const char *const mainItems[MENU_ITEM_COUNT] = {
-            "Radar", "Chat", "Remote Exec", "Sync Data", "Back",
+            "Radar", "Chat", "Remote Exec", "Sync Data", "Survey", "Back",
         };
         menu_.setItems(mainItems, MENU_ITEM_COUNT);
 
+        // Nodes join a Master's survey while the app is open.
+        gn.setServiceHandler(&survey_);
+
         statusBar_.setBatteryLevel(100U);
         state_ = GhostState::MAIN_MENU;
         needsRedraw_ = true;
@@ -119,6 +198,8 @@ public:
         // Tick the GhostNet manager.
         hackos::core::GhostNetManager::instance().tick();
 
+        tickSurvey();
+
         // Refresh radar animation.
         if (state_ == GhostState::RADAR)
         {
@@ -160,6 +241,9 @@ public:
         case GhostState::SYNC_VIEW:
             drawSyncView(disp);
             break;
+        case GhostState::SURVEY_VIEW:
+            drawSurveyView(disp);
+            break;
         }
 
         disp.present();
@@ -206,12 +290,23 @@ public:
         case GhostState::SYNC_VIEW:
             handleSyncInput(input);
             break;
+        case GhostState::SURVEY_VIEW:
+            handleSurveyInput(input);
+            break;
         }
     }
 
     void onDestroy() override
     {
         EventSystem::instance().unsubscribe(this);
+
+        // The survey lives in this app: detach it from the radio task
+        // (waits out a message being queued right now), then tell nodes to
+        // stop and release the radio.
+        hackos::core::GhostNetManager::instance().setServiceHandler(nullptr);
+        survey_.stop();
+        setSurveyCapture(false);
+
         // Leave GhostNet running in background so it can receive messages.
     }
 
@@ -436,6 +531,168 @@ private:
         disp.drawText(2, 44, "captures to peers");
     }
 
+    void drawSurveyView(DisplayManager &disp)
+    {
+        using namespace hackos::core;
+        const SurveyView &view = survey_.view();
+
+        char hdr[32];
+        switch (survey_.role())
+        {
+        case SurveyRole::MASTER:
+            std::snprintf(hdr, sizeof(hdr), "Survey M %u nodes",
+                          static_cast<unsigned>(survey_.participants()));
+            break;
+        case SurveyRole::NODE:
+            std::snprintf(hdr, sizeof(hdr), "Survey Node ch%u",
+                          static_cast<unsigned>(survey_.radioChannel()));
+            break;
+        default:
+            std::snprintf(hdr, sizeof(hdr), "Channel Survey");
+            break;
+        }
+        disp.drawText(0, 10, hdr);
+        disp.drawLine(0, 18, 127, 18);
+
+        if (survey_.role() == SurveyRole::IDLE)
+        {
+            disp.drawText(2, 26, "PRESS: start Master");
+            disp.drawText(2, 36, "Nodes join when the");
+            disp.drawText(2, 46, "Master sends a plan");
+            return;
+        }
+
+        if (survey_.role() == SurveyRole::NODE)
+        {
+            char line[32];
+            size_t assigned = 0U;
+            for (uint8_t ch = 1U; ch <= SURVEY_CHANNEL_COUNT; ++ch)
+            {
+                if ((survey_.assignedMask() & surveyChannelBit(ch)) != 0U)
+                {
+                    ++assigned;
+                }
+            }
+            std::snprintf(line, sizeof(line), "Assigned: %u ch",
+                          static_cast<unsigned>(assigned));
+            disp.drawText(2, 26, line);
+            std::snprintf(line, sizeof(line), "Home: ch%u",
+                          static_cast<unsigned>(survey_.homeChannel()));
+            disp.drawText(2, 36, line);
+            disp.drawText(2, 46, "Reporting to Master");
+            return;
+        }
+
+        // Master: frames/s per channel as bars, APs below.
+        static constexpr int16_t BAR_BASE = 52;
+        static constexpr int16_t BAR_MAX_H = 30;
+        uint32_t maxRate = 1U;
+        for (uint8_t ch = 1U; ch <= SURVEY_CHANNEL_COUNT; ++ch)
+        {
+            const uint32_t rate = view.frameRate(ch);
+            if (rate > maxRate)
+            {
+                maxRate = rate;
+            }
+        }
+        for (uint8_t ch = 1U; ch <= SURVEY_CHANNEL_COUNT; ++ch)
+        {
+            const int16_t x = static_cast<int16_t>(2 + (ch - 1U) * 9);
+            const auto h = static_cast<int16_t>(
+                (view.frameRate(ch) * static_cast<uint32_t>(BAR_MAX_H)) / maxRate);
+            if (h > 0)
+            {
+                disp.fillRect(x, BAR_BASE - h, 7, h);
+            }
+            disp.drawLine(x, BAR_BASE, x + 6, BAR_BASE);
+        }
+
+        char footer[32];
+        std::snprintf(footer, sizeof(footer), "APs:%u  max %lu f/s",
+                      static_cast<unsigned>(view.apCount()),
+                      static_cast<unsigned long>(maxRate));
+        disp.drawText(0, 56, footer);
+    }
+
+    // ── Survey capture ───────────────────────────────────────────────────
+
+    void setSurveyCapture(bool on)
+    {
+        if (on == surveyPromisc_)
+        {
+            return;
+        }
+
+        if (on)
+        {
+            wifi_promiscuous_filter_t filter = {};
+            filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT |
+                                 WIFI_PROMIS_FILTER_MASK_CTRL |
+                                 WIFI_PROMIS_FILTER_MASK_DATA;
+            esp_wifi_set_promiscuous_filter(&filter);
+            esp_wifi_set_promiscuous_rx_cb(&surveyPromiscuousRxCb);
+            surveyPromisc_ = (esp_wifi_set_promiscuous(true) == ESP_OK);
+            ESP_LOGI(TAG_GNA, "Survey capture %s",
+                     surveyPromisc_ ? "started" : "failed");
+            return;
+        }
+
+        esp_wifi_set_promiscuous(false);
+        esp_wifi_set_promiscuous_rx_cb(nullptr);
+        surveyPromisc_ = false;
+        g_surveyFrames.reset();
+
+        // Park the radio back on the GhostNet home channel.
+        const uint8_t home = survey_.homeChannel();
+        if (home != 0U)
+        {
+            (void)esp_wifi_set_channel(home, WIFI_SECOND_CHAN_NONE);
+        }
+        surveyChannel_ = 0U;
+        ESP_LOGI(TAG_GNA, "Survey capture stopped");
+    }
+
+    void tickSurvey()
+    {
+        const uint32_t now = millis();
+        const hackos::core::SurveyRole before = survey_.role();
+        survey_.tick(now);
+
+        setSurveyCapture(survey_.isRunning());
+        if (!survey_.isRunning())
+        {
+            if (before != survey_.role())
+            {
+                needsRedraw_ = true;
+            }
+            return;
+        }
+
+        const uint8_t ch = survey_.radioChannel();
+        if (ch != 0U && ch != surveyChannel_)
+        {
+            (void)esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
+            surveyChannel_ = ch;
+        }
+
+        SurveyFrame frame;
+        while (g_surveyFrames.pop(frame))
+        {
+            survey_.recordFrame(frame.channel, frame.kind, frame.rssi);
+            if (frame.isAp)
+            {
+                survey_.recordAp(frame.channel, frame.bssid, frame.ssid, frame.rssi);
+            }
+        }
+
+        if (state_ == GhostState::SURVEY_VIEW &&
+            (before != survey_.role() || (now - lastSurveyDrawMs_) >= SURVEY_REFRESH_MS))
+        {
+            lastSurveyDrawMs_ = now;
+            needsRedraw_ = true;
+        }
+    }
+
     // ── Input handlers ───────────────────────────────────────────────────
 
     void handleMainMenuInput(InputManager::InputEvent input)
@@ -475,7 +732,11 @@ private:
                 state_ = GhostState::SYNC_VIEW;
                 needsRedraw_ = true;
                 break;
-            case 4U: // Back
+            case 4U: // Survey
+                state_ = GhostState::SURVEY_VIEW;
+                needsRedraw_ = true;
+                break;
+            case 5U: // Back
             {
                 const Event evt{EventType::EVT_SYSTEM, SYSTEM_EVENT_BACK,
                                 0, nullptr};
@@ -487,7 +748,7 @@ private:
             }
 
             // Award XP for using GhostNet.
-            if (sel < 4U)
+            if (sel < 5U)
             {
                 const Event xpEvt{EventType::EVT_XP_EARNED, XP_GHOSTNET_OP,
                                   0, nullptr};
@@ -628,6 +889,40 @@ private:
         }
     }
 
+    void handleSurveyInput(InputManager::InputEvent input)
+    {
+        using hackos::core::SurveyRole;
+
+        if (input == InputManager::InputEvent::BUTTON_PRESS)
+        {
+            if (survey_.role() == SurveyRole::IDLE)
+            {
+                uint8_t primary = 1U;
+                wifi_second_chan_t second = WIFI_SECOND_CHAN_NONE;
+                (void)esp_wifi_get_channel(&primary, &second);
+                if (survey_.startMaster(primary,
+                                        hackos::core::GhostSurvey::DEFAULT_DWELL_MS,
+                                        millis()))
+                {
+                    ESP_LOGI(TAG_GNA, "Survey Master started (home ch%u)",
+                             static_cast<unsigned>(primary));
+                }
+            }
+            else
+            {
+                survey_.stop();
+                ESP_LOGI(TAG_GNA, "Survey stopped");
+            }
+            needsRedraw_ = true;
+        }
+        else if (input == InputManager::InputEvent::LEFT)
+        {
+            // The survey keeps running while the app is open.
+            state_ = GhostState::MAIN_MENU;
+            needsRedraw_ = true;
+        }
+    }
+
     // ── Members ──────────────────────────────────────────────────────────
 
     StatusBar    statusBar_;
@@ -645,6 +940,12 @@ private:
 
     // Remote exec.
     size_t cmdMenuIdx_;
+
+    // Survey.
+    hackos::core::GhostSurvey survey_;
+    bool     surveyPromisc_;
+    uint8_t  surveyChannel_;
+    uint32_t lastSurveyDrawMs_;
 };
 
 } // namespace
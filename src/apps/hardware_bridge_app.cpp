@@ -6,9 +6,17 @@
  *  1. **UART/I2C/SPI Sniffer** – sniffs bus traffic on configurable GPIO
  *     pins.  Captured bytes are displayed on the OLED and streamed to the
  *     Remote Dashboard (Fase 17) via a Server-Sent Events endpoint
- *     (/api/hwbridge/live).
- *  2. **Digital Voltmeter** – reads the ESP32 ADC (0-3.3 V) and renders a
- *     live bar-graph on the OLED display.
+ *     (/api/hwbridge/live).  All three buses are captured by the
+ *     GpioSampler at MHz rates as a run-length transition log and decoded
+ *     from the edges by streaming decoders (UART auto-baud, I2C, SPI in any
+ *     CPOL/CPHA mode).  CENTER records the raw edges to a VCD file on the
+ *     SD card for PulseView.
+ *  2. **Digital Voltmeter** – streams the ESP32 ADC (0-3.3 V) through the
+ *     DMA AdcStream and renders the block mean (1/16 LSB) and ripple as a
+ *     live bar-graph on the OLED display.  Up to 7 h of readings are kept
+ *     in a multi-resolution TimeSeries; UP/DOWN zoom the history chart
+ *     from 6 s to 6 h, and the SSE stream opens with an LTTB-reduced
+ *     history for the dashboard chart.
  *  3. **Signal Generator** – outputs a configurable-frequency PWM square
  *     wave on a GPIO pin for probing actuators or simulating sensors.
  *
@@ -22,7 +30,6 @@
 #include <new>
 
 #include <Arduino.h>
-#include <Wire.h>
 #include <esp_log.h>
 #include <esp_http_server.h>
 #include <driver/ledc.h>
@@ -31,8 +38,16 @@
 #include "core/event.h"
 #include "core/event_system.h"
 #include "core/experience_manager.h"
+#include "core/scratch.h"
+#include "core/time_series.h"
+#include "hardware/adc/adc_stream.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
+#include "hardware/logic/bus_decoders.h"
+#include "hardware/logic/gpio_sampler.h"
+#include "hardware/logic/transition_log.h"
+#include "storage/buffered_stream.h"
+#include "storage/vfs.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
 // Anonymous namespace – all internal implementation
@@ -53,8 +68,20 @@ static constexpr int16_t HEADER_H  = 10;
 /// ADC / Voltmeter
 static constexpr uint16_t ADC_MAX         = 4095U;
 static constexpr float    ADC_REF_VOLTAGE = 3.3f;
-static constexpr size_t   VM_HISTORY_LEN  = 100U; ///< scrolling history
 static constexpr uint32_t VM_SAMPLE_MS    = 50U;   ///< sample every 50 ms
+static constexpr uint32_t VM_STREAM_HZ    = 20000U; ///< DMA rate (one block ≈ 26 ms)
+
+/// Voltmeter history: 7 levels × 128 buckets, ×4 per level ≈ 7 h in 5.25 KB
+static constexpr size_t  VM_HIST_LEVELS  = 7U;
+static constexpr size_t  VM_HIST_BUCKETS = 128U;
+static constexpr uint8_t VM_HIST_FACTOR  = 4U;
+
+/// History chart zoom presets (UP / DOWN)
+static constexpr size_t   VM_SPAN_COUNT = 5U;
+static constexpr uint32_t VM_SPAN_MS[VM_SPAN_COUNT] = {
+    6400U, 60000U, 600000U, 3600000U, 6U * 3600000U,
+};
+static constexpr const char *VM_SPAN_LABELS[VM_SPAN_COUNT] = {"6s", "1m", "10m", "1h", "6h"};
 
 /// Default HW-bridge pins (free GPIOs on ESP32 DevKit v1)
 static constexpr uint8_t PIN_HB_UART_RX = 26U; ///< sniff UART RX
@@ -69,6 +96,21 @@ static constexpr uint8_t PIN_HB_SIGGEN  = 2U;  ///< PWM signal output
 
 /// Sniffer ring buffer
 static constexpr size_t SNIFF_BUF_SIZE = 512U;
+static constexpr const char *SCRATCH_SNIFF = "hb_sniff";
+
+/// Capture channels per protocol (bit n of a logic state = pins[n])
+static constexpr uint8_t UART_PINS[] = {PIN_HB_UART_RX, PIN_HB_UART_TX};
+static constexpr uint8_t I2C_PINS[]  = {PIN_HB_SDA, PIN_HB_SCL};
+static constexpr uint8_t SPI_PINS[]  = {PIN_HB_SPI_CLK, PIN_HB_SPI_MOSI, PIN_HB_SPI_MISO};
+static constexpr const char *UART_NAMES[] = {"RX", "TX"};
+static constexpr const char *I2C_NAMES[]  = {"SDA", "SCL"};
+static constexpr const char *SPI_NAMES[]  = {"CLK", "MOSI", "MISO"};
+static constexpr uint32_t LOGIC_RATE_HZ =
+    hackos::logic::GpioSampler::DEFAULT_RATE_HZ;
+
+/// VCD recordings: /ext/captures/logic_NNN.vcd
+static constexpr const char *VCD_DIR       = "/ext/captures";
+static constexpr unsigned    VCD_MAX_FILES = 1000U;
 
 /// Signal generator
 static constexpr uint32_t SIGGEN_FREQ_MIN  = 1U;
@@ -79,6 +121,8 @@ static constexpr uint8_t  SIGGEN_DUTY_BITS = 8U;
 static constexpr size_t   SSE_LINE_MAX = 256U;
 static constexpr uint32_t SSE_INTERVAL_MS = 200U;
 static constexpr int      SSE_MAX_SAMPLES = 150;
+static constexpr size_t   SSE_HIST_POINTS = 100U; ///< LTTB points sent on connect
+static constexpr size_t   SSE_HIST_CHUNK  = 12U;  ///< points per HTTP chunk (fits the line buffer)
 
 /// LEDC channel / timer for signal generator
 static constexpr ledc_channel_t SIGGEN_LEDC_CH    = LEDC_CHANNEL_1;
@@ -126,13 +170,6 @@ struct SniffRing
     volatile size_t head;
     volatile size_t tail;
 
-    void reset()
-    {
-        head = 0U;
-        tail = 0U;
-        std::memset(data, 0, sizeof(data));
-    }
-
     bool push(uint8_t b)
     {
         const size_t next = (head + 1U) % SNIFF_BUF_SIZE;
@@ -160,13 +197,70 @@ struct SniffRing
 
 // ── Shared state ─────────────────────────────────────────────────────────────
 
-static SniffRing         g_sniffRing;
+/// Leased from the scratch arena while the sniffer runs.
+static hackos::core::ScratchLease<SniffRing> g_sniffRing;
 static volatile bool     g_sniffActive   = false;
 static volatile uint32_t g_sniffBytes    = 0U;
 static SniffProto        g_sniffProto    = SniffProto::UART;
 
-/// UART sniffer uses HardwareSerial(2)
-static HardwareSerial    g_sniffSerial(2);
+// ── Decoder output → sniffer ring ───────────────────────────────────────────
+
+/// I2C addresses are pushed as the byte on the wire (address << 1 | R/W).
+struct SniffSink final : hackos::logic::BusEventSink
+{
+    void onBusEvent(const hackos::logic::BusEvent &e) override
+    {
+        using hackos::logic::BusEventType;
+        uint8_t b = 0U;
+        switch (e.type)
+        {
+        case BusEventType::UART_BYTE:
+        case BusEventType::I2C_DATA:
+        case BusEventType::SPI_WORD:
+            b = static_cast<uint8_t>(e.value);
+            break;
+        case BusEventType::I2C_ADDRESS:
+            b = static_cast<uint8_t>((e.value << 1U) |
+                ((e.flags & hackos::logic::BUS_FLAG_READ) != 0U ? 1U : 0U));
+            break;
+        default:
+            return;
+        }
+        if (g_sniffRing)
+        {
+            g_sniffRing->push(b);
+        }
+        g_sniffBytes++;
+    }
+};
+
+// ── VCD file output ─────────────────────────────────────────────────────────
+
+struct VcdFileSink final : hackos::logic::LogicTextSink
+{
+    hackos::storage::BufferedWriter writer;
+
+    bool write(const char *text, size_t len) override
+    {
+        return writer.write(reinterpret_cast<const uint8_t *>(text), len);
+    }
+};
+
+static hackos::logic::UartConfig uartChannel(uint8_t channel)
+{
+    hackos::logic::UartConfig cfg;
+    cfg.channel = channel; // auto-baud, 8N1
+    return cfg;
+}
+
+static hackos::logic::SpiConfig spiChannels()
+{
+    hackos::logic::SpiConfig cfg;
+    cfg.clk  = 0U;
+    cfg.mosi = 1U;
+    cfg.miso = 2U;
+    return cfg;
+}
 
 // ── SSE shared buffer for dashboard passthrough ──────────────────────────────
 // Latest hex-dump line ready for SSE streaming
@@ -176,6 +270,11 @@ static volatile bool     g_sseNewData = false;
 // ── Voltmeter SSE data ──────────────────────────────────────────────────────
 static volatile float    g_lastVoltage = 0.0f;
 
+// History of the running voltmeter (owned by the app, nullptr when idle);
+// g_vmMux guards it against the SSE handler on the HTTP task.
+static hackos::core::TimeSeries *g_vmHistory = nullptr;
+static portMUX_TYPE              g_vmMux = portMUX_INITIALIZER_UNLOCKED;
+
 // ══════════════════════════════════════════════════════════════════════════════
 // HardwareBridgeApp class
 // ══════════════════════════════════════════════════════════════════════════════
@@ -194,14 +293,13 @@ public:
         menuSel_    = 0U;
         sniffRunning_ = false;
         vmRunning_    = false;
+        vmStream_     = false;
         sgRunning_    = false;
         sgFreq_       = 1000U;
         sgDuty_       = 128U;  // 50 %
-        vmHistIdx_    = 0U;
+        vmSpanIdx_    = 0U;
         lastSampleMs_ = 0U;
         lastXpMs_     = 0U;
-        std::memset(vmHistory_, 0, sizeof(vmHistory_));
-        g_sniffRing.reset();
         g_sniffActive  = false;
         g_sniffBytes   = 0U;
         g_sseNewData   = false;
@@ -279,12 +377,31 @@ private:
     char     hexLine_[128];
     size_t   hexLinePos_;
 
+    // Bus capture: GpioSampler edges → streaming decoders (+ VCD)
+    hackos::logic::TransitionReader logicReader_{
+        hackos::logic::GpioSampler::instance().ring()};
+    SniffSink sniffSink_;
+    hackos::logic::UartDecoder uartRx_{sniffSink_, uartChannel(0U), LOGIC_RATE_HZ};
+    hackos::logic::UartDecoder uartTx_{sniffSink_, uartChannel(1U), LOGIC_RATE_HZ};
+    hackos::logic::I2cDecoder  i2c_{sniffSink_, 0U, 1U};
+    hackos::logic::SpiDecoder  spi_{sniffSink_, spiChannels()};
+    hackos::logic::BusDecoder *decoders_[2] = {};
+    size_t   decoderCount_ = 0U;
+    uint8_t  spiMode_ = 0U;
+
+    VcdFileSink vcdSink_;
+    hackos::logic::VcdWriter vcd_{vcdSink_, LOGIC_RATE_HZ};
+    bool     recording_ = false;
+
     // Voltmeter
     bool     vmRunning_;
-    uint16_t vmHistory_[VM_HISTORY_LEN];
-    size_t   vmHistIdx_;
+    hackos::core::TimeSeriesBuffer<VM_HIST_LEVELS, VM_HIST_BUCKETS> vmHistory_{VM_SAMPLE_MS,
+                                                                              VM_HIST_FACTOR};
+    size_t   vmSpanIdx_;
     uint32_t lastSampleMs_;
     float    currentVoltage_;
+    float    rippleVoltage_;
+    bool     vmStream_;      ///< AdcStream running (else analogRead)
 
     // Signal generator
     bool     sgRunning_;
@@ -375,37 +492,55 @@ private:
     {
         if (sniffRunning_) return;
 
-        g_sniffRing.reset();
+        // A fresh lease is an empty ring.
+        if (!g_sniffRing.acquire(SCRATCH_SNIFF))
+        {
+            ESP_LOGE(TAG_HB, "No scratch memory for the sniff ring");
+            return;
+        }
         g_sniffBytes  = 0U;
         g_sniffActive = true;
         hexLinePos_   = 0U;
         std::memset(hexLine_, 0, sizeof(hexLine_));
 
+        const uint8_t *pins = nullptr;
+        size_t count = 0U;
+        decoderCount_ = 0U;
         switch (g_sniffProto)
         {
         case SniffProto::UART:
-            g_sniffSerial.begin(115200, SERIAL_8N1, PIN_HB_UART_RX, PIN_HB_UART_TX);
-            ESP_LOGI(TAG_HB, "UART sniffer started on RX=%u TX=%u",
-                     PIN_HB_UART_RX, PIN_HB_UART_TX);
+            pins  = UART_PINS;
+            count = sizeof(UART_PINS);
+            decoders_[decoderCount_++] = &uartRx_;
+            decoders_[decoderCount_++] = &uartTx_;
             break;
-
         case SniffProto::I2C:
-            Wire.begin(PIN_HB_SDA, PIN_HB_SCL, 100000U);
-            ESP_LOGI(TAG_HB, "I2C sniffer started on SDA=%u SCL=%u",
-                     PIN_HB_SDA, PIN_HB_SCL);
+            pins  = I2C_PINS;
+            count = sizeof(I2C_PINS);
+            decoders_[decoderCount_++] = &i2c_;
             break;
-
         case SniffProto::SPI:
-            pinMode(PIN_HB_SPI_CLK, INPUT);
-            pinMode(PIN_HB_SPI_MOSI, INPUT);
-            pinMode(PIN_HB_SPI_MISO, INPUT);
-            ESP_LOGI(TAG_HB, "SPI sniffer started (CLK=%u MOSI=%u MISO=%u)",
-                     PIN_HB_SPI_CLK, PIN_HB_SPI_MOSI, PIN_HB_SPI_MISO);
+            pins  = SPI_PINS;
+            count = sizeof(SPI_PINS);
+            spi_.setMode((spiMode_ & 2U) != 0U, (spiMode_ & 1U) != 0U);
+            decoders_[decoderCount_++] = &spi_;
             break;
-
         default:
-            break;
+            g_sniffRing.release();
+            return;
+        }
+
+        logicReader_.reset();
+        for (size_t i = 0U; i < decoderCount_; ++i)
+        {
+            decoders_[i]->reset();
         }
+        if (!hackos::logic::GpioSampler::instance().start(pins, count, LOGIC_RATE_HZ))
+        {
+            ESP_LOGE(TAG_HB, "%s sampler failed to start", sniffProtoName(g_sniffProto));
+        }
+        ESP_LOGI(TAG_HB, "%s sniffer started on %u channels",
+                 sniffProtoName(g_sniffProto), static_cast<unsigned>(count));
 
         sniffRunning_ = true;
     }
@@ -415,89 +550,103 @@ private:
         if (!sniffRunning_) return;
         g_sniffActive = false;
 
-        if (g_sniffProto == SniffProto::UART)
+        // Drain what the sampler already logged, then let the decoders
+        // complete frames that end after the last edge.
+        drainEdges();
+        auto &sampler = hackos::logic::GpioSampler::instance();
+        sampler.stop();
+        hackos::logic::SamplerStats st;
+        sampler.stats(&st);
+        const uint64_t endTick = st.samples + st.blindTicks;
+        for (size_t i = 0U; i < decoderCount_; ++i)
         {
-            g_sniffSerial.end();
+            decoders_[i]->finish(endTick);
         }
+        stopRecording(endTick);
+        g_sniffRing.release();
 
         sniffRunning_ = false;
         ESP_LOGI(TAG_HB, "Sniffer stopped – %lu bytes captured",
                  static_cast<unsigned long>(g_sniffBytes));
     }
 
-    void loopSniffer(uint32_t now)
+    /// @brief Feed every logged edge to the active decoders (and the VCD).
+    void drainEdges()
     {
-        if (!sniffRunning_) return;
-
-        // Read from hardware into ring buffer
-        switch (g_sniffProto)
+        hackos::logic::LogicEdge edge;
+        while (logicReader_.next(&edge))
         {
-        case SniffProto::UART:
-            while (g_sniffSerial.available() > 0)
+            for (size_t i = 0U; i < decoderCount_; ++i)
             {
-                const uint8_t b = static_cast<uint8_t>(g_sniffSerial.read());
-                g_sniffRing.push(b);
-                g_sniffBytes++;
+                decoders_[i]->feed(edge);
             }
-            break;
-
-        case SniffProto::I2C:
-        {
-            // Passive I2C scan: request 1 byte from addresses 0x08-0x77
-            // This is a simplified scan; real sniffer would use
-            // GPIO interrupt-based edge detection.
-            static uint8_t scanAddr = 0x08U;
-            Wire.beginTransmission(scanAddr);
-            uint8_t err = Wire.endTransmission(true);
-            if (err == 0U)
+            if (recording_ && !vcd_.edge(edge))
             {
-                // Device responded – request one byte
-                Wire.requestFrom(scanAddr, static_cast<uint8_t>(1U));
-                if (Wire.available())
-                {
-                    uint8_t b = static_cast<uint8_t>(Wire.read());
-                    g_sniffRing.push(scanAddr);
-                    g_sniffRing.push(b);
-                    g_sniffBytes += 2U;
-                }
+                ESP_LOGE(TAG_HB, "VCD write failed");
+                stopRecording(edge.tick);
             }
-            scanAddr++;
-            if (scanAddr > 0x77U) scanAddr = 0x08U;
-            break;
         }
+    }
 
-        case SniffProto::SPI:
-        {
-            // Bit-bang SPI sniff: sample MOSI on rising CLK edge
-            static volatile uint8_t spiByte  = 0U;
-            static volatile uint8_t spiBit   = 0U;
-            static volatile bool    lastClk  = false;
+    void startRecording()
+    {
+        if (recording_ || !sniffRunning_) return;
 
-            bool clk = digitalRead(PIN_HB_SPI_CLK);
-            if (clk && !lastClk) // rising edge
-            {
-                bool mosi = digitalRead(PIN_HB_SPI_MOSI);
-                spiByte = static_cast<uint8_t>((spiByte << 1U) | (mosi ? 1U : 0U));
-                spiBit++;
-                if (spiBit >= 8U)
-                {
-                    g_sniffRing.push(spiByte);
-                    g_sniffBytes++;
-                    spiByte = 0U;
-                    spiBit  = 0U;
-                }
-            }
-            lastClk = clk;
-            break;
+        auto &vfs = hackos::storage::VirtualFS::instance();
+        vfs.mkdir(VCD_DIR);
+        char path[48];
+        unsigned n = 0U;
+        for (; n < VCD_MAX_FILES; ++n)
+        {
+            std::snprintf(path, sizeof(path), "%s/logic_%03u.vcd", VCD_DIR, n);
+            if (!vfs.exists(path)) break;
+        }
+        if (n == VCD_MAX_FILES || !vcdSink_.writer.begin(path))
+        {
+            ESP_LOGE(TAG_HB, "Cannot create VCD file");
+            return;
         }
 
-        default:
-            break;
+        const char *const *names = SPI_NAMES;
+        size_t count = sizeof(SPI_PINS);
+        if (g_sniffProto == SniffProto::UART)
+        {
+            names = UART_NAMES;
+            count = sizeof(UART_PINS);
+        }
+        else if (g_sniffProto == SniffProto::I2C)
+        {
+            names = I2C_NAMES;
+            count = sizeof(I2C_PINS);
         }
+        if (!vcd_.begin(names, count, logicReader_.state()))
+        {
+            vcdSink_.writer.close();
+            return;
+        }
+        recording_ = true;
+        ESP_LOGI(TAG_HB, "Recording edges to %s", path);
+    }
+
+    void stopRecording(uint64_t endTick)
+    {
+        if (!recording_) return;
+        recording_ = false;
+        vcd_.finish(endTick);
+        vcdSink_.writer.close();
+        ESP_LOGI(TAG_HB, "VCD closed – %lu bytes",
+                 static_cast<unsigned long>(vcdSink_.writer.bytesWritten()));
+    }
+
+    void loopSniffer(uint32_t now)
+    {
+        if (!sniffRunning_) return;
+
+        drainEdges();
 
         // Build hex-dump line for display + SSE passthrough
         uint8_t b;
-        while (g_sniffRing.pop(b))
+        while (g_sniffRing->pop(b))
         {
             char hex[4];
             std::snprintf(hex, sizeof(hex), "%02X ", b);
@@ -555,11 +704,49 @@ private:
             d.drawText(0, 14, "Waiting for data...");
         }
 
-        // Protocol selector hint
-        d.drawText(0, 38, "U/D:protocol L:back");
+        if (sniffRunning_)
+        {
+            // Sustained rate, then the baud / SPI mode / samples per byte
+            hackos::logic::SamplerStats st;
+            hackos::logic::GpioSampler::instance().stats(&st);
+            char detail[12];
+            if (g_sniffProto == SniffProto::UART)
+            {
+                if (uartRx_.baud() != 0U)
+                {
+                    std::snprintf(detail, sizeof(detail), "%lubd",
+                                  static_cast<unsigned long>(uartRx_.baud()));
+                }
+                else
+                {
+                    std::snprintf(detail, sizeof(detail), "auto");
+                }
+            }
+            else if (g_sniffProto == SniffProto::SPI)
+            {
+                std::snprintf(detail, sizeof(detail), "mode%u", static_cast<unsigned>(spiMode_));
+            }
+            else
+            {
+                const unsigned long perByte = (st.log.bytes > 0U)
+                    ? static_cast<unsigned long>(st.samples / st.log.bytes) : 0UL;
+                std::snprintf(detail, sizeof(detail), "%lu:1", perByte);
+            }
+            char rate[24];
+            std::snprintf(rate, sizeof(rate), "%lu.%02luMS/s %s",
+                          static_cast<unsigned long>(st.achievedHz / 1000000U),
+                          static_cast<unsigned long>((st.achievedHz / 10000U) % 100U),
+                          detail);
+            d.drawText(0, 38, rate);
+        }
+        else
+        {
+            // Protocol selector hint
+            d.drawText(0, 38, "U/D:protocol L:back");
+        }
 
         // Ring buffer usage bar
-        const size_t used = g_sniffRing.available();
+        const size_t used = g_sniffRing ? g_sniffRing->available() : 0U;
         const int16_t barW = static_cast<int16_t>((used * 120U) / SNIFF_BUF_SIZE);
         d.drawRect(0, 54, 124, 8);
         if (barW > 0)
@@ -568,7 +755,9 @@ private:
         }
 
         // Show passthrough status
-        d.drawText(0, 48, sniffRunning_ ? "[LIVE->Dashboard]" : "[STOPPED]");
+        d.drawText(0, 48, !sniffRunning_ ? "[STOPPED]"
+                          : recording_   ? "[REC VCD] C:stop"
+                                         : "[LIVE->Dashboard]");
     }
 
     void handleSnifferInput(InputManager::InputEvent input)
@@ -595,6 +784,25 @@ private:
             startSniffer();
             break;
         }
+        case InputManager::InputEvent::RIGHT:
+            // Cycle SPI mode (CPOL << 1 | CPHA)
+            if (g_sniffProto == SniffProto::SPI)
+            {
+                spiMode_ = static_cast<uint8_t>((spiMode_ + 1U) & 3U);
+                spi_.setMode((spiMode_ & 2U) != 0U, (spiMode_ & 1U) != 0U);
+            }
+            break;
+        case InputManager::InputEvent::CENTER:
+        case InputManager::InputEvent::BUTTON_PRESS:
+            if (recording_)
+            {
+                stopRecording(logicReader_.tick());
+            }
+            else
+            {
+                startRecording();
+            }
+            break;
         case InputManager::InputEvent::LEFT:
             stopSniffer();
             view_ = HBView::MENU;
@@ -611,17 +819,37 @@ private:
     void startVoltmeter()
     {
         vmRunning_ = true;
-        vmHistIdx_ = 0U;
         currentVoltage_ = 0.0f;
-        std::memset(vmHistory_, 0, sizeof(vmHistory_));
-        analogReadResolution(12);
-        pinMode(PIN_HB_ADC, INPUT);
-        ESP_LOGI(TAG_HB, "Voltmeter started on ADC pin %u", PIN_HB_ADC);
+        rippleVoltage_  = 0.0f;
+        portENTER_CRITICAL(&g_vmMux);
+        vmHistory_.clear();
+        g_vmHistory = &vmHistory_;
+        portEXIT_CRITICAL(&g_vmMux);
+
+        hackos::adc::AdcStreamConfig cfg;
+        cfg.pin    = PIN_HB_ADC;
+        cfg.rateHz = VM_STREAM_HZ;
+        vmStream_ = hackos::adc::AdcStream::instance().start(cfg);
+        if (!vmStream_)
+        {
+            analogReadResolution(12);
+            pinMode(PIN_HB_ADC, INPUT);
+        }
+        ESP_LOGI(TAG_HB, "Voltmeter started on ADC pin %u (%s)", PIN_HB_ADC,
+                 vmStream_ ? "DMA" : "polled");
     }
 
     void stopVoltmeter()
     {
+        if (vmStream_)
+        {
+            hackos::adc::AdcStream::instance().stop();
+            vmStream_ = false;
+        }
         vmRunning_ = false;
+        portENTER_CRITICAL(&g_vmMux);
+        g_vmHistory = nullptr;
+        portEXIT_CRITICAL(&g_vmMux);
     }
 
     void loopVoltmeter(uint32_t now)
@@ -630,20 +858,44 @@ private:
         if ((now - lastSampleMs_) < VM_SAMPLE_MS) return;
         lastSampleMs_ = now;
 
-        const uint16_t raw = static_cast<uint16_t>(analogRead(PIN_HB_ADC));
-        currentVoltage_ = (static_cast<float>(raw) / static_cast<float>(ADC_MAX)) * ADC_REF_VOLTAGE;
+        constexpr float LSB_V = ADC_REF_VOLTAGE / static_cast<float>(ADC_MAX);
+        uint16_t raw = 0U;
+        if (vmStream_)
+        {
+            // Mean and RMS ripple of the newest DMA block
+            hackos::adc::AdcBlockStats st;
+            if (!hackos::adc::AdcStream::instance().latest(&st)) return;
+            raw = static_cast<uint16_t>((st.meanQ4 + 8U) >> 4);
+            currentVoltage_ = static_cast<float>(st.meanQ4) / 16.0f * LSB_V;
+            rippleVoltage_  = static_cast<float>(st.acRmsQ4) / 16.0f * LSB_V;
+        }
+        else
+        {
+            raw = static_cast<uint16_t>(analogRead(PIN_HB_ADC));
+            currentVoltage_ = static_cast<float>(raw) * LSB_V;
+        }
         g_lastVoltage = currentVoltage_;
 
-        vmHistory_[vmHistIdx_ % VM_HISTORY_LEN] = raw;
-        vmHistIdx_++;
+        portENTER_CRITICAL(&g_vmMux);
+        vmHistory_.push(static_cast<int16_t>(raw));
+        portEXIT_CRITICAL(&g_vmMux);
     }
 
     void drawVoltmeter(DisplayManager &d)
     {
-        // Header with voltage reading
+        // Header with voltage reading (and RMS ripple when streaming)
         char hdr[24];
-        std::snprintf(hdr, sizeof(hdr), "VM: %.2fV", static_cast<double>(currentVoltage_));
+        if (vmStream_)
+        {
+            std::snprintf(hdr, sizeof(hdr), "VM: %.2fV ~%umV", static_cast<double>(currentVoltage_),
+                          static_cast<unsigned>(rippleVoltage_ * 1000.0f + 0.5f));
+        }
+        else
+        {
+            std::snprintf(hdr, sizeof(hdr), "VM: %.2fV", static_cast<double>(currentVoltage_));
+        }
         d.drawText(0, 0, hdr);
+        d.drawText(110, 0, VM_SPAN_LABELS[vmSpanIdx_]);
 
         // Large voltage display
         char bigV[10];
@@ -669,28 +921,42 @@ private:
         d.drawText(55, barY + barH + 2, "1.65");
         d.drawText(110, barY + barH + 2, "3.3");
 
-        // Scrolling history waveform (bottom area)
+        // History chart (bottom area): one min..max line per column over
+        // the selected span, newest at the right edge
         const int16_t waveY = 48;
         const int16_t waveH = 14;
-        const size_t  count = (vmHistIdx_ < VM_HISTORY_LEN) ? vmHistIdx_ : VM_HISTORY_LEN;
-        const size_t  start = (vmHistIdx_ >= VM_HISTORY_LEN) ? (vmHistIdx_ - VM_HISTORY_LEN) : 0U;
-
-        for (size_t i = 0U; i < count && i < static_cast<size_t>(DISPLAY_W); ++i)
+        hackos::core::TsBucket cols[DISPLAY_W];
+        const size_t count = vmHistory_.envelope(VM_SPAN_MS[vmSpanIdx_], cols,
+                                                 static_cast<size_t>(DISPLAY_W));
+        auto level = [waveH](int16_t raw) {
+            return static_cast<int16_t>(static_cast<int32_t>(raw) * waveH / ADC_MAX);
+        };
+
+        for (size_t i = 0U; i < count; ++i)
         {
-            const uint16_t raw = vmHistory_[(start + i) % VM_HISTORY_LEN];
-            const int16_t h = static_cast<int16_t>(
-                (static_cast<float>(raw) / static_cast<float>(ADC_MAX)) * static_cast<float>(waveH));
-            const int16_t x = static_cast<int16_t>(i);
-            d.drawLine(x, waveY + waveH - h, x, waveY + waveH);
+            const int16_t x = static_cast<int16_t>(DISPLAY_W - static_cast<int16_t>(count) +
+                                                   static_cast<int16_t>(i));
+            d.drawLine(x, waveY + waveH - level(cols[i].max), x,
+                       waveY + waveH - level(cols[i].min));
         }
     }
 
     void handleVmInput(InputManager::InputEvent input)
     {
-        if (input == InputManager::InputEvent::LEFT)
+        switch (input)
         {
+        case InputManager::InputEvent::UP:
+            if (vmSpanIdx_ + 1U < VM_SPAN_COUNT) ++vmSpanIdx_;
+            break;
+        case InputManager::InputEvent::DOWN:
+            if (vmSpanIdx_ > 0U) --vmSpanIdx_;
+            break;
+        case InputManager::InputEvent::LEFT:
             stopVoltmeter();
             view_ = HBView::MENU;
+            break;
+        default:
+            break;
         }
     }
 
@@ -861,6 +1127,11 @@ public:
         httpd_resp_set_hdr(req, "Connection", "keep-alive");
         httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
 
+        if (sendVmHistory(req) != ESP_OK)
+        {
+            return httpd_resp_send_chunk(req, nullptr, 0);
+        }
+
         for (int i = 0; i < SSE_MAX_SAMPLES; ++i)
         {
             char buf[SSE_LINE_MAX + 64];
@@ -893,6 +1164,53 @@ public:
 
         return httpd_resp_send_chunk(req, nullptr, 0);
     }
+
+private:
+    /**
+     * @brief Open the stream with the voltmeter history as one event:
+     *        data: {"type":"vmhist","points":[[ageMs,mV],...]}
+     *
+     * The whole retained history is LTTB-reduced to SSE_HIST_POINTS, so a
+     * chart of hours costs ~1.5 KB instead of one event per sample.
+     */
+    static esp_err_t sendVmHistory(httpd_req_t *req)
+    {
+        hackos::core::TsPoint pts[SSE_HIST_POINTS];
+        size_t n = 0U;
+        portENTER_CRITICAL(&g_vmMux);
+        if (g_vmHistory != nullptr)
+        {
+            n = g_vmHistory->downsample(g_vmHistory->historyMs(), pts, SSE_HIST_POINTS);
+        }
+        portEXIT_CRITICAL(&g_vmMux);
+        if (n == 0U)
+        {
+            return ESP_OK;
+        }
+
+        char buf[SSE_LINE_MAX + 64];
+        int len = std::snprintf(buf, sizeof(buf), "data: {\"type\":\"vmhist\",\"points\":[");
+        for (size_t i = 0U; i < n; ++i)
+        {
+            const unsigned mv = static_cast<unsigned>(
+                static_cast<uint32_t>(pts[i].value) * 3300U / ADC_MAX);
+            len += std::snprintf(buf + len, sizeof(buf) - static_cast<size_t>(len), "%s[%lu,%u]",
+                                 (i == 0U) ? "" : ",", static_cast<unsigned long>(pts[i].ageMs), mv);
+            if ((i + 1U) % SSE_HIST_CHUNK == 0U || i + 1U == n)
+            {
+                if (i + 1U == n)
+                {
+                    len += std::snprintf(buf + len, sizeof(buf) - static_cast<size_t>(len), "]}\n\n");
+                }
+                if (httpd_resp_send_chunk(req, buf, len) != ESP_OK)
+                {
+                    return ESP_FAIL;
+                }
+                len = 0;
+            }
+        }
+        return ESP_OK;
+    }
 };
 
 // Constexpr static member definitions
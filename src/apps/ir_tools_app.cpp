@@ -4,13 +4,18 @@
  *        DB Manager.
  *
  * Features:
- *  - **TV-B-Gone (Universal Remote)**: Reads `/ext/assets/ir/tv_bgone.csv`
- *    and sequentially transmits Power codes for 50+ brands with 200 ms delay.
+ *  - **TV-B-Gone (Universal Remote)**: Streams Power codes from the compiled
+ *    database `/ext/assets/ir/tv_bgone.irdb` with 200 ms delay.  The
+ *    database is (re)compiled from `tv_bgone.csv` when it is missing or the
+ *    CSV size changed.
  *  - **Protocol Auto-Detect (Sniffer)**: Receives an IR signal on GPIO15,
  *    identifies the protocol (NEC, Sony, Samsung, RC5, etc.), and displays
- *    the hex value and bit length.
+ *    the hex value, bit length and the matching brand from the database.
  *  - **Signal Editor**: Allows editing a captured hex code before re-sending.
  *  - **DB Manager**: Name-and-save captured codes to SD for future replay.
+ *    Codes IRremoteESP8266 cannot decode are saved as compressed raw
+ *    timings (`.irr`, see hardware/ir/ir_raw_codec.h) and replayed with
+ *    sendRaw().
  */
 
 #include "apps/ir_tools_app.h"
@@ -27,8 +32,10 @@
 #include "core/event_system.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
+#include "hardware/ir/ir_code_db.h"
+#include "hardware/ir/ir_raw_codec.h"
 #include "hardware/ir_transceiver.h"
-#include "hardware/storage.h"
+#include "storage/buffered_stream.h"
 #include "storage/vfs.h"
 #include "ui/widgets.h"
 
@@ -67,14 +74,24 @@ static const char *const IR_MENU_LABELS[IR_MENU_COUNT] = {
 
 // ── TV-B-Gone constants ─────────────────────────────────────────────────────
 
-/// Path to the TV-B-Gone CSV database on the SD card.
+/// Path to the TV-B-Gone CSV source on the SD card.
 static constexpr const char *TV_BGONE_PATH = "/ext/assets/ir/tv_bgone.csv";
 
+/// Compiled database built from TV_BGONE_PATH (also used for reverse lookup).
+static constexpr const char *TV_BGONE_DB_PATH = "/ext/assets/ir/tv_bgone.irdb";
+
+/// Sorted runs spilled while compiling: RAM disk first, SD if they do not fit.
+static constexpr const char *IRDB_RUNS_RAM = "/ram/ir/irdb_runs.tmp";
+static constexpr const char *IRDB_RUNS_TMP = "/ext/assets/ir/.irdb_runs.tmp";
+
+/// Records sorted in RAM per run while compiling (16 B each).
+static constexpr size_t IRDB_RUN_RECORDS = 256U;
+
 /// Delay between sequential code transmissions (milliseconds).
 static constexpr uint32_t TV_BGONE_DELAY_MS = 200U;
 
-/// Maximum number of codes to store from the CSV.
-static constexpr size_t TV_BGONE_MAX_CODES = 64U;
+/// SD read chunk while compiling.
+static constexpr size_t IO_CHUNK = 128U;
 
 /// Maximum CSV line length.
 static constexpr size_t CSV_LINE_MAX = 128U;
@@ -87,19 +104,75 @@ static constexpr const char *IR_SAVED_DIR = "/ext/assets/ir/saved";
 /// Maximum saved entries shown in the load list.
 static constexpr size_t DB_MAX_ENTRIES = 16U;
 
+/// Extension of saved raw captures (decoded codes use .csv).
+static constexpr const char *IR_RAW_EXT = ".irr";
+
+/// Carrier assumed for raw captures (IRrecv does not measure it).
+static constexpr uint8_t IR_RAW_CARRIER_KHZ = 38U;
+
 // ── Signal Editor constants ─────────────────────────────────────────────────
 
 /// Number of hex nibbles editable (8 nibbles = 32-bit code).
 static constexpr size_t HEX_NIBBLES = 8U;
 
-// ── TV-B-Gone entry ─────────────────────────────────────────────────────────
+// ── Code database I/O ───────────────────────────────────────────────────────
 
-struct TvBGoneEntry
+/// @brief IrByteSink that appends to a BufferedWriter.
+class WriterSink final : public hackos::ir::IrByteSink
 {
-    char brand[20];
-    decode_type_t protocol;
-    uint64_t code;
-    uint16_t bits;
+public:
+    explicit WriterSink(hackos::storage::BufferedWriter &writer) : writer_(writer) {}
+
+    bool write(const uint8_t *data, size_t len) override
+    {
+        return writer_.write(data, len);
+    }
+
+private:
+    hackos::storage::BufferedWriter &writer_;
+};
+
+/// @brief IrByteSource over an open VirtualFS file (seek + read).
+class FileSource final : public hackos::ir::IrByteSource
+{
+public:
+    FileSource() : size_(0U) {}
+
+    bool open(const char *path)
+    {
+        close();
+        file_ = hackos::storage::VirtualFS::instance().open(path, "r");
+        if (!file_)
+        {
+            return false;
+        }
+        size_ = static_cast<uint32_t>(file_.size());
+        return true;
+    }
+
+    void close()
+    {
+        if (file_)
+        {
+            file_.close();
+        }
+        size_ = 0U;
+    }
+
+    uint32_t size() const override { return size_; }
+
+    size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        if (!file_ || !file_.seek(offset))
+        {
+            return 0U;
+        }
+        return file_.read(buf, len);
+    }
+
+private:
+    fs::File file_;
+    uint32_t size_;
 };
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -118,20 +191,26 @@ public:
           clonerSent_(false),
           protoName_{},
           codeHex_{},
+          sniffBrand_{},
           tvbEntryCount_(0U),
           tvbCurrent_(0U),
           tvbRunning_(false),
           tvbLastSendMs_(0U),
+          tvbBrand_{},
+          tvbCode_(0U),
           editNibbleIdx_(0U),
           editValue_(0U),
           editBits_(32U),
           editProto_(static_cast<decode_type_t>(3)), // NEC default
+          dbEntryRaw_{},
           dbEntryCount_(0U),
+          rawBlob_{},
+          rawBlobLen_(0U),
+          loadedRaw_(false),
           saveName_{},
           saveNameLen_(0U),
           saveNameCursorChar_('A')
     {
-        std::memset(tvbEntries_, 0, sizeof(tvbEntries_));
         std::memset(dbEntryNames_, 0, sizeof(dbEntryNames_));
     }
 
@@ -240,6 +319,7 @@ public:
     void onDestroy() override
     {
         IRTransceiver::instance().deinit();
+        closeCodeDb();
         EventSystem::instance().unsubscribe(this);
         ESP_LOGI(TAG_IR_APP, "destroyed");
     }
@@ -253,13 +333,19 @@ private:
     bool clonerSent_;
     char protoName_[16];
     char codeHex_[20];
+    char sniffBrand_[24];
+
+    // ── Compiled code database ──────────────────────────────────────────
+    FileSource codeDbFile_;
+    hackos::ir::IrCodeDb codeDb_;
 
     // ── TV-B-Gone state ─────────────────────────────────────────────────
-    TvBGoneEntry tvbEntries_[TV_BGONE_MAX_CODES];
     size_t tvbEntryCount_;
     size_t tvbCurrent_;
     bool tvbRunning_;
     uint32_t tvbLastSendMs_;
+    char tvbBrand_[20];
+    uint64_t tvbCode_;
 
     // ── Signal Editor state ─────────────────────────────────────────────
     size_t editNibbleIdx_;
@@ -269,9 +355,16 @@ private:
 
     // ── DB Manager state ────────────────────────────────────────────────
     char dbEntryNames_[DB_MAX_ENTRIES][20];
+    bool dbEntryRaw_[DB_MAX_ENTRIES];
     const char *dbMenuLabels_[DB_MAX_ENTRIES];
     size_t dbEntryCount_;
 
+    /// Compressed raw capture loaded from the DB (or being saved).
+    uint8_t rawBlob_[hackos::ir::IR_RAW_MAX_BYTES];
+    size_t rawBlobLen_;
+    bool loadedRaw_;
+    hackos::ir::IrRawDecoder rawDecoder_;
+
     /// Name being composed in DB_SAVE state.
     char saveName_[16];
     size_t saveNameLen_;
@@ -305,6 +398,7 @@ private:
             std::snprintf(bits, sizeof(bits), "Bits: %u",
                           static_cast<unsigned>(IRTransceiver::instance().lastBits()));
             DisplayManager::instance().drawText(2, 48, bits);
+            DisplayManager::instance().drawText(2, 58, sniffBrand_);
         }
         else
         {
@@ -330,6 +424,17 @@ private:
             editBits_ = bits;
             editProto_ = proto;
 
+            if (proto == decode_type_t::UNKNOWN)
+            {
+                uint16_t count = 0U;
+                (void)IRTransceiver::instance().lastRaw(&count);
+                std::snprintf(sniffBrand_, sizeof(sniffBrand_), "Raw: %u timings",
+                              static_cast<unsigned>(count));
+            }
+            else
+            {
+                lookupBrand(proto, value, bits);
+            }
             needsRedraw_ = true;
             ESP_LOGI(TAG_IR_APP, "sniffed: %s 0x%llX %ubits",
                      protoName_,
@@ -361,10 +466,20 @@ private:
             return;
         }
 
-        IRTransceiver::instance().send(
-            IRTransceiver::instance().lastValue(),
-            IRTransceiver::instance().lastProtocol(),
-            IRTransceiver::instance().lastBits());
+        uint16_t rawCount = 0U;
+        const uint16_t *raw = IRTransceiver::instance().lastRaw(&rawCount);
+        if (IRTransceiver::instance().lastProtocol() == decode_type_t::UNKNOWN &&
+            raw != nullptr)
+        {
+            IRTransceiver::instance().sendRaw(raw, rawCount, IR_RAW_CARRIER_KHZ);
+        }
+        else
+        {
+            IRTransceiver::instance().send(
+                IRTransceiver::instance().lastValue(),
+                IRTransceiver::instance().lastProtocol(),
+                IRTransceiver::instance().lastBits());
+        }
 
         ESP_LOGI(TAG_IR_APP, "cloned code sent");
         clonerSent_ = true;
@@ -373,70 +488,163 @@ private:
 
     // ── TV-B-Gone ───────────────────────────────────────────────────────
 
-    bool loadTvBGoneDb()
+    /**
+     * @brief Open the compiled database, compiling it from the CSV when it
+     *        is missing or was built from a CSV of a different size.
+     */
+    bool openCodeDb()
     {
+        if (codeDb_.isOpen())
+        {
+            return true;
+        }
+
+        uint32_t csvBytes = 0U;
         auto &vfs = hackos::storage::VirtualFS::instance();
-        fs::File f = vfs.open(TV_BGONE_PATH, "r");
-        if (!f)
+        fs::File csv = vfs.open(TV_BGONE_PATH, "r");
+        if (csv)
         {
-            ESP_LOGE(TAG_IR_APP, "Cannot open %s", TV_BGONE_PATH);
-            return false;
+            csvBytes = static_cast<uint32_t>(csv.size());
+            csv.close();
         }
 
-        tvbEntryCount_ = 0U;
-        char line[CSV_LINE_MAX];
+        if (codeDbFile_.open(TV_BGONE_DB_PATH) && codeDb_.open(codeDbFile_) &&
+            (csvBytes == 0U || codeDb_.sourceBytes() == csvBytes))
+        {
+            return true;
+        }
+        closeCodeDb();
 
-        while (f.available() && tvbEntryCount_ < TV_BGONE_MAX_CODES)
+        if (csvBytes == 0U ||
+            (!compileCodeDb(IRDB_RUNS_RAM) && !compileCodeDb(IRDB_RUNS_TMP)))
         {
-            const size_t len = f.readBytesUntil('\n', line, sizeof(line) - 1U);
-            if (len == 0U)
-            {
-                continue;
-            }
-            line[len] = '\0';
+            ESP_LOGE(TAG_IR_APP, "No IR code database (%s)", TV_BGONE_PATH);
+            return false;
+        }
+        if (!codeDbFile_.open(TV_BGONE_DB_PATH) || !codeDb_.open(codeDbFile_))
+        {
+            closeCodeDb();
+            return false;
+        }
+        return true;
+    }
 
-            // Skip comment lines
-            if (line[0] == '#')
-            {
-                continue;
-            }
+    void closeCodeDb()
+    {
+        codeDb_.close();
+        codeDbFile_.close();
+    }
 
-            // Parse: brand,protocol_id,hex_code,bits
-            char *saveptr = nullptr;
-            char *brand = strtok_r(line, ",", &saveptr);
-            char *protoStr = strtok_r(nullptr, ",", &saveptr);
-            char *codeStr = strtok_r(nullptr, ",", &saveptr);
-            char *bitsStr = strtok_r(nullptr, ",\r\n", &saveptr);
+    /// @brief Compile TV_BGONE_PATH into TV_BGONE_DB_PATH (external sort via @p runsPath).
+    static bool compileCodeDb(const char *runsPath)
+    {
+        auto *runBuf = new (std::nothrow) hackos::ir::IrCodeRecord[IRDB_RUN_RECORDS];
+        auto *builder = new (std::nothrow) hackos::ir::IrCodeDbBuilder(runBuf,
+                                                                       IRDB_RUN_RECORDS);
+        bool ok = (runBuf != nullptr && builder != nullptr);
 
-            if (brand == nullptr || protoStr == nullptr ||
-                codeStr == nullptr || bitsStr == nullptr)
+        // Pass 1: parse the CSV into sorted runs.
+        if (ok)
+        {
+            hackos::storage::BufferedReader reader;
+            hackos::storage::BufferedWriter runs;
+            ok = reader.begin(TV_BGONE_PATH) && runs.begin(runsPath);
+            WriterSink runSink(runs);
+            builder->begin(runSink);
+            uint8_t chunk[IO_CHUNK];
+            while (ok && !reader.isFinished())
             {
-                continue;
+                const size_t n = reader.readChunk(chunk, sizeof(chunk));
+                if (n == 0U)
+                {
+                    break;
+                }
+                ok = builder->feed(reinterpret_cast<const char *>(chunk), n);
             }
+            ok = ok && builder->finish() && runs.flush();
+            reader.close();
+            runs.close();
+        }
 
-            TvBGoneEntry &e = tvbEntries_[tvbEntryCount_];
-            std::snprintf(e.brand, sizeof(e.brand), "%.19s", brand);
-            e.protocol = static_cast<decode_type_t>(std::strtol(protoStr, nullptr, 10));
-            e.code = std::strtoull(codeStr, nullptr, 16);
-            e.bits = static_cast<uint16_t>(std::strtoul(bitsStr, nullptr, 10));
+        // Pass 2: merge the runs into the database.
+        if (ok)
+        {
+            FileSource runSource;
+            hackos::storage::BufferedWriter out;
+            ok = runSource.open(runsPath) && out.begin(TV_BGONE_DB_PATH);
+            WriterSink outSink(out);
+            ok = ok && builder->write(outSink, runSource) && out.flush();
+            out.close();
+            runSource.close();
+        }
 
-            ++tvbEntryCount_;
+        auto &vfs = hackos::storage::VirtualFS::instance();
+        (void)vfs.remove(runsPath);
+        if (!ok)
+        {
+            (void)vfs.remove(TV_BGONE_DB_PATH);
         }
+        if (builder != nullptr)
+        {
+            ESP_LOGI(TAG_IR_APP, "IR DB compile via %s %s: %u codes, %u runs, %u skipped",
+                     runsPath, ok ? "OK" : "FAILED",
+                     static_cast<unsigned>(builder->recordCount()),
+                     static_cast<unsigned>(builder->runCount()),
+                     static_cast<unsigned>(builder->skippedLines()));
+        }
+        delete builder;
+        delete[] runBuf;
+        return ok;
+    }
 
-        f.close();
-        ESP_LOGI(TAG_IR_APP, "Loaded %u TV-B-Gone entries", static_cast<unsigned>(tvbEntryCount_));
-        return tvbEntryCount_ > 0U;
+    /// @brief Reverse lookup of a sniffed code into sniffBrand_.
+    void lookupBrand(decode_type_t proto, uint64_t value, uint16_t bits)
+    {
+        uint32_t index = 0U;
+        hackos::ir::IrCodeRecord rec;
+        char brand[16];
+        if (codeDb_.isOpen() &&
+            codeDb_.find(static_cast<uint16_t>(proto), value, bits, &index) &&
+            codeDb_.record(index, &rec) && codeDb_.brand(rec, brand, sizeof(brand)))
+        {
+            // Count further brands sharing this exact code.
+            unsigned others = 0U;
+            hackos::ir::IrCodeRecord next;
+            while (others < 9U && codeDb_.record(index + 1U + others, &next) &&
+                   next.protocol == rec.protocol && next.value == rec.value &&
+                   next.bits == rec.bits)
+            {
+                ++others;
+            }
+            if (others > 0U)
+            {
+                std::snprintf(sniffBrand_, sizeof(sniffBrand_), "DB: %s +%u", brand, others);
+            }
+            else
+            {
+                std::snprintf(sniffBrand_, sizeof(sniffBrand_), "DB: %s", brand);
+            }
+        }
+        else
+        {
+            std::snprintf(sniffBrand_, sizeof(sniffBrand_), "%s",
+                          codeDb_.isOpen() ? "DB: no match" : "");
+        }
     }
 
     void startTvBGone()
     {
-        if (!loadTvBGoneDb())
+        if (!openCodeDb() || codeDb_.count() == 0U)
         {
             ESP_LOGW(TAG_IR_APP, "TV-B-Gone DB empty or not found");
             return;
         }
 
+        ESP_LOGI(TAG_IR_APP, "TV-B-Gone: %u codes, %u protocols",
+                 static_cast<unsigned>(codeDb_.count()),
+                 static_cast<unsigned>(codeDb_.protocolCount()));
         IRTransceiver::instance().initTransmit();
+        tvbEntryCount_ = codeDb_.count();
         tvbCurrent_ = 0U;
         tvbRunning_ = true;
         tvbLastSendMs_ = 0U;
@@ -461,21 +669,38 @@ private:
             // All codes sent
             tvbRunning_ = false;
             IRTransceiver::instance().deinit();
+            ESP_LOGI(TAG_IR_APP, "TV-B-Gone complete (%u SD reads)",
+                     static_cast<unsigned>(codeDb_.reads()));
+            closeCodeDb();
             transitionTo(IRState::TV_BGONE_DONE);
-            ESP_LOGI(TAG_IR_APP, "TV-B-Gone complete");
             EventSystem::instance().postEvent(
                 {EventType::EVT_XP_EARNED, XP_IR_SEND, 0, nullptr});
             return;
         }
 
-        const TvBGoneEntry &e = tvbEntries_[tvbCurrent_];
-        IRTransceiver::instance().send(e.code, e.protocol, e.bits);
+        // Stream the next record straight from SD.
+        hackos::ir::IrCodeRecord rec;
+        if (!codeDb_.record(static_cast<uint32_t>(tvbCurrent_), &rec))
+        {
+            ESP_LOGE(TAG_IR_APP, "TV-B-Gone: read failed at %u",
+                     static_cast<unsigned>(tvbCurrent_));
+            tvbEntryCount_ = tvbCurrent_; // finish on the next poll
+            return;
+        }
+        if (!codeDb_.brand(rec, tvbBrand_, sizeof(tvbBrand_)))
+        {
+            tvbBrand_[0] = '\0';
+        }
+        tvbCode_ = rec.value;
+
+        const decode_type_t proto = static_cast<decode_type_t>(rec.protocol);
+        IRTransceiver::instance().send(rec.value, proto, rec.bits);
         ESP_LOGD(TAG_IR_APP, "TV-B-Gone [%u/%u] %s proto=%d 0x%llX",
                  static_cast<unsigned>(tvbCurrent_ + 1U),
                  static_cast<unsigned>(tvbEntryCount_),
-                 e.brand,
-                 static_cast<int>(e.protocol),
-                 static_cast<unsigned long long>(e.code));
+                 tvbBrand_,
+                 static_cast<int>(proto),
+                 static_cast<unsigned long long>(rec.value));
 
         tvbLastSendMs_ = now;
         ++tvbCurrent_;
@@ -498,12 +723,11 @@ private:
 
         if (tvbCurrent_ > 0U && tvbCurrent_ <= tvbEntryCount_)
         {
-            const TvBGoneEntry &e = tvbEntries_[tvbCurrent_ - 1U];
-            DisplayManager::instance().drawText(2, 36, e.brand);
+            DisplayManager::instance().drawText(2, 36, tvbBrand_);
 
             char hexBuf[20];
             std::snprintf(hexBuf, sizeof(hexBuf), "0x%08llX",
-                          static_cast<unsigned long long>(e.code));
+                          static_cast<unsigned long long>(tvbCode_));
             DisplayManager::instance().drawText(2, 48, hexBuf);
         }
 
@@ -749,6 +973,15 @@ private:
             return;
         }
 
+        uint16_t rawCount = 0U;
+        const uint16_t *raw = IRTransceiver::instance().lastRaw(&rawCount);
+        if (IRTransceiver::instance().lastProtocol() == decode_type_t::UNKNOWN &&
+            raw != nullptr)
+        {
+            performRawSave(raw, rawCount);
+            return;
+        }
+
         // Build file path: /ext/assets/ir/saved/<name>.csv
         char path[64];
         std::snprintf(path, sizeof(path), "%s/%s.csv", IR_SAVED_DIR, saveName_);
@@ -775,6 +1008,49 @@ private:
         ESP_LOGI(TAG_IR_APP, "Saved code to %s (proto=%s)", path, protoStr.c_str());
     }
 
+    /// @brief Compress an undecoded capture into /ext/assets/ir/saved/<name>.irr.
+    void performRawSave(const uint16_t *raw, uint16_t count)
+    {
+        auto *encoder = new (std::nothrow) hackos::ir::IrRawEncoder();
+        if (encoder == nullptr)
+        {
+            ESP_LOGE(TAG_IR_APP, "OOM allocating raw encoder");
+            return;
+        }
+
+        rawBlobLen_ = 0U;
+        loadedRaw_ = false;
+        constexpr uint16_t tolerance = hackos::ir::IR_RAW_TOLERANCE_US;
+        bool ok = encoder->encode(raw, count, IR_RAW_CARRIER_KHZ, tolerance,
+                                  rawBlob_, sizeof(rawBlob_), &rawBlobLen_) ||
+                  encoder->encode(raw, count, IR_RAW_CARRIER_KHZ, 2U * tolerance,
+                                  rawBlob_, sizeof(rawBlob_), &rawBlobLen_);
+        const size_t dictSize = encoder->dictSize();
+        const uint16_t maxError = encoder->maxErrorUs();
+        delete encoder;
+        if (!ok)
+        {
+            ESP_LOGE(TAG_IR_APP, "Raw capture of %u timings does not compress",
+                     static_cast<unsigned>(count));
+            return;
+        }
+
+        char path[64];
+        std::snprintf(path, sizeof(path), "%s/%s%s", IR_SAVED_DIR, saveName_, IR_RAW_EXT);
+        fs::File f = hackos::storage::VirtualFS::instance().open(path, "w");
+        if (!f)
+        {
+            ESP_LOGE(TAG_IR_APP, "Cannot open %s for writing", path);
+            return;
+        }
+        ok = (f.write(rawBlob_, rawBlobLen_) == rawBlobLen_);
+        f.close();
+        ESP_LOGI(TAG_IR_APP, "Saved raw %s: %u timings -> %u B (dict %u, max err %u us)%s",
+                 path, static_cast<unsigned>(count), static_cast<unsigned>(rawBlobLen_),
+                 static_cast<unsigned>(dictSize), static_cast<unsigned>(maxError),
+                 ok ? "" : " WRITE FAILED");
+    }
+
     // ── DB Manager: Load ────────────────────────────────────────────────
 
     void enterDbLoad()
@@ -790,11 +1066,12 @@ private:
             {
                 continue;
             }
-            // Copy name (strip .csv extension for display)
+            // Copy name (strip .csv / .irr extension for display)
             std::snprintf(dbEntryNames_[dbEntryCount_],
                           sizeof(dbEntryNames_[0]),
                           "%.19s", entries[i].name);
             char *dot = std::strrchr(dbEntryNames_[dbEntryCount_], '.');
+            dbEntryRaw_[dbEntryCount_] = (dot != nullptr && std::strcmp(dot, IR_RAW_EXT) == 0);
             if (dot != nullptr)
             {
                 *dot = '\0';
@@ -820,6 +1097,12 @@ private:
             return;
         }
 
+        if (dbEntryRaw_[index])
+        {
+            performRawLoad(index);
+            return;
+        }
+
         char path[64];
         std::snprintf(path, sizeof(path), "%s/%s.csv",
                       IR_SAVED_DIR, dbEntryNames_[index]);
@@ -877,17 +1160,80 @@ private:
         }
 
         f.close();
+        loadedRaw_ = false;
         transitionTo(IRState::DB_LOADED);
     }
 
+    void performRawLoad(size_t index)
+    {
+        char path[64];
+        std::snprintf(path, sizeof(path), "%s/%s%s",
+                      IR_SAVED_DIR, dbEntryNames_[index], IR_RAW_EXT);
+
+        fs::File f = hackos::storage::VirtualFS::instance().open(path, "r");
+        if (!f)
+        {
+            ESP_LOGE(TAG_IR_APP, "Cannot open %s for reading", path);
+            return;
+        }
+        rawBlobLen_ = f.read(rawBlob_, sizeof(rawBlob_));
+        f.close();
+
+        if (!rawDecoder_.begin(rawBlob_, rawBlobLen_))
+        {
+            ESP_LOGE(TAG_IR_APP, "%s is not a raw IR capture", path);
+            return;
+        }
+
+        loadedRaw_ = true;
+        std::snprintf(protoName_, sizeof(protoName_), "RAW %u kHz",
+                      static_cast<unsigned>(rawDecoder_.carrierKhz()));
+        std::snprintf(codeHex_, sizeof(codeHex_), "%u timings",
+                      static_cast<unsigned>(rawDecoder_.count()));
+        ESP_LOGI(TAG_IR_APP, "Loaded raw: %u timings, %u B from %s",
+                 static_cast<unsigned>(rawDecoder_.count()),
+                 static_cast<unsigned>(rawBlobLen_), path);
+        transitionTo(IRState::DB_LOADED);
+    }
+
+    /// @brief Expand the loaded raw capture and transmit it.
+    void sendLoadedRaw()
+    {
+        if (!rawDecoder_.begin(rawBlob_, rawBlobLen_))
+        {
+            return;
+        }
+        auto *timings = new (std::nothrow) uint16_t[rawDecoder_.count()];
+        if (timings == nullptr)
+        {
+            ESP_LOGE(TAG_IR_APP, "OOM expanding raw capture");
+            return;
+        }
+        const size_t count = rawDecoder_.decode(timings, rawDecoder_.count());
+        if (count > 0U)
+        {
+            IRTransceiver::instance().sendRaw(timings, static_cast<uint16_t>(count),
+                                              rawDecoder_.carrierKhz());
+        }
+        delete[] timings;
+    }
+
     void drawDbLoadedView()
     {
         DisplayManager::instance().drawText(2, 24, protoName_);
         DisplayManager::instance().drawText(2, 36, codeHex_);
 
         char bits[16];
-        std::snprintf(bits, sizeof(bits), "Bits: %u",
-                      static_cast<unsigned>(editBits_));
+        if (loadedRaw_)
+        {
+            std::snprintf(bits, sizeof(bits), "%u bytes",
+                          static_cast<unsigned>(rawBlobLen_));
+        }
+        else
+        {
+            std::snprintf(bits, sizeof(bits), "Bits: %u",
+                          static_cast<unsigned>(editBits_));
+        }
         DisplayManager::instance().drawText(2, 48, bits);
         DisplayManager::instance().drawText(2, 58, "OK:send  L:back");
     }
@@ -901,11 +1247,6 @@ private:
             ESP_LOGW(TAG_IR_APP, "saveIrCodeToSd: no code captured");
             return;
         }
-        if (!StorageManager::instance().isMounted())
-        {
-            ESP_LOGW(TAG_IR_APP, "saveIrCodeToSd: SD not mounted");
-            return;
-        }
 
         char buf[64];
         const int len = std::snprintf(buf, sizeof(buf),
@@ -916,8 +1257,8 @@ private:
 
         if (len > 0 && len < static_cast<int>(sizeof(buf)))
         {
-            const bool ok = StorageManager::instance().appendChunk(
-                "/captures/ir_codes.txt",
+            const bool ok = hackos::storage::VirtualFS::instance().append(
+                "/ext/captures/ir_codes.txt",
                 reinterpret_cast<const uint8_t *>(buf),
                 static_cast<size_t>(len));
             ESP_LOGI(TAG_IR_APP, "saveIrCodeToSd: %s", ok ? "OK" : "FAIL");
@@ -939,6 +1280,7 @@ private:
                 input == InputManager::InputEvent::LEFT)
             {
                 IRTransceiver::instance().deinit();
+                closeCodeDb();
                 transitionTo(IRState::MAIN_MENU);
                 mainMenu_.setItems(IR_MENU_LABELS, IR_MENU_COUNT);
             }
@@ -949,6 +1291,7 @@ private:
             {
                 tvbRunning_ = false;
                 IRTransceiver::instance().deinit();
+                closeCodeDb();
                 transitionTo(IRState::MAIN_MENU);
                 mainMenu_.setItems(IR_MENU_LABELS, IR_MENU_COUNT);
                 ESP_LOGI(TAG_IR_APP, "TV-B-Gone cancelled");
@@ -996,6 +1339,8 @@ private:
                 startTvBGone();
                 break;
             case 1U: // IR Sniffer
+                sniffBrand_[0] = '\0';
+                (void)openCodeDb(); // reverse lookup; sniffing works without it
                 IRTransceiver::instance().initReceive();
                 transitionTo(IRState::SNIFFER);
                 break;
@@ -1053,10 +1398,17 @@ private:
         {
             // Send the loaded code
             IRTransceiver::instance().initTransmit();
-            IRTransceiver::instance().send(editValue_, editProto_, editBits_);
+            if (loadedRaw_)
+            {
+                sendLoadedRaw();
+            }
+            else
+            {
+                IRTransceiver::instance().send(editValue_, editProto_, editBits_);
+                ESP_LOGI(TAG_IR_APP, "Sent loaded code: 0x%llX",
+                         static_cast<unsigned long long>(editValue_));
+            }
             IRTransceiver::instance().deinit();
-            ESP_LOGI(TAG_IR_APP, "Sent loaded code: 0x%llX",
-                     static_cast<unsigned long long>(editValue_));
         }
         else if (input == InputManager::InputEvent::LEFT)
         {
@@ -8,7 +8,8 @@
  *  3. Handshake Hunter  – captures WPA/WPA2 EAPOL 4-way handshake;
  *                         HackBot celebrates + vibrate on success.
  *  4. Circular buffer   – lock-free ring buffer in RAM; background IO task
- *                         flushes to SD without losing packets.
+ *                         flushes to SD without losing packets.  The ring
+ *                         is leased from the scratch arena per capture.
  *  5. Statistics view   – live packets/second display on OLED.
  */
 
@@ -25,10 +26,13 @@
 #include "core/event.h"
 #include "core/event_system.h"
 #include "core/experience_manager.h"
+#include "core/scratch.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
 #include "hardware/radio/frame_parser_80211.h"
+#include "storage/buffered_stream.h"
 #include "storage/vfs.h"
+#include "ui/view_animator.h"
 #include "ui/widgets.h"
 
 // ── Constants ────────────────────────────────────────────────────────────────
@@ -53,10 +57,18 @@ static constexpr size_t   EAPOL_FULL_HANDSHAKE = 4U;
 // IO task
 static constexpr uint32_t IO_TASK_INTERVAL_MS = 50U;
 static constexpr uint32_t IO_TASK_STACK       = 4096U;
+static constexpr uint32_t IO_EXIT_WAIT_INTERVALS = 20U;
 
 // Stats update
 static constexpr uint32_t STATS_INTERVAL_MS   = 1000U;
 
+// PCAP durability: bulk sniffing loses at most 16 KiB / 1 s of packets to a
+// power cut; every handshake frame is on the card before the next one.
+static constexpr hackos::storage::DurabilityPolicy PCAP_SNIFF_POLICY =
+    hackos::storage::DurabilityPolicy::every(16384U, 1000U);
+static constexpr hackos::storage::DurabilityPolicy PCAP_HANDSHAKE_POLICY =
+    hackos::storage::DurabilityPolicy::everyRecord();
+
 // ── PCAP packed structures ───────────────────────────────────────────────────
 
 #pragma pack(push, 1)
@@ -135,13 +147,6 @@ struct RingBuffer
     volatile size_t head; ///< next write index (producer)
     volatile size_t tail; ///< next read index  (consumer)
 
-    void reset()
-    {
-        head = 0U;
-        tail = 0U;
-        std::memset(slots, 0, sizeof(slots));
-    }
-
     /// @brief Push a packet from ISR context (producer). Returns false if full.
     bool IRAM_ATTR push(const uint8_t *pkt, size_t len, uint32_t tsMs)
     {
@@ -184,18 +189,27 @@ struct RingBuffer
     }
 };
 
+// The ring and a scene transition can be held together.
+static_assert(hackos::core::scratchFootprint<RingBuffer, hackos::ui::ViewAnimator::Scenes>() <=
+                  hackos::core::Scratch::CAPACITY,
+              "net forensics scratch budget");
+
 // ── Global shared state (accessed from ISR + IO task + app) ──────────────────
 
-static RingBuffer         g_ring;
+static constexpr const char *SCRATCH_RING = "nf_ring";
+
+static hackos::core::ScratchLease<RingBuffer> g_ringLease;
+static RingBuffer *volatile g_ring         = nullptr; ///< g_ringLease while capturing
 static volatile uint32_t  g_totalPkts      = 0U;
 static volatile uint32_t  g_droppedPkts    = 0U;
 static volatile uint32_t  g_eapolCount     = 0U;
 static volatile bool      g_captureActive  = false;
 static volatile bool      g_ioTaskRunning  = false;
+static volatile bool      g_ioTaskExited   = true;
 static PktFilter          g_pktFilter      = PktFilter::ALL;
 static bool               g_handshakeMode  = false;
 static char               g_pcapPath[64]   = {};
-static bool               g_pcapOpen       = false;
+static hackos::storage::DurableWriter g_pcapWriter;
 
 // ── PcapManager ──────────────────────────────────────────────────────────────
 //
@@ -226,8 +240,8 @@ public:
             return false;
         }
 
-        fs::File f = vfs.open(path, "w");
-        if (!f)
+        if (!g_pcapWriter.begin(path, g_handshakeMode ? PCAP_HANDSHAKE_POLICY
+                                                      : PCAP_SNIFF_POLICY))
         {
             ESP_LOGE(TAG_NF, "Failed to create PCAP: %s", path);
             return false;
@@ -243,12 +257,12 @@ public:
         hdr.snaplen      = PCAP_SNAP_LEN;
         hdr.linktype     = PCAP_LINK_80211;
 
-        f.write(reinterpret_cast<const uint8_t *>(&hdr), sizeof(hdr));
-        f.close();
+        (void)g_pcapWriter.write(reinterpret_cast<const uint8_t *>(&hdr), sizeof(hdr));
+        (void)g_pcapWriter.endRecord();
+        (void)g_pcapWriter.sync();   // a cut file is still a valid, empty PCAP
 
         std::strncpy(g_pcapPath, path, sizeof(g_pcapPath) - 1U);
         g_pcapPath[sizeof(g_pcapPath) - 1U] = '\0';
-        g_pcapOpen = true;
 
         ESP_LOGI(TAG_NF, "PCAP created: %s", g_pcapPath);
         return true;
@@ -257,14 +271,7 @@ public:
     /// @brief Append a single packet record to the open PCAP file.
     static bool writePacket(const RingSlot &slot)
     {
-        if (!g_pcapOpen || slot.len == 0U)
-        {
-            return false;
-        }
-
-        auto &vfs = hackos::storage::VirtualFS::instance();
-        fs::File f = vfs.open(g_pcapPath, "a");
-        if (!f)
+        if (!g_pcapWriter.isOpen() || slot.len == 0U)
         {
             return false;
         }
@@ -275,17 +282,26 @@ public:
         phdr.inclLen = slot.len;
         phdr.origLen = slot.origLen;
 
-        f.write(reinterpret_cast<const uint8_t *>(&phdr), sizeof(phdr));
-        f.write(slot.data, slot.len);
-        f.close();
-        return true;
+        const bool ok =
+            g_pcapWriter.write(reinterpret_cast<const uint8_t *>(&phdr), sizeof(phdr)) &&
+            g_pcapWriter.write(slot.data, slot.len);
+        return g_pcapWriter.endRecord() && ok;
+    }
+
+    /// @brief Sync on the time trigger while packets are sparse.
+    static void poll()
+    {
+        (void)g_pcapWriter.poll();
     }
 
     /// @brief Close the current PCAP file.
     static void close()
     {
-        g_pcapOpen = false;
-        ESP_LOGI(TAG_NF, "PCAP closed: %s", g_pcapPath);
+        g_pcapWriter.close();
+        const auto &st = g_pcapWriter.stats();
+        ESP_LOGI(TAG_NF, "PCAP closed: %s (%lu B, %lu syncs, max %lu B at risk)", g_pcapPath,
+                 static_cast<unsigned long>(st.bytes), static_cast<unsigned long>(st.syncs),
+                 static_cast<unsigned long>(st.maxUnsynced));
     }
 };
 
@@ -339,7 +355,7 @@ static void IRAM_ATTR nfPromiscuousRxCb(void *buf, wifi_promiscuous_pkt_type_t t
     const uint32_t tsMs = static_cast<uint32_t>(
         xTaskGetTickCount() * portTICK_PERIOD_MS);
 
-    if (!g_ring.push(payload, len, tsMs))
+    if (!g_ring->push(payload, len, tsMs))
     {
         ++g_droppedPkts;
     }
@@ -358,21 +374,23 @@ static void nfIoTask(void * /*param*/)
     while (g_ioTaskRunning)
     {
         RingSlot slot;
-        while (g_ring.pop(slot))
+        while (g_ring->pop(slot))
         {
             PcapManager::writePacket(slot);
         }
+        PcapManager::poll();
         vTaskDelay(pdMS_TO_TICKS(IO_TASK_INTERVAL_MS));
     }
 
     // Drain remaining packets before exit
     RingSlot slot;
-    while (g_ring.pop(slot))
+    while (g_ring->pop(slot))
     {
         PcapManager::writePacket(slot);
     }
 
     ESP_LOGI(TAG_NF, "IO task exiting");
+    g_ioTaskExited = true;
     vTaskDelete(nullptr);
 }
 
@@ -660,7 +678,7 @@ private:
         d.drawText(0, 42, buf, 1U);
 
         // Ring buffer usage bar
-        const size_t used = g_ring.used();
+        const size_t used = (g_ring != nullptr) ? g_ring->used() : 0U;
         const uint8_t pct = static_cast<uint8_t>(
             (used * 100U) / RING_SLOT_COUNT);
         std::snprintf(buf, sizeof(buf), "Buf: %u%%", pct);
@@ -741,7 +759,7 @@ private:
         d.drawText(0, 42, buf, 1U);
 
         std::snprintf(buf, sizeof(buf), "File: %s",
-                      g_pcapOpen ? g_pcapPath : "none");
+                      g_pcapWriter.isOpen() ? g_pcapPath : "none");
         d.drawText(0, 52, buf, 1U);
     }
 
@@ -763,13 +781,21 @@ private:
         pps_          = 0U;
         lastStatsMs_  = 0U;
         handshakeCelebrated_ = false;
-        g_ring.reset();
+
+        // A fresh lease is a zeroed ring.
+        if (!g_ringLease.acquire(SCRATCH_RING))
+        {
+            ESP_LOGE(TAG_NF, "No scratch memory for the capture ring");
+            return;
+        }
+        g_ring = g_ringLease.get();
 
         // Create PCAP file
         const char *prefix = g_handshakeMode ? "hs" : "cap";
         if (!PcapManager::create("/ext/pcap", prefix))
         {
             ESP_LOGE(TAG_NF, "Cannot create PCAP file");
+            releaseRing();
             return;
         }
 
@@ -802,11 +828,13 @@ private:
         {
             ESP_LOGE(TAG_NF, "Failed to enable promiscuous mode");
             PcapManager::close();
+            releaseRing();
             return;
         }
 
         // Start IO flush task on core 0
         g_ioTaskRunning = true;
+        g_ioTaskExited  = false;
         g_captureActive = true;
 
         xTaskCreatePinnedToCore(
@@ -842,12 +870,24 @@ private:
         g_ioTaskRunning = false;
         if (ioTaskHandle_ != nullptr)
         {
-            // Give IO task time to drain and exit
-            vTaskDelay(pdMS_TO_TICKS(IO_TASK_INTERVAL_MS * 3U));
+            // Give IO task time to drain and exit; the ring goes back to
+            // the scratch arena only once it has.
+            for (uint32_t i = 0U; i < IO_EXIT_WAIT_INTERVALS && !g_ioTaskExited; ++i)
+            {
+                vTaskDelay(pdMS_TO_TICKS(IO_TASK_INTERVAL_MS));
+            }
             ioTaskHandle_ = nullptr;
         }
 
         PcapManager::close();
+        if (g_ioTaskExited)
+        {
+            releaseRing();
+        }
+        else
+        {
+            ESP_LOGW(TAG_NF, "IO task still running – keeping the capture ring");
+        }
         ESP_LOGI(TAG_NF, "Capture stopped – %lu packets, %lu dropped",
                  static_cast<unsigned long>(g_totalPkts),
                  static_cast<unsigned long>(g_droppedPkts));
@@ -855,6 +895,12 @@ private:
 
     // ── Helpers ──────────────────────────────────────────────────────────
 
+    static void releaseRing()
+    {
+        g_ring = nullptr;
+        g_ringLease.release();
+    }
+
     void updateStats()
     {
         const uint32_t nowMs = static_cast<uint32_t>(millis());
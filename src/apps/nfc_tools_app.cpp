@@ -6,7 +6,14 @@
  * Features:
  *  - **UID Cloner**: Read UID (4/7 bytes), save, write to Magic Gen1/Gen2.
  *  - **Sector Dumper**: Multi-key Mifare Classic 1K dump with block matrix.
- *  - **Hex Viewer**: Scrollable hex display of dump data on OLED.
+ *    Keys come from the SD dictionary in hit-count order, and the keys
+ *    that opened each sector are cached per UID, so re-dumping one of our
+ *    own cards authenticates every sector on the first try.
+ *  - **Hex Viewer**: Scrollable hex display of dump data on OLED.  Pages
+ *    through RAM dumps and SD files of any size with a fixed row window.
+ *  - **Dump Files**: Save dumps as raw .bin plus Flipper .nfc, diff a new
+ *    dump against the saved one for the same UID (changed blocks, value
+ *    block deltas) and browse saved .bin / .nfc files.
  *  - **NFC Emulator**: NTAG213 URL tag emulation (Rickroll, custom URLs).
  */
 
@@ -21,8 +28,11 @@
 #include "core/event_system.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
+#include "hardware/nfc/nfc_dump.h"
 #include "hardware/nfc_reader.h"
 #include "hardware/storage.h"
+#include "storage/buffered_stream.h"
+#include "storage/vfs.h"
 #include "ui/widgets.h"
 
 static constexpr const char *TAG_NFC_APP = "NFCToolsApp";
@@ -43,15 +53,17 @@ enum class NFCState : uint8_t
     HEX_VIEWER,
     EMULATOR_MENU,
     EMULATING,
+    FILE_BROWSER,
 };
 
 // ── Menu labels ─────────────────────────────────────────────────────────────
 
-static constexpr size_t NFC_MENU_COUNT = 5U;
+static constexpr size_t NFC_MENU_COUNT = 6U;
 static const char *const NFC_MENU_LABELS[NFC_MENU_COUNT] = {
     "UID Cloner",
     "Sector Dump",
     "NFC Emulator",
+    "Dump Files",
     "Save UID",
     "Back",
 };
@@ -88,6 +100,73 @@ static const uint8_t EMULATOR_PREFIXES[] = {
 static constexpr size_t DUMP_BUF_SIZE =
     static_cast<size_t>(NFCReader::MIFARE_1K_BLOCKS) * NFCReader::BYTES_PER_BLOCK;
 
+// ── Dump files ──────────────────────────────────────────────────────────────
+static constexpr const char *DUMP_DIR_VFS = "/ext/nfc";
+static constexpr const char *DUMP_DIR_SD = "/nfc"; ///< StorageManager (raw SD) path
+static constexpr const char *NFC_VIEW_TMP = "/ext/nfc/.view.bin";
+static constexpr size_t MAX_DUMP_FILES = 12U;
+static constexpr size_t FILE_LABEL_LEN = 24U;
+static constexpr size_t DUMP_PATH_LEN = 96U;
+static constexpr size_t IO_CHUNK = 128U;
+
+/// @brief NfcByteSink that appends to a BufferedWriter.
+class WriterSink final : public hackos::nfc::NfcByteSink
+{
+public:
+    explicit WriterSink(hackos::storage::BufferedWriter &writer) : writer_(writer) {}
+
+    bool write(const uint8_t *data, size_t len) override
+    {
+        return writer_.write(data, len);
+    }
+
+private:
+    hackos::storage::BufferedWriter &writer_;
+};
+
+/// @brief NfcPageSource over an open VirtualFS file (seek + read).
+class FilePageSource final : public hackos::nfc::NfcPageSource
+{
+public:
+    FilePageSource() : size_(0U) {}
+
+    bool open(const char *path)
+    {
+        close();
+        file_ = hackos::storage::VirtualFS::instance().open(path, "r");
+        if (!file_)
+        {
+            return false;
+        }
+        size_ = static_cast<uint32_t>(file_.size());
+        return true;
+    }
+
+    void close()
+    {
+        if (file_)
+        {
+            file_.close();
+        }
+        size_ = 0U;
+    }
+
+    uint32_t size() const override { return size_; }
+
+    size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        if (!file_ || !file_.seek(offset))
+        {
+            return 0U;
+        }
+        return file_.read(buf, len);
+    }
+
+private:
+    fs::File file_;
+    uint32_t size_;
+};
+
 class NFCToolsApp final : public AppBase, public IEventObserver
 {
 public:
@@ -106,6 +185,17 @@ public:
           blockStatus_{},
           dumpBuf_{},
           hexViewOffset_(0U),
+          dumpRows_(NFCReader::MIFARE_1K_BLOCKS),
+          ntagPages_(0U),
+          ntagDump_(false),
+          authTries_(0U),
+          cachedSectors_(0U),
+          memSource_(dumpBuf_, 0U),
+          viewingFile_(false),
+          diffValid_(false),
+          fileCount_(0U),
+          fileLabels_{},
+          filePtrs_{},
           statusLine_{}
     {
     }
@@ -192,6 +282,10 @@ public:
             drawTitle("Emulating");
             drawStatus();
             break;
+        case NFCState::FILE_BROWSER:
+            drawTitle("Dump Files");
+            subMenu_.draw();
+            break;
         }
 
         DisplayManager::instance().present();
@@ -213,6 +307,8 @@ public:
 
     void onDestroy() override
     {
+        pager_.attach(nullptr);
+        fileSource_.close();
         NFCReader::instance().deinit();
         EventSystem::instance().unsubscribe(this);
         ESP_LOGI(TAG_NFC_APP, "destroyed");
@@ -237,8 +333,31 @@ private:
     uint8_t blockStatus_[NFCReader::MIFARE_1K_BLOCKS / 8U + 1U];
     /// Sector dump data buffer.
     uint8_t dumpBuf_[DUMP_BUF_SIZE];
-    /// Hex viewer scroll offset (in blocks).
-    uint8_t hexViewOffset_;
+    /// Hex viewer scroll offset (in rows).
+    uint32_t hexViewOffset_;
+    /// 16-byte rows held in dumpBuf_ (64 for Mifare 1K, pages/4 for NTAG).
+    uint8_t dumpRows_;
+    /// Pages the NTAG reports (dumpRows_ rounds up to whole rows).
+    uint8_t ntagPages_;
+    /// dumpBuf_ holds NTAG pages rather than Mifare blocks.
+    bool ntagDump_;
+    /// Mifare auth commands sent during the dump (1 per sector is ideal).
+    uint16_t authTries_;
+    /// Sectors of this card found in the UID key cache at dump start.
+    uint8_t cachedSectors_;
+    /// Hex viewer: constant-size row window over memSource_ or fileSource_.
+    hackos::nfc::NfcHexPager pager_;
+    hackos::nfc::NfcMemorySource memSource_;
+    FilePageSource fileSource_;
+    bool viewingFile_;
+    /// Last dump compared with the saved dump of the same UID.
+    hackos::nfc::NfcDumpDiff diff_;
+    bool diffValid_;
+    /// Dump Files browser.
+    StorageManager::DirEntry fileEntries_[MAX_DUMP_FILES];
+    size_t fileCount_;
+    char fileLabels_[MAX_DUMP_FILES][FILE_LABEL_LEN];
+    const char *filePtrs_[MAX_DUMP_FILES];
     char statusLine_[STATUS_LEN];
 
     // ── Helpers ─────────────────────────────────────────────────────────────
@@ -393,47 +512,57 @@ private:
                       static_cast<unsigned>(dumpSuccess_),
                       static_cast<unsigned>(dumpFail_));
         DisplayManager::instance().drawText(2, 22, line);
-        DisplayManager::instance().drawText(2, 32, "UP/DN:Hex  OK:Exit");
+        DisplayManager::instance().drawText(2, 32, "U/D:Hex R:Save OK:Ex");
+        DisplayManager::instance().drawText(2, 54, statusLine_);
     }
 
-    /// Scrollable hex viewer: shows 3 rows of hex data at a time.
+    /// Scrollable hex viewer: shows 3 rows of hex data at a time.  Rows
+    /// come from pager_, so SD files of any size use the same small window.
     void drawHexViewer()
     {
-        static constexpr uint8_t VISIBLE_ROWS = 3U;
-        const uint8_t maxOffset = (NFCReader::MIFARE_1K_BLOCKS > VISIBLE_ROWS)
-                                      ? (NFCReader::MIFARE_1K_BLOCKS - VISIBLE_ROWS)
-                                      : 0U;
+        static constexpr uint32_t VISIBLE_ROWS = 3U;
+        const uint32_t rows = pager_.rowCount();
+        const uint32_t maxOffset = (rows > VISIBLE_ROWS) ? (rows - VISIBLE_ROWS) : 0U;
         if (hexViewOffset_ > maxOffset)
         {
             hexViewOffset_ = maxOffset;
         }
 
-        for (uint8_t r = 0U; r < VISIBLE_ROWS; ++r)
+        for (uint32_t r = 0U; r < VISIBLE_ROWS; ++r)
         {
-            const uint8_t block = hexViewOffset_ + r;
-            if (block >= NFCReader::MIFARE_1K_BLOCKS)
+            const uint32_t row = hexViewOffset_ + r;
+            if (row >= rows)
             {
                 break;
             }
 
-            const size_t offset = static_cast<size_t>(block) * NFCReader::BYTES_PER_BLOCK;
-
-            // Line format: "BB:XXXXXXXXXXXXXXXX" (block# + first 8 hex bytes)
+            // Line format: "BB:XXXXXXXXXXXXXXXX" (row# + first 8 hex bytes);
+            // NTAG rows are labelled with their first page number instead,
+            // and '*' replaces ':' on rows that changed since the last save.
             char line[28];
-            if (getBlockStatus(block))
+            const bool live = !viewingFile_;
+            const unsigned label = (live && ntagDump_)
+                                       ? static_cast<unsigned>(row) * NFCReader::NTAG_READ_PAGES
+                                       : static_cast<unsigned>(row);
+            const char sep = (live && rowChanged(row)) ? '*' : ':';
+            size_t len = 0U;
+            const uint8_t *d = pager_.row(row, &len);
+
+            if (live && !getBlockStatus(static_cast<uint8_t>(row)))
             {
-                std::snprintf(line, sizeof(line),
-                              "%02X:%02X%02X%02X%02X%02X%02X%02X%02X",
-                              static_cast<unsigned>(block),
-                              dumpBuf_[offset + 0U], dumpBuf_[offset + 1U],
-                              dumpBuf_[offset + 2U], dumpBuf_[offset + 3U],
-                              dumpBuf_[offset + 4U], dumpBuf_[offset + 5U],
-                              dumpBuf_[offset + 6U], dumpBuf_[offset + 7U]);
+                std::snprintf(line, sizeof(line), "%02X%c-- auth fail --", label, sep);
+            }
+            else if (d == nullptr)
+            {
+                std::snprintf(line, sizeof(line), "%02X%c-- read error --", label, sep);
             }
             else
             {
-                std::snprintf(line, sizeof(line), "%02X:-- auth fail --",
-                              static_cast<unsigned>(block));
+                int pos = std::snprintf(line, sizeof(line), "%02X%c", label, sep);
+                for (size_t i = 0U; i < len && i < 8U; ++i)
+                {
+                    pos += std::snprintf(line + pos, sizeof(line) - pos, "%02X", d[i]);
+                }
             }
 
             const int16_t y = static_cast<int16_t>(22 + r * 12);
@@ -441,14 +570,35 @@ private:
         }
 
         // Scroll indicator
-        char indicator[16];
-        std::snprintf(indicator, sizeof(indicator), "Blk %u-%u/%u",
-                      static_cast<unsigned>(hexViewOffset_),
-                      static_cast<unsigned>(hexViewOffset_ + VISIBLE_ROWS - 1U),
-                      static_cast<unsigned>(NFCReader::MIFARE_1K_BLOCKS - 1U));
+        char indicator[24];
+        std::snprintf(indicator, sizeof(indicator), "Row %lu-%lu/%lu",
+                      static_cast<unsigned long>(hexViewOffset_),
+                      static_cast<unsigned long>(hexViewOffset_ + VISIBLE_ROWS - 1U),
+                      static_cast<unsigned long>(rows > 0U ? rows - 1U : 0U));
         DisplayManager::instance().drawText(2, 58, indicator);
     }
 
+    /// True if hex row @p row of the live dump differs from the saved dump.
+    bool rowChanged(uint32_t row) const
+    {
+        if (!diffValid_)
+        {
+            return false;
+        }
+        if (!ntagDump_)
+        {
+            return diff_.isChanged(static_cast<uint16_t>(row));
+        }
+        for (uint32_t p = 0U; p < NFCReader::NTAG_READ_PAGES; ++p)
+        {
+            if (diff_.isChanged(static_cast<uint16_t>(row * NFCReader::NTAG_READ_PAGES + p)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // ── NFC operations ──────────────────────────────────────────────────────
 
     void pollUID()
@@ -468,16 +618,30 @@ private:
     {
         if (dumpSector_ >= NFCReader::MIFARE_1K_SECTORS)
         {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Auth %u tries %u cached",
+                          static_cast<unsigned>(authTries_),
+                          static_cast<unsigned>(cachedSectors_));
+            (void)NFCReader::instance().saveKeyStore();
             transitionTo(NFCState::DUMP_DONE);
             EventSystem::instance().postEvent(
                 {EventType::EVT_XP_EARNED, XP_NFC_READ, 0, nullptr});
             return;
         }
 
+        // 7-byte UIDs are usually NTAG21x: bulk-read the whole tag at once.
+        if (dumpSector_ == 0U && uidLen_ == 7U && stepNtagDump())
+        {
+            return;
+        }
+
         const uint8_t firstBlock = static_cast<uint8_t>(dumpSector_ * NFCReader::BLOCKS_PER_SECTOR);
 
-        // Try multiple default keys for authentication
-        if (NFCReader::instance().authenticateBlockWithKeys(uid_, uidLen_, firstBlock))
+        // Cached key → previous sector's key → dictionary by hit count
+        const bool authOk =
+            NFCReader::instance().authenticateBlockWithKeys(uid_, uidLen_, firstBlock);
+        authTries_ = static_cast<uint16_t>(
+            authTries_ + NFCReader::instance().lastMifareAuth().attempts);
+        if (authOk)
         {
             bool sectorOk = true;
             for (uint8_t b = 0U; b < NFCReader::BLOCKS_PER_SECTOR; ++b)
@@ -532,6 +696,49 @@ private:
         needsRedraw_ = true;
     }
 
+    /// @brief Dump an NTAG21x with FAST_READ bursts.
+    /// @return false if the tag is not an NTAG21x (fall back to Mifare).
+    bool stepNtagDump()
+    {
+        auto &nfc = NFCReader::instance();
+        const uint8_t pages = nfc.ntagPageCount();
+        if (pages == 0U ||
+            static_cast<size_t>(pages) * NFCReader::NTAG_PAGE_SIZE > DUMP_BUF_SIZE)
+        {
+            return false;
+        }
+
+        const bool ok = nfc.readNtagPages(0U, pages, dumpBuf_);
+        const NtagOpStats &st = nfc.lastNtagRead();
+
+        ntagDump_ = true;
+        ntagPages_ = pages;
+        dumpRows_ = static_cast<uint8_t>(
+            (pages + NFCReader::NTAG_READ_PAGES - 1U) / NFCReader::NTAG_READ_PAGES);
+        for (uint8_t r = 0U; r < dumpRows_; ++r)
+        {
+            setBlockStatus(r, ok);
+        }
+        dumpSuccess_ = ok ? dumpRows_ : 0U;
+        dumpFail_ = ok ? 0U : dumpRows_;
+        // Block matrix: cover exactly the rows read.
+        dumpSector_ = static_cast<uint8_t>(
+            (dumpRows_ + NFCReader::BLOCKS_PER_SECTOR - 1U) / NFCReader::BLOCKS_PER_SECTOR);
+
+        std::snprintf(statusLine_, sizeof(statusLine_), "NTAG %up %ux %lums",
+                      static_cast<unsigned>(pages),
+                      static_cast<unsigned>(st.exchanges),
+                      static_cast<unsigned long>(st.elapsedUs / 1000U));
+        progressBar_.setProgress(100U);
+        transitionTo(NFCState::DUMP_DONE);
+        if (ok)
+        {
+            EventSystem::instance().postEvent(
+                {EventType::EVT_XP_EARNED, XP_NFC_READ, 0, nullptr});
+        }
+        return true;
+    }
+
     void startWriteUid()
     {
         if (uidLen_ == 0U)
@@ -627,6 +834,9 @@ private:
                 subMenu_.setItems(EMULATOR_MENU_LABELS, EMULATOR_MENU_COUNT);
             }
             break;
+        case NFCState::FILE_BROWSER:
+            handleFileBrowser(input);
+            break;
         }
     }
 
@@ -660,7 +870,11 @@ private:
                 subMenu_.setItems(EMULATOR_MENU_LABELS, EMULATOR_MENU_COUNT);
                 transitionTo(NFCState::EMULATOR_MENU);
             }
-            else if (sel == 3U) // Save UID
+            else if (sel == 3U) // Dump Files
+            {
+                openFileBrowser();
+            }
+            else if (sel == 4U) // Save UID
             {
                 saveUidToSd();
             }
@@ -746,9 +960,18 @@ private:
         if (input == InputManager::InputEvent::UP ||
             input == InputManager::InputEvent::DOWN)
         {
+            memSource_ = hackos::nfc::NfcMemorySource(dumpBuf_,
+                                                      static_cast<uint32_t>(dumpLength()));
+            pager_.attach(&memSource_);
+            viewingFile_ = false;
             hexViewOffset_ = 0U;
             transitionTo(NFCState::HEX_VIEWER);
         }
+        else if (input == InputManager::InputEvent::RIGHT)
+        {
+            saveDump();
+            needsRedraw_ = true;
+        }
         else if (input == InputManager::InputEvent::BUTTON_PRESS ||
                  input == InputManager::InputEvent::LEFT)
         {
@@ -769,9 +992,8 @@ private:
         }
         else if (input == InputManager::InputEvent::DOWN)
         {
-            const uint8_t maxScroll = (NFCReader::MIFARE_1K_BLOCKS > 3U)
-                                         ? static_cast<uint8_t>(NFCReader::MIFARE_1K_BLOCKS - 3U)
-                                         : 0U;
+            const uint32_t rows = pager_.rowCount();
+            const uint32_t maxScroll = (rows > 3U) ? (rows - 3U) : 0U;
             if (hexViewOffset_ < maxScroll)
             {
                 ++hexViewOffset_;
@@ -781,7 +1003,39 @@ private:
         else if (input == InputManager::InputEvent::BUTTON_PRESS ||
                  input == InputManager::InputEvent::LEFT)
         {
-            transitionTo(NFCState::DUMP_DONE);
+            pager_.attach(nullptr);
+            if (viewingFile_)
+            {
+                fileSource_.close();
+                subMenu_.setItems(filePtrs_, fileCount_);
+                transitionTo(NFCState::FILE_BROWSER);
+            }
+            else
+            {
+                transitionTo(NFCState::DUMP_DONE);
+            }
+        }
+    }
+
+    void handleFileBrowser(InputManager::InputEvent input)
+    {
+        if (input == InputManager::InputEvent::UP)
+        {
+            subMenu_.moveSelection(-1);
+        }
+        else if (input == InputManager::InputEvent::DOWN)
+        {
+            subMenu_.moveSelection(1);
+        }
+        else if (input == InputManager::InputEvent::BUTTON_PRESS ||
+                 input == InputManager::InputEvent::RIGHT)
+        {
+            openDumpFile(subMenu_.selectedIndex());
+        }
+        else if (input == InputManager::InputEvent::LEFT)
+        {
+            transitionTo(NFCState::MAIN_MENU);
+            mainMenu_.setItems(NFC_MENU_LABELS, NFC_MENU_COUNT);
         }
     }
 
@@ -803,6 +1057,12 @@ private:
             dumpSector_ = 0U;
             dumpSuccess_ = 0U;
             dumpFail_ = 0U;
+            dumpRows_ = NFCReader::MIFARE_1K_BLOCKS;
+            ntagPages_ = 0U;
+            ntagDump_ = false;
+            authTries_ = 0U;
+            (void)NFCReader::instance().loadKeyStore();
+            cachedSectors_ = NFCReader::instance().uidCache().knownSectors(uid_, uidLen_);
             std::memset(blockStatus_, 0, sizeof(blockStatus_));
             std::memset(dumpBuf_, 0, sizeof(dumpBuf_));
             progressBar_.setProgress(0U);
@@ -823,11 +1083,6 @@ private:
             ESP_LOGW(TAG_NFC_APP, "saveUidToSd: no UID");
             return;
         }
-        if (!StorageManager::instance().isMounted())
-        {
-            ESP_LOGW(TAG_NFC_APP, "saveUidToSd: SD not mounted");
-            return;
-        }
 
         char hexUID[22] = {};
         formatUid(uid_, uidLen_, hexUID, sizeof(hexUID));
@@ -836,13 +1091,251 @@ private:
         const int len = std::snprintf(line, sizeof(line), "UID: %s\n", hexUID);
         if (len > 0 && len < static_cast<int>(sizeof(line)))
         {
-            const bool ok = StorageManager::instance().appendChunk(
-                "/captures/nfc_uid.txt",
+            const bool ok = hackos::storage::VirtualFS::instance().append(
+                "/ext/captures/nfc_uid.txt",
                 reinterpret_cast<const uint8_t *>(line),
                 static_cast<size_t>(len));
             ESP_LOGI(TAG_NFC_APP, "saveUidToSd: %s", ok ? "OK" : "FAIL");
         }
     }
+
+    // ── Dump files ──────────────────────────────────────────────────────────
+
+    /// "/ext/nfc/mf_0A1B2C3D.<ext>" (ntag_… for NTAG dumps).
+    void dumpPath(const char *ext, char *out, size_t outLen) const
+    {
+        char hex[15] = {};
+        for (uint8_t i = 0U; i < uidLen_ && i < UID_BUF_LEN; ++i)
+        {
+            std::snprintf(hex + i * 2U, 3U, "%02X", static_cast<unsigned>(uid_[i]));
+        }
+        std::snprintf(out, outLen, "%s/%s_%s.%s", DUMP_DIR_VFS,
+                      ntagDump_ ? "ntag" : "mf", hex, ext);
+    }
+
+    /// @brief Bytes of card memory in dumpBuf_ (no padding past the last NTAG page).
+    size_t dumpLength() const
+    {
+        return ntagDump_ ? static_cast<size_t>(ntagPages_) * NFCReader::NTAG_PAGE_SIZE
+                         : static_cast<size_t>(dumpRows_) * NFCReader::BYTES_PER_BLOCK;
+    }
+
+    /// @brief Save the dump as .bin + .nfc, diffing against the old .bin first.
+    void saveDump()
+    {
+        if (uidLen_ == 0U || dumpSuccess_ == 0U)
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Nothing to save");
+            return;
+        }
+
+        const size_t dumpLen = dumpLength();
+        const hackos::nfc::NfcDumpKind kind = ntagDump_
+                                                  ? hackos::nfc::NfcDumpKind::NTAG
+                                                  : hackos::nfc::NfcDumpKind::MIFARE_CLASSIC_1K;
+        char path[DUMP_PATH_LEN];
+        uint8_t chunk[IO_CHUNK];
+
+        // 1. Compare the live dump with the previous save of this card.
+        dumpPath("bin", path, sizeof(path));
+        diffValid_ = false;
+        hackos::storage::BufferedReader reader;
+        if (reader.begin(path))
+        {
+            diff_.begin(kind);
+            size_t offset = 0U;
+            while (!reader.isFinished() && offset < dumpLen)
+            {
+                const size_t want = (dumpLen - offset < sizeof(chunk)) ? (dumpLen - offset)
+                                                                       : sizeof(chunk);
+                const size_t n = reader.readChunk(chunk, want);
+                if (n == 0U)
+                {
+                    break;
+                }
+                diff_.feed(chunk, dumpBuf_ + offset, n);
+                offset += n;
+            }
+            reader.close();
+            diffValid_ = true;
+        }
+
+        // 2. Raw .bin – the card memory as-is.
+        hackos::storage::BufferedWriter writer;
+        bool ok = writer.begin(path) && writer.write(dumpBuf_, dumpLen) && writer.flush();
+        writer.close();
+
+        // 3. Flipper .nfc – unread Mifare blocks are written as "??".
+        dumpPath("nfc", path, sizeof(path));
+        if (ok && writer.begin(path))
+        {
+            hackos::nfc::NfcDumpInfo info = {};
+            info.kind = kind;
+            std::memcpy(info.uid, uid_, uidLen_);
+            info.uidLen = uidLen_;
+            if (ntagDump_)
+            {
+                info.atqa[1] = 0x44U;
+                info.units = ntagPages_;
+            }
+            else
+            {
+                info.atqa[1] = 0x04U;
+                info.sak = 0x08U;
+                info.units = NFCReader::MIFARE_1K_BLOCKS;
+            }
+
+            WriterSink sink(writer);
+            hackos::nfc::NfcBinToFlipper enc(sink);
+            ok = enc.begin(info);
+            if (ntagDump_)
+            {
+                ok = ok && enc.feed(dumpBuf_, dumpLen);
+            }
+            for (uint8_t b = 0U; ok && !ntagDump_ && b < dumpRows_; ++b)
+            {
+                const uint8_t *src = dumpBuf_ + static_cast<size_t>(b) * NFCReader::BYTES_PER_BLOCK;
+                ok = getBlockStatus(b) ? enc.feed(src, NFCReader::BYTES_PER_BLOCK)
+                                       : enc.feedUnknown();
+            }
+            ok = enc.finish() && ok && writer.flush();
+            writer.close();
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Save failed");
+        }
+        else if (!diffValid_)
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Saved (new card)");
+        }
+        else
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "Diff %u blk %u val",
+                          static_cast<unsigned>(diff_.changedUnits()),
+                          static_cast<unsigned>(diff_.valueDeltas()));
+            for (size_t i = 0U; i < diff_.deltaCount(); ++i)
+            {
+                const hackos::nfc::NfcBlockDelta &d = diff_.delta(i);
+                if (d.value)
+                {
+                    ESP_LOGI(TAG_NFC_APP, "value block %u: %ld -> %ld",
+                             static_cast<unsigned>(d.unit),
+                             static_cast<long>(d.before), static_cast<long>(d.after));
+                }
+            }
+        }
+        ESP_LOGI(TAG_NFC_APP, "saveDump: %s", statusLine_);
+    }
+
+    void openFileBrowser()
+    {
+        if (!StorageManager::instance().isMounted())
+        {
+            std::snprintf(statusLine_, sizeof(statusLine_), "SD not mounted");
+            needsRedraw_ = true;
+            return;
+        }
+
+        StorageManager::DirEntry all[MAX_DUMP_FILES];
+        const size_t n = StorageManager::instance().listDir(DUMP_DIR_SD, all, MAX_DUMP_FILES);
+        fileCount_ = 0U;
+        for (size_t i = 0U; i < n; ++i)
+        {
+            const char *dot = std::strrchr(all[i].name, '.');
+            if (all[i].isDir || all[i].name[0] == '.' || dot == nullptr ||
+                (std::strcmp(dot, ".bin") != 0 && std::strcmp(dot, ".nfc") != 0))
+            {
+                continue;
+            }
+            fileEntries_[fileCount_] = all[i];
+            std::snprintf(fileLabels_[fileCount_], FILE_LABEL_LEN, "%.17s %luB",
+                          all[i].name, static_cast<unsigned long>(all[i].size));
+            filePtrs_[fileCount_] = fileLabels_[fileCount_];
+            ++fileCount_;
+        }
+        if (fileCount_ == 0U)
+        {
+            std::snprintf(fileLabels_[0], FILE_LABEL_LEN, "(no dumps)");
+            filePtrs_[0] = fileLabels_[0];
+        }
+
+        subMenu_.setItems(filePtrs_, fileCount_ > 0U ? fileCount_ : 1U);
+        transitionTo(NFCState::FILE_BROWSER);
+    }
+
+    /// @brief Page through a saved dump; .nfc files are converted first.
+    void openDumpFile(size_t idx)
+    {
+        if (idx >= fileCount_)
+        {
+            return;
+        }
+
+        char path[DUMP_PATH_LEN];
+        std::snprintf(path, sizeof(path), "%s/%s", DUMP_DIR_VFS, fileEntries_[idx].name);
+
+        const char *dot = std::strrchr(path, '.');
+        if (dot != nullptr && std::strcmp(dot, ".nfc") == 0)
+        {
+            if (!convertNfcToBin(path, NFC_VIEW_TMP))
+            {
+                std::snprintf(statusLine_, sizeof(statusLine_), "Bad .nfc file");
+                needsRedraw_ = true;
+                return;
+            }
+            std::snprintf(path, sizeof(path), "%s", NFC_VIEW_TMP);
+        }
+
+        if (!fileSource_.open(path))
+        {
+            ESP_LOGW(TAG_NFC_APP, "Cannot open %s", path);
+            return;
+        }
+        pager_.attach(&fileSource_);
+        viewingFile_ = true;
+        hexViewOffset_ = 0U;
+        transitionTo(NFCState::HEX_VIEWER);
+    }
+
+    /// @brief Stream a Flipper .nfc file into a raw .bin file.
+    static bool convertNfcToBin(const char *nfcPath, const char *binPath)
+    {
+        hackos::storage::BufferedReader reader;
+        hackos::storage::BufferedWriter writer;
+        if (!reader.begin(nfcPath) || !writer.begin(binPath))
+        {
+            return false;
+        }
+
+        WriterSink sink(writer);
+        hackos::nfc::NfcFlipperToBin dec(sink);
+        dec.begin();
+        uint8_t chunk[IO_CHUNK];
+        bool ok = true;
+        while (ok && !reader.isFinished())
+        {
+            const size_t n = reader.readChunk(chunk, sizeof(chunk));
+            if (n == 0U)
+            {
+                break;
+            }
+            ok = dec.feed(reinterpret_cast<const char *>(chunk), n);
+        }
+        ok = dec.finish() && ok && writer.flush();
+        reader.close();
+        writer.close();
+
+        ESP_LOGI(TAG_NFC_APP, "nfc->bin: %u units (%u unknown)",
+                 static_cast<unsigned>(dec.unitsWritten()),
+                 static_cast<unsigned>(dec.unknownUnits()));
+        return ok && dec.sawHeader();
+    }
 };
 
 } // namespace
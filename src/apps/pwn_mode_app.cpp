@@ -36,6 +36,7 @@
 #include "hardware/input.h"
 #include "hardware/radio/frame_parser_80211.h"
 #include "hardware/wireless.h"
+#include "storage/buffered_stream.h"
 #include "storage/vfs.h"
 #include "ui/widgets.h"
 
@@ -52,6 +53,7 @@ static constexpr uint8_t DEAUTH_BURST_SIZE    = 5U;
 static constexpr uint8_t CHANNEL_HOP_MAX      = 13U;
 static constexpr uint16_t DEAUTH_REASON       = 7U;    ///< Class-3 from non-associated station
 static constexpr size_t  PCAP_SNAP_LEN        = 256U;
+static constexpr size_t  PCAP_BUFFER_SIZE     = 512U;  ///< One EAPOL frame + header
 static constexpr uint32_t CAPTURE_TASK_STACK   = 4096U;
 static constexpr uint8_t  CAPTURE_TASK_PRIO    = 1U;
 static constexpr uint32_t CAPTURE_LOOP_MS      = 500U;
@@ -708,8 +710,9 @@ private:
             }
         }
 
-        fs::File f = vfs.open(path, "w");
-        if (!f)
+        // Handshakes are rare and hard to repeat: each one is synced.
+        if (!pcap_.begin(path, hackos::storage::DurabilityPolicy::everyRecord(), false,
+                         PCAP_BUFFER_SIZE))
         {
             ESP_LOGE(TAG_PWN, "Failed to create PCAP: %s", path);
             return;
@@ -725,8 +728,8 @@ private:
         hdr.snaplen      = PCAP_SNAP_LEN;
         hdr.linktype     = PCAP_LINK_80211;
 
-        f.write(reinterpret_cast<const uint8_t *>(&hdr), sizeof(hdr));
-        f.close();
+        (void)pcap_.write(reinterpret_cast<const uint8_t *>(&hdr), sizeof(hdr));
+        (void)pcap_.endRecord();
 
         pcapOpen_ = true;
         std::strncpy(pcapPath_, path, sizeof(pcapPath_) - 1U);
@@ -741,13 +744,6 @@ private:
             return;
         }
 
-        auto &vfs = hackos::storage::VirtualFS::instance();
-        fs::File f = vfs.open(pcapPath_, "a");
-        if (!f)
-        {
-            return;
-        }
-
         const uint32_t nowMs = static_cast<uint32_t>(
             xTaskGetTickCount() * portTICK_PERIOD_MS);
         const size_t captureLen = (len > PCAP_SNAP_LEN) ? PCAP_SNAP_LEN : len;
@@ -758,18 +754,20 @@ private:
         phdr.inclLen = static_cast<uint32_t>(captureLen);
         phdr.origLen = static_cast<uint32_t>(len);
 
-        f.write(reinterpret_cast<const uint8_t *>(&phdr), sizeof(phdr));
-        f.write(data, captureLen);
-        f.close();
+        (void)pcap_.write(reinterpret_cast<const uint8_t *>(&phdr), sizeof(phdr));
+        (void)pcap_.write(data, captureLen);
+        (void)pcap_.endRecord();
     }
 
     void closePcap()
     {
+        pcap_.close();
         pcapOpen_ = false;
         ESP_LOGI(TAG_PWN, "PCAP closed");
     }
 
     char pcapPath_[64] = {};
+    hackos::storage::DurableWriter pcap_;
 };
 
 // ── Promiscuous RX callback (runs in WiFi task context) ─────────────────────
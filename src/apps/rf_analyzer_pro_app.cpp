@@ -16,6 +16,10 @@
  *  - Time Scaling (Zoom): UP / DOWN changes the inter-sample delay so the
  *    user can inspect short pulses (zoom in) or long patterns (zoom out).
  *  - Pause / Resume: CENTER button freezes the display for closer study.
+ *  - Session recording: RIGHT records the rows to
+ *    /ext/captures/waterfall/rfa_NNN.wfl; RIGHT while paused plays the
+ *    newest recording back (UP/DOWN scrub, RIGHT time zoom, CENTER
+ *    max/mean, LEFT live).
  */
 
 #include "apps/rf_analyzer_pro_app.h"
@@ -30,6 +34,7 @@
 
 #include "hackos.h"
 #include "config.h"
+#include "hardware/radio/waterfall_tape.h"
 
 // ── Anonymous namespace for all internal implementation ──────────────────────
 
@@ -116,7 +121,8 @@ public:
           paused_(false),
           signalDetected_(false),
           xpAwarded_(false),
-          xpCooldownMs_(0U)
+          xpCooldownMs_(0U),
+          tape_("rfa")
     {
         std::memset(wfBuf_, 0, sizeof(wfBuf_));
     }
@@ -132,7 +138,7 @@ public:
      */
     void sampleRow()
     {
-        if (paused_)
+        if (paused_ || tape_.playing())
         {
             return;
         }
@@ -167,6 +173,7 @@ public:
 
         // Place new row at the top
         std::memcpy(wfBuf_[0], row, WF_ROW_BYTES);
+        tape_.pushRow(row);
 
         // XP award when signal activity is detected
         if (anyHigh)
@@ -187,8 +194,22 @@ public:
 
     void draw(Canvas *canvas) override
     {
+        // Playback replaces the header with the tape position
+        if (tape_.playing())
+        {
+            char title[24];
+            std::snprintf(title, sizeof(title), "Play x%u %s %lus",
+                          static_cast<unsigned>(tape_.zoom()),
+                          tape_.aggregate() == hackos::radio::WfAggregate::MAX ? "max" : "avg",
+                          static_cast<unsigned long>(tape_.positionSec()));
+            canvas->drawStr(2, 7, title);
+            canvas->drawLine(0, HEADER_H - 1, DISPLAY_W - 1, HEADER_H - 1);
+            drawWaterfall(canvas);
+            return;
+        }
+
         // Title bar
-        canvas->drawStr(2, 7, "RF Pro 433MHz");
+        canvas->drawStr(2, 7, tape_.recording() ? "RF Pro   REC" : "RF Pro 433MHz");
 
         // Zoom indicator
         char zoomTxt[16];
@@ -245,6 +266,63 @@ public:
     bool isPaused() const { return paused_; }
     size_t zoomIndex() const { return zoomIdx_; }
 
+    // ── Recording / playback ────────────────────────────────────────────
+
+    void toggleRecording()
+    {
+        if (tape_.recording())
+        {
+            tape_.stopRecording();
+        }
+        else
+        {
+            (void)tape_.startRecording(1U, static_cast<uint16_t>(SAMPLES_PER_ROW));
+        }
+    }
+
+    bool playing() const { return tape_.playing(); }
+
+    bool startPlayback()
+    {
+        if (!tape_.startPlayback())
+        {
+            return false;
+        }
+        refreshPlayback();
+        return true;
+    }
+
+    /// Back to live capture with a clean buffer.
+    void stopPlayback()
+    {
+        tape_.stopPlayback();
+        std::memset(wfBuf_, 0, sizeof(wfBuf_));
+        paused_ = false;
+    }
+
+    /// UP/DOWN scrub half a screen, RIGHT zooms, CENTER switches max/mean.
+    void playbackInput(InputManager::InputEvent input)
+    {
+        switch (input)
+        {
+        case InputManager::InputEvent::UP:
+            tape_.scrub(WF_H / 2);
+            break;
+        case InputManager::InputEvent::DOWN:
+            tape_.scrub(-(WF_H / 2));
+            break;
+        case InputManager::InputEvent::RIGHT:
+            tape_.cycleZoom();
+            break;
+        case InputManager::InputEvent::BUTTON_PRESS:
+            tape_.toggleAggregate();
+            break;
+        default:
+            return;
+        }
+        refreshPlayback();
+    }
+
 private:
     /// Packed 1-bit waterfall buffer: wfBuf_[row][packedByte]
     uint8_t wfBuf_[WF_H][WF_ROW_BYTES];
@@ -254,9 +332,15 @@ private:
     bool signalDetected_;
     bool xpAwarded_;
     uint32_t xpCooldownMs_;
+    hackos::radio::WaterfallTape tape_;
 
     // ── Helpers ──────────────────────────────────────────────────────────
 
+    void refreshPlayback()
+    {
+        tape_.fill(&wfBuf_[0][0], WF_ROW_BYTES, WF_H);
+    }
+
     /// Scroll all rows down by 1 (bottom row is discarded).
     void scrollDown()
     {
@@ -362,6 +446,21 @@ public:
         const auto input =
             static_cast<InputManager::InputEvent>(event->arg0);
 
+        // Playback: LEFT returns to live capture, other keys navigate
+        if (waterfallView_ != nullptr && waterfallView_->playing())
+        {
+            if (input == InputManager::InputEvent::LEFT)
+            {
+                waterfallView_->stopPlayback();
+            }
+            else
+            {
+                waterfallView_->playbackInput(input);
+            }
+            needsRedraw_ = true;
+            return;
+        }
+
         switch (input)
         {
         case InputManager::InputEvent::UP:
@@ -391,6 +490,22 @@ public:
             }
             break;
 
+        case InputManager::InputEvent::RIGHT:
+            // Paused: play back the newest recording; live: record
+            if (waterfallView_ != nullptr)
+            {
+                if (waterfallView_->isPaused())
+                {
+                    (void)waterfallView_->startPlayback();
+                }
+                else
+                {
+                    waterfallView_->toggleRecording();
+                }
+                needsRedraw_ = true;
+            }
+            break;
+
         case InputManager::InputEvent::LEFT:
             // Exit app
         {
@@ -3,12 +3,12 @@
  * @brief Phase 9 – 433 MHz RF Tools: RAW Capture, Jammer, Save/Replay.
  *
  * Implements a low-level 433 MHz signal analyser without high-level RF
- * libraries.  All signal capture is done via a GPIO edge interrupt on the
- * RX pin (GPIO16), measuring pulse durations in microseconds with
- * esp_timer_get_time().
+ * libraries.  Signal capture subscribes to the shared EdgeCapture service
+ * on the RX pin (GPIO16), which timestamps every edge with the CPU cycle
+ * counter; pulse durations come out in microseconds.
  *
  * Features:
- *  - **RAW Capture (Signal Sniffer)**: ISR-based pulse timing capture with
+ *  - **RAW Capture (Signal Sniffer)**: edge-capture pulse timing with
  *    a live mini-oscilloscope waveform on the OLED.
  *  - **Signal Jammer**: High-frequency PWM (LEDC) on the TX pin (GPIO25)
  *    to saturate 433.92 MHz.
@@ -27,14 +27,15 @@
 #include <cstring>
 #include <driver/gpio.h>
 #include <esp_log.h>
-#include <esp_timer.h>
 #include <new>
 
 #include "config.h"
 #include "core/event.h"
 #include "core/event_system.h"
 #include "hardware/display.h"
+#include "hardware/edge/edge_capture.h"
 #include "hardware/input.h"
+#include "storage/buffered_stream.h"
 #include "storage/vfs.h"
 #include "ui/widgets.h"
 
@@ -56,66 +57,13 @@ static constexpr uint32_t RF_FREQUENCY_HZ = 433920000U;
 static constexpr uint8_t LEDC_JAMMER_CHANNEL = 0U;
 static constexpr uint32_t JAMMER_FREQ_HZ = 500000U;
 
-/// Maximum gap duration (µs) stored in the ISR buffer.  Longer silences
+/// Maximum gap duration (µs) stored in the capture buffer.  Longer silences
 /// are clamped to this value to keep the waveform display manageable.
 static constexpr int32_t MAX_GAP_US = 100000;
 
 /// Path for saved captures on the SD card.
 static constexpr const char *CAPTURE_FILE_PATH = "/ext/captures/rf_capture.sub";
 
-// ── ISR-shared state (kept in DRAM for IRAM ISR access) ─────────────────────
-
-static volatile int32_t  s_rawTimings[RAW_BUF_CAPACITY];
-static volatile uint16_t s_rawCount   = 0U;
-static volatile int64_t  s_lastEdgeUs = 0;
-static volatile bool     s_isrActive  = false;
-
-/**
- * @brief GPIO edge ISR – measures pulse durations in microseconds.
- *
- * Fires on every edge of the RF RX pin.  The elapsed time since the
- * previous edge is recorded as a signed value: positive = mark (the
- * previous state was HIGH), negative = space (the previous state was LOW).
- *
- * This convention matches the Flipper SubGhz RAW format.
- */
-static void IRAM_ATTR rfRxEdgeISR(void * /*arg*/)
-{
-    const int64_t nowUs = esp_timer_get_time();
-    const int level = gpio_get_level(RF_RX_GPIO);
-
-    if (s_lastEdgeUs == 0)
-    {
-        // First edge – just seed the timestamp.
-        s_lastEdgeUs = nowUs;
-        return;
-    }
-
-    int32_t duration = static_cast<int32_t>(nowUs - s_lastEdgeUs);
-    s_lastEdgeUs = nowUs;
-
-    // Clamp unreasonably long gaps.
-    if (duration > MAX_GAP_US)
-    {
-        duration = MAX_GAP_US;
-    }
-
-    // After this edge the pin is at `level`.
-    // The duration we measured belongs to the PREVIOUS state:
-    //   pin now HIGH → previous was LOW → space → store negative
-    //   pin now LOW  → previous was HIGH → mark  → store positive
-    if (level)
-    {
-        duration = -duration;
-    }
-
-    if (s_rawCount < RAW_BUF_CAPACITY)
-    {
-        s_rawTimings[s_rawCount] = duration;
-        ++s_rawCount;
-    }
-}
-
 // ── Anonymous namespace for the app implementation ──────────────────────────
 
 namespace
@@ -154,6 +102,13 @@ static constexpr int16_t WAVE_WIDTH  = WAVE_X1 - WAVE_X0;
 /// Maximum timing values per RAW_Data line in the .sub file.
 static constexpr size_t SUB_VALUES_PER_LINE = 20U;
 
+/// "RAW_Data:" + SUB_VALUES_PER_LINE × " -2147483648" + "\n".
+static constexpr size_t SUB_LINE_LEN = 10U + SUB_VALUES_PER_LINE * 12U + 2U;
+
+/// A power cut mid-save leaves the header and whole RAW_Data lines only.
+static constexpr hackos::storage::DurabilityPolicy SUB_POLICY =
+    hackos::storage::DurabilityPolicy::every(4096U, 0U);
+
 // ═════════════════════════════════════════════════════════════════════════════
 // ── RFToolsApp ──────────────────────────────────────────────────────────────
 // ═════════════════════════════════════════════════════════════════════════════
@@ -168,6 +123,7 @@ public:
           needsRedraw_(true),
           jammerActive_(false),
           capturedCount_(0U),
+          rxReader_(),
           statusLine_{},
           statusTitle_("Status")
     {
@@ -186,13 +142,6 @@ public:
         state_ = RFState::MAIN_MENU;
         needsRedraw_ = true;
 
-        // Install the GPIO ISR service (safe if already installed).
-        const esp_err_t err = gpio_install_isr_service(0);
-        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
-        {
-            ESP_LOGE(TAG_RF_APP, "gpio_install_isr_service failed: %d", err);
-        }
-
         ESP_LOGI(TAG_RF_APP, "setup complete");
     }
 
@@ -200,10 +149,8 @@ public:
     {
         if (state_ == RFState::RAW_CAPTURE)
         {
-            const uint16_t isrCount = s_rawCount;
-            if (isrCount != capturedCount_)
+            if (drainCapture())
             {
-                copyIsrBuffer(isrCount);
                 needsRedraw_ = true;
             }
         }
@@ -277,10 +224,13 @@ private:
     bool needsRedraw_;
     bool jammerActive_;
 
-    /// Local copy of captured pulse timings (copied from the ISR buffer).
+    /// Captured pulse timings (drained from the edge capture).
     int32_t  capturedTimings_[RAW_BUF_CAPACITY];
     uint16_t capturedCount_;
 
+    /// Our cursor into the shared RX edge capture.
+    hackos::edge::EdgeReader rxReader_;
+
     /// Status message shown on save / replay / load screens.
     char statusLine_[LINE_LEN];
 
@@ -402,12 +352,10 @@ private:
         DisplayManager::instance().drawText(2, 48, "Press to continue");
     }
 
-    // ── RAW capture control (ISR-based) ──────────────────────────────────
+    // ── RAW capture control (EdgeCapture subscriber) ─────────────────────
 
     void startRawCapture()
     {
-        s_rawCount   = 0U;
-        s_lastEdgeUs = 0;
         capturedCount_ = 0U;
 
         gpio_config_t io_conf = {};
@@ -415,11 +363,15 @@ private:
         io_conf.mode          = GPIO_MODE_INPUT;
         io_conf.pull_up_en    = GPIO_PULLUP_DISABLE;
         io_conf.pull_down_en  = GPIO_PULLDOWN_DISABLE;
-        io_conf.intr_type     = GPIO_INTR_ANYEDGE;
+        io_conf.intr_type     = GPIO_INTR_DISABLE; // EdgeCapture sets it
         gpio_config(&io_conf);
 
-        gpio_isr_handler_add(RF_RX_GPIO, rfRxEdgeISR, nullptr);
-        s_isrActive = true;
+        if (!hackos::edge::EdgeCapture::instance().subscribe(PIN_RF_RX, &rxReader_))
+        {
+            ESP_LOGE(TAG_RF_APP, "edge capture unavailable on GPIO%u",
+                     static_cast<unsigned>(PIN_RF_RX));
+            return;
+        }
 
         ESP_LOGI(TAG_RF_APP, "RAW capture started on GPIO%u",
                  static_cast<unsigned>(PIN_RF_RX));
@@ -427,13 +379,10 @@ private:
 
     void stopRawCapture()
     {
-        if (s_isrActive)
+        if (rxReader_.attached())
         {
-            gpio_isr_handler_remove(RF_RX_GPIO);
-            gpio_set_intr_type(RF_RX_GPIO, GPIO_INTR_DISABLE);
-            s_isrActive = false;
-
-            copyIsrBuffer(s_rawCount);
+            (void)drainCapture();
+            hackos::edge::EdgeCapture::instance().unsubscribe(PIN_RF_RX, &rxReader_);
 
             ESP_LOGI(TAG_RF_APP, "RAW capture stopped – %u pulses",
                      capturedCount_);
@@ -445,18 +394,14 @@ private:
         }
     }
 
-    /// Copy the volatile ISR buffer into local (non-volatile) storage.
-    void copyIsrBuffer(uint16_t count)
+    /// Append newly captured pulses; true if any arrived.
+    bool drainCapture()
     {
-        if (count > RAW_BUF_CAPACITY)
-        {
-            count = static_cast<uint16_t>(RAW_BUF_CAPACITY);
-        }
-        for (uint16_t i = 0U; i < count; ++i)
-        {
-            capturedTimings_[i] = s_rawTimings[i];
-        }
-        capturedCount_ = count;
+        const size_t n = hackos::edge::EdgeCapture::instance().readPulses(
+            PIN_RF_RX, &rxReader_, &capturedTimings_[capturedCount_],
+            RAW_BUF_CAPACITY - capturedCount_, MAX_GAP_US);
+        capturedCount_ = static_cast<uint16_t>(capturedCount_ + n);
+        return n != 0U;
     }
 
     // ── Jammer control (LEDC PWM) ────────────────────────────────────────
@@ -493,31 +438,40 @@ private:
             return false;
         }
 
-        auto &vfs = hackos::storage::VirtualFS::instance();
-        fs::File f = vfs.open(CAPTURE_FILE_PATH, "w");
-        if (!f)
+        hackos::storage::DurableWriter w;
+        if (!w.begin(CAPTURE_FILE_PATH, SUB_POLICY))
         {
             ESP_LOGE(TAG_RF_APP, "Cannot open %s for writing", CAPTURE_FILE_PATH);
             return false;
         }
 
-        f.println("Filetype: Flipper SubGhz RAW File");
-        f.println("Version: 1");
-        f.printf("Frequency: %lu\n", static_cast<unsigned long>(RF_FREQUENCY_HZ));
-        f.println("Preset: FuriHalSubGhzPresetOok650Async");
-        f.println("Protocol: RAW");
+        char line[SUB_LINE_LEN];
+        int len = std::snprintf(line, sizeof(line),
+            "Filetype: Flipper SubGhz RAW File\nVersion: 1\nFrequency: %lu\n"
+            "Preset: FuriHalSubGhzPresetOok650Async\nProtocol: RAW\n",
+            static_cast<unsigned long>(RF_FREQUENCY_HZ));
+        bool ok = w.write(reinterpret_cast<const uint8_t *>(line), static_cast<size_t>(len)) &&
+                  w.endRecord();
 
-        for (uint16_t i = 0U; i < capturedCount_;)
+        for (uint16_t i = 0U; i < capturedCount_ && ok;)
         {
-            f.print("RAW_Data:");
+            len = std::snprintf(line, sizeof(line), "RAW_Data:");
             for (size_t j = 0U; j < SUB_VALUES_PER_LINE && i < capturedCount_; ++j, ++i)
             {
-                f.printf(" %ld", static_cast<long>(capturedTimings_[i]));
+                len += std::snprintf(line + len, sizeof(line) - static_cast<size_t>(len),
+                                     " %ld", static_cast<long>(capturedTimings_[i]));
             }
-            f.println();
+            line[len++] = '\n';
+            ok = w.write(reinterpret_cast<const uint8_t *>(line), static_cast<size_t>(len)) &&
+                 w.endRecord();
         }
 
-        f.close();
+        w.close();
+        if (!ok)
+        {
+            ESP_LOGE(TAG_RF_APP, "Write to %s failed", CAPTURE_FILE_PATH);
+            return false;
+        }
         ESP_LOGI(TAG_RF_APP, "Saved %u pulses to %s", capturedCount_, CAPTURE_FILE_PATH);
         return true;
     }
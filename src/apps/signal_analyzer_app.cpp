@@ -7,7 +7,8 @@
  * the 128×64 OLED.  Brighter pixels indicate stronger RF activity.
  *
  * Features:
- *  - High-speed ADC sampling of PIN_RF_RX for signal intensity.
+ *  - High-speed ADC sampling of PIN_RF_RX for signal intensity, through
+ *    the I2S DMA AdcStream when the pin is on ADC1.
  *  - Waterfall UI: each new sample row appears at the top and scrolls
  *    down, giving a time-vs-intensity view of the 433 MHz band.
  *  - Peak detection: the column with the highest energy in the current
@@ -15,6 +16,9 @@
  *  - Sound-to-Light: optional buzzer output that maps signal strength
  *    to an audible tone via LEDC PWM on PIN_BUZZER.
  *  - DMA-style direct buffer writes to maintain ~30 FPS.
+ *  - Session recording: RIGHT records the rows to
+ *    /ext/captures/waterfall/sa_NNN.wfl; DOWN plays the newest recording
+ *    back (UP/DOWN scrub, RIGHT time zoom, OK max/mean, LEFT live).
  */
 
 #include "apps/signal_analyzer_app.h"
@@ -28,6 +32,8 @@
 
 #include "hackos.h"
 #include "config.h"
+#include "hardware/adc/adc_stream.h"
+#include "hardware/radio/waterfall_tape.h"
 
 // ── Anonymous namespace for all internal implementation ──────────────────────
 
@@ -54,6 +60,11 @@ static constexpr size_t SAMPLES_PER_ROW = 128U;
 /// ADC resolution (12-bit on ESP32)
 static constexpr uint16_t ADC_MAX = 4095U;
 
+/// DMA stream: 200 kHz through a /4 FIR gives one row per 2.56 ms,
+/// the span of the polled loop.
+static constexpr uint32_t STREAM_RATE_HZ = 200000U;
+static constexpr uint8_t STREAM_DECIMATION = 4U;
+
 /// Number of intensity levels mapped to dither patterns (monochrome OLED)
 static constexpr uint8_t INTENSITY_LEVELS = 4U;
 
@@ -109,7 +120,8 @@ public:
           peakCol_(0),
           peakVal_(0),
           xpAwarded_(false),
-          xpCooldownMs_(0U)
+          xpCooldownMs_(0U),
+          tape_("sa")
     {
         std::memset(wfBuf_, 0, sizeof(wfBuf_));
         std::memset(currentRow_, 0, sizeof(currentRow_));
@@ -120,30 +132,34 @@ public:
     /**
      * @brief Sample the RF RX pin at high speed and fill the current row.
      *
-     * Reads PIN_RF_RX using analogRead at tight intervals.  Each of the
-     * 128 columns gets one sample (this keeps it simple on the monochrome
-     * OLED).  The 12-bit ADC value is quantised into 0-3 intensity.
+     * Takes the newest 128 samples from the DMA AdcStream when it runs;
+     * otherwise reads PIN_RF_RX using analogRead at tight intervals.
+     * Each of the 128 columns gets one sample (this keeps it simple on
+     * the monochrome OLED).  The 12-bit ADC value is quantised into 0-3
+     * intensity.
      */
     void sampleRow()
     {
+        if (tape_.playing())
+        {
+            return;
+        }
+
+        uint16_t raw[SAMPLES_PER_ROW];
+        fillRaw(raw);
+
         uint16_t peakV = 0U;
         uint8_t peakC = 0U;
 
         for (size_t i = 0U; i < SAMPLES_PER_ROW; ++i)
         {
-            const uint16_t raw = static_cast<uint16_t>(analogRead(PIN_RF_RX));
-            const uint8_t q = quantise(raw);
-            currentRow_[i] = q;
+            currentRow_[i] = quantise(raw[i]);
 
-            if (raw > peakV)
+            if (raw[i] > peakV)
             {
-                peakV = raw;
+                peakV = raw[i];
                 peakC = static_cast<uint8_t>(i);
             }
-
-            // Brief inter-sample delay for consistent sampling rate.
-            // ~1.3ms total per row is acceptable within the 33ms frame budget.
-            delayMicroseconds(SAMPLE_INTERVAL_US);
         }
 
         peakCol_ = peakC;
@@ -157,6 +173,7 @@ public:
         {
             setIntensity(0U, c, currentRow_[c]);
         }
+        tape_.pushRow(wfBuf_[0]);
 
         // Sound-to-light: drive buzzer frequency proportional to peak
         if (buzzerOn_)
@@ -193,8 +210,20 @@ public:
 
     void draw(Canvas *canvas) override
     {
-        // Title bar
-        canvas->drawStr(2, 7, "RF Waterfall 433MHz");
+        // Title bar (replaced by the position while playing back)
+        if (tape_.playing())
+        {
+            char title[24];
+            std::snprintf(title, sizeof(title), "Play x%u %s %lus",
+                          static_cast<unsigned>(tape_.zoom()),
+                          tape_.aggregate() == hackos::radio::WfAggregate::MAX ? "max" : "avg",
+                          static_cast<unsigned long>(tape_.positionSec()));
+            canvas->drawStr(2, 7, title);
+        }
+        else
+        {
+            canvas->drawStr(2, 7, tape_.recording() ? "RF Waterfall  REC" : "RF Waterfall 433MHz");
+        }
         canvas->drawLine(0, HEADER_H - 1, DISPLAY_W - 1, HEADER_H - 1);
 
         // Buzzer indicator
@@ -206,6 +235,11 @@ public:
         // Waterfall area – render from buffer using dither patterns
         drawWaterfall(canvas);
 
+        if (tape_.playing())
+        {
+            return;
+        }
+
         // Peak marker (inverted triangle at the peak column)
         if (peakVal_ > ADC_MAX / 10U)
         {
@@ -249,6 +283,63 @@ public:
         ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
     }
 
+    // ── Recording / playback ────────────────────────────────────────────
+
+    void toggleRecording()
+    {
+        if (tape_.recording())
+        {
+            tape_.stopRecording();
+        }
+        else
+        {
+            (void)tape_.startRecording(2U, static_cast<uint16_t>(SAMPLES_PER_ROW));
+        }
+    }
+
+    bool playing() const { return tape_.playing(); }
+
+    bool startPlayback()
+    {
+        if (!tape_.startPlayback())
+        {
+            return false;
+        }
+        stopBuzzer();
+        peakVal_ = 0U;
+        refreshPlayback();
+        return true;
+    }
+
+    void stopPlayback()
+    {
+        tape_.stopPlayback();
+        std::memset(wfBuf_, 0, sizeof(wfBuf_));
+    }
+
+    /// UP/DOWN scrub half a screen, RIGHT zooms, OK switches max/mean.
+    void playbackInput(InputManager::InputEvent input)
+    {
+        switch (input)
+        {
+        case InputManager::InputEvent::UP:
+            tape_.scrub(WF_H / 2);
+            break;
+        case InputManager::InputEvent::DOWN:
+            tape_.scrub(-(WF_H / 2));
+            break;
+        case InputManager::InputEvent::RIGHT:
+            tape_.cycleZoom();
+            break;
+        case InputManager::InputEvent::BUTTON_PRESS:
+            tape_.toggleAggregate();
+            break;
+        default:
+            return;
+        }
+        refreshPlayback();
+    }
+
 private:
     /// 2-bit intensity buffer: wfBuf_[row][packedCol]
     uint8_t wfBuf_[WF_H][WF_ROW_BYTES];
@@ -259,9 +350,15 @@ private:
     uint16_t peakVal_;
     bool xpAwarded_;
     uint32_t xpCooldownMs_;
+    hackos::radio::WaterfallTape tape_;
 
     // ── Helpers ──────────────────────────────────────────────────────────
 
+    void refreshPlayback()
+    {
+        tape_.fill(&wfBuf_[0][0], WF_ROW_BYTES, WF_H);
+    }
+
     /// Quantise 12-bit ADC value to 0-3 intensity.
     static uint8_t quantise(uint16_t raw)
     {
@@ -280,6 +377,21 @@ private:
         return 3U;
     }
 
+    /// Newest row of samples: from the DMA stream, or polled if it is off.
+    static void fillRaw(uint16_t *raw)
+    {
+        auto &stream = hackos::adc::AdcStream::instance();
+        if (stream.isRunning() && stream.newest(raw, SAMPLES_PER_ROW) == SAMPLES_PER_ROW)
+        {
+            return;
+        }
+        for (size_t i = 0U; i < SAMPLES_PER_ROW; ++i)
+        {
+            raw[i] = static_cast<uint16_t>(analogRead(PIN_RF_RX));
+            delayMicroseconds(SAMPLE_INTERVAL_US);
+        }
+    }
+
     /// Get the 2-bit intensity at (row, col) in the waterfall buffer.
     uint8_t getIntensity(size_t row, size_t col) const
     {
@@ -413,6 +525,18 @@ public:
         analogSetPinAttenuation(PIN_RF_RX, ADC_11db);
         pinMode(PIN_RF_RX, INPUT);
 
+        // Stream through I2S DMA when the pin is on ADC1; otherwise the
+        // waterfall keeps polling analogRead.
+        hackos::adc::AdcStreamConfig adcCfg;
+        adcCfg.pin = PIN_RF_RX;
+        adcCfg.rateHz = STREAM_RATE_HZ;
+        adcCfg.decimation = STREAM_DECIMATION;
+        if (!hackos::adc::AdcStream::instance().start(adcCfg))
+        {
+            ESP_LOGI(TAG_SIG, "ADC DMA unavailable on GPIO%u, polling",
+                     static_cast<unsigned>(PIN_RF_RX));
+        }
+
         // Initialise LEDC for the buzzer (sound-to-light)
         ledcSetup(BUZZER_LEDC_CHANNEL, 2000, BUZZER_LEDC_RESOLUTION);
         ledcAttachPin(PIN_BUZZER, BUZZER_LEDC_CHANNEL);
@@ -431,6 +555,21 @@ public:
 
         const auto input = static_cast<InputManager::InputEvent>(event->arg0);
 
+        // Playback: LEFT returns to the live view, other keys navigate
+        if (waterfallView_ != nullptr && waterfallView_->playing())
+        {
+            if (input == InputManager::InputEvent::LEFT)
+            {
+                waterfallView_->stopPlayback();
+            }
+            else
+            {
+                waterfallView_->playbackInput(input);
+            }
+            needsRedraw_ = true;
+            return;
+        }
+
         // CENTER: toggle buzzer
         if (input == InputManager::InputEvent::BUTTON_PRESS)
         {
@@ -440,6 +579,23 @@ public:
                 needsRedraw_ = true;
             }
         }
+        // RIGHT: start / stop recording
+        else if (input == InputManager::InputEvent::RIGHT)
+        {
+            if (waterfallView_ != nullptr)
+            {
+                waterfallView_->toggleRecording();
+                needsRedraw_ = true;
+            }
+        }
+        // DOWN: play back the newest recording
+        else if (input == InputManager::InputEvent::DOWN)
+        {
+            if (waterfallView_ != nullptr && waterfallView_->startPlayback())
+            {
+                needsRedraw_ = true;
+            }
+        }
         // LEFT or BACK: exit app
         else if (input == InputManager::InputEvent::LEFT)
         {
@@ -462,6 +618,8 @@ public:
         // Detach buzzer
         ledcDetachPin(PIN_BUZZER);
 
+        hackos::adc::AdcStream::instance().stop();
+
         viewDispatcher_.removeView(VIEW_WATERFALL);
 
         if (waterfallView_ != nullptr)
@@ -6,9 +6,13 @@
  *
  *  1. **Waterfall Visualizer** – scrolling cascade display where each pixel
  *     row represents signal intensity at a point in time.  Uses high-speed
- *     ADC sampling of PIN_RF_RX with dithered intensity levels.
+ *     ADC sampling of PIN_RF_RX (I2S DMA stream on ADC1 pins) with
+ *     dithered intensity levels.  RIGHT records the session to
+ *     /ext/captures/waterfall/sl_NNN.wfl, DOWN plays the newest recording
+ *     back (UP/DOWN scrub, RIGHT time zoom, CENTER max/mean, LEFT live).
  *
- *  2. **Protocol Decoder** – captures edge timings via GPIO ISR and matches
+ *  2. **Protocol Decoder** – reads edge timings from the shared EdgeCapture
+ *     service (one ISR on PIN_RF_RX for every view) and matches
  *     against common OOK protocols (Princeton, EV1527, HT6P20B).  Displays
  *     decoded device ID and function bits in real time.
  *
@@ -27,10 +31,13 @@
 
 #include <Arduino.h>
 #include <esp_log.h>
-#include <driver/gpio.h>
 
 #include "hackos.h"
 #include "config.h"
+#include "hardware/adc/adc_stream.h"
+#include "hardware/edge/edge_capture.h"
+#include "hardware/radio/pulse_spectrum.h"
+#include "hardware/radio/waterfall_tape.h"
 
 // ── Anonymous namespace for all internal implementation ──────────────────────
 
@@ -63,6 +70,10 @@ static constexpr uint8_t INTENSITY_LEVELS = 4U;
 /// High-speed sampling interval (µs)
 static constexpr uint32_t SAMPLE_INTERVAL_US = 10U;
 
+/// DMA stream: 200 kHz through a /4 FIR gives one row per 2.56 ms.
+static constexpr uint32_t STREAM_RATE_HZ = 200000U;
+static constexpr uint8_t  STREAM_DECIMATION = 4U;
+
 /// XP cooldown between awards (ms)
 static constexpr uint32_t XP_COOLDOWN_MS = 10000U;
 
@@ -115,42 +126,87 @@ static constexpr ProtocolDef PROTOCOLS[] = {
 
 static constexpr size_t PROTO_COUNT = sizeof(PROTOCOLS) / sizeof(PROTOCOLS[0]);
 
-// ── ISR-shared pulse capture state ──────────────────────────────────────────
+// ── Shared RX edge capture ──────────────────────────────────────────────────
+
+/// Pulses shorter than this are receiver noise (OOK symbols are ≥ 150 µs).
+static constexpr uint32_t RX_GLITCH_NS = 20000U;
 
-/// Circular buffer for edge timings captured by the GPIO ISR.
-/// Positive values = HIGH duration (µs), negative = LOW duration (µs).
-static volatile int32_t  s_pulseBuf[MAX_PULSES];
-static volatile size_t   s_pulseHead  = 0U;
-static volatile size_t   s_pulseCount = 0U;
-static volatile int64_t  s_lastEdgeUs = 0;
-static volatile bool     s_isrActive  = false;
+/// Longest pulse kept; longer silences are clamped.
+static constexpr int32_t MAX_PULSE_US = 100000;
 
-/// GPIO ISR handler: captures edge timing into the circular buffer.
-static void IRAM_ATTR rfEdgeISR(void * /*arg*/)
+/**
+ * @brief The newest MAX_PULSES pulses of the RF RX pin.
+ *
+ * Each analysis view owns a window with its own EdgeReader, so all of
+ * them share the one EdgeCapture ISR on PIN_RF_RX.  Pulses are signed
+ * µs: positive = HIGH duration, negative = LOW duration.
+ */
+class PulseWindow
 {
-    const int64_t now = esp_timer_get_time();
-    if (s_lastEdgeUs == 0)
+public:
+    PulseWindow() : buf_{}, head_(0U), count_(0U), reader_() {}
+
+    bool open()
     {
-        s_lastEdgeUs = now;
-        return;
+        hackos::edge::EdgeCaptureConfig cfg;
+        cfg.glitchNs = RX_GLITCH_NS;
+        return hackos::edge::EdgeCapture::instance().subscribe(PIN_RF_RX, &reader_, cfg);
     }
 
-    const int32_t duration = static_cast<int32_t>(now - s_lastEdgeUs);
-    s_lastEdgeUs = now;
+    void close()
+    {
+        hackos::edge::EdgeCapture::instance().unsubscribe(PIN_RF_RX, &reader_);
+    }
 
-    // Determine if this edge is rising (signal went HIGH) or falling
-    const int level = gpio_get_level(static_cast<gpio_num_t>(PIN_RF_RX));
-    // After a rising edge the pin is HIGH → previous period was LOW
-    const int32_t signedDur = (level != 0) ? -duration : duration;
+    /// Forget the window and continue from the live end of the capture.
+    void clear()
+    {
+        reader_.skipToLive();
+        head_  = 0U;
+        count_ = 0U;
+    }
 
-    const size_t idx = s_pulseHead;
-    s_pulseBuf[idx] = signedDur;
-    s_pulseHead = (idx + 1U) % MAX_PULSES;
-    if (s_pulseCount < MAX_PULSES)
+    /// Pull newly captured pulses into the window; returns how many.
+    size_t update()
     {
-        ++s_pulseCount;
+        int32_t fresh[32];
+        size_t added = 0U;
+        size_t n;
+        while ((n = hackos::edge::EdgeCapture::instance().readPulses(
+                    PIN_RF_RX, &reader_, fresh, 32U, MAX_PULSE_US)) > 0U)
+        {
+            for (size_t i = 0U; i < n; ++i)
+            {
+                buf_[head_] = fresh[i];
+                head_ = (head_ + 1U) % MAX_PULSES;
+                if (count_ < MAX_PULSES)
+                {
+                    ++count_;
+                }
+            }
+            added += n;
+        }
+        return added;
     }
-}
+
+    /// Copy the window into @p out (oldest first); returns the count.
+    size_t snapshot(int32_t *out) const
+    {
+        for (size_t i = 0U; i < count_; ++i)
+        {
+            out[i] = buf_[(head_ + MAX_PULSES - count_ + i) % MAX_PULSES];
+        }
+        return count_;
+    }
+
+    size_t count() const { return count_; }
+
+private:
+    int32_t buf_[MAX_PULSES];
+    size_t  head_;
+    size_t  count_;
+    hackos::edge::EdgeReader reader_;
+};
 
 // ── Scene / View IDs ────────────────────────────────────────────────────────
 
@@ -247,45 +303,67 @@ class SLWaterfallView final : public View
 public:
     SLWaterfallView()
         : peakCol_(0),
-          peakVal_(0)
+          peakVal_(0),
+          tape_("sl")
     {
         std::memset(wfBuf_, 0, sizeof(wfBuf_));
     }
 
-    /// Sample one row of ADC data from PIN_RF_RX.
+    /// Sample one row of ADC data from PIN_RF_RX (DMA stream or polled).
     void sampleRow()
     {
+        if (tape_.playing())
+        {
+            return;
+        }
+
+        uint16_t raw[SAMPLES_PER_ROW];
+        fillRaw(raw);
+
         uint16_t peakV = 0U;
         uint8_t  peakC = 0U;
 
+        // Scroll waterfall down (newest row at top)
+        scrollDown();
+
         for (size_t i = 0U; i < SAMPLES_PER_ROW; ++i)
         {
-            const uint16_t raw =
-                static_cast<uint16_t>(analogRead(PIN_RF_RX));
-            const uint8_t q = quantise(raw);
-            setIntensity(0U, i, q);
+            setIntensity(0U, i, quantise(raw[i]));
 
-            if (raw > peakV)
+            if (raw[i] > peakV)
             {
-                peakV = raw;
+                peakV = raw[i];
                 peakC = static_cast<uint8_t>(i);
             }
-            delayMicroseconds(SAMPLE_INTERVAL_US);
         }
 
         peakCol_ = peakC;
         peakVal_ = peakV;
-
-        // Scroll waterfall down (newest row at top)
-        scrollDown();
+        tape_.pushRow(wfBuf_[0]);
     }
 
     void draw(Canvas *canvas) override
     {
-        canvas->drawStr(2, 7, "Waterfall 433MHz");
+        if (tape_.playing())
+        {
+            char title[24];
+            std::snprintf(title, sizeof(title), "Play x%u %s %lus",
+                          static_cast<unsigned>(tape_.zoom()),
+                          tape_.aggregate() == hackos::radio::WfAggregate::MAX ? "max" : "avg",
+                          static_cast<unsigned long>(tape_.positionSec()));
+            canvas->drawStr(2, 7, title);
+        }
+        else
+        {
+            canvas->drawStr(2, 7, tape_.recording() ? "Waterfall  REC" : "Waterfall 433MHz");
+        }
         canvas->drawLine(0, HEADER_H - 1, DISPLAY_W - 1, HEADER_H - 1);
 
         drawWaterfall(canvas);
+        if (tape_.playing())
+        {
+            return;
+        }
 
         // Peak marker
         if (peakVal_ > ADC_MAX / 10U)
@@ -304,10 +382,59 @@ public:
 
     bool input(InputEvent * /*event*/) override { return false; }
 
+    // ── Recording / playback ────────────────────────────────────────────
+
+    void toggleRecording()
+    {
+        if (tape_.recording())
+        {
+            tape_.stopRecording();
+        }
+        else
+        {
+            (void)tape_.startRecording(2U, static_cast<uint16_t>(SAMPLES_PER_ROW));
+        }
+    }
+
+    void stopRecording() { tape_.stopRecording(); }
+
+    bool playing() const { return tape_.playing(); }
+
+    bool startPlayback()
+    {
+        if (!tape_.startPlayback())
+        {
+            return false;
+        }
+        tape_.fill(&wfBuf_[0][0], WF_ROW_BYTES, WF_H);
+        return true;
+    }
+
+    void stopPlayback()
+    {
+        tape_.stopPlayback();
+        std::memset(wfBuf_, 0, sizeof(wfBuf_));
+    }
+
+    /// UP/DOWN scrub half a screen, RIGHT zooms, CENTER switches max/mean.
+    void playbackInput(InputManager::InputEvent input)
+    {
+        switch (input)
+        {
+        case InputManager::InputEvent::UP:           tape_.scrub(WF_H / 2); break;
+        case InputManager::InputEvent::DOWN:         tape_.scrub(-(WF_H / 2)); break;
+        case InputManager::InputEvent::RIGHT:        tape_.cycleZoom(); break;
+        case InputManager::InputEvent::BUTTON_PRESS: tape_.toggleAggregate(); break;
+        default: return;
+        }
+        tape_.fill(&wfBuf_[0][0], WF_ROW_BYTES, WF_H);
+    }
+
 private:
     uint8_t wfBuf_[WF_H][WF_ROW_BYTES];
     uint8_t peakCol_;
     uint16_t peakVal_;
+    hackos::radio::WaterfallTape tape_;
 
     static uint8_t quantise(uint16_t raw)
     {
@@ -317,6 +444,21 @@ private:
         return 3U;
     }
 
+    /// Newest row of samples: from the DMA stream, or polled if it is off.
+    static void fillRaw(uint16_t *raw)
+    {
+        auto &stream = hackos::adc::AdcStream::instance();
+        if (stream.isRunning() && stream.newest(raw, SAMPLES_PER_ROW) == SAMPLES_PER_ROW)
+        {
+            return;
+        }
+        for (size_t i = 0U; i < SAMPLES_PER_ROW; ++i)
+        {
+            raw[i] = static_cast<uint16_t>(analogRead(PIN_RF_RX));
+            delayMicroseconds(SAMPLE_INTERVAL_US);
+        }
+    }
+
     uint8_t getIntensity(size_t row, size_t col) const
     {
         const size_t byteIdx = (col * 2U) / 8U;
@@ -380,20 +522,12 @@ public:
     {
     }
 
-    /// Copy ISR buffer and attempt protocol decoding.
+    /// Pull new pulses and attempt protocol decoding.
     void processCapture()
     {
-        // Snapshot the volatile ISR buffer
-        noInterrupts();
-        const size_t count = s_pulseCount;
+        window_.update();
         int32_t localBuf[MAX_PULSES];
-        size_t head = s_pulseHead;
-        for (size_t i = 0U; i < count; ++i)
-        {
-            const size_t idx = (head + MAX_PULSES - count + i) % MAX_PULSES;
-            localBuf[i] = s_pulseBuf[idx];
-        }
-        interrupts();
+        const size_t count = window_.snapshot(localBuf);
 
         if (count < MIN_FRAME_PULSES)
         {
@@ -465,7 +599,7 @@ public:
             // Show pulse count for feedback
             char cntTxt[24];
             std::snprintf(cntTxt, sizeof(cntTxt), "Pulses: %u",
-                          static_cast<unsigned>(s_pulseCount));
+                          static_cast<unsigned>(window_.count()));
             canvas->drawStr(2, HEADER_H + 44, cntTxt);
         }
     }
@@ -477,9 +611,13 @@ public:
         detectedProto_ = PROTO_UNKNOWN;
         decodedCode_   = 0U;
         decodedBits_   = 0U;
+        window_.clear();
     }
 
+    PulseWindow &window() { return window_; }
+
 private:
+    PulseWindow window_;
     uint8_t  detectedProto_;
     uint32_t decodedCode_;
     uint8_t  decodedBits_;
@@ -594,31 +732,35 @@ public:
         : syncUs_(0U),
           highUs_(0U),
           lowUs_(0U),
-          pulseCount_(0U)
+          pulseCount_(0U),
+          timing_{},
+          hasTiming_(false)
     {
     }
 
-    /// Analyse the ISR pulse buffer and extract timing statistics.
+    PulseWindow &window() { return window_; }
+
+    /// Pull new pulses and extract timing statistics.
     void analyse()
     {
-        noInterrupts();
-        const size_t count = s_pulseCount;
+        const size_t fresh = window_.update();
         int32_t localBuf[MAX_PULSES];
-        const size_t head = s_pulseHead;
-        for (size_t i = 0U; i < count; ++i)
-        {
-            const size_t idx = (head + MAX_PULSES - count + i) % MAX_PULSES;
-            localBuf[i] = s_pulseBuf[idx];
-        }
-        interrupts();
+        const size_t count = window_.snapshot(localBuf);
 
         if (count < 4U)
         {
+            hasTiming_ = false;
             return;
         }
 
         pulseCount_ = static_cast<uint16_t>(count);
 
+        // Clock / bit-rate estimate, only when the window changed
+        if (fresh > 0U)
+        {
+            hasTiming_ = spectrum_.analyse(localBuf, count, &timing_);
+        }
+
         // Find the longest LOW duration as the likely sync pulse
         uint32_t maxLow = 0U;
         for (size_t i = 0U; i < count; ++i)
@@ -685,9 +827,19 @@ public:
                       static_cast<unsigned long>(lowUs_));
         canvas->drawStr(2, HEADER_H + 30, buf);
 
-        // Pulse count
-        std::snprintf(buf, sizeof(buf), "Count: %u",
-                      static_cast<unsigned>(pulseCount_));
+        // Pulse count, plus the estimated bit rate and coding
+        if (hasTiming_)
+        {
+            std::snprintf(buf, sizeof(buf), "%u: %lubps %s",
+                          static_cast<unsigned>(pulseCount_),
+                          static_cast<unsigned long>(timing_.bitRateBps),
+                          hackos::radio::modulationHintName(timing_.hint));
+        }
+        else
+        {
+            std::snprintf(buf, sizeof(buf), "Count: %u",
+                          static_cast<unsigned>(pulseCount_));
+        }
         canvas->drawStr(2, HEADER_H + 40, buf);
 
         // Graphical bar representation (bottom area)
@@ -701,6 +853,10 @@ private:
     uint32_t highUs_;
     uint32_t lowUs_;
     uint16_t pulseCount_;
+    PulseWindow window_;
+    hackos::radio::PulseSpectrum spectrum_;
+    hackos::radio::PulseSpectrumResult timing_;
+    bool hasTiming_;
 
     /// Draw proportional horizontal bars for Sync, High, Low.
     void drawBars(Canvas *canvas) const
@@ -804,16 +960,26 @@ public:
         analogSetPinAttenuation(PIN_RF_RX, ADC_11db);
         pinMode(PIN_RF_RX, INPUT);
 
-        // Install GPIO ISR for pulse capture (decoder + pulse views)
-        gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
-        gpio_set_intr_type(
-            static_cast<gpio_num_t>(PIN_RF_RX), GPIO_INTR_ANYEDGE);
-        gpio_isr_handler_add(
-            static_cast<gpio_num_t>(PIN_RF_RX), rfEdgeISR, nullptr);
-        s_isrActive = true;
-        s_lastEdgeUs = 0;
-        s_pulseHead  = 0U;
-        s_pulseCount = 0U;
+        // Stream through I2S DMA when the pin is on ADC1; otherwise the
+        // waterfall keeps polling analogRead.
+        hackos::adc::AdcStreamConfig adcCfg;
+        adcCfg.pin = PIN_RF_RX;
+        adcCfg.rateHz = STREAM_RATE_HZ;
+        adcCfg.decimation = STREAM_DECIMATION;
+        if (!hackos::adc::AdcStream::instance().start(adcCfg))
+        {
+            ESP_LOGI(TAG_SL, "ADC DMA unavailable on GPIO%u, polling",
+                     static_cast<unsigned>(PIN_RF_RX));
+        }
+
+        // Decoder and pulse views share the RX edge capture
+        const bool decOk = (decoderView_ != nullptr) && decoderView_->window().open();
+        const bool pulseOk = (pulseView_ != nullptr) && pulseView_->window().open();
+        if (!decOk || !pulseOk)
+        {
+            ESP_LOGW(TAG_SL, "edge capture unavailable on GPIO%u",
+                     static_cast<unsigned>(PIN_RF_RX));
+        }
 
         needsRedraw_ = true;
         ESP_LOGI(TAG_SL, "SignalLab started");
@@ -835,6 +1001,8 @@ public:
             handleMenuInput(input);
             break;
         case SCENE_WATERFALL:
+            handleWaterfallInput(input);
+            break;
         case SCENE_DECODER:
         case SCENE_PULSE:
             handleSubviewInput(input);
@@ -846,12 +1014,11 @@ public:
 
     void on_free() override
     {
-        // Remove ISR
-        if (s_isrActive)
-        {
-            gpio_isr_handler_remove(static_cast<gpio_num_t>(PIN_RF_RX));
-            s_isrActive = false;
-        }
+        // Leave the RX edge capture
+        if (decoderView_ != nullptr) { decoderView_->window().close(); }
+        if (pulseView_   != nullptr) { pulseView_->window().close(); }
+
+        hackos::adc::AdcStream::instance().stop();
 
         viewDispatcher_.removeView(VIEW_MENU);
         viewDispatcher_.removeView(VIEW_WATERFALL);
@@ -987,18 +1154,13 @@ private:
                     {
                         // Reset decoder state when entering
                         if (decoderView_ != nullptr) { decoderView_->reset(); }
-                        s_pulseHead = 0U;
-                        s_pulseCount = 0U;
-                        s_lastEdgeUs = 0;
                         sceneManager_->navigateTo(SCENE_DECODER);
                     }
                     break;
                 case 2U:
                     if (sceneManager_ != nullptr)
                     {
-                        s_pulseHead = 0U;
-                        s_pulseCount = 0U;
-                        s_lastEdgeUs = 0;
+                        if (pulseView_ != nullptr) { pulseView_->window().clear(); }
                         sceneManager_->navigateTo(SCENE_PULSE);
                     }
                     break;
@@ -1019,6 +1181,49 @@ private:
         }
     }
 
+    void handleWaterfallInput(InputManager::InputEvent input)
+    {
+        if (waterfallView_ == nullptr)
+        {
+            handleSubviewInput(input);
+            return;
+        }
+
+        if (waterfallView_->playing())
+        {
+            if (input == InputManager::InputEvent::LEFT)
+            {
+                waterfallView_->stopPlayback();
+            }
+            else
+            {
+                waterfallView_->playbackInput(input);
+            }
+            needsRedraw_ = true;
+            return;
+        }
+
+        switch (input)
+        {
+        case InputManager::InputEvent::RIGHT:
+            waterfallView_->toggleRecording();
+            needsRedraw_ = true;
+            break;
+        case InputManager::InputEvent::DOWN:
+            if (waterfallView_->startPlayback())
+            {
+                needsRedraw_ = true;
+            }
+            break;
+        case InputManager::InputEvent::LEFT:
+            waterfallView_->stopRecording();
+            handleSubviewInput(input);
+            break;
+        default:
+            break;
+        }
+    }
+
     void handleSubviewInput(InputManager::InputEvent input)
     {
         if (input == InputManager::InputEvent::LEFT)
@@ -9,8 +9,8 @@
 #include "core/event_system.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
-#include "hardware/storage.h"
 #include "hardware/wireless.h"
+#include "storage/vfs.h"
 #include "ui/widgets.h"
 
 static constexpr const char *TAG_WIFI = "WiFiToolsApp";
@@ -493,11 +493,6 @@ private:
             ESP_LOGW(TAG_WIFI, "saveApToSd: no AP selected");
             return;
         }
-        if (!StorageManager::instance().isMounted())
-        {
-            ESP_LOGW(TAG_WIFI, "saveApToSd: SD not mounted");
-            return;
-        }
 
         const Wireless::ApRecord &ap = aps[selectedApIndex_];
         char buf[128];
@@ -513,8 +508,8 @@ private:
 
         if (len > 0 && len < static_cast<int>(sizeof(buf)))
         {
-            const bool ok = StorageManager::instance().appendChunk(
-                "/captures/wifi_scan.txt",
+            const bool ok = hackos::storage::VirtualFS::instance().append(
+                "/ext/captures/wifi_scan.txt",
                 reinterpret_cast<const uint8_t *>(buf),
                 static_cast<size_t>(len));
             ESP_LOGI(TAG_WIFI, "saveApToSd: %s", ok ? "OK" : "FAIL");
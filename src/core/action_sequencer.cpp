@@ -0,0 +1,210 @@
+/**
+ * @file action_sequencer.cpp
+ * @brief Cooperative plugin op sequencer (see action_sequencer.h).
+ */
+
+#include "core/action_sequencer.h"
+
+namespace hackos::core {
+
+namespace {
+
+/// Signed distance from @p now to @p due on the wrapping µs clock.
+int32_t until(uint32_t due, uint32_t now)
+{
+    return static_cast<int32_t>(due - now);
+}
+
+} // namespace
+
+ActionSequencer::ActionSequencer(SeqBackend &backend)
+    : backend_(backend), tasks_{}, maxLateUs_(0U)
+{
+}
+
+int ActionSequencer::start(const SeqOp *ops, size_t count, uint16_t tag)
+{
+    if (ops == nullptr || count == 0U)
+    {
+        return INVALID;
+    }
+    for (size_t i = 0U; i < MAX_TASKS; ++i)
+    {
+        Task &t = tasks_[i];
+        if (t.busy)
+        {
+            continue;
+        }
+        t.ops = ops;
+        t.count = count;
+        t.pc = 0U;
+        t.due = backend_.nowUs();
+        t.tonePins = 0U;
+        t.tag = tag;
+        t.gen = static_cast<uint16_t>(t.gen + 1U);
+        t.busy = true;
+        return static_cast<int>(t.gen) * static_cast<int>(MAX_TASKS) + static_cast<int>(i);
+    }
+    return INVALID;
+}
+
+ActionSequencer::Task *ActionSequencer::lookup(int handle)
+{
+    return const_cast<Task *>(static_cast<const ActionSequencer *>(this)->lookup(handle));
+}
+
+const ActionSequencer::Task *ActionSequencer::lookup(int handle) const
+{
+    if (handle < 0)
+    {
+        return nullptr;
+    }
+    const Task &t = tasks_[static_cast<size_t>(handle) % MAX_TASKS];
+    const bool same = t.gen == static_cast<uint16_t>(static_cast<size_t>(handle) / MAX_TASKS);
+    return (t.busy && same) ? &t : nullptr;
+}
+
+void ActionSequencer::cancel(int handle)
+{
+    Task *t = lookup(handle);
+    if (t != nullptr)
+    {
+        stop(*t, true);
+    }
+}
+
+void ActionSequencer::cancelTag(uint16_t tag)
+{
+    for (Task &t : tasks_)
+    {
+        if (t.busy && t.tag == tag)
+        {
+            stop(t, true);
+        }
+    }
+}
+
+void ActionSequencer::cancelAll()
+{
+    for (Task &t : tasks_)
+    {
+        if (t.busy)
+        {
+            stop(t, true);
+        }
+    }
+}
+
+bool ActionSequencer::running(int handle) const
+{
+    return lookup(handle) != nullptr;
+}
+
+bool ActionSequencer::runningTag(uint16_t tag) const
+{
+    for (const Task &t : tasks_)
+    {
+        if (t.busy && t.tag == tag)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ActionSequencer::active() const
+{
+    size_t n = 0U;
+    for (const Task &t : tasks_)
+    {
+        n += t.busy ? 1U : 0U;
+    }
+    return n;
+}
+
+void ActionSequencer::stop(Task &t, bool silence)
+{
+    for (uint8_t pin = 0U; silence && t.tonePins != 0U; ++pin)
+    {
+        if ((t.tonePins & (1ULL << pin)) != 0U)
+        {
+            (void)backend_.tone(pin, 0U);
+            t.tonePins &= ~(1ULL << pin);
+        }
+    }
+    t.tonePins = 0U;
+    t.busy = false;
+}
+
+bool ActionSequencer::step(Task &t, uint32_t now)
+{
+    while (t.pc < t.count)
+    {
+        const SeqOp &op = t.ops[t.pc++];
+        switch (op.code)
+        {
+        case SeqOpCode::PIN_HIGH:
+            backend_.pinWrite(op.pin, true);
+            break;
+        case SeqOpCode::PIN_LOW:
+            backend_.pinWrite(op.pin, false);
+            break;
+        case SeqOpCode::PIN_TOGGLE:
+            backend_.pinWrite(op.pin, !backend_.pinLevel(op.pin));
+            break;
+        case SeqOpCode::TONE:
+            if (op.pin < 64U)
+            {
+                const uint64_t bit = 1ULL << op.pin;
+                const bool on = op.arg != 0U && backend_.tone(op.pin, op.arg);
+                if (op.arg == 0U)
+                {
+                    (void)backend_.tone(op.pin, 0U);
+                }
+                t.tonePins = on ? (t.tonePins | bit) : (t.tonePins & ~bit);
+            }
+            break;
+        case SeqOpCode::WAIT_US:
+            // From the previous deadline, so lateness does not accumulate.
+            t.due += op.arg;
+            if (until(t.due, now) > 0)
+            {
+                return true;
+            }
+            break;
+        case SeqOpCode::NOTE:
+            backend_.note(t.tag, op);
+            break;
+        }
+    }
+    stop(t, false);   // a tone left on at the end keeps sounding
+    return false;
+}
+
+uint32_t ActionSequencer::poll()
+{
+    const uint32_t now = backend_.nowUs();
+    uint32_t next = IDLE;
+    for (Task &t : tasks_)
+    {
+        if (!t.busy)
+        {
+            continue;
+        }
+        const int32_t wait = until(t.due, now);
+        if (wait <= 0)
+        {
+            const uint32_t late = static_cast<uint32_t>(-wait);
+            maxLateUs_ = (t.pc > 0U && late > maxLateUs_) ? late : maxLateUs_;
+            if (!step(t, now))
+            {
+                continue;
+            }
+        }
+        const uint32_t left = static_cast<uint32_t>(until(t.due, now));
+        next = (left < next) ? left : next;
+    }
+    return next;
+}
+
+} // namespace hackos::core
@@ -2,6 +2,7 @@
 
 #include <cstring>
 
+#include "core/scratch.h"
 #include "core/state_machine.h"
 #include "core/stealth_manager.h"
 #include "hardware/input.h"
@@ -168,4 +169,7 @@ void AppManager::destroyActiveApp()
     activeApp_->onDestroy();
     delete activeApp_;
     activeApp_ = nullptr;
+
+    // Per-tag scratch peaks of the session; anything still held leaked.
+    hackos::core::Scratch::instance().logStats();
 }
@@ -8,8 +8,7 @@ EventSystem &EventSystem::instance()
 
 EventSystem::EventSystem()
     : eventQueue_(nullptr),
-      observers_{nullptr},
-      observerCount_(0U)
+      observers_()
 {
 }
 
@@ -44,49 +43,23 @@ void EventSystem::dispatchPendingEvents()
     Event event{};
     while (xQueueReceive(eventQueue_, &event, 0) == pdTRUE)
     {
-        for (size_t i = 0; i < observerCount_; ++i)
+        for (size_t i = 0; i < observers_.size(); ++i)
         {
-            if (observers_[i] != nullptr)
-            {
-                observers_[i]->onEvent(&event);
-            }
+            observers_[i]->onEvent(&event);
         }
     }
 }
 
 bool EventSystem::subscribe(IEventObserver *observer)
 {
-    if (observer == nullptr || observerCount_ >= MAX_OBSERVERS)
+    if (observer == nullptr)
     {
         return false;
     }
-
-    for (size_t i = 0; i < observerCount_; ++i)
-    {
-        if (observers_[i] == observer)
-        {
-            return true;
-        }
-    }
-
-    observers_[observerCount_] = observer;
-    ++observerCount_;
-    return true;
+    return observers_.contains(observer) || observers_.push(observer);
 }
 
 void EventSystem::unsubscribe(const IEventObserver *observer)
 {
-    for (size_t i = 0; i < observerCount_; ++i)
-    {
-        if (observers_[i] == observer)
-        {
-            for (size_t j = i; j + 1U < observerCount_; ++j)
-            {
-                observers_[j] = observers_[j + 1U];
-            }
-            observers_[observerCount_ - 1U] = nullptr;
-            --observerCount_;
-            return;
-        }
-    }
+    (void)observers_.removeIf([observer](const IEventObserver *o) { return o == observer; });
 }
@@ -0,0 +1,202 @@
+/**
+ * @file ghostnet_espnow.cpp
+ * @brief ESP-NOW backend for the GhostNet device node.
+ *
+ * Uses ESP-NOW (connectionless 802.11 vendor action frames) as the link
+ * layer for GhostNetManager::instance().  All unicast frames are
+ * encrypted with a shared PMK/LMK key pair; notifications are forwarded
+ * to the EventSystem as EVT_GHOSTNET events.
+ */
+
+#include "core/ghostnet_manager.h"
+
+#include <cstring>
+
+#include <Arduino.h>
+#include <esp_log.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <WiFi.h>
+
+#include "core/event.h"
+#include "core/event_system.h"
+
+static constexpr const char *TAG_GN = "GhostNet";
+
+// ── Encryption keys (shared across all HackOS devices) ───────────────────────
+// PMK (Primary Master Key) – 16 bytes, used for ESP-NOW encryption.
+// LMK (Local Master Key) – 16 bytes, per-peer encryption key.
+static const uint8_t GHOSTNET_PMK[16] = {
+    0x48, 0x61, 0x63, 0x6B, 0x4F, 0x53, 0x5F, 0x47,
+    0x68, 0x6F, 0x73, 0x74, 0x4E, 0x65, 0x74, 0x31  // "HackOS_GhostNet1"
+};
+
+static const uint8_t GHOSTNET_LMK[16] = {
+    0x47, 0x4E, 0x5F, 0x4C, 0x4D, 0x4B, 0x5F, 0x4B,
+    0x65, 0x79, 0x5F, 0x48, 0x4F, 0x53, 0x31, 0x36  // "GN_LMK_Key_HOS16"
+};
+
+namespace hackos::core {
+
+namespace {
+
+class EspNowBackend final : public GhostNetBackend
+{
+public:
+    EspNowBackend() : owner_(nullptr) {}
+
+    bool begin(GhostNetManager &owner, uint8_t *ownMac) override
+    {
+        // Ensure WiFi is in STA mode (required for ESP-NOW).
+        WiFi.mode(WIFI_STA);
+        WiFi.disconnect();
+
+        // Read own MAC address.
+        esp_read_mac(ownMac, ESP_MAC_WIFI_STA);
+
+        // Initialise ESP-NOW.
+        if (esp_now_init() != ESP_OK)
+        {
+            ESP_LOGE(TAG_GN, "esp_now_init failed");
+            return false;
+        }
+
+        // Set PMK for encryption.
+        if (esp_now_set_pmk(GHOSTNET_PMK) != ESP_OK)
+        {
+            ESP_LOGW(TAG_GN, "Failed to set PMK – continuing unencrypted");
+        }
+
+        owner_ = &owner;
+
+        // Register callbacks.
+        esp_now_register_recv_cb(onDataRecv);
+        esp_now_register_send_cb(
+            [](const uint8_t * /*mac*/, esp_now_send_status_t status)
+            {
+                if (status != ESP_NOW_SEND_SUCCESS)
+                {
+                    ESP_LOGD(TAG_GN, "ESP-NOW send failed");
+                }
+            });
+
+        // Add broadcast peer so we can send beacons.
+        esp_now_peer_info_t bcastPeer;
+        std::memset(&bcastPeer, 0, sizeof(bcastPeer));
+        std::memcpy(bcastPeer.peer_addr, GHOST_BROADCAST_MAC, 6);
+        bcastPeer.channel = 0; // current channel
+        bcastPeer.encrypt = false;
+        if (!esp_now_is_peer_exist(GHOST_BROADCAST_MAC))
+        {
+            (void)esp_now_add_peer(&bcastPeer);
+        }
+
+        ESP_LOGI(TAG_GN, "GhostNet initialised – node HOS_%02X%02X",
+                 ownMac[4], ownMac[5]);
+        return true;
+    }
+
+    void end() override
+    {
+        esp_now_unregister_recv_cb();
+        esp_now_unregister_send_cb();
+        esp_now_deinit();
+        owner_ = nullptr;
+        ESP_LOGI(TAG_GN, "GhostNet deinitialised");
+    }
+
+    bool addPeer(const uint8_t *mac, bool encrypt) override
+    {
+        if (esp_now_is_peer_exist(mac))
+        {
+            return true;
+        }
+
+        esp_now_peer_info_t peerInfo;
+        std::memset(&peerInfo, 0, sizeof(peerInfo));
+        std::memcpy(peerInfo.peer_addr, mac, 6);
+        peerInfo.channel = 0;
+        peerInfo.encrypt = encrypt;
+        std::memcpy(peerInfo.lmk, GHOSTNET_LMK, 16);
+        return esp_now_add_peer(&peerInfo) == ESP_OK;
+    }
+
+    void removePeer(const uint8_t *mac) override
+    {
+        ESP_LOGI(TAG_GN, "Peer pruned (timeout): %02X:%02X:%02X",
+                 mac[3], mac[4], mac[5]);
+        (void)esp_now_del_peer(mac);
+    }
+
+    bool send(const uint8_t *mac, const uint8_t *data, size_t len) override
+    {
+        return esp_now_send(mac, data, len) == ESP_OK;
+    }
+
+    uint32_t nowMs() override { return millis(); }
+
+    void notify(GhostMsgType type, int32_t arg) override
+    {
+        switch (type)
+        {
+        case GhostMsgType::BEACON_ACK:
+            ESP_LOGI(TAG_GN, "Peer added (%ld active)", static_cast<long>(arg));
+            break;
+        case GhostMsgType::CHAT:
+            ESP_LOGI(TAG_GN, "Chat received");
+            break;
+        case GhostMsgType::SYNC_DATA:
+            ESP_LOGI(TAG_GN, "Sync data received (%ld bytes)", static_cast<long>(arg));
+            break;
+        case GhostMsgType::CMD_REQUEST:
+            ESP_LOGI(TAG_GN, "Command received: 0x%02lX",
+                     static_cast<unsigned long>(arg));
+            break;
+        default:
+            break;
+        }
+
+        const Event evt{EventType::EVT_GHOSTNET, static_cast<int32_t>(type),
+                        arg, nullptr};
+        EventSystem::instance().postEvent(evt);
+    }
+
+private:
+    static void onDataRecv(const uint8_t *mac, const uint8_t *data, int len);
+
+    GhostNetManager *owner_;
+};
+
+EspNowBackend &espNowBackend()
+{
+    static EspNowBackend backend;
+    return backend;
+}
+
+void EspNowBackend::onDataRecv(const uint8_t *mac, const uint8_t *data, int len)
+{
+    GhostNetManager *owner = espNowBackend().owner_;
+    if (owner == nullptr)
+    {
+        return;
+    }
+
+    // Approximate RSSI – ESP-NOW does not expose RSSI directly in this
+    // callback, so we use a medium-range placeholder.  Real RSSI can be
+    // obtained by hooking the WiFi promiscuous callback, which is left
+    // for a future enhancement.
+    constexpr int8_t estimatedRssi = -70;
+    owner->onReceive(mac, data, len, estimatedRssi);
+}
+
+} // namespace
+
+// ── Singleton ────────────────────────────────────────────────────────────────
+
+GhostNetManager &GhostNetManager::instance()
+{
+    static GhostNetManager inst(espNowBackend());
+    return inst;
+}
+
+} // namespace hackos::core
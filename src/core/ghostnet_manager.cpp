@@ -1,10 +1,12 @@
 /**
  * @file ghostnet_manager.cpp
- * @brief GhostNet ESP-NOW mesh manager implementation.
+ * @brief GhostNet mesh protocol implementation.
  *
- * Uses ESP-NOW (connectionless 802.11 vendor action frames) to build a
- * zero-configuration mesh network between HackOS devices.  All frames
- * are encrypted with a shared PMK/LMK key pair.
+ * Peer discovery, chat, data sync and remote execution logic.  This file
+ * is platform-independent: every radio operation, the clock and all UI
+ * notifications go through the GhostNetBackend the manager was built
+ * with, so the same code runs on the device (ESP-NOW backend) and inside
+ * the host-side GhostNetSimulator.
  *
  * @warning **Legal notice**: Coordinated wireless attacks against
  * networks or devices you do not own or have explicit written
@@ -16,49 +18,19 @@
 #include <cstring>
 #include <cstdio>
 
-#include <Arduino.h>
-#include <esp_log.h>
-#include <esp_now.h>
-#include <esp_wifi.h>
-#include <WiFi.h>
-
-#include "core/event.h"
-#include "core/event_system.h"
-
-static constexpr const char *TAG_GN = "GhostNet";
-
-// ── Encryption keys (shared across all HackOS devices) ───────────────────────
-// PMK (Primary Master Key) – 16 bytes, used for ESP-NOW encryption.
-// LMK (Local Master Key) – 16 bytes, per-peer encryption key.
-static const uint8_t GHOSTNET_PMK[16] = {
-    0x48, 0x61, 0x63, 0x6B, 0x4F, 0x53, 0x5F, 0x47,
-    0x68, 0x6F, 0x73, 0x74, 0x4E, 0x65, 0x74, 0x31  // "HackOS_GhostNet1"
-};
-
-static const uint8_t GHOSTNET_LMK[16] = {
-    0x47, 0x4E, 0x5F, 0x4C, 0x4D, 0x4B, 0x5F, 0x4B,
-    0x65, 0x79, 0x5F, 0x48, 0x4F, 0x53, 0x31, 0x36  // "GN_LMK_Key_HOS16"
-};
-
-/// Broadcast MAC for discovery beacons.
-static const uint8_t BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-
 namespace hackos::core {
 
-// ── Singleton ────────────────────────────────────────────────────────────────
+// ── Construction ─────────────────────────────────────────────────────────────
 
-GhostNetManager &GhostNetManager::instance()
-{
-    static GhostNetManager inst;
-    return inst;
-}
-
-GhostNetManager::GhostNetManager()
-    : initialized_(false)
+GhostNetManager::GhostNetManager(GhostNetBackend &backend)
+    : backend_(backend)
+    , initialized_(false)
     , seqNo_(0U)
     , chatHead_(0U)
     , chatCount_(0U)
     , lastCmd_(GhostCmd::NONE)
+    , serviceHandler_(nullptr)
+    , serviceDispatches_(0U)
     , lastBeaconMs_(0U)
 {
     std::memset(nodeName_, 0, sizeof(nodeName_));
@@ -76,53 +48,17 @@ bool GhostNetManager::init()
         return true;
     }
 
-    // Ensure WiFi is in STA mode (required for ESP-NOW).
-    WiFi.mode(WIFI_STA);
-    WiFi.disconnect();
-
-    // Read own MAC address.
-    esp_read_mac(ownMac_, ESP_MAC_WIFI_STA);
-
-    // Generate a short node name from the last 2 bytes of MAC.
-    std::snprintf(nodeName_, sizeof(nodeName_), "HOS_%02X%02X",
-                  ownMac_[4], ownMac_[5]);
-
-    // Initialise ESP-NOW.
-    if (esp_now_init() != ESP_OK)
+    if (!backend_.begin(*this, ownMac_))
     {
-        ESP_LOGE(TAG_GN, "esp_now_init failed");
         return false;
     }
 
-    // Set PMK for encryption.
-    if (esp_now_set_pmk(GHOSTNET_PMK) != ESP_OK)
-    {
-        ESP_LOGW(TAG_GN, "Failed to set PMK – continuing unencrypted");
-    }
-
-    // Register callbacks.
-    esp_now_register_recv_cb(onDataRecv);
-    esp_now_register_send_cb(
-        [](const uint8_t *mac, esp_now_send_status_t status)
-        {
-            onDataSent(mac, status == ESP_NOW_SEND_SUCCESS);
-        });
-
-    // Add broadcast peer so we can send beacons.
-    esp_now_peer_info_t bcastPeer;
-    std::memset(&bcastPeer, 0, sizeof(bcastPeer));
-    std::memcpy(bcastPeer.peer_addr, BROADCAST_MAC, 6);
-    bcastPeer.channel = 0; // current channel
-    bcastPeer.encrypt = false;
-    if (!esp_now_is_peer_exist(BROADCAST_MAC))
-    {
-        (void)esp_now_add_peer(&bcastPeer);
-    }
+    // Generate a short node name from the last 2 bytes of MAC.
+    std::snprintf(nodeName_, sizeof(nodeName_), "HOS_%02X%02X",
+                  ownMac_[4], ownMac_[5]);
 
     initialized_ = true;
-    lastBeaconMs_ = millis();
-
-    ESP_LOGI(TAG_GN, "GhostNet initialised – node %s", nodeName_);
+    lastBeaconMs_ = backend_.nowMs();
     return true;
 }
 
@@ -133,9 +69,7 @@ void GhostNetManager::deinit()
         return;
     }
 
-    esp_now_unregister_recv_cb();
-    esp_now_unregister_send_cb();
-    esp_now_deinit();
+    backend_.end();
 
     // Clear peer list.
     for (size_t i = 0U; i < MAX_PEERS; ++i)
@@ -144,7 +78,6 @@ void GhostNetManager::deinit()
     }
 
     initialized_ = false;
-    ESP_LOGI(TAG_GN, "GhostNet deinitialised");
 }
 
 // ── Periodic tick ────────────────────────────────────────────────────────────
@@ -156,7 +89,7 @@ void GhostNetManager::tick()
         return;
     }
 
-    const uint32_t now = millis();
+    const uint32_t now = backend_.nowMs();
 
     // Periodic beacon.
     if ((now - lastBeaconMs_) >= BEACON_INTERVAL_MS)
@@ -196,7 +129,7 @@ const GhostPeer *GhostNetManager::peer(size_t index) const
 bool GhostNetManager::addOrUpdatePeer(const uint8_t *mac, int8_t rssi,
                                        const char *name)
 {
-    const uint32_t now = millis();
+    const uint32_t now = backend_.nowMs();
 
     // Check if peer already exists.
     for (size_t i = 0U; i < MAX_PEERS; ++i)
@@ -235,46 +168,27 @@ bool GhostNetManager::addOrUpdatePeer(const uint8_t *mac, int8_t rssi,
                               "%02X%02X%02X", mac[3], mac[4], mac[5]);
             }
 
-            // Register with ESP-NOW (encrypted).
-            esp_now_peer_info_t peerInfo;
-            std::memset(&peerInfo, 0, sizeof(peerInfo));
-            std::memcpy(peerInfo.peer_addr, mac, 6);
-            peerInfo.channel = 0;
-            peerInfo.encrypt = true;
-            std::memcpy(peerInfo.lmk, GHOSTNET_LMK, 16);
-
-            if (!esp_now_is_peer_exist(mac))
-            {
-                (void)esp_now_add_peer(&peerInfo);
-            }
-
-            ESP_LOGI(TAG_GN, "Peer added: %s (RSSI %d)", peers_[i].name,
-                     rssi);
-
-            // Post GhostNet event.
-            const Event evt{EventType::EVT_GHOSTNET,
-                            static_cast<int32_t>(GhostMsgType::BEACON_ACK),
-                            static_cast<int32_t>(peerCount()), nullptr};
-            EventSystem::instance().postEvent(evt);
+            // Register with the link layer (encrypted).
+            (void)backend_.addPeer(mac, true);
 
+            backend_.notify(GhostMsgType::BEACON_ACK,
+                            static_cast<int32_t>(peerCount()));
             return true;
         }
     }
 
-    ESP_LOGW(TAG_GN, "Peer table full (%zu slots)", MAX_PEERS);
-    return false;
+    return false; // Peer table full.
 }
 
 void GhostNetManager::pruneStale()
 {
-    const uint32_t now = millis();
+    const uint32_t now = backend_.nowMs();
     for (size_t i = 0U; i < MAX_PEERS; ++i)
     {
         if (peers_[i].active &&
             (now - peers_[i].lastSeenMs) > PEER_TIMEOUT_MS)
         {
-            ESP_LOGI(TAG_GN, "Peer pruned (timeout): %s", peers_[i].name);
-            (void)esp_now_del_peer(peers_[i].mac);
+            backend_.removePeer(peers_[i].mac);
             peers_[i].active = false;
         }
     }
@@ -289,6 +203,22 @@ void GhostNetManager::sendBeacon()
 
 // ── Chat ─────────────────────────────────────────────────────────────────────
 
+void GhostNetManager::pushChat(const char *sender, const char *text, size_t len)
+{
+    GhostChatMsg &msg = chatRing_[chatHead_];
+    std::strncpy(msg.sender, sender, sizeof(msg.sender) - 1U);
+    msg.sender[sizeof(msg.sender) - 1U] = '\0';
+    const size_t copyLen = (len < sizeof(msg.text) - 1U) ? len : sizeof(msg.text) - 1U;
+    std::memcpy(msg.text, text, copyLen);
+    msg.text[copyLen] = '\0';
+    msg.timestampMs = backend_.nowMs();
+    chatHead_ = (chatHead_ + 1U) % CHAT_RING_SIZE;
+    if (chatCount_ < CHAT_RING_SIZE)
+    {
+        ++chatCount_;
+    }
+}
+
 bool GhostNetManager::sendChat(const char *text)
 {
     if (text == nullptr || text[0] == '\0')
@@ -300,17 +230,7 @@ bool GhostNetManager::sendChat(const char *text)
     const size_t sendLen = (textLen < GHOST_MAX_PAYLOAD) ? textLen : GHOST_MAX_PAYLOAD;
 
     // Store locally in the ring buffer.
-    GhostChatMsg &msg = chatRing_[chatHead_];
-    std::strncpy(msg.sender, nodeName_, sizeof(msg.sender) - 1U);
-    msg.sender[sizeof(msg.sender) - 1U] = '\0';
-    std::strncpy(msg.text, text, sizeof(msg.text) - 1U);
-    msg.text[sizeof(msg.text) - 1U] = '\0';
-    msg.timestampMs = millis();
-    chatHead_ = (chatHead_ + 1U) % CHAT_RING_SIZE;
-    if (chatCount_ < CHAT_RING_SIZE)
-    {
-        ++chatCount_;
-    }
+    pushChat(nodeName_, text, textLen);
 
     return sendPacket(GhostMsgType::CHAT,
                       reinterpret_cast<const uint8_t *>(text), sendLen);
@@ -347,9 +267,7 @@ bool GhostNetManager::syncData(const char *dataType,
     const size_t totalLen = 1U + typeLen + len;
     if (totalLen > GHOST_MAX_PAYLOAD)
     {
-        ESP_LOGW(TAG_GN, "Sync payload too large (%zu > %zu)",
-                 totalLen, GHOST_MAX_PAYLOAD);
-        return false;
+        return false; // payload too large for one frame
     }
 
     uint8_t buf[250];
@@ -368,10 +286,39 @@ bool GhostNetManager::sendCommand(GhostCmd cmd)
     return sendPacket(GhostMsgType::CMD_REQUEST, &cmdByte, 1U);
 }
 
+// ── Service messages ─────────────────────────────────────────────────────────
+
+void GhostNetManager::setServiceHandler(GhostServiceHandler *handler)
+{
+    serviceHandler_.store(handler);
+    if (handler != nullptr)
+    {
+        return;
+    }
+
+    // A dispatch that loaded the old handler is still inside it.  Handlers
+    // only queue the message (microseconds), and the radio task outranks
+    // every caller, so a plain spin is enough.
+    while (serviceDispatches_.load() != 0U)
+    {
+    }
+}
+
+bool GhostNetManager::sendService(GhostMsgType type, const uint8_t *payload,
+                                  size_t len, const uint8_t *dstMac)
+{
+    if (static_cast<uint8_t>(type) < GHOST_SERVICE_TYPE_MIN)
+    {
+        return false;
+    }
+    return sendPacket(type, payload, len, dstMac);
+}
+
 // ── Packet assembly and transmission ─────────────────────────────────────────
 
 bool GhostNetManager::sendPacket(GhostMsgType type,
-                                  const uint8_t *payload, size_t len)
+                                  const uint8_t *payload, size_t len,
+                                  const uint8_t *dstMac)
 {
     if (!initialized_)
     {
@@ -405,9 +352,12 @@ bool GhostNetManager::sendPacket(GhostMsgType type,
     // Send to broadcast (discovery) or unicast per peer depending on type.
     if (type == GhostMsgType::BEACON)
     {
-        // Broadcast beacon.
-        const esp_err_t err = esp_now_send(BROADCAST_MAC, buf, totalLen);
-        return (err == ESP_OK);
+        return backend_.send(GHOST_BROADCAST_MAC, buf, totalLen);
+    }
+
+    if (dstMac != nullptr)
+    {
+        return backend_.send(dstMac, buf, totalLen);
     }
 
     // Unicast to each known peer.
@@ -416,8 +366,7 @@ bool GhostNetManager::sendPacket(GhostMsgType type,
     {
         if (peers_[i].active)
         {
-            const esp_err_t err = esp_now_send(peers_[i].mac, buf, totalLen);
-            if (err != ESP_OK)
+            if (!backend_.send(peers_[i].mac, buf, totalLen))
             {
                 allOk = false;
             }
@@ -426,40 +375,18 @@ bool GhostNetManager::sendPacket(GhostMsgType type,
     return allOk;
 }
 
-// ── ESP-NOW callbacks ────────────────────────────────────────────────────────
+// ── Packet processing ────────────────────────────────────────────────────────
 
-void GhostNetManager::onDataRecv(const uint8_t *mac,
-                                  const uint8_t *data, int len)
+void GhostNetManager::onReceive(const uint8_t *mac,
+                                 const uint8_t *data, int len,
+                                 int8_t rssi)
 {
-    if (mac == nullptr || data == nullptr ||
+    if (!initialized_ || mac == nullptr || data == nullptr ||
         len < static_cast<int>(GHOST_HEADER_SIZE))
     {
         return;
     }
 
-    auto &mgr = instance();
-    // Approximate RSSI – ESP-NOW does not expose RSSI directly in this
-    // callback, so we use a medium-range placeholder.  Real RSSI can be
-    // obtained by hooking the WiFi promiscuous callback, which is left
-    // for a future enhancement.
-    constexpr int8_t estimatedRssi = -70;
-    mgr.handlePacket(mac, data, len, estimatedRssi);
-}
-
-void GhostNetManager::onDataSent(const uint8_t * /*mac*/, bool success)
-{
-    if (!success)
-    {
-        ESP_LOGD(TAG_GN, "ESP-NOW send failed");
-    }
-}
-
-// ── Packet processing ────────────────────────────────────────────────────────
-
-void GhostNetManager::handlePacket(const uint8_t *mac,
-                                    const uint8_t *data, int len,
-                                    int8_t rssi)
-{
     const auto *pkt = reinterpret_cast<const GhostPacket *>(data);
 
     // Validate magic.
@@ -492,51 +419,24 @@ void GhostNetManager::handlePacket(const uint8_t *mac,
     {
         // Reply with a beacon ACK so the sender knows about us.
         (void)sendPacket(GhostMsgType::BEACON_ACK, nullptr, 0U);
-        ESP_LOGD(TAG_GN, "Beacon from %s", pkt->srcName);
         break;
     }
 
     case GhostMsgType::BEACON_ACK:
-    {
-        ESP_LOGD(TAG_GN, "Beacon ACK from %s", pkt->srcName);
         break;
-    }
 
     case GhostMsgType::CHAT:
     {
-        // Store in ring buffer.
-        GhostChatMsg &msg = chatRing_[chatHead_];
-        std::strncpy(msg.sender, pkt->srcName, sizeof(msg.sender) - 1U);
-        msg.sender[sizeof(msg.sender) - 1U] = '\0';
-        const size_t copyLen = (pkt->payloadLen < sizeof(msg.text) - 1U)
-                                   ? pkt->payloadLen
-                                   : sizeof(msg.text) - 1U;
-        std::memcpy(msg.text, payload, copyLen);
-        msg.text[copyLen] = '\0';
-        msg.timestampMs = millis();
-        chatHead_ = (chatHead_ + 1U) % CHAT_RING_SIZE;
-        if (chatCount_ < CHAT_RING_SIZE)
-        {
-            ++chatCount_;
-        }
-
-        ESP_LOGI(TAG_GN, "Chat from %s: %s", msg.sender, msg.text);
-
-        // Post event for the UI.
-        const Event evt{EventType::EVT_GHOSTNET,
-                        static_cast<int32_t>(GhostMsgType::CHAT),
-                        0, nullptr};
-        EventSystem::instance().postEvent(evt);
+        pushChat(pkt->srcName, reinterpret_cast<const char *>(payload),
+                 pkt->payloadLen);
+        backend_.notify(GhostMsgType::CHAT, 0);
         break;
     }
 
     case GhostMsgType::SYNC_DATA:
     {
-        ESP_LOGI(TAG_GN, "Sync data received (%u bytes)", pkt->payloadLen);
-        const Event evt{EventType::EVT_GHOSTNET,
-                        static_cast<int32_t>(GhostMsgType::SYNC_DATA),
-                        static_cast<int32_t>(pkt->payloadLen), nullptr};
-        EventSystem::instance().postEvent(evt);
+        backend_.notify(GhostMsgType::SYNC_DATA,
+                        static_cast<int32_t>(pkt->payloadLen));
         break;
     }
 
@@ -545,28 +445,35 @@ void GhostNetManager::handlePacket(const uint8_t *mac,
         if (pkt->payloadLen >= 1U)
         {
             lastCmd_ = static_cast<GhostCmd>(payload[0]);
-            ESP_LOGI(TAG_GN, "Command received: 0x%02X from %s",
-                     payload[0], pkt->srcName);
 
             // Acknowledge receipt.
             const uint8_t ack = payload[0];
             (void)sendPacket(GhostMsgType::CMD_ACK, &ack, 1U);
 
-            const Event evt{EventType::EVT_GHOSTNET,
-                            static_cast<int32_t>(GhostMsgType::CMD_REQUEST),
-                            static_cast<int32_t>(lastCmd_), nullptr};
-            EventSystem::instance().postEvent(evt);
+            backend_.notify(GhostMsgType::CMD_REQUEST,
+                            static_cast<int32_t>(lastCmd_));
         }
         break;
     }
 
     case GhostMsgType::CMD_ACK:
-    {
-        ESP_LOGD(TAG_GN, "Command ACK from %s", pkt->srcName);
         break;
-    }
 
     default:
+        if (static_cast<uint8_t>(pkt->type) >= GHOST_SERVICE_TYPE_MIN)
+        {
+            // Count ourselves in before loading the handler: a concurrent
+            // setServiceHandler(nullptr) then either hides the handler from
+            // us or waits for the count to drop (both seq_cst).
+            serviceDispatches_.fetch_add(1U);
+            GhostServiceHandler *handler = serviceHandler_.load();
+            if (handler != nullptr)
+            {
+                handler->onServiceMessage(mac, pkt->type, payload,
+                                          pkt->payloadLen);
+            }
+            serviceDispatches_.fetch_sub(1U);
+        }
         break;
     }
 }
@@ -0,0 +1,699 @@
+/**
+ * @file ghostnet_sim.cpp
+ * @brief GhostNetSimulator – virtual ESP-NOW medium for N GhostNet nodes.
+ *
+ * Time is virtual and advances in 1 ms steps; nodes are ticked at the
+ * configured loop period.  Frames are delivered in order of arrival time
+ * (ties broken by transmission order).  CPU time is measured with the
+ * host steady clock around every call into a node.
+ */
+
+#include "core/ghostnet_sim.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace hackos::core {
+
+namespace {
+
+/// Sync data type tag used by sendSync().
+static constexpr const char *SIM_SYNC_TYPE = "SIM";
+static constexpr size_t SIM_SYNC_TYPE_LEN = 3U;
+
+/// Prefix that tags chat messages with a tracking id.
+static constexpr const char *SIM_CHAT_PREFIX = "#sim";
+static constexpr size_t SIM_CHAT_PREFIX_LEN = 4U;
+
+static const GhostSimLink LINK_DOWN = {false, 0U, 0U, 0};
+
+uint64_t hostMicros()
+{
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Per-node backend
+// ═══════════════════════════════════════════════════════════════════════════════
+
+class GhostNetSimulator::NodeBackend final : public GhostNetBackend
+{
+public:
+    NodeBackend(GhostNetSimulator &sim, size_t index)
+        : sim_(sim), index_(index), mac_{0x02U, 'S', 'I', 'M', 0U, 0U}
+    {
+        mac_[4] = static_cast<uint8_t>(index >> 8);
+        mac_[5] = static_cast<uint8_t>(index & 0xFFU);
+    }
+
+    bool begin(GhostNetManager & /*owner*/, uint8_t *ownMac) override
+    {
+        std::memcpy(ownMac, mac_, sizeof(mac_));
+        return true;
+    }
+
+    void end() override {}
+
+    bool addPeer(const uint8_t * /*mac*/, bool /*encrypt*/) override { return true; }
+
+    void removePeer(const uint8_t * /*mac*/) override {}
+
+    bool send(const uint8_t *mac, const uint8_t *data, size_t len) override
+    {
+        return sim_.transmit(index_, mac, data, len);
+    }
+
+    uint32_t nowMs() override { return sim_.nowMs_; }
+
+    void notify(GhostMsgType type, int32_t arg) override
+    {
+        sim_.notify(index_, type, arg);
+    }
+
+    const uint8_t *mac() const { return mac_; }
+
+private:
+    GhostNetSimulator &sim_;
+    size_t index_;
+    uint8_t mac_[6];
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// In-flight frame
+// ═══════════════════════════════════════════════════════════════════════════════
+
+struct GhostNetSimulator::InFlight
+{
+    uint32_t deliverAtMs;
+    uint32_t seq;
+    uint8_t  from;
+    uint8_t  to;
+    uint8_t  len;
+    uint8_t  data[250];
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Construction
+// ═══════════════════════════════════════════════════════════════════════════════
+
+GhostNetSimulator::GhostNetSimulator(const GhostSimConfig &config)
+    : ready_(false),
+      config_(config),
+      nodeCount_(config.nodeCount < MAX_NODES ? config.nodeCount : MAX_NODES),
+      nowMs_(0U),
+      startMs_(0U),
+      rng_(config.seed != 0U ? config.seed : 1U),
+      backends_{},
+      nodes_{},
+      bootAtMs_{},
+      stats_{},
+      links_(nullptr),
+      inFlight_(nullptr),
+      inFlightCount_(0U),
+      txSeq_(0U),
+      airBusyUntilUs_(0U),
+      airBusyTotalUs_(0U),
+      airtimeDrops_(0U),
+      converged_(false),
+      convergedAtMs_(0U),
+      chats_{},
+      nextChatId_(1U),
+      chatsSent_(0U),
+      chatDeliveries_(0U),
+      chatLatencySumMs_(0U),
+      chatLatencyMaxMs_(0U),
+      syncBytesSent_(0U),
+      syncBytesDelivered_(0U)
+{
+    if (nodeCount_ == 0U || config_.bitRate == 0U)
+    {
+        return;
+    }
+
+    links_ = new (std::nothrow) GhostSimLink[nodeCount_ * nodeCount_];
+    inFlight_ = new (std::nothrow) InFlight[MAX_IN_FLIGHT];
+    if (links_ == nullptr || inFlight_ == nullptr)
+    {
+        return;
+    }
+
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        backends_[i] = new (std::nothrow) NodeBackend(*this, i);
+        if (backends_[i] == nullptr)
+        {
+            return;
+        }
+        nodes_[i] = new (std::nothrow) GhostNetManager(*backends_[i]);
+        if (nodes_[i] == nullptr)
+        {
+            return;
+        }
+    }
+
+    setTopology(GhostSimTopology::FULL_MESH);
+    ready_ = true;
+}
+
+GhostNetSimulator::~GhostNetSimulator()
+{
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        delete nodes_[i];
+        delete backends_[i];
+    }
+    delete[] links_;
+    delete[] inFlight_;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Topology
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void GhostNetSimulator::setTopology(GhostSimTopology topology)
+{
+    if (links_ == nullptr)
+    {
+        return;
+    }
+
+    const GhostSimLink up = {true, config_.defaultLossPct, config_.defaultLatencyMs,
+                             config_.defaultRssi};
+
+    size_t side = 1U;
+    while (side * side < nodeCount_)
+    {
+        ++side;
+    }
+
+    for (size_t a = 0U; a < nodeCount_; ++a)
+    {
+        for (size_t b = 0U; b < nodeCount_; ++b)
+        {
+            bool connected = false;
+            if (a != b)
+            {
+                switch (topology)
+                {
+                case GhostSimTopology::FULL_MESH:
+                    connected = true;
+                    break;
+                case GhostSimTopology::LINE:
+                    connected = (a + 1U == b) || (b + 1U == a);
+                    break;
+                case GhostSimTopology::RING:
+                    connected = (a + 1U == b) || (b + 1U == a) ||
+                                ((a + 1U) % nodeCount_ == b) ||
+                                ((b + 1U) % nodeCount_ == a);
+                    break;
+                case GhostSimTopology::GRID:
+                {
+                    const size_t ax = a % side;
+                    const size_t ay = a / side;
+                    const size_t bx = b % side;
+                    const size_t by = b / side;
+                    const size_t dx = (ax > bx) ? ax - bx : bx - ax;
+                    const size_t dy = (ay > by) ? ay - by : by - ay;
+                    connected = (dx + dy) == 1U;
+                    break;
+                }
+                case GhostSimTopology::STAR:
+                    connected = (a == 0U) || (b == 0U);
+                    break;
+                }
+            }
+            links_[a * nodeCount_ + b] = connected ? up : LINK_DOWN;
+        }
+    }
+}
+
+void GhostNetSimulator::setLink(size_t from, size_t to, const GhostSimLink &link)
+{
+    if (links_ == nullptr || from >= nodeCount_ || to >= nodeCount_ || from == to)
+    {
+        return;
+    }
+    links_[from * nodeCount_ + to] = link;
+}
+
+void GhostNetSimulator::setLinkBoth(size_t a, size_t b, const GhostSimLink &link)
+{
+    setLink(a, b, link);
+    setLink(b, a, link);
+}
+
+const GhostSimLink &GhostNetSimulator::link(size_t from, size_t to) const
+{
+    if (links_ == nullptr || from >= nodeCount_ || to >= nodeCount_)
+    {
+        return LINK_DOWN;
+    }
+    return links_[from * nodeCount_ + to];
+}
+
+size_t GhostNetSimulator::expectedPeers(size_t index) const
+{
+    size_t count = 0U;
+    for (size_t j = 0U; j < nodeCount_; ++j)
+    {
+        const GhostSimLink &l = link(j, index);
+        if (j != index && l.up && l.lossPct < 100U)
+        {
+            ++count;
+        }
+    }
+    return (count < GhostNetManager::MAX_PEERS) ? count : GhostNetManager::MAX_PEERS;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Scenario control
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void GhostNetSimulator::start()
+{
+    if (!ready_)
+    {
+        return;
+    }
+
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        nodes_[i]->deinit();
+        const uint32_t jitter = (config_.bootSpreadMs > 0U)
+                                    ? (nextRandom() % config_.bootSpreadMs)
+                                    : 0U;
+        bootAtMs_[i] = nowMs_ + jitter;
+        std::memset(&stats_[i], 0, sizeof(stats_[i]));
+    }
+
+    inFlightCount_ = 0U;
+    airBusyUntilUs_ = static_cast<uint64_t>(nowMs_) * 1000U;
+    converged_ = false;
+    convergedAtMs_ = 0U;
+    resetMetrics();
+}
+
+void GhostNetSimulator::resetMetrics()
+{
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        stats_[i].framesTx = 0U;
+        stats_[i].framesRx = 0U;
+        stats_[i].framesLost = 0U;
+        stats_[i].cpuUs = 0U;
+    }
+
+    startMs_ = nowMs_;
+    airBusyTotalUs_ = 0U;
+    airtimeDrops_ = 0U;
+    std::memset(chats_, 0, sizeof(chats_));
+    chatsSent_ = 0U;
+    chatDeliveries_ = 0U;
+    chatLatencySumMs_ = 0U;
+    chatLatencyMaxMs_ = 0U;
+    syncBytesSent_ = 0U;
+    syncBytesDelivered_ = 0U;
+}
+
+void GhostNetSimulator::runFor(uint32_t durationMs, uint32_t tickMs)
+{
+    if (!ready_)
+    {
+        return;
+    }
+    if (tickMs == 0U)
+    {
+        tickMs = 1U;
+    }
+
+    for (uint32_t step = 0U; step < durationMs; ++step)
+    {
+        ++nowMs_;
+
+        for (size_t i = 0U; i < nodeCount_; ++i)
+        {
+            if (!nodes_[i]->isActive() && nowMs_ >= bootAtMs_[i])
+            {
+                const uint64_t t0 = hostMicros();
+                (void)nodes_[i]->init();
+                stats_[i].cpuUs += hostMicros() - t0;
+            }
+        }
+
+        deliverDue();
+
+        if (((nowMs_ - startMs_) % tickMs) == 0U)
+        {
+            for (size_t i = 0U; i < nodeCount_; ++i)
+            {
+                if (nodes_[i]->isActive())
+                {
+                    const uint64_t t0 = hostMicros();
+                    nodes_[i]->tick();
+                    stats_[i].cpuUs += hostMicros() - t0;
+                }
+            }
+        }
+
+        checkConvergence();
+    }
+}
+
+bool GhostNetSimulator::runUntilConverged(uint32_t timeoutMs, uint32_t tickMs)
+{
+    static constexpr uint32_t STEP_MS = 100U;
+    uint32_t elapsed = 0U;
+    while (!converged_ && elapsed < timeoutMs)
+    {
+        const uint32_t step = (timeoutMs - elapsed < STEP_MS) ? (timeoutMs - elapsed) : STEP_MS;
+        runFor(step, tickMs);
+        elapsed += step;
+    }
+    return converged_;
+}
+
+bool GhostNetSimulator::sendChat(size_t from, const char *text)
+{
+    if (!ready_ || from >= nodeCount_ || text == nullptr)
+    {
+        return false;
+    }
+
+    const uint32_t id = nextChatId_++;
+    TrackedChat &slot = chats_[id % MAX_TRACKED_CHATS];
+    slot.id = id;
+    slot.sentMs = nowMs_;
+
+    char tagged[sizeof(GhostChatMsg::text)];
+    std::snprintf(tagged, sizeof(tagged), "%s%lu %s", SIM_CHAT_PREFIX,
+                  static_cast<unsigned long>(id), text);
+
+    ++chatsSent_;
+    const uint64_t t0 = hostMicros();
+    const bool ok = nodes_[from]->sendChat(tagged);
+    stats_[from].cpuUs += hostMicros() - t0;
+    return ok;
+}
+
+size_t GhostNetSimulator::sendSync(size_t from, size_t totalBytes)
+{
+    if (!ready_ || from >= nodeCount_)
+    {
+        return 0U;
+    }
+
+    static constexpr size_t CHUNK = GHOST_MAX_PAYLOAD - 1U - SIM_SYNC_TYPE_LEN;
+    uint8_t chunk[CHUNK];
+    for (size_t i = 0U; i < CHUNK; ++i)
+    {
+        chunk[i] = static_cast<uint8_t>(i);
+    }
+
+    size_t frames = 0U;
+    size_t remaining = totalBytes;
+    while (remaining > 0U)
+    {
+        const size_t n = (remaining < CHUNK) ? remaining : CHUNK;
+        const uint64_t t0 = hostMicros();
+        const bool ok = nodes_[from]->syncData(SIM_SYNC_TYPE, chunk, n);
+        stats_[from].cpuUs += hostMicros() - t0;
+        if (ok)
+        {
+            ++frames;
+            syncBytesSent_ += static_cast<uint32_t>(n);
+        }
+        remaining -= n;
+    }
+    return frames;
+}
+
+GhostNetManager *GhostNetSimulator::node(size_t index)
+{
+    return (index < nodeCount_) ? nodes_[index] : nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Medium
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int GhostNetSimulator::findNode(const uint8_t *mac) const
+{
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        if (std::memcmp(backends_[i]->mac(), mac, 6U) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool GhostNetSimulator::transmit(size_t from, const uint8_t *mac,
+                                 const uint8_t *data, size_t len)
+{
+    if (mac == nullptr || data == nullptr || len == 0U || len > sizeof(InFlight::data))
+    {
+        return false;
+    }
+
+    ++stats_[from].framesTx;
+
+    // ── Airtime: frames serialise on the shared channel ──────────────────
+    const uint64_t nowUs = static_cast<uint64_t>(nowMs_) * 1000U;
+    uint64_t txEndUs = nowUs;
+    if (config_.maxBacklogMs > 0U)
+    {
+        const uint64_t airUs = config_.frameOverheadUs +
+                               (static_cast<uint64_t>(len) * 8U * 1000000U) / config_.bitRate;
+        const uint64_t startUs = (airBusyUntilUs_ > nowUs) ? airBusyUntilUs_ : nowUs;
+        if (startUs - nowUs > static_cast<uint64_t>(config_.maxBacklogMs) * 1000U)
+        {
+            ++airtimeDrops_;
+            return false; // TX queue full – esp_now_send() fails with NO_MEM
+        }
+        airBusyUntilUs_ = startUs + airUs;
+        airBusyTotalUs_ += airUs;
+        txEndUs = airBusyUntilUs_;
+    }
+    const uint32_t txEndMs = static_cast<uint32_t>((txEndUs + 999U) / 1000U);
+
+    // ── Fan out to every receiver in range ───────────────────────────────
+    const bool broadcast = std::memcmp(mac, GHOST_BROADCAST_MAC, 6U) == 0;
+    const int unicastTo = broadcast ? -1 : findNode(mac);
+
+    for (size_t to = 0U; to < nodeCount_; ++to)
+    {
+        if (to == from || (!broadcast && static_cast<int>(to) != unicastTo))
+        {
+            continue;
+        }
+
+        const GhostSimLink &l = link(from, to);
+        if (!l.up)
+        {
+            if (!broadcast)
+            {
+                ++stats_[to].framesLost; // unicast to a peer out of range
+            }
+            continue;
+        }
+        if (l.lossPct > 0U && (nextRandom() % 100U) < l.lossPct)
+        {
+            ++stats_[to].framesLost;
+            continue;
+        }
+        if (inFlightCount_ >= MAX_IN_FLIGHT)
+        {
+            ++airtimeDrops_;
+            continue;
+        }
+
+        InFlight &f = inFlight_[inFlightCount_++];
+        f.deliverAtMs = txEndMs + l.latencyMs;
+        f.seq = txSeq_++;
+        f.from = static_cast<uint8_t>(from);
+        f.to = static_cast<uint8_t>(to);
+        f.len = static_cast<uint8_t>(len);
+        std::memcpy(f.data, data, len);
+    }
+    return true;
+}
+
+void GhostNetSimulator::deliverDue()
+{
+    for (;;)
+    {
+        // Pick the earliest due frame (stable by transmission order).
+        size_t best = inFlightCount_;
+        for (size_t i = 0U; i < inFlightCount_; ++i)
+        {
+            const InFlight &f = inFlight_[i];
+            if (f.deliverAtMs > nowMs_)
+            {
+                continue;
+            }
+            if (best == inFlightCount_ ||
+                f.deliverAtMs < inFlight_[best].deliverAtMs ||
+                (f.deliverAtMs == inFlight_[best].deliverAtMs && f.seq < inFlight_[best].seq))
+            {
+                best = i;
+            }
+        }
+        if (best == inFlightCount_)
+        {
+            return;
+        }
+
+        // Copy out before delivery: the receiver may transmit (ACKs).
+        const InFlight frame = inFlight_[best];
+        inFlight_[best] = inFlight_[--inFlightCount_];
+
+        GhostNetManager *dst = nodes_[frame.to];
+        if (!dst->isActive())
+        {
+            ++stats_[frame.to].framesLost; // receiver not booted yet
+            continue;
+        }
+
+        ++stats_[frame.to].framesRx;
+        const uint64_t t0 = hostMicros();
+        dst->onReceive(backends_[frame.from]->mac(), frame.data, frame.len,
+                       link(frame.from, frame.to).rssi);
+        stats_[frame.to].cpuUs += hostMicros() - t0;
+    }
+}
+
+void GhostNetSimulator::notify(size_t node, GhostMsgType type, int32_t arg)
+{
+    if (type == GhostMsgType::CHAT)
+    {
+        const GhostNetManager *n = nodes_[node];
+        const GhostChatMsg *msg = n->chatAt(n->chatCount() - 1U);
+        if (msg == nullptr ||
+            std::strncmp(msg->text, SIM_CHAT_PREFIX, SIM_CHAT_PREFIX_LEN) != 0)
+        {
+            return;
+        }
+        const uint32_t id = static_cast<uint32_t>(
+            std::strtoul(msg->text + SIM_CHAT_PREFIX_LEN, nullptr, 10));
+        const TrackedChat &slot = chats_[id % MAX_TRACKED_CHATS];
+        if (slot.id != id)
+        {
+            return; // evicted from the tracking window
+        }
+        const uint32_t latency = nowMs_ - slot.sentMs;
+        ++chatDeliveries_;
+        chatLatencySumMs_ += latency;
+        if (latency > chatLatencyMaxMs_)
+        {
+            chatLatencyMaxMs_ = latency;
+        }
+    }
+    else if (type == GhostMsgType::SYNC_DATA)
+    {
+        // arg = payload length including the [len][type] prefix.
+        const int32_t dataBytes = arg - static_cast<int32_t>(1U + SIM_SYNC_TYPE_LEN);
+        if (dataBytes > 0)
+        {
+            syncBytesDelivered_ += static_cast<uint32_t>(dataBytes);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Metrics
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void GhostNetSimulator::checkConvergence()
+{
+    if (converged_)
+    {
+        return;
+    }
+
+    bool all = true;
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        if (stats_[i].convergedMs == 0U)
+        {
+            if (nodes_[i]->isActive() && nodes_[i]->peerCount() >= expectedPeers(i))
+            {
+                const uint32_t t = nowMs_ - startMs_;
+                stats_[i].convergedMs = (t > 0U) ? t : 1U;
+            }
+            else
+            {
+                all = false;
+            }
+        }
+    }
+
+    if (all)
+    {
+        converged_ = true;
+        convergedAtMs_ = nowMs_ - startMs_;
+    }
+}
+
+const GhostSimNodeStats &GhostNetSimulator::nodeStats(size_t index) const
+{
+    static const GhostSimNodeStats EMPTY = {};
+    return (index < nodeCount_) ? stats_[index] : EMPTY;
+}
+
+GhostSimReport GhostNetSimulator::report() const
+{
+    GhostSimReport r = {};
+    r.elapsedMs = nowMs_ - startMs_;
+    r.converged = converged_;
+    r.convergenceMs = convergedAtMs_;
+    r.framesAirtimeDrop = airtimeDrops_;
+    r.chatsSent = chatsSent_;
+    r.chatDeliveries = chatDeliveries_;
+    r.chatLatencyAvgMs = (chatDeliveries_ > 0U)
+                             ? static_cast<uint32_t>(chatLatencySumMs_ / chatDeliveries_)
+                             : 0U;
+    r.chatLatencyMaxMs = chatLatencyMaxMs_;
+    r.syncBytesSent = syncBytesSent_;
+    r.syncBytesDelivered = syncBytesDelivered_;
+    r.syncThroughputBps = (r.elapsedMs > 0U)
+                              ? static_cast<uint32_t>(
+                                    (static_cast<uint64_t>(syncBytesDelivered_) * 1000U) /
+                                    r.elapsedMs)
+                              : 0U;
+    r.airtimeBusyPct = (r.elapsedMs > 0U)
+                           ? static_cast<uint32_t>((airBusyTotalUs_ * 100U) /
+                                                   (static_cast<uint64_t>(r.elapsedMs) * 1000U))
+                           : 0U;
+
+    for (size_t i = 0U; i < nodeCount_; ++i)
+    {
+        r.framesTx += stats_[i].framesTx;
+        r.framesDelivered += stats_[i].framesRx;
+        r.framesLost += stats_[i].framesLost;
+        r.cpuUsTotal += stats_[i].cpuUs;
+        if (stats_[i].cpuUs > r.cpuUsMaxNode)
+        {
+            r.cpuUsMaxNode = stats_[i].cpuUs;
+        }
+    }
+    return r;
+}
+
+uint32_t GhostNetSimulator::nextRandom()
+{
+    // xorshift32 – deterministic for a given seed.
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_;
+}
+
+} // namespace hackos::core
@@ -0,0 +1,908 @@
+/**
+ * @file ghostnet_survey.cpp
+ * @brief Distributed passive channel survey – partitioning, digests,
+ *        merging and the Master / Node schedule.
+ *
+ * Platform-independent: radio tuning and frame capture are done by the
+ * caller, transport goes through GhostNetManager service messages.
+ */
+
+#include "core/ghostnet_survey.h"
+
+#include <climits>
+#include <cstring>
+
+namespace hackos::core {
+
+namespace {
+
+/// Interleaved sweep order: non-overlapping channels first.
+static constexpr uint8_t CHANNEL_ORDER[SURVEY_CHANNEL_COUNT] = {
+    1U, 6U, 11U, 3U, 8U, 13U, 2U, 7U, 12U, 4U, 9U, 5U, 10U,
+};
+
+static constexpr uint16_t ALL_CHANNELS_MASK =
+    static_cast<uint16_t>((1U << SURVEY_CHANNEL_COUNT) - 1U);
+
+void putU16(uint8_t *p, uint32_t v)
+{
+    const uint16_t sat = (v > 0xFFFFU) ? 0xFFFFU : static_cast<uint16_t>(v);
+    p[0] = static_cast<uint8_t>(sat & 0xFFU);
+    p[1] = static_cast<uint8_t>(sat >> 8U);
+}
+
+uint16_t getU16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8U));
+}
+
+bool validChannel(uint8_t channel)
+{
+    return channel >= 1U && channel <= SURVEY_CHANNEL_COUNT;
+}
+
+void copySsid(char *dst, const char *src, size_t len)
+{
+    const size_t n = (len < 32U) ? len : 32U;
+    std::memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+} // namespace
+
+// ── Partitioning ─────────────────────────────────────────────────────────────
+
+uint16_t surveyPartition(uint8_t home, size_t nodeCount, size_t nodeIndex)
+{
+    if (nodeCount == 0U || nodeIndex >= nodeCount)
+    {
+        return 0U;
+    }
+    if (nodeCount == 1U)
+    {
+        return ALL_CHANNELS_MASK;
+    }
+    if (nodeIndex == 0U)
+    {
+        return surveyChannelBit(home);
+    }
+
+    const size_t workers = nodeCount - 1U;
+    uint16_t mask = 0U;
+    size_t pos = 0U;
+    for (size_t i = 0U; i < SURVEY_CHANNEL_COUNT; ++i)
+    {
+        if (CHANNEL_ORDER[i] == home)
+        {
+            continue;
+        }
+        if ((pos % workers) == nodeIndex - 1U)
+        {
+            mask = static_cast<uint16_t>(mask | surveyChannelBit(CHANNEL_ORDER[i]));
+        }
+        ++pos;
+    }
+    return mask;
+}
+
+// ── SurveyCollector ──────────────────────────────────────────────────────────
+
+SurveyCollector::SurveyCollector()
+{
+    reset();
+}
+
+void SurveyCollector::reset()
+{
+    std::memset(counters_, 0, sizeof(counters_));
+    for (size_t i = 0U; i < SURVEY_CHANNEL_COUNT; ++i)
+    {
+        counters_[i].peakRssi = INT8_MIN;
+    }
+    std::memset(aps_, 0, sizeof(aps_));
+}
+
+void SurveyCollector::recordFrame(uint8_t channel, SurveyFrameKind kind,
+                                  int8_t rssi)
+{
+    if (!validChannel(channel))
+    {
+        return;
+    }
+
+    Counters &c = counters_[channel - 1U];
+    switch (kind)
+    {
+    case SurveyFrameKind::MGMT: ++c.mgmt; break;
+    case SurveyFrameKind::CTRL: ++c.ctrl; break;
+    case SurveyFrameKind::DATA: ++c.data; break;
+    }
+    if (rssi > c.peakRssi)
+    {
+        c.peakRssi = rssi;
+    }
+}
+
+SurveyLocalAp *SurveyCollector::findOrAllocAp(const uint8_t *bssid)
+{
+    SurveyLocalAp *freeSlot = nullptr;
+    SurveyLocalAp *victim = nullptr;
+
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        SurveyLocalAp &ap = aps_[i];
+        if (!ap.used)
+        {
+            if (freeSlot == nullptr)
+            {
+                freeSlot = &ap;
+            }
+            continue;
+        }
+        if (std::memcmp(ap.bssid, bssid, 6) == 0)
+        {
+            return &ap;
+        }
+        // Already-reported APs are cheap to forget: the Master keeps them.
+        if (!ap.dirty && (victim == nullptr || ap.rssi < victim->rssi))
+        {
+            victim = &ap;
+        }
+    }
+
+    SurveyLocalAp *slot = (freeSlot != nullptr) ? freeSlot : victim;
+    if (slot != nullptr)
+    {
+        std::memset(slot, 0, sizeof(*slot));
+        std::memcpy(slot->bssid, bssid, 6);
+    }
+    return slot;
+}
+
+void SurveyCollector::recordAp(uint8_t channel, const uint8_t *bssid,
+                               const char *ssid, int8_t rssi)
+{
+    if (!validChannel(channel) || bssid == nullptr)
+    {
+        return;
+    }
+
+    SurveyLocalAp *ap = findOrAllocAp(bssid);
+    if (ap == nullptr)
+    {
+        return; // Table full of unreported APs.
+    }
+
+    if (!ap->used)
+    {
+        ap->used = true;
+        ap->dirty = true;
+        ap->channel = channel;
+        ap->rssi = rssi;
+        ap->reportedRssi = rssi;
+        if (ssid != nullptr)
+        {
+            copySsid(ap->ssid, ssid, std::strlen(ssid));
+        }
+        return;
+    }
+
+    ap->rssi = rssi;
+    if (ap->channel != channel)
+    {
+        ap->channel = channel;
+        ap->dirty = true;
+    }
+    if (ssid != nullptr && ssid[0] != '\0' &&
+        std::strncmp(ap->ssid, ssid, 32U) != 0)
+    {
+        copySsid(ap->ssid, ssid, std::strlen(ssid));
+        ap->dirty = true;
+    }
+    const int delta = static_cast<int>(rssi) - static_cast<int>(ap->reportedRssi);
+    if (delta >= SURVEY_RSSI_DELTA_DB || delta <= -SURVEY_RSSI_DELTA_DB)
+    {
+        ap->dirty = true;
+    }
+}
+
+void SurveyCollector::addListenTime(uint8_t channel, uint32_t ms)
+{
+    if (validChannel(channel))
+    {
+        counters_[channel - 1U].listenMs += ms;
+    }
+}
+
+bool SurveyCollector::hasPending(uint8_t channel) const
+{
+    if (!validChannel(channel))
+    {
+        return false;
+    }
+
+    const Counters &c = counters_[channel - 1U];
+    if (c.mgmt != 0U || c.data != 0U || c.ctrl != 0U || c.listenMs != 0U)
+    {
+        return true;
+    }
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        if (aps_[i].used && aps_[i].dirty && aps_[i].channel == channel)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t SurveyCollector::buildDigest(uint8_t channel, uint8_t session,
+                                    uint8_t planVersion, uint8_t *out,
+                                    size_t cap)
+{
+    if (out == nullptr || cap < SURVEY_DIGEST_HEADER)
+    {
+        return 0U;
+    }
+
+    std::memset(out, 0, SURVEY_DIGEST_HEADER);
+    out[0] = SURVEY_WIRE_VERSION;
+    out[1] = session;
+    out[2] = planVersion;
+    out[3] = channel;
+    out[12] = static_cast<uint8_t>(INT8_MIN);
+
+    if (!validChannel(channel))
+    {
+        return SURVEY_DIGEST_HEADER; // End-of-batch marker.
+    }
+
+    Counters &c = counters_[channel - 1U];
+    putU16(&out[4], c.listenMs);
+    putU16(&out[6], c.mgmt);
+    putU16(&out[8], c.data);
+    putU16(&out[10], c.ctrl);
+    out[12] = static_cast<uint8_t>(c.peakRssi);
+    std::memset(&c, 0, sizeof(c));
+    c.peakRssi = INT8_MIN;
+
+    size_t pos = SURVEY_DIGEST_HEADER;
+    uint8_t apCount = 0U;
+    for (size_t i = 0U; i < MAX_APS && apCount < UINT8_MAX; ++i)
+    {
+        SurveyLocalAp &ap = aps_[i];
+        if (!ap.used || !ap.dirty || ap.channel != channel)
+        {
+            continue;
+        }
+
+        const size_t ssidLen = std::strlen(ap.ssid);
+        if (pos + SURVEY_AP_FIXED + ssidLen > cap)
+        {
+            continue; // Try a shorter one; this AP goes in the next digest.
+        }
+
+        std::memcpy(&out[pos], ap.bssid, 6);
+        out[pos + 6U] = static_cast<uint8_t>(ap.rssi);
+        out[pos + 7U] = static_cast<uint8_t>(ssidLen);
+        std::memcpy(&out[pos + SURVEY_AP_FIXED], ap.ssid, ssidLen);
+        pos += SURVEY_AP_FIXED + ssidLen;
+
+        ap.dirty = false;
+        ap.reportedRssi = ap.rssi;
+        ++apCount;
+    }
+    out[13] = apCount;
+    return pos;
+}
+
+// ── SurveyView ───────────────────────────────────────────────────────────────
+
+SurveyView::SurveyView()
+{
+    reset();
+}
+
+void SurveyView::reset()
+{
+    std::memset(channels_, 0, sizeof(channels_));
+    for (size_t i = 0U; i < SURVEY_CHANNEL_COUNT; ++i)
+    {
+        channels_[i].peakRssi = INT8_MIN;
+    }
+    std::memset(aps_, 0, sizeof(aps_));
+    digests_ = 0U;
+}
+
+bool SurveyView::merge(const uint8_t *payload, size_t len, uint8_t session,
+                       uint8_t reporter, uint32_t nowMs)
+{
+    if (payload == nullptr || len < SURVEY_DIGEST_HEADER ||
+        payload[0] != SURVEY_WIRE_VERSION || payload[1] != session ||
+        !validChannel(payload[3]))
+    {
+        return false;
+    }
+
+    const uint8_t ch = payload[3];
+    SurveyChannelSummary &sum = channels_[ch - 1U];
+    sum.listenMs += getU16(&payload[4]);
+    sum.mgmt     += getU16(&payload[6]);
+    sum.data     += getU16(&payload[8]);
+    sum.ctrl     += getU16(&payload[10]);
+    const auto peak = static_cast<int8_t>(payload[12]);
+    if (peak > sum.peakRssi)
+    {
+        sum.peakRssi = peak;
+    }
+    sum.reporter = reporter;
+    sum.lastReportMs = nowMs;
+
+    size_t pos = SURVEY_DIGEST_HEADER;
+    const uint8_t apCount = payload[13];
+    for (uint8_t n = 0U; n < apCount; ++n)
+    {
+        if (pos + SURVEY_AP_FIXED > len)
+        {
+            break;
+        }
+        const uint8_t *rec = &payload[pos];
+        const size_t ssidLen = rec[7];
+        if (ssidLen > 32U || pos + SURVEY_AP_FIXED + ssidLen > len)
+        {
+            break;
+        }
+        pos += SURVEY_AP_FIXED + ssidLen;
+
+        SurveyAp *slot = findOrEvictAp(rec);
+        if (!slot->used || std::memcmp(slot->bssid, rec, 6) != 0)
+        {
+            std::memset(slot, 0, sizeof(*slot));
+            std::memcpy(slot->bssid, rec, 6);
+            slot->used = true;
+        }
+        slot->rssi = static_cast<int8_t>(rec[6]);
+        slot->channel = ch;
+        slot->reporter = reporter;
+        slot->lastSeenMs = nowMs;
+        if (ssidLen > 0U)
+        {
+            copySsid(slot->ssid, reinterpret_cast<const char *>(&rec[SURVEY_AP_FIXED]),
+                     ssidLen);
+        }
+    }
+
+    recountAps();
+    ++digests_;
+    return true;
+}
+
+SurveyAp *SurveyView::findOrEvictAp(const uint8_t *bssid)
+{
+    SurveyAp *freeSlot = nullptr;
+    SurveyAp *oldest = nullptr;
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        SurveyAp &ap = aps_[i];
+        if (!ap.used)
+        {
+            if (freeSlot == nullptr)
+            {
+                freeSlot = &ap;
+            }
+        }
+        else if (std::memcmp(ap.bssid, bssid, 6) == 0)
+        {
+            return &ap;
+        }
+        else if (oldest == nullptr || ap.lastSeenMs < oldest->lastSeenMs)
+        {
+            oldest = &ap;
+        }
+    }
+    return (freeSlot != nullptr) ? freeSlot : oldest;
+}
+
+void SurveyView::recountAps()
+{
+    for (size_t i = 0U; i < SURVEY_CHANNEL_COUNT; ++i)
+    {
+        channels_[i].apCount = 0U;
+    }
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        if (aps_[i].used && validChannel(aps_[i].channel))
+        {
+            ++channels_[aps_[i].channel - 1U].apCount;
+        }
+    }
+}
+
+const SurveyChannelSummary *SurveyView::channel(uint8_t channel) const
+{
+    return validChannel(channel) ? &channels_[channel - 1U] : nullptr;
+}
+
+uint32_t SurveyView::frameRate(uint8_t channel) const
+{
+    const SurveyChannelSummary *sum = this->channel(channel);
+    if (sum == nullptr || sum->listenMs == 0U)
+    {
+        return 0U;
+    }
+    const uint64_t frames = static_cast<uint64_t>(sum->mgmt) + sum->data + sum->ctrl;
+    return static_cast<uint32_t>((frames * 1000U) / sum->listenMs);
+}
+
+size_t SurveyView::apCount() const
+{
+    size_t count = 0U;
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        if (aps_[i].used)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+const SurveyAp *SurveyView::ap(size_t index) const
+{
+    for (size_t i = 0U; i < MAX_APS; ++i)
+    {
+        if (aps_[i].used)
+        {
+            if (index == 0U)
+            {
+                return &aps_[i];
+            }
+            --index;
+        }
+    }
+    return nullptr;
+}
+
+// ── GhostSurvey ──────────────────────────────────────────────────────────────
+
+GhostSurvey::GhostSurvey(GhostNetManager &net)
+    : net_(net)
+    , role_(SurveyRole::IDLE)
+    , phase_(Phase::HOP)
+    , session_(0U)
+    , planVersion_(0U)
+    , home_(0U)
+    , dwellMs_(DEFAULT_DWELL_MS)
+    , mask_(0U)
+    , planCount_(0U)
+    , channelCount_(0U)
+    , hopIndex_(0U)
+    , radioChannel_(0U)
+    , flushed_(false)
+    , slot_(0U)
+    , nowMs_(0U)
+    , phaseStartMs_(0U)
+    , lastPlanCheckMs_(0U)
+    , lastPlanRxMs_(0U)
+{
+    std::memset(masterMac_, 0, sizeof(masterMac_));
+    std::memset(plan_, 0, sizeof(plan_));
+    std::memset(channels_, 0, sizeof(channels_));
+}
+
+bool GhostSurvey::startMaster(uint8_t homeChannel, uint16_t dwellMs,
+                              uint32_t nowMs)
+{
+    if (!net_.isActive() || !validChannel(homeChannel) || dwellMs == 0U)
+    {
+        return false;
+    }
+
+    nowMs_ = nowMs;
+    role_ = SurveyRole::MASTER;
+    session_ = static_cast<uint8_t>(session_ + 1U);
+    if (session_ == 0U)
+    {
+        session_ = 1U;
+    }
+    planVersion_ = 0U;
+    home_ = homeChannel;
+    dwellMs_ = dwellMs;
+    slot_ = 0U;
+    std::memcpy(masterMac_, net_.ownMac(), 6);
+    view_.reset();
+    collector_.reset();
+
+    replan();
+
+    uint8_t buf[GHOST_MAX_PAYLOAD];
+    const size_t len = encodePlan(buf, sizeof(buf));
+    (void)net_.sendService(GhostMsgType::SURVEY_PLAN, buf, len);
+
+    lastPlanCheckMs_ = nowMs;
+    startCycle(nowMs);
+    return true;
+}
+
+void GhostSurvey::stop()
+{
+    if (role_ == SurveyRole::MASTER)
+    {
+        uint8_t buf[SURVEY_PLAN_HEADER] = {};
+        buf[0] = SURVEY_WIRE_VERSION;
+        buf[3] = home_;
+        (void)net_.sendService(GhostMsgType::SURVEY_PLAN, buf, sizeof(buf));
+    }
+
+    role_ = SurveyRole::IDLE;
+    radioChannel_ = home_;
+}
+
+// ── Plan ─────────────────────────────────────────────────────────────────────
+
+void GhostSurvey::replan()
+{
+    // Collect active peers sorted by MAC so the split is deterministic.
+    planCount_ = 0U;
+    for (size_t i = 0U; i < GhostNetManager::MAX_PEERS; ++i)
+    {
+        const GhostPeer *p = net_.peer(i);
+        if (p == nullptr || !p->active)
+        {
+            continue;
+        }
+
+        size_t at = planCount_;
+        while (at > 0U && std::memcmp(plan_[at - 1U].mac, p->mac, 6) > 0)
+        {
+            plan_[at] = plan_[at - 1U];
+            --at;
+        }
+        std::memcpy(plan_[at].mac, p->mac, 6);
+        ++planCount_;
+    }
+
+    const size_t participants = planCount_ + 1U;
+    for (size_t i = 0U; i < planCount_; ++i)
+    {
+        plan_[i].mask = surveyPartition(home_, participants, i + 1U);
+    }
+    mask_ = surveyPartition(home_, participants, 0U);
+    planVersion_ = static_cast<uint8_t>(planVersion_ + 1U);
+    buildChannelList();
+}
+
+size_t GhostSurvey::encodePlan(uint8_t *out, size_t cap) const
+{
+    if (cap < SURVEY_PLAN_HEADER)
+    {
+        return 0U;
+    }
+
+    out[0] = SURVEY_WIRE_VERSION;
+    out[1] = session_;
+    out[2] = planVersion_;
+    out[3] = home_;
+    putU16(&out[4], dwellMs_);
+
+    size_t pos = SURVEY_PLAN_HEADER;
+    uint8_t count = 0U;
+    for (size_t i = 0U; i < planCount_ && pos + SURVEY_PLAN_ENTRY <= cap; ++i)
+    {
+        std::memcpy(&out[pos], plan_[i].mac, 6);
+        putU16(&out[pos + 6U], plan_[i].mask);
+        pos += SURVEY_PLAN_ENTRY;
+        ++count;
+    }
+    out[6] = count;
+    return pos;
+}
+
+void GhostSurvey::applyPlan(const uint8_t *src, const uint8_t *payload,
+                            size_t len)
+{
+    if (role_ == SurveyRole::MASTER || len < SURVEY_PLAN_HEADER ||
+        payload[0] != SURVEY_WIRE_VERSION)
+    {
+        return;
+    }
+
+    const uint8_t session = payload[1];
+    if (session == 0U)
+    {
+        if (role_ == SurveyRole::NODE && std::memcmp(src, masterMac_, 6) == 0)
+        {
+            role_ = SurveyRole::IDLE;
+            radioChannel_ = home_;
+        }
+        return;
+    }
+
+    if (role_ == SurveyRole::NODE && std::memcmp(src, masterMac_, 6) != 0)
+    {
+        return; // Already following another Master.
+    }
+
+    uint16_t mask = 0U;
+    uint8_t slot = 0U;
+    const size_t count = payload[6];
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const size_t pos = SURVEY_PLAN_HEADER + i * SURVEY_PLAN_ENTRY;
+        if (pos + SURVEY_PLAN_ENTRY > len)
+        {
+            break;
+        }
+        if (std::memcmp(&payload[pos], net_.ownMac(), 6) == 0)
+        {
+            mask = static_cast<uint16_t>(getU16(&payload[pos + 6U]) & ALL_CHANNELS_MASK);
+            slot = static_cast<uint8_t>(i);
+            break;
+        }
+    }
+
+    lastPlanRxMs_ = nowMs_;
+
+    const bool changed = role_ != SurveyRole::NODE || session != session_ ||
+                         payload[2] != planVersion_ || mask != mask_;
+    if (!changed)
+    {
+        return;
+    }
+
+    role_ = SurveyRole::NODE;
+    std::memcpy(masterMac_, src, 6);
+    session_ = session;
+    planVersion_ = payload[2];
+    home_ = validChannel(payload[3]) ? payload[3] : home_;
+    const uint16_t dwell = getU16(&payload[4]);
+    dwellMs_ = (dwell != 0U) ? dwell : DEFAULT_DWELL_MS;
+    mask_ = mask;
+    slot_ = slot;
+    collector_.reset();
+    buildChannelList();
+    startCycle(nowMs_);
+}
+
+int GhostSurvey::findPlanEntry(const uint8_t *mac) const
+{
+    for (size_t i = 0U; i < planCount_; ++i)
+    {
+        if (std::memcmp(plan_[i].mac, mac, 6) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void GhostSurvey::buildChannelList()
+{
+    channelCount_ = 0U;
+    for (size_t i = 0U; i < SURVEY_CHANNEL_COUNT; ++i)
+    {
+        if ((mask_ & surveyChannelBit(CHANNEL_ORDER[i])) != 0U)
+        {
+            channels_[channelCount_++] = CHANNEL_ORDER[i];
+        }
+    }
+}
+
+// ── Schedule ─────────────────────────────────────────────────────────────────
+
+void GhostSurvey::startCycle(uint32_t nowMs)
+{
+    phase_ = Phase::HOP;
+    hopIndex_ = 0U;
+    phaseStartMs_ = nowMs;
+    if (channelCount_ == 0U)
+    {
+        enterReport(nowMs);
+        return;
+    }
+    radioChannel_ = channels_[0];
+}
+
+void GhostSurvey::enterReport(uint32_t nowMs)
+{
+    phase_ = Phase::REPORT;
+    phaseStartMs_ = nowMs;
+    radioChannel_ = home_;
+    // Digests go out on the next tick, once the caller has retuned.
+    flushed_ = false;
+}
+
+void GhostSurvey::tick(uint32_t nowMs)
+{
+    nowMs_ = nowMs;
+
+    InboxMsg msg;
+    while (inbox_.pop(msg))
+    {
+        if (msg.type == GhostMsgType::SURVEY_PLAN)
+        {
+            applyPlan(msg.mac, msg.payload, msg.len);
+        }
+        else if (msg.type == GhostMsgType::SURVEY_DIGEST)
+        {
+            onDigest(msg.mac, msg.payload, msg.len);
+        }
+    }
+
+    if (role_ == SurveyRole::IDLE)
+    {
+        return;
+    }
+
+    if (role_ == SurveyRole::NODE &&
+        (nowMs - lastPlanRxMs_) > ORPHAN_TIMEOUT_MS)
+    {
+        role_ = SurveyRole::IDLE;
+        radioChannel_ = home_;
+        return;
+    }
+
+    if (role_ == SurveyRole::MASTER &&
+        (nowMs - lastPlanCheckMs_) >= REPLAN_CHECK_MS)
+    {
+        lastPlanCheckMs_ = nowMs;
+
+        bool same = true;
+        size_t active = 0U;
+        for (size_t i = 0U; i < GhostNetManager::MAX_PEERS; ++i)
+        {
+            const GhostPeer *p = net_.peer(i);
+            if (p != nullptr && p->active)
+            {
+                ++active;
+                if (findPlanEntry(p->mac) < 0)
+                {
+                    same = false;
+                }
+            }
+        }
+        if (!same || active != planCount_)
+        {
+            replan();
+            uint8_t buf[GHOST_MAX_PAYLOAD];
+            const size_t len = encodePlan(buf, sizeof(buf));
+            (void)net_.sendService(GhostMsgType::SURVEY_PLAN, buf, len);
+            startCycle(nowMs);
+            return;
+        }
+    }
+
+    const uint32_t elapsed = nowMs - phaseStartMs_;
+
+    if (phase_ == Phase::HOP)
+    {
+        if (elapsed < dwellMs_)
+        {
+            return;
+        }
+        collector_.addListenTime(channels_[hopIndex_], elapsed);
+        ++hopIndex_;
+        phaseStartMs_ = nowMs;
+        if (hopIndex_ >= channelCount_)
+        {
+            enterReport(nowMs);
+        }
+        else
+        {
+            radioChannel_ = channels_[hopIndex_];
+        }
+        return;
+    }
+
+    // REPORT: on the home channel.  Nodes flush in their own slot so the
+    // Master's inbox never sees every node's burst at once.
+    if (!flushed_ && elapsed >= slot_ * REPORT_SLOT_MS)
+    {
+        flushDigests();
+        flushed_ = true;
+    }
+    if (elapsed >= REPORT_WINDOW_MS)
+    {
+        if ((mask_ & surveyChannelBit(home_)) != 0U)
+        {
+            collector_.addListenTime(home_, elapsed);
+        }
+        startCycle(nowMs);
+    }
+}
+
+void GhostSurvey::flushDigests()
+{
+    uint8_t buf[GHOST_MAX_PAYLOAD];
+    size_t sent = 0U;
+
+    for (size_t i = 0U; i < channelCount_; ++i)
+    {
+        const uint8_t ch = channels_[i];
+        while (sent < MAX_DIGESTS_PER_REPORT && collector_.hasPending(ch))
+        {
+            const size_t len = collector_.buildDigest(ch, session_, planVersion_,
+                                                      buf, sizeof(buf));
+            if (role_ == SurveyRole::MASTER)
+            {
+                (void)view_.merge(buf, len, session_, 0U, nowMs_);
+            }
+            else
+            {
+                (void)net_.sendService(GhostMsgType::SURVEY_DIGEST, buf, len,
+                                       masterMac_);
+            }
+            ++sent;
+        }
+    }
+
+    if (role_ == SurveyRole::NODE)
+    {
+        const size_t len = collector_.buildDigest(0U, session_, planVersion_,
+                                                  buf, sizeof(buf));
+        (void)net_.sendService(GhostMsgType::SURVEY_DIGEST, buf, len, masterMac_);
+    }
+}
+
+// ── Capture input ────────────────────────────────────────────────────────────
+
+void GhostSurvey::recordFrame(uint8_t channel, SurveyFrameKind kind, int8_t rssi)
+{
+    if (role_ != SurveyRole::IDLE && (mask_ & surveyChannelBit(channel)) != 0U)
+    {
+        collector_.recordFrame(channel, kind, rssi);
+    }
+}
+
+void GhostSurvey::recordAp(uint8_t channel, const uint8_t *bssid,
+                           const char *ssid, int8_t rssi)
+{
+    if (role_ != SurveyRole::IDLE && (mask_ & surveyChannelBit(channel)) != 0U)
+    {
+        collector_.recordAp(channel, bssid, ssid, rssi);
+    }
+}
+
+// ── Messages ─────────────────────────────────────────────────────────────────
+
+void GhostSurvey::onServiceMessage(const uint8_t *srcMac, GhostMsgType type,
+                                   const uint8_t *payload, size_t len)
+{
+    if (srcMac == nullptr || payload == nullptr || len > GHOST_MAX_PAYLOAD ||
+        (type != GhostMsgType::SURVEY_PLAN && type != GhostMsgType::SURVEY_DIGEST))
+    {
+        return;
+    }
+
+    InboxMsg msg;
+    std::memcpy(msg.mac, srcMac, 6);
+    msg.type = type;
+    msg.len = static_cast<uint8_t>(len);
+    std::memcpy(msg.payload, payload, len);
+    (void)inbox_.push(msg); // Dropped when full; plans are re-sent.
+}
+
+void GhostSurvey::onDigest(const uint8_t *srcMac, const uint8_t *payload,
+                           size_t len)
+{
+    if (role_ != SurveyRole::MASTER || len < SURVEY_DIGEST_HEADER ||
+        payload[0] != SURVEY_WIRE_VERSION)
+    {
+        return;
+    }
+
+    if (payload[3] == 0U)
+    {
+        // End of the node's report window: answer with the current plan.
+        uint8_t buf[GHOST_MAX_PAYLOAD];
+        const size_t planLen = encodePlan(buf, sizeof(buf));
+        (void)net_.sendService(GhostMsgType::SURVEY_PLAN, buf, planLen, srcMac);
+        return;
+    }
+
+    const int idx = findPlanEntry(srcMac);
+    const uint8_t reporter = (idx >= 0) ? static_cast<uint8_t>(idx + 1) : UINT8_MAX;
+    (void)view_.merge(payload, len, session_, reporter, nowMs_);
+}
+
+} // namespace hackos::core
@@ -3,7 +3,8 @@
  * @brief Dynamic Plugin Manager implementation.
  *
  * Scans `/ext/plugins/` for JSON plugin definitions, parses them, and
- * registers them as dynamic apps with the AppManager.
+ * registers them as dynamic apps with the AppManager.  Actions run on an
+ * ActionSequencer driven by a one-shot esp_timer (see plugin_manager.h).
  */
 
 #include "core/plugin_manager.h"
@@ -14,8 +15,12 @@
 
 #include <esp_log.h>
 #include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <Arduino.h>
 
+#include "config.h"
 #include "apps/app_base.h"
 #include "core/app_manager.h"
 #include "core/event.h"
@@ -28,6 +33,405 @@ static constexpr const char *TAG_PM = "PluginMgr";
 
 namespace hackos::core {
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// Action runtime – sequencer on a one-shot esp_timer
+// ═══════════════════════════════════════════════════════════════════════════════
+
+namespace {
+
+/// LEDC channels for plugin tones (0 = buzzer / jammer, 1 = signal generator).
+static constexpr uint8_t PLUGIN_TONE_CHANNELS[] = {2U, 3U};
+static constexpr size_t PLUGIN_TONE_COUNT = sizeof(PLUGIN_TONE_CHANNELS) / sizeof(PLUGIN_TONE_CHANNELS[0]);
+static constexpr uint8_t NO_PIN = 0xFFU;
+static constexpr uint8_t MAX_PLUGIN_GPIO = 39U;
+
+/// Sequencer tags: plugin index × 16 + action index (PLUGIN_SCRIPT = 8).
+static constexpr uint16_t TAGS_PER_PLUGIN = 16U;
+static_assert(PLUGIN_PROGRAM < TAGS_PER_PLUGIN, "action index must fit the tag");
+
+/// Shortest timer arm; a due op is run by the next poll anyway.
+static constexpr uint32_t MIN_ARM_US = 20U;
+
+/// Scripts running at once, instructions per slice, and the pause a
+/// script that never waits gets between slices.
+static constexpr size_t MAX_PLUGIN_VMS = 2U;
+static constexpr uint32_t VM_BUDGET = 256U;
+static constexpr uint32_t VM_SLICE_GAP_US = 1000U;
+
+uint16_t actionTag(size_t plugin, size_t action)
+{
+    return static_cast<uint16_t>(plugin * TAGS_PER_PLUGIN + action);
+}
+
+/// @brief Arduino GPIO / LEDC access for the sequencer.
+class ArduinoSeqBackend final : public SeqBackend
+{
+public:
+    ArduinoSeqBackend() : outputs_(0U), tonePin_{}
+    {
+        memset(tonePin_, NO_PIN, sizeof(tonePin_));
+    }
+
+    uint32_t nowUs() override { return static_cast<uint32_t>(micros()); }
+
+    void pinWrite(uint8_t pin, bool high) override
+    {
+        ensureOutput(pin);
+        digitalWrite(pin, high ? HIGH : LOW);
+    }
+
+    bool pinLevel(uint8_t pin) override
+    {
+        ensureOutput(pin);
+        return digitalRead(pin) == HIGH;
+    }
+
+    bool tone(uint8_t pin, uint32_t hz) override
+    {
+        size_t ch = PLUGIN_TONE_COUNT;
+        for (size_t i = 0U; i < PLUGIN_TONE_COUNT; ++i)
+        {
+            if (tonePin_[i] == pin)
+            {
+                ch = i;
+            }
+        }
+        if (hz == 0U)
+        {
+            if (ch < PLUGIN_TONE_COUNT)
+            {
+                ledcWriteTone(PLUGIN_TONE_CHANNELS[ch], 0U);
+                ledcDetachPin(pin);
+                tonePin_[ch] = NO_PIN;
+                outputs_ &= ~(1ULL << pin);   // back to plain GPIO on next use
+            }
+            return true;
+        }
+        for (size_t i = 0U; ch == PLUGIN_TONE_COUNT && i < PLUGIN_TONE_COUNT; ++i)
+        {
+            if (tonePin_[i] == NO_PIN)
+            {
+                ch = i;
+                tonePin_[i] = pin;
+                ledcSetup(PLUGIN_TONE_CHANNELS[i], hz, 8);
+                ledcAttachPin(pin, PLUGIN_TONE_CHANNELS[i]);
+            }
+        }
+        if (ch == PLUGIN_TONE_COUNT)
+        {
+            ESP_LOGW(TAG_PM, "No tone channel free for pin %u", static_cast<unsigned>(pin));
+            return false;
+        }
+        ledcWriteTone(PLUGIN_TONE_CHANNELS[ch], hz);
+        return true;
+    }
+
+    void note(uint16_t tag, const SeqOp &op) override
+    {
+        const PluginInfo *info = PluginManager::instance().pluginAt(tag / TAGS_PER_PLUGIN);
+        if (info == nullptr || op.aux >= info->actionCount)
+        {
+            return;
+        }
+        const PluginAction &act = info->actions[op.aux];
+        if (act.type == PluginActionType::LOG_MSG)
+        {
+            ESP_LOGI(TAG_PM, "Plugin log: %s", act.label);
+        }
+        else
+        {
+            ESP_LOGI(TAG_PM, "Plugin %s: %s (%ld)", info->name, act.label, static_cast<long>(op.arg));
+        }
+    }
+
+private:
+    void ensureOutput(uint8_t pin)
+    {
+        if ((outputs_ & (1ULL << pin)) == 0U)
+        {
+            pinMode(pin, OUTPUT);
+            outputs_ |= 1ULL << pin;
+        }
+    }
+
+    uint64_t outputs_;   ///< Pins already switched to OUTPUT
+    uint8_t tonePin_[PLUGIN_TONE_COUNT];
+};
+
+static ArduinoSeqBackend g_seqBackend;
+static ActionSequencer g_sequencer(g_seqBackend);
+static StaticSemaphore_t g_seqMutexBuf;
+static SemaphoreHandle_t g_seqMutex = nullptr;
+static esp_timer_handle_t g_seqTimer = nullptr;
+
+/// Pins a script may drive: not flash, input-only, or wired to the
+/// display, SD / NFC SPI bus or joystick button.
+bool scriptMayDrive(uint8_t pin)
+{
+    static constexpr uint8_t RESERVED[] = {
+        PIN_OLED_SDA, PIN_OLED_SCL, PIN_SD_CS, PIN_NFC_CS,
+        PIN_SPI_SCK,  PIN_SPI_MISO, PIN_SPI_MOSI, PIN_JOY_SW,
+    };
+    if (pin > 33U || (pin >= 6U && pin <= 11U))
+    {
+        return false;
+    }
+    for (uint8_t r : RESERVED)
+    {
+        if (pin == r)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief One script instance; keeps its result after it ends for the app.
+struct VmSlot
+{
+    explicit VmSlot(VmBackend &backend)
+        : vm(backend), due(0U), shown(0), tag(0U), used(false), hasShown(false)
+    {
+    }
+
+    bool running() const
+    {
+        return used && (vm.status() == VmStatus::RUNNING || vm.status() == VmStatus::WAITING);
+    }
+
+    PluginVm vm;
+    uint32_t due;        ///< µs deadline of the next slice
+    int32_t shown;       ///< Last `show` value
+    uint16_t tag;
+    bool used;
+    bool hasShown;
+};
+
+static VmSlot *g_vmCurrent = nullptr;   ///< Slot inside run(), for output()
+
+/// @brief Sandboxed script bindings on top of the sequencer backend.
+class ArduinoVmBackend final : public VmBackend
+{
+public:
+    uint32_t nowMs() override { return static_cast<uint32_t>(millis()); }
+
+    bool pinWrite(uint8_t pin, bool high) override
+    {
+        if (!scriptMayDrive(pin))
+        {
+            return false;
+        }
+        g_seqBackend.pinWrite(pin, high);
+        return true;
+    }
+
+    bool pinRead(uint8_t pin, int32_t &level) override
+    {
+        if (pin > MAX_PLUGIN_GPIO || (pin >= 6U && pin <= 11U))
+        {
+            return false;
+        }
+        level = (digitalRead(pin) == HIGH) ? 1 : 0;
+        return true;
+    }
+
+    bool adcRead(uint8_t pin, int32_t &value) override
+    {
+        if (pin < 32U || pin > MAX_PLUGIN_GPIO)   // ADC1 only; ADC2 is busy with WiFi
+        {
+            return false;
+        }
+        value = analogRead(pin);
+        return true;
+    }
+
+    bool tone(uint8_t pin, uint32_t hz) override
+    {
+        return scriptMayDrive(pin) && g_seqBackend.tone(pin, hz);
+    }
+
+    void output(VmOutput kind, int32_t value) override
+    {
+        VmSlot *slot = g_vmCurrent;
+        const PluginInfo *info =
+            (slot != nullptr) ? PluginManager::instance().pluginAt(slot->tag / TAGS_PER_PLUGIN) : nullptr;
+        const char *name = (info != nullptr) ? info->name : "?";
+        if (kind == VmOutput::SHOW && slot != nullptr)
+        {
+            slot->shown = value;
+            slot->hasShown = true;
+        }
+        else if (kind == VmOutput::FREQ)
+        {
+            ESP_LOGI(TAG_PM, "Plugin %s: freq %ld Hz", name, static_cast<long>(value));
+        }
+        else if (kind == VmOutput::PRINT)
+        {
+            ESP_LOGI(TAG_PM, "Plugin %s: %ld", name, static_cast<long>(value));
+        }
+    }
+};
+
+static ArduinoVmBackend g_vmBackend;
+static VmSlot g_vmSlots[MAX_PLUGIN_VMS] = {VmSlot(g_vmBackend), VmSlot(g_vmBackend)};
+
+VmSlot *findVm(uint16_t tag)
+{
+    for (VmSlot &s : g_vmSlots)
+    {
+        if (s.used && s.tag == tag)
+        {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+/// Give every due script one slice; @return µs until the next one is due.
+uint32_t pollScripts(uint32_t next)
+{
+    const uint32_t now = static_cast<uint32_t>(micros());
+    for (VmSlot &s : g_vmSlots)
+    {
+        if (!s.running())
+        {
+            continue;
+        }
+        int32_t wait = static_cast<int32_t>(s.due - now);
+        if (wait <= 0)
+        {
+            uint32_t waitUs = 0U;
+            g_vmCurrent = &s;
+            const VmStatus st = s.vm.run(VM_BUDGET, waitUs);
+            g_vmCurrent = nullptr;
+            if (st == VmStatus::WAITING)
+            {
+                s.due += waitUs;   // from the deadline, like sequencer waits
+            }
+            else if (st == VmStatus::RUNNING)
+            {
+                s.due = now + VM_SLICE_GAP_US;
+            }
+            else
+            {
+                if (st == VmStatus::FAULT)
+                {
+                    ESP_LOGW(TAG_PM, "Plugin script fault at %u: %s",
+                             static_cast<unsigned>(s.vm.faultPc()), s.vm.faultMessage());
+                }
+                continue;
+            }
+            wait = static_cast<int32_t>(s.due - now);
+        }
+        const uint32_t left = (wait > 0) ? static_cast<uint32_t>(wait) : 0U;
+        next = (left < next) ? left : next;
+    }
+    return next;
+}
+
+/// Run what is due and re-arm the timer; caller holds g_seqMutex.
+void pumpLocked()
+{
+    const uint32_t next = pollScripts(g_sequencer.poll());
+    (void)esp_timer_stop(g_seqTimer);
+    if (next != ActionSequencer::IDLE)
+    {
+        (void)esp_timer_start_once(g_seqTimer, (next < MIN_ARM_US) ? MIN_ARM_US : next);
+    }
+}
+
+void seqTimerCb(void * /*arg*/)
+{
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    pumpLocked();
+    xSemaphoreGive(g_seqMutex);
+}
+
+/// Create the mutex and timer on first use.
+bool ensureSequencer()
+{
+    if (g_seqTimer != nullptr)
+    {
+        return true;
+    }
+    if (g_seqMutex == nullptr)
+    {
+        g_seqMutex = xSemaphoreCreateMutexStatic(&g_seqMutexBuf);
+    }
+    const esp_timer_create_args_t args = {
+        .callback = &seqTimerCb,
+        .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "plugin_seq",
+        .skip_unhandled_events = false,
+    };
+    if (g_seqMutex == nullptr || esp_timer_create(&args, &g_seqTimer) != ESP_OK)
+    {
+        ESP_LOGE(TAG_PM, "Failed to create action sequencer timer");
+        g_seqTimer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/// Cancel an op list or script by tag; caller holds g_seqMutex.
+void cancelTagLocked(uint16_t tag)
+{
+    g_sequencer.cancelTag(tag);
+    VmSlot *slot = findVm(tag);
+    if (slot != nullptr && slot->running())
+    {
+        slot->vm.stop();
+    }
+}
+
+/// Caller holds g_seqMutex.
+bool runningTagLocked(uint16_t tag)
+{
+    const VmSlot *slot = findVm(tag);
+    return g_sequencer.runningTag(tag) || (slot != nullptr && slot->running());
+}
+
+/// Start @p info's script as @p tag; caller holds g_seqMutex.
+bool startScriptLocked(const PluginInfo &info, uint16_t tag)
+{
+    VmSlot *slot = findVm(tag);   // restart in place
+    for (size_t i = 0U; slot == nullptr && i < MAX_PLUGIN_VMS; ++i)
+    {
+        slot = g_vmSlots[i].running() ? nullptr : &g_vmSlots[i];
+    }
+    if (slot == nullptr)
+    {
+        return false;
+    }
+    slot->vm.stop();
+    slot->used = slot->vm.load(info.code, info.codeSize);
+    slot->tag = tag;
+    slot->due = static_cast<uint32_t>(micros());
+    slot->hasShown = false;
+    return slot->used;
+}
+
+/// Stop everything (plugin indices are about to change).
+void cancelAllActions()
+{
+    if (g_seqTimer == nullptr)
+    {
+        return;
+    }
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    g_sequencer.cancelAll();
+    for (VmSlot &s : g_vmSlots)
+    {
+        s.vm.stop();
+        s.used = false;
+    }
+    pumpLocked();
+    xSemaphoreGive(g_seqMutex);
+}
+
+} // anonymous namespace
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PluginApp – Generic app created from a plugin definition
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -57,20 +461,21 @@ public:
     void onDraw() override
     {
         auto &disp = DisplayManager::instance();
+        auto &pm = PluginManager::instance();
         disp.clear();
 
         // Title
         disp.drawText(0, 0, info_->label);
         disp.drawLine(0, 10, 127, 10);
 
-        if (info_->actionCount == 0U)
+        if (itemCount() == 0U)
         {
             disp.drawText(0, 16, "No actions defined");
             disp.drawText(0, 28, "[BACK] to exit");
         }
         else
         {
-            // Draw action menu
+            // Draw action menu, then "Run all" and the compiled script
             const size_t maxVisible = 4U;
             size_t firstVisible = 0U;
             if (menuSel_ >= maxVisible)
@@ -78,24 +483,43 @@ public:
                 firstVisible = menuSel_ - maxVisible + 1U;
             }
 
-            for (size_t i = 0U; i < maxVisible && (firstVisible + i) < info_->actionCount; ++i)
+            for (size_t i = 0U; i < maxVisible && (firstVisible + i) < itemCount(); ++i)
             {
                 const size_t idx = firstVisible + i;
                 const int y = 14 + static_cast<int>(i) * 10;
+                const size_t action = actionIndex(idx);
+                const char *label = (action == PLUGIN_SCRIPT)    ? "> Run all"
+                                    : (action == PLUGIN_PROGRAM) ? "> Run script"
+                                                                 : info_->actions[idx].label;
+                const bool running = pm.isActionRunning(info_->name, action);
                 if (idx == menuSel_)
                 {
                     disp.fillRect(0, y - 1, 128, 9);
-                    disp.drawText(2, y, info_->actions[idx].label, 1U, 0U);
+                    disp.drawText(2, y, label, 1U, 0U);
+                    if (running)
+                    {
+                        disp.drawText(120, y, "~", 1U, 0U);
+                    }
                 }
                 else
                 {
-                    disp.drawText(2, y, info_->actions[idx].label);
+                    disp.drawText(2, y, label);
+                    if (running)
+                    {
+                        disp.drawText(120, y, "~");
+                    }
                 }
             }
         }
 
-        // Show result message
-        if (showResult_)
+        // Show result message; the script's line follows it live
+        char scriptLine[32];
+        if (itemCount() > 0U && actionIndex(menuSel_) == PLUGIN_PROGRAM &&
+            pm.scriptOutput(info_->name, scriptLine, sizeof(scriptLine)))
+        {
+            disp.drawText(0, 56, scriptLine);
+        }
+        else if (showResult_)
         {
             disp.drawText(0, 56, resultMsg_);
         }
@@ -118,7 +542,7 @@ public:
             showResult_ = false;
         }
         else if (input == InputManager::InputEvent::DOWN &&
-                 menuSel_ + 1U < info_->actionCount)
+                 menuSel_ + 1U < itemCount())
         {
             ++menuSel_;
             showResult_ = false;
@@ -131,73 +555,98 @@ public:
 
     void onDestroy() override
     {
+        PluginManager::instance().cancelActions(info_->name);
         EventSystem::instance().unsubscribe(this);
     }
 
 private:
+    size_t itemCount() const
+    {
+        return info_->actionCount + ((info_->actionCount > 0U) ? 1U : 0U) +
+               ((info_->codeSize > 0U) ? 1U : 0U);
+    }
+
+    size_t actionIndex(size_t item) const
+    {
+        if (item < info_->actionCount)
+        {
+            return item;
+        }
+        return (item == info_->actionCount && info_->actionCount > 0U) ? PLUGIN_SCRIPT : PLUGIN_PROGRAM;
+    }
+
+    /// Start (or, while it runs, stop) the selected action; never blocks.
     void executeCurrentAction()
     {
-        if (menuSel_ >= info_->actionCount)
+        if (menuSel_ >= itemCount())
         {
             return;
         }
 
-        const PluginAction &act = info_->actions[menuSel_];
+        auto &pm = PluginManager::instance();
+        const size_t index = actionIndex(menuSel_);
         showResult_ = true;
 
+        if (pm.isActionRunning(info_->name, index))
+        {
+            pm.cancelAction(info_->name, index);
+            snprintf(resultMsg_, sizeof(resultMsg_), "Stopped");
+            return;
+        }
+        if (!pm.executeAction(info_->name, index))
+        {
+            snprintf(resultMsg_, sizeof(resultMsg_), "Busy / nothing to run");
+            return;
+        }
+
+        if (index == PLUGIN_SCRIPT)
+        {
+            snprintf(resultMsg_, sizeof(resultMsg_), "Running %u actions",
+                     static_cast<unsigned>(info_->actionCount));
+        }
+        else if (index == PLUGIN_PROGRAM)
+        {
+            snprintf(resultMsg_, sizeof(resultMsg_), "Script started");
+        }
+        else
+        {
+            describe(info_->actions[index]);
+        }
+
+        // Award XP
+        EventSystem::instance().postEvent(
+            {EventType::EVT_XP_EARNED, XP_PLUGIN_LOAD, 0, nullptr});
+    }
+
+    void describe(const PluginAction &act)
+    {
         switch (act.type)
         {
         case PluginActionType::GPIO_TOGGLE:
-        {
-            pinMode(act.pin, OUTPUT);
-            int cur = digitalRead(act.pin);
-            digitalWrite(act.pin, cur == HIGH ? LOW : HIGH);
             snprintf(resultMsg_, sizeof(resultMsg_), "Pin %ld toggled", static_cast<long>(act.pin));
             break;
-        }
         case PluginActionType::GPIO_HIGH:
-            pinMode(act.pin, OUTPUT);
-            digitalWrite(act.pin, HIGH);
             snprintf(resultMsg_, sizeof(resultMsg_), "Pin %ld HIGH", static_cast<long>(act.pin));
             break;
         case PluginActionType::GPIO_LOW:
-            pinMode(act.pin, OUTPUT);
-            digitalWrite(act.pin, LOW);
             snprintf(resultMsg_, sizeof(resultMsg_), "Pin %ld LOW", static_cast<long>(act.pin));
             break;
         case PluginActionType::PWM_TONE:
-            ledcSetup(1, act.value, 8);
-            ledcAttachPin(act.pin, 1);
-            ledcWriteTone(1, act.value);
-            if (act.duration > 0)
-            {
-                delay(act.duration);
-                ledcWriteTone(1, 0);
-            }
             snprintf(resultMsg_, sizeof(resultMsg_), "Tone %ldHz", static_cast<long>(act.value));
             break;
         case PluginActionType::FREQ_SET:
             snprintf(resultMsg_, sizeof(resultMsg_), "Freq: %ld", static_cast<long>(act.value));
             break;
         case PluginActionType::DELAY_MS:
-            if (act.value > 0)
-            {
-                delay(act.value > 5000 ? 5000 : act.value);
-            }
-            snprintf(resultMsg_, sizeof(resultMsg_), "Waited %ldms", static_cast<long>(act.value > 5000 ? 5000 : (act.value > 0 ? act.value : 0)));
+            snprintf(resultMsg_, sizeof(resultMsg_), "Waiting %ldms", static_cast<long>(act.value));
             break;
         case PluginActionType::LOG_MSG:
-            ESP_LOGI(TAG_PM, "Plugin log: %s", act.label);
             snprintf(resultMsg_, sizeof(resultMsg_), "Logged OK");
             break;
         default:
             snprintf(resultMsg_, sizeof(resultMsg_), "Unknown action");
             break;
         }
-
-        // Award XP
-        EventSystem::instance().postEvent(
-            {EventType::EVT_XP_EARNED, XP_PLUGIN_LOAD, 0, nullptr});
     }
 
     const PluginInfo *info_;
@@ -431,6 +880,9 @@ bool PluginManager::deletePlugin(const char *name)
             auto &vfs = storage::VirtualFS::instance();
             if (vfs.remove(path))
             {
+                // Running ops and tags point at plugin indices about to shift
+                cancelAllActions();
+
                 // Clear the plugin slot to release any associated data
                 g_pluginSlots[i] = nullptr;
 
@@ -457,18 +909,249 @@ bool PluginManager::deletePlugin(const char *name)
     return false;
 }
 
+size_t PluginManager::indexOf(const char *name) const
+{
+    if (name == nullptr)
+    {
+        return MAX_PLUGINS;
+    }
+    for (size_t i = 0U; i < pluginCount_; ++i)
+    {
+        if (strcmp(plugins_[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return MAX_PLUGINS;
+}
+
 bool PluginManager::executeAction(const char *pluginName, size_t actionIndex)
 {
-    const PluginInfo *info = findPlugin(pluginName);
-    if (info == nullptr || actionIndex >= info->actionCount)
+    const size_t idx = indexOf(pluginName);
+    if (idx >= pluginCount_)
+    {
+        return false;
+    }
+    const PluginInfo &info = plugins_[idx];
+    const uint16_t tag = actionTag(idx, actionIndex);
+
+    if (actionIndex == PLUGIN_PROGRAM)
+    {
+        if (info.codeSize == 0U || !ensureSequencer())
+        {
+            return false;
+        }
+        xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+        const bool started = startScriptLocked(info, tag);
+        pumpLocked();
+        xSemaphoreGive(g_seqMutex);
+        if (!started)
+        {
+            ESP_LOGW(TAG_PM, "%s: all %u script slots busy", info.name,
+                     static_cast<unsigned>(MAX_PLUGIN_VMS));
+        }
+        return started;
+    }
+
+    const bool script = actionIndex == PLUGIN_SCRIPT;
+    if (!script && actionIndex >= info.actionCount)
+    {
+        return false;
+    }
+    const size_t first = script ? 0U : actionIndex;
+    const size_t last = script ? info.actionCount : actionIndex + 1U;
+    const size_t opCount = static_cast<size_t>(info.opStart[last] - info.opStart[first]);
+    if (opCount == 0U || !ensureSequencer())
     {
         return false;
     }
 
-    // Action execution is handled by the PluginApp when launched
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    g_sequencer.cancelTag(tag);   // restart if still running
+    const int handle = g_sequencer.start(&info.ops[info.opStart[first]], opCount, tag);
+    pumpLocked();   // the first ops run now, the rest on the timer
+    xSemaphoreGive(g_seqMutex);
+
+    if (handle == ActionSequencer::INVALID)
+    {
+        ESP_LOGW(TAG_PM, "%s: all %u action slots busy", info.name,
+                 static_cast<unsigned>(ActionSequencer::MAX_TASKS));
+        return false;
+    }
     return true;
 }
 
+bool PluginManager::isActionRunning(const char *pluginName, size_t actionIndex) const
+{
+    const size_t idx = indexOf(pluginName);
+    if (idx >= pluginCount_ || actionIndex > PLUGIN_PROGRAM || g_seqTimer == nullptr)
+    {
+        return false;
+    }
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    const bool running = runningTagLocked(actionTag(idx, actionIndex));
+    xSemaphoreGive(g_seqMutex);
+    return running;
+}
+
+void PluginManager::cancelAction(const char *pluginName, size_t actionIndex)
+{
+    const size_t idx = indexOf(pluginName);
+    if (idx >= pluginCount_ || actionIndex > PLUGIN_PROGRAM || g_seqTimer == nullptr)
+    {
+        return;
+    }
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    cancelTagLocked(actionTag(idx, actionIndex));
+    pumpLocked();
+    xSemaphoreGive(g_seqMutex);
+}
+
+void PluginManager::cancelActions(const char *pluginName)
+{
+    const size_t idx = indexOf(pluginName);
+    if (idx >= pluginCount_ || g_seqTimer == nullptr)
+    {
+        return;
+    }
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    for (size_t a = 0U; a <= PLUGIN_PROGRAM; ++a)
+    {
+        cancelTagLocked(actionTag(idx, a));
+    }
+    pumpLocked();
+    xSemaphoreGive(g_seqMutex);
+}
+
+bool PluginManager::scriptOutput(const char *pluginName, char *out, size_t outSize) const
+{
+    const size_t idx = indexOf(pluginName);
+    if (idx >= pluginCount_ || out == nullptr || outSize == 0U || g_seqTimer == nullptr)
+    {
+        return false;
+    }
+    xSemaphoreTake(g_seqMutex, portMAX_DELAY);
+    const VmSlot *slot = findVm(actionTag(idx, PLUGIN_PROGRAM));
+    if (slot != nullptr)
+    {
+        const long shown = static_cast<long>(slot->shown);
+        switch (slot->vm.status())
+        {
+        case VmStatus::FAULT:
+            snprintf(out, outSize, "Fault: %s", slot->vm.faultMessage());
+            break;
+        case VmStatus::DONE:
+            snprintf(out, outSize, slot->hasShown ? "Done = %ld" : "Done", shown);
+            break;
+        case VmStatus::IDLE:
+            snprintf(out, outSize, "Stopped");
+            break;
+        default:
+            snprintf(out, outSize, slot->hasShown ? "= %ld" : "Running...", shown);
+            break;
+        }
+    }
+    xSemaphoreGive(g_seqMutex);
+    return slot != nullptr;
+}
+
+void PluginManager::compileScript(const char *json, PluginInfo &info)
+{
+    info.codeSize = 0U;
+    const char *pos = strstr(json, "\"script\"");
+    if (pos == nullptr)
+    {
+        return;
+    }
+    pos += 8;
+    while (*pos == ' ' || *pos == ':' || *pos == '\t' || *pos == '\n' || *pos == '\r')
+    {
+        ++pos;
+    }
+    if (*pos != '"')
+    {
+        return;
+    }
+    const char *src = ++pos;
+    while (*pos != '\0' && *pos != '"')
+    {
+        pos += (*pos == '\\' && pos[1] != '\0') ? 2 : 1;   // escapes stay for the lexer
+    }
+
+    VmCompiler compiler;
+    size_t size = 0U;
+    if (!compiler.compile(src, static_cast<size_t>(pos - src), info.code, sizeof(info.code), size))
+    {
+        ESP_LOGW(TAG_PM, "%s: script error at %u: %s", info.name,
+                 static_cast<unsigned>(compiler.errorOffset()), compiler.error());
+        return;
+    }
+    info.codeSize = static_cast<uint16_t>(size);
+    ESP_LOGI(TAG_PM, "%s: script compiled to %u bytes", info.name, static_cast<unsigned>(size));
+}
+
+void PluginManager::compileActions(PluginInfo &info)
+{
+    size_t n = 0U;
+    for (size_t i = 0U; i < info.actionCount; ++i)
+    {
+        const PluginAction &act = info.actions[i];
+        info.opStart[i] = static_cast<uint8_t>(n);
+
+        const bool needsPin = act.type == PluginActionType::GPIO_TOGGLE ||
+                              act.type == PluginActionType::GPIO_HIGH ||
+                              act.type == PluginActionType::GPIO_LOW ||
+                              act.type == PluginActionType::PWM_TONE;
+        if (needsPin && (act.pin < 0 || act.pin > MAX_PLUGIN_GPIO))
+        {
+            ESP_LOGW(TAG_PM, "%s: action '%s' has invalid pin %ld, skipped", info.name,
+                     act.label, static_cast<long>(act.pin));
+            continue;
+        }
+        const uint8_t pin = static_cast<uint8_t>(needsPin ? act.pin : 0);
+        const uint16_t aux = static_cast<uint16_t>(i);
+
+        switch (act.type)
+        {
+        case PluginActionType::GPIO_TOGGLE:
+            info.ops[n++] = {SeqOpCode::PIN_TOGGLE, pin, aux, 0U};
+            break;
+        case PluginActionType::GPIO_HIGH:
+            info.ops[n++] = {SeqOpCode::PIN_HIGH, pin, aux, 0U};
+            break;
+        case PluginActionType::GPIO_LOW:
+            info.ops[n++] = {SeqOpCode::PIN_LOW, pin, aux, 0U};
+            break;
+        case PluginActionType::PWM_TONE:
+        {
+            const uint32_t hz = (act.value > 0) ? static_cast<uint32_t>(act.value) : 0U;
+            info.ops[n++] = {SeqOpCode::TONE, pin, aux, hz};
+            if (act.duration > 0 && hz != 0U)
+            {
+                const uint32_t ms = (act.duration > 600000) ? 600000U : static_cast<uint32_t>(act.duration);
+                info.ops[n++] = {SeqOpCode::WAIT_US, 0U, aux, ms * 1000U};
+                info.ops[n++] = {SeqOpCode::TONE, pin, aux, 0U};
+            }
+            break;
+        }
+        case PluginActionType::DELAY_MS:
+            if (act.value > 0)
+            {
+                const uint32_t ms = (act.value > 600000) ? 600000U : static_cast<uint32_t>(act.value);
+                info.ops[n++] = {SeqOpCode::WAIT_US, 0U, aux, ms * 1000U};
+            }
+            break;
+        case PluginActionType::FREQ_SET:
+        case PluginActionType::LOG_MSG:
+            info.ops[n++] = {SeqOpCode::NOTE, 0U, aux, static_cast<uint32_t>(act.value)};
+            break;
+        default:
+            break;
+        }
+    }
+    info.opStart[info.actionCount] = static_cast<uint8_t>(n);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // JSON Parsing (lightweight, no external dependency)
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -541,6 +1224,8 @@ bool PluginManager::parsePluginFile(const char *path, PluginInfo &info)
 
     // Actions
     info.actionCount = parseActions(buf, info.actions, MAX_PLUGIN_ACTIONS);
+    compileActions(info);
+    compileScript(buf, info);
 
     return true;
 }
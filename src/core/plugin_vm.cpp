@@ -0,0 +1,1047 @@
+/**
+ * @file plugin_vm.cpp
+ * @brief Plugin script compiler and bytecode VM (see plugin_vm.h).
+ */
+
+#include "core/plugin_vm.h"
+
+#include <cstring>
+
+namespace hackos::core {
+
+namespace {
+
+constexpr uint32_t MAX_WAIT_MS = 600000U;
+
+bool isNameStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isNameChar(char c)
+{
+    return isNameStart(c) || (c >= '0' && c <= '9');
+}
+
+const char *const KEYWORDS[] = {
+    "repeat", "while", "if", "else", "out", "tone", "wait", "print",
+    "show", "freq", "stop", "pin", "adc", "ms",
+};
+
+bool isKeyword(const char *name)
+{
+    for (const char *kw : KEYWORDS)
+    {
+        if (strcmp(name, kw) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Operand bytes following each opcode.
+size_t operandBytes(VmOp op)
+{
+    switch (op)
+    {
+    case VmOp::PUSH8:
+    case VmOp::LOAD:
+    case VmOp::STORE:
+        return 1U;
+    case VmOp::JMP:
+    case VmOp::JZ:
+        return 2U;
+    case VmOp::REPEAT:
+        return 3U;
+    case VmOp::PUSH32:
+        return 4U;
+    default:
+        return 0U;
+    }
+}
+
+uint16_t readU16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+int32_t wrap(uint32_t v)
+{
+    return static_cast<int32_t>(v);
+}
+
+} // namespace
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// VmCompiler – recursive descent, emits as it parses
+// ═══════════════════════════════════════════════════════════════════════════════
+
+VmCompiler::VmCompiler()
+    : src_(nullptr),
+      len_(0U),
+      pos_(0U),
+      code_(nullptr),
+      cap_(0U),
+      size_(0U),
+      depth_(0),
+      nesting_(0U),
+      varCount_(0U),
+      vars_{},
+      error_(nullptr),
+      errorOffset_(0U)
+{
+}
+
+bool VmCompiler::compile(const char *src, size_t len, uint8_t *code, size_t cap, size_t &size)
+{
+    src_ = src;
+    len_ = len;
+    pos_ = 0U;
+    code_ = code;
+    cap_ = (cap < MAX_CODE) ? cap : MAX_CODE;
+    size_ = 0U;
+    depth_ = 0;
+    nesting_ = 0U;
+    varCount_ = 0U;
+    error_ = nullptr;
+    errorOffset_ = 0U;
+    size = 0U;
+
+    if (src == nullptr || code == nullptr)
+    {
+        return fail("no source");
+    }
+    if (!statements(false) || !emit(VmOp::HALT))
+    {
+        return false;
+    }
+    size = size_;
+    return true;
+}
+
+// ── Lexer ────────────────────────────────────────────────────────────────────
+
+void VmCompiler::skipSpace()
+{
+    while (pos_ < len_)
+    {
+        const char c = src_[pos_];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ';')
+        {
+            ++pos_;
+        }
+        else if (c == '\\')
+        {
+            pos_ += 2U;   // JSON escape (\n, \t) inside the script string
+        }
+        else if (c == '/' && pos_ + 1U < len_ && src_[pos_ + 1U] == '/')
+        {
+            while (pos_ < len_ && src_[pos_] != '\n' &&
+                   !(src_[pos_] == '\\' && pos_ + 1U < len_ && src_[pos_ + 1U] == 'n'))
+            {
+                ++pos_;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    pos_ = (pos_ < len_) ? pos_ : len_;
+}
+
+bool VmCompiler::atEnd()
+{
+    skipSpace();
+    return pos_ >= len_;
+}
+
+bool VmCompiler::accept(const char *tok)
+{
+    skipSpace();
+    const size_t n = strlen(tok);
+    if (pos_ + n <= len_ && memcmp(src_ + pos_, tok, n) == 0)
+    {
+        pos_ += n;
+        return true;
+    }
+    return false;
+}
+
+bool VmCompiler::peekWord(const char *word)
+{
+    skipSpace();
+    const size_t n = strlen(word);
+    return pos_ + n <= len_ && memcmp(src_ + pos_, word, n) == 0 &&
+           (pos_ + n == len_ || !isNameChar(src_[pos_ + n]));
+}
+
+bool VmCompiler::acceptWord(const char *word)
+{
+    if (!peekWord(word))
+    {
+        return false;
+    }
+    pos_ += strlen(word);
+    return true;
+}
+
+bool VmCompiler::readName(char *out, size_t outSize)
+{
+    skipSpace();
+    if (pos_ >= len_ || !isNameStart(src_[pos_]))
+    {
+        return false;
+    }
+    size_t n = 0U;
+    while (pos_ < len_ && isNameChar(src_[pos_]))
+    {
+        if (n + 1U >= outSize)
+        {
+            return fail("name too long");
+        }
+        out[n++] = src_[pos_++];
+    }
+    out[n] = '\0';
+    return true;
+}
+
+// ── Statements ───────────────────────────────────────────────────────────────
+
+bool VmCompiler::statements(bool inBlock)
+{
+    for (;;)
+    {
+        if (atEnd())
+        {
+            return inBlock ? fail("missing '}'") : true;
+        }
+        if (inBlock && accept("}"))
+        {
+            return true;
+        }
+        if (!statement())
+        {
+            return false;
+        }
+    }
+}
+
+bool VmCompiler::block()
+{
+    if (!accept("{"))
+    {
+        return fail("expected '{'");
+    }
+    return statements(true);
+}
+
+bool VmCompiler::statement()
+{
+    if (acceptWord("repeat"))
+    {
+        if (nesting_ >= MAX_NESTING)
+        {
+            return fail("repeat nested too deep");
+        }
+        const uint8_t reg = static_cast<uint8_t>(MAX_VARS + nesting_);
+        if (!expression() || !emit(VmOp::STORE) || !emitByte(reg) || !pushed(-1))
+        {
+            return false;
+        }
+        const size_t top = size_;
+        if (!emit(VmOp::REPEAT) || !emitByte(reg) || !emitU16(0U))
+        {
+            return false;
+        }
+        const size_t hole = size_ - 2U;
+        ++nesting_;
+        const bool ok = block();
+        --nesting_;
+        if (!ok || !emit(VmOp::JMP) || !emitU16(static_cast<uint16_t>(top)))
+        {
+            return false;
+        }
+        patchU16(hole, static_cast<uint16_t>(size_));
+        return true;
+    }
+    if (acceptWord("while"))
+    {
+        const size_t top = size_;
+        if (!expression() || !emit(VmOp::JZ) || !emitU16(0U) || !pushed(-1))
+        {
+            return false;
+        }
+        const size_t hole = size_ - 2U;
+        if (!block() || !emit(VmOp::JMP) || !emitU16(static_cast<uint16_t>(top)))
+        {
+            return false;
+        }
+        patchU16(hole, static_cast<uint16_t>(size_));
+        return true;
+    }
+    if (acceptWord("if"))
+    {
+        if (!expression() || !emit(VmOp::JZ) || !emitU16(0U) || !pushed(-1))
+        {
+            return false;
+        }
+        const size_t hole = size_ - 2U;
+        if (!block())
+        {
+            return false;
+        }
+        if (!acceptWord("else"))
+        {
+            patchU16(hole, static_cast<uint16_t>(size_));
+            return true;
+        }
+        if (!emit(VmOp::JMP) || !emitU16(0U))
+        {
+            return false;
+        }
+        const size_t skip = size_ - 2U;
+        patchU16(hole, static_cast<uint16_t>(size_));
+        if (!(peekWord("if") ? statement() : block()))
+        {
+            return false;
+        }
+        patchU16(skip, static_cast<uint16_t>(size_));
+        return true;
+    }
+    const bool out = acceptWord("out");
+    if (out || acceptWord("tone"))
+    {
+        if (!expression())
+        {
+            return false;
+        }
+        if (!accept(","))
+        {
+            return fail("expected ','");
+        }
+        return expression() && emit(out ? VmOp::OUT : VmOp::TONE) && pushed(-2);
+    }
+
+    static const struct
+    {
+        const char *word;
+        VmOp op;
+    } UNARY_STMTS[] = {
+        {"wait", VmOp::WAIT},
+        {"print", VmOp::PRINT},
+        {"show", VmOp::SHOW},
+        {"freq", VmOp::FREQ},
+    };
+    for (const auto &s : UNARY_STMTS)
+    {
+        if (acceptWord(s.word))
+        {
+            return expression() && emit(s.op) && pushed(-1);
+        }
+    }
+    if (acceptWord("stop"))
+    {
+        return emit(VmOp::HALT);
+    }
+
+    // Assignment
+    const size_t at = pos_;
+    char name[sizeof(vars_[0])];
+    if (!readName(name, sizeof(name)))
+    {
+        return error_ != nullptr ? false : fail("expected a statement");
+    }
+    if (isKeyword(name))
+    {
+        pos_ = at;
+        return fail("unexpected keyword");
+    }
+    if (!accept("=") || (pos_ < len_ && src_[pos_] == '='))
+    {
+        return fail("expected '='");
+    }
+    if (!expression())
+    {
+        return false;
+    }
+    const int reg = lookupVar(name, true);
+    if (reg < 0)
+    {
+        pos_ = at;
+        return fail("too many variables");
+    }
+    return emit(VmOp::STORE) && emitByte(static_cast<uint8_t>(reg)) && pushed(-1);
+}
+
+// ── Expressions ──────────────────────────────────────────────────────────────
+
+bool VmCompiler::expression()
+{
+    return logic();
+}
+
+bool VmCompiler::logic()
+{
+    if (!comparison())
+    {
+        return false;
+    }
+    for (;;)
+    {
+        VmOp op;
+        if (accept("&&"))
+        {
+            op = VmOp::AND;
+        }
+        else if (accept("||"))
+        {
+            op = VmOp::OR;
+        }
+        else
+        {
+            return true;
+        }
+        if (!comparison() || !emit(op) || !pushed(-1))
+        {
+            return false;
+        }
+    }
+}
+
+bool VmCompiler::comparison()
+{
+    if (!sum())
+    {
+        return false;
+    }
+    static const struct
+    {
+        const char *tok;
+        VmOp op;
+    } CMPS[] = {
+        {"==", VmOp::EQ}, {"!=", VmOp::NE}, {"<=", VmOp::LE},
+        {">=", VmOp::GE}, {"<", VmOp::LT},  {">", VmOp::GT},
+    };
+    for (const auto &c : CMPS)
+    {
+        if (accept(c.tok))
+        {
+            return sum() && emit(c.op) && pushed(-1);
+        }
+    }
+    return true;
+}
+
+bool VmCompiler::sum()
+{
+    if (!term())
+    {
+        return false;
+    }
+    for (;;)
+    {
+        VmOp op;
+        if (accept("+"))
+        {
+            op = VmOp::ADD;
+        }
+        else if (accept("-"))
+        {
+            op = VmOp::SUB;
+        }
+        else
+        {
+            return true;
+        }
+        if (!term() || !emit(op) || !pushed(-1))
+        {
+            return false;
+        }
+    }
+}
+
+bool VmCompiler::term()
+{
+    if (!unary())
+    {
+        return false;
+    }
+    for (;;)
+    {
+        VmOp op;
+        if (accept("*"))
+        {
+            op = VmOp::MUL;
+        }
+        else if (accept("/"))
+        {
+            op = VmOp::DIV;
+        }
+        else if (accept("%"))
+        {
+            op = VmOp::MOD;
+        }
+        else
+        {
+            return true;
+        }
+        if (!unary() || !emit(op) || !pushed(-1))
+        {
+            return false;
+        }
+    }
+}
+
+bool VmCompiler::unary()
+{
+    if (accept("-"))
+    {
+        return unary() && emit(VmOp::NEG);
+    }
+    if (accept("!"))
+    {
+        // "!=" belongs to comparison(); only reached at operand start.
+        return unary() && emit(VmOp::NOT);
+    }
+    return primary();
+}
+
+bool VmCompiler::call1(VmOp op)
+{
+    if (!accept("("))
+    {
+        return fail("expected '('");
+    }
+    if (!expression())
+    {
+        return false;
+    }
+    if (!accept(")"))
+    {
+        return fail("expected ')'");
+    }
+    return emit(op);
+}
+
+bool VmCompiler::primary()
+{
+    skipSpace();
+    if (pos_ >= len_)
+    {
+        return fail("expected a value");
+    }
+
+    const char c = src_[pos_];
+    if (c >= '0' && c <= '9')
+    {
+        uint64_t v = 0U;
+        const bool hex = c == '0' && pos_ + 1U < len_ && (src_[pos_ + 1U] == 'x' || src_[pos_ + 1U] == 'X');
+        pos_ += hex ? 2U : 0U;
+        const size_t start = pos_;
+        while (pos_ < len_)
+        {
+            const char d = src_[pos_];
+            uint32_t digit;
+            if (d >= '0' && d <= '9')
+            {
+                digit = static_cast<uint32_t>(d - '0');
+            }
+            else if (hex && ((d >= 'a' && d <= 'f') || (d >= 'A' && d <= 'F')))
+            {
+                digit = static_cast<uint32_t>((d | 0x20) - 'a' + 10);
+            }
+            else
+            {
+                break;
+            }
+            v = v * (hex ? 16U : 10U) + digit;
+            if (v > (hex ? 0xFFFFFFFFULL : 0x7FFFFFFFULL))
+            {
+                return fail("number too large");
+            }
+            ++pos_;
+        }
+        if (pos_ == start || (pos_ < len_ && isNameChar(src_[pos_])))
+        {
+            return fail("bad number");
+        }
+        return emitPush(static_cast<int32_t>(static_cast<uint32_t>(v))) && pushed(1);
+    }
+    if (accept("("))
+    {
+        if (!expression())
+        {
+            return false;
+        }
+        return accept(")") ? true : fail("expected ')'");
+    }
+    if (acceptWord("pin"))
+    {
+        return call1(VmOp::PIN);
+    }
+    if (acceptWord("adc"))
+    {
+        return call1(VmOp::ADC);
+    }
+    if (acceptWord("ms"))
+    {
+        if (!accept("(") || !accept(")"))
+        {
+            return fail("expected 'ms()'");
+        }
+        return emit(VmOp::MS) && pushed(1);
+    }
+
+    const size_t at = pos_;
+    char name[sizeof(vars_[0])];
+    if (!readName(name, sizeof(name)))
+    {
+        return error_ != nullptr ? false : fail("expected a value");
+    }
+    const int reg = isKeyword(name) ? -1 : lookupVar(name, false);
+    if (reg < 0)
+    {
+        pos_ = at;
+        return fail("unknown variable");
+    }
+    return emit(VmOp::LOAD) && emitByte(static_cast<uint8_t>(reg)) && pushed(1);
+}
+
+// ── Emitter ──────────────────────────────────────────────────────────────────
+
+bool VmCompiler::emitByte(uint8_t b)
+{
+    if (size_ >= cap_)
+    {
+        return fail("script too large");
+    }
+    code_[size_++] = b;
+    return true;
+}
+
+bool VmCompiler::emit(VmOp op)
+{
+    return emitByte(static_cast<uint8_t>(op));
+}
+
+bool VmCompiler::emitU16(uint16_t v)
+{
+    return emitByte(static_cast<uint8_t>(v & 0xFFU)) && emitByte(static_cast<uint8_t>(v >> 8));
+}
+
+bool VmCompiler::emitPush(int32_t v)
+{
+    if (v >= -128 && v <= 127)
+    {
+        return emit(VmOp::PUSH8) && emitByte(static_cast<uint8_t>(static_cast<int8_t>(v)));
+    }
+    const uint32_t u = static_cast<uint32_t>(v);
+    return emit(VmOp::PUSH32) && emitByte(static_cast<uint8_t>(u)) &&
+           emitByte(static_cast<uint8_t>(u >> 8)) && emitByte(static_cast<uint8_t>(u >> 16)) &&
+           emitByte(static_cast<uint8_t>(u >> 24));
+}
+
+void VmCompiler::patchU16(size_t at, uint16_t v)
+{
+    code_[at] = static_cast<uint8_t>(v & 0xFFU);
+    code_[at + 1U] = static_cast<uint8_t>(v >> 8);
+}
+
+int VmCompiler::lookupVar(const char *name, bool create)
+{
+    for (size_t i = 0U; i < varCount_; ++i)
+    {
+        if (strcmp(vars_[i], name) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    if (!create || varCount_ >= MAX_VARS)
+    {
+        return -1;
+    }
+    strncpy(vars_[varCount_], name, sizeof(vars_[0]) - 1U);
+    return static_cast<int>(varCount_++);
+}
+
+bool VmCompiler::pushed(int delta)
+{
+    depth_ += delta;
+    return (depth_ > static_cast<int>(MAX_STACK)) ? fail("expression too deep") : true;
+}
+
+bool VmCompiler::fail(const char *message)
+{
+    if (error_ == nullptr)
+    {
+        error_ = message;
+        errorOffset_ = pos_;
+    }
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PluginVm
+// ═══════════════════════════════════════════════════════════════════════════════
+
+PluginVm::PluginVm(VmBackend &backend)
+    : backend_(backend),
+      code_(nullptr),
+      size_(0U),
+      pc_(0U),
+      sp_(0U),
+      stack_{},
+      regs_{},
+      tonePins_(0U),
+      executed_(0U),
+      status_(VmStatus::IDLE),
+      fault_(nullptr),
+      faultPc_(0U)
+{
+}
+
+bool PluginVm::load(const uint8_t *code, size_t size)
+{
+    stop();
+    if (code == nullptr || size == 0U || size > VmCompiler::MAX_CODE)
+    {
+        return false;
+    }
+
+    // Walk once for opcodes / registers, then check every jump target is
+    // the start of an instruction (or the end).
+    auto isStart = [&](size_t target) {
+        for (size_t pc = 0U; pc <= size;)
+        {
+            if (pc == target)
+            {
+                return true;
+            }
+            if (pc == size || pc > target)
+            {
+                return false;
+            }
+            pc += 1U + operandBytes(static_cast<VmOp>(code[pc]));
+        }
+        return false;
+    };
+    for (size_t pc = 0U; pc < size;)
+    {
+        const uint8_t raw = code[pc];
+        if (raw >= static_cast<uint8_t>(VmOp::COUNT_))
+        {
+            return false;
+        }
+        const VmOp op = static_cast<VmOp>(raw);
+        const size_t n = operandBytes(op);
+        if (pc + 1U + n > size)
+        {
+            return false;
+        }
+        const uint8_t *arg = code + pc + 1U;
+        const bool hasReg = op == VmOp::LOAD || op == VmOp::STORE || op == VmOp::REPEAT;
+        if (hasReg && arg[0] >= REGS)
+        {
+            return false;
+        }
+        if (op == VmOp::JMP || op == VmOp::JZ || op == VmOp::REPEAT)
+        {
+            const uint16_t target = readU16(op == VmOp::REPEAT ? arg + 1 : arg);
+            if (target > size || !isStart(target))
+            {
+                return false;
+            }
+        }
+        pc += 1U + n;
+    }
+
+    code_ = code;
+    size_ = size;
+    pc_ = 0U;
+    sp_ = 0U;
+    memset(regs_, 0, sizeof(regs_));
+    executed_ = 0U;
+    fault_ = nullptr;
+    faultPc_ = 0U;
+    status_ = VmStatus::RUNNING;
+    return true;
+}
+
+void PluginVm::stop()
+{
+    for (uint8_t pin = 0U; tonePins_ != 0U; ++pin)
+    {
+        if ((tonePins_ & (1ULL << pin)) != 0U)
+        {
+            (void)backend_.tone(pin, 0U);
+            tonePins_ &= ~(1ULL << pin);
+        }
+    }
+    status_ = VmStatus::IDLE;
+}
+
+VmStatus PluginVm::trap(const char *message, size_t pc)
+{
+    fault_ = message;
+    faultPc_ = pc;
+    stop();
+    status_ = VmStatus::FAULT;
+    return status_;
+}
+
+VmStatus PluginVm::run(uint32_t budget, uint32_t &waitUs)
+{
+    waitUs = 0U;
+    if (status_ != VmStatus::RUNNING && status_ != VmStatus::WAITING)
+    {
+        return status_;
+    }
+    status_ = VmStatus::RUNNING;
+
+    const uint8_t *const code = code_;
+    int32_t *const st = stack_;
+    size_t pc = pc_;
+    size_t sp = sp_;
+    uint32_t done = 0U;
+    VmStatus result = VmStatus::RUNNING;
+
+    while (done < budget)
+    {
+        if (pc >= size_)
+        {
+            result = VmStatus::DONE;
+            break;
+        }
+        const size_t at = pc;
+        const VmOp op = static_cast<VmOp>(code[pc++]);
+        ++done;
+
+        // Binary ops pop two and push one; everything else is explicit.
+        if (op >= VmOp::ADD && op <= VmOp::OR)
+        {
+            if (sp < 2U)
+            {
+                result = trap("stack underflow", at);
+                break;
+            }
+            const int32_t b = st[--sp];
+            const int32_t a = st[sp - 1U];
+            int32_t r = 0;
+            switch (op)
+            {
+            case VmOp::ADD: r = wrap(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); break;
+            case VmOp::SUB: r = wrap(static_cast<uint32_t>(a) - static_cast<uint32_t>(b)); break;
+            case VmOp::MUL: r = wrap(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); break;
+            case VmOp::DIV:
+            case VmOp::MOD:
+                if (b == 0)
+                {
+                    result = trap("division by zero", at);
+                    break;
+                }
+                if (b == -1)
+                {
+                    r = (op == VmOp::DIV) ? wrap(0U - static_cast<uint32_t>(a)) : 0;
+                }
+                else
+                {
+                    r = (op == VmOp::DIV) ? a / b : a % b;
+                }
+                break;
+            case VmOp::EQ: r = (a == b) ? 1 : 0; break;
+            case VmOp::NE: r = (a != b) ? 1 : 0; break;
+            case VmOp::LT: r = (a < b) ? 1 : 0; break;
+            case VmOp::GT: r = (a > b) ? 1 : 0; break;
+            case VmOp::LE: r = (a <= b) ? 1 : 0; break;
+            case VmOp::GE: r = (a >= b) ? 1 : 0; break;
+            case VmOp::AND: r = (a != 0 && b != 0) ? 1 : 0; break;
+            case VmOp::OR: r = (a != 0 || b != 0) ? 1 : 0; break;
+            default: break;
+            }
+            if (result == VmStatus::FAULT)
+            {
+                break;
+            }
+            st[sp - 1U] = r;
+            continue;
+        }
+
+        switch (op)
+        {
+        case VmOp::HALT:
+            pc = size_;
+            result = VmStatus::DONE;
+            break;
+        case VmOp::PUSH8:
+        case VmOp::PUSH32:
+        case VmOp::LOAD:
+        case VmOp::MS:
+            if (sp >= STACK)
+            {
+                result = trap("stack overflow", at);
+                break;
+            }
+            if (op == VmOp::PUSH8)
+            {
+                st[sp++] = static_cast<int8_t>(code[pc++]);
+            }
+            else if (op == VmOp::PUSH32)
+            {
+                st[sp++] = wrap(static_cast<uint32_t>(code[pc]) | (static_cast<uint32_t>(code[pc + 1U]) << 8) |
+                                (static_cast<uint32_t>(code[pc + 2U]) << 16) |
+                                (static_cast<uint32_t>(code[pc + 3U]) << 24));
+                pc += 4U;
+            }
+            else if (op == VmOp::LOAD)
+            {
+                st[sp++] = regs_[code[pc++]];
+            }
+            else
+            {
+                st[sp++] = static_cast<int32_t>(backend_.nowMs() & 0x7FFFFFFFU);
+            }
+            break;
+        case VmOp::STORE:
+        case VmOp::JZ:
+        case VmOp::WAIT:
+        case VmOp::PRINT:
+        case VmOp::SHOW:
+        case VmOp::FREQ:
+        {
+            if (sp < 1U)
+            {
+                result = trap("stack underflow", at);
+                break;
+            }
+            const int32_t v = st[--sp];
+            if (op == VmOp::STORE)
+            {
+                regs_[code[pc++]] = v;
+            }
+            else if (op == VmOp::JZ)
+            {
+                pc = (v == 0) ? readU16(code + pc) : pc + 2U;
+            }
+            else if (op == VmOp::WAIT)
+            {
+                const uint32_t ms = (v <= 0) ? 0U : static_cast<uint32_t>(v);
+                waitUs = ((ms < MAX_WAIT_MS) ? ms : MAX_WAIT_MS) * 1000U;
+                result = VmStatus::WAITING;
+            }
+            else
+            {
+                backend_.output((op == VmOp::PRINT) ? VmOutput::PRINT
+                                : (op == VmOp::SHOW) ? VmOutput::SHOW
+                                                     : VmOutput::FREQ,
+                                v);
+            }
+            break;
+        }
+        case VmOp::JMP:
+            pc = readU16(code + pc);
+            break;
+        case VmOp::REPEAT:
+        {
+            int32_t &counter = regs_[code[pc]];
+            if (counter <= 0)
+            {
+                pc = readU16(code + pc + 1U);
+            }
+            else
+            {
+                --counter;
+                pc += 3U;
+            }
+            break;
+        }
+        case VmOp::NOT:
+        case VmOp::NEG:
+        case VmOp::PIN:
+        case VmOp::ADC:
+        {
+            if (sp < 1U)
+            {
+                result = trap("stack underflow", at);
+                break;
+            }
+            int32_t &v = st[sp - 1U];
+            if (op == VmOp::NOT)
+            {
+                v = (v == 0) ? 1 : 0;
+            }
+            else if (op == VmOp::NEG)
+            {
+                v = wrap(0U - static_cast<uint32_t>(v));
+            }
+            else if (v < 0 || v > 63)
+            {
+                result = trap("bad pin", at);
+            }
+            else
+            {
+                const uint8_t pin = static_cast<uint8_t>(v);
+                const bool ok = (op == VmOp::PIN) ? backend_.pinRead(pin, v) : backend_.adcRead(pin, v);
+                if (!ok)
+                {
+                    result = trap("pin not allowed", at);
+                }
+            }
+            break;
+        }
+        case VmOp::OUT:
+        case VmOp::TONE:
+        {
+            if (sp < 2U)
+            {
+                result = trap("stack underflow", at);
+                break;
+            }
+            const int32_t v = st[--sp];
+            const int32_t p = st[--sp];
+            if (p < 0 || p > 63)
+            {
+                result = trap("bad pin", at);
+                break;
+            }
+            const uint8_t pin = static_cast<uint8_t>(p);
+            bool ok;
+            if (op == VmOp::OUT)
+            {
+                ok = backend_.pinWrite(pin, v != 0);
+            }
+            else
+            {
+                const uint32_t hz = (v <= 0) ? 0U : static_cast<uint32_t>(v);
+                ok = backend_.tone(pin, hz);
+                tonePins_ = (ok && hz != 0U) ? (tonePins_ | (1ULL << pin)) : (tonePins_ & ~(1ULL << pin));
+            }
+            if (!ok)
+            {
+                result = trap("pin not allowed", at);
+            }
+            break;
+        }
+        default:
+            result = trap("bad opcode", at);
+            break;
+        }
+        if (result != VmStatus::RUNNING)
+        {
+            break;
+        }
+    }
+
+    executed_ += done;
+    if (result == VmStatus::FAULT)
+    {
+        return result;
+    }
+    pc_ = pc;
+    sp_ = sp;
+    status_ = result;
+    return result;
+}
+
+} // namespace hackos::core
@@ -0,0 +1,107 @@
+/**
+ * @file scratch.cpp
+ * @brief System scratch block and its lock (see scratch.h).
+ */
+
+#include "core/scratch.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static constexpr const char *TAG_SCRATCH = "Scratch";
+
+namespace hackos::core {
+
+Scratch &Scratch::instance()
+{
+    static Scratch scratch;
+    return scratch;
+}
+
+Scratch::Scratch()
+    : storage_{},
+      arena_(storage_, CAPACITY)
+{
+}
+
+uint32_t Scratch::nowMs()
+{
+    return static_cast<uint32_t>(esp_timer_get_time() / 1000);
+}
+
+void *Scratch::lease(const char *tag, size_t bytes)
+{
+    const uint32_t now = nowMs();
+    portENTER_CRITICAL(&mux_);
+    void *p = arena_.lease(tag, bytes, now);
+    const size_t largest = arena_.largestFree();
+    portEXIT_CRITICAL(&mux_);
+
+    if (p == nullptr)
+    {
+        ESP_LOGW(TAG_SCRATCH, "%s: no room for %u B (largest free %u B)",
+                 (tag != nullptr) ? tag : "?", static_cast<unsigned>(bytes),
+                 static_cast<unsigned>(largest));
+    }
+    return p;
+}
+
+void Scratch::release(void *ptr)
+{
+    const uint32_t now = nowMs();
+    portENTER_CRITICAL(&mux_);
+    const bool ok = arena_.release(ptr, now);
+    portEXIT_CRITICAL(&mux_);
+
+    if (!ok && ptr != nullptr)
+    {
+        ESP_LOGE(TAG_SCRATCH, "release of unknown block %p", ptr);
+    }
+}
+
+size_t Scratch::used() const
+{
+    portENTER_CRITICAL(&mux_);
+    const size_t n = arena_.used();
+    portEXIT_CRITICAL(&mux_);
+    return n;
+}
+
+size_t Scratch::peak() const
+{
+    portENTER_CRITICAL(&mux_);
+    const size_t n = arena_.peak();
+    portEXIT_CRITICAL(&mux_);
+    return n;
+}
+
+void Scratch::logStats()
+{
+    ScratchArena::TagStats tags[ScratchArena::MAX_TAGS];
+    portENTER_CRITICAL(&mux_);
+    const size_t used = arena_.used();
+    const size_t peak = arena_.peak();
+    const size_t leases = arena_.leases();
+    for (size_t i = 0U; i < ScratchArena::MAX_TAGS; ++i)
+    {
+        tags[i] = arena_.tagStats(i);
+    }
+    portEXIT_CRITICAL(&mux_);
+
+    ESP_LOGI(TAG_SCRATCH, "used=%u B in %u leases, peak=%u / %u B",
+             static_cast<unsigned>(used), static_cast<unsigned>(leases),
+             static_cast<unsigned>(peak), static_cast<unsigned>(CAPACITY));
+    for (const ScratchArena::TagStats &ts : tags)
+    {
+        if (ts.tag == nullptr)
+        {
+            continue;
+        }
+        ESP_LOGI(TAG_SCRATCH, "  %-10s leases=%lu fails=%lu held=%lu peak=%lu B max hold=%lu ms",
+                 ts.tag, static_cast<unsigned long>(ts.leases),
+                 static_cast<unsigned long>(ts.failures), static_cast<unsigned long>(ts.bytes),
+                 static_cast<unsigned long>(ts.peakBytes), static_cast<unsigned long>(ts.maxHoldMs));
+    }
+}
+
+} // namespace hackos::core
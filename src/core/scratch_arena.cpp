@@ -0,0 +1,171 @@
+/**
+ * @file scratch_arena.cpp
+ * @brief First-fit lease placement and per-tag statistics (see scratch_arena.h).
+ */
+
+#include "core/scratch_arena.h"
+
+#include <cstring>
+
+namespace hackos::core {
+
+ScratchArena::ScratchArena(uint8_t *base, size_t capacity)
+    : base_(base),
+      capacity_(capacity & ~(ALIGN - 1U)),
+      leases_{},
+      count_(0U),
+      used_(0U),
+      peak_(0U),
+      tags_{}
+{
+}
+
+// ── Leases ───────────────────────────────────────────────────────────────────
+
+void *ScratchArena::lease(const char *tag, size_t bytes, uint32_t nowMs)
+{
+    const uint8_t t = tagIndex(tag);
+    const size_t size = footprint(bytes);
+    if (bytes == 0U || size > capacity_ || count_ >= MAX_LEASES)
+    {
+        if (t < MAX_TAGS)
+        {
+            ++tags_[t].failures;
+        }
+        return nullptr;
+    }
+
+    // Lowest gap that fits: before lease i, or after the last one.
+    size_t at = 0U;
+    size_t offset = 0U;
+    for (; at < count_; ++at)
+    {
+        if (leases_[at].offset - offset >= size)
+        {
+            break;
+        }
+        offset = leases_[at].offset + leases_[at].size;
+    }
+    if (at == count_ && capacity_ - offset < size)
+    {
+        if (t < MAX_TAGS)
+        {
+            ++tags_[t].failures;
+        }
+        return nullptr;
+    }
+
+    for (size_t i = count_; i > at; --i)
+    {
+        leases_[i] = leases_[i - 1U];
+    }
+    leases_[at] = Lease{static_cast<uint32_t>(offset), static_cast<uint32_t>(size), nowMs, t};
+    ++count_;
+
+    used_ += size;
+    if (used_ > peak_)
+    {
+        peak_ = used_;
+    }
+    if (t < MAX_TAGS)
+    {
+        TagStats &ts = tags_[t];
+        ++ts.leases;
+        ts.bytes += static_cast<uint32_t>(size);
+        if (ts.bytes > ts.peakBytes)
+        {
+            ts.peakBytes = ts.bytes;
+        }
+    }
+    return base_ + offset;
+}
+
+bool ScratchArena::release(void *ptr, uint32_t nowMs)
+{
+    if (ptr == nullptr)
+    {
+        return false;
+    }
+    const uint8_t *p = static_cast<const uint8_t *>(ptr);
+    for (size_t i = 0U; i < count_; ++i)
+    {
+        const Lease &l = leases_[i];
+        if (base_ + l.offset != p)
+        {
+            continue;
+        }
+        used_ -= l.size;
+        if (l.tag < MAX_TAGS)
+        {
+            TagStats &ts = tags_[l.tag];
+            ts.bytes -= l.size;
+            const uint32_t held = nowMs - l.sinceMs;
+            if (held > ts.maxHoldMs)
+            {
+                ts.maxHoldMs = held;
+            }
+        }
+        for (size_t j = i + 1U; j < count_; ++j)
+        {
+            leases_[j - 1U] = leases_[j];
+        }
+        --count_;
+        return true;
+    }
+    return false;
+}
+
+size_t ScratchArena::largestFree() const
+{
+    if (count_ >= MAX_LEASES)
+    {
+        return 0U;
+    }
+    size_t best = 0U;
+    size_t offset = 0U;
+    for (size_t i = 0U; i < count_; ++i)
+    {
+        const size_t gap = leases_[i].offset - offset;
+        best = (gap > best) ? gap : best;
+        offset = leases_[i].offset + leases_[i].size;
+    }
+    const size_t tail = capacity_ - offset;
+    return (tail > best) ? tail : best;
+}
+
+// ── Statistics ───────────────────────────────────────────────────────────────
+
+uint8_t ScratchArena::tagIndex(const char *tag)
+{
+    if (tag == nullptr)
+    {
+        return static_cast<uint8_t>(MAX_TAGS);
+    }
+    for (size_t i = 0U; i < MAX_TAGS; ++i)
+    {
+        if (tags_[i].tag == nullptr)
+        {
+            tags_[i].tag = tag;
+            return static_cast<uint8_t>(i);
+        }
+        if (tags_[i].tag == tag || std::strcmp(tags_[i].tag, tag) == 0)
+        {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return static_cast<uint8_t>(MAX_TAGS);
+}
+
+void ScratchArena::resetStats()
+{
+    peak_ = used_;
+    for (TagStats &ts : tags_)
+    {
+        ts.leases = 0U;
+        ts.failures = 0U;
+        ts.peakBytes = ts.bytes;
+        ts.maxHoldMs = 0U;
+    }
+}
+
+} // namespace hackos::core
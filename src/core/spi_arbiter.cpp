@@ -0,0 +1,263 @@
+/**
+ * @file spi_arbiter.cpp
+ * @brief SPI bus request ranking and statistics (see spi_arbiter.h).
+ */
+
+#include "core/spi_arbiter.h"
+
+namespace hackos::core {
+
+namespace
+{
+
+constexpr uint8_t OVERDUE_CLASS = static_cast<uint8_t>(BusPriority::LATENCY) + 1U;
+
+/// a < b on a wrapping microsecond clock.
+bool earlier(uint32_t a, uint32_t b)
+{
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+} // namespace
+
+SpiArbiter::SpiArbiter()
+    : reqs_{},
+      holder_(-1),
+      nextSeq_(0U),
+      busyUs_(0U),
+      windowStartUs_(0U),
+      stats_{}
+{
+}
+
+// ── Queue ────────────────────────────────────────────────────────────────────
+
+int SpiArbiter::request(uint8_t client, BusPriority prio, uint32_t budgetUs, uint32_t nowUs)
+{
+    if (client >= MAX_CLIENTS)
+    {
+        return -1;
+    }
+    for (size_t i = 0U; i < MAX_REQUESTS; ++i)
+    {
+        Request &r = reqs_[i];
+        if (r.state != Slot::FREE)
+        {
+            continue;
+        }
+        r.state = Slot::QUEUED;
+        r.client = client;
+        r.prio = prio;
+        r.hasDeadline = budgetUs != 0U;
+        r.seq = nextSeq_++;
+        r.queuedUs = nowUs;
+        r.deadlineUs = nowUs + budgetUs;
+        r.grantedUs = 0U;
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int SpiArbiter::grant(uint32_t nowUs)
+{
+    if (holder_ >= 0)
+    {
+        return -1;
+    }
+
+    int best = -1;
+    for (size_t i = 0U; i < MAX_REQUESTS; ++i)
+    {
+        if (reqs_[i].state == Slot::QUEUED &&
+            (best < 0 || before(reqs_[i], reqs_[best], nowUs)))
+        {
+            best = static_cast<int>(i);
+        }
+    }
+    if (best < 0)
+    {
+        return -1;
+    }
+
+    Request &r = reqs_[best];
+    r.state = Slot::GRANTED;
+    r.grantedUs = nowUs;
+    holder_ = best;
+
+    ClientStats &st = stats_[r.client];
+    const uint32_t waitUs = nowUs - r.queuedUs;
+    ++st.grants;
+    ++st.waitHist[bucketOf(waitUs)];
+    st.maxWaitUs = (waitUs > st.maxWaitUs) ? waitUs : st.maxWaitUs;
+    if (overdue(r, nowUs))
+    {
+        ++st.deadlineMisses;
+    }
+    return best;
+}
+
+bool SpiArbiter::cancel(int ticket)
+{
+    if (ticket < 0 || ticket >= static_cast<int>(MAX_REQUESTS) ||
+        reqs_[ticket].state != Slot::QUEUED)
+    {
+        return false;
+    }
+    reqs_[ticket].state = Slot::FREE;
+    ++stats_[reqs_[ticket].client].cancels;
+    return true;
+}
+
+void SpiArbiter::release(int ticket, uint32_t nowUs)
+{
+    if (ticket < 0 || ticket != holder_)
+    {
+        return;
+    }
+    Request &r = reqs_[ticket];
+    const uint32_t holdUs = nowUs - r.grantedUs;
+    ClientStats &st = stats_[r.client];
+    ++st.holdHist[bucketOf(holdUs)];
+    st.maxHoldUs = (holdUs > st.maxHoldUs) ? holdUs : st.maxHoldUs;
+    st.busyUs += holdUs;
+    busyUs_ += holdUs;
+
+    r.state = Slot::FREE;
+    holder_ = -1;
+}
+
+bool SpiArbiter::isGranted(int ticket) const
+{
+    return ticket >= 0 && ticket < static_cast<int>(MAX_REQUESTS) &&
+           reqs_[ticket].state == Slot::GRANTED;
+}
+
+size_t SpiArbiter::queued() const
+{
+    size_t n = 0U;
+    for (const Request &r : reqs_)
+    {
+        n += (r.state == Slot::QUEUED) ? 1U : 0U;
+    }
+    return n;
+}
+
+bool SpiArbiter::contended(uint32_t nowUs) const
+{
+    if (holder_ < 0)
+    {
+        return false;
+    }
+    const uint8_t held = static_cast<uint8_t>(reqs_[holder_].prio);
+    for (const Request &r : reqs_)
+    {
+        if (r.state == Slot::QUEUED && rankClass(r, nowUs) > held)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ── Ranking ──────────────────────────────────────────────────────────────────
+
+bool SpiArbiter::overdue(const Request &r, uint32_t nowUs)
+{
+    return r.hasDeadline && !earlier(nowUs, r.deadlineUs);
+}
+
+uint8_t SpiArbiter::rankClass(const Request &r, uint32_t nowUs) const
+{
+    return overdue(r, nowUs) ? OVERDUE_CLASS : static_cast<uint8_t>(r.prio);
+}
+
+bool SpiArbiter::before(const Request &a, const Request &b, uint32_t nowUs) const
+{
+    const uint8_t ca = rankClass(a, nowUs);
+    const uint8_t cb = rankClass(b, nowUs);
+    if (ca != cb)
+    {
+        return ca > cb;
+    }
+    if (a.hasDeadline != b.hasDeadline)
+    {
+        return a.hasDeadline;
+    }
+    if (a.hasDeadline && a.deadlineUs != b.deadlineUs)
+    {
+        return earlier(a.deadlineUs, b.deadlineUs);
+    }
+    return earlier(a.seq, b.seq);
+}
+
+// ── Statistics ───────────────────────────────────────────────────────────────
+
+const SpiArbiter::ClientStats &SpiArbiter::stats(uint8_t client) const
+{
+    return stats_[(client < MAX_CLIENTS) ? client : 0U];
+}
+
+uint32_t SpiArbiter::utilisationPermille(uint32_t nowUs) const
+{
+    const uint32_t window = windowUs(nowUs);
+    if (window == 0U)
+    {
+        return 0U;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(busyUs_) * 1000U / window);
+}
+
+void SpiArbiter::resetStats(uint32_t nowUs)
+{
+    for (ClientStats &st : stats_)
+    {
+        st = ClientStats{};
+    }
+    busyUs_ = 0U;
+    windowStartUs_ = nowUs;
+    if (holder_ >= 0)
+    {
+        reqs_[holder_].grantedUs = nowUs;   // count the current hold from here
+    }
+}
+
+size_t SpiArbiter::bucketOf(uint32_t us)
+{
+    size_t b = 0U;
+    while (b + 1U < HIST_BUCKETS && us >= bucketLimitUs(b))
+    {
+        ++b;
+    }
+    return b;
+}
+
+uint32_t SpiArbiter::bucketLimitUs(size_t b)
+{
+    return (b + 1U < HIST_BUCKETS) ? HIST_BASE_US << b : UINT32_MAX;
+}
+
+uint32_t SpiArbiter::percentileUs(const uint32_t (&hist)[HIST_BUCKETS], uint32_t permille)
+{
+    uint64_t total = 0U;
+    for (uint32_t n : hist)
+    {
+        total += n;
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+    const uint64_t target = (total * permille + 999U) / 1000U;
+    uint64_t seen = 0U;
+    for (size_t b = 0U; b < HIST_BUCKETS; ++b)
+    {
+        seen += hist[b];
+        if (seen >= target)
+        {
+            return bucketLimitUs(b);
+        }
+    }
+    return UINT32_MAX;
+}
+
+} // namespace hackos::core
@@ -1,11 +1,12 @@
 /**
  * @file system_core.cpp
- * @brief ThreadManager and HardwareBus mutex implementation.
+ * @brief ThreadManager, HardwareBus mutex and SPI arbiter adapter.
  */
 
 #include "core/system_core.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
 
 static constexpr const char *TAG = "SystemCore";
 
@@ -50,34 +51,220 @@ void BusMutex::release()
     }
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// SpiBus
+// ═══════════════════════════════════════════════════════════════════════════════
+
+SpiBus::SpiBus()
+    : lock_(nullptr),
+      lockBuf_{},
+      wake_{},
+      wakeBuf_{},
+      arbiter_(),
+      ticket_(-1),
+      holderClient_(SpiClient::SD),
+      holderPrio_(BusPriority::BULK)
+{
+}
+
+bool SpiBus::init()
+{
+    if (lock_ != nullptr)
+    {
+        return true;
+    }
+
+    for (size_t i = 0U; i < SpiArbiter::MAX_REQUESTS; ++i)
+    {
+        wake_[i] = xSemaphoreCreateBinaryStatic(&wakeBuf_[i]);
+        if (wake_[i] == nullptr)
+        {
+            return false;
+        }
+    }
+    arbiter_.resetStats(nowUs());
+    lock_ = xSemaphoreCreateMutexStatic(&lockBuf_);
+    return lock_ != nullptr;
+}
+
+bool SpiBus::acquire(SpiClient client, BusPriority prio, uint32_t budgetUs,
+                     TickType_t ticksToWait)
+{
+    if (lock_ == nullptr)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    const uint32_t now = nowUs();
+    const int ticket = arbiter_.request(static_cast<uint8_t>(client), prio, budgetUs, now);
+    if (ticket < 0)
+    {
+        xSemaphoreGive(lock_);
+        ESP_LOGW(TAG, "SPI arbiter queue full");
+        return false;
+    }
+    (void)xSemaphoreTake(wake_[ticket], 0);   // stale wake-up of a timed-out waiter
+    const int granted = arbiter_.grant(now);
+    if (granted >= 0 && granted != ticket)
+    {
+        xSemaphoreGive(wake_[granted]);
+    }
+    xSemaphoreGive(lock_);
+
+    if (granted != ticket)
+    {
+        (void)xSemaphoreTake(wake_[ticket], ticksToWait);
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        // A grant racing the timeout still counts.
+        if (!arbiter_.isGranted(ticket))
+        {
+            (void)arbiter_.cancel(ticket);
+            xSemaphoreGive(lock_);
+            return false;
+        }
+    }
+    else
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+    }
+    ticket_ = ticket;
+    holderClient_ = client;
+    holderPrio_ = prio;
+    xSemaphoreGive(lock_);
+    return true;
+}
+
+void SpiBus::release()
+{
+    if (lock_ == nullptr)
+    {
+        return;
+    }
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    if (ticket_ >= 0)
+    {
+        const uint32_t now = nowUs();
+        arbiter_.release(ticket_, now);
+        ticket_ = -1;
+        const int next = arbiter_.grant(now);
+        if (next >= 0)
+        {
+            xSemaphoreGive(wake_[next]);
+        }
+    }
+    xSemaphoreGive(lock_);
+}
+
+bool SpiBus::yieldIfContended(TickType_t ticksToWait)
+{
+    if (lock_ == nullptr)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    const bool contended = ticket_ >= 0 && arbiter_.contended(nowUs());
+    const SpiClient client = holderClient_;
+    const BusPriority prio = holderPrio_;
+    xSemaphoreGive(lock_);
+    if (!contended)
+    {
+        return true;
+    }
+
+    release();
+    return acquire(client, prio, 0U, ticksToWait);
+}
+
+void SpiBus::logStats()
+{
+    if (lock_ == nullptr)
+    {
+        return;
+    }
+
+    static constexpr const char *CLIENT_NAMES[] = {"SD", "NFC"};
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    const uint32_t now = nowUs();
+    ESP_LOGI(TAG, "SPI bus: %lu.%lu%% busy over %lu ms",
+             static_cast<unsigned long>(arbiter_.utilisationPermille(now) / 10U),
+             static_cast<unsigned long>(arbiter_.utilisationPermille(now) % 10U),
+             static_cast<unsigned long>(arbiter_.windowUs(now) / 1000U));
+    for (size_t c = 0U; c < sizeof(CLIENT_NAMES) / sizeof(CLIENT_NAMES[0]); ++c)
+    {
+        const SpiArbiter::ClientStats &st = arbiter_.stats(static_cast<uint8_t>(c));
+        ESP_LOGI(TAG, "  %-3s grants=%lu wait p50<%lu p99<%lu max=%lu us hold p99<%lu max=%lu us "
+                      "misses=%lu timeouts=%lu",
+                 CLIENT_NAMES[c], static_cast<unsigned long>(st.grants),
+                 static_cast<unsigned long>(SpiArbiter::percentileUs(st.waitHist, 500U)),
+                 static_cast<unsigned long>(SpiArbiter::percentileUs(st.waitHist, 990U)),
+                 static_cast<unsigned long>(st.maxWaitUs),
+                 static_cast<unsigned long>(SpiArbiter::percentileUs(st.holdHist, 990U)),
+                 static_cast<unsigned long>(st.maxHoldUs),
+                 static_cast<unsigned long>(st.deadlineMisses),
+                 static_cast<unsigned long>(st.cancels));
+    }
+    arbiter_.resetStats(now);
+    xSemaphoreGive(lock_);
+}
+
+uint32_t SpiBus::nowUs()
+{
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+SpiLease::SpiLease(SpiClient client, BusPriority prio, uint32_t budgetUs)
+    : held_(HardwareBus::spi().acquire(client, prio, budgetUs))
+{
+}
+
+SpiLease::~SpiLease()
+{
+    if (held_)
+    {
+        HardwareBus::spi().release();
+    }
+}
+
+void SpiLease::yield()
+{
+    if (held_)
+    {
+        held_ = HardwareBus::spi().yieldIfContended();
+    }
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // HardwareBus  (static storage)
 // ═══════════════════════════════════════════════════════════════════════════════
 
 namespace {
 BusMutex g_i2cMutex;
-BusMutex g_spiMutex;
+SpiBus g_spiBus;
 } // namespace
 
 bool HardwareBus::init()
 {
     const bool i2cOk = g_i2cMutex.init();
-    const bool spiOk = g_spiMutex.init();
+    const bool spiOk = g_spiBus.init();
 
     if (!i2cOk || !spiOk)
     {
-        ESP_LOGE(TAG, "HardwareBus mutex init failed (I2C=%d, SPI=%d)", i2cOk, spiOk);
+        ESP_LOGE(TAG, "HardwareBus init failed (I2C=%d, SPI=%d)", i2cOk, spiOk);
     }
     else
     {
-        ESP_LOGI(TAG, "HardwareBus mutexes initialised (I2C + SPI)");
+        ESP_LOGI(TAG, "HardwareBus initialised (I2C mutex + SPI arbiter)");
     }
 
     return i2cOk && spiOk;
 }
 
 BusMutex &HardwareBus::i2c() { return g_i2cMutex; }
-BusMutex &HardwareBus::spi() { return g_spiMutex; }
+SpiBus &HardwareBus::spi() { return g_spiBus; }
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // ThreadManager
@@ -0,0 +1,290 @@
+/**
+ * @file time_series.cpp
+ * @brief Multi-resolution time-series store (see time_series.h).
+ */
+
+#include "core/time_series.h"
+
+#include <cstring>
+
+namespace hackos::core {
+
+namespace {
+
+int16_t roundedMean(int32_t sum, uint32_t n)
+{
+    const int32_t half = static_cast<int32_t>(n / 2U);
+    return static_cast<int16_t>((sum >= 0 ? sum + half : sum - half) / static_cast<int32_t>(n));
+}
+
+void merge(TsBucket *acc, const TsBucket &b)
+{
+    if (b.min < acc->min)
+    {
+        acc->min = b.min;
+    }
+    if (b.max > acc->max)
+    {
+        acc->max = b.max;
+    }
+}
+
+} // namespace
+
+TimeSeries::TimeSeries()
+    : storage_(nullptr),
+      levels_(0U),
+      capacity_(0U),
+      periodMs_(0U),
+      factor_(0U),
+      samples_(0U),
+      head_{},
+      count_{},
+      pending_{}
+{
+}
+
+bool TimeSeries::begin(TsBucket *storage, size_t levels, size_t capacity, uint32_t periodMs,
+                       uint8_t factor)
+{
+    if (storage == nullptr || levels == 0U || levels > MAX_LEVELS || capacity < 2U ||
+        periodMs == 0U || factor < 2U)
+    {
+        storage_ = nullptr;
+        levels_ = 0U;
+        return false;
+    }
+    storage_ = storage;
+    levels_ = levels;
+    capacity_ = capacity;
+    periodMs_ = periodMs;
+    factor_ = factor;
+    clear();
+    return true;
+}
+
+void TimeSeries::clear()
+{
+    samples_ = 0U;
+    std::memset(head_, 0, sizeof(head_));
+    std::memset(count_, 0, sizeof(count_));
+    std::memset(pending_, 0, sizeof(pending_));
+}
+
+void TimeSeries::push(int16_t value)
+{
+    if (storage_ == nullptr)
+    {
+        return;
+    }
+    ++samples_;
+    add(0U, TsBucket{value, value, value});
+}
+
+void TimeSeries::add(size_t level, const TsBucket &b)
+{
+    storage_[level * capacity_ + head_[level]] = b;
+    head_[level] = (head_[level] + 1U) % capacity_;
+    if (count_[level] < capacity_)
+    {
+        ++count_[level];
+    }
+
+    if (level + 1U >= levels_)
+    {
+        return;
+    }
+
+    // Roll up into the next level; pending_[level] builds its next bucket.
+    Pending &p = pending_[level];
+    if (p.n == 0U)
+    {
+        p.min = b.min;
+        p.max = b.max;
+        p.sum = 0;
+    }
+    else
+    {
+        p.min = (b.min < p.min) ? b.min : p.min;
+        p.max = (b.max > p.max) ? b.max : p.max;
+    }
+    p.sum += b.mean;
+    if (++p.n == factor_)
+    {
+        const TsBucket up{p.min, p.max, roundedMean(p.sum, p.n)};
+        p.n = 0U;
+        add(level + 1U, up);
+    }
+}
+
+size_t TimeSeries::count(size_t level) const
+{
+    return (level < levels_) ? count_[level] : 0U;
+}
+
+uint32_t TimeSeries::bucketMs(size_t level) const
+{
+    uint32_t ms = periodMs_;
+    for (size_t k = 0U; k < level; ++k)
+    {
+        ms *= factor_;
+    }
+    return ms;
+}
+
+uint32_t TimeSeries::historyMs() const
+{
+    uint32_t best = 0U;
+    for (size_t k = 0U; k < levels_; ++k)
+    {
+        const uint32_t ms = static_cast<uint32_t>(count_[k]) * bucketMs(k);
+        best = (ms > best) ? ms : best;
+    }
+    return best;
+}
+
+const TsBucket &TimeSeries::at(size_t level, size_t age) const
+{
+    const size_t slot = (head_[level] + capacity_ - 1U - age) % capacity_;
+    return storage_[level * capacity_ + slot];
+}
+
+size_t TimeSeries::coveringLevel(uint32_t spanMs) const
+{
+    const uint32_t history = historyMs();
+    const uint32_t target = (spanMs < history) ? spanMs : history;
+    for (size_t k = 0U; k + 1U < levels_; ++k)
+    {
+        if (static_cast<uint32_t>(count_[k]) * bucketMs(k) >= target)
+        {
+            return k;
+        }
+    }
+    return levels_ - 1U;
+}
+
+size_t TimeSeries::bucketsFor(size_t level, uint32_t spanMs) const
+{
+    const uint32_t ms = bucketMs(level);
+    const size_t want = static_cast<size_t>((spanMs + ms - 1U) / ms);
+    return (want < count_[level]) ? want : count_[level];
+}
+
+size_t TimeSeries::envelope(uint32_t spanMs, TsBucket *out, size_t width) const
+{
+    if (storage_ == nullptr || width == 0U || spanMs == 0U)
+    {
+        return 0U;
+    }
+
+    // Finest level that holds the whole span (or all history there is).
+    const size_t level = coveringLevel(spanMs);
+    const size_t n = bucketsFor(level, spanMs);
+    if (n == 0U)
+    {
+        return 0U;
+    }
+    const uint32_t ms = bucketMs(level);
+    const uint32_t held = static_cast<uint32_t>(n) * ms;
+    const uint64_t colMs = (spanMs + width - 1U) / width;
+    const size_t cols = static_cast<size_t>((held + colMs - 1U) / colMs);
+    const size_t used = (cols < width) ? cols : width;
+
+    // Column c (oldest first) covers ages [lo, hi) before the newest
+    // bucket; it merges every bucket overlapping that slice, so a column
+    // narrower than a bucket repeats it and a wider one folds several.
+    for (size_t c = 0U; c < used; ++c)
+    {
+        const uint64_t hi = static_cast<uint64_t>(used - c) * colMs;
+        const uint64_t lo = hi - colMs;
+        size_t newest = static_cast<size_t>(lo / ms);
+        size_t oldest = static_cast<size_t>((hi + ms - 1U) / ms) - 1U;
+        oldest = (oldest < n) ? oldest : n - 1U;
+        newest = (newest < oldest) ? newest : oldest;
+
+        TsBucket col = at(level, oldest);
+        int32_t sum = col.mean;
+        for (size_t age = newest; age < oldest; ++age)
+        {
+            const TsBucket &bk = at(level, age);
+            merge(&col, bk);
+            sum += bk.mean;
+        }
+        col.mean = roundedMean(sum, static_cast<uint32_t>(oldest - newest + 1U));
+        out[c] = col;
+    }
+    return used;
+}
+
+size_t TimeSeries::downsample(uint32_t spanMs, TsPoint *out, size_t maxPoints) const
+{
+    if (storage_ == nullptr || maxPoints < 3U)
+    {
+        return 0U;
+    }
+
+    const size_t level = coveringLevel(spanMs);
+    const size_t n = bucketsFor(level, spanMs);
+    const uint32_t ms = bucketMs(level);
+    // Index i counts oldest-first; the bucket is at age n-1-i.
+    auto point = [&](size_t i) {
+        return TsPoint{static_cast<uint32_t>(n - 1U - i) * ms, at(level, n - 1U - i).mean};
+    };
+
+    if (n <= maxPoints)
+    {
+        for (size_t i = 0U; i < n; ++i)
+        {
+            out[i] = point(i);
+        }
+        return n;
+    }
+
+    // Largest-Triangle-Three-Buckets: the first and last point stay, each
+    // of the maxPoints-2 inner buckets contributes the point spanning the
+    // largest triangle with the previous pick and the next bucket's mean.
+    const float every = static_cast<float>(n - 2U) / static_cast<float>(maxPoints - 2U);
+    size_t a = 0U;
+    size_t written = 0U;
+    out[written++] = point(0U);
+    for (size_t b = 0U; b < maxPoints - 2U; ++b)
+    {
+        size_t nextFrom = static_cast<size_t>(static_cast<float>(b + 1U) * every) + 1U;
+        size_t nextTo = static_cast<size_t>(static_cast<float>(b + 2U) * every) + 1U;
+        nextTo = (nextTo < n) ? nextTo : n;
+        nextFrom = (nextFrom < nextTo) ? nextFrom : nextTo - 1U;
+        float avgX = 0.0f;
+        float avgY = 0.0f;
+        for (size_t i = nextFrom; i < nextTo; ++i)
+        {
+            avgX += static_cast<float>(i);
+            avgY += static_cast<float>(at(level, n - 1U - i).mean);
+        }
+        avgX /= static_cast<float>(nextTo - nextFrom);
+        avgY /= static_cast<float>(nextTo - nextFrom);
+
+        const size_t from = static_cast<size_t>(static_cast<float>(b) * every) + 1U;
+        const size_t to = static_cast<size_t>(static_cast<float>(b + 1U) * every) + 1U;
+        const float ax = static_cast<float>(a);
+        const float ay = static_cast<float>(at(level, n - 1U - a).mean);
+        float bestArea = -1.0f;
+        size_t pick = from;
+        for (size_t i = from; i < to && i < n - 1U; ++i)
+        {
+            const float y = static_cast<float>(at(level, n - 1U - i).mean);
+            float area = (ax - avgX) * (y - ay) - (ax - static_cast<float>(i)) * (avgY - ay);
+            area = (area < 0.0f) ? -area : area;
+            if (area > bestArea)
+            {
+                bestArea = area;
+                pick = i;
+            }
+        }
+        out[written++] = point(pick);
+        a = pick;
+    }
+    out[written++] = point(n - 1U);
+    return written;
+}
+
+} // namespace hackos::core
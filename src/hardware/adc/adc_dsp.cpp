@@ -0,0 +1,248 @@
+/**
+ * @file adc_dsp.cpp
+ * @brief ADC block-processing kernels (see adc_dsp.h).
+ */
+
+#include "hardware/adc/adc_dsp.h"
+
+#include <cmath>
+
+namespace hackos::adc {
+
+namespace {
+
+constexpr int32_t Q15_ONE = 32768;
+
+/// Cut-off as a fraction of the post-decimation Nyquist frequency.
+constexpr double LOWPASS_EDGE = 0.8;
+
+constexpr double PI = 3.14159265358979323846;
+
+uint32_t isqrt(uint64_t v)
+{
+    uint64_t r = 0U;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0U)
+    {
+        if (v >= r + bit)
+        {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(r);
+}
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── Block statistics ────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+void blockStats(const uint16_t *samples, size_t count, AdcBlockStats *out)
+{
+    *out = {};
+    if (count == 0U)
+    {
+        return;
+    }
+
+    uint16_t lo = samples[0];
+    uint16_t hi = samples[0];
+    uint32_t sum = 0U;
+    uint64_t sumSq = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const uint16_t s = samples[i];
+        lo = (s < lo) ? s : lo;
+        hi = (s > hi) ? s : hi;
+        sum += s;
+        sumSq += static_cast<uint32_t>(s) * s;
+    }
+
+    const uint64_t n = count;
+    // n²·variance = n·Σx² − (Σx)²; scaled by 256 for the Q4 square root.
+    const uint64_t spread = n * sumSq - static_cast<uint64_t>(sum) * sum;
+    out->min = lo;
+    out->max = hi;
+    out->meanQ4 = static_cast<uint16_t>((static_cast<uint64_t>(sum) * 16U + n / 2U) / n);
+    out->acRmsQ4 = static_cast<uint16_t>(isqrt((spread / n) * 256U / n));
+    out->count = static_cast<uint32_t>(count);
+}
+
+size_t unpackI2sAdc(uint16_t *words, size_t count)
+{
+    const size_t even = count & ~static_cast<size_t>(1U);
+    for (size_t i = 0U; i < even; i += 2U)
+    {
+        const uint16_t first = words[i + 1U];
+        words[i + 1U] = static_cast<uint16_t>(words[i] & ADC_FULL_SCALE);
+        words[i] = static_cast<uint16_t>(first & ADC_FULL_SCALE);
+    }
+    return even;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── Oversampler ─────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+bool Oversampler::configure(uint8_t extraBits)
+{
+    if (extraBits > MAX_EXTRA_BITS)
+    {
+        return false;
+    }
+    bits_ = extraBits;
+    group_ = 1UL << (2U * extraBits);
+    reset();
+    return true;
+}
+
+void Oversampler::reset()
+{
+    sum_ = 0U;
+    have_ = 0U;
+}
+
+size_t Oversampler::process(const uint16_t *in, size_t count, uint16_t *out)
+{
+    size_t n = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        sum_ += in[i];
+        if (++have_ == group_)
+        {
+            out[n++] = static_cast<uint16_t>(sum_ >> bits_);
+            sum_ = 0U;
+            have_ = 0U;
+        }
+    }
+    return n;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── FirDecimator ────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+FirDecimator::FirDecimator()
+    : taps_{},
+      hist_{},
+      count_(1U),
+      pos_(0U),
+      factor_(1U),
+      phase_(0U),
+      mid_(1L << (ADC_BITS - 1U)),
+      top_(ADC_FULL_SCALE)
+{
+    taps_[0] = INT16_MAX; // pass-through until configured
+}
+
+bool FirDecimator::configure(const int16_t *taps, size_t count, uint8_t factor,
+                             uint8_t inputBits)
+{
+    if (count == 0U || count > MAX_TAPS || factor == 0U || inputBits < ADC_BITS ||
+        inputBits > 16U)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < count; ++i)
+    {
+        taps_[i] = taps[i];
+    }
+    count_ = count;
+    factor_ = factor;
+    mid_ = 1L << (inputBits - 1U);
+    top_ = (1L << inputBits) - 1;
+    reset();
+    return true;
+}
+
+bool FirDecimator::configureLowpass(size_t count, uint8_t factor, uint8_t inputBits)
+{
+    if (count == 0U || count > MAX_TAPS || factor == 0U)
+    {
+        return false;
+    }
+
+    // Windowed sinc, then rounded to Q15 with the rounding error moved to
+    // the centre tap so the DC gain is exactly one.
+    const double fc = LOWPASS_EDGE * 0.5 / factor; // cycles per input sample
+    const double centre = 0.5 * static_cast<double>(count - 1U);
+    double h[MAX_TAPS];
+    double total = 0.0;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const double m = static_cast<double>(i) - centre;
+        const double sinc = (m == 0.0) ? 2.0 * fc : std::sin(2.0 * PI * fc * m) / (PI * m);
+        const double w = (count == 1U)
+            ? 1.0
+            : 0.42 - 0.5 * std::cos(2.0 * PI * i / (count - 1U)) +
+              0.08 * std::cos(4.0 * PI * i / (count - 1U));
+        h[i] = sinc * w;
+        total += h[i];
+    }
+
+    int16_t q[MAX_TAPS];
+    int32_t sum = 0;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        q[i] = static_cast<int16_t>(std::lround(h[i] / total * (Q15_ONE - 1)));
+        sum += q[i];
+    }
+    const int32_t centreTap = q[count / 2U] + Q15_ONE - sum;
+    q[count / 2U] = static_cast<int16_t>((centreTap > INT16_MAX) ? INT16_MAX : centreTap);
+    return configure(q, count, factor, inputBits);
+}
+
+void FirDecimator::reset()
+{
+    for (size_t i = 0U; i < 2U * count_; ++i)
+    {
+        hist_[i] = 0; // centred mid-scale
+    }
+    pos_ = 0U;
+    phase_ = 0U;
+}
+
+size_t FirDecimator::process(const uint16_t *in, size_t count, uint16_t *out)
+{
+    size_t n = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const int32_t x = static_cast<int32_t>(in[i]) - mid_;
+        hist_[pos_] = x;
+        hist_[pos_ + count_] = x;
+        if (++pos_ == count_)
+        {
+            pos_ = 0U;
+        }
+        if (++phase_ < factor_)
+        {
+            continue;
+        }
+        phase_ = 0U;
+
+        // hist_[pos_ .. pos_ + count_) runs oldest → newest.
+        const int32_t *window = &hist_[pos_];
+        int32_t acc = 0;
+        for (size_t k = 0U; k < count_; ++k)
+        {
+            acc += window[k] * taps_[k];
+        }
+        int32_t y = ((acc + (1L << 14)) >> 15) + mid_;
+        y = (y < 0) ? 0 : ((y > top_) ? top_ : y);
+        out[n++] = static_cast<uint16_t>(y);
+    }
+    return n;
+}
+
+} // namespace hackos::adc
@@ -0,0 +1,314 @@
+/**
+ * @file adc_stream.cpp
+ * @brief I2S-DMA ADC acquisition and block worker (see adc_stream.h).
+ */
+
+#include "hardware/adc/adc_stream.h"
+
+#include <Arduino.h>
+#include <cstring>
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#include <esp_log.h>
+#include <freertos/task.h>
+#include <new>
+
+static constexpr const char *TAG_ADC = "AdcStream";
+
+namespace hackos::adc {
+
+namespace {
+
+constexpr i2s_port_t ADC_I2S_PORT   = I2S_NUM_0;
+constexpr int      EVENT_QUEUE_LEN  = 8;
+constexpr uint32_t WORKER_STACK     = 3072U;
+constexpr UBaseType_t WORKER_PRIO   = 5U;
+constexpr BaseType_t WORKER_CORE    = 0;
+constexpr uint32_t READ_TIMEOUT_MS  = 100U;
+constexpr uint32_t STOP_TIMEOUT_MS  = 200U;
+
+/// ADC1 channel n is wired to ADC1_PINS[n].
+constexpr uint8_t ADC1_PINS[8] = {36U, 37U, 38U, 39U, 32U, 33U, 34U, 35U};
+
+constexpr size_t HISTORY_MASK = AdcStream::HISTORY_SAMPLES - 1U;
+static_assert((AdcStream::HISTORY_SAMPLES & HISTORY_MASK) == 0U,
+              "history must be a power of two");
+
+} // namespace
+
+AdcStream &AdcStream::instance()
+{
+    static AdcStream stream;
+    return stream;
+}
+
+AdcStream::AdcStream()
+    : config_(),
+      oversampler_(),
+      fir_(),
+      events_(nullptr),
+      block_{},
+      history_(nullptr),
+      head_(0U),
+      latest_{},
+      haveLatest_(false),
+      running_(false),
+      taskDone_(true),
+      blocks_(0U),
+      overruns_(0U),
+      cpuPermille_(0U)
+{
+}
+
+int8_t AdcStream::adc1Channel(uint8_t pin)
+{
+    for (size_t ch = 0U; ch < sizeof(ADC1_PINS); ++ch)
+    {
+        if (ADC1_PINS[ch] == pin)
+        {
+            return static_cast<int8_t>(ch);
+        }
+    }
+    return -1;
+}
+
+bool AdcStream::start(const AdcStreamConfig &config)
+{
+    const int8_t channel = adc1Channel(config.pin);
+    if (running_ || !taskDone_ || channel < 0 || config.rateHz < MIN_RATE_HZ ||
+        config.rateHz > MAX_RATE_HZ || config.decimation == 0U ||
+        !oversampler_.configure(config.oversampleBits))
+    {
+        return false;
+    }
+    const uint8_t bits = static_cast<uint8_t>(ADC_BITS + config.oversampleBits);
+    if (config.decimation > 1U && !fir_.configureLowpass(FIR_TAPS, config.decimation, bits))
+    {
+        return false;
+    }
+    config_ = config;
+
+    if (history_ == nullptr)
+    {
+        history_ = new (std::nothrow) uint16_t[HISTORY_SAMPLES];
+    }
+    if (history_ == nullptr)
+    {
+        ESP_LOGE(TAG_ADC, "OOM allocating history");
+        return false;
+    }
+
+    i2s_config_t i2s = {};
+    i2s.mode = static_cast<i2s_mode_t>(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    i2s.sample_rate = config.rateHz;
+    i2s.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2s.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    i2s.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    i2s.intr_alloc_flags = 0;
+    i2s.dma_buf_count = static_cast<int>(DMA_BUFFERS);
+    i2s.dma_buf_len = static_cast<int>(BLOCK_SAMPLES);
+    i2s.use_apll = false;
+    if (i2s_driver_install(ADC_I2S_PORT, &i2s, EVENT_QUEUE_LEN, &events_) != ESP_OK)
+    {
+        ESP_LOGE(TAG_ADC, "I2S driver install failed");
+        return false;
+    }
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten(static_cast<adc1_channel_t>(channel), ADC_ATTEN_DB_11);
+    if (i2s_set_adc_mode(ADC_UNIT_1, static_cast<adc1_channel_t>(channel)) != ESP_OK ||
+        i2s_adc_enable(ADC_I2S_PORT) != ESP_OK)
+    {
+        ESP_LOGE(TAG_ADC, "I2S ADC mode failed");
+        i2s_driver_uninstall(ADC_I2S_PORT);
+        return false;
+    }
+
+    head_ = 0U;
+    haveLatest_ = false;
+    blocks_ = 0U;
+    overruns_ = 0U;
+    cpuPermille_ = 0U;
+    oversampler_.reset();
+    fir_.reset();
+    running_ = true;
+    taskDone_ = false;
+    if (xTaskCreatePinnedToCore(taskEntry, "adc_dsp", WORKER_STACK, this, WORKER_PRIO,
+                                nullptr, WORKER_CORE) != pdPASS)
+    {
+        running_ = false;
+        taskDone_ = true;
+        i2s_adc_disable(ADC_I2S_PORT);
+        i2s_driver_uninstall(ADC_I2S_PORT);
+        ESP_LOGE(TAG_ADC, "task create failed");
+        return false;
+    }
+
+    ESP_LOGI(TAG_ADC, "GPIO%u (ADC1_CH%d) @ %lu Hz, x%lu oversample, /%u decimation",
+             static_cast<unsigned>(config.pin), channel,
+             static_cast<unsigned long>(config.rateHz),
+             static_cast<unsigned long>(oversampler_.factor()),
+             static_cast<unsigned>(config.decimation));
+    return true;
+}
+
+void AdcStream::stop()
+{
+    if (!running_)
+    {
+        return;
+    }
+    running_ = false;
+    for (uint32_t waited = 0U; !taskDone_ && waited < STOP_TIMEOUT_MS; ++waited)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1U));
+    }
+    i2s_adc_disable(ADC_I2S_PORT);
+    i2s_driver_uninstall(ADC_I2S_PORT);
+    events_ = nullptr;
+
+    ESP_LOGI(TAG_ADC, "stopped: %lu blocks, %lu overruns, cpu %u permille",
+             static_cast<unsigned long>(blocks_), static_cast<unsigned long>(overruns_),
+             static_cast<unsigned>(cpuPermille_));
+
+    if (taskDone_)
+    {
+        delete[] history_;
+        history_ = nullptr;
+    }
+}
+
+bool AdcStream::latest(AdcBlockStats *out) const
+{
+    portENTER_CRITICAL(&latestMux_);
+    const bool have = haveLatest_;
+    *out = latest_;
+    portEXIT_CRITICAL(&latestMux_);
+    return have;
+}
+
+size_t AdcStream::read(uint32_t *cursor, uint16_t *out, size_t max, uint32_t *lost) const
+{
+    if (history_ == nullptr)
+    {
+        return 0U;
+    }
+
+    uint32_t from = *cursor;
+    uint32_t skipped = 0U;
+    const uint32_t head = head_;
+    if (head - from > HISTORY_SAMPLES)
+    {
+        skipped = head - static_cast<uint32_t>(HISTORY_SAMPLES) - from;
+        from = head - static_cast<uint32_t>(HISTORY_SAMPLES);
+    }
+    size_t n = head - from;
+    n = (n < max) ? n : max;
+    for (size_t i = 0U; i < n; ++i)
+    {
+        out[i] = history_[(from + i) & HISTORY_MASK];
+    }
+
+    // The worker may have lapped the copy; drop what it overwrote.
+    const uint32_t oldest = head_ - static_cast<uint32_t>(HISTORY_SAMPLES);
+    if (static_cast<int32_t>(oldest - from) > 0)
+    {
+        const size_t stale = (oldest - from < n) ? (oldest - from) : n;
+        std::memmove(out, out + stale, (n - stale) * sizeof(uint16_t));
+        n -= stale;
+        skipped += static_cast<uint32_t>(stale);
+        from += static_cast<uint32_t>(stale);
+    }
+
+    *cursor = from + static_cast<uint32_t>(n);
+    if (lost != nullptr)
+    {
+        *lost = skipped;
+    }
+    return n;
+}
+
+size_t AdcStream::newest(uint16_t *out, size_t count) const
+{
+    const uint32_t head = head_;
+    uint32_t cursor = (head > count) ? head - static_cast<uint32_t>(count) : 0U;
+    return read(&cursor, out, count);
+}
+
+void AdcStream::stats(AdcStreamStats *out) const
+{
+    out->rateHz = config_.rateHz;
+    out->outputHz = config_.rateHz / oversampler_.factor() / config_.decimation;
+    out->outputBits = static_cast<uint8_t>(ADC_BITS + config_.oversampleBits);
+    out->blocks = blocks_;
+    out->overruns = overruns_;
+    out->cpuPermille = cpuPermille_;
+}
+
+void AdcStream::taskEntry(void *arg)
+{
+    auto *self = static_cast<AdcStream *>(arg);
+    self->run();
+    self->taskDone_ = true;
+    vTaskDelete(nullptr);
+}
+
+void AdcStream::run()
+{
+    const uint32_t cpuHz = getCpuFrequencyMhz() * 1000000UL;
+    const uint64_t blockCycles = static_cast<uint64_t>(cpuHz) * BLOCK_SAMPLES / config_.rateHz;
+
+    while (running_)
+    {
+        // Blocks until the DMA completes the next buffer.
+        size_t bytes = 0U;
+        if (i2s_read(ADC_I2S_PORT, block_, sizeof(block_), &bytes,
+                     pdMS_TO_TICKS(READ_TIMEOUT_MS)) != ESP_OK || bytes == 0U)
+        {
+            continue;
+        }
+
+        const uint32_t t0 = ESP.getCycleCount();
+        processBlock(bytes / sizeof(uint16_t));
+        const uint32_t busy = ESP.getCycleCount() - t0;
+        cpuPermille_ = static_cast<uint16_t>((static_cast<uint64_t>(busy) * 1000U) / blockCycles);
+        blocks_ = blocks_ + 1U;
+
+        i2s_event_t event;
+        while (xQueueReceive(events_, &event, 0) == pdTRUE)
+        {
+            if (event.type == I2S_EVENT_RX_Q_OVF)
+            {
+                overruns_ = overruns_ + 1U;
+            }
+        }
+    }
+}
+
+void AdcStream::processBlock(size_t count)
+{
+    const size_t n = unpackI2sAdc(block_, count);
+
+    AdcBlockStats st;
+    blockStats(block_, n, &st);
+    portENTER_CRITICAL(&latestMux_);
+    latest_ = st;
+    haveLatest_ = true;
+    portEXIT_CRITICAL(&latestMux_);
+
+    // Both stages write at or behind the sample they read, so they can
+    // run in place.
+    size_t m = oversampler_.process(block_, n, block_);
+    if (config_.decimation > 1U)
+    {
+        m = fir_.process(block_, m, block_);
+    }
+
+    uint32_t head = head_;
+    for (size_t i = 0U; i < m; ++i)
+    {
+        history_[(head + i) & HISTORY_MASK] = block_[i];
+    }
+    head_ = head + static_cast<uint32_t>(m); // publish after the samples
+}
+
+} // namespace hackos::adc
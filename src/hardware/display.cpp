@@ -2,8 +2,25 @@
 
 #include <Wire.h>
 #include <cstring>
+#include <esp_log.h>
+#include <esp_timer.h>
 
 #include "config.h"
+#include "core/system_core.h"
+
+static constexpr const char *TAG_DISPLAY = "Display";
+
+namespace
+{
+
+constexpr uint8_t OLED_ADDR = 0x3CU;
+constexpr uint32_t OLED_I2C_HZ = 400000U;
+constexpr uint8_t CONTROL_COMMANDS = 0x00U;
+constexpr uint8_t CONTROL_DATA = 0x40U;
+/// Data bytes per I2C transaction (the Wire buffer holds 128 with the control byte).
+constexpr size_t DATA_CHUNK = 64U;
+
+} // namespace
 
 DisplayManager &DisplayManager::instance()
 {
@@ -12,9 +29,18 @@ DisplayManager &DisplayManager::instance()
 }
 
 DisplayManager::DisplayManager()
-    : display_(WIDTH, HEIGHT, &Wire, -1),
+    : display_(WIDTH, HEIGHT, &Wire, -1, OLED_I2C_HZ, OLED_I2C_HZ),
       backBuffer_(WIDTH, HEIGHT),
-      frontBuffer_{0},
+      pipeline_(),
+      lock_(nullptr),
+      lockBuf_{},
+      presentLock_(nullptr),
+      presentLockBuf_{},
+      slotFree_(nullptr),
+      slotFreeBuf_{},
+      txTask_(nullptr),
+      txTcb_{},
+      txStack_{},
       initialized_(false)
 {
 }
@@ -27,13 +53,24 @@ bool DisplayManager::init()
     }
 
     Wire.begin(PIN_OLED_SDA, PIN_OLED_SCL);
-    if (!display_.begin(SSD1306_SWITCHCAPVCC, 0x3CU))
+    if (!display_.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR))
+    {
+        return false;
+    }
+
+    lock_ = xSemaphoreCreateMutexStatic(&lockBuf_);
+    presentLock_ = xSemaphoreCreateMutexStatic(&presentLockBuf_);
+    slotFree_ = xSemaphoreCreateBinaryStatic(&slotFreeBuf_);
+    txTask_ = xTaskCreateStatic(txTaskEntry, "oled_tx", TX_STACK, this, TX_PRIO,
+                                txStack_, &txTcb_);
+    if (lock_ == nullptr || presentLock_ == nullptr || slotFree_ == nullptr || txTask_ == nullptr)
     {
+        ESP_LOGE(TAG_DISPLAY, "frame pipeline init failed");
         return false;
     }
+    pipeline_.resetStats(nowUs());
 
     backBuffer_.fillScreen(SSD1306_BLACK);
-    std::memset(frontBuffer_, 0, sizeof(frontBuffer_));
     initialized_ = true;
     present();
     return true;
@@ -84,9 +121,39 @@ void DisplayManager::present()
         return;
     }
 
-    std::memcpy(frontBuffer_, backBuffer_.getBuffer(), sizeof(frontBuffer_));
-    std::memcpy(display_.getBuffer(), frontBuffer_, sizeof(frontBuffer_));
-    display_.display();
+    xSemaphoreTake(presentLock_, portMAX_DELAY);
+    uint8_t *frame = display_.getBuffer();
+    std::memcpy(frame, backBuffer_.getBuffer(), BUFFER_SIZE);
+
+    // Block only while both slots are in flight.  After PRESENT_WAIT_MS the
+    // queued frame that has not started is overwritten: the newest frame
+    // always goes out, only an older one is ever dropped.
+    const TickType_t start = xTaskGetTickCount();
+    const TickType_t patience = pdMS_TO_TICKS(PRESENT_WAIT_MS);
+    uint8_t *slot = nullptr;
+    for (;;)
+    {
+        const TickType_t waited = xTaskGetTickCount() - start;
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        slot = pipeline_.acquire();
+        if (slot == nullptr && waited >= patience)
+        {
+            slot = pipeline_.replaceQueued(nowUs());
+        }
+        xSemaphoreGive(lock_);
+        if (slot != nullptr)
+        {
+            break;
+        }
+        (void)xSemaphoreTake(slotFree_, (waited < patience) ? patience - waited : patience);
+    }
+
+    std::memcpy(slot, frame, BUFFER_SIZE);
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    (void)pipeline_.submit(nowUs());
+    xSemaphoreGive(lock_);
+    xSemaphoreGive(presentLock_);
+    xTaskNotifyGive(txTask_);
 }
 
 bool DisplayManager::isInitialized() const
@@ -98,3 +165,125 @@ uint8_t *DisplayManager::getDisplayBuffer()
 {
     return display_.getBuffer();
 }
+
+DisplayStats DisplayManager::stats() const
+{
+    DisplayStats out{};
+    if (!initialized_)
+    {
+        return out;
+    }
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    const uint32_t now = nowUs();
+    const hackos::display::FramePipeline::Stats &st = pipeline_.stats();
+    const uint32_t window = pipeline_.windowUs(now);
+    out.fpsTenths = pipeline_.fpsTenths(now);
+    for (size_t n = 0U; n <= hackos::display::FramePipeline::SLOTS; ++n)
+    {
+        out.occupancyPermille[n] = (window > 0U)
+            ? static_cast<uint16_t>(static_cast<uint64_t>(st.occupancyUs[n]) * 1000U / window)
+            : 0U;
+    }
+    out.pagesSent = st.pagesSent;
+    out.pagesSkipped = st.pagesSkipped;
+    out.waits = st.waits;
+    out.dropped = st.superseded;
+    out.errors = st.pageErrors;
+    xSemaphoreGive(lock_);
+    return out;
+}
+
+void DisplayManager::logStats()
+{
+    if (!initialized_)
+    {
+        return;
+    }
+
+    const DisplayStats st = stats();
+    ESP_LOGI(TAG_DISPLAY, "%lu.%lu fps, in flight 0/1/2: %u/%u/%u permille, pages sent=%lu "
+                          "skipped=%lu, waits=%lu dropped=%lu errors=%lu",
+             static_cast<unsigned long>(st.fpsTenths / 10U),
+             static_cast<unsigned long>(st.fpsTenths % 10U),
+             static_cast<unsigned>(st.occupancyPermille[0]),
+             static_cast<unsigned>(st.occupancyPermille[1]),
+             static_cast<unsigned>(st.occupancyPermille[2]),
+             static_cast<unsigned long>(st.pagesSent), static_cast<unsigned long>(st.pagesSkipped),
+             static_cast<unsigned long>(st.waits), static_cast<unsigned long>(st.dropped),
+             static_cast<unsigned long>(st.errors));
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    pipeline_.resetStats(nowUs());
+    xSemaphoreGive(lock_);
+}
+
+// ── I2C driver task ──────────────────────────────────────────────────────────
+
+void DisplayManager::txTaskEntry(void *param)
+{
+    static_cast<DisplayManager *>(param)->txLoop();
+}
+
+void DisplayManager::txLoop()
+{
+    for (;;)
+    {
+        uint8_t page = 0U;
+        const uint8_t *data = nullptr;
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        const bool pending = pipeline_.nextPage(&page, &data);
+        xSemaphoreGive(lock_);
+        if (!pending)
+        {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // The slot is not touched by present() until pageDone() frees it.
+        const bool ok = sendPage(page, data);
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        const bool freed = pipeline_.pageDone(ok, nowUs());
+        xSemaphoreGive(lock_);
+        if (freed)
+        {
+            xSemaphoreGive(slotFree_);
+        }
+    }
+}
+
+bool DisplayManager::sendPage(uint8_t page, const uint8_t *data)
+{
+    hackos::core::BusMutex &bus = hackos::core::HardwareBus::i2c();
+    if (!bus.acquire())
+    {
+        return false;
+    }
+
+    // Horizontal addressing (set by begin()): a one-page window.
+    Wire.beginTransmission(OLED_ADDR);
+    Wire.write(CONTROL_COMMANDS);
+    Wire.write(static_cast<uint8_t>(SSD1306_PAGEADDR));
+    Wire.write(page);
+    Wire.write(page);
+    Wire.write(static_cast<uint8_t>(SSD1306_COLUMNADDR));
+    Wire.write(static_cast<uint8_t>(0U));
+    Wire.write(static_cast<uint8_t>(WIDTH - 1));
+    bool ok = Wire.endTransmission() == 0U;
+
+    for (size_t off = 0U; ok && off < static_cast<size_t>(WIDTH); off += DATA_CHUNK)
+    {
+        Wire.beginTransmission(OLED_ADDR);
+        Wire.write(CONTROL_DATA);
+        Wire.write(data + off, DATA_CHUNK);
+        ok = Wire.endTransmission() == 0U;
+    }
+
+    bus.release();
+    return ok;
+}
+
+uint32_t DisplayManager::nowUs()
+{
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
@@ -0,0 +1,277 @@
+/**
+ * @file frame_pipeline.cpp
+ * @brief Frame slots, dirty pages and pipeline statistics (see frame_pipeline.h).
+ */
+
+#include "hardware/display/frame_pipeline.h"
+
+#include <cstring>
+
+namespace hackos::display {
+
+namespace
+{
+
+constexpr uint8_t ALL_PAGES = 0xFFU;
+
+static_assert(FramePipeline::PAGES == 8U, "dirty masks are one byte");
+
+uint8_t pageCount(uint8_t mask)
+{
+    uint8_t n = 0U;
+    for (; mask != 0U; mask &= static_cast<uint8_t>(mask - 1U))
+    {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+FramePipeline::FramePipeline()
+    : frames_{},
+      state_{},
+      dirty_{},
+      seq_{},
+      filling_(-1),
+      last_(-1),
+      head_(0U),
+      queued_(0U),
+      page_(0U),
+      full_(true),
+      nextSeq_(0U),
+      completed_(0U),
+      lastChangeUs_(0U),
+      windowStartUs_(0U),
+      stats_{}
+{
+}
+
+// ── Renderer side ────────────────────────────────────────────────────────────
+
+uint8_t *FramePipeline::acquire()
+{
+    if (filling_ >= 0)
+    {
+        return frames_[filling_];
+    }
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        // The last submitted frame stays intact: the next one is diffed
+        // against it.
+        if (state_[i] == Slot::FREE && static_cast<int>(i) != last_)
+        {
+            state_[i] = Slot::FILLING;
+            filling_ = static_cast<int>(i);
+            return frames_[i];
+        }
+    }
+    ++stats_.waits;
+    return nullptr;
+}
+
+uint8_t *FramePipeline::replaceQueued(uint32_t nowUs)
+{
+    if (filling_ >= 0)
+    {
+        return frames_[filling_];
+    }
+    // The head may already be on the wire; anything queued behind it is not.
+    if (queued_ < 2U || last_ < 0 || static_cast<size_t>(last_) == head_)
+    {
+        return nullptr;
+    }
+    const size_t slot = static_cast<size_t>(last_);
+
+    // The frame ahead is what the panel holds once the head is out: diff
+    // the replacement against it, or repaint whole if the dropped frame had
+    // to (a page error since it was queued).
+    int base = -1;
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        if (i != slot && state_[i] == Slot::QUEUED &&
+            (base < 0 || static_cast<int32_t>(seq_[i] - seq_[base]) > 0))
+        {
+            base = static_cast<int>(i);
+        }
+    }
+    if (dirty_[slot] == ALL_PAGES)
+    {
+        full_ = true;
+    }
+
+    account(nowUs);
+    --queued_;
+    ++stats_.superseded;
+    state_[slot] = Slot::FILLING;
+    filling_ = static_cast<int>(slot);
+    last_ = base;
+    return frames_[slot];
+}
+
+bool FramePipeline::submit(uint32_t nowUs)
+{
+    if (filling_ < 0)
+    {
+        return false;
+    }
+    const size_t slot = static_cast<size_t>(filling_);
+    filling_ = -1;
+
+    uint8_t dirty = 0U;
+    if (full_ || last_ < 0)
+    {
+        dirty = ALL_PAGES;
+        full_ = false;
+    }
+    else
+    {
+        for (size_t p = 0U; p < PAGES; ++p)
+        {
+            if (std::memcmp(frames_[slot] + p * WIDTH, frames_[last_] + p * WIDTH, WIDTH) != 0)
+            {
+                dirty |= static_cast<uint8_t>(1U << p);
+            }
+        }
+    }
+    stats_.pagesSkipped += PAGES - pageCount(dirty);
+    ++stats_.submitted;
+
+    account(nowUs);
+    state_[slot] = Slot::QUEUED;
+    dirty_[slot] = dirty;
+    seq_[slot] = nextSeq_++;
+    last_ = static_cast<int>(slot);
+    if (queued_++ == 0U)
+    {
+        head_ = slot;
+        page_ = nextDirty(0U);
+        if (page_ == PAGES)
+        {
+            completeHead(nowUs);   // nothing changed on screen
+        }
+    }
+    return true;
+}
+
+// ── Driver side ──────────────────────────────────────────────────────────────
+
+bool FramePipeline::nextPage(uint8_t *page, const uint8_t **data)
+{
+    if (queued_ == 0U)
+    {
+        return false;
+    }
+    *page = page_;
+    *data = frames_[head_] + static_cast<size_t>(page_) * WIDTH;
+    return true;
+}
+
+bool FramePipeline::pageDone(bool ok, uint32_t nowUs)
+{
+    if (queued_ == 0U)
+    {
+        return false;
+    }
+    if (ok)
+    {
+        ++stats_.pagesSent;
+    }
+    else
+    {
+        // The panel no longer matches any diff base: repaint whole frames.
+        ++stats_.pageErrors;
+        full_ = true;
+        for (size_t i = 0U; i < SLOTS; ++i)
+        {
+            if (state_[i] == Slot::QUEUED && i != head_)
+            {
+                dirty_[i] = ALL_PAGES;
+                full_ = false;
+            }
+        }
+    }
+
+    page_ = nextDirty(static_cast<uint8_t>(page_ + 1U));
+    if (page_ < PAGES)
+    {
+        return false;
+    }
+    completeHead(nowUs);
+    return true;
+}
+
+void FramePipeline::invalidate()
+{
+    full_ = true;
+}
+
+void FramePipeline::completeHead(uint32_t nowUs)
+{
+    while (queued_ > 0U)
+    {
+        account(nowUs);
+        state_[head_] = Slot::FREE;
+        --queued_;
+        ++completed_;
+        ++stats_.sent;
+
+        // Oldest remaining frame next; skip it too if nothing changed.
+        bool found = false;
+        for (size_t i = 0U; i < SLOTS; ++i)
+        {
+            if (state_[i] == Slot::QUEUED &&
+                (!found || static_cast<int32_t>(seq_[i] - seq_[head_]) < 0))
+            {
+                head_ = i;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            return;
+        }
+        page_ = nextDirty(0U);
+        if (page_ < PAGES)
+        {
+            return;
+        }
+    }
+}
+
+uint8_t FramePipeline::nextDirty(uint8_t from) const
+{
+    uint8_t p = from;
+    while (p < PAGES && (dirty_[head_] & (1U << p)) == 0U)
+    {
+        ++p;
+    }
+    return p;
+}
+
+// ── Statistics ───────────────────────────────────────────────────────────────
+
+void FramePipeline::account(uint32_t nowUs)
+{
+    stats_.occupancyUs[queued_] += nowUs - lastChangeUs_;
+    lastChangeUs_ = nowUs;
+}
+
+uint32_t FramePipeline::fpsTenths(uint32_t nowUs) const
+{
+    const uint32_t window = windowUs(nowUs);
+    if (window == 0U)
+    {
+        return 0U;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(stats_.sent) * 10000000U / window);
+}
+
+void FramePipeline::resetStats(uint32_t nowUs)
+{
+    stats_ = Stats{};
+    windowStartUs_ = nowUs;
+    lastChangeUs_ = nowUs;
+}
+
+} // namespace hackos::display
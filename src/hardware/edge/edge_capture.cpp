@@ -0,0 +1,241 @@
+/**
+ * @file edge_capture.cpp
+ * @brief Per-pin GPIO edge ISR feeding shared EdgeRings (see edge_capture.h).
+ */
+
+#include "hardware/edge/edge_capture.h"
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <esp_log.h>
+#include <new>
+#include <soc/gpio_reg.h>
+
+static constexpr const char *TAG_EDGE = "EdgeCapture";
+
+namespace hackos::edge {
+
+namespace {
+
+constexpr uint8_t GPIO_MAX_PIN = 39U;
+
+} // namespace
+
+EdgeCapture &EdgeCapture::instance()
+{
+    static EdgeCapture capture;
+    return capture;
+}
+
+EdgeCapture::EdgeCapture()
+    : channels_(),
+      cyclesPerUs_(getCpuFrequencyMhz())
+{
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── ISR ─────────────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+void IRAM_ATTR EdgeCapture::isr(void *arg)
+{
+    // Timestamp first: everything after this adds no latency error.
+    const uint32_t now = ESP.getCycleCount();
+    auto *ch = static_cast<Channel *>(arg);
+    const uint32_t in = ch->highBank ? REG_READ(GPIO_IN1_REG) : REG_READ(GPIO_IN_REG);
+    const uint8_t level = ((in & ch->bit) != 0U) ? 1U : 0U;
+
+    ch->isrCore = xPortGetCoreID();
+    if (ch->ring.minPulseCycles() == 0U)
+    {
+        ch->ring.onEdge(now, level); // single producer: no lock needed
+        return;
+    }
+    portENTER_CRITICAL_ISR(&ch->mux);
+    ch->ring.onEdge(now, level);
+    portEXIT_CRITICAL_ISR(&ch->mux);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── Subscription ────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+bool EdgeCapture::subscribe(uint8_t pin, EdgeReader *reader, const EdgeCaptureConfig &config)
+{
+    if (reader == nullptr || reader->attached() || pin > GPIO_MAX_PIN)
+    {
+        return false;
+    }
+
+    Channel *ch = find(pin);
+    if (ch != nullptr)
+    {
+        reader->attach(&ch->ring, cyclesPerUs_);
+        ++ch->subscribers;
+        return true;
+    }
+
+    const size_t cap = config.ringEdges;
+    if (cap < 2U || cap > MAX_RING_EDGES || (cap & (cap - 1U)) != 0U)
+    {
+        return false;
+    }
+    for (Channel &c : channels_)
+    {
+        if (c.subscribers == 0U)
+        {
+            ch = &c;
+            break;
+        }
+    }
+    if (ch == nullptr)
+    {
+        ESP_LOGW(TAG_EDGE, "no free slot for GPIO%u", static_cast<unsigned>(pin));
+        return false;
+    }
+
+    ch->buf = new (std::nothrow) uint32_t[cap];
+    if (ch->buf == nullptr)
+    {
+        ESP_LOGE(TAG_EDGE, "OOM allocating %u-edge ring", static_cast<unsigned>(cap));
+        return false;
+    }
+    cyclesPerUs_ = getCpuFrequencyMhz();
+    ch->ring.attach(ch->buf, cap);
+    ch->ring.reset(static_cast<uint32_t>(
+        (static_cast<uint64_t>(config.glitchNs) * cyclesPerUs_ + 999U) / 1000U));
+    ch->pin = pin;
+    ch->highBank = pin >= 32U;
+    ch->bit = 1UL << (pin & 31U);
+    ch->isrCore = -1;
+
+    // The service may already be installed by another driver.
+    const esp_err_t svc = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    const gpio_num_t gpio = static_cast<gpio_num_t>(pin);
+    if ((svc != ESP_OK && svc != ESP_ERR_INVALID_STATE) ||
+        gpio_set_intr_type(gpio, GPIO_INTR_ANYEDGE) != ESP_OK ||
+        gpio_isr_handler_add(gpio, isr, ch) != ESP_OK)
+    {
+        ESP_LOGE(TAG_EDGE, "ISR install failed on GPIO%u", static_cast<unsigned>(pin));
+        delete[] ch->buf;
+        ch->buf = nullptr;
+        return false;
+    }
+    ch->subscribers = 1U;
+    reader->attach(&ch->ring, cyclesPerUs_);
+
+    ESP_LOGI(TAG_EDGE, "GPIO%u: %u-edge ring, glitch filter %lu ns",
+             static_cast<unsigned>(pin), static_cast<unsigned>(cap),
+             static_cast<unsigned long>(config.glitchNs));
+    return true;
+}
+
+void EdgeCapture::unsubscribe(uint8_t pin, EdgeReader *reader)
+{
+    Channel *ch = find(pin);
+    if (ch == nullptr || reader == nullptr || !reader->attached())
+    {
+        return;
+    }
+    reader->detach();
+    if (--ch->subscribers != 0U)
+    {
+        return;
+    }
+
+    const gpio_num_t gpio = static_cast<gpio_num_t>(pin);
+    gpio_isr_handler_remove(gpio);
+    gpio_set_intr_type(gpio, GPIO_INTR_DISABLE);
+
+    EdgeRingStats st;
+    ch->ring.stats(&st);
+    ESP_LOGI(TAG_EDGE, "GPIO%u released: %lu edges, %lu glitches",
+             static_cast<unsigned>(pin), static_cast<unsigned long>(st.edges),
+             static_cast<unsigned long>(st.glitches));
+
+    delete[] ch->buf;
+    ch->buf = nullptr;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── Reading ─────────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+size_t EdgeCapture::readPulses(uint8_t pin, EdgeReader *reader, int32_t *out, size_t max,
+                               int32_t maxUs)
+{
+    Channel *ch = find(pin);
+    if (ch == nullptr)
+    {
+        return 0U;
+    }
+    settle(ch);
+    reader->setCyclesPerUs(getCpuFrequencyMhz()); // PowerManager scales the clock
+    return reader->readPulses(out, max, maxUs);
+}
+
+size_t EdgeCapture::readEdges(uint8_t pin, EdgeReader *reader, EdgeStamp *out, size_t max)
+{
+    Channel *ch = find(pin);
+    if (ch == nullptr)
+    {
+        return 0U;
+    }
+    settle(ch);
+    return reader->readEdges(out, max);
+}
+
+void EdgeCapture::settle(Channel *ch)
+{
+    // The cycle counters of the two cores are not synchronised: a pending
+    // edge can only be aged on the core its timestamp came from.  On the
+    // other core it waits for the next edge.
+    if (ch->ring.minPulseCycles() == 0U || ch->isrCore != xPortGetCoreID())
+    {
+        return;
+    }
+    portENTER_CRITICAL(&ch->mux);
+    ch->ring.settle(ESP.getCycleCount());
+    portEXIT_CRITICAL(&ch->mux);
+}
+
+bool EdgeCapture::stats(uint8_t pin, EdgeCaptureStats *out) const
+{
+    const Channel *ch = find(pin);
+    if (ch == nullptr)
+    {
+        return false;
+    }
+    ch->ring.stats(&out->ring);
+    out->pin = ch->pin;
+    out->subscribers = ch->subscribers;
+    out->cyclesPerUs = cyclesPerUs_;
+    out->ringEdges = ch->ring.capacity();
+    return true;
+}
+
+EdgeCapture::Channel *EdgeCapture::find(uint8_t pin)
+{
+    for (Channel &c : channels_)
+    {
+        if (c.subscribers != 0U && c.pin == pin)
+        {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+const EdgeCapture::Channel *EdgeCapture::find(uint8_t pin) const
+{
+    for (const Channel &c : channels_)
+    {
+        if (c.subscribers != 0U && c.pin == pin)
+        {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace hackos::edge
@@ -0,0 +1,184 @@
+/**
+ * @file edge_ring.cpp
+ * @brief Glitch-filtered edge ring and readers (see edge_ring.h).
+ */
+
+#include "hardware/edge/edge_ring.h"
+
+namespace hackos::edge {
+
+namespace {
+
+/// Edges converted per batch in readPulses().
+constexpr size_t PULSE_BATCH = 32U;
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── EdgeRing ────────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+EdgeRing::EdgeRing()
+    : buf_(nullptr),
+      cap_(0U),
+      mask_(0U),
+      head_(0U),
+      min_(0U),
+      level_(LEVEL_UNKNOWN),
+      pending_(false),
+      pendingLevel_(0U),
+      pendingCycles_(0U),
+      edges_(0U),
+      glitches_(0U),
+      published_(0U)
+{
+}
+
+bool EdgeRing::attach(uint32_t *buf, size_t cap)
+{
+    if (buf == nullptr || cap < 2U || (cap & (cap - 1U)) != 0U)
+    {
+        return false;
+    }
+    buf_ = buf;
+    cap_ = cap;
+    mask_ = static_cast<uint32_t>(cap - 1U);
+    reset(min_);
+    return true;
+}
+
+void EdgeRing::reset(uint32_t minPulseCycles)
+{
+    head_ = 0U;
+    min_ = minPulseCycles;
+    level_ = LEVEL_UNKNOWN;
+    pending_ = false;
+    edges_ = 0U;
+    glitches_ = 0U;
+    published_ = 0U;
+}
+
+void EdgeRing::stats(EdgeRingStats *out) const
+{
+    out->edges = edges_;
+    out->glitches = glitches_;
+    out->published = published_;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── EdgeReader ──────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+EdgeReader::EdgeReader()
+    : ring_(nullptr),
+      cursor_(0U),
+      cyclesPerUs_(1U),
+      lost_(0U),
+      prevCycles_(0U),
+      prevLevel_(0U),
+      primed_(false)
+{
+}
+
+void EdgeReader::attach(const EdgeRing *ring, uint32_t cyclesPerUs)
+{
+    ring_ = ring;
+    cyclesPerUs_ = (cyclesPerUs == 0U) ? 1U : cyclesPerUs;
+    lost_ = 0U;
+    skipToLive();
+}
+
+void EdgeReader::detach()
+{
+    ring_ = nullptr;
+}
+
+void EdgeReader::skipToLive()
+{
+    cursor_ = (ring_ != nullptr) ? ring_->head() : 0U;
+    primed_ = false;
+}
+
+size_t EdgeReader::readEdges(EdgeStamp *out, size_t max)
+{
+    if (ring_ == nullptr)
+    {
+        return 0U;
+    }
+
+    const uint32_t cap = static_cast<uint32_t>(ring_->capacity());
+    uint32_t from = cursor_;
+    const uint32_t head = ring_->head();
+    if (head - from > cap)
+    {
+        lost_ += head - cap - from;
+        from = head - cap;
+        primed_ = false;
+    }
+    size_t n = head - from;
+    n = (n < max) ? n : max;
+    for (size_t i = 0U; i < n; ++i)
+    {
+        const uint32_t w = ring_->word(from + static_cast<uint32_t>(i));
+        out[i].cycles = w & ~1UL;
+        out[i].level = static_cast<uint8_t>(w & 1U);
+    }
+
+    // The producer may have lapped the copy; drop what it overwrote.
+    const uint32_t oldest = ring_->head() - cap;
+    if (static_cast<int32_t>(oldest - from) > 0)
+    {
+        const size_t stale = (oldest - from < n) ? (oldest - from) : n;
+        for (size_t i = stale; i < n; ++i)
+        {
+            out[i - stale] = out[i];
+        }
+        n -= stale;
+        lost_ += static_cast<uint32_t>(stale);
+        from += static_cast<uint32_t>(stale);
+        primed_ = false;
+    }
+
+    cursor_ = from + static_cast<uint32_t>(n);
+    return n;
+}
+
+size_t EdgeReader::readPulses(int32_t *out, size_t max, int32_t maxUs)
+{
+    size_t n = 0U;
+    EdgeStamp batch[PULSE_BATCH];
+    while (n < max)
+    {
+        // One edge more than pulses wanted: an unprimed reader needs a seed.
+        const size_t want = (max - n + 1U < PULSE_BATCH) ? (max - n + 1U) : PULSE_BATCH;
+        // readEdges() unprimes the reader when edges were lost, so no
+        // pulse spans a gap in the record.
+        const size_t got = readEdges(batch, want);
+        if (got == 0U)
+        {
+            break;
+        }
+
+        size_t used = 0U;
+        for (; used < got && n < max; ++used)
+        {
+            const EdgeStamp &e = batch[used];
+            if (primed_)
+            {
+                const uint32_t us = (e.cycles - prevCycles_) / cyclesPerUs_;
+                const int32_t dur = (us > static_cast<uint32_t>(maxUs))
+                    ? maxUs
+                    : static_cast<int32_t>(us);
+                out[n++] = (prevLevel_ != 0U) ? dur : -dur;
+            }
+            prevCycles_ = e.cycles;
+            prevLevel_ = e.level;
+            primed_ = true;
+        }
+        // Give back edges read ahead but not converted.
+        cursor_ -= static_cast<uint32_t>(got - used);
+    }
+    return n;
+}
+
+} // namespace hackos::edge
@@ -0,0 +1,661 @@
+/**
+ * @file ir_code_db.cpp
+ * @brief Compiled IR code database (see ir_code_db.h).
+ */
+
+#include "hardware/ir/ir_code_db.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace hackos::ir {
+
+namespace {
+
+constexpr uint8_t IRDB_MAGIC[4] = {'H', 'I', 'R', 'D'};
+
+/// Records per sink write while spilling / merging.
+constexpr size_t IO_RECORDS = 8U;
+
+void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, static_cast<uint16_t>(v));
+    put16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+void put64(uint8_t *p, uint64_t v)
+{
+    put32(p, static_cast<uint32_t>(v));
+    put32(p + 4, static_cast<uint32_t>(v >> 32));
+}
+
+uint16_t get16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(get16(p)) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+uint64_t get64(const uint8_t *p)
+{
+    return static_cast<uint64_t>(get32(p)) | (static_cast<uint64_t>(get32(p + 4)) << 32);
+}
+
+void encodeRecord(const IrCodeRecord &r, uint8_t *p)
+{
+    put64(p, r.value);
+    put16(p + 8, r.protocol);
+    put16(p + 10, r.bits);
+    put32(p + 12, r.brand);
+}
+
+void decodeRecord(const uint8_t *p, IrCodeRecord *r)
+{
+    r->value = get64(p);
+    r->protocol = get16(p + 8);
+    r->bits = get16(p + 10);
+    r->brand = get32(p + 12);
+}
+
+/// Sort order of the record table.
+bool recordLess(const IrCodeRecord &a, const IrCodeRecord &b)
+{
+    if (a.protocol != b.protocol)
+    {
+        return a.protocol < b.protocol;
+    }
+    if (a.value != b.value)
+    {
+        return a.value < b.value;
+    }
+    if (a.bits != b.bits)
+    {
+        return a.bits < b.bits;
+    }
+    return a.brand < b.brand;
+}
+
+bool recordEqual(const IrCodeRecord &a, const IrCodeRecord &b)
+{
+    return a.protocol == b.protocol && a.value == b.value && a.bits == b.bits &&
+           a.brand == b.brand;
+}
+
+char *trim(char *s)
+{
+    while (*s == ' ' || *s == '\t')
+    {
+        ++s;
+    }
+    size_t n = std::strlen(s);
+    while (n > 0U && (s[n - 1U] == ' ' || s[n - 1U] == '\t' || s[n - 1U] == '\r'))
+    {
+        s[--n] = '\0';
+    }
+    return s;
+}
+
+/// Strict unsigned parse of a whole field.
+bool parseUnsigned(char *text, int base, uint64_t *out)
+{
+    char *end = nullptr;
+    const char *s = trim(text);
+    if (*s == '\0' || *s == '-')
+    {
+        return false;
+    }
+    *out = std::strtoull(s, &end, base);
+    return end != s && *end == '\0';
+}
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── IrCodeDbBuilder ─────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+IrCodeDbBuilder::IrCodeDbBuilder(IrCodeRecord *runBuf, size_t runCap)
+    : buf_(runBuf),
+      cap_(runCap),
+      used_(0U),
+      runOut_(nullptr),
+      runStart_{},
+      runLen_{},
+      runCount_(0U),
+      records_(0U),
+      protos_{},
+      protoCount_(0U),
+      pool_{},
+      poolUsed_(0U),
+      lastBrand_(-1),
+      line_{},
+      lineLen_(0U),
+      lineOverflow_(false),
+      skipped_(0U),
+      sourceBytes_(0U),
+      ok_(false)
+{
+}
+
+void IrCodeDbBuilder::begin(IrByteSink &runOut)
+{
+    runOut_ = &runOut;
+    used_ = 0U;
+    runCount_ = 0U;
+    records_ = 0U;
+    protoCount_ = 0U;
+    poolUsed_ = 0U;
+    lastBrand_ = -1;
+    lineLen_ = 0U;
+    lineOverflow_ = false;
+    skipped_ = 0U;
+    sourceBytes_ = 0U;
+    ok_ = (buf_ != nullptr && cap_ > 0U);
+}
+
+bool IrCodeDbBuilder::feed(const char *text, size_t len)
+{
+    sourceBytes_ += static_cast<uint32_t>(len);
+    for (size_t i = 0U; ok_ && i < len; ++i)
+    {
+        const char c = text[i];
+        if (c == '\n')
+        {
+            if (!lineOverflow_)
+            {
+                line_[lineLen_] = '\0';
+                ok_ = parseLine();
+            }
+            else
+            {
+                ++skipped_;
+            }
+            lineLen_ = 0U;
+            lineOverflow_ = false;
+        }
+        else if (lineLen_ + 1U < LINE_MAX)
+        {
+            line_[lineLen_++] = c;
+        }
+        else
+        {
+            lineOverflow_ = true;
+        }
+    }
+    return ok_;
+}
+
+bool IrCodeDbBuilder::finish()
+{
+    if (ok_ && lineLen_ > 0U)
+    {
+        if (!lineOverflow_)
+        {
+            line_[lineLen_] = '\0';
+            ok_ = parseLine();
+        }
+        else
+        {
+            ++skipped_;
+        }
+        lineLen_ = 0U;
+    }
+    if (ok_ && used_ > 0U)
+    {
+        ok_ = spillRun();
+    }
+    return ok_;
+}
+
+bool IrCodeDbBuilder::parseLine()
+{
+    char *line = trim(line_);
+    if (*line == '\0' || *line == '#')
+    {
+        return true;
+    }
+
+    // brand,protocol_id,hex_code,bits
+    char *fields[4] = {};
+    size_t n = 0U;
+    fields[n++] = line;
+    for (char *p = line; *p != '\0' && n < 4U; ++p)
+    {
+        if (*p == ',')
+        {
+            *p = '\0';
+            fields[n++] = p + 1;
+        }
+    }
+
+    if (n == 4U)
+    {
+        char *extra = std::strchr(fields[3], ','); // ignore trailing columns
+        if (extra != nullptr)
+        {
+            *extra = '\0';
+        }
+    }
+
+    uint64_t proto = 0U;
+    uint64_t value = 0U;
+    uint64_t bits = 0U;
+    const char *brand = (n == 4U) ? trim(fields[0]) : "";
+    if (n != 4U || *brand == '\0' ||
+        !parseUnsigned(fields[1], 10, &proto) || proto > 0xFFFFU ||
+        !parseUnsigned(fields[2], 16, &value) ||
+        !parseUnsigned(fields[3], 10, &bits) || bits == 0U || bits > 0xFFFFU)
+    {
+        ++skipped_;
+        return true;
+    }
+
+    const int brandOff = internBrand(brand);
+    if (brandOff < 0)
+    {
+        return false; // string pool full
+    }
+
+    IrCodeRecord &r = buf_[used_++];
+    r.value = value;
+    r.protocol = static_cast<uint16_t>(proto);
+    r.bits = static_cast<uint16_t>(bits);
+    r.brand = static_cast<uint32_t>(brandOff);
+
+    return (used_ < cap_) || spillRun();
+}
+
+int IrCodeDbBuilder::internBrand(const char *name)
+{
+    // Source files are grouped by brand: the last name almost always hits.
+    if (lastBrand_ >= 0 && std::strcmp(pool_ + lastBrand_, name) == 0)
+    {
+        return lastBrand_;
+    }
+
+    for (size_t off = 0U; off < poolUsed_; off += std::strlen(pool_ + off) + 1U)
+    {
+        if (std::strcmp(pool_ + off, name) == 0)
+        {
+            lastBrand_ = static_cast<int>(off);
+            return lastBrand_;
+        }
+    }
+
+    const size_t len = std::strlen(name) + 1U;
+    if (poolUsed_ + len > STRING_POOL)
+    {
+        return -1;
+    }
+    std::memcpy(pool_ + poolUsed_, name, len);
+    lastBrand_ = static_cast<int>(poolUsed_);
+    poolUsed_ += len;
+    return lastBrand_;
+}
+
+bool IrCodeDbBuilder::countProtocol(uint16_t protocol)
+{
+    for (size_t i = 0U; i < protoCount_; ++i)
+    {
+        if (protos_[i].protocol == protocol)
+        {
+            ++protos_[i].count;
+            return true;
+        }
+    }
+    if (protoCount_ >= IRDB_MAX_PROTOCOLS)
+    {
+        return false;
+    }
+    protos_[protoCount_++] = {protocol, 0U, 1U};
+    return true;
+}
+
+bool IrCodeDbBuilder::spillRun()
+{
+    if (runCount_ >= MAX_RUNS || runOut_ == nullptr)
+    {
+        return false;
+    }
+
+    std::sort(buf_, buf_ + used_, recordLess);
+
+    uint8_t out[IO_RECORDS * IRDB_RECORD_SIZE];
+    size_t pending = 0U;
+    uint32_t kept = 0U;
+    for (size_t i = 0U; i < used_; ++i)
+    {
+        if (i > 0U && recordEqual(buf_[i], buf_[i - 1U]))
+        {
+            continue;
+        }
+        if (!countProtocol(buf_[i].protocol))
+        {
+            return false;
+        }
+        encodeRecord(buf_[i], out + pending * IRDB_RECORD_SIZE);
+        ++kept;
+        if (++pending == IO_RECORDS)
+        {
+            if (!runOut_->write(out, sizeof(out)))
+            {
+                return false;
+            }
+            pending = 0U;
+        }
+    }
+    if (pending > 0U && !runOut_->write(out, pending * IRDB_RECORD_SIZE))
+    {
+        return false;
+    }
+
+    runStart_[runCount_] = records_;
+    runLen_[runCount_] = kept;
+    ++runCount_;
+    records_ += kept;
+    used_ = 0U;
+    return true;
+}
+
+bool IrCodeDbBuilder::write(IrByteSink &out, IrByteSource &runs)
+{
+    if (!ok_ || runs.size() < records_ * IRDB_RECORD_SIZE)
+    {
+        return false;
+    }
+
+    // ── Header and protocol index ───────────────────────────────────────
+    std::sort(protos_, protos_ + protoCount_,
+              [](const IrProtocolSlice &a, const IrProtocolSlice &b)
+              { return a.protocol < b.protocol; });
+    uint32_t first = 0U;
+    for (size_t i = 0U; i < protoCount_; ++i)
+    {
+        protos_[i].first = first;
+        first += protos_[i].count;
+    }
+
+    const uint32_t recordsOff =
+        static_cast<uint32_t>(IRDB_HEADER_SIZE + protoCount_ * IRDB_INDEX_SIZE);
+    const uint32_t stringsOff = recordsOff + records_ * static_cast<uint32_t>(IRDB_RECORD_SIZE);
+
+    uint8_t hdr[IRDB_HEADER_SIZE] = {};
+    std::memcpy(hdr, IRDB_MAGIC, sizeof(IRDB_MAGIC));
+    put16(hdr + 4, IRDB_VERSION);
+    put16(hdr + 6, static_cast<uint16_t>(protoCount_));
+    put32(hdr + 8, records_);
+    put32(hdr + 12, recordsOff);
+    put32(hdr + 16, stringsOff);
+    put32(hdr + 20, static_cast<uint32_t>(poolUsed_));
+    put32(hdr + 24, sourceBytes_);
+    if (!out.write(hdr, sizeof(hdr)))
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < protoCount_; ++i)
+    {
+        uint8_t e[IRDB_INDEX_SIZE] = {};
+        put16(e, protos_[i].protocol);
+        put32(e + 4, protos_[i].first);
+        put32(e + 8, protos_[i].count);
+        if (!out.write(e, sizeof(e)))
+        {
+            return false;
+        }
+    }
+
+    // ── k-way merge of the sorted runs ──────────────────────────────────
+    // One head record per run; ≤ MAX_RUNS compares per output record.
+    IrCodeRecord heads[MAX_RUNS];
+    uint32_t pos[MAX_RUNS];
+    uint8_t rec[IRDB_RECORD_SIZE];
+    for (size_t r = 0U; r < runCount_; ++r)
+    {
+        pos[r] = 0U;
+        if (runLen_[r] > 0U)
+        {
+            if (runs.readAt(runStart_[r] * IRDB_RECORD_SIZE, rec, sizeof(rec)) != sizeof(rec))
+            {
+                return false;
+            }
+            decodeRecord(rec, &heads[r]);
+        }
+    }
+
+    uint8_t buf[IO_RECORDS * IRDB_RECORD_SIZE];
+    size_t pending = 0U;
+    for (uint32_t n = 0U; n < records_; ++n)
+    {
+        size_t best = MAX_RUNS;
+        for (size_t r = 0U; r < runCount_; ++r)
+        {
+            if (pos[r] < runLen_[r] && (best == MAX_RUNS || recordLess(heads[r], heads[best])))
+            {
+                best = r;
+            }
+        }
+        if (best == MAX_RUNS)
+        {
+            return false;
+        }
+
+        encodeRecord(heads[best], buf + pending * IRDB_RECORD_SIZE);
+        if (++pending == IO_RECORDS)
+        {
+            if (!out.write(buf, sizeof(buf)))
+            {
+                return false;
+            }
+            pending = 0U;
+        }
+
+        if (++pos[best] < runLen_[best])
+        {
+            const uint32_t at = (runStart_[best] + pos[best]) * IRDB_RECORD_SIZE;
+            if (runs.readAt(at, rec, sizeof(rec)) != sizeof(rec))
+            {
+                return false;
+            }
+            decodeRecord(rec, &heads[best]);
+        }
+    }
+    if (pending > 0U && !out.write(buf, pending * IRDB_RECORD_SIZE))
+    {
+        return false;
+    }
+
+    // ── String table ────────────────────────────────────────────────────
+    return poolUsed_ == 0U ||
+           out.write(reinterpret_cast<const uint8_t *>(pool_), poolUsed_);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── IrCodeDb ────────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+IrCodeDb::IrCodeDb()
+    : source_(nullptr),
+      count_(0U),
+      recordsOff_(0U),
+      stringsOff_(0U),
+      stringsSize_(0U),
+      sourceBytes_(0U),
+      protos_{},
+      protoCount_(0U),
+      window_{},
+      windowFirst_(0U),
+      windowCount_(0U),
+      reads_(0U)
+{
+}
+
+bool IrCodeDb::open(IrByteSource &source)
+{
+    close();
+
+    uint8_t hdr[IRDB_HEADER_SIZE];
+    if (source.readAt(0U, hdr, sizeof(hdr)) != sizeof(hdr) ||
+        std::memcmp(hdr, IRDB_MAGIC, sizeof(IRDB_MAGIC)) != 0 ||
+        get16(hdr + 4) != IRDB_VERSION)
+    {
+        return false;
+    }
+
+    const uint16_t protoCount = get16(hdr + 6);
+    const uint32_t count = get32(hdr + 8);
+    const uint32_t recordsOff = get32(hdr + 12);
+    const uint32_t stringsOff = get32(hdr + 16);
+    const uint32_t stringsSize = get32(hdr + 20);
+    if (protoCount > IRDB_MAX_PROTOCOLS ||
+        recordsOff != IRDB_HEADER_SIZE + protoCount * IRDB_INDEX_SIZE ||
+        stringsOff != recordsOff + static_cast<uint64_t>(count) * IRDB_RECORD_SIZE ||
+        static_cast<uint64_t>(stringsOff) + stringsSize > source.size())
+    {
+        return false;
+    }
+
+    uint8_t index[IRDB_MAX_PROTOCOLS * IRDB_INDEX_SIZE];
+    const size_t indexLen = protoCount * IRDB_INDEX_SIZE;
+    if (indexLen > 0U && source.readAt(IRDB_HEADER_SIZE, index, indexLen) != indexLen)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < protoCount; ++i)
+    {
+        const uint8_t *e = index + i * IRDB_INDEX_SIZE;
+        protos_[i] = {get16(e), get32(e + 4), get32(e + 8)};
+        if (static_cast<uint64_t>(protos_[i].first) + protos_[i].count > count)
+        {
+            return false;
+        }
+    }
+
+    source_ = &source;
+    protoCount_ = protoCount;
+    count_ = count;
+    recordsOff_ = recordsOff;
+    stringsOff_ = stringsOff;
+    stringsSize_ = stringsSize;
+    sourceBytes_ = get32(hdr + 24);
+    reads_ = 1U;
+    return true;
+}
+
+void IrCodeDb::close()
+{
+    source_ = nullptr;
+    count_ = 0U;
+    protoCount_ = 0U;
+    windowCount_ = 0U;
+}
+
+bool IrCodeDb::loadWindow(uint32_t index)
+{
+    const uint32_t left = count_ - index;
+    const uint32_t n = (left < WINDOW_RECORDS) ? left : static_cast<uint32_t>(WINDOW_RECORDS);
+    ++reads_;
+    const size_t bytes = n * IRDB_RECORD_SIZE;
+    if (source_->readAt(recordsOff_ + index * IRDB_RECORD_SIZE, window_, bytes) != bytes)
+    {
+        windowCount_ = 0U;
+        return false;
+    }
+    windowFirst_ = index;
+    windowCount_ = n;
+    return true;
+}
+
+bool IrCodeDb::record(uint32_t index, IrCodeRecord *out)
+{
+    if (source_ == nullptr || out == nullptr || index >= count_)
+    {
+        return false;
+    }
+    if ((index < windowFirst_ || index >= windowFirst_ + windowCount_) &&
+        !loadWindow(index))
+    {
+        return false;
+    }
+    decodeRecord(window_ + (index - windowFirst_) * IRDB_RECORD_SIZE, out);
+    return true;
+}
+
+bool IrCodeDb::brand(const IrCodeRecord &rec, char *out, size_t len)
+{
+    if (source_ == nullptr || out == nullptr || len == 0U || rec.brand >= stringsSize_)
+    {
+        return false;
+    }
+    size_t n = stringsSize_ - rec.brand;
+    if (n > len - 1U)
+    {
+        n = len - 1U;
+    }
+    ++reads_;
+    const size_t got = source_->readAt(stringsOff_ + rec.brand,
+                                       reinterpret_cast<uint8_t *>(out), n);
+    out[got] = '\0';
+    return got > 0U;
+}
+
+bool IrCodeDb::find(uint16_t protocol, uint64_t value, uint16_t bits, uint32_t *index)
+{
+    if (source_ == nullptr)
+    {
+        return false;
+    }
+
+    const IrProtocolSlice *slice = nullptr;
+    for (size_t i = 0U; i < protoCount_ && slice == nullptr; ++i)
+    {
+        slice = (protos_[i].protocol == protocol) ? &protos_[i] : nullptr;
+    }
+    if (slice == nullptr)
+    {
+        return false;
+    }
+
+    // lower_bound on (value, bits) inside the protocol's slice.
+    uint32_t lo = slice->first;
+    uint32_t hi = slice->first + slice->count;
+    IrCodeRecord r;
+    while (lo < hi)
+    {
+        const uint32_t mid = lo + (hi - lo) / 2U;
+        if (!record(mid, &r))
+        {
+            return false;
+        }
+        if (r.value < value || (r.value == value && r.bits < bits))
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if (lo >= slice->first + slice->count || !record(lo, &r) || r.value != value ||
+        (bits != 0U && r.bits != bits))
+    {
+        return false;
+    }
+    if (index != nullptr)
+    {
+        *index = lo;
+    }
+    return true;
+}
+
+} // namespace hackos::ir
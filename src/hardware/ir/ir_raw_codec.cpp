@@ -0,0 +1,502 @@
+/**
+ * @file ir_raw_codec.cpp
+ * @brief Raw IR timing compression (see ir_raw_codec.h).
+ */
+
+#include "hardware/ir/ir_raw_codec.h"
+
+#include <cstring>
+
+namespace hackos::ir {
+
+namespace {
+
+constexpr uint8_t IR_RAW_MAGIC[4] = {'H', 'I', 'R', 'R'};
+
+/// Longest Elias gamma prefix accepted by the decoder (values < 2^16).
+constexpr uint8_t GAMMA_MAX_ZEROS = 16U;
+
+void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t get16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+/// Bits needed to store any value in 0 … @p maxValue (at least 1).
+uint8_t bitsFor(size_t maxValue)
+{
+    uint8_t bits = 1U;
+    while ((static_cast<size_t>(1U) << bits) <= maxValue)
+    {
+        ++bits;
+    }
+    return bits;
+}
+
+/// Length of the Elias gamma code of @p v (v ≥ 1).
+size_t gammaBits(uint32_t v)
+{
+    size_t n = 0U;
+    while ((v >> n) > 1U)
+    {
+        ++n;
+    }
+    return 2U * n + 1U;
+}
+
+/// MSB-first bit packer over a fixed buffer.
+class BitWriter
+{
+public:
+    BitWriter(uint8_t *out, size_t cap) : out_(out), cap_(cap), bitPos_(0U), ok_(true) {}
+
+    void put(uint32_t v, size_t n)
+    {
+        while (n > 0U)
+        {
+            --n;
+            const size_t byte = bitPos_ >> 3;
+            if (byte >= cap_)
+            {
+                ok_ = false;
+                return;
+            }
+            const uint8_t mask = static_cast<uint8_t>(0x80U >> (bitPos_ & 7U));
+            if ((bitPos_ & 7U) == 0U)
+            {
+                out_[byte] = 0U;
+            }
+            if (((v >> n) & 1U) != 0U)
+            {
+                out_[byte] = static_cast<uint8_t>(out_[byte] | mask);
+            }
+            ++bitPos_;
+        }
+    }
+
+    void putGamma(uint32_t v)
+    {
+        const size_t len = gammaBits(v);
+        put(0U, len / 2U);
+        put(v, len / 2U + 1U);
+    }
+
+    size_t bytes() const { return (bitPos_ + 7U) >> 3; }
+    bool ok() const { return ok_; }
+
+private:
+    uint8_t *out_;
+    size_t cap_;
+    size_t bitPos_;
+    bool ok_;
+};
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── IrRawEncoder ────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+IrRawEncoder::IrRawEncoder()
+    : dict_{},
+      dictLo_{},
+      dictCount_(0U),
+      pairs_{},
+      pairCount_(0U),
+      seq_{},
+      seqLen_(0U),
+      copies_(0U),
+      maxError_(0U)
+{
+}
+
+bool IrRawEncoder::encode(const uint16_t *timings, size_t count, uint8_t carrierKhz,
+                          uint16_t toleranceUs, uint8_t *out, size_t cap, size_t *outLen)
+{
+    copies_ = 0U;
+    maxError_ = 0U;
+    if (timings == nullptr || count == 0U || count > IR_RAW_MAX_TIMINGS)
+    {
+        return false;
+    }
+    if (!buildDictionary(timings, count, toleranceUs) || !buildPairs(timings, count))
+    {
+        return false;
+    }
+
+    const size_t tables = IR_RAW_HEADER_SIZE + 2U * dictCount_ + 2U * pairCount_;
+    if (cap < tables)
+    {
+        return false;
+    }
+
+    std::memcpy(out, IR_RAW_MAGIC, sizeof(IR_RAW_MAGIC));
+    out[4] = IR_RAW_VERSION;
+    out[5] = carrierKhz;
+    put16(out + 6, static_cast<uint16_t>(count));
+    out[8] = static_cast<uint8_t>(dictCount_);
+    out[9] = static_cast<uint8_t>(pairCount_);
+    uint8_t *p = out + IR_RAW_HEADER_SIZE;
+    for (size_t i = 0U; i < dictCount_; ++i, p += 2)
+    {
+        put16(p, dict_[i]);
+    }
+    for (size_t i = 0U; i < pairCount_; ++i, p += 2)
+    {
+        p[0] = pairs_[i][0];
+        p[1] = pairs_[i][1];
+    }
+
+    // Greedy parse: take the longest earlier match when it is cheaper than
+    // spelling the same pairs out as literals.
+    const uint8_t width = bitsFor(pairCount_);
+    const uint32_t esc = static_cast<uint32_t>(pairCount_);
+    BitWriter bw(out + tables, cap - tables);
+    size_t pos = 0U;
+    while (pos < seqLen_ && bw.ok())
+    {
+        size_t distance = 0U;
+        const size_t len = longestMatch(pos, &distance);
+        if (len >= MIN_MATCH)
+        {
+            const size_t cost = width + gammaBits(static_cast<uint32_t>(distance)) +
+                                gammaBits(static_cast<uint32_t>(len));
+            if (cost < len * width)
+            {
+                bw.put(esc, width);
+                bw.putGamma(static_cast<uint32_t>(distance));
+                bw.putGamma(static_cast<uint32_t>(len));
+                pos += len;
+                ++copies_;
+                continue;
+            }
+        }
+        bw.put(seq_[pos], width);
+        ++pos;
+    }
+    if (!bw.ok())
+    {
+        return false;
+    }
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const uint16_t dec = dict_[dictIndex(timings[i])];
+        const uint16_t err = static_cast<uint16_t>(dec > timings[i] ? dec - timings[i]
+                                                                    : timings[i] - dec);
+        if (err > maxError_)
+        {
+            maxError_ = err;
+        }
+    }
+    *outLen = tables + bw.bytes();
+    return true;
+}
+
+bool IrRawEncoder::buildDictionary(const uint16_t *timings, size_t count,
+                                   uint16_t toleranceUs)
+{
+    // One pass per cluster: start at the smallest duration not yet covered
+    // and take everything within toleranceUs of it.  No sort and no copy of
+    // the input; at most IR_RAW_MAX_DICT passes.
+    dictCount_ = 0U;
+    uint32_t uncovered = 0U; // smallest duration not yet in a cluster
+    for (;;)
+    {
+        uint32_t lo = UINT32_MAX;
+        for (size_t i = 0U; i < count; ++i)
+        {
+            if (timings[i] >= uncovered && timings[i] < lo)
+            {
+                lo = timings[i];
+            }
+        }
+        if (lo == UINT32_MAX)
+        {
+            return true;
+        }
+        if (dictCount_ == IR_RAW_MAX_DICT)
+        {
+            return false;
+        }
+
+        const uint32_t hi = lo + toleranceUs;
+        uint32_t sum = 0U;
+        uint32_t n = 0U;
+        for (size_t i = 0U; i < count; ++i)
+        {
+            if (timings[i] >= lo && timings[i] <= hi)
+            {
+                sum += timings[i];
+                ++n;
+            }
+        }
+        dictLo_[dictCount_] = static_cast<uint16_t>(lo);
+        dict_[dictCount_] = static_cast<uint16_t>((sum + n / 2U) / n);
+        ++dictCount_;
+        uncovered = hi + 1U;
+    }
+}
+
+uint8_t IrRawEncoder::dictIndex(uint16_t us) const
+{
+    // Clusters are disjoint and ascending: the last one starting at or
+    // below @p us holds it.
+    size_t i = dictCount_ - 1U;
+    while (i > 0U && dictLo_[i] > us)
+    {
+        --i;
+    }
+    return static_cast<uint8_t>(i);
+}
+
+bool IrRawEncoder::buildPairs(const uint16_t *timings, size_t count)
+{
+    pairCount_ = 0U;
+    seqLen_ = (count + 1U) / 2U;
+    for (size_t k = 0U; k < seqLen_; ++k)
+    {
+        const uint8_t mark = dictIndex(timings[2U * k]);
+        const uint8_t space = (2U * k + 1U < count) ? dictIndex(timings[2U * k + 1U]) : 0U;
+
+        size_t idx = 0U;
+        while (idx < pairCount_ && (pairs_[idx][0] != mark || pairs_[idx][1] != space))
+        {
+            ++idx;
+        }
+        if (idx == pairCount_)
+        {
+            if (pairCount_ == IR_RAW_MAX_PAIR_TABLE)
+            {
+                return false;
+            }
+            pairs_[idx][0] = mark;
+            pairs_[idx][1] = space;
+            ++pairCount_;
+        }
+        seq_[k] = static_cast<uint8_t>(idx);
+    }
+    return true;
+}
+
+size_t IrRawEncoder::longestMatch(size_t pos, size_t *distance) const
+{
+    // Overlapping matches are allowed (distance 1 = run of one pair).
+    size_t best = 0U;
+    const size_t remaining = seqLen_ - pos;
+    for (size_t from = pos; from > 0U && best < remaining; --from)
+    {
+        const size_t start = from - 1U;
+        size_t len = 0U;
+        while (len < remaining && seq_[start + len] == seq_[pos + len])
+        {
+            ++len;
+        }
+        if (len > best)
+        {
+            best = len;
+            *distance = pos - start;
+        }
+    }
+    return best;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── IrRawDecoder ────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+IrRawDecoder::IrRawDecoder()
+    : data_(nullptr),
+      len_(0U),
+      count_(0U),
+      carrierKhz_(0U),
+      dict_{},
+      dictCount_(0U),
+      pairs_(nullptr),
+      pairCount_(0U),
+      width_(0U),
+      streamOff_(0U),
+      bitPos_(0U),
+      hist_{},
+      histLen_(0U),
+      copyDist_(0U),
+      copyLeft_(0U),
+      curPair_(0U),
+      spaceNext_(false),
+      emitted_(0U),
+      failed_(false)
+{
+}
+
+bool IrRawDecoder::begin(const uint8_t *data, size_t len)
+{
+    data_ = nullptr;
+    count_ = 0U;
+    if (data == nullptr || len < IR_RAW_HEADER_SIZE ||
+        std::memcmp(data, IR_RAW_MAGIC, sizeof(IR_RAW_MAGIC)) != 0 ||
+        data[4] != IR_RAW_VERSION)
+    {
+        return false;
+    }
+
+    const uint16_t count = get16(data + 6);
+    const size_t dictCount = data[8];
+    const size_t pairCount = data[9];
+    const size_t tables = IR_RAW_HEADER_SIZE + 2U * dictCount + 2U * pairCount;
+    if (count == 0U || count > IR_RAW_MAX_TIMINGS || dictCount == 0U ||
+        dictCount > IR_RAW_MAX_DICT || pairCount == 0U || len < tables)
+    {
+        return false;
+    }
+
+    const uint8_t *p = data + IR_RAW_HEADER_SIZE;
+    for (size_t i = 0U; i < dictCount; ++i, p += 2)
+    {
+        dict_[i] = get16(p);
+    }
+    for (size_t i = 0U; i < pairCount; ++i)
+    {
+        if (p[2U * i] >= dictCount || p[2U * i + 1U] >= dictCount)
+        {
+            return false;
+        }
+    }
+
+    data_ = data;
+    len_ = len;
+    count_ = count;
+    carrierKhz_ = data[5];
+    dictCount_ = dictCount;
+    pairs_ = p;
+    pairCount_ = pairCount;
+    width_ = bitsFor(pairCount);
+    streamOff_ = tables;
+    return rewind();
+}
+
+bool IrRawDecoder::rewind()
+{
+    bitPos_ = streamOff_ * 8U;
+    histLen_ = 0U;
+    copyDist_ = 0U;
+    copyLeft_ = 0U;
+    spaceNext_ = false;
+    emitted_ = 0U;
+    failed_ = false;
+    return data_ != nullptr;
+}
+
+bool IrRawDecoder::readBits(uint8_t n, uint32_t *v)
+{
+    if (bitPos_ + n > len_ * 8U)
+    {
+        return false;
+    }
+    uint32_t acc = 0U;
+    for (uint8_t i = 0U; i < n; ++i, ++bitPos_)
+    {
+        acc = (acc << 1) | ((data_[bitPos_ >> 3] >> (7U - (bitPos_ & 7U))) & 1U);
+    }
+    *v = acc;
+    return true;
+}
+
+bool IrRawDecoder::readGamma(uint32_t *v)
+{
+    uint8_t zeros = 0U;
+    uint32_t bit = 0U;
+    while (readBits(1U, &bit) && bit == 0U)
+    {
+        if (++zeros > GAMMA_MAX_ZEROS)
+        {
+            return false;
+        }
+    }
+    if (bit != 1U)
+    {
+        return false;
+    }
+    uint32_t rest = 0U;
+    if (!readBits(zeros, &rest))
+    {
+        return false;
+    }
+    *v = (1U << zeros) | rest;
+    return true;
+}
+
+bool IrRawDecoder::nextPair(uint8_t *pair)
+{
+    if (copyLeft_ == 0U)
+    {
+        uint32_t sym = 0U;
+        if (!readBits(width_, &sym) || sym > pairCount_)
+        {
+            return false;
+        }
+        if (sym < pairCount_)
+        {
+            *pair = static_cast<uint8_t>(sym);
+            hist_[histLen_++] = *pair;
+            return true;
+        }
+        if (!readGamma(&copyDist_) || !readGamma(&copyLeft_) || copyDist_ > histLen_)
+        {
+            return false;
+        }
+    }
+    if (histLen_ >= IR_RAW_MAX_PAIRS)
+    {
+        return false;
+    }
+    *pair = hist_[histLen_ - copyDist_];
+    hist_[histLen_++] = *pair;
+    --copyLeft_;
+    return true;
+}
+
+bool IrRawDecoder::next(uint16_t *us)
+{
+    if (data_ == nullptr || failed_ || emitted_ >= count_)
+    {
+        return false;
+    }
+    if (spaceNext_)
+    {
+        *us = dict_[pairs_[2U * curPair_ + 1U]];
+        spaceNext_ = false;
+    }
+    else
+    {
+        if (histLen_ >= IR_RAW_MAX_PAIRS || !nextPair(&curPair_))
+        {
+            failed_ = true;
+            return false;
+        }
+        *us = dict_[pairs_[2U * curPair_]];
+        spaceNext_ = true;
+    }
+    ++emitted_;
+    return true;
+}
+
+size_t IrRawDecoder::decode(uint16_t *out, size_t cap)
+{
+    if (!rewind() || cap < count_)
+    {
+        return 0U;
+    }
+    size_t n = 0U;
+    while (next(&out[n]))
+    {
+        ++n;
+    }
+    return failed_ ? 0U : n;
+}
+
+} // namespace hackos::ir
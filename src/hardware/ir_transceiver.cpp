@@ -23,7 +23,9 @@ IRTransceiver::IRTransceiver()
       hasLast_(false),
       lastValue_(0U),
       lastProtocol_(decode_type_t::UNKNOWN),
-      lastBits_(0U)
+      lastBits_(0U),
+      lastRaw_{},
+      lastRawCount_(0U)
 {
 }
 
@@ -105,6 +107,14 @@ bool IRTransceiver::decode(uint64_t &value, decode_type_t &protocol, uint16_t &b
     lastBits_ = bits;
     hasLast_ = true;
 
+    // rawbuf[0] is the gap before the frame; the rest is in ticks.
+    lastRawCount_ = 0U;
+    for (uint16_t i = 1U; i < results_.rawlen && lastRawCount_ < CAPTURE_BUF; ++i)
+    {
+        const uint32_t us = static_cast<uint32_t>(results_.rawbuf[i]) * kRawTick;
+        lastRaw_[lastRawCount_++] = static_cast<uint16_t>(us > 0xFFFFU ? 0xFFFFU : us);
+    }
+
     recv_->resume();
     ESP_LOGD(TAG_IR, "decoded: proto=%d value=0x%llX bits=%u",
              static_cast<int>(protocol),
@@ -127,6 +137,18 @@ void IRTransceiver::send(uint64_t value, decode_type_t protocol, uint16_t bits)
              static_cast<unsigned>(bits));
 }
 
+void IRTransceiver::sendRaw(const uint16_t *timings, uint16_t count, uint16_t khz)
+{
+    if (!sendActive_ || send_ == nullptr || timings == nullptr || count == 0U)
+    {
+        return;
+    }
+
+    send_->sendRaw(timings, count, khz);
+    ESP_LOGI(TAG_IR, "sent raw: %u timings @ %u kHz",
+             static_cast<unsigned>(count), static_cast<unsigned>(khz));
+}
+
 bool IRTransceiver::hasLastCode() const
 {
     return hasLast_;
@@ -146,3 +168,9 @@ uint16_t IRTransceiver::lastBits() const
 {
     return lastBits_;
 }
+
+const uint16_t *IRTransceiver::lastRaw(uint16_t *count) const
+{
+    *count = lastRawCount_;
+    return lastRawCount_ > 0U ? lastRaw_ : nullptr;
+}
@@ -0,0 +1,516 @@
+/**
+ * @file bus_decoders.cpp
+ * @brief Streaming bus decoders and VCD export (see bus_decoders.h).
+ */
+
+#include "hardware/logic/bus_decoders.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace hackos::logic {
+
+namespace {
+
+/// Rates auto-baud snaps to when the estimate is within BAUD_SNAP_PCT.
+constexpr uint32_t STANDARD_BAUDS[] = {
+    300U,    600U,    1200U,   2400U,   4800U,   9600U,   14400U,
+    19200U,  28800U,  38400U,  57600U,  74880U,  115200U, 230400U,
+    250000U, 460800U, 500000U, 921600U, 1000000U, 2000000U,
+};
+constexpr uint32_t BAUD_SNAP_PCT = 3U;
+
+/// Auto-baud ignores gaps longer than this many bit times (idle between
+/// frames says nothing about the bit time).
+constexpr uint64_t AUTOBAUD_MAX_BITS = 10U;
+
+constexpr uint64_t NS_PER_S = 1000000000ULL;
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── UartDecoder ─────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+UartDecoder::UartDecoder(BusEventSink &sink, const UartConfig &config, uint32_t rateHz)
+    : BusDecoder(sink),
+      config_(config),
+      rateHz_(rateHz),
+      baud_(0U),
+      bitQ8_(0U),
+      line_(true),
+      inFrame_(false),
+      frameStart_(0U),
+      bitIndex_(0U),
+      shift_(0U),
+      flags_(0U),
+      pendingTick_{},
+      pendingHigh_{},
+      pendingCount_(0U)
+{
+    reset();
+}
+
+void UartDecoder::reset()
+{
+    line_ = true;
+    inFrame_ = false;
+    pendingCount_ = 0U;
+    baud_ = 0U;
+    bitQ8_ = 0U;
+    if (config_.baud != 0U)
+    {
+        setBaud(config_.baud);
+    }
+}
+
+void UartDecoder::setBaud(uint32_t baud)
+{
+    baud_ = baud;
+    bitQ8_ = (static_cast<uint64_t>(rateHz_) << 8) / baud;
+}
+
+void UartDecoder::feed(const LogicEdge &edge)
+{
+    const bool high = level(edge.state, config_.channel) != config_.inverted;
+
+    if (baud_ == 0U)
+    {
+        const bool last = (pendingCount_ > 0U) ? pendingHigh_[pendingCount_ - 1U] : line_;
+        if (high == last)
+        {
+            return;
+        }
+        pendingTick_[pendingCount_] = edge.tick;
+        pendingHigh_[pendingCount_] = high;
+        if (++pendingCount_ == AUTOBAUD_EDGES && !detectBaud())
+        {
+            pendingCount_ = 0U; // nothing usable yet – collect afresh
+        }
+        return;
+    }
+
+    if (high != line_)
+    {
+        lineEdge(edge.tick, high);
+    }
+}
+
+void UartDecoder::finish(uint64_t endTick)
+{
+    if (baud_ == 0U && !detectBaud())
+    {
+        return;
+    }
+    sampleUntil(endTick);
+}
+
+bool UartDecoder::detectBaud()
+{
+    if (pendingCount_ < 3U)
+    {
+        return false;
+    }
+
+    // The shortest pulse is one bit; longer pulses are whole multiples of
+    // it, so averaging over all of them refines the estimate.
+    uint64_t shortest = UINT64_MAX;
+    for (size_t i = 1U; i < pendingCount_; ++i)
+    {
+        const uint64_t width = pendingTick_[i] - pendingTick_[i - 1U];
+        if (width > 0U && width < shortest)
+        {
+            shortest = width;
+        }
+    }
+    if (shortest == UINT64_MAX)
+    {
+        return false;
+    }
+
+    uint64_t ticks = 0U;
+    uint64_t bits = 0U;
+    for (size_t i = 1U; i < pendingCount_; ++i)
+    {
+        const uint64_t width = pendingTick_[i] - pendingTick_[i - 1U];
+        const uint64_t n = (width + shortest / 2U) / shortest;
+        if (n >= 1U && n <= AUTOBAUD_MAX_BITS)
+        {
+            ticks += width;
+            bits += n;
+        }
+    }
+    if (bits == 0U || ticks == 0U)
+    {
+        return false;
+    }
+
+    uint32_t baud = static_cast<uint32_t>((static_cast<uint64_t>(rateHz_) * bits) / ticks);
+    for (const uint32_t std : STANDARD_BAUDS)
+    {
+        const uint32_t diff = (baud > std) ? baud - std : std - baud;
+        if (diff * 100U <= std * BAUD_SNAP_PCT)
+        {
+            baud = std;
+            break;
+        }
+    }
+    if (baud == 0U)
+    {
+        return false;
+    }
+    setBaud(baud);
+
+    // Replay the buffered edges through the frame decoder.
+    const size_t count = pendingCount_;
+    pendingCount_ = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        lineEdge(pendingTick_[i], pendingHigh_[i]);
+    }
+    return true;
+}
+
+void UartDecoder::lineEdge(uint64_t tick, bool high)
+{
+    sampleUntil(tick);
+    line_ = high;
+    if (!inFrame_ && !high)
+    {
+        inFrame_ = true;
+        frameStart_ = tick;
+        bitIndex_ = 0U;
+        shift_ = 0U;
+        flags_ = 0U;
+    }
+}
+
+void UartDecoder::sampleUntil(uint64_t tick)
+{
+    const uint8_t parityBits = (config_.parity == UartParity::NONE) ? 0U : 1U;
+    const uint8_t stopIndex = static_cast<uint8_t>(1U + config_.dataBits + parityBits);
+
+    while (inFrame_)
+    {
+        // Centre of bit n: start + (n + ½) bit times.
+        const uint64_t at = frameStart_ + ((bitQ8_ * (2U * bitIndex_ + 1U)) >> 9);
+        if (at >= tick)
+        {
+            return; // the line may still change before this sample point
+        }
+
+        if (bitIndex_ == 0U)
+        {
+            if (line_)
+            {
+                inFrame_ = false; // glitch, not a start bit
+                return;
+            }
+        }
+        else if (bitIndex_ <= config_.dataBits)
+        {
+            shift_ = static_cast<uint16_t>(shift_ | (static_cast<uint16_t>(line_) << (bitIndex_ - 1U)));
+        }
+        else if (bitIndex_ < stopIndex)
+        {
+            uint8_t ones = static_cast<uint8_t>(line_);
+            for (uint16_t v = shift_; v != 0U; v = static_cast<uint16_t>(v & (v - 1U)))
+            {
+                ++ones;
+            }
+            const bool odd = (ones & 1U) != 0U;
+            if (odd != (config_.parity == UartParity::ODD))
+            {
+                flags_ = static_cast<uint8_t>(flags_ | BUS_FLAG_PARITY);
+            }
+        }
+        else
+        {
+            if (!line_)
+            {
+                flags_ = static_cast<uint8_t>(flags_ | BUS_FLAG_FRAMING);
+            }
+            endFrame();
+            return;
+        }
+        ++bitIndex_;
+    }
+}
+
+void UartDecoder::endFrame()
+{
+    inFrame_ = false;
+    const uint64_t end = frameStart_ + ((bitQ8_ * (2U * bitIndex_ + 1U)) >> 9);
+    emit({BusEventType::UART_BYTE, flags_, shift_, 0U, frameStart_, end});
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── I2cDecoder ──────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+I2cDecoder::I2cDecoder(BusEventSink &sink, uint8_t sdaChannel, uint8_t sclChannel)
+    : BusDecoder(sink),
+      sda_(sdaChannel),
+      scl_(sclChannel),
+      active_(false),
+      addressPhase_(false),
+      bitCount_(0U),
+      byte_(0U),
+      byteStart_(0U)
+{
+}
+
+void I2cDecoder::reset()
+{
+    active_ = false;
+    addressPhase_ = false;
+    bitCount_ = 0U;
+    byte_ = 0U;
+}
+
+void I2cDecoder::feed(const LogicEdge &edge)
+{
+    const uint8_t prev = static_cast<uint8_t>(edge.state ^ edge.changed);
+    const bool sda = level(edge.state, sda_);
+    const bool scl = level(edge.state, scl_);
+
+    if (level(edge.changed, scl_))
+    {
+        // Data is sampled on the rising clock edge.  If SDA moved in the
+        // same sample it was set up just before the edge, so use the new
+        // level.
+        if (!scl || !active_)
+        {
+            return;
+        }
+        if (bitCount_ < 8U)
+        {
+            if (bitCount_ == 0U)
+            {
+                byteStart_ = edge.tick;
+            }
+            byte_ = static_cast<uint8_t>((byte_ << 1) | static_cast<uint8_t>(sda));
+            ++bitCount_;
+            return;
+        }
+
+        const uint8_t ack = sda ? BUS_FLAG_NACK : 0U;
+        if (addressPhase_)
+        {
+            const uint8_t rw = ((byte_ & 1U) != 0U) ? BUS_FLAG_READ : 0U;
+            emit({BusEventType::I2C_ADDRESS, static_cast<uint8_t>(ack | rw),
+                  static_cast<uint16_t>(byte_ >> 1), 0U, byteStart_, edge.tick});
+            addressPhase_ = false;
+        }
+        else
+        {
+            emit({BusEventType::I2C_DATA, ack, byte_, 0U, byteStart_, edge.tick});
+        }
+        bitCount_ = 0U;
+        byte_ = 0U;
+        return;
+    }
+
+    // SDA moving while SCL stays high is a bus condition, not data.
+    if (!level(edge.changed, sda_) || !scl || !level(prev, scl_))
+    {
+        return;
+    }
+    if (!sda)
+    {
+        emit({active_ ? BusEventType::I2C_RESTART : BusEventType::I2C_START, 0U, 0U, 0U,
+              edge.tick, edge.tick});
+        active_ = true;
+        addressPhase_ = true;
+        bitCount_ = 0U;
+        byte_ = 0U;
+    }
+    else if (active_)
+    {
+        emit({BusEventType::I2C_STOP, 0U, 0U, 0U, edge.tick, edge.tick});
+        active_ = false;
+    }
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── SpiDecoder ──────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+SpiDecoder::SpiDecoder(BusEventSink &sink, const SpiConfig &config)
+    : BusDecoder(sink),
+      config_(config),
+      sampleLevel_(config.cpha ? config.cpol : !config.cpol),
+      primed_(false),
+      bits_(0U),
+      mosi_(0U),
+      miso_(0U),
+      wordStart_(0U)
+{
+    if (config_.wordBits == 0U || config_.wordBits > 16U)
+    {
+        config_.wordBits = 8U;
+    }
+}
+
+void SpiDecoder::reset()
+{
+    primed_ = false;
+    bits_ = 0U;
+    mosi_ = 0U;
+    miso_ = 0U;
+}
+
+void SpiDecoder::setMode(bool cpol, bool cpha)
+{
+    config_.cpol = cpol;
+    config_.cpha = cpha;
+    sampleLevel_ = cpha ? cpol : !cpol;
+    bits_ = 0U;
+    mosi_ = 0U;
+    miso_ = 0U;
+}
+
+void SpiDecoder::feed(const LogicEdge &edge)
+{
+    if (!primed_)
+    {
+        primed_ = true; // levels at capture start, not edges
+        return;
+    }
+
+    const bool hasCs = config_.cs != LOGIC_NO_CHANNEL;
+    if (hasCs && level(edge.changed, config_.cs))
+    {
+        if (bits_ > 0U)
+        {
+            endWord(edge.tick, BUS_FLAG_PARTIAL);
+        }
+        bits_ = 0U; // assert or release: either way a word starts afresh
+    }
+    if (hasCs && level(edge.state, config_.cs))
+    {
+        return; // deselected
+    }
+    if (!level(edge.changed, config_.clk) || level(edge.state, config_.clk) != sampleLevel_)
+    {
+        return;
+    }
+
+    const uint16_t mosi = static_cast<uint16_t>(level(edge.state, config_.mosi));
+    const uint16_t miso = (config_.miso != LOGIC_NO_CHANNEL)
+                              ? static_cast<uint16_t>(level(edge.state, config_.miso))
+                              : 0U;
+    if (bits_ == 0U)
+    {
+        wordStart_ = edge.tick;
+    }
+    if (config_.msbFirst)
+    {
+        mosi_ = static_cast<uint16_t>((mosi_ << 1) | mosi);
+        miso_ = static_cast<uint16_t>((miso_ << 1) | miso);
+    }
+    else
+    {
+        mosi_ = static_cast<uint16_t>(mosi_ | (mosi << bits_));
+        miso_ = static_cast<uint16_t>(miso_ | (miso << bits_));
+    }
+    if (++bits_ == config_.wordBits)
+    {
+        endWord(edge.tick, 0U);
+    }
+}
+
+void SpiDecoder::endWord(uint64_t tick, uint8_t flags)
+{
+    emit({BusEventType::SPI_WORD, flags, mosi_, miso_, wordStart_, tick});
+    bits_ = 0U;
+    mosi_ = 0U;
+    miso_ = 0U;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── VcdWriter ───────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+VcdWriter::VcdWriter(LogicTextSink &out, uint32_t rateHz)
+    : out_(out), rateHz_(rateHz), channels_(0U), state_(0U), ok_(false)
+{
+}
+
+bool VcdWriter::print(const char *fmt, ...)
+{
+    char line[96];
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (n < 0 || static_cast<size_t>(n) >= sizeof(line))
+    {
+        ok_ = false;
+        return false;
+    }
+    if (!out_.write(line, static_cast<size_t>(n)))
+    {
+        ok_ = false;
+    }
+    return ok_;
+}
+
+uint64_t VcdWriter::tickToNs(uint64_t tick) const
+{
+    // Split so tick × 10^9 cannot overflow for long captures.
+    return (tick / rateHz_) * NS_PER_S + ((tick % rateHz_) * NS_PER_S) / rateHz_;
+}
+
+bool VcdWriter::begin(const char *const *names, size_t channels, uint8_t initialState)
+{
+    if (channels == 0U || channels > LOGIC_MAX_CHANNELS || rateHz_ == 0U)
+    {
+        return false;
+    }
+    ok_ = true;
+    channels_ = channels;
+    state_ = initialState;
+
+    print("$version HackOS logic analyser $end\n");
+    print("$comment %lu Hz sample rate $end\n", static_cast<unsigned long>(rateHz_));
+    print("$timescale 1 ns $end\n$scope module logic $end\n");
+    for (size_t c = 0U; c < channels; ++c)
+    {
+        print("$var wire 1 %c %s $end\n", static_cast<char>('!' + c), names[c]);
+    }
+    print("$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (size_t c = 0U; c < channels; ++c)
+    {
+        print("%c%c\n", ((initialState >> c) & 1U) ? '1' : '0', static_cast<char>('!' + c));
+    }
+    return print("$end\n");
+}
+
+bool VcdWriter::edge(const LogicEdge &edge)
+{
+    const uint8_t mask = static_cast<uint8_t>((1U << channels_) - 1U);
+    const uint8_t diff = static_cast<uint8_t>((edge.state ^ state_) & mask);
+    if (!ok_ || diff == 0U)
+    {
+        return ok_;
+    }
+    state_ = edge.state;
+
+    print("#%llu\n", static_cast<unsigned long long>(tickToNs(edge.tick)));
+    for (size_t c = 0U; c < channels_; ++c)
+    {
+        if (((diff >> c) & 1U) != 0U)
+        {
+            print("%c%c\n", ((edge.state >> c) & 1U) ? '1' : '0', static_cast<char>('!' + c));
+        }
+    }
+    return ok_;
+}
+
+bool VcdWriter::finish(uint64_t endTick)
+{
+    return ok_ && print("#%llu\n", static_cast<unsigned long long>(tickToNs(endTick)));
+}
+
+} // namespace hackos::logic
@@ -0,0 +1,234 @@
+/**
+ * @file gpio_sampler.cpp
+ * @brief Cycle-counter paced GPIO sampler (see gpio_sampler.h).
+ */
+
+#include "hardware/logic/gpio_sampler.h"
+
+#include <Arduino.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <new>
+#include <soc/gpio_reg.h>
+
+static constexpr const char *TAG_GS = "GpioSampler";
+
+namespace hackos::logic {
+
+namespace {
+
+constexpr uint32_t SAMPLER_STACK    = 3072U;
+constexpr UBaseType_t SAMPLER_PRIO  = 10U;
+constexpr BaseType_t SAMPLER_CORE   = 0;
+constexpr uint8_t  GPIO_MAX_PIN     = 39U;
+constexpr uint32_t STOP_TIMEOUT_MS  = 100U;
+
+} // namespace
+
+GpioSampler &GpioSampler::instance()
+{
+    static GpioSampler sampler;
+    return sampler;
+}
+
+GpioSampler::GpioSampler()
+    : ring_(),
+      encoder_(ring_),
+      ringBuf_(nullptr),
+      pins_{},
+      channels_(0U),
+      mask0_(0U),
+      mask1_(0U),
+      rateHz_(DEFAULT_RATE_HZ),
+      running_(false),
+      taskDone_(true),
+      achievedHz_(0U),
+      samples_(0U),
+      blindTicks_(0U),
+      startMs_(0U),
+      stopMs_(0U)
+{
+}
+
+bool GpioSampler::start(const uint8_t *pins, size_t count, uint32_t rateHz)
+{
+    if (running_ || !taskDone_ || count == 0U || count > LOGIC_MAX_CHANNELS ||
+        rateHz == 0U)
+    {
+        return false;
+    }
+
+    mask0_ = 0U;
+    mask1_ = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (pins[i] > GPIO_MAX_PIN)
+        {
+            return false;
+        }
+        pins_[i] = pins[i];
+        if (pins[i] < 32U)
+        {
+            mask0_ |= 1UL << pins[i];
+        }
+        else
+        {
+            mask1_ |= 1UL << (pins[i] - 32U);
+        }
+        pinMode(pins[i], INPUT);
+    }
+    channels_ = count;
+    rateHz_ = rateHz;
+
+    if (ringBuf_ == nullptr)
+    {
+        ringBuf_ = new (std::nothrow) uint8_t[RING_BYTES];
+    }
+    if (ringBuf_ == nullptr || !ring_.attach(ringBuf_, RING_BYTES))
+    {
+        ESP_LOGE(TAG_GS, "OOM allocating %u B ring", static_cast<unsigned>(RING_BYTES));
+        return false;
+    }
+
+    achievedHz_ = 0U;
+    samples_ = 0U;
+    blindTicks_ = 0U;
+    startMs_ = static_cast<uint32_t>(millis());
+    stopMs_ = 0U;
+    running_ = true;
+    taskDone_ = false;
+    if (xTaskCreatePinnedToCore(taskEntry, "logic_smp", SAMPLER_STACK, this, SAMPLER_PRIO,
+                                nullptr, SAMPLER_CORE) != pdPASS)
+    {
+        running_ = false;
+        taskDone_ = true;
+        ESP_LOGE(TAG_GS, "task create failed");
+        return false;
+    }
+
+    ESP_LOGI(TAG_GS, "sampling %u ch @ %lu Hz", static_cast<unsigned>(count),
+             static_cast<unsigned long>(rateHz));
+    return true;
+}
+
+void GpioSampler::stop()
+{
+    if (!running_)
+    {
+        return;
+    }
+    running_ = false;
+    for (uint32_t waited = 0U; !taskDone_ && waited < STOP_TIMEOUT_MS; ++waited)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1U));
+    }
+    stopMs_ = static_cast<uint32_t>(millis());
+
+    SamplerStats st;
+    stats(&st);
+    ESP_LOGI(TAG_GS, "stopped: %llu samples @ %lu Hz (req %lu), %lu edges in %lu B, "
+             "peak %u B, %lu dropped",
+             static_cast<unsigned long long>(st.samples),
+             static_cast<unsigned long>(st.achievedHz),
+             static_cast<unsigned long>(st.rateHz),
+             static_cast<unsigned long>(st.log.records),
+             static_cast<unsigned long>(st.log.bytes),
+             static_cast<unsigned>(st.log.highWater),
+             static_cast<unsigned long>(st.log.dropped));
+
+    if (taskDone_)
+    {
+        delete[] ringBuf_;
+        ringBuf_ = nullptr;
+    }
+}
+
+void GpioSampler::stats(SamplerStats *out) const
+{
+    out->rateHz = rateHz_;
+    out->achievedHz = achievedHz_;
+    out->samples = samples_;
+    out->blindTicks = blindTicks_;
+    out->elapsedMs = (running_ ? static_cast<uint32_t>(millis()) : stopMs_) - startMs_;
+    out->log = encoder_.stats();
+    out->ringBytes = RING_BYTES;
+}
+
+void GpioSampler::taskEntry(void *arg)
+{
+    auto *self = static_cast<GpioSampler *>(arg);
+    self->run();
+    self->taskDone_ = true;
+    vTaskDelete(nullptr);
+}
+
+uint8_t GpioSampler::pack(uint32_t in, uint32_t in1) const
+{
+    uint8_t state = 0U;
+    for (size_t c = 0U; c < channels_; ++c)
+    {
+        const uint8_t pin = pins_[c];
+        const uint32_t level = (pin < 32U) ? (in >> pin) : (in1 >> (pin - 32U));
+        state = static_cast<uint8_t>(state | ((level & 1U) << c));
+    }
+    return state;
+}
+
+void GpioSampler::run()
+{
+    const uint32_t cpuHz = getCpuFrequencyMhz() * 1000000UL;
+    const uint32_t cyclesPerSample = (cpuHz / rateHz_ > 0U) ? cpuHz / rateHz_ : 1U;
+    const uint32_t windowCycles = cpuHz / 1000U * SAMPLE_WINDOW_MS;
+
+    uint32_t in = REG_READ(GPIO_IN_REG) & mask0_;
+    uint32_t in1 = REG_READ(GPIO_IN1_REG) & mask1_;
+    encoder_.begin(pack(in, in1), 0U);
+
+    uint32_t tick = 0U;
+    uint64_t taken = 0U;
+    uint64_t busyCycles = 0U;
+    uint32_t slot = ESP.getCycleCount();
+    while (running_)
+    {
+        // ── One window: only register reads and compares per slot ──────
+        const uint32_t windowStart = ESP.getCycleCount();
+        const uint32_t windowEnd = slot + windowCycles;
+        uint32_t n = 0U;
+        while (static_cast<int32_t>(slot - windowEnd) < 0)
+        {
+            while (static_cast<int32_t>(ESP.getCycleCount() - slot) < 0)
+            {
+            }
+            const uint32_t nin = REG_READ(GPIO_IN_REG) & mask0_;
+            const uint32_t nin1 = REG_READ(GPIO_IN1_REG) & mask1_;
+            if (nin != in || nin1 != in1)
+            {
+                in = nin;
+                in1 = nin1;
+                encoder_.edge(tick, pack(in, in1));
+            }
+            ++tick;
+            ++n;
+            slot += cyclesPerSample;
+        }
+        busyCycles += ESP.getCycleCount() - windowStart;
+        taken += n;
+        samples_ = taken;
+        achievedHz_ = static_cast<uint32_t>((taken * cpuHz) / busyCycles);
+        encoder_.keepAlive(tick);
+
+        vTaskDelay(1);
+
+        // Resynchronise: slots that passed while yielding (or while the
+        // loop ran behind) are skipped, keeping ticks on the real timebase.
+        const int32_t behind = static_cast<int32_t>(ESP.getCycleCount() - slot);
+        const uint32_t skipped = (behind > 0) ? static_cast<uint32_t>(behind) / cyclesPerSample
+                                              : 0U;
+        tick += skipped;
+        slot += skipped * cyclesPerSample;
+        blindTicks_ = blindTicks_ + skipped;
+    }
+}
+
+} // namespace hackos::logic
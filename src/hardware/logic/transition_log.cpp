@@ -0,0 +1,171 @@
+/**
+ * @file transition_log.cpp
+ * @brief Run-length transition log (see transition_log.h).
+ */
+
+#include "hardware/logic/transition_log.h"
+
+namespace hackos::logic {
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── TransitionRing ──────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+TransitionRing::TransitionRing()
+    : buf_(nullptr), cap_(0U), mask_(0U), head_(0U), tail_(0U)
+{
+}
+
+bool TransitionRing::attach(uint8_t *buf, size_t cap)
+{
+    if (buf == nullptr || cap < LOGIC_MAX_RECORD || (cap & (cap - 1U)) != 0U)
+    {
+        return false;
+    }
+    buf_ = buf;
+    cap_ = cap;
+    mask_ = cap - 1U;
+    reset();
+    return true;
+}
+
+void TransitionRing::reset()
+{
+    head_ = 0U;
+    tail_ = 0U;
+}
+
+size_t TransitionRing::push(uint32_t delta, uint8_t state)
+{
+    uint8_t rec[LOGIC_MAX_RECORD];
+    size_t len = 0U;
+    rec[len++] = state;
+    do
+    {
+        uint8_t b = static_cast<uint8_t>(delta & 0x7FU);
+        delta >>= 7;
+        if (delta != 0U)
+        {
+            b = static_cast<uint8_t>(b | 0x80U);
+        }
+        rec[len++] = b;
+    } while (delta != 0U);
+
+    const size_t head = head_;
+    if (cap_ - (head - tail_) < len)
+    {
+        return 0U;
+    }
+    for (size_t i = 0U; i < len; ++i)
+    {
+        buf_[(head + i) & mask_] = rec[i];
+    }
+    head_ = head + len; // publish after the bytes
+    return len;
+}
+
+bool TransitionRing::pop(uint32_t *delta, uint8_t *state)
+{
+    size_t tail = tail_;
+    if (tail == head_)
+    {
+        return false;
+    }
+    *state = buf_[tail++ & mask_];
+    uint32_t value = 0U;
+    for (uint8_t shift = 0U;; shift = static_cast<uint8_t>(shift + 7U))
+    {
+        const uint8_t b = buf_[tail++ & mask_];
+        value |= static_cast<uint32_t>(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0U)
+        {
+            break;
+        }
+    }
+    *delta = value;
+    tail_ = tail;
+    return true;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── TransitionEncoder ───────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+TransitionEncoder::TransitionEncoder(TransitionRing &ring)
+    : ring_(ring), last_(0U), lastTick_(0U), tick_(0U), stats_{}
+{
+}
+
+void TransitionEncoder::begin(uint8_t state, uint32_t tick)
+{
+    stats_ = {};
+    last_ = state;
+    lastTick_ = tick;
+    tick_ = tick;
+    store(tick, state);
+}
+
+void TransitionEncoder::feed(const uint8_t *states, size_t count)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (states[i] != last_)
+        {
+            store(tick_ + static_cast<uint32_t>(i), states[i]);
+        }
+    }
+    tick_ += static_cast<uint32_t>(count);
+    keepAlive(tick_);
+}
+
+void TransitionEncoder::store(uint32_t tick, uint8_t state)
+{
+    last_ = state;
+    const size_t len = ring_.push(tick - lastTick_, state);
+    if (len == 0U)
+    {
+        ++stats_.dropped; // lastTick_ stays: the next delta spans the gap
+        return;
+    }
+    lastTick_ = tick;
+    ++stats_.records;
+    stats_.bytes += static_cast<uint32_t>(len);
+    const size_t used = ring_.used();
+    if (used > stats_.highWater)
+    {
+        stats_.highWater = used;
+    }
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── TransitionReader ────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+TransitionReader::TransitionReader(TransitionRing &ring)
+    : ring_(ring), tick_(0U), state_(0U)
+{
+}
+
+void TransitionReader::reset()
+{
+    tick_ = 0U;
+    state_ = 0U;
+}
+
+bool TransitionReader::next(LogicEdge *edge)
+{
+    uint32_t delta = 0U;
+    uint8_t state = 0U;
+    if (!ring_.pop(&delta, &state))
+    {
+        return false;
+    }
+    tick_ += delta;
+    edge->tick = tick_;
+    edge->state = state;
+    edge->changed = static_cast<uint8_t>(state ^ state_);
+    state_ = state;
+    return true;
+}
+
+} // namespace hackos::logic
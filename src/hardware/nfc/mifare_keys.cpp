@@ -0,0 +1,469 @@
+/**
+ * @file mifare_keys.cpp
+ * @brief Mifare Classic key dictionary (hit-ordered) and UID sector cache.
+ */
+
+#include "hardware/nfc/mifare_keys.h"
+
+#include <cstring>
+
+namespace hackos::nfc {
+
+namespace {
+
+int hexNibble(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MifareKeyDictionary
+// ═══════════════════════════════════════════════════════════════════════════
+
+MifareKeyDictionary::MifareKeyDictionary()
+    : entries_{},
+      count_(0U),
+      dirty_(false),
+      line_{},
+      lineLen_(0U),
+      lineOverflow_(false)
+{
+}
+
+void MifareKeyDictionary::clear()
+{
+    count_ = 0U;
+    dirty_ = false;
+    beginParse();
+}
+
+bool MifareKeyDictionary::add(const uint8_t *key)
+{
+    if (key == nullptr)
+    {
+        return false;
+    }
+    if (find(key) >= 0)
+    {
+        return true;
+    }
+    if (count_ >= MAX_KEYS)
+    {
+        return false;
+    }
+
+    std::memcpy(entries_[count_].key, key, MF_KEY_LEN);
+    entries_[count_].hits = 0U;
+    ++count_;
+    return true;
+}
+
+int MifareKeyDictionary::find(const uint8_t *key) const
+{
+    for (size_t i = 0U; i < count_; ++i)
+    {
+        if (std::memcmp(entries_[i].key, key, MF_KEY_LEN) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void MifareKeyDictionary::recordHit(const uint8_t *key)
+{
+    int idx = find(key);
+    if (idx < 0)
+    {
+        if (!add(key))
+        {
+            return;
+        }
+        idx = static_cast<int>(count_ - 1U);
+    }
+
+    MifareKeyEntry &e = entries_[idx];
+    if (e.hits < 0xFFFFU)
+    {
+        ++e.hits;
+    }
+    dirty_ = true;
+
+    // Bubble forward past keys with fewer hits (stable for ties).
+    size_t pos = static_cast<size_t>(idx);
+    while (pos > 0U && entries_[pos - 1U].hits < entries_[pos].hits)
+    {
+        const MifareKeyEntry tmp = entries_[pos - 1U];
+        entries_[pos - 1U] = entries_[pos];
+        entries_[pos] = tmp;
+        --pos;
+    }
+}
+
+// ── Text parsing ─────────────────────────────────────────────────────────────
+
+void MifareKeyDictionary::beginParse()
+{
+    lineLen_ = 0U;
+    lineOverflow_ = false;
+}
+
+size_t MifareKeyDictionary::feed(const char *data, size_t len)
+{
+    if (data == nullptr)
+    {
+        return 0U;
+    }
+
+    size_t added = 0U;
+    for (size_t i = 0U; i < len; ++i)
+    {
+        const char c = data[i];
+        if (c == '\n')
+        {
+            added += parseLine();
+            continue;
+        }
+        if (lineLen_ < LINE_MAX)
+        {
+            line_[lineLen_++] = c;
+        }
+        else
+        {
+            lineOverflow_ = true;
+        }
+    }
+    return added;
+}
+
+size_t MifareKeyDictionary::finishParse()
+{
+    return parseLine();
+}
+
+size_t MifareKeyDictionary::parseLine()
+{
+    const size_t len = lineLen_;
+    const bool overflow = lineOverflow_;
+    beginParse();
+    if (overflow)
+    {
+        return 0U;
+    }
+
+    size_t start = 0U;
+    size_t end = len;
+    while (start < end && isSpace(line_[start]))
+    {
+        ++start;
+    }
+    while (end > start && isSpace(line_[end - 1U]))
+    {
+        --end;
+    }
+    if (end - start != MF_KEY_LEN * 2U)
+    {
+        return 0U; // blank, comment or malformed
+    }
+
+    uint8_t key[MF_KEY_LEN];
+    for (size_t i = 0U; i < MF_KEY_LEN; ++i)
+    {
+        const int hi = hexNibble(line_[start + i * 2U]);
+        const int lo = hexNibble(line_[start + i * 2U + 1U]);
+        if (hi < 0 || lo < 0)
+        {
+            return 0U;
+        }
+        key[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+
+    const size_t before = count_;
+    (void)add(key);
+    return count_ - before;
+}
+
+// ── Hit counters ─────────────────────────────────────────────────────────────
+
+size_t MifareKeyDictionary::encodeStats(uint8_t *out, size_t cap) const
+{
+    if (out == nullptr)
+    {
+        return 0U;
+    }
+
+    size_t pos = 0U;
+    for (size_t i = 0U; i < count_; ++i)
+    {
+        const MifareKeyEntry &e = entries_[i];
+        if (e.hits == 0U)
+        {
+            break; // sorted: the rest have no hits either
+        }
+        if (pos + STATS_RECORD_SIZE > cap)
+        {
+            break;
+        }
+        std::memcpy(out + pos, e.key, MF_KEY_LEN);
+        out[pos + MF_KEY_LEN] = static_cast<uint8_t>(e.hits & 0xFFU);
+        out[pos + MF_KEY_LEN + 1U] = static_cast<uint8_t>(e.hits >> 8U);
+        pos += STATS_RECORD_SIZE;
+    }
+    return pos;
+}
+
+size_t MifareKeyDictionary::applyStats(const uint8_t *in, size_t len)
+{
+    if (in == nullptr)
+    {
+        return 0U;
+    }
+
+    size_t applied = 0U;
+    for (size_t pos = 0U; pos + STATS_RECORD_SIZE <= len; pos += STATS_RECORD_SIZE)
+    {
+        const uint8_t *key = in + pos;
+        int idx = find(key);
+        if (idx < 0)
+        {
+            if (!add(key))
+            {
+                continue;
+            }
+            idx = static_cast<int>(count_ - 1U);
+        }
+        entries_[idx].hits = static_cast<uint16_t>(
+            in[pos + MF_KEY_LEN] | (in[pos + MF_KEY_LEN + 1U] << 8U));
+        ++applied;
+    }
+
+    sortByHits();
+    return applied;
+}
+
+void MifareKeyDictionary::sortByHits()
+{
+    // Insertion sort: stable, and the input is nearly sorted already.
+    for (size_t i = 1U; i < count_; ++i)
+    {
+        const MifareKeyEntry e = entries_[i];
+        size_t j = i;
+        while (j > 0U && entries_[j - 1U].hits < e.hits)
+        {
+            entries_[j] = entries_[j - 1U];
+            --j;
+        }
+        entries_[j] = e;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MifareUidCache
+// ═══════════════════════════════════════════════════════════════════════════
+
+MifareUidCache::MifareUidCache()
+    : entries_{},
+      count_(0U),
+      dirty_(false)
+{
+}
+
+void MifareUidCache::clear()
+{
+    count_ = 0U;
+    dirty_ = false;
+}
+
+int MifareUidCache::findEntry(const uint8_t *uid, uint8_t uidLen) const
+{
+    if (uid == nullptr || uidLen == 0U || uidLen > MF_MAX_UID_LEN)
+    {
+        return -1;
+    }
+    for (size_t i = 0U; i < count_; ++i)
+    {
+        if (entries_[i].uidLen == uidLen &&
+            std::memcmp(entries_[i].uid, uid, uidLen) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+size_t MifareUidCache::touch(size_t index)
+{
+    if (index > 0U)
+    {
+        const Entry e = entries_[index];
+        std::memmove(&entries_[1], &entries_[0], index * sizeof(Entry));
+        entries_[0] = e;
+    }
+    return 0U;
+}
+
+bool MifareUidCache::lookup(const uint8_t *uid, uint8_t uidLen, uint8_t sector,
+                            uint8_t *keyOut)
+{
+    if (sector >= MF_SECTORS_1K || keyOut == nullptr)
+    {
+        return false;
+    }
+    const int idx = findEntry(uid, uidLen);
+    if (idx < 0 || (entries_[idx].knownMask & (1U << sector)) == 0U)
+    {
+        return false;
+    }
+
+    // Recency only matters for eviction; not worth a rewrite of the file.
+    const size_t i = touch(static_cast<size_t>(idx));
+    std::memcpy(keyOut, entries_[i].keys[sector], MF_KEY_LEN);
+    return true;
+}
+
+void MifareUidCache::store(const uint8_t *uid, uint8_t uidLen, uint8_t sector,
+                           const uint8_t *key)
+{
+    if (sector >= MF_SECTORS_1K || key == nullptr ||
+        uid == nullptr || uidLen == 0U || uidLen > MF_MAX_UID_LEN)
+    {
+        return;
+    }
+
+    const int idx = findEntry(uid, uidLen);
+    size_t i = 0U;
+    if (idx >= 0)
+    {
+        i = touch(static_cast<size_t>(idx));
+        Entry &e = entries_[i];
+        if ((e.knownMask & (1U << sector)) != 0U &&
+            std::memcmp(e.keys[sector], key, MF_KEY_LEN) == 0)
+        {
+            return; // unchanged
+        }
+    }
+    else
+    {
+        // New card: evict the least recently used one when full.
+        if (count_ < MAX_UIDS)
+        {
+            ++count_;
+        }
+        std::memmove(&entries_[1], &entries_[0], (count_ - 1U) * sizeof(Entry));
+        Entry &e = entries_[0];
+        std::memset(&e, 0, sizeof(e));
+        std::memcpy(e.uid, uid, uidLen);
+        e.uidLen = uidLen;
+    }
+
+    Entry &e = entries_[i];
+    std::memcpy(e.keys[sector], key, MF_KEY_LEN);
+    e.knownMask = static_cast<uint16_t>(e.knownMask | (1U << sector));
+    dirty_ = true;
+}
+
+void MifareUidCache::forget(const uint8_t *uid, uint8_t uidLen, uint8_t sector)
+{
+    if (sector >= MF_SECTORS_1K)
+    {
+        return;
+    }
+    const int idx = findEntry(uid, uidLen);
+    if (idx < 0 || (entries_[idx].knownMask & (1U << sector)) == 0U)
+    {
+        return;
+    }
+    entries_[idx].knownMask =
+        static_cast<uint16_t>(entries_[idx].knownMask & ~(1U << sector));
+    dirty_ = true;
+}
+
+uint8_t MifareUidCache::knownSectors(const uint8_t *uid, uint8_t uidLen) const
+{
+    const int idx = findEntry(uid, uidLen);
+    if (idx < 0)
+    {
+        return 0U;
+    }
+    uint8_t n = 0U;
+    for (uint16_t m = entries_[idx].knownMask; m != 0U; m &= static_cast<uint16_t>(m - 1U))
+    {
+        ++n;
+    }
+    return n;
+}
+
+// ── Persistence ──────────────────────────────────────────────────────────────
+
+size_t MifareUidCache::encode(uint8_t *out, size_t cap) const
+{
+    if (out == nullptr)
+    {
+        return 0U;
+    }
+
+    size_t pos = 0U;
+    for (size_t i = 0U; i < count_ && pos + RECORD_SIZE <= cap; ++i)
+    {
+        const Entry &e = entries_[i];
+        uint8_t *p = out + pos;
+        std::memcpy(p, e.uid, MF_MAX_UID_LEN);
+        p[MF_MAX_UID_LEN] = e.uidLen;
+        p[MF_MAX_UID_LEN + 1U] = static_cast<uint8_t>(e.knownMask & 0xFFU);
+        p[MF_MAX_UID_LEN + 2U] = static_cast<uint8_t>(e.knownMask >> 8U);
+        std::memcpy(p + MF_MAX_UID_LEN + 3U, e.keys, sizeof(e.keys));
+        pos += RECORD_SIZE;
+    }
+    return pos;
+}
+
+size_t MifareUidCache::decode(const uint8_t *in, size_t len)
+{
+    clear();
+    if (in == nullptr)
+    {
+        return 0U;
+    }
+
+    for (size_t pos = 0U; pos + RECORD_SIZE <= len && count_ < MAX_UIDS;
+         pos += RECORD_SIZE)
+    {
+        const uint8_t *p = in + pos;
+        const uint8_t uidLen = p[MF_MAX_UID_LEN];
+        if (uidLen == 0U || uidLen > MF_MAX_UID_LEN ||
+            findEntry(p, uidLen) >= 0)
+        {
+            continue;
+        }
+
+        Entry &e = entries_[count_];
+        std::memcpy(e.uid, p, MF_MAX_UID_LEN);
+        e.uidLen = uidLen;
+        e.knownMask = static_cast<uint16_t>(
+            p[MF_MAX_UID_LEN + 1U] | (p[MF_MAX_UID_LEN + 2U] << 8U));
+        std::memcpy(e.keys, p + MF_MAX_UID_LEN + 3U, sizeof(e.keys));
+        ++count_;
+    }
+    return count_;
+}
+
+} // namespace hackos::nfc
@@ -0,0 +1,694 @@
+/**
+ * @file nfc_dump.cpp
+ * @brief Streaming .bin ↔ Flipper .nfc conversion, dump diff and hex pager.
+ */
+
+#include "hardware/nfc/nfc_dump.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace hackos::nfc {
+
+namespace {
+
+static constexpr const char *NFC_FILETYPE = "Flipper NFC device";
+static constexpr const char *TYPE_MIFARE_CLASSIC = "Mifare Classic";
+static constexpr const char *TYPE_NTAG = "NTAG/Ultralight";
+
+int hexNibble(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/// @brief Parse up to @p max space-separated hex bytes.
+/// @return Bytes parsed; stops at the first malformed token.
+size_t parseHexBytes(const char *s, uint8_t *out, size_t max)
+{
+    size_t n = 0U;
+    while (n < max)
+    {
+        while (*s == ' ')
+        {
+            ++s;
+        }
+        const int hi = hexNibble(s[0]);
+        const int lo = (hi >= 0) ? hexNibble(s[1]) : -1;
+        if (hi < 0 || lo < 0)
+        {
+            break;
+        }
+        out[n++] = static_cast<uint8_t>((hi << 4) | lo);
+        s += 2;
+    }
+    return n;
+}
+
+/// @brief If @p line starts with @p key, return the text after it.
+const char *afterKey(const char *line, const char *key)
+{
+    const size_t n = std::strlen(key);
+    return (std::strncmp(line, key, n) == 0) ? line + n : nullptr;
+}
+
+/// @brief GET_VERSION storage-size byte for an NTAG21x with @p pages.
+uint8_t ntagStorageByte(uint16_t pages)
+{
+    if (pages >= 231U)
+    {
+        return 0x13U; // NTAG216
+    }
+    if (pages >= 135U)
+    {
+        return 0x11U; // NTAG215
+    }
+    return 0x0FU;     // NTAG213
+}
+
+const char *ntagTypeName(uint16_t pages)
+{
+    if (pages >= 231U)
+    {
+        return "NTAG216";
+    }
+    if (pages >= 135U)
+    {
+        return "NTAG215";
+    }
+    return "NTAG213";
+}
+
+} // namespace
+
+bool mifareDecodeValue(const uint8_t *block, int32_t *value, uint8_t *addr)
+{
+    if (block == nullptr)
+    {
+        return false;
+    }
+
+    uint32_t v[3];
+    for (size_t i = 0U; i < 3U; ++i)
+    {
+        const uint8_t *p = block + i * 4U;
+        v[i] = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8U) |
+               (static_cast<uint32_t>(p[2]) << 16U) | (static_cast<uint32_t>(p[3]) << 24U);
+    }
+    if (v[0] != v[2] || v[0] != ~v[1])
+    {
+        return false;
+    }
+    if (block[12] != block[14] || block[13] != block[15] ||
+        block[12] != static_cast<uint8_t>(~block[13]))
+    {
+        return false;
+    }
+
+    if (value != nullptr)
+    {
+        *value = static_cast<int32_t>(v[0]);
+    }
+    if (addr != nullptr)
+    {
+        *addr = block[12];
+    }
+    return true;
+}
+
+size_t NfcMemorySource::readAt(uint32_t offset, uint8_t *buf, size_t len)
+{
+    if (buf == nullptr || data_ == nullptr || offset >= len_)
+    {
+        return 0U;
+    }
+    const size_t n = (len < len_ - offset) ? len : (len_ - offset);
+    std::memcpy(buf, data_ + offset, n);
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NfcBinToFlipper
+// ═══════════════════════════════════════════════════════════════════════════
+
+NfcBinToFlipper::NfcBinToFlipper(NfcByteSink &out)
+    : out_(out),
+      kind_(NfcDumpKind::MIFARE_CLASSIC_1K),
+      partial_{},
+      partialLen_(0U),
+      unit_(0U),
+      ok_(true)
+{
+}
+
+bool NfcBinToFlipper::writeText(const char *text)
+{
+    if (ok_)
+    {
+        ok_ = out_.write(reinterpret_cast<const uint8_t *>(text), std::strlen(text));
+    }
+    return ok_;
+}
+
+bool NfcBinToFlipper::begin(const NfcDumpInfo &info)
+{
+    kind_ = info.kind;
+    partialLen_ = 0U;
+    unit_ = 0U;
+    ok_ = true;
+
+    const bool ntag = (kind_ == NfcDumpKind::NTAG);
+    char line[128];
+
+    (void)writeText("Filetype: ");
+    (void)writeText(NFC_FILETYPE);
+    (void)writeText("\nVersion: 4\n"
+                    "# Device type can be ISO14443-3A, ISO14443-3B, ISO14443-4A, "
+                    "NTAG/Ultralight, Mifare Classic, Mifare DESFire\n");
+    std::snprintf(line, sizeof(line), "Device type: %s\n# UID is common for all formats\nUID:",
+                  ntag ? TYPE_NTAG : TYPE_MIFARE_CLASSIC);
+    (void)writeText(line);
+    const uint8_t uidLen = (info.uidLen <= sizeof(info.uid)) ? info.uidLen : 0U;
+    for (uint8_t i = 0U; i < uidLen; ++i)
+    {
+        std::snprintf(line, sizeof(line), " %02X", info.uid[i]);
+        (void)writeText(line);
+    }
+    std::snprintf(line, sizeof(line),
+                  "\n# ISO14443-3A specific data\nATQA: %02X %02X\nSAK: %02X\n",
+                  info.atqa[0], info.atqa[1], info.sak);
+    (void)writeText(line);
+
+    if (ntag)
+    {
+        std::snprintf(line, sizeof(line),
+                      "# NTAG/Ultralight specific data\nData format version: 2\n"
+                      "NTAG/Ultralight type: %s\n",
+                      ntagTypeName(info.units));
+        (void)writeText(line);
+        (void)writeText("Signature: 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+                        "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00\n");
+        std::snprintf(line, sizeof(line), "Mifare version: 00 04 04 02 01 00 %02X 03\n",
+                      ntagStorageByte(info.units));
+        (void)writeText(line);
+        for (unsigned i = 0U; i < 3U; ++i)
+        {
+            std::snprintf(line, sizeof(line), "Counter %u: 0\nTearing %u: 00\n", i, i);
+            (void)writeText(line);
+        }
+        std::snprintf(line, sizeof(line), "Pages total: %u\nPages read: %u\n",
+                      static_cast<unsigned>(info.units),
+                      static_cast<unsigned>(info.units));
+        (void)writeText(line);
+    }
+    else
+    {
+        std::snprintf(line, sizeof(line),
+                      "# Mifare Classic specific data\nMifare Classic type: %s\n"
+                      "Data format version: 2\n",
+                      (kind_ == NfcDumpKind::MIFARE_CLASSIC_4K) ? "4K" : "1K");
+        (void)writeText(line);
+        // Split literal: "??'" would be a trigraph.
+        (void)writeText("# Mifare Classic blocks, '?" "?' means unknown data\n");
+    }
+    return ok_;
+}
+
+bool NfcBinToFlipper::emitUnit(const uint8_t *data, size_t have)
+{
+    const size_t unitSize = nfcUnitSize(kind_);
+    char line[8 + 12 + NFC_BLOCK_SIZE * 3U];
+    int pos = std::snprintf(line, sizeof(line), "%s %u:",
+                            (kind_ == NfcDumpKind::NTAG) ? "Page" : "Block",
+                            static_cast<unsigned>(unit_));
+    for (size_t i = 0U; i < unitSize; ++i)
+    {
+        if (i < have)
+        {
+            pos += std::snprintf(line + pos, sizeof(line) - pos, " %02X", data[i]);
+        }
+        else
+        {
+            pos += std::snprintf(line + pos, sizeof(line) - pos, " ??");
+        }
+    }
+    line[pos++] = '\n';
+    line[pos] = '\0';
+    ++unit_;
+    return writeText(line);
+}
+
+bool NfcBinToFlipper::feed(const uint8_t *data, size_t len)
+{
+    if (data == nullptr)
+    {
+        return ok_;
+    }
+
+    const size_t unitSize = nfcUnitSize(kind_);
+    size_t i = 0U;
+
+    // Complete a unit split across chunks.
+    if (partialLen_ > 0U)
+    {
+        const size_t take = (len < unitSize - partialLen_) ? len : (unitSize - partialLen_);
+        std::memcpy(partial_ + partialLen_, data, take);
+        partialLen_ += take;
+        i = take;
+        if (partialLen_ == unitSize)
+        {
+            (void)emitUnit(partial_, unitSize);
+            partialLen_ = 0U;
+        }
+    }
+
+    for (; i + unitSize <= len && ok_; i += unitSize)
+    {
+        (void)emitUnit(data + i, unitSize);
+    }
+
+    if (i < len)
+    {
+        std::memcpy(partial_, data + i, len - i);
+        partialLen_ = len - i;
+    }
+    return ok_;
+}
+
+bool NfcBinToFlipper::feedUnknown()
+{
+    if (partialLen_ > 0U)
+    {
+        (void)emitUnit(partial_, partialLen_);
+        partialLen_ = 0U;
+    }
+    return emitUnit(nullptr, 0U);
+}
+
+bool NfcBinToFlipper::finish()
+{
+    if (partialLen_ > 0U)
+    {
+        (void)emitUnit(partial_, partialLen_);
+        partialLen_ = 0U;
+    }
+    return ok_;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NfcFlipperToBin
+// ═══════════════════════════════════════════════════════════════════════════
+
+NfcFlipperToBin::NfcFlipperToBin(NfcByteSink &out)
+    : out_(out),
+      info_{},
+      line_{},
+      lineLen_(0U),
+      lineOverflow_(false),
+      next_(0U),
+      unknown_(0U),
+      sawHeader_(false),
+      ok_(true)
+{
+}
+
+void NfcFlipperToBin::begin()
+{
+    info_ = {};
+    lineLen_ = 0U;
+    lineOverflow_ = false;
+    next_ = 0U;
+    unknown_ = 0U;
+    sawHeader_ = false;
+    ok_ = true;
+}
+
+bool NfcFlipperToBin::feed(const char *text, size_t len)
+{
+    if (text == nullptr)
+    {
+        return ok_;
+    }
+
+    for (size_t i = 0U; i < len && ok_; ++i)
+    {
+        const char c = text[i];
+        if (c == '\n')
+        {
+            (void)parseLine();
+        }
+        else if (c != '\r')
+        {
+            if (lineLen_ + 1U < LINE_MAX)
+            {
+                line_[lineLen_++] = c;
+            }
+            else
+            {
+                lineOverflow_ = true;
+            }
+        }
+    }
+    return ok_;
+}
+
+bool NfcFlipperToBin::finish()
+{
+    if (lineLen_ > 0U)
+    {
+        (void)parseLine();
+    }
+    return ok_;
+}
+
+bool NfcFlipperToBin::parseLine()
+{
+    line_[lineLen_] = '\0';
+    const bool overflow = lineOverflow_;
+    lineLen_ = 0U;
+    lineOverflow_ = false;
+    if (overflow || line_[0] == '#' || line_[0] == '\0')
+    {
+        return ok_;
+    }
+
+    const char *v = nullptr;
+    if ((v = afterKey(line_, "Device type: ")) != nullptr)
+    {
+        sawHeader_ = true;
+        info_.kind = (std::strcmp(v, TYPE_NTAG) == 0) ? NfcDumpKind::NTAG
+                                                      : NfcDumpKind::MIFARE_CLASSIC_1K;
+    }
+    else if ((v = afterKey(line_, "Mifare Classic type: ")) != nullptr)
+    {
+        info_.kind = (std::strcmp(v, "4K") == 0) ? NfcDumpKind::MIFARE_CLASSIC_4K
+                                                 : NfcDumpKind::MIFARE_CLASSIC_1K;
+    }
+    else if ((v = afterKey(line_, "UID:")) != nullptr)
+    {
+        info_.uidLen = static_cast<uint8_t>(parseHexBytes(v, info_.uid, sizeof(info_.uid)));
+    }
+    else if ((v = afterKey(line_, "ATQA:")) != nullptr)
+    {
+        (void)parseHexBytes(v, info_.atqa, sizeof(info_.atqa));
+    }
+    else if ((v = afterKey(line_, "SAK:")) != nullptr)
+    {
+        (void)parseHexBytes(v, &info_.sak, 1U);
+    }
+    else if ((v = afterKey(line_, "Pages total: ")) != nullptr)
+    {
+        info_.units = static_cast<uint16_t>(std::strtoul(v, nullptr, 10));
+    }
+    else if ((v = afterKey(line_, "Block ")) != nullptr ||
+             (v = afterKey(line_, "Page ")) != nullptr)
+    {
+        if (!sawHeader_)
+        {
+            info_.kind = (line_[0] == 'P') ? NfcDumpKind::NTAG
+                                           : NfcDumpKind::MIFARE_CLASSIC_1K;
+            sawHeader_ = true;
+        }
+        char *end = nullptr;
+        const unsigned long index = std::strtoul(v, &end, 10);
+        if (end != v && *end == ':' && index <= 0xFFFFUL)
+        {
+            (void)emitUnits(static_cast<uint16_t>(index), end + 1);
+        }
+    }
+    return ok_;
+}
+
+bool NfcFlipperToBin::emitUnits(uint16_t index, const char *hex)
+{
+    if (index < next_)
+    {
+        return ok_; // duplicate or out of order: keep the first
+    }
+
+    const size_t unitSize = nfcUnitSize(info_.kind);
+    uint8_t unit[NFC_BLOCK_SIZE] = {};
+
+    // Zero-fill units the file skipped.
+    while (next_ < index && ok_)
+    {
+        ok_ = out_.write(unit, unitSize);
+        ++next_;
+        ++unknown_;
+    }
+
+    bool unknown = false;
+    const char *s = hex;
+    for (size_t i = 0U; i < unitSize; ++i)
+    {
+        while (*s == ' ')
+        {
+            ++s;
+        }
+        const int hi = hexNibble(s[0]);
+        const int lo = (hi >= 0) ? hexNibble(s[1]) : -1;
+        if (hi >= 0 && lo >= 0)
+        {
+            unit[i] = static_cast<uint8_t>((hi << 4) | lo);
+            s += 2;
+        }
+        else
+        {
+            unknown = true; // "??" or truncated line
+            if (s[0] != '\0')
+            {
+                s += (s[1] != '\0') ? 2 : 1;
+            }
+        }
+    }
+
+    if (ok_)
+    {
+        ok_ = out_.write(unit, unitSize);
+    }
+    ++next_;
+    if (unknown)
+    {
+        ++unknown_;
+    }
+    return ok_;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NfcDumpDiff
+// ═══════════════════════════════════════════════════════════════════════════
+
+NfcDumpDiff::NfcDumpDiff()
+    : kind_(NfcDumpKind::MIFARE_CLASSIC_1K),
+      unitSize_(NFC_BLOCK_SIZE),
+      partialA_{},
+      partialB_{},
+      partialLen_(0U),
+      units_(0U),
+      changed_(0U),
+      valueDeltas_(0U),
+      trailers_(0U),
+      bitmap_{},
+      deltas_{},
+      deltaCount_(0U)
+{
+}
+
+void NfcDumpDiff::begin(NfcDumpKind kind)
+{
+    kind_ = kind;
+    unitSize_ = nfcUnitSize(kind);
+    partialLen_ = 0U;
+    units_ = 0U;
+    changed_ = 0U;
+    valueDeltas_ = 0U;
+    trailers_ = 0U;
+    std::memset(bitmap_, 0, sizeof(bitmap_));
+    deltaCount_ = 0U;
+}
+
+void NfcDumpDiff::feed(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    if (a == nullptr || b == nullptr)
+    {
+        return;
+    }
+
+    size_t i = 0U;
+    if (partialLen_ > 0U)
+    {
+        const size_t take = (len < unitSize_ - partialLen_) ? len : (unitSize_ - partialLen_);
+        std::memcpy(partialA_ + partialLen_, a, take);
+        std::memcpy(partialB_ + partialLen_, b, take);
+        partialLen_ += take;
+        i = take;
+        if (partialLen_ == unitSize_)
+        {
+            compareUnit(units_, partialA_, partialB_);
+            partialLen_ = 0U;
+        }
+    }
+
+    for (; i + unitSize_ <= len; i += unitSize_)
+    {
+        compareUnit(units_, a + i, b + i);
+    }
+
+    if (i < len)
+    {
+        std::memcpy(partialA_, a + i, len - i);
+        std::memcpy(partialB_, b + i, len - i);
+        partialLen_ = len - i;
+    }
+}
+
+void NfcDumpDiff::compareUnit(uint16_t unit, const uint8_t *a, const uint8_t *b)
+{
+    if (unit >= units_)
+    {
+        units_ = static_cast<uint16_t>(unit + 1U);
+    }
+
+    uint16_t mask = 0U;
+    for (size_t i = 0U; i < unitSize_; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            mask = static_cast<uint16_t>(mask | (1U << i));
+        }
+    }
+    if (mask == 0U)
+    {
+        return;
+    }
+
+    NfcBlockDelta d = {};
+    d.unit = unit;
+    d.byteMask = mask;
+    if (kind_ != NfcDumpKind::NTAG)
+    {
+        d.trailer = mifareIsTrailer(unit);
+        d.value = !d.trailer && unit != 0U &&
+                  mifareDecodeValue(a, &d.before, nullptr) &&
+                  mifareDecodeValue(b, &d.after, nullptr);
+    }
+
+    ++changed_;
+    if (d.trailer)
+    {
+        ++trailers_;
+    }
+    if (d.value)
+    {
+        ++valueDeltas_;
+    }
+    if (unit < MAX_UNITS)
+    {
+        bitmap_[unit / 8U] = static_cast<uint8_t>(bitmap_[unit / 8U] | (1U << (unit % 8U)));
+    }
+    keep(d);
+}
+
+void NfcDumpDiff::keep(const NfcBlockDelta &d)
+{
+    if (deltaCount_ < MAX_DELTAS)
+    {
+        deltas_[deltaCount_++] = d;
+        return;
+    }
+    if (!d.value)
+    {
+        return;
+    }
+    // Full: a value delta displaces the newest plain change.
+    for (size_t i = MAX_DELTAS; i > 0U; --i)
+    {
+        if (!deltas_[i - 1U].value)
+        {
+            deltas_[i - 1U] = d;
+            return;
+        }
+    }
+}
+
+bool NfcDumpDiff::isChanged(uint16_t unit) const
+{
+    return unit < MAX_UNITS && (bitmap_[unit / 8U] & (1U << (unit % 8U))) != 0U;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NfcHexPager
+// ═══════════════════════════════════════════════════════════════════════════
+
+NfcHexPager::NfcHexPager()
+    : source_(nullptr),
+      window_{},
+      firstRow_(0U),
+      windowLen_(0U),
+      valid_(false),
+      loads_(0U)
+{
+}
+
+void NfcHexPager::attach(NfcPageSource *source)
+{
+    source_ = source;
+    valid_ = false;
+    windowLen_ = 0U;
+    firstRow_ = 0U;
+    loads_ = 0U;
+}
+
+uint32_t NfcHexPager::rowCount() const
+{
+    if (source_ == nullptr)
+    {
+        return 0U;
+    }
+    return (source_->size() + ROW_BYTES - 1U) / ROW_BYTES;
+}
+
+const uint8_t *NfcHexPager::row(uint32_t index, size_t *len)
+{
+    if (source_ == nullptr || index >= rowCount())
+    {
+        return nullptr;
+    }
+
+    const bool hit = valid_ && index >= firstRow_ &&
+                     (index - firstRow_) * ROW_BYTES < windowLen_;
+    if (!hit)
+    {
+        // Centre the window so scrolling either way stays cached.
+        firstRow_ = (index > WINDOW_ROWS / 2U) ? index - WINDOW_ROWS / 2U : 0U;
+        windowLen_ = source_->readAt(firstRow_ * ROW_BYTES, window_, sizeof(window_));
+        valid_ = windowLen_ > 0U;
+        ++loads_;
+        if ((index - firstRow_) * ROW_BYTES >= windowLen_)
+        {
+            valid_ = false;
+            return nullptr;
+        }
+    }
+
+    const size_t off = (index - firstRow_) * ROW_BYTES;
+    if (len != nullptr)
+    {
+        *len = (windowLen_ - off < ROW_BYTES) ? (windowLen_ - off) : ROW_BYTES;
+    }
+    return window_ + off;
+}
+
+} // namespace hackos::nfc
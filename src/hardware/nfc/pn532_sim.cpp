@@ -0,0 +1,550 @@
+/**
+ * @file pn532_sim.cpp
+ * @brief Host-side PN532 simulator (see pn532_sim.h).
+ */
+
+#include "hardware/nfc/pn532_sim.h"
+
+#include <cstring>
+
+#include "hardware/nfc/mifare_keys.h"
+
+namespace hackos::nfc {
+
+namespace {
+
+constexpr uint32_t SIM_FIRMWARE = 0x32010607UL; ///< PN532 v1.6, ISO A/B + Felica
+
+constexpr uint8_t CMD_MF_AUTH_A      = 0x60U;
+constexpr uint8_t CMD_MF_AUTH_B      = 0x61U;
+constexpr uint8_t CMD_READ           = 0x30U;
+constexpr uint8_t CMD_MF_WRITE       = 0xA0U;
+constexpr uint8_t CMD_NTAG_VERSION   = 0x60U;
+constexpr uint8_t CMD_NTAG_FAST_READ = 0x3AU;
+constexpr uint8_t CMD_NTAG_WRITE     = 0xA2U;
+constexpr uint8_t CMD_NTAG_PWD_AUTH  = 0x1BU;
+
+constexpr size_t MF_1K_BYTES = 1024U;
+constexpr size_t MF_BLOCK    = 16U;
+constexpr size_t PAGE        = 4U;
+
+/// Trailer of a factory-blank sector: key A, access bits, key B.
+constexpr uint8_t BLANK_TRAILER[MF_BLOCK] = {
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0xFFU, 0x07U, 0x80U, 0x69U,
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+};
+
+uint16_t pagesOf(SimTagType type)
+{
+    switch (type)
+    {
+    case SimTagType::NTAG213:    return 45U;
+    case SimTagType::NTAG215:    return 135U;
+    case SimTagType::NTAG216:    return 231U;
+    case SimTagType::ULTRALIGHT: return 16U;
+    default:                     return 0U;
+    }
+}
+
+/// GET_VERSION storage-size byte.
+uint8_t versionSizeOf(SimTagType type)
+{
+    switch (type)
+    {
+    case SimTagType::NTAG213: return 0x0FU;
+    case SimTagType::NTAG215: return 0x11U;
+    default:                  return 0x13U;
+    }
+}
+
+/// Capability-container data-area size byte.
+uint8_t ccSizeOf(SimTagType type)
+{
+    switch (type)
+    {
+    case SimTagType::NTAG213: return 0x12U;
+    case SimTagType::NTAG215: return 0x3EU;
+    case SimTagType::NTAG216: return 0x6DU;
+    default:                  return 0x06U;
+    }
+}
+
+} // namespace
+
+Pn532Simulator::Pn532Simulator(const Pn532SimTiming &timing)
+    : timing_(timing),
+      stats_{},
+      clockUs_(0U),
+      present_(false),
+      magic_(false),
+      type_(SimTagType::MIFARE_CLASSIC_1K),
+      uid_{},
+      uidLen_(0U),
+      mem_{},
+      memSize_(0U),
+      state_(CardState::IDLE),
+      authSector_(0U),
+      dropCount_(0U),
+      pool_{},
+      poolUsed_(0U),
+      cmds_{},
+      cmdCount_(0U),
+      cmdNext_(0U),
+      resps_{},
+      respCount_(0U)
+{
+}
+
+// ── Virtual tags ─────────────────────────────────────────────────────────────
+
+bool Pn532Simulator::loadMifare1k(const uint8_t *uid, uint8_t uidLen, bool magic)
+{
+    if (uid == nullptr || (uidLen != 4U && uidLen != 7U))
+    {
+        return false;
+    }
+
+    std::memset(mem_, 0, MF_1K_BYTES);
+    std::memcpy(mem_, uid, uidLen);
+    if (uidLen == 4U)
+    {
+        mem_[4] = uid[0] ^ uid[1] ^ uid[2] ^ uid[3]; // BCC
+        mem_[5] = 0x08U;                             // SAK
+        mem_[6] = 0x04U;                             // ATQA
+        mem_[7] = 0x00U;
+    }
+    for (size_t s = 0U; s < MF_SECTORS_1K; ++s)
+    {
+        std::memcpy(mem_ + (s * 4U + 3U) * MF_BLOCK, BLANK_TRAILER, MF_BLOCK);
+    }
+
+    type_ = SimTagType::MIFARE_CLASSIC_1K;
+    std::memcpy(uid_, uid, uidLen);
+    uidLen_ = uidLen;
+    memSize_ = MF_1K_BYTES;
+    magic_ = magic;
+    present_ = true;
+    state_ = CardState::IDLE;
+    return true;
+}
+
+bool Pn532Simulator::loadMifare1kImage(const uint8_t *image, bool magic)
+{
+    if (image == nullptr)
+    {
+        return false;
+    }
+
+    type_ = SimTagType::MIFARE_CLASSIC_1K;
+    std::memcpy(mem_, image, MF_1K_BYTES);
+    std::memcpy(uid_, image, 4U);
+    uidLen_ = 4U;
+    memSize_ = MF_1K_BYTES;
+    magic_ = magic;
+    present_ = true;
+    state_ = CardState::IDLE;
+    return true;
+}
+
+bool Pn532Simulator::setSectorKeyA(uint8_t sector, const uint8_t *key)
+{
+    if (!present_ || !isMifare() || sector >= MF_SECTORS_1K || key == nullptr)
+    {
+        return false;
+    }
+    std::memcpy(mem_ + (static_cast<size_t>(sector) * 4U + 3U) * MF_BLOCK, key, MF_KEY_LEN);
+    return true;
+}
+
+bool Pn532Simulator::loadNtag(SimTagType type, const uint8_t *uid)
+{
+    const uint16_t pages = pagesOf(type);
+    if (uid == nullptr || pages == 0U)
+    {
+        return false;
+    }
+
+    std::memset(mem_, 0, static_cast<size_t>(pages) * PAGE);
+    mem_[0] = uid[0];
+    mem_[1] = uid[1];
+    mem_[2] = uid[2];
+    mem_[3] = 0x88U ^ uid[0] ^ uid[1] ^ uid[2];      // BCC0 (includes CT)
+    std::memcpy(mem_ + 4, uid + 3, 4U);
+    mem_[8] = uid[3] ^ uid[4] ^ uid[5] ^ uid[6];     // BCC1
+    mem_[9] = 0x48U;                                 // internal
+    mem_[12] = 0xE1U;                                // CC: NDEF magic
+    mem_[13] = 0x10U;                                //     version 1.0
+    mem_[14] = ccSizeOf(type);
+    if (type != SimTagType::ULTRALIGHT)
+    {
+        // CFG0 (AUTH0 = FF: no password protection), CFG1, PWD = FF…FF.
+        uint8_t *cfg = mem_ + static_cast<size_t>(pages - 4U) * PAGE;
+        cfg[0] = 0x04U;
+        cfg[3] = 0xFFU;
+        cfg[5] = 0x05U;
+        std::memset(cfg + 8, 0xFF, PAGE);
+    }
+
+    type_ = type;
+    std::memcpy(uid_, uid, 7U);
+    uidLen_ = 7U;
+    memSize_ = static_cast<size_t>(pages) * PAGE;
+    magic_ = false;
+    present_ = true;
+    state_ = CardState::IDLE;
+    return true;
+}
+
+bool Pn532Simulator::loadNtagImage(SimTagType type, const uint8_t *image)
+{
+    const uint16_t pages = pagesOf(type);
+    if (image == nullptr || pages == 0U)
+    {
+        return false;
+    }
+
+    type_ = type;
+    memSize_ = static_cast<size_t>(pages) * PAGE;
+    std::memcpy(mem_, image, memSize_);
+    std::memcpy(uid_, image, 3U);
+    std::memcpy(uid_ + 3, image + 4, 4U);
+    uidLen_ = 7U;
+    magic_ = false;
+    present_ = true;
+    state_ = CardState::IDLE;
+    return true;
+}
+
+void Pn532Simulator::removeTag()
+{
+    present_ = false;
+    state_ = CardState::IDLE;
+}
+
+uint16_t Pn532Simulator::ntagPages() const
+{
+    return pagesOf(type_);
+}
+
+// ── External reader (target mode) ────────────────────────────────────────────
+
+void Pn532Simulator::clearTargetScript()
+{
+    poolUsed_ = 0U;
+    cmdCount_ = 0U;
+    cmdNext_ = 0U;
+    respCount_ = 0U;
+}
+
+bool Pn532Simulator::storeFrame(Frame *frames, size_t *count, const uint8_t *data,
+                                uint8_t len)
+{
+    if (*count >= MAX_TARGET_FRAMES || poolUsed_ + len > TARGET_POOL_BYTES)
+    {
+        return false;
+    }
+    std::memcpy(pool_ + poolUsed_, data, len);
+    frames[*count] = {static_cast<uint16_t>(poolUsed_), len};
+    ++*count;
+    poolUsed_ += len;
+    return true;
+}
+
+bool Pn532Simulator::queueReaderCommand(const uint8_t *cmd, uint8_t len)
+{
+    if (cmd == nullptr || len == 0U || len > NFC_MAX_FRAME)
+    {
+        return false;
+    }
+    return storeFrame(cmds_, &cmdCount_, cmd, len);
+}
+
+const uint8_t *Pn532Simulator::targetResponse(size_t index, uint8_t *len) const
+{
+    if (index >= respCount_)
+    {
+        return nullptr;
+    }
+    if (len != nullptr)
+    {
+        *len = resps_[index].len;
+    }
+    return pool_ + resps_[index].offset;
+}
+
+// ── NfcTransport ─────────────────────────────────────────────────────────────
+
+void Pn532Simulator::charge(uint32_t us)
+{
+    ++stats_.commands;
+    stats_.busyUs += us;
+    clockUs_ += us;
+}
+
+void Pn532Simulator::begin()
+{
+    state_ = CardState::IDLE;
+}
+
+uint32_t Pn532Simulator::firmwareVersion()
+{
+    charge(timing_.frameUs);
+    return SIM_FIRMWARE;
+}
+
+bool Pn532Simulator::samConfig()
+{
+    charge(timing_.frameUs);
+    return true;
+}
+
+bool Pn532Simulator::inListPassiveTarget(uint8_t *uid, uint8_t *uidLen,
+                                         uint16_t timeoutMs)
+{
+    ++stats_.selects;
+    if (!present_ || uid == nullptr || uidLen == nullptr)
+    {
+        charge(timing_.frameUs +
+               ((timeoutMs != 0U) ? timeoutMs * 1000UL : timing_.timeoutUs));
+        return false;
+    }
+
+    charge(timing_.frameUs + timing_.selectUs + timing_.byteUs * uidLen_);
+    std::memcpy(uid, uid_, uidLen_);
+    *uidLen = uidLen_;
+    state_ = CardState::ACTIVE;
+    dropCount_ = 0U;
+    return true;
+}
+
+bool Pn532Simulator::inDataExchange(const uint8_t *cmd, uint8_t cmdLen,
+                                    uint8_t *resp, uint8_t *respLen)
+{
+    ++stats_.exchanges;
+
+    uint8_t cap = (respLen != nullptr) ? *respLen : 0U;
+    if (cap > NFC_MAX_FRAME)
+    {
+        cap = NFC_MAX_FRAME;
+    }
+    uint8_t got = cap;
+    uint32_t extraUs = 0U;
+    bool ok = false;
+
+    if (dropCount_ > 0U)
+    {
+        --dropCount_;
+        state_ = CardState::IDLE;
+    }
+    else if (present_ && state_ != CardState::IDLE && cmd != nullptr && cmdLen > 0U &&
+             cmdLen <= NFC_MAX_FRAME && resp != nullptr)
+    {
+        ok = isMifare() ? exchangeMifare(cmd, cmdLen, resp, &got, &extraUs)
+                        : exchangeNtag(cmd, cmdLen, resp, &got, &extraUs);
+        if (!ok)
+        {
+            state_ = CardState::IDLE; // NAK / failed auth
+        }
+    }
+
+    if (!ok)
+    {
+        ++stats_.failures;
+        charge(timing_.frameUs + timing_.byteUs * cmdLen + timing_.timeoutUs + extraUs);
+        if (respLen != nullptr)
+        {
+            *respLen = 0U;
+        }
+        return false;
+    }
+
+    charge(timing_.frameUs + timing_.byteUs * (cmdLen + got) + extraUs);
+    *respLen = got;
+    return true;
+}
+
+bool Pn532Simulator::exchangeMifare(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp,
+                                    uint8_t *respLen, uint32_t *extraUs)
+{
+    const uint8_t block = (cmdLen >= 2U) ? cmd[1] : 0xFFU;
+    if (block >= MF_1K_BYTES / MF_BLOCK)
+    {
+        return false;
+    }
+    const uint8_t sector = mifareSectorOf(block);
+    uint8_t *data = mem_ + static_cast<size_t>(block) * MF_BLOCK;
+    const uint8_t *trailer = mem_ + (static_cast<size_t>(sector) * 4U + 3U) * MF_BLOCK;
+
+    if ((cmd[0] == CMD_MF_AUTH_A || cmd[0] == CMD_MF_AUTH_B) && cmdLen == 12U)
+    {
+        ++stats_.auths;
+        *extraUs = timing_.authUs;
+        const uint8_t *key = trailer + ((cmd[0] == CMD_MF_AUTH_A) ? 0U : 10U);
+        if (std::memcmp(cmd + 2, key, MF_KEY_LEN) != 0 ||
+            std::memcmp(cmd + 8, uid_ + (uidLen_ - 4U), 4U) != 0)
+        {
+            ++stats_.authFailures;
+            return false;
+        }
+        state_ = CardState::AUTHENTICATED;
+        authSector_ = sector;
+        *respLen = 0U;
+        return true;
+    }
+
+    if (state_ != CardState::AUTHENTICATED || authSector_ != sector)
+    {
+        return false;
+    }
+
+    if (cmd[0] == CMD_READ && cmdLen == 2U)
+    {
+        if (*respLen < MF_BLOCK)
+        {
+            return false;
+        }
+        std::memcpy(resp, data, MF_BLOCK);
+        if ((block & 3U) == 3U)
+        {
+            std::memset(resp, 0, MF_KEY_LEN); // key A is never readable
+        }
+        *respLen = MF_BLOCK;
+        return true;
+    }
+
+    if (cmd[0] == CMD_MF_WRITE && cmdLen == 2U + MF_BLOCK)
+    {
+        if (block == 0U && !magic_)
+        {
+            return false; // manufacturer block is read-only
+        }
+        *extraUs = timing_.writeUs;
+        ++stats_.writes;
+        std::memcpy(data, cmd + 2, MF_BLOCK);
+        if (block == 0U && uidLen_ == 4U)
+        {
+            std::memcpy(uid_, data, 4U); // magic card answers with the new UID
+        }
+        *respLen = 0U;
+        return true;
+    }
+
+    return false;
+}
+
+bool Pn532Simulator::exchangeNtag(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp,
+                                  uint8_t *respLen, uint32_t *extraUs)
+{
+    const uint16_t pages = ntagPages();
+    const bool ntag21x = (type_ != SimTagType::ULTRALIGHT);
+
+    if (cmd[0] == CMD_NTAG_VERSION && cmdLen == 1U)
+    {
+        if (!ntag21x || *respLen < 8U)
+        {
+            return false;
+        }
+        const uint8_t version[8] = {0x00U, 0x04U, 0x04U, 0x02U,
+                                    0x01U, 0x00U, versionSizeOf(type_), 0x03U};
+        std::memcpy(resp, version, sizeof(version));
+        *respLen = sizeof(version);
+        return true;
+    }
+
+    if (cmd[0] == CMD_READ && cmdLen == 2U)
+    {
+        if (cmd[1] >= pages || *respLen < 4U * PAGE)
+        {
+            return false;
+        }
+        for (uint16_t i = 0U; i < 4U; ++i)
+        {
+            const uint16_t p = static_cast<uint16_t>((cmd[1] + i) % pages);
+            std::memcpy(resp + i * PAGE, mem_ + static_cast<size_t>(p) * PAGE, PAGE);
+        }
+        *respLen = static_cast<uint8_t>(4U * PAGE);
+        return true;
+    }
+
+    if (cmd[0] == CMD_NTAG_FAST_READ && cmdLen == 3U)
+    {
+        const size_t bytes = static_cast<size_t>(cmd[2] - cmd[1] + 1) * PAGE;
+        if (!ntag21x || cmd[1] > cmd[2] || cmd[2] >= pages || bytes > *respLen)
+        {
+            return false;
+        }
+        std::memcpy(resp, mem_ + static_cast<size_t>(cmd[1]) * PAGE, bytes);
+        *respLen = static_cast<uint8_t>(bytes);
+        return true;
+    }
+
+    if (cmd[0] == CMD_NTAG_WRITE && cmdLen == 2U + PAGE)
+    {
+        if (cmd[1] < 2U || cmd[1] >= pages)
+        {
+            return false; // UID pages are read-only
+        }
+        *extraUs = timing_.writeUs;
+        ++stats_.writes;
+        uint8_t *page = mem_ + static_cast<size_t>(cmd[1]) * PAGE;
+        for (size_t i = 0U; i < PAGE; ++i)
+        {
+            // Page 3 (capability container) is one-time programmable.
+            page[i] = (cmd[1] == 3U) ? static_cast<uint8_t>(page[i] | cmd[2 + i])
+                                     : cmd[2 + i];
+        }
+        *respLen = 0U;
+        return true;
+    }
+
+    if (cmd[0] == CMD_NTAG_PWD_AUTH && cmdLen == 1U + PAGE)
+    {
+        const uint8_t *pwd = mem_ + static_cast<size_t>(pages - 2U) * PAGE;
+        if (!ntag21x || *respLen < 2U || std::memcmp(cmd + 1, pwd, PAGE) != 0)
+        {
+            return false;
+        }
+        std::memcpy(resp, pwd + PAGE, 2U); // PACK
+        *respLen = 2U;
+        return true;
+    }
+
+    return false;
+}
+
+bool Pn532Simulator::tgInitAsTarget()
+{
+    charge(timing_.frameUs + timing_.targetUs);
+    return cmdNext_ < cmdCount_;
+}
+
+bool Pn532Simulator::tgGetData(uint8_t *cmd, uint8_t *cmdLen)
+{
+    ++stats_.targetFrames;
+    if (cmdNext_ >= cmdCount_ || cmd == nullptr || cmdLen == nullptr ||
+        cmds_[cmdNext_].len > *cmdLen)
+    {
+        charge(timing_.frameUs + timing_.timeoutUs); // reader left the field
+        return false;
+    }
+
+    const Frame &f = cmds_[cmdNext_++];
+    std::memcpy(cmd, pool_ + f.offset, f.len);
+    *cmdLen = f.len;
+    charge(timing_.frameUs + timing_.targetUs + timing_.byteUs * f.len);
+    return true;
+}
+
+bool Pn532Simulator::tgSetData(const uint8_t *data, uint8_t len)
+{
+    ++stats_.targetFrames;
+    charge(timing_.frameUs + timing_.byteUs * len);
+    if (data == nullptr || len > NFC_MAX_FRAME)
+    {
+        return false;
+    }
+    return storeFrame(resps_, &respCount_, data, len);
+}
+
+} // namespace hackos::nfc
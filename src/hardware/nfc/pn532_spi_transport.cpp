@@ -0,0 +1,165 @@
+/**
+ * @file pn532_spi_transport.cpp
+ * @brief Adafruit_PN532 (SPI) transport for the device NFCReader.
+ *
+ * The PN532 shares the SPI bus with the SD card, so every command holds
+ * the SPI arbiter (core/spi_arbiter.h) and runs inside its own SPI
+ * transaction (1 MHz, LSB first, mode 0).  Exchanges with a card in the
+ * field go at BusPriority::LATENCY with a deadline hint; waiting for a
+ * card is cut into short polls so the SD gets the bus in between.
+ */
+
+#include "hardware/nfc_reader.h"
+
+#include <Adafruit_PN532.h>
+#include <SPI.h>
+#include <cstring>
+#include <esp_timer.h>
+
+#include "config.h"
+#include "core/system_core.h"
+
+namespace {
+
+using hackos::core::BusPriority;
+using hackos::core::SpiClient;
+using hackos::core::SpiLease;
+
+// ── SPI Transaction Guard for shared bus ────────────────────────────────────
+const SPISettings NFC_SPI_SETTINGS(1000000, LSBFIRST, SPI_MODE0);
+
+/// Card exchanges want the bus within this; past it they beat everything.
+constexpr uint32_t EXCHANGE_BUDGET_US = 2000U;
+/// Longest single InListPassiveTarget poll while waiting for a card.
+constexpr uint16_t POLL_SLICE_MS = 20U;
+
+/// RAII arbiter lease plus SPI transaction for one PN532 command.
+class SpiTransaction
+{
+public:
+    explicit SpiTransaction(BusPriority prio, uint32_t budgetUs = 0U)
+        : lease_(SpiClient::NFC, prio, budgetUs)
+    {
+        SPI.beginTransaction(NFC_SPI_SETTINGS);
+    }
+    ~SpiTransaction() { SPI.endTransaction(); }
+
+    SpiTransaction(const SpiTransaction &) = delete;
+    SpiTransaction &operator=(const SpiTransaction &) = delete;
+
+private:
+    SpiLease lease_;
+};
+
+class Pn532SpiTransport final : public hackos::nfc::NfcTransport
+{
+public:
+    Pn532SpiTransport() : nfc_(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, PIN_NFC_CS) {}
+
+    void begin() override
+    {
+        nfc_.begin();
+    }
+
+    uint32_t firmwareVersion() override
+    {
+        return nfc_.getFirmwareVersion();
+    }
+
+    bool samConfig() override
+    {
+        return nfc_.SAMConfig();
+    }
+
+    bool inListPassiveTarget(uint8_t *uid, uint8_t *uidLen, uint16_t timeoutMs) override
+    {
+        // A new InListPassiveTarget aborts the previous one, so polling in
+        // slices waits just as long without holding the bus throughout.
+        const uint32_t start = nowUs();
+        for (;;)
+        {
+            const uint32_t elapsedMs = (nowUs() - start) / 1000U;
+            const uint32_t left = (timeoutMs > elapsedMs) ? timeoutMs - elapsedMs : 0U;
+            const uint16_t slice = static_cast<uint16_t>((left < POLL_SLICE_MS) ? left
+                                                                                 : POLL_SLICE_MS);
+            {
+                SpiTransaction txn(BusPriority::BULK);
+                if (nfc_.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, uidLen,
+                                             (slice > 0U) ? slice : 1U) == 1)
+                {
+                    return true;
+                }
+            }
+            if (left <= POLL_SLICE_MS)
+            {
+                return false;
+            }
+        }
+    }
+
+    bool inDataExchange(const uint8_t *cmd, uint8_t cmdLen,
+                        uint8_t *resp, uint8_t *respLen) override
+    {
+        // Adafruit_PN532 takes a non-const command buffer.
+        uint8_t buf[hackos::nfc::NFC_MAX_FRAME];
+        if (cmdLen > sizeof(buf))
+        {
+            return false;
+        }
+        std::memcpy(buf, cmd, cmdLen);
+
+        SpiTransaction txn(BusPriority::LATENCY, EXCHANGE_BUDGET_US);
+        return nfc_.inDataExchange(buf, cmdLen, resp, respLen);
+    }
+
+    bool tgInitAsTarget() override
+    {
+        // AsTarget() uses its own hardcoded SENS_RES/NFCID1/SEL_RES
+        // parameters; custom ATR params cannot be applied here.
+        SpiTransaction txn(BusPriority::BULK);
+        return nfc_.AsTarget() != 0U;
+    }
+
+    bool tgGetData(uint8_t *cmd, uint8_t *cmdLen) override
+    {
+        SpiTransaction txn(BusPriority::LATENCY, EXCHANGE_BUDGET_US);
+        return nfc_.getDataTarget(cmd, cmdLen) == 1;
+    }
+
+    bool tgSetData(const uint8_t *data, uint8_t len) override
+    {
+        // setDataTarget expects cmd[0] == 0x8E (TgSetData command code).
+        uint8_t buf[hackos::nfc::NFC_MAX_FRAME + 1U];
+        if (len > hackos::nfc::NFC_MAX_FRAME)
+        {
+            return false;
+        }
+        buf[0] = 0x8EU;
+        std::memcpy(buf + 1, data, len);
+
+        SpiTransaction txn(BusPriority::LATENCY, EXCHANGE_BUDGET_US);
+        return nfc_.setDataTarget(buf, static_cast<uint8_t>(len + 1U)) == 1;
+    }
+
+    uint32_t nowUs() override
+    {
+        return static_cast<uint32_t>(esp_timer_get_time());
+    }
+
+private:
+    Adafruit_PN532 nfc_;
+};
+
+Pn532SpiTransport &pn532SpiTransport()
+{
+    static Pn532SpiTransport transport;
+    return transport;
+}
+
+} // namespace
+
+NFCReader &NFCReader::instance()
+{
+    static NFCReader reader(pn532SpiTransport());
+    return reader;
+}
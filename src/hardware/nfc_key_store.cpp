@@ -0,0 +1,148 @@
+/**
+ * @file nfc_key_store.cpp
+ * @brief SD persistence of the NFCReader Mifare key dictionary and UID cache.
+ *
+ * Kept apart from nfc_reader.cpp so the reader's protocol code has no
+ * filesystem dependency and builds on the host against Pn532Simulator.
+ */
+
+#include "hardware/nfc_reader.h"
+
+#include <esp_log.h>
+#include <new>
+
+#include "storage/buffered_stream.h"
+
+static constexpr const char *TAG_NFC = "NFCReader";
+
+// ── Mifare key store ────────────────────────────────────────────────────────
+
+bool NFCReader::loadKeyStore()
+{
+    if (keyStoreLoaded_)
+    {
+        return true;
+    }
+
+    hackos::storage::BufferedReader reader;
+    uint8_t chunk[128];
+
+    if (!reader.begin(KEY_DICT_PATH))
+    {
+        return false; // SD missing – retry on the next dump
+    }
+    keys_.beginParse();
+    size_t added = 0U;
+    while (!reader.isFinished())
+    {
+        const size_t n = reader.readChunk(chunk, sizeof(chunk));
+        if (n == 0U)
+        {
+            break;
+        }
+        added += keys_.feed(reinterpret_cast<const char *>(chunk), n);
+    }
+    added += keys_.finishParse();
+    reader.close();
+
+    // Hit counters: records never straddle a chunk (128 = 16 × 8).
+    static_assert(sizeof(chunk) % hackos::nfc::MifareKeyDictionary::STATS_RECORD_SIZE == 0U,
+                  "chunk must hold whole stats records");
+    if (reader.begin(KEY_HITS_PATH))
+    {
+        while (!reader.isFinished())
+        {
+            const size_t n = reader.readChunk(chunk, sizeof(chunk));
+            if (n == 0U)
+            {
+                break;
+            }
+            (void)keys_.applyStats(chunk, n);
+        }
+        reader.close();
+    }
+
+    // UID cache: small enough to read in one go.
+    constexpr size_t CACHE_BYTES =
+        hackos::nfc::MifareUidCache::MAX_UIDS * hackos::nfc::MifareUidCache::RECORD_SIZE;
+    uint8_t *cacheBuf = new (std::nothrow) uint8_t[CACHE_BYTES];
+    if (cacheBuf != nullptr && reader.begin(UID_CACHE_PATH))
+    {
+        size_t total = 0U;
+        while (!reader.isFinished() && total < CACHE_BYTES)
+        {
+            const size_t n = reader.readChunk(cacheBuf + total, CACHE_BYTES - total);
+            if (n == 0U)
+            {
+                break;
+            }
+            total += n;
+        }
+        reader.close();
+        (void)uidCache_.decode(cacheBuf, total);
+    }
+    delete[] cacheBuf;
+
+    keys_.clearDirty();
+    uidCache_.clearDirty();
+    keyStoreLoaded_ = true;
+    ESP_LOGI(TAG_NFC, "Key store: %u keys (+%u from SD), %u cached cards",
+             static_cast<unsigned>(keys_.count()), static_cast<unsigned>(added),
+             static_cast<unsigned>(uidCache_.count()));
+    return true;
+}
+
+bool NFCReader::saveKeyStore()
+{
+    if (!keyStoreLoaded_)
+    {
+        return false; // never overwrite counters we have not read
+    }
+
+    bool ok = true;
+    hackos::storage::BufferedWriter writer;
+
+    if (keys_.isDirty())
+    {
+        uint8_t stats[hackos::nfc::MifareKeyDictionary::MAX_KEYS *
+                      hackos::nfc::MifareKeyDictionary::STATS_RECORD_SIZE];
+        const size_t n = keys_.encodeStats(stats, sizeof(stats));
+        if (writer.begin(KEY_HITS_PATH) && writer.write(stats, n) && writer.flush())
+        {
+            keys_.clearDirty();
+        }
+        else
+        {
+            ok = false;
+        }
+        writer.close();
+    }
+
+    if (uidCache_.isDirty())
+    {
+        constexpr size_t CACHE_BYTES =
+            hackos::nfc::MifareUidCache::MAX_UIDS * hackos::nfc::MifareUidCache::RECORD_SIZE;
+        uint8_t *cacheBuf = new (std::nothrow) uint8_t[CACHE_BYTES];
+        if (cacheBuf == nullptr)
+        {
+            return false;
+        }
+        const size_t n = uidCache_.encode(cacheBuf, CACHE_BYTES);
+        if (writer.begin(UID_CACHE_PATH) && writer.write(cacheBuf, n) && writer.flush())
+        {
+            uidCache_.clearDirty();
+        }
+        else
+        {
+            ok = false;
+        }
+        writer.close();
+        delete[] cacheBuf;
+    }
+
+    if (!ok)
+    {
+        ESP_LOGW(TAG_NFC, "Key store save failed");
+    }
+    return ok;
+}
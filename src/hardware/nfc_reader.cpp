@@ -1,30 +1,20 @@
 #include "hardware/nfc_reader.h"
 
-#include <SPI.h>
 #include <cstring>
 #include <esp_log.h>
 
-#include "config.h"
+static constexpr const char *TAG_NFC = "NFCReader";
 
-// ── SPI Transaction Guard for shared bus ────────────────────────────────────
-static const SPISettings NFC_SPI_SETTINGS(1000000, LSBFIRST, SPI_MODE0);
+// ── NFC Forum Type 2 / NTAG21x command codes ────────────────────────────────
+static constexpr uint8_t NTAG_CMD_GET_VERSION = 0x60U;
+static constexpr uint8_t NTAG_CMD_READ        = 0x30U;
+static constexpr uint8_t NTAG_CMD_FAST_READ   = 0x3AU;
+static constexpr uint8_t NTAG_CMD_WRITE       = 0xA2U;
 
-/// @brief Helper: send data in PN532 target/emulation mode.
-/// Wraps setDataTarget with the required 0x8E (TgSetData) command prefix.
-static bool sendTargetResponse(Adafruit_PN532 &nfc, uint8_t *data, uint8_t len)
-{
-    // setDataTarget expects cmd[0] == 0x8E (TgSetData command code)
-    uint8_t buf[64];
-    if (static_cast<size_t>(len) + 1U > sizeof(buf))
-    {
-        return false;
-    }
-    buf[0] = 0x8EU;
-    std::memcpy(buf + 1, data, len);
-    return nfc.setDataTarget(buf, static_cast<uint8_t>(len + 1U)) == 1;
-}
-
-static constexpr const char *TAG_NFC = "NFCReader";
+// ── Mifare Classic command codes ────────────────────────────────────────────
+static constexpr uint8_t MF_CMD_AUTH_A = 0x60U;
+static constexpr uint8_t MF_CMD_READ   = 0x30U;
+static constexpr uint8_t MF_CMD_WRITE  = 0xA0U;
 
 // ── Well-known Mifare Classic default keys ──────────────────────────────────
 const uint8_t NFCReader::DEFAULT_KEYS[NUM_DEFAULT_KEYS][6] = {
@@ -36,16 +26,22 @@ const uint8_t NFCReader::DEFAULT_KEYS[NUM_DEFAULT_KEYS][6] = {
     {0x4DU, 0x3AU, 0x99U, 0xC3U, 0x51U, 0xDDU}, // NDEF key
 };
 
-NFCReader &NFCReader::instance()
-{
-    static NFCReader reader;
-    return reader;
-}
-
-NFCReader::NFCReader()
-    : nfc_(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI, PIN_NFC_CS),
-      initialized_(false)
+NFCReader::NFCReader(hackos::nfc::NfcTransport &transport)
+    : transport_(transport),
+      initialized_(false),
+      fastReadSupported_(true),
+      lastRead_{},
+      lastWrite_{},
+      keys_(),
+      uidCache_(),
+      keyStoreLoaded_(false),
+      lastAuth_{},
+      lastAuthUid_{},
+      lastAuthUidLen_(0U),
+      prevKey_{},
+      cardLost_(false)
 {
+    seedDefaultKeys();
 }
 
 bool NFCReader::init()
@@ -55,8 +51,8 @@ bool NFCReader::init()
         return true;
     }
 
-    nfc_.begin();
-    const uint32_t version = nfc_.getFirmwareVersion();
+    transport_.begin();
+    const uint32_t version = transport_.firmwareVersion();
 
     if (version == 0U)
     {
@@ -68,7 +64,11 @@ bool NFCReader::init()
              static_cast<unsigned long>((version >> 16) & 0xFFUL),
              static_cast<unsigned long>((version >> 8) & 0xFFUL));
 
-    nfc_.SAMConfig();
+    if (!transport_.samConfig())
+    {
+        ESP_LOGE(TAG_NFC, "SAMConfig failed");
+        return false;
+    }
     initialized_ = true;
     return true;
 }
@@ -91,10 +91,11 @@ bool NFCReader::readUID(uint8_t *uid, uint8_t *uidLen, uint16_t timeoutMs)
         return false;
     }
 
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const bool ok = nfc_.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, uidLen,
-                                    timeoutMs) == 1;
-    SPI.endTransaction();
+    const bool ok = transport_.inListPassiveTarget(uid, uidLen, timeoutMs);
+    if (ok)
+    {
+        fastReadSupported_ = true; // New selection: assume NTAG21x until NAK
+    }
     return ok;
 }
 
@@ -105,68 +106,150 @@ bool NFCReader::authenticateBlock(const uint8_t *uid, uint8_t uidLen, uint8_t bl
         return false;
     }
 
-    // Copy key to mutable buffer – Adafruit_PN532 API takes non-const pointers
-    uint8_t key[6];
-    std::memcpy(key, DEFAULT_KEYS[0], 6U);
-
-    // uid parameter also requires a non-const pointer per the Adafruit_PN532 API
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const bool ok = nfc_.mifareclassic_AuthenticateBlock(
-               const_cast<uint8_t *>(uid), uidLen, blockAddr, 0U, key) == 1;
-    SPI.endTransaction();
-    return ok;
+    return mifareAuth(uid, uidLen, blockAddr, DEFAULT_KEYS[0]);
 }
 
 bool NFCReader::authenticateBlockWithKeys(const uint8_t *uid, uint8_t uidLen,
                                           uint8_t blockAddr, uint8_t *keyIdx)
 {
-    if (!initialized_ || uid == nullptr)
+    if (!initialized_ || uid == nullptr || uidLen == 0U ||
+        uidLen > hackos::nfc::MF_MAX_UID_LEN)
     {
         return false;
     }
 
-    for (uint8_t k = 0U; k < NUM_DEFAULT_KEYS; ++k)
+    const uint8_t sector = hackos::nfc::mifareSectorOf(blockAddr);
+    const bool sameCard = (uidLen == lastAuthUidLen_ &&
+                           std::memcmp(uid, lastAuthUid_, uidLen) == 0);
+
+    lastAuth_ = {};
+    cardLost_ = false;
+    uint8_t tried[2][6] = {};
+    size_t triedCount = 0U;
+    const uint8_t *found = nullptr;
+
+    // 1. Key that opened this sector of this card last time.
+    uint8_t cached[6];
+    if (uidCache_.lookup(uid, uidLen, sector, cached))
     {
-        // Need a fresh card selection before each auth attempt after a failure.
-        // Re-select the card by doing a quick readPassiveTargetID if k > 0.
-        if (k > 0U)
+        std::memcpy(tried[triedCount++], cached, 6U);
+        if (tryAuthKey(uid, uidLen, blockAddr, cached))
         {
-            uint8_t tmpUid[7] = {};
-            uint8_t tmpLen = 0U;
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            const bool reselected = nfc_.readPassiveTargetID(
-                PN532_MIFARE_ISO14443A, tmpUid, &tmpLen, 200U);
-            SPI.endTransaction();
-            if (!reselected)
-            {
-                continue;
-            }
+            found = cached;
+            lastAuth_.source = MifareKeySource::UID_CACHE;
         }
+        else
+        {
+            uidCache_.forget(uid, uidLen, sector);
+        }
+    }
 
-        uint8_t key[6];
-        std::memcpy(key, DEFAULT_KEYS[k], 6U);
+    // 2. Cards are often keyed uniformly: reuse the previous sector's key.
+    if (found == nullptr && sameCard &&
+        (triedCount == 0U || std::memcmp(tried[0], prevKey_, 6U) != 0))
+    {
+        std::memcpy(tried[triedCount++], prevKey_, 6U);
+        if (tryAuthKey(uid, uidLen, blockAddr, prevKey_))
+        {
+            found = prevKey_;
+            lastAuth_.source = MifareKeySource::PREV_SECTOR;
+        }
+    }
 
-        SPI.beginTransaction(NFC_SPI_SETTINGS);
-        const bool authOk = nfc_.mifareclassic_AuthenticateBlock(
-                const_cast<uint8_t *>(uid), uidLen, blockAddr, 0U, key) == 1;
-        SPI.endTransaction();
+    // 3. Dictionary, most successful keys first.
+    uint8_t dictKey[6];
+    for (size_t i = 0U; found == nullptr && !cardLost_ && i < keys_.count(); ++i)
+    {
+        const uint8_t *key = keys_.at(i).key;
+        bool skip = false;
+        for (size_t t = 0U; t < triedCount; ++t)
+        {
+            skip = skip || std::memcmp(tried[t], key, 6U) == 0;
+        }
+        if (skip)
+        {
+            continue;
+        }
+        std::memcpy(dictKey, key, 6U);
+        if (tryAuthKey(uid, uidLen, blockAddr, dictKey))
+        {
+            found = dictKey;
+            lastAuth_.source = MifareKeySource::DICTIONARY;
+        }
+    }
 
-        if (authOk)
+    if (found == nullptr)
+    {
+        ESP_LOGD(TAG_NFC, "Auth block %u failed after %u keys",
+                 static_cast<unsigned>(blockAddr),
+                 static_cast<unsigned>(lastAuth_.attempts));
+        // The last rejected key halted the card; select it again so the
+        // next sector's first (cached / previous-sector) key gets a fair try.
+        if (lastAuth_.attempts > 0U && !cardLost_)
         {
-            if (keyIdx != nullptr)
+            (void)reselect();
+        }
+        return false;
+    }
+
+    std::memcpy(lastAuth_.key, found, 6U);
+    if (found != prevKey_)
+    {
+        std::memcpy(prevKey_, found, 6U);
+    }
+    std::memcpy(lastAuthUid_, uid, uidLen);
+    lastAuthUidLen_ = uidLen;
+    keys_.recordHit(found);
+    uidCache_.store(uid, uidLen, sector, found);
+
+    if (keyIdx != nullptr)
+    {
+        *keyIdx = NUM_DEFAULT_KEYS;
+        for (uint8_t k = 0U; k < NUM_DEFAULT_KEYS; ++k)
+        {
+            if (std::memcmp(DEFAULT_KEYS[k], found, 6U) == 0)
             {
                 *keyIdx = k;
+                break;
             }
-            ESP_LOGD(TAG_NFC, "Auth block %u OK with key #%u",
-                     static_cast<unsigned>(blockAddr), static_cast<unsigned>(k));
-            return true;
         }
+    }
+    ESP_LOGD(TAG_NFC, "Auth block %u OK (source %u, %u tries)",
+             static_cast<unsigned>(blockAddr),
+             static_cast<unsigned>(lastAuth_.source),
+             static_cast<unsigned>(lastAuth_.attempts));
+    return true;
+}
 
-        ESP_LOGD(TAG_NFC, "Auth block %u failed with key #%u",
-                 static_cast<unsigned>(blockAddr), static_cast<unsigned>(k));
+bool NFCReader::tryAuthKey(const uint8_t *uid, uint8_t uidLen, uint8_t blockAddr,
+                           const uint8_t *key)
+{
+    // A failed auth halts the card: re-select before every further attempt.
+    if (lastAuth_.attempts > 0U && !reselect())
+    {
+        cardLost_ = true;
+        return false;
     }
+    ++lastAuth_.attempts;
+    return mifareAuth(uid, uidLen, blockAddr, key);
+}
 
-    return false;
+bool NFCReader::mifareAuth(const uint8_t *uid, uint8_t uidLen, uint8_t blockAddr,
+                           const uint8_t *key)
+{
+    if (uidLen < 4U)
+    {
+        return false;
+    }
+
+    // The card authenticates against the last four UID bytes (cascade
+    // level 2 for 7-byte UIDs).
+    uint8_t cmd[12] = {MF_CMD_AUTH_A, blockAddr};
+    std::memcpy(cmd + 2, key, 6U);
+    std::memcpy(cmd + 8, uid + (uidLen - 4U), 4U);
+    uint8_t resp[4];
+    uint8_t respLen = sizeof(resp);
+    return exchange(cmd, sizeof(cmd), resp, &respLen);
 }
 
 bool NFCReader::readBlock(uint8_t blockAddr, uint8_t *data)
@@ -176,10 +259,15 @@ bool NFCReader::readBlock(uint8_t blockAddr, uint8_t *data)
         return false;
     }
 
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const bool ok = nfc_.mifareclassic_ReadDataBlock(blockAddr, data) == 1;
-    SPI.endTransaction();
-    return ok;
+    const uint8_t cmd[2] = {MF_CMD_READ, blockAddr};
+    uint8_t resp[BYTES_PER_BLOCK];
+    uint8_t respLen = sizeof(resp);
+    if (!exchange(cmd, sizeof(cmd), resp, &respLen) || respLen < BYTES_PER_BLOCK)
+    {
+        return false;
+    }
+    std::memcpy(data, resp, BYTES_PER_BLOCK);
+    return true;
 }
 
 bool NFCReader::writeBlock(uint8_t blockAddr, const uint8_t *data)
@@ -189,11 +277,11 @@ bool NFCReader::writeBlock(uint8_t blockAddr, const uint8_t *data)
         return false;
     }
 
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const bool ok = nfc_.mifareclassic_WriteDataBlock(blockAddr,
-                                             const_cast<uint8_t *>(data)) == 1;
-    SPI.endTransaction();
-    return ok;
+    uint8_t cmd[2U + BYTES_PER_BLOCK] = {MF_CMD_WRITE, blockAddr};
+    std::memcpy(cmd + 2, data, BYTES_PER_BLOCK);
+    uint8_t resp[4];
+    uint8_t respLen = sizeof(resp);
+    return exchange(cmd, sizeof(cmd), resp, &respLen);
 }
 
 bool NFCReader::writeMagicUid(const uint8_t *newUid, uint8_t uidLen)
@@ -319,15 +407,8 @@ bool NFCReader::emulateNtag213Url(const char *url, uint8_t prefixCode,
         return false;
     }
 
-    // Note: AsTarget() uses its own hardcoded SENS_RES/NFCID1/SEL_RES
-    // parameters internally; custom ATR params cannot be applied here.
-
     // Set PN532 as target (passive only, 106 kbps)
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const uint8_t activated = nfc_.AsTarget();
-    SPI.endTransaction();
-
-    if (activated == 0U)
+    if (!transport_.tgInitAsTarget())
     {
         ESP_LOGW(TAG_NFC, "emulateNtag213Url: no reader detected (timeout)");
         return false;
@@ -343,9 +424,7 @@ bool NFCReader::emulateNtag213Url(const char *url, uint8_t prefixCode,
     for (uint8_t attempts = 0U; attempts < 20U; ++attempts)
     {
         cmdLen = sizeof(cmd);
-        SPI.beginTransaction(NFC_SPI_SETTINGS);
-        const bool gotData = nfc_.getDataTarget(cmd, &cmdLen) == 1;
-        SPI.endTransaction();
+        const bool gotData = transport_.tgGetData(cmd, &cmdLen);
         if (!gotData)
         {
             break;
@@ -398,9 +477,7 @@ bool NFCReader::emulateNtag213Url(const char *url, uint8_t prefixCode,
                 }
             }
 
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            const bool sent = sendTargetResponse(nfc_, resp, 16U);
-            SPI.endTransaction();
+            const bool sent = sendTargetResponse(resp, 16U);
             if (sent)
             {
                 success = true;
@@ -410,9 +487,7 @@ bool NFCReader::emulateNtag213Url(const char *url, uint8_t prefixCode,
         {
             // Unknown command – respond with empty ACK
             uint8_t ack = 0x0AU;
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            sendTargetResponse(nfc_, &ack, 1U);
-            SPI.endTransaction();
+            sendTargetResponse(&ack, 1U);
         }
     }
 
@@ -431,16 +506,11 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
 
     // Extract UID bytes from the dump to use in SENS_RES/NFCID1
     // NTAG215 page 0: UID0 UID1 UID2 BCC0, page 1: UID3 UID4 UID5 UID6
-    // Note: AsTarget() uses its own hardcoded SENS_RES/NFCID1/SEL_RES/Felica
-    // parameters internally; the PN532 library does not expose a configurable
-    // tgInitAsTarget() API, so custom ATR params cannot be applied here.
+    // Note: the transport presents fixed SENS_RES/NFCID1/SEL_RES values;
+    // the dump's UID cannot be applied to the anticollision response.
     (void)timeoutMs;
 
-    SPI.beginTransaction(NFC_SPI_SETTINGS);
-    const uint8_t activated = nfc_.AsTarget();
-    SPI.endTransaction();
-
-    if (activated == 0U)
+    if (!transport_.tgInitAsTarget())
     {
         ESP_LOGW(TAG_NFC, "emulateNtag215: no reader detected (timeout)");
         return false;
@@ -455,9 +525,7 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
     for (uint8_t attempts = 0U; attempts < 50U; ++attempts)
     {
         cmdLen = sizeof(cmd);
-        SPI.beginTransaction(NFC_SPI_SETTINGS);
-        const bool gotData = nfc_.getDataTarget(cmd, &cmdLen) == 1;
-        SPI.endTransaction();
+        const bool gotData = transport_.tgGetData(cmd, &cmdLen);
         if (!gotData)
         {
             break;
@@ -483,9 +551,7 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
                 }
             }
 
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            const bool sent = sendTargetResponse(nfc_, resp, 16U);
-            SPI.endTransaction();
+            const bool sent = sendTargetResponse(resp, 16U);
             if (sent)
             {
                 success = true;
@@ -498,9 +564,7 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
                 0x00U, 0x04U, 0x04U, 0x02U,
                 0x01U, 0x00U, 0x11U, 0x03U,
             };
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            sendTargetResponse(nfc_, version, sizeof(version));
-            SPI.endTransaction();
+            sendTargetResponse(version, sizeof(version));
         }
         else if (cmd[0] == 0x1BU && cmdLen >= 5U)
         {
@@ -508,9 +572,7 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
             // Respond with PACK (2 bytes) from pages 133-134 area
             // For Amiibo, respond with 0x80 0x80 (standard PACK)
             uint8_t pack[] = {0x80U, 0x80U};
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            sendTargetResponse(nfc_, pack, sizeof(pack));
-            SPI.endTransaction();
+            sendTargetResponse(pack, sizeof(pack));
             success = true;
         }
         else if (cmd[0] == 0x3AU && cmdLen >= 3U)
@@ -527,26 +589,20 @@ bool NFCReader::emulateNtag215(const uint8_t *dump, uint16_t timeoutMs)
                 uint8_t resp[56] = {};
                 std::memcpy(resp, dump + (static_cast<size_t>(startPage) * 4U),
                             static_cast<size_t>(pages) * 4U);
-                SPI.beginTransaction(NFC_SPI_SETTINGS);
-                sendTargetResponse(nfc_, resp, pages * 4U);
-                SPI.endTransaction();
+                sendTargetResponse(resp, pages * 4U);
                 success = true;
             }
             else
             {
                 uint8_t nack = 0x00U;
-                SPI.beginTransaction(NFC_SPI_SETTINGS);
-                sendTargetResponse(nfc_, &nack, 1U);
-                SPI.endTransaction();
+                sendTargetResponse(&nack, 1U);
             }
         }
         else
         {
             // Unknown command – respond with ACK
             uint8_t ack = 0x0AU;
-            SPI.beginTransaction(NFC_SPI_SETTINGS);
-            sendTargetResponse(nfc_, &ack, 1U);
-            SPI.endTransaction();
+            sendTargetResponse(&ack, 1U);
         }
     }
 
@@ -575,26 +631,241 @@ bool NFCReader::writeNtag215(const uint8_t *dump)
     // Step 2: Write user-data pages (4–129)
     // Pages 0-3 are manufacturer/UID (read-only on real tags)
     // Pages 130-134 are config/password area
-    for (uint8_t page = 4U; page < 130U; ++page)
+    static constexpr uint8_t FIRST_USER_PAGE = 4U;
+    static constexpr uint8_t USER_PAGES = 126U;
+    if (!writeNtagPages(FIRST_USER_PAGE, USER_PAGES,
+                        dump + static_cast<size_t>(FIRST_USER_PAGE) * NTAG_PAGE_SIZE))
     {
-        const size_t offset = static_cast<size_t>(page) * 4U;
-        uint8_t pageData[4];
-        std::memcpy(pageData, dump + offset, 4U);
+        ESP_LOGE(TAG_NFC, "writeNtag215: write failed");
+        return false;
+    }
+
+    ESP_LOGI(TAG_NFC, "writeNtag215: all pages written successfully");
+    return true;
+}
 
-        SPI.beginTransaction(NFC_SPI_SETTINGS);
-        const bool writeOk = nfc_.ntag2xx_WritePage(page, pageData) == 1;
-        SPI.endTransaction();
+// ── NTAG bulk access ────────────────────────────────────────────────────────
 
-        if (!writeOk)
+bool NFCReader::exchange(const uint8_t *cmd, uint8_t cmdLen, uint8_t *resp,
+                         uint8_t *respLen)
+{
+    return transport_.inDataExchange(cmd, cmdLen, resp, respLen);
+}
+
+bool NFCReader::sendTargetResponse(const uint8_t *data, uint8_t len)
+{
+    return transport_.tgSetData(data, len);
+}
+
+bool NFCReader::reselect()
+{
+    uint8_t uid[7] = {};
+    uint8_t uidLen = 0U;
+    return transport_.inListPassiveTarget(uid, &uidLen, 200U);
+}
+
+uint8_t NFCReader::ntagPageCount()
+{
+    if (!initialized_)
+    {
+        return 0U;
+    }
+
+    uint8_t cmd[1] = {NTAG_CMD_GET_VERSION};
+    uint8_t resp[8] = {};
+    uint8_t respLen = sizeof(resp);
+    if (!exchange(cmd, sizeof(cmd), resp, &respLen) || respLen < 8U)
+    {
+        // Ultralight / clones: no GET_VERSION means no FAST_READ either,
+        // so skip the second NAK in readNtagPages().
+        fastReadSupported_ = false;
+        (void)reselect(); // A NAK leaves the tag in IDLE.
+        return 0U;
+    }
+
+    // resp: header, vendor (0x04 = NXP), type (0x04 = NTAG), subtype,
+    //       major, minor, storage size, protocol.
+    if (resp[1] != 0x04U || resp[2] != 0x04U)
+    {
+        return 0U;
+    }
+
+    switch (resp[6])
+    {
+    case 0x0FU: return 45U;  // NTAG213
+    case 0x11U: return 135U; // NTAG215
+    case 0x13U: return 231U; // NTAG216
+    default:    return 0U;
+    }
+}
+
+bool NFCReader::readNtagPages(uint8_t startPage, uint16_t pageCount, uint8_t *out)
+{
+    lastRead_ = NtagOpStats{};
+    lastRead_.pages = pageCount;
+
+    if (!initialized_ || out == nullptr || pageCount == 0U ||
+        static_cast<uint16_t>(startPage) + pageCount > 256U)
+    {
+        return false;
+    }
+
+    const uint32_t startUs = transport_.nowUs();
+    uint16_t done = 0U;
+    bool ok = true;
+
+    while (done < pageCount)
+    {
+        const uint8_t page = static_cast<uint8_t>(startPage + done);
+        const uint16_t remaining = static_cast<uint16_t>(pageCount - done);
+
+        if (fastReadSupported_)
         {
-            ESP_LOGE(TAG_NFC, "writeNtag215: write page %u failed",
+            const uint8_t chunk = (remaining > NTAG_FAST_READ_MAX_PAGES)
+                                      ? NTAG_FAST_READ_MAX_PAGES
+                                      : static_cast<uint8_t>(remaining);
+            uint8_t cmd[3] = {NTAG_CMD_FAST_READ, page,
+                              static_cast<uint8_t>(page + chunk - 1U)};
+            uint8_t resp[NTAG_FAST_READ_MAX_PAGES * NTAG_PAGE_SIZE];
+            uint8_t respLen = sizeof(resp);
+            ++lastRead_.exchanges;
+
+            if (exchange(cmd, sizeof(cmd), resp, &respLen) &&
+                respLen >= chunk * NTAG_PAGE_SIZE)
+            {
+                std::memcpy(out + static_cast<size_t>(done) * NTAG_PAGE_SIZE, resp,
+                            static_cast<size_t>(chunk) * NTAG_PAGE_SIZE);
+                done = static_cast<uint16_t>(done + chunk);
+                lastRead_.fastRead = true;
+                continue;
+            }
+
+            // Ultralight / clones: no FAST_READ.  The NAK put the tag in
+            // IDLE, so select it again and continue with plain READ.
+            ESP_LOGD(TAG_NFC, "FAST_READ rejected at page %u, using READ",
                      static_cast<unsigned>(page));
-            return false;
+            fastReadSupported_ = false;
+            if (!reselect())
+            {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+
+        uint8_t cmd[2] = {NTAG_CMD_READ, page};
+        uint8_t resp[NTAG_READ_PAGES * NTAG_PAGE_SIZE];
+        uint8_t respLen = sizeof(resp);
+        ++lastRead_.exchanges;
+
+        if (!exchange(cmd, sizeof(cmd), resp, &respLen) || respLen < NTAG_PAGE_SIZE)
+        {
+            ok = false;
+            break;
         }
 
-        ESP_LOGD(TAG_NFC, "writeNtag215: page %u OK", static_cast<unsigned>(page));
+        // READ returns 4 pages (wrapping at the end of memory).
+        uint16_t got = static_cast<uint16_t>(respLen / NTAG_PAGE_SIZE);
+        if (got > remaining)
+        {
+            got = remaining;
+        }
+        std::memcpy(out + static_cast<size_t>(done) * NTAG_PAGE_SIZE, resp,
+                    static_cast<size_t>(got) * NTAG_PAGE_SIZE);
+        done = static_cast<uint16_t>(done + got);
     }
 
-    ESP_LOGI(TAG_NFC, "writeNtag215: all pages written successfully");
-    return true;
+    lastRead_.elapsedUs = transport_.nowUs() - startUs;
+    lastRead_.ok = ok;
+    ESP_LOGI(TAG_NFC, "readNtagPages: %u pages, %u exchanges (%s), %lu us%s",
+             static_cast<unsigned>(pageCount),
+             static_cast<unsigned>(lastRead_.exchanges),
+             lastRead_.fastRead ? "FAST_READ" : "READ",
+             static_cast<unsigned long>(lastRead_.elapsedUs),
+             ok ? "" : " FAILED");
+    return ok;
+}
+
+bool NFCReader::writeNtagPages(uint8_t startPage, uint16_t pageCount,
+                               const uint8_t *data, bool skipUnchanged)
+{
+    NtagOpStats stats{};
+    stats.pages = pageCount;
+
+    if (!initialized_ || data == nullptr || pageCount == 0U ||
+        static_cast<uint16_t>(startPage) + pageCount > 256U)
+    {
+        lastWrite_ = stats;
+        return false;
+    }
+
+    const uint32_t startUs = transport_.nowUs();
+    bool ok = true;
+
+    // Work in FAST_READ-sized windows so the compare buffer stays small.
+    for (uint16_t base = 0U; base < pageCount && ok;
+         base = static_cast<uint16_t>(base + NTAG_FAST_READ_MAX_PAGES))
+    {
+        const uint16_t left = static_cast<uint16_t>(pageCount - base);
+        const uint8_t chunk = (left > NTAG_FAST_READ_MAX_PAGES)
+                                  ? NTAG_FAST_READ_MAX_PAGES
+                                  : static_cast<uint8_t>(left);
+        const uint8_t *src = data + static_cast<size_t>(base) * NTAG_PAGE_SIZE;
+
+        uint8_t current[NTAG_FAST_READ_MAX_PAGES * NTAG_PAGE_SIZE];
+        bool haveCurrent = false;
+        if (skipUnchanged)
+        {
+            haveCurrent = readNtagPages(static_cast<uint8_t>(startPage + base),
+                                        chunk, current);
+            stats.exchanges = static_cast<uint16_t>(stats.exchanges + lastRead_.exchanges);
+            stats.fastRead = stats.fastRead || lastRead_.fastRead;
+        }
+
+        for (uint8_t i = 0U; i < chunk; ++i)
+        {
+            const size_t off = static_cast<size_t>(i) * NTAG_PAGE_SIZE;
+            if (haveCurrent && std::memcmp(current + off, src + off, NTAG_PAGE_SIZE) == 0)
+            {
+                continue;
+            }
+
+            const uint8_t page = static_cast<uint8_t>(startPage + base + i);
+            uint8_t cmd[2U + NTAG_PAGE_SIZE] = {NTAG_CMD_WRITE, page};
+            std::memcpy(cmd + 2, src + off, NTAG_PAGE_SIZE);
+            uint8_t resp[4];
+            uint8_t respLen = sizeof(resp);
+            ++stats.exchanges;
+
+            if (!exchange(cmd, sizeof(cmd), resp, &respLen))
+            {
+                ESP_LOGE(TAG_NFC, "writeNtagPages: page %u failed",
+                         static_cast<unsigned>(page));
+                ok = false;
+                break;
+            }
+            ++stats.written;
+        }
+    }
+
+    stats.elapsedUs = transport_.nowUs() - startUs;
+    stats.ok = ok;
+    lastWrite_ = stats;
+    ESP_LOGI(TAG_NFC, "writeNtagPages: %u/%u pages written, %u exchanges, %lu us%s",
+             static_cast<unsigned>(stats.written),
+             static_cast<unsigned>(pageCount),
+             static_cast<unsigned>(stats.exchanges),
+             static_cast<unsigned long>(stats.elapsedUs),
+             ok ? "" : " FAILED");
+    return ok;
+}
+
+// ── Mifare key store ────────────────────────────────────────────────────────
+
+void NFCReader::seedDefaultKeys()
+{
+    for (uint8_t k = 0U; k < NUM_DEFAULT_KEYS; ++k)
+    {
+        (void)keys_.add(DEFAULT_KEYS[k]);
+    }
 }
@@ -0,0 +1,47 @@
+/**
+ * @file edge_rx_device.cpp
+ * @brief EdgeCapture-backed receive device (see edge_rx_device.h).
+ */
+
+#include "hardware/radio/edge_rx_device.h"
+
+#include <cstring>
+
+#include "hardware/edge/edge_capture.h"
+
+namespace hackos::radio {
+
+EdgeRxDevice::EdgeRxDevice(const char *name, uint8_t pin, Modulation modulation)
+    : name_(name),
+      pin_(pin),
+      modulation_(modulation),
+      reader_()
+{
+}
+
+bool EdgeRxDevice::startReceive()
+{
+    if (reader_.attached())
+    {
+        return true;
+    }
+    return hackos::edge::EdgeCapture::instance().subscribe(pin_, &reader_);
+}
+
+void EdgeRxDevice::stop()
+{
+    hackos::edge::EdgeCapture::instance().unsubscribe(pin_, &reader_);
+}
+
+size_t EdgeRxDevice::read(uint8_t *buffer, size_t maxLen)
+{
+    static constexpr size_t BATCH = 64U;
+    int32_t pulses[BATCH];
+    const size_t want = (maxLen / sizeof(int32_t) < BATCH) ? maxLen / sizeof(int32_t) : BATCH;
+    const size_t n = hackos::edge::EdgeCapture::instance().readPulses(
+        pin_, &reader_, pulses, want, MAX_PULSE_US);
+    std::memcpy(buffer, pulses, n * sizeof(int32_t));
+    return n * sizeof(int32_t);
+}
+
+} // namespace hackos::radio
@@ -0,0 +1,640 @@
+/**
+ * @file pulse_spectrum.cpp
+ * @brief Fixed-point FFT / Goertzel pulse-train analysis (see pulse_spectrum.h).
+ */
+
+#include "hardware/radio/pulse_spectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+namespace hackos::radio {
+
+namespace {
+
+constexpr size_t TWIDDLE_N = 1U << FFT_MAX_LOG2;
+constexpr size_t QUARTER = TWIDDLE_N / 4U;
+constexpr double PI = 3.14159265358979323846;
+
+/// Inputs at or above this may overflow a butterfly: halve that stage.
+constexpr int32_t FFT_HEADROOM = 8192;
+
+/// Largest bin value fed to the FFT.
+constexpr int32_t DENSITY_FULL = 16383;
+
+/// A clock peak must reach this share of the strongest non-zero lag.
+constexpr int32_t CLOCK_PEAK_PERCENT = 35;
+
+/// A repeat peak must reach this share of lag 0.
+constexpr int32_t REPEAT_PEAK_PERMILLE = 300;
+
+/// Pulses longer than this many clocks are sync / gaps, not data.
+constexpr uint32_t MAX_DATA_UNITS = 8U;
+
+/// A shorter repeat candidate wins if it reaches this share of the best.
+constexpr int32_t REPEAT_OCTAVE_PERCENT = 85;
+
+/// Frame lags within this share of the spectral estimate are tried.
+constexpr uint32_t REPEAT_SNAP_PERCENT = 15U;
+
+/// Repeat periods shorter than this many clocks are data structure.
+constexpr uint32_t MIN_REPEAT_UNITS = 8U;
+
+const int16_t *cosTable()
+{
+    // Written once on first use; a concurrent first call writes the same
+    // values.
+    static int16_t table[QUARTER + 1U];
+    static bool ready = false;
+    if (!ready)
+    {
+        for (size_t i = 0U; i <= QUARTER; ++i)
+        {
+            table[i] = static_cast<int16_t>(
+                std::lround(32767.0 * std::cos(2.0 * PI * i / TWIDDLE_N)));
+        }
+        ready = true;
+    }
+    return table;
+}
+
+/// cos(2π·i / TWIDDLE_N) in Q15 from the quarter-wave table.
+inline int32_t cosAt(const int16_t *tab, size_t i)
+{
+    if (i <= QUARTER)
+    {
+        return tab[i];
+    }
+    if (i <= 2U * QUARTER)
+    {
+        return -tab[2U * QUARTER - i];
+    }
+    if (i <= 3U * QUARTER)
+    {
+        return -tab[i - 2U * QUARTER];
+    }
+    return tab[4U * QUARTER - i];
+}
+
+inline int32_t sinAt(const int16_t *tab, size_t i)
+{
+    return cosAt(tab, (i + 3U * QUARTER) & (TWIDDLE_N - 1U));
+}
+
+inline int32_t absI(int32_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+/// Parabolic peak offset of y1 between y0 and y2, in 1/256 sample.
+int32_t peakOffsetQ8(int32_t y0, int32_t y1, int32_t y2)
+{
+    const int64_t denom = static_cast<int64_t>(y0) - 2 * static_cast<int64_t>(y1) + y2;
+    if (denom >= 0)
+    {
+        return 0; // not a maximum
+    }
+    const int64_t off = (128 * (static_cast<int64_t>(y0) - y2)) / denom;
+    return static_cast<int32_t>(std::clamp<int64_t>(off, -128, 128));
+}
+
+/// Least-squares clock from pulses already quantised to @p symbolQ8 µs.
+uint32_t polishClockQ8(const int32_t *pulses, size_t count, uint32_t symbolQ8)
+{
+    uint64_t sumUs = 0U;
+    uint64_t sumUnits = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const uint64_t us = static_cast<uint64_t>(absI(pulses[i]));
+        const uint64_t units = (us * 256U + symbolQ8 / 2U) / symbolQ8;
+        if (units == 0U || units > MAX_DATA_UNITS)
+        {
+            continue;
+        }
+        sumUs += us;
+        sumUnits += units;
+    }
+    return (sumUnits == 0U) ? symbolQ8 : static_cast<uint32_t>((sumUs * 256U + sumUnits / 2U) / sumUnits);
+}
+
+/**
+ * Snap a coarse frame period to a whole number of pulses: the even pulse
+ * lag whose span is within REPEAT_SNAP_PERCENT of @p estimateUs and whose
+ * pulses best match their counterparts one frame later.  Returns the mean
+ * span of that lag, or 0 if no lag matches within half a clock.
+ */
+uint32_t polishRepeat(const int32_t *pulses, size_t count, uint32_t estimateUs, uint32_t symbolUs)
+{
+    const uint64_t lo = static_cast<uint64_t>(estimateUs) * (100U - REPEAT_SNAP_PERCENT) / 100U;
+    const uint64_t hi = static_cast<uint64_t>(estimateUs) * (100U + REPEAT_SNAP_PERCENT) / 100U;
+    uint64_t bestDiff = static_cast<uint64_t>(symbolUs) / 2U;
+    uint32_t best = 0U;
+
+    uint64_t span = 0U;
+    for (size_t m = 1U; m < count; ++m)
+    {
+        span += static_cast<uint32_t>(absI(pulses[m - 1U]));
+        if (span > hi)
+        {
+            break;
+        }
+        if ((m & 1U) != 0U || span < lo)
+        {
+            continue;
+        }
+        // Mean pulse mismatch and mean window span at lag m.
+        uint64_t diff = 0U;
+        uint64_t window = span;
+        uint64_t windows = span;
+        for (size_t i = 0U; i + m < count; ++i)
+        {
+            diff += static_cast<uint32_t>(absI(pulses[i + m] - pulses[i]));
+            window += static_cast<uint32_t>(absI(pulses[i + m]));
+            window -= static_cast<uint32_t>(absI(pulses[i]));
+            windows += window;
+        }
+        const uint64_t n = count - m;
+        if (diff / n < bestDiff)
+        {
+            bestDiff = diff / n;
+            best = static_cast<uint32_t>(windows / (n + 1U));
+        }
+    }
+    return best;
+}
+
+struct Coding
+{
+    ModulationHint hint;
+    uint32_t bitUnits;
+};
+
+size_t distinctUnits(const uint16_t *hist)
+{
+    uint32_t total = 0U;
+    for (uint32_t u = 1U; u <= MAX_DATA_UNITS; ++u)
+    {
+        total += hist[u];
+    }
+    size_t n = 0U;
+    for (uint32_t u = 1U; u <= MAX_DATA_UNITS; ++u)
+    {
+        n += (total != 0U && hist[u] * 10U >= total) ? 1U : 0U;
+    }
+    return n;
+}
+
+/// Histogram of adjacent mark + space sums (one bit period for PWM / PPM).
+struct PairHistogram
+{
+    uint16_t sums[2U * MAX_DATA_UNITS + 1U];
+    uint32_t pairs;
+    uint32_t total;
+
+    void add(uint32_t units)
+    {
+        ++sums[units];
+        ++pairs;
+        total += units;
+    }
+
+    uint32_t mode() const
+    {
+        uint32_t m = 0U;
+        for (uint32_t p = 1U; p <= 2U * MAX_DATA_UNITS; ++p)
+        {
+            m = (sums[p] > sums[m]) ? p : m;
+        }
+        return m;
+    }
+};
+
+Coding classify(const int32_t *pulses, size_t count, uint32_t symbolUs)
+{
+    uint16_t highs[MAX_DATA_UNITS + 1U] = {};
+    uint16_t lows[MAX_DATA_UNITS + 1U] = {};
+    // A bit may start with its mark (Princeton) or its space (HT6P20B);
+    // only the right phase gives a constant sum.
+    PairHistogram markFirst = {};
+    PairHistogram spaceFirst = {};
+    uint32_t prev = 0U;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const uint32_t us = static_cast<uint32_t>(absI(pulses[i]));
+        uint32_t units = (us + symbolUs / 2U) / symbolUs;
+        units = (units == 0U) ? 1U : units;
+        if (units > MAX_DATA_UNITS)
+        {
+            prev = 0U; // sync or gap breaks the pairing
+            continue;
+        }
+        if (pulses[i] > 0)
+        {
+            ++highs[units];
+            if (prev != 0U)
+            {
+                spaceFirst.add(prev + units);
+            }
+        }
+        else
+        {
+            ++lows[units];
+            if (prev != 0U)
+            {
+                markFirst.add(prev + units);
+            }
+        }
+        prev = units;
+    }
+
+    const size_t dh = distinctUnits(highs);
+    const size_t dl = distinctUnits(lows);
+    for (const PairHistogram *h : {&markFirst, &spaceFirst})
+    {
+        const uint32_t mode = h->mode();
+        if (h->pairs != 0U && dh == 2U && h->sums[mode] * 100U >= h->pairs * 80U)
+        {
+            return {ModulationHint::PWM, mode};
+        }
+    }
+    if (markFirst.pairs != 0U && dh == 1U && dl >= 2U)
+    {
+        return {ModulationHint::PPM, (markFirst.total + markFirst.pairs / 2U) / markFirst.pairs};
+    }
+    bool halfBits = highs[1] != 0U && highs[2] != 0U && lows[1] != 0U && lows[2] != 0U;
+    for (uint32_t u = 3U; u <= MAX_DATA_UNITS; ++u)
+    {
+        halfBits = halfBits && highs[u] == 0U && lows[u] == 0U;
+    }
+    if (halfBits)
+    {
+        return {ModulationHint::MANCHESTER, 2U};
+    }
+    if (dh + dl >= 3U)
+    {
+        return {ModulationHint::NRZ, 1U};
+    }
+    return {ModulationHint::UNKNOWN, 1U};
+}
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── Kernels ─────────────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+int fftQ15(Cq15 *x, uint8_t log2n, bool inverse)
+{
+    if (log2n == 0U || log2n > FFT_MAX_LOG2)
+    {
+        return -1;
+    }
+    const size_t n = 1U << log2n;
+    const int16_t *tab = cosTable();
+
+    // Bit-reversal permutation.
+    for (size_t i = 1U, j = 0U; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; (j & bit) != 0U; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            std::swap(x[i], x[j]);
+        }
+    }
+
+    int32_t peak = 0;
+    for (size_t i = 0U; i < n; ++i)
+    {
+        peak = std::max(peak, std::max(absI(x[i].re), absI(x[i].im)));
+    }
+
+    // |a ± w·b| ≤ |a| + |b|: a halved stage never grows the magnitude, and
+    // an unhalved one starts below √2·FFT_HEADROOM.  Magnitudes therefore
+    // stay under √2·16384 and every component fits in int16.
+    int shifts = 0;
+    for (size_t len = 2U; len <= n; len <<= 1)
+    {
+        const bool scale = peak >= FFT_HEADROOM;
+        const int down = scale ? 1 : 0;
+        shifts += down;
+        peak = 0;
+
+        const size_t half = len >> 1;
+        const size_t step = TWIDDLE_N / len;
+        for (size_t k = 0U; k < half; ++k)
+        {
+            const int32_t wr = cosAt(tab, k * step);
+            const int32_t ws = sinAt(tab, k * step);
+            const int32_t wi = inverse ? ws : -ws;
+            for (size_t start = k; start < n; start += len)
+            {
+                Cq15 &a = x[start];
+                Cq15 &b = x[start + half];
+                const int32_t vr = (b.re * wr - b.im * wi + (1 << 14)) >> 15;
+                const int32_t vi = (b.re * wi + b.im * wr + (1 << 14)) >> 15;
+                const int32_t ar = (a.re + vr) >> down;
+                const int32_t ai = (a.im + vi) >> down;
+                const int32_t br = (a.re - vr) >> down;
+                const int32_t bi = (a.im - vi) >> down;
+                a.re = static_cast<int16_t>(ar);
+                a.im = static_cast<int16_t>(ai);
+                b.re = static_cast<int16_t>(br);
+                b.im = static_cast<int16_t>(bi);
+                peak = std::max(peak, std::max(std::max(absI(ar), absI(ai)),
+                                               std::max(absI(br), absI(bi))));
+            }
+        }
+    }
+    return shifts;
+}
+
+int32_t goertzelCoeffQ14(uint32_t periodQ8)
+{
+    const double w = 2.0 * PI * 256.0 / static_cast<double>(periodQ8);
+    return static_cast<int32_t>(std::lround(2.0 * std::cos(w) * 16384.0));
+}
+
+uint64_t goertzelPower(const int16_t *x, size_t n, int32_t coeffQ14)
+{
+    int64_t s1 = 0;
+    int64_t s2 = 0;
+    for (size_t i = 0U; i < n; ++i)
+    {
+        const int64_t s0 = x[i] + ((coeffQ14 * s1) >> 14) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    const int64_t p = s1 * s1 + s2 * s2 - ((coeffQ14 * s1) >> 14) * s2;
+    return (p > 0) ? static_cast<uint64_t>(p) : 0U;
+}
+
+const char *modulationHintName(ModulationHint hint)
+{
+    switch (hint)
+    {
+    case ModulationHint::PWM:        return "PWM";
+    case ModulationHint::PPM:        return "PPM";
+    case ModulationHint::MANCHESTER: return "Manch";
+    case ModulationHint::NRZ:        return "NRZ";
+    default:                         return "?";
+    }
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── PulseSpectrum ───────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+PulseSpectrum::PulseSpectrum()
+    : work_{},
+      density_{},
+      autocorr_{}
+{
+}
+
+void PulseSpectrum::binEdges(const int32_t *pulses, size_t count, uint32_t binUs)
+{
+    // autocorr_ is free until autocorrelate() overwrites it.
+    int32_t *counts = autocorr_;
+    std::fill(counts, counts + WINDOW_BINS, 0);
+
+    uint64_t t = 0U;
+    size_t used = 0U;
+    int64_t sum = 0;
+    for (size_t i = 0U; i <= count; ++i)
+    {
+        const uint64_t bin = t / binUs;
+        if (bin >= WINDOW_BINS)
+        {
+            break;
+        }
+        ++counts[bin]; // the edge starting pulse i
+        ++sum;
+        used = static_cast<size_t>(bin) + 1U;
+        if (i < count)
+        {
+            t += static_cast<uint32_t>(absI(pulses[i]));
+        }
+    }
+
+    // Remove the mean over the captured span (scaled by `used` to stay in
+    // integers): the autocorrelation becomes an autocovariance, so a dense
+    // frame no longer looks like a peak at every short lag.
+    int64_t most = 0;
+    for (size_t i = 0U; i < used; ++i)
+    {
+        const int64_t c = static_cast<int64_t>(counts[i]) * static_cast<int64_t>(used) - sum;
+        most = std::max(most, (c < 0) ? -c : c);
+    }
+    for (size_t i = 0U; i < WINDOW_BINS; ++i)
+    {
+        const int64_t c = static_cast<int64_t>(counts[i]) * static_cast<int64_t>(used) - sum;
+        density_[i] = static_cast<int16_t>((i >= used || most == 0) ? 0 : c * DENSITY_FULL / most);
+    }
+}
+
+void PulseSpectrum::autocorrelate()
+{
+    Cq15 *x = work_.bins;
+    for (size_t i = 0U; i < FFT_SIZE; ++i)
+    {
+        x[i].re = (i < WINDOW_BINS) ? density_[i] : 0;
+        x[i].im = 0;
+    }
+    (void)fftQ15(x, FFT_LOG2, false);
+
+    // Power spectrum, normalised back into the FFT input range.
+    int32_t pmax = 0;
+    for (size_t k = 0U; k < FFT_SIZE; ++k)
+    {
+        const int32_t p = x[k].re * x[k].re + x[k].im * x[k].im;
+        pmax = std::max(pmax, p);
+        work_.durations[k] = static_cast<uint32_t>(p);
+    }
+    int shift = 0;
+    while ((pmax >> shift) > DENSITY_FULL)
+    {
+        ++shift;
+    }
+    for (size_t k = 0U; k < FFT_SIZE; ++k)
+    {
+        const int32_t p = static_cast<int32_t>(work_.durations[k]) >> shift;
+        x[k].re = static_cast<int16_t>(p);
+        x[k].im = 0;
+    }
+    (void)fftQ15(x, FFT_LOG2, true);
+
+    for (size_t lag = 0U; lag < WINDOW_BINS; ++lag)
+    {
+        autocorr_[lag] = x[lag].re;
+    }
+}
+
+uint32_t PulseSpectrum::refineClock(uint32_t lagQ8) const
+{
+    uint32_t best = lagQ8;
+    uint64_t bestPower = 0U;
+    for (size_t k = 0U; k < GOERTZEL_BANK; ++k)
+    {
+        // Candidates span lag ± half a bin.
+        const uint32_t periodQ8 = lagQ8 - 128U + static_cast<uint32_t>(k * 256U / (GOERTZEL_BANK - 1U));
+        if (periodQ8 < 2U * 256U)
+        {
+            continue;
+        }
+        const uint64_t p = goertzelPower(density_, WINDOW_BINS, goertzelCoeffQ14(periodQ8));
+        if (p > bestPower)
+        {
+            bestPower = p;
+            best = periodQ8;
+        }
+    }
+    return best;
+}
+
+bool PulseSpectrum::analyse(const int32_t *pulses, size_t count, PulseSpectrumResult *out)
+{
+    *out = {};
+    if (pulses == nullptr || count < MIN_PULSES)
+    {
+        return false;
+    }
+
+    // Bin width: a quarter of the 10th-percentile pulse, so the shortest
+    // real symbols span several bins while noise cannot shrink the bins.
+    const size_t n = std::min(count, FFT_SIZE);
+    for (size_t i = 0U; i < n; ++i)
+    {
+        work_.durations[i] = static_cast<uint32_t>(absI(pulses[i]));
+    }
+    std::nth_element(work_.durations, work_.durations + n / 10U, work_.durations + n);
+    const uint32_t binUs = std::max<uint32_t>(1U, work_.durations[n / 10U] / 4U);
+    out->binUs = binUs;
+
+    binEdges(pulses, count, binUs);
+    autocorrelate();
+    const int32_t r0 = autocorr_[0];
+    if (r0 <= 0)
+    {
+        return false;
+    }
+
+    // ── Clock: first strong local maximum ────────────────────────────────
+    int32_t rmax = 0;
+    for (size_t lag = 2U; lag < WINDOW_BINS; ++lag)
+    {
+        rmax = std::max(rmax, autocorr_[lag]);
+    }
+    size_t clockLag = 0U;
+    for (size_t lag = 2U; lag + 1U < WINDOW_BINS; ++lag)
+    {
+        const int32_t r = autocorr_[lag];
+        if (r * 100 >= rmax * CLOCK_PEAK_PERCENT && r >= autocorr_[lag - 1U] &&
+            r > autocorr_[lag + 1U])
+        {
+            clockLag = lag;
+            break;
+        }
+    }
+    if (clockLag == 0U || rmax <= 0)
+    {
+        return false;
+    }
+    out->clockPermille = static_cast<uint16_t>(autocorr_[clockLag] * 1000 / r0);
+
+    const uint32_t lagQ8 = static_cast<uint32_t>(
+        static_cast<int32_t>(clockLag * 256U) +
+        peakOffsetQ8(autocorr_[clockLag - 1U], autocorr_[clockLag], autocorr_[clockLag + 1U]));
+    uint32_t symbolQ8 = refineClock(lagQ8) * binUs;
+    symbolQ8 = polishClockQ8(pulses, count, symbolQ8);
+    symbolQ8 = polishClockQ8(pulses, count, symbolQ8);
+    out->symbolUs = (symbolQ8 + 128U) / 256U;
+    if (out->symbolUs == 0U)
+    {
+        return false;
+    }
+
+    const Coding coding = classify(pulses, count, out->symbolUs);
+    out->hint = coding.hint;
+    out->bitUs = (symbolQ8 * coding.bitUnits + 128U) / 256U;
+    out->bitRateBps = (out->bitUs == 0U) ? 0U : (1000000U + out->bitUs / 2U) / out->bitUs;
+
+    // ── Repetition: strongest peak past the first zero crossing ──────────
+    uint64_t spanUs = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        spanUs += static_cast<uint32_t>(absI(pulses[i]));
+    }
+    // At the clock resolution a frame must beat the clock's own harmonics.
+    int32_t harmonicFloor = autocorr_[clockLag];
+    uint32_t repeatBinUs = binUs;
+    if (spanUs >= static_cast<uint64_t>(WINDOW_BINS) * binUs)
+    {
+        // Whole clocks per bin, so the clock itself cannot alias into a
+        // slow beat that looks like a frame period.
+        const uint64_t minBin = spanUs / WINDOW_BINS + 1U;
+        const uint64_t clocks = (minBin + out->symbolUs - 1U) / out->symbolUs;
+        repeatBinUs = static_cast<uint32_t>(clocks * out->symbolUs);
+        binEdges(pulses, count, repeatBinUs);
+        autocorrelate();
+        harmonicFloor = 0;
+    }
+    const int32_t rr0 = autocorr_[0];
+    size_t minLag = std::max<size_t>(2U, MIN_REPEAT_UNITS * out->symbolUs / repeatBinUs + 1U);
+    while (minLag < WINDOW_BINS && autocorr_[minLag - 1U] > 0)
+    {
+        ++minLag; // still inside the lag-0 lobe
+    }
+    // The strongest peak may be a multiple of the frame: take the first
+    // peak that comes close to it.
+    int32_t strongest = 0;
+    for (size_t lag = minLag; lag + 1U < WINDOW_BINS; ++lag)
+    {
+        const int32_t r = autocorr_[lag];
+        if (r >= autocorr_[lag - 1U] && r > autocorr_[lag + 1U])
+        {
+            strongest = std::max(strongest, r);
+        }
+    }
+    size_t repeatLag = 0U;
+    for (size_t lag = minLag; strongest > 0 && lag + 1U < WINDOW_BINS; ++lag)
+    {
+        const int32_t r = autocorr_[lag];
+        if (r >= autocorr_[lag - 1U] && r > autocorr_[lag + 1U] &&
+            r * 100 >= strongest * REPEAT_OCTAVE_PERCENT)
+        {
+            repeatLag = lag;
+            break;
+        }
+    }
+    if (rr0 > 0 && repeatLag != 0U && autocorr_[repeatLag] > harmonicFloor &&
+        autocorr_[repeatLag] * 1000 >= rr0 * REPEAT_PEAK_PERMILLE)
+    {
+        const int32_t off = peakOffsetQ8(autocorr_[repeatLag - 1U], autocorr_[repeatLag],
+                                         autocorr_[repeatLag + 1U]);
+        const uint32_t coarseUs = static_cast<uint32_t>(
+            (static_cast<int64_t>(repeatLag * 256U) + off) * repeatBinUs / 256);
+        uint32_t repeatUs = polishRepeat(pulses, count, coarseUs, out->symbolUs);
+        // Two frames also repeat: keep halving while the half still matches.
+        while (repeatUs != 0U)
+        {
+            const uint32_t half = polishRepeat(pulses, count, repeatUs / 2U, out->symbolUs);
+            if (half == 0U)
+            {
+                break;
+            }
+            repeatUs = half;
+        }
+        out->repeatUs = (repeatUs != 0U) ? repeatUs : coarseUs;
+        out->repeatPermille = static_cast<uint16_t>(autocorr_[repeatLag] * 1000 / rr0);
+    }
+    return true;
+}
+
+} // namespace hackos::radio
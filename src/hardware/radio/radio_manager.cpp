@@ -3,9 +3,18 @@
 #include <cstring>
 
 #include "hardware/radio/radio_protocol.h"
+#include "ui/view_animator.h"
 
 namespace hackos::radio {
 
+namespace
+{
+
+constexpr const char *SCRATCH_CAPTURE = "radio_rx";
+constexpr const char *SCRATCH_TX = "radio_tx";
+
+} // namespace
+
 RadioManager &RadioManager::instance()
 {
     static RadioManager mgr;
@@ -17,13 +26,19 @@ RadioManager::RadioManager()
       deviceCount_(0U),
       activeDevice_(nullptr),
       rawRing_(),
-      workerBuf_{},
+      capture_(),
       workerBufLen_(0U),
-      txBuf_{},
       readBuf_{},
       lastRecord_{},
-      hasLast_(false)
+      hasLast_(false),
+      spectrum_(),
+      lastAnalysis_{},
+      hasAnalysis_(false)
 {
+    // The sample window, a transmit and a scene transition can overlap.
+    static_assert(core::scratchFootprint<CaptureScratch, TxScratch, ui::ViewAnimator::Scenes>() <=
+                      core::Scratch::CAPACITY,
+                  "radio scratch budget");
     lastRecord_.clear();
 }
 
@@ -66,8 +81,13 @@ bool RadioManager::startCapture(IRxTxDevice *device)
     // Stop any previous session.
     stopCapture();
 
+    if (!capture_.acquire(SCRATCH_CAPTURE))
+    {
+        return false;
+    }
     if (!device->startReceive())
     {
+        capture_.release();
         return false;
     }
 
@@ -84,6 +104,7 @@ void RadioManager::stopCapture()
         activeDevice_->stop();
         activeDevice_ = nullptr;
     }
+    capture_.release();
 }
 
 bool RadioManager::isCapturing() const
@@ -118,7 +139,12 @@ bool RadioManager::transmit(const SignalRecord &record)
     }
 
     // Encode the signal into raw timings.
-    const size_t len = proto->encode(record, txBuf_, MAX_RAW_SAMPLES);
+    core::ScratchLease<TxScratch> tx;
+    if (!tx.acquire(SCRATCH_TX))
+    {
+        return false;
+    }
+    const size_t len = proto->encode(record, tx->timings, MAX_RAW_SAMPLES);
     if (len == 0U)
     {
         return false;
@@ -129,7 +155,7 @@ bool RadioManager::transmit(const SignalRecord &record)
         return false;
     }
 
-    const bool ok = dev->write(reinterpret_cast<const uint8_t *>(txBuf_),
+    const bool ok = dev->write(reinterpret_cast<const uint8_t *>(tx->timings),
                                len * sizeof(int32_t));
     dev->stop();
     return ok;
@@ -147,6 +173,16 @@ const SignalRecord &RadioManager::lastRecord() const
     return lastRecord_;
 }
 
+bool RadioManager::hasAnalysis() const
+{
+    return hasAnalysis_;
+}
+
+const PulseSpectrumResult &RadioManager::lastAnalysis() const
+{
+    return lastAnalysis_;
+}
+
 // ── Worker task ──────────────────────────────────────────────────────────────
 
 void RadioManager::workerEntry(void * /*param*/)
@@ -162,10 +198,11 @@ void RadioManager::workerEntry(void * /*param*/)
 
 void RadioManager::processBuffer()
 {
-    if (activeDevice_ == nullptr)
+    if (activeDevice_ == nullptr || !capture_)
     {
         return;
     }
+    int32_t *const workerBuf = capture_->samples;
 
     // Poll device for new data and push into ring buffer.
     const size_t got = activeDevice_->read(readBuf_, sizeof(readBuf_));
@@ -185,7 +222,7 @@ void RadioManager::processBuffer()
     {
         if (workerBufLen_ < MAX_RAW_SAMPLES)
         {
-            workerBuf_[workerBufLen_++] = sample;
+            workerBuf[workerBufLen_++] = sample;
         }
         else
         {
@@ -200,10 +237,10 @@ void RadioManager::processBuffer()
     }
 
     // Try to decode the accumulated samples.
-    SignalRecord record;
+    SignalRecord &record = capture_->decoded;
     record.clear();
     RadioProtocol *matched = ProtocolRegistry::tryDecodeAll(
-        workerBuf_, workerBufLen_, record);
+        workerBuf, workerBufLen_, record);
 
     if (matched != nullptr)
     {
@@ -211,6 +248,18 @@ void RadioManager::processBuffer()
         hasLast_ = true;
         workerBufLen_ = 0U; // Consume the buffer on successful decode.
     }
+    else if (workerBufLen_ == MAX_RAW_SAMPLES)
+    {
+        // A full buffer no protocol recognises: estimate its timing so the
+        // UI can still show clock / bit rate, then start a fresh window.
+        PulseSpectrumResult result;
+        if (spectrum_.analyse(workerBuf, workerBufLen_, &result))
+        {
+            lastAnalysis_ = result;
+            hasAnalysis_ = true;
+        }
+        workerBufLen_ = 0U;
+    }
 }
 
 } // namespace hackos::radio
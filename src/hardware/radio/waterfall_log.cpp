@@ -0,0 +1,656 @@
+/**
+ * @file waterfall_log.cpp
+ * @brief Waterfall recording and playback (see waterfall_log.h).
+ */
+
+#include "hardware/radio/waterfall_log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hackos::radio {
+
+namespace {
+
+constexpr uint8_t WFL_MAGIC[4] = {'H', 'W', 'F', 'L'};
+constexpr uint8_t WFIX_MAGIC[4] = {'W', 'F', 'I', 'X'};
+
+constexpr uint8_t TAG_KEY = 0xFFU;
+constexpr uint8_t TAG_RAW = 0xFEU;
+constexpr uint8_t TAG_SAME = 0x80U;        ///< 0x80 + (n - 1)
+constexpr uint8_t MAX_SAME = 0xFDU - TAG_SAME + 1U;
+constexpr uint8_t MAX_DELTA = 0x7FU;      ///< Largest DELTA tag a reader accepts
+
+/// Index entries per source read while loading the table.
+constexpr size_t IO_ENTRIES = 8U;
+
+void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, static_cast<uint16_t>(v));
+    put16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t get16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(get16(p)) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+size_t rowBytesFor(uint8_t bpp, uint16_t width)
+{
+    return (static_cast<size_t>(width) * bpp + 7U) / 8U;
+}
+
+/**
+ * Offer keyframe number @p keyNo to a bounded index.  Only every
+ * @p stride-th keyframe is kept; a full table drops every other entry and
+ * doubles the stride.
+ */
+void indexKeyframe(WfIndexEntry *index, size_t cap, size_t *count, uint32_t *stride,
+                   uint32_t keyNo, const WfIndexEntry &entry)
+{
+    if (keyNo % *stride != 0U)
+    {
+        return;
+    }
+    if (*count == cap)
+    {
+        size_t kept = 0U;
+        for (size_t i = 0U; i < *count; i += 2U)
+        {
+            index[kept++] = index[i];
+        }
+        *count = kept;
+        *stride *= 2U;
+        if (keyNo % *stride != 0U)
+        {
+            return;
+        }
+    }
+    index[(*count)++] = entry;
+}
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── WaterfallRecorder ───────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+WaterfallRecorder::WaterfallRecorder()
+    : sink_(nullptr),
+      index_(nullptr),
+      indexCap_(0U),
+      indexCount_(0U),
+      keyStride_(1U),
+      keyframes_(0U),
+      keyEvery_(WFL_KEY_EVERY),
+      rowBytes_(0U),
+      rows_(0U),
+      bytes_(0U),
+      same_(0U),
+      prev_{}
+{
+}
+
+bool WaterfallRecorder::begin(WfByteSink &sink, uint8_t bpp, uint16_t width, uint16_t keyEvery,
+                              uint32_t startMs, WfIndexEntry *index, size_t indexCap)
+{
+    const size_t rb = rowBytesFor(bpp, width);
+    if ((bpp != 1U && bpp != 2U) || rb == 0U || rb > WFL_MAX_ROW_BYTES || index == nullptr ||
+        indexCap < 2U)
+    {
+        return false;
+    }
+
+    sink_ = &sink;
+    index_ = index;
+    indexCap_ = indexCap;
+    indexCount_ = 0U;
+    keyStride_ = 1U;
+    keyframes_ = 0U;
+    keyEvery_ = (keyEvery == 0U) ? WFL_KEY_EVERY : keyEvery;
+    rowBytes_ = rb;
+    rows_ = 0U;
+    bytes_ = 0U;
+    same_ = 0U;
+
+    uint8_t hdr[WFL_HEADER_SIZE] = {};
+    std::memcpy(hdr, WFL_MAGIC, sizeof(WFL_MAGIC));
+    hdr[4] = WFL_VERSION;
+    hdr[5] = bpp;
+    put16(hdr + 6, width);
+    put16(hdr + 8, keyEvery_);
+    put32(hdr + 12, startMs);
+    if (!put(hdr, sizeof(hdr)))
+    {
+        sink_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool WaterfallRecorder::pushRow(const uint8_t *row, uint32_t ms)
+{
+    if (sink_ == nullptr)
+    {
+        return false;
+    }
+
+    if (rows_ % keyEvery_ == 0U)
+    {
+        if (!flushSame())
+        {
+            return false;
+        }
+        const WfIndexEntry entry{rows_, bytes_, ms};
+        uint8_t rec[1U + 4U + WFL_MAX_ROW_BYTES];
+        rec[0] = TAG_KEY;
+        put32(rec + 1, ms);
+        std::memcpy(rec + 5, row, rowBytes_);
+        if (!put(rec, 5U + rowBytes_))
+        {
+            return false;
+        }
+        indexKeyframe(index_, indexCap_, &indexCount_, &keyStride_, keyframes_++, entry);
+    }
+    else if (std::memcmp(row, prev_, rowBytes_) == 0)
+    {
+        if (++same_ == MAX_SAME && !flushSame())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (!flushSame())
+        {
+            return false;
+        }
+        size_t changed = 0U;
+        for (size_t i = 0U; i < rowBytes_; ++i)
+        {
+            changed += (row[i] != prev_[i]) ? 1U : 0U;
+        }
+        uint8_t rec[1U + WFL_MAX_ROW_BYTES];
+        bool ok;
+        if (2U * changed < rowBytes_) // cheaper than RAW
+        {
+            size_t len = 1U;
+            for (size_t i = 0U; i < rowBytes_; ++i)
+            {
+                if (row[i] != prev_[i])
+                {
+                    rec[len++] = static_cast<uint8_t>(i);
+                    rec[len++] = static_cast<uint8_t>(row[i] ^ prev_[i]);
+                }
+            }
+            rec[0] = static_cast<uint8_t>(changed);
+            ok = put(rec, len);
+        }
+        else
+        {
+            rec[0] = TAG_RAW;
+            std::memcpy(rec + 1, row, rowBytes_);
+            ok = put(rec, 1U + rowBytes_);
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    std::memcpy(prev_, row, rowBytes_);
+    ++rows_;
+    return true;
+}
+
+bool WaterfallRecorder::finish()
+{
+    if (sink_ == nullptr)
+    {
+        return false;
+    }
+    bool ok = flushSame();
+    const uint32_t indexOff = bytes_;
+    for (size_t i = 0U; ok && i < indexCount_; ++i)
+    {
+        uint8_t e[WFL_INDEX_SIZE];
+        put32(e, index_[i].row);
+        put32(e + 4, index_[i].offset);
+        put32(e + 8, index_[i].ms);
+        ok = put(e, sizeof(e));
+    }
+    if (ok)
+    {
+        uint8_t foot[WFL_FOOTER_SIZE];
+        put32(foot, indexOff);
+        put32(foot + 4, static_cast<uint32_t>(indexCount_));
+        put32(foot + 8, rows_);
+        std::memcpy(foot + 12, WFIX_MAGIC, sizeof(WFIX_MAGIC));
+        ok = put(foot, sizeof(foot));
+    }
+    sink_ = nullptr;
+    return ok;
+}
+
+bool WaterfallRecorder::put(const uint8_t *data, size_t len)
+{
+    if (!sink_->write(data, len))
+    {
+        return false;
+    }
+    bytes_ += static_cast<uint32_t>(len);
+    return true;
+}
+
+bool WaterfallRecorder::flushSame()
+{
+    if (same_ == 0U)
+    {
+        return true;
+    }
+    const uint8_t tag = static_cast<uint8_t>(TAG_SAME + same_ - 1U);
+    same_ = 0U;
+    return put(&tag, 1U);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// ── WaterfallPlayer ─────────────────────────────────────────────────────────
+// ═════════════════════════════════════════════════════════════════════════════
+
+WaterfallPlayer::WaterfallPlayer()
+    : source_(nullptr),
+      index_(nullptr),
+      indexCap_(0U),
+      indexCount_(0U),
+      keyStride_(1U),
+      bpp_(0U),
+      width_(0U),
+      rowBytes_(0U),
+      startMs_(0U),
+      rows_(0U),
+      dataEnd_(0U),
+      recovered_(false),
+      reads_(0U),
+      curRow_(0U),
+      curOff_(0U),
+      sameLeft_(0U),
+      prev_{},
+      window_{},
+      windowOff_(0U),
+      windowLen_(0U)
+{
+}
+
+bool WaterfallPlayer::open(WfByteSource &source, WfIndexEntry *index, size_t indexCap)
+{
+    close();
+    if (index == nullptr || indexCap < 2U)
+    {
+        return false;
+    }
+    source_ = &source;
+    index_ = index;
+    indexCap_ = indexCap;
+    dataEnd_ = source.size();
+
+    uint8_t hdr[WFL_HEADER_SIZE];
+    if (!bytesAt(0U, hdr, sizeof(hdr)) || std::memcmp(hdr, WFL_MAGIC, sizeof(WFL_MAGIC)) != 0 ||
+        hdr[4] != WFL_VERSION || (hdr[5] != 1U && hdr[5] != 2U))
+    {
+        close();
+        return false;
+    }
+    bpp_ = hdr[5];
+    width_ = get16(hdr + 6);
+    rowBytes_ = rowBytesFor(bpp_, width_);
+    startMs_ = get32(hdr + 12);
+    if (rowBytes_ == 0U || rowBytes_ > WFL_MAX_ROW_BYTES)
+    {
+        close();
+        return false;
+    }
+
+    // Finished recording: trust a footer that describes the file exactly.
+    const uint32_t size = source.size();
+    uint8_t foot[WFL_FOOTER_SIZE];
+    bool indexed = false;
+    if (size >= WFL_HEADER_SIZE + WFL_FOOTER_SIZE &&
+        bytesAt(size - WFL_FOOTER_SIZE, foot, sizeof(foot)) &&
+        std::memcmp(foot + 12, WFIX_MAGIC, sizeof(WFIX_MAGIC)) == 0)
+    {
+        const uint32_t indexOff = get32(foot);
+        const uint32_t count = get32(foot + 4);
+        indexed = indexOff >= WFL_HEADER_SIZE &&
+                  static_cast<uint64_t>(indexOff) + static_cast<uint64_t>(count) * WFL_INDEX_SIZE +
+                          WFL_FOOTER_SIZE == size;
+        if (indexed)
+        {
+            dataEnd_ = indexOff;
+            rows_ = get32(foot + 8);
+            uint8_t buf[IO_ENTRIES * WFL_INDEX_SIZE];
+            for (uint32_t i = 0U; indexed && i < count; i += IO_ENTRIES)
+            {
+                const size_t n = std::min<size_t>(IO_ENTRIES, count - i);
+                indexed = bytesAt(indexOff + i * WFL_INDEX_SIZE, buf, n * WFL_INDEX_SIZE);
+                for (size_t k = 0U; indexed && k < n; ++k)
+                {
+                    const uint8_t *e = buf + k * WFL_INDEX_SIZE;
+                    indexed = addIndex(i + static_cast<uint32_t>(k), get32(e), get32(e + 4),
+                                       get32(e + 8));
+                }
+            }
+        }
+    }
+    if (!indexed)
+    {
+        indexCount_ = 0U;
+        keyStride_ = 1U;
+        dataEnd_ = size;
+        if (!scanIndex())
+        {
+            close();
+            return false;
+        }
+        recovered_ = true;
+    }
+    if (indexCount_ == 0U || index_[0].row != 0U)
+    {
+        close();
+        return false;
+    }
+    curRow_ = rows_; // force a seek on the first render
+    return true;
+}
+
+void WaterfallPlayer::close()
+{
+    source_ = nullptr;
+    indexCount_ = 0U;
+    keyStride_ = 1U;
+    rows_ = 0U;
+    recovered_ = false;
+    reads_ = 0U;
+    curRow_ = 0U;
+    curOff_ = 0U;
+    sameLeft_ = 0U;
+    windowLen_ = 0U;
+}
+
+uint32_t WaterfallPlayer::msAt(uint32_t row) const
+{
+    const WfIndexEntry *key = keyBefore(row);
+    return (key == nullptr) ? startMs_ : key->ms;
+}
+
+size_t WaterfallPlayer::render(uint32_t first, uint16_t zoom, WfAggregate mode, uint8_t *out,
+                               size_t count)
+{
+    std::memset(out, 0, count * rowBytes_);
+    if (source_ == nullptr)
+    {
+        return 0U;
+    }
+    zoom = (zoom == 0U) ? 1U : zoom;
+    const uint8_t mask = static_cast<uint8_t>((1U << bpp_) - 1U);
+    const size_t perByte = 8U / bpp_;
+
+    size_t filled = 0U;
+    uint8_t row[WFL_MAX_ROW_BYTES];
+    uint16_t sums[WFL_MAX_ROW_BYTES * 8U];
+    for (size_t o = 0U; o < count; ++o)
+    {
+        const uint64_t r0 = static_cast<uint64_t>(first) + static_cast<uint64_t>(o) * zoom;
+        if (r0 >= rows_ || !seek(static_cast<uint32_t>(r0)))
+        {
+            break;
+        }
+        const uint32_t n = std::min<uint32_t>(zoom, rows_ - static_cast<uint32_t>(r0));
+        uint8_t *dst = out + o * rowBytes_;
+
+        std::fill(sums, sums + rowBytes_ * perByte, static_cast<uint16_t>(0U));
+        for (uint32_t k = 0U; k < n; ++k)
+        {
+            if (!nextRow(row))
+            {
+                return filled;
+            }
+            for (size_t b = 0U; b < rowBytes_; ++b)
+            {
+                for (size_t p = 0U; p < perByte; ++p)
+                {
+                    const uint16_t v = (row[b] >> (p * bpp_)) & mask;
+                    uint16_t &s = sums[b * perByte + p];
+                    s = (mode == WfAggregate::MAX) ? std::max(s, v) : static_cast<uint16_t>(s + v);
+                }
+            }
+        }
+        for (size_t b = 0U; b < rowBytes_; ++b)
+        {
+            uint8_t packed = 0U;
+            for (size_t p = 0U; p < perByte; ++p)
+            {
+                uint32_t v = sums[b * perByte + p];
+                if (mode == WfAggregate::MEAN)
+                {
+                    v = (v * 2U + n) / (2U * n); // round half up
+                }
+                packed = static_cast<uint8_t>(packed | ((v & mask) << (p * bpp_)));
+            }
+            dst[b] = packed;
+        }
+        ++filled;
+    }
+    return filled;
+}
+
+bool WaterfallPlayer::scanIndex()
+{
+    // One pass over the records: index the keyframes and stop at the first
+    // record that is cut off.
+    uint32_t off = WFL_HEADER_SIZE;
+    uint32_t keyNo = 0U;
+    rows_ = 0U;
+    while (off < dataEnd_)
+    {
+        uint8_t tag;
+        if (!byteAt(off, &tag))
+        {
+            break;
+        }
+        uint32_t len;
+        uint32_t adds = 1U;
+        if (tag == TAG_KEY)
+        {
+            len = 5U + static_cast<uint32_t>(rowBytes_);
+        }
+        else if (tag == TAG_RAW)
+        {
+            len = 1U + static_cast<uint32_t>(rowBytes_);
+        }
+        else if (tag >= TAG_SAME)
+        {
+            len = 1U;
+            adds = tag - TAG_SAME + 1U;
+        }
+        else if (tag != 0U)
+        {
+            len = 1U + 2U * tag;
+        }
+        else
+        {
+            break; // not a record: the file is damaged from here
+        }
+        if (static_cast<uint64_t>(off) + len > dataEnd_)
+        {
+            break;
+        }
+        if (tag == TAG_KEY)
+        {
+            uint8_t ms[4];
+            if (!bytesAt(off + 1U, ms, sizeof(ms)))
+            {
+                break;
+            }
+            const WfIndexEntry entry{rows_, off, get32(ms)};
+            indexKeyframe(index_, indexCap_, &indexCount_, &keyStride_, keyNo++, entry);
+        }
+        else if (rows_ == 0U)
+        {
+            break; // must start with a keyframe
+        }
+        rows_ += adds;
+        off += len;
+    }
+    dataEnd_ = off;
+    return rows_ != 0U;
+}
+
+bool WaterfallPlayer::addIndex(uint32_t keyNo, uint32_t row, uint32_t offset, uint32_t ms)
+{
+    if (offset < WFL_HEADER_SIZE || offset >= dataEnd_ || row >= rows_ ||
+        (indexCount_ != 0U && row <= index_[indexCount_ - 1U].row))
+    {
+        return false;
+    }
+    // A footer index larger than the table is thinned like a live one.
+    const WfIndexEntry entry{row, offset, ms};
+    indexKeyframe(index_, indexCap_, &indexCount_, &keyStride_, keyNo, entry);
+    return true;
+}
+
+const WfIndexEntry *WaterfallPlayer::keyBefore(uint32_t row) const
+{
+    const WfIndexEntry *first = index_;
+    const WfIndexEntry *it = std::upper_bound(
+        first, first + indexCount_, row,
+        [](uint32_t r, const WfIndexEntry &e) { return r < e.row; });
+    return (it == first) ? nullptr : it - 1;
+}
+
+bool WaterfallPlayer::seek(uint32_t row)
+{
+    if (row >= rows_)
+    {
+        return false;
+    }
+    if (row == curRow_)
+    {
+        return true;
+    }
+    const WfIndexEntry *key = keyBefore(row); // index_[0] is row 0
+
+    // Continue from the cursor when it is between the keyframe and the row.
+    if (!(curRow_ < row && curRow_ >= key->row))
+    {
+        curRow_ = key->row;
+        curOff_ = key->offset;
+        sameLeft_ = 0U;
+    }
+    uint8_t skip[WFL_MAX_ROW_BYTES];
+    while (curRow_ < row)
+    {
+        if (!nextRow(skip))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WaterfallPlayer::nextRow(uint8_t *row)
+{
+    if (sameLeft_ == 0U)
+    {
+        uint8_t tag;
+        if (curOff_ >= dataEnd_ || !byteAt(curOff_, &tag))
+        {
+            return false;
+        }
+        if (tag == TAG_KEY)
+        {
+            if (!bytesAt(curOff_ + 5U, prev_, rowBytes_))
+            {
+                return false;
+            }
+            curOff_ += 5U + static_cast<uint32_t>(rowBytes_);
+        }
+        else if (tag == TAG_RAW)
+        {
+            if (!bytesAt(curOff_ + 1U, prev_, rowBytes_))
+            {
+                return false;
+            }
+            curOff_ += 1U + static_cast<uint32_t>(rowBytes_);
+        }
+        else if (tag >= TAG_SAME)
+        {
+            sameLeft_ = static_cast<uint8_t>(tag - TAG_SAME + 1U);
+            curOff_ += 1U;
+        }
+        else
+        {
+            uint8_t pairs[2U * MAX_DELTA];
+            const size_t len = 2U * tag;
+            if (tag == 0U || !bytesAt(curOff_ + 1U, pairs, len))
+            {
+                return false;
+            }
+            for (size_t i = 0U; i < len; i += 2U)
+            {
+                if (pairs[i] >= rowBytes_)
+                {
+                    return false;
+                }
+                prev_[pairs[i]] ^= pairs[i + 1U];
+            }
+            curOff_ += 1U + static_cast<uint32_t>(len);
+        }
+    }
+    if (sameLeft_ != 0U)
+    {
+        --sameLeft_;
+    }
+    std::memcpy(row, prev_, rowBytes_);
+    ++curRow_;
+    return true;
+}
+
+bool WaterfallPlayer::byteAt(uint32_t offset, uint8_t *b)
+{
+    return bytesAt(offset, b, 1U);
+}
+
+bool WaterfallPlayer::bytesAt(uint32_t offset, uint8_t *buf, size_t len)
+{
+    if (len > WINDOW)
+    {
+        ++reads_;
+        return source_->readAt(offset, buf, len) == len;
+    }
+    if (windowLen_ == 0U || offset < windowOff_ || offset + len > windowOff_ + windowLen_)
+    {
+        ++reads_;
+        windowOff_ = offset;
+        windowLen_ = source_->readAt(offset, window_, WINDOW);
+        if (windowLen_ < len)
+        {
+            windowLen_ = 0U;
+            return false;
+        }
+    }
+    std::memcpy(buf, window_ + (offset - windowOff_), len);
+    return true;
+}
+
+} // namespace hackos::radio
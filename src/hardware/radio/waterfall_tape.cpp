@@ -0,0 +1,270 @@
+/**
+ * @file waterfall_tape.cpp
+ * @brief Waterfall recording / playback on VirtualFS (see waterfall_tape.h).
+ */
+
+#include "hardware/radio/waterfall_tape.h"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <esp_log.h>
+
+#include "storage/vfs.h"
+
+static constexpr const char *TAG_WFT = "WaterfallTape";
+
+namespace hackos::radio {
+
+namespace {
+
+constexpr const char *WFL_DIR = "/ext/captures/waterfall";
+
+} // namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// FileSource
+// ═════════════════════════════════════════════════════════════════════════════
+
+bool WaterfallTape::FileSource::open(const char *path)
+{
+    close();
+    file_ = storage::VirtualFS::instance().open(path, "r");
+    if (!file_)
+    {
+        return false;
+    }
+    size_ = static_cast<uint32_t>(file_.size());
+    return true;
+}
+
+void WaterfallTape::FileSource::close()
+{
+    if (file_)
+    {
+        file_.close();
+    }
+    size_ = 0U;
+}
+
+size_t WaterfallTape::FileSource::readAt(uint32_t offset, uint8_t *buf, size_t len)
+{
+    if (!file_ || !file_.seek(offset))
+    {
+        return 0U;
+    }
+    return file_.read(buf, len);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// WaterfallTape
+// ═════════════════════════════════════════════════════════════════════════════
+
+WaterfallTape::WaterfallTape(const char *prefix)
+    : prefix_(prefix),
+      path_{},
+      sink_(),
+      source_(),
+      recorder_(),
+      player_(),
+      index_{},
+      top_(0U),
+      zoom_(1U),
+      mode_(WfAggregate::MAX)
+{
+}
+
+WaterfallTape::~WaterfallTape()
+{
+    stopRecording();
+    stopPlayback();
+}
+
+// ── Recording ────────────────────────────────────────────────────────────────
+
+bool WaterfallTape::startRecording(uint8_t bpp, uint16_t width)
+{
+    if (recording())
+    {
+        return true;
+    }
+    stopPlayback();
+
+    auto &vfs = storage::VirtualFS::instance();
+    vfs.mkdir("/ext/captures");
+    vfs.mkdir(WFL_DIR);
+    unsigned n = 0U;
+    for (; n < MAX_FILES; ++n)
+    {
+        std::snprintf(path_, sizeof(path_), "%s/%s_%03u.wfl", WFL_DIR, prefix_, n);
+        if (!vfs.exists(path_))
+        {
+            break;
+        }
+    }
+    if (n == MAX_FILES || !sink_.writer.begin(path_))
+    {
+        ESP_LOGE(TAG_WFT, "Cannot create waterfall file");
+        path_[0] = '\0';
+        return false;
+    }
+    if (!recorder_.begin(sink_, bpp, width, WFL_KEY_EVERY, millis(), index_, INDEX_ENTRIES))
+    {
+        sink_.writer.close();
+        (void)vfs.remove(path_);
+        path_[0] = '\0';
+        return false;
+    }
+    ESP_LOGI(TAG_WFT, "Recording waterfall to %s", path_);
+    return true;
+}
+
+void WaterfallTape::pushRow(const uint8_t *row)
+{
+    if (recording() && !recorder_.pushRow(row, millis()))
+    {
+        ESP_LOGE(TAG_WFT, "Write failed, recording stopped");
+        stopRecording();
+    }
+}
+
+void WaterfallTape::stopRecording()
+{
+    if (!recording())
+    {
+        return;
+    }
+    const uint32_t rows = recorder_.rows();
+    const bool ok = recorder_.finish() && sink_.writer.flush();
+    sink_.writer.close();
+    ESP_LOGI(TAG_WFT, "%s: %lu rows, %lu bytes%s", path_, static_cast<unsigned long>(rows),
+             static_cast<unsigned long>(recorder_.bytes()), ok ? "" : " (unfinished)");
+}
+
+// ── Playback ─────────────────────────────────────────────────────────────────
+
+bool WaterfallTape::newestPath(char *out, size_t len) const
+{
+    auto &vfs = storage::VirtualFS::instance();
+    bool found = false;
+    char path[sizeof(path_)];
+    for (unsigned n = 0U; n < MAX_FILES; ++n)
+    {
+        std::snprintf(path, sizeof(path), "%s/%s_%03u.wfl", WFL_DIR, prefix_, n);
+        if (!vfs.exists(path))
+        {
+            break;
+        }
+        std::snprintf(out, len, "%s", path);
+        found = true;
+    }
+    return found;
+}
+
+bool WaterfallTape::startPlayback()
+{
+    stopRecording();
+    stopPlayback();
+
+    // The file just recorded, otherwise the newest one on the card.
+    if (path_[0] == '\0' && !newestPath(path_, sizeof(path_)))
+    {
+        ESP_LOGW(TAG_WFT, "No %s_*.wfl recordings", prefix_);
+        return false;
+    }
+    if (!source_.open(path_) || !player_.open(source_, index_, INDEX_ENTRIES))
+    {
+        ESP_LOGE(TAG_WFT, "Cannot open %s", path_);
+        source_.close();
+        return false;
+    }
+    if (player_.recovered())
+    {
+        ESP_LOGW(TAG_WFT, "%s has no index, re-indexed %lu rows", path_,
+                 static_cast<unsigned long>(player_.rows()));
+    }
+    zoom_ = 1U;
+    top_ = (player_.rows() > 0U) ? player_.rows() - 1U : 0U;
+    return true;
+}
+
+void WaterfallTape::stopPlayback()
+{
+    if (player_.isOpen())
+    {
+        player_.close();
+        source_.close();
+    }
+}
+
+void WaterfallTape::scrub(int32_t lines)
+{
+    if (!playing() || player_.rows() == 0U)
+    {
+        return;
+    }
+    const int64_t target = static_cast<int64_t>(top_) + static_cast<int64_t>(lines) * zoom_;
+    const int64_t last = static_cast<int64_t>(player_.rows()) - 1;
+    top_ = static_cast<uint32_t>(target < 0 ? 0 : (target > last ? last : target));
+}
+
+void WaterfallTape::cycleZoom()
+{
+    zoom_ = (zoom_ >= MAX_ZOOM) ? 1U : static_cast<uint16_t>(zoom_ * 2U);
+}
+
+void WaterfallTape::toggleAggregate()
+{
+    mode_ = (mode_ == WfAggregate::MAX) ? WfAggregate::MEAN : WfAggregate::MAX;
+}
+
+uint32_t WaterfallTape::positionSec() const
+{
+    if (!playing())
+    {
+        return 0U;
+    }
+    return (player_.msAt(top_) - player_.startMs()) / 1000U;
+}
+
+void WaterfallTape::fill(uint8_t *rows, size_t rowBytes, size_t count)
+{
+    std::memset(rows, 0, rowBytes * count);
+    if (!playing() || player_.rows() == 0U || rowBytes != player_.rowBytes())
+    {
+        return;
+    }
+
+    // Lines are aligned to the top row; only the oldest one can be short.
+    // Render oldest-first in one forward decode, then flip to newest-first.
+    const uint32_t span = zoom_;
+    const uint32_t avail = top_ + 1U;
+    const size_t lines = std::min<size_t>(count, (avail + span - 1U) / span);
+    const uint32_t covered = static_cast<uint32_t>(lines) * span;
+    size_t done = 0U;
+    uint32_t first = 0U;
+    if (covered > avail)
+    {
+        const uint16_t partial = static_cast<uint16_t>(span - (covered - avail));
+        if (player_.render(0U, partial, mode_, rows, 1U) == 0U)
+        {
+            return;
+        }
+        done = 1U;
+        first = partial;
+    }
+    else
+    {
+        first = avail - covered;
+    }
+    done += player_.render(first, zoom_, mode_, rows + done * rowBytes, lines - done);
+
+    for (size_t i = 0U, j = done; i + 1U < j; ++i, --j)
+    {
+        std::swap_ranges(rows + i * rowBytes, rows + (i + 1U) * rowBytes,
+                         rows + (j - 1U) * rowBytes);
+    }
+}
+
+} // namespace hackos::radio
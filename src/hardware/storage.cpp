@@ -3,11 +3,80 @@
 #include <SD.h>
 #include <SPI.h>
 #include <cstring>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #include "config.h"
+#include "core/system_core.h"
+#include "storage/file_pool.h"
+#include "storage/spi_fs.h"
 
-// ── SPI Transaction Guard for shared bus ────────────────────────────────────
-static const SPISettings SD_SPI_SETTINGS(4000000, MSBFIRST, SPI_MODE0);
+static constexpr const char *TAG_STORAGE = "Storage";
+
+// ── Append handle pool ──────────────────────────────────────────────────────
+
+namespace
+{
+
+using hackos::core::BusPriority;
+using hackos::core::SpiClient;
+using hackos::core::SpiLease;
+using hackos::storage::FileHandlePool;
+using hackos::storage::sdFs;
+
+/// @brief SD files behind the pool, one per slot.
+class SdPoolFs final : public hackos::storage::PoolFs
+{
+public:
+    bool open(size_t slot, const char *path) override
+    {
+        files_[slot] = sdFs().open(path, FILE_APPEND);
+        return static_cast<bool>(files_[slot]);
+    }
+
+    size_t write(size_t slot, const uint8_t *data, size_t len) override
+    {
+        return files_[slot].write(data, len);
+    }
+
+    bool sync(size_t slot) override
+    {
+        files_[slot].flush();
+        return true;
+    }
+
+    void close(size_t slot) override { files_[slot].close(); }
+
+private:
+    File files_[FileHandlePool::SLOTS];
+};
+
+SdPoolFs g_sdPoolFs;
+FileHandlePool g_appendPool(g_sdPoolFs);
+
+/// @brief Serialises g_appendPool: the write-back task appends through it
+///        while the main loop runs tick() and apps read / list the card.
+class PoolLock
+{
+public:
+    PoolLock() { xSemaphoreTake(mutex(), portMAX_DELAY); }
+    ~PoolLock() { xSemaphoreGive(mutex()); }
+
+    PoolLock(const PoolLock &) = delete;
+    PoolLock &operator=(const PoolLock &) = delete;
+
+private:
+    static SemaphoreHandle_t mutex()
+    {
+        static StaticSemaphore_t buf;
+        static SemaphoreHandle_t handle = xSemaphoreCreateMutexStatic(&buf);
+        return handle;
+    }
+};
+
+} // namespace
 
 StorageManager &StorageManager::instance()
 {
@@ -17,7 +86,10 @@ StorageManager &StorageManager::instance()
 
 StorageManager::StorageManager()
     : mounted_(false),
-      lastError_("Not initialized")
+      lastError_("Not initialized"),
+      appendCount_(0U),
+      appendMaxUs_(0U),
+      appendTotalUs_(0U)
 {
 }
 
@@ -29,6 +101,7 @@ bool StorageManager::mount()
     }
 
     SPI.begin();
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
     if (!SD.begin(PIN_SD_CS, SPI))
     {
         lastError_ = "Failed to mount SD";
@@ -48,7 +121,15 @@ void StorageManager::unmount()
         return;
     }
 
-    SD.end();
+    {
+        PoolLock lock;
+        (void)g_appendPool.closeAll();
+    }
+    logStats();
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+        SD.end();
+    }
     SPI.end();
     mounted_ = false;
     lastError_ = "Unmounted";
@@ -71,7 +152,11 @@ size_t StorageManager::listDir(const char *path, DirEntry *entries, size_t maxEn
         return 0U;
     }
 
-    File dir = SD.open(path);
+    {
+        PoolLock lock;
+        (void)g_appendPool.syncAll();   // sizes of pooled files
+    }
+    File dir = sdFs().open(path);
     if (!dir || !dir.isDirectory())
     {
         if (dir)
@@ -110,7 +195,8 @@ bool StorageManager::writeFile(const char *path, const uint8_t *data, size_t len
         return false;
     }
 
-    File f = SD.open(path, FILE_WRITE);
+    (void)close(path);
+    File f = sdFs().open(path, FILE_WRITE);
     if (!f)
     {
         lastError_ = "writeFile: open failed";
@@ -137,23 +223,64 @@ bool StorageManager::appendChunk(const char *path, const uint8_t *data, size_t l
         return false;
     }
 
-    File f = SD.open(path, FILE_APPEND);
-    if (!f)
+    PoolLock lock;
+    const int64_t t0 = esp_timer_get_time();
+    const bool ok = g_appendPool.append(path, data, len, millis());
+    const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - t0);
+    ++appendCount_;
+    appendTotalUs_ += us;
+    appendMaxUs_ = (us > appendMaxUs_) ? us : appendMaxUs_;
+
+    if (!ok)
     {
-        lastError_ = "appendChunk: open failed";
+        lastError_ = "appendChunk: open/write failed";
         return false;
     }
+    lastError_ = "OK";
+    return true;
+}
 
-    const size_t written = f.write(data, len);
-    f.close();
+bool StorageManager::sync(const char *path)
+{
+    PoolLock lock;
+    return mounted_ && g_appendPool.sync(path);
+}
 
-    if (written != len)
+bool StorageManager::syncAll()
+{
+    PoolLock lock;
+    return mounted_ && g_appendPool.syncAll();
+}
+
+bool StorageManager::close(const char *path)
+{
+    PoolLock lock;
+    return g_appendPool.close(path);
+}
+
+void StorageManager::tick()
+{
+    if (mounted_)
     {
-        lastError_ = "appendChunk: short write";
-        return false;
+        PoolLock lock;
+        g_appendPool.tick(millis());
     }
-    lastError_ = "OK";
-    return true;
+}
+
+void StorageManager::logStats() const
+{
+    FileHandlePool::Stats st;
+    {
+        PoolLock lock;
+        st = g_appendPool.stats();
+    }
+    ESP_LOGI(TAG_STORAGE, "appends=%lu opens=%lu evictions=%lu writes=%lu syncs=%lu avg=%lu us max=%lu us",
+             static_cast<unsigned long>(st.appends), static_cast<unsigned long>(st.opens),
+             static_cast<unsigned long>(st.evictions), static_cast<unsigned long>(st.writes),
+             static_cast<unsigned long>(st.syncs),
+             static_cast<unsigned long>((appendCount_ > 0U) ? appendTotalUs_ / appendCount_ : 0U),
+             static_cast<unsigned long>(appendMaxUs_));
+    hackos::core::HardwareBus::spi().logStats();
 }
 
 bool StorageManager::readFile(const char *path, uint8_t *buf, size_t maxLen, size_t *bytesRead)
@@ -168,7 +295,8 @@ bool StorageManager::readFile(const char *path, uint8_t *buf, size_t maxLen, siz
         return false;
     }
 
-    File f = SD.open(path, FILE_READ);
+    (void)close(path);   // see appended data
+    File f = sdFs().open(path, FILE_READ);
     if (!f)
     {
         lastError_ = "readFile: open failed";
@@ -54,6 +54,8 @@
 #include "core/system_core.h"
 #include "hardware/display.h"
 #include "hardware/input.h"
+#include "hardware/radio/edge_rx_device.h"
+#include "hardware/radio/radio_manager.h"
 #include "hardware/storage.h"
 #include "storage/vfs.h"
 #include "storage/storage_init.h"
@@ -115,6 +117,11 @@ void setup()
     const bool xpOk = ExperienceManager::instance().init();
     ESP_LOGI(TAG, "ExperienceManager init: %s", xpOk ? "OK" : "FAIL");
 
+    // ── Radio devices (capture through the shared EdgeCapture ISR) ───────
+    static hackos::radio::EdgeRxDevice rf433Rx("RF433", PIN_RF_RX);
+    const bool rfOk = hackos::radio::RadioManager::instance().registerDevice(&rf433Rx);
+    ESP_LOGI(TAG, "RadioManager RF433: %s", rfOk ? "OK" : "FAIL");
+
     ESP_LOGI(TAG, "EventSystem init: %s", eventSystemOk ? "OK" : "FAIL");
     ESP_LOGI(TAG, "AppManager init: %s", appManagerOk ? "OK" : "FAIL");
 
@@ -188,5 +195,8 @@ void loop()
     // Let the PowerManager evaluate idle-timeout / sleep policy.
     hackos::core::PowerManager::instance().tick();
 
+    // Commit / close pooled SD append handles.
+    StorageManager::instance().tick();
+
     vTaskDelay(LOOP_DELAY_TICKS);
 }
@@ -1,8 +1,12 @@
 #include "storage/buffered_stream.h"
 
+#include <Arduino.h>
+#include <cstdio>
 #include <cstring>
 #include <esp_log.h>
+#include <new>
 
+#include "storage/crc32.h"
 #include "storage/vfs.h"
 
 static constexpr const char *TAG_BUF = "BufferedStream";
@@ -169,4 +173,128 @@ void BufferedWriter::close()
 
 size_t BufferedWriter::bytesWritten() const { return totalWritten_; }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// DurableWriter
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool DurableWriter::FileSink::write(const uint8_t *data, size_t len)
+{
+    return file.write(data, len) == len;
+}
+
+bool DurableWriter::FileSink::sync()
+{
+    file.flush();   // fflush + fsync: data and FAT directory entry
+    return true;
+}
+
+bool DurableWriter::FileSink::mark(uint32_t offset, const uint8_t *data, size_t len)
+{
+    if (!tracked)
+    {
+        return true;
+    }
+    // Trailer slots are rewritten in place: the sidecar stays MAX_SIDECAR.
+    const bool ok = sidecar.seek(offset, fs::SeekSet) && sidecar.write(data, len) == len;
+    sidecar.flush();
+    return ok;
+}
+
+DurableWriter::DurableWriter()
+    : buffer_(nullptr),
+      sidecarPath_{}
+{
+}
+
+DurableWriter::~DurableWriter()
+{
+    close();
+}
+
+bool DurableWriter::begin(const char *path, const DurabilityPolicy &policy, bool append,
+                          size_t bufferSize)
+{
+    close();
+
+    auto &vfs = VirtualFS::instance();
+    sink_.file = vfs.open(path, append ? "a" : "w");
+    if (!sink_.file)
+    {
+        ESP_LOGW(TAG_BUF, "durable: cannot open %s", path ? path : "(null)");
+        return false;
+    }
+    const uint32_t start = append ? static_cast<uint32_t>(sink_.file.size()) : 0U;
+
+    // Sidecar named after the capture path; RAM captures need none.
+    sink_.tracked = VirtualFS::resolveStorage(path) != StorageType::RAM && vfs.flashMounted() &&
+                    vfs.mkdir(VirtualFS::DURABLE_DIR);
+    if (sink_.tracked)
+    {
+        std::snprintf(sidecarPath_, sizeof(sidecarPath_), "%s/%08lX", VirtualFS::DURABLE_DIR,
+                      static_cast<unsigned long>(
+                          crc32(0U, reinterpret_cast<const uint8_t *>(path), std::strlen(path))));
+        sink_.sidecar = vfs.open(sidecarPath_, "w");
+        sink_.tracked = static_cast<bool>(sink_.sidecar);
+    }
+    if (!sink_.tracked)
+    {
+        ESP_LOGW(TAG_BUF, "durable: %s has no sidecar – not recoverable", path);
+    }
+
+    buffer_ = (bufferSize > 0U) ? new (std::nothrow) uint8_t[bufferSize] : nullptr;
+    if (!log_.begin(sink_, path, start, policy, buffer_, (buffer_ != nullptr) ? bufferSize : 0U,
+                    millis()))
+    {
+        ESP_LOGW(TAG_BUF, "durable: path too long %s", path);
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DurableWriter::write(const uint8_t *data, size_t len)
+{
+    return log_.write(data, len, millis());
+}
+
+bool DurableWriter::endRecord()
+{
+    return log_.endRecord(millis());
+}
+
+bool DurableWriter::poll()
+{
+    return log_.poll(millis());
+}
+
+bool DurableWriter::sync()
+{
+    return log_.sync();
+}
+
+void DurableWriter::close()
+{
+    // A failed final sync keeps the sidecar: the next boot trims the tail.
+    const bool clean = !log_.isOpen() || log_.end();
+    if (sink_.file)
+    {
+        sink_.file.close();
+    }
+    if (sink_.sidecar)
+    {
+        sink_.sidecar.close();
+        if (clean)
+        {
+            (void)VirtualFS::instance().remove(sidecarPath_);
+        }
+    }
+    sink_.tracked = false;
+    delete[] buffer_;
+    buffer_ = nullptr;
+}
+
+bool DurableWriter::isOpen() const { return log_.isOpen(); }
+
+const DurableLog::Stats &DurableWriter::stats() const { return log_.stats(); }
+
 } // namespace hackos::storage
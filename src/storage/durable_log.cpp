@@ -0,0 +1,344 @@
+/**
+ * @file durable_log.cpp
+ * @brief Durability policy, block trailers and recovery (see durable_log.h).
+ */
+
+#include "storage/durable_log.h"
+
+#include <cstring>
+
+#include "storage/crc32.h"
+
+namespace hackos::storage {
+
+namespace
+{
+
+constexpr uint32_t HEADER_MAGIC = 0x31525544U;    // "DUR1"
+constexpr uint32_t TRAILER_MAGIC = 0x31544244U;   // "DBT1"
+constexpr size_t VERIFY_CHUNK = 256U;
+
+void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return p[0] | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/// CRC of @p path bytes [start, end) on @p vol; false on a short read.
+bool crcRange(TierVolume &vol, const char *path, uint32_t start, uint32_t end, uint32_t *crc)
+{
+    uint8_t chunk[VERIFY_CHUNK];
+    uint32_t c = 0U;
+    for (uint32_t pos = start; pos < end;)
+    {
+        const size_t want = (end - pos < VERIFY_CHUNK) ? end - pos : VERIFY_CHUNK;
+        if (vol.read(path, pos, chunk, want) != want)
+        {
+            return false;
+        }
+        c = crc32(c, chunk, want);
+        pos += want;
+    }
+    *crc = c;
+    return true;
+}
+
+} // namespace
+
+DurableLog::DurableLog()
+    : sink_(nullptr),
+      policy_(DurabilityPolicy::everyRecord()),
+      buf_(nullptr),
+      bufSize_(0U),
+      buffered_(0U),
+      start_(0U),
+      pos_(0U),
+      syncedPos_(0U),
+      unsyncedSinceMs_(0U),
+      blockStart_(0U),
+      recordEnd_(0U),
+      runCrc_(0U),
+      recordCrc_(0U),
+      tailCrc_(0U),
+      slotBase_(0U),
+      open_(false),
+      stats_{}
+{
+}
+
+// ── Writing ──────────────────────────────────────────────────────────────────
+
+bool DurableLog::begin(CaptureSink &sink, const char *capturePath, uint32_t startOffset,
+                       const DurabilityPolicy &policy, uint8_t *buffer, size_t bufferSize,
+                       uint32_t nowMs)
+{
+    const size_t pathLen = (capturePath != nullptr) ? std::strlen(capturePath) : 0U;
+    if (pathLen == 0U || pathLen >= MAX_PATH)
+    {
+        return false;
+    }
+
+    sink_ = &sink;
+    policy_ = policy;
+    buf_ = buffer;
+    bufSize_ = (buffer != nullptr) ? bufferSize : 0U;
+    buffered_ = 0U;
+    start_ = startOffset;
+    pos_ = startOffset;
+    syncedPos_ = startOffset;
+    unsyncedSinceMs_ = nowMs;
+    blockStart_ = startOffset;
+    recordEnd_ = startOffset;
+    runCrc_ = 0U;
+    recordCrc_ = 0U;
+    tailCrc_ = 0U;
+    slotBase_ = static_cast<uint32_t>(HEADER_SIZE + pathLen);
+    stats_ = Stats{};
+    open_ = true;
+
+    uint8_t header[HEADER_SIZE + MAX_PATH];
+    put32(header, HEADER_MAGIC);
+    put32(header + 4, startOffset);
+    put32(header + 8, static_cast<uint32_t>(pathLen));
+    std::memcpy(header + HEADER_SIZE, capturePath, pathLen);
+    put32(header + 12, crc32(crc32(0U, header, 12U), header + HEADER_SIZE, pathLen));
+    if (!sink_->mark(0U, header, HEADER_SIZE + pathLen))
+    {
+        ++stats_.failures;   // still a working writer, just not recoverable
+    }
+    return true;
+}
+
+bool DurableLog::write(const uint8_t *data, size_t len, uint32_t nowMs)
+{
+    if (!open_ || data == nullptr)
+    {
+        return false;
+    }
+    if (len == 0U)
+    {
+        return true;
+    }
+
+    if (pos_ == syncedPos_)
+    {
+        unsyncedSinceMs_ = nowMs;
+    }
+    runCrc_ = crc32(runCrc_, data, len);
+    tailCrc_ = crc32(tailCrc_, data, len);
+    pos_ += static_cast<uint32_t>(len);
+    stats_.bytes += static_cast<uint32_t>(len);
+    if (pos_ - syncedPos_ > stats_.maxUnsynced)
+    {
+        stats_.maxUnsynced = pos_ - syncedPos_;
+    }
+
+    bool ok = true;
+    if (len >= bufSize_)
+    {
+        // Larger than the buffer: keep order, then write through.
+        ok = flushBuffer() && sink_->write(data, len);
+        if (!ok)
+        {
+            ++stats_.failures;
+        }
+    }
+    else
+    {
+        size_t offset = 0U;
+        while (offset < len && ok)
+        {
+            const size_t space = bufSize_ - buffered_;
+            const size_t chunk = (len - offset < space) ? len - offset : space;
+            std::memcpy(buf_ + buffered_, data + offset, chunk);
+            buffered_ += chunk;
+            offset += chunk;
+            if (buffered_ == bufSize_)
+            {
+                ok = flushBuffer();
+            }
+        }
+    }
+    return (ok && due(nowMs)) ? sync() : ok;
+}
+
+bool DurableLog::endRecord(uint32_t nowMs)
+{
+    if (!open_)
+    {
+        return false;
+    }
+    recordEnd_ = pos_;
+    recordCrc_ = runCrc_;
+    tailCrc_ = 0U;
+    return (policy_.syncOnRecord || due(nowMs)) ? sync() : true;
+}
+
+bool DurableLog::poll(uint32_t nowMs)
+{
+    return (open_ && due(nowMs)) ? sync() : open_;
+}
+
+bool DurableLog::sync()
+{
+    if (!open_)
+    {
+        return false;
+    }
+    if (pos_ != syncedPos_)
+    {
+        if (!flushBuffer() || !sink_->sync())
+        {
+            ++stats_.failures;
+            return false;
+        }
+        syncedPos_ = pos_;
+        ++stats_.syncs;
+    }
+    if (recordEnd_ == blockStart_)
+    {
+        return true;   // no complete record since the last trailer
+    }
+
+    uint8_t trailer[TRAILER_SIZE];
+    put32(trailer, TRAILER_MAGIC);
+    put32(trailer + 4, blockStart_);
+    put32(trailer + 8, recordEnd_);
+    put32(trailer + 12, recordCrc_);
+    put32(trailer + 16, crc32(0U, trailer, 16U));
+    const uint32_t slot = stats_.trailers % TRAILER_SLOTS;
+    if (!sink_->mark(slotBase_ + slot * static_cast<uint32_t>(TRAILER_SIZE), trailer,
+                     TRAILER_SIZE))
+    {
+        ++stats_.failures;
+        return false;
+    }
+    ++stats_.trailers;
+    blockStart_ = recordEnd_;
+    runCrc_ = tailCrc_;
+    recordCrc_ = 0U;
+    return true;
+}
+
+bool DurableLog::end()
+{
+    if (!open_)
+    {
+        return false;
+    }
+    const bool ok = sync();
+    open_ = false;
+    sink_ = nullptr;
+    return ok;
+}
+
+bool DurableLog::flushBuffer()
+{
+    if (buffered_ == 0U)
+    {
+        return true;
+    }
+    const bool ok = sink_->write(buf_, buffered_);
+    buffered_ = 0U;
+    if (!ok)
+    {
+        ++stats_.failures;
+    }
+    return ok;
+}
+
+bool DurableLog::due(uint32_t nowMs) const
+{
+    const uint32_t unsynced = pos_ - syncedPos_;
+    if (unsynced == 0U)
+    {
+        return recordEnd_ != blockStart_ && policy_.syncOnRecord;
+    }
+    return (policy_.syncBytes != 0U && unsynced >= policy_.syncBytes) ||
+           (policy_.syncMs != 0U && nowMs - unsyncedSinceMs_ >= policy_.syncMs);
+}
+
+// ── Recovery ─────────────────────────────────────────────────────────────────
+
+bool DurableLog::recover(TierVolume &meta, const char *sidecarPath,
+                         TierVolume &captures, Recovered &out)
+{
+    out = Recovered{};
+    const int32_t sidecarSize = meta.size(sidecarPath);
+    uint8_t header[HEADER_SIZE];
+    if (sidecarSize < static_cast<int32_t>(HEADER_SIZE) ||
+        meta.read(sidecarPath, 0U, header, HEADER_SIZE) != HEADER_SIZE ||
+        get32(header) != HEADER_MAGIC)
+    {
+        return false;
+    }
+    const uint32_t start = get32(header + 4);
+    const uint32_t pathLen = get32(header + 8);
+    if (pathLen == 0U || pathLen >= MAX_PATH ||
+        static_cast<uint32_t>(sidecarSize) < HEADER_SIZE + pathLen ||
+        meta.read(sidecarPath, HEADER_SIZE, reinterpret_cast<uint8_t *>(out.path), pathLen) !=
+            pathLen ||
+        crc32(crc32(0U, header, 12U), reinterpret_cast<const uint8_t *>(out.path), pathLen) !=
+            get32(header + 12))
+    {
+        return false;
+    }
+    out.path[pathLen] = '\0';
+
+    out.size = captures.size(out.path);
+    if (out.size < 0)
+    {
+        return true;
+    }
+    const uint32_t size = static_cast<uint32_t>(out.size);
+    out.keep = (start < size) ? start : size;
+
+    // Slots wrap, so order the intact trailers by block end, newest first;
+    // a torn slot simply fails its CRC.
+    const uint32_t first = HEADER_SIZE + pathLen;
+    uint32_t count = (static_cast<uint32_t>(sidecarSize) - first) / TRAILER_SIZE;
+    count = (count < TRAILER_SLOTS) ? count : static_cast<uint32_t>(TRAILER_SLOTS);
+    uint8_t slots[TRAILER_SLOTS][TRAILER_SIZE];
+    size_t intact = 0U;
+    for (uint32_t i = 0U; i < count; ++i)
+    {
+        uint8_t t[TRAILER_SIZE];
+        if (meta.read(sidecarPath, first + i * TRAILER_SIZE, t, TRAILER_SIZE) != TRAILER_SIZE ||
+            get32(t) != TRAILER_MAGIC || get32(t + 16) != crc32(0U, t, 16U))
+        {
+            continue;
+        }
+        size_t at = intact++;
+        for (; at > 0U && get32(slots[at - 1U] + 8) < get32(t + 8); --at)
+        {
+            std::memcpy(slots[at], slots[at - 1U], TRAILER_SIZE);
+        }
+        std::memcpy(slots[at], t, TRAILER_SIZE);
+    }
+
+    for (size_t i = 0U; i < intact; ++i)
+    {
+        const uint8_t *t = slots[i];
+        const uint32_t blockStart = get32(t + 4);
+        const uint32_t blockEnd = get32(t + 8);
+        ++out.verified;
+        uint32_t crc = 0U;
+        if (blockStart <= blockEnd && blockEnd <= size &&
+            crcRange(captures, out.path, blockStart, blockEnd, &crc) && crc == get32(t + 12))
+        {
+            out.keep = blockEnd;
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace hackos::storage
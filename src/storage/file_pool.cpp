@@ -0,0 +1,218 @@
+/**
+ * @file file_pool.cpp
+ * @brief Pooled append handles with coalescing buffers (see file_pool.h).
+ */
+
+#include "storage/file_pool.h"
+
+#include <cstring>
+
+namespace hackos::storage {
+
+FileHandlePool::FileHandlePool(PoolFs &fs)
+    : fs_(fs), slots_{}, stats_{}
+{
+}
+
+int FileHandlePool::find(const char *path) const
+{
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        if (slots_[i].open && strcmp(slots_[i].path, path) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int FileHandlePool::acquire(const char *path, uint32_t nowMs)
+{
+    // A free slot, else the least recently used one.
+    size_t pick = 0U;
+    bool freeFound = false;
+    for (size_t i = 0U; i < SLOTS && !freeFound; ++i)
+    {
+        if (!slots_[i].open)
+        {
+            pick = i;
+            freeFound = true;
+        }
+        else if (static_cast<int32_t>(slots_[i].lastUseMs - slots_[pick].lastUseMs) < 0)
+        {
+            pick = i;
+        }
+    }
+    Slot &s = slots_[pick];
+    if (!freeFound)
+    {
+        (void)closeSlot(s, pick);
+        ++stats_.evictions;
+    }
+
+    if (!fs_.open(pick, path))
+    {
+        return -1;
+    }
+    strncpy(s.path, path, MAX_PATH - 1U);
+    s.path[MAX_PATH - 1U] = '\0';
+    s.buffered = 0U;
+    s.lastUseMs = nowMs;
+    s.dirtySinceMs = nowMs;
+    s.open = true;
+    s.dirty = false;
+    ++stats_.opens;
+    return static_cast<int>(pick);
+}
+
+bool FileHandlePool::append(const char *path, const uint8_t *data, size_t len, uint32_t nowMs)
+{
+    if (path == nullptr || strlen(path) >= MAX_PATH || (data == nullptr && len > 0U))
+    {
+        return false;
+    }
+    int index = find(path);
+    if (index < 0)
+    {
+        index = acquire(path, nowMs);
+        if (index < 0)
+        {
+            return false;
+        }
+    }
+
+    Slot &s = slots_[index];
+    const size_t i = static_cast<size_t>(index);
+    if (s.buffered == 0U && !s.dirty)
+    {
+        s.dirtySinceMs = nowMs;
+    }
+    s.lastUseMs = nowMs;
+    ++stats_.appends;
+
+    if (s.buffered + len > BUFFER_SIZE && !flush(s, i))
+    {
+        (void)closeSlot(s, i);
+        return false;
+    }
+    if (len >= BUFFER_SIZE)
+    {
+        ++stats_.writes;
+        if (fs_.write(i, data, len) != len)
+        {
+            (void)closeSlot(s, i);
+            return false;
+        }
+        s.dirty = true;
+        return true;
+    }
+    memcpy(s.buffer + s.buffered, data, len);
+    s.buffered += len;
+    return true;
+}
+
+bool FileHandlePool::flush(Slot &s, size_t index)
+{
+    if (s.buffered == 0U)
+    {
+        return true;
+    }
+    ++stats_.writes;
+    const size_t n = s.buffered;
+    s.buffered = 0U;
+    s.dirty = true;
+    return fs_.write(index, s.buffer, n) == n;
+}
+
+bool FileHandlePool::syncSlot(Slot &s, size_t index)
+{
+    const bool flushed = flush(s, index);
+    if (!s.dirty)
+    {
+        return flushed;
+    }
+    ++stats_.syncs;
+    s.dirty = false;
+    return fs_.sync(index) && flushed;
+}
+
+bool FileHandlePool::closeSlot(Slot &s, size_t index)
+{
+    if (!s.open)
+    {
+        return true;
+    }
+    const bool flushed = flush(s, index);
+    fs_.close(index);   // closing commits the size like sync()
+    s.open = false;
+    s.dirty = false;
+    return flushed;
+}
+
+bool FileHandlePool::sync(const char *path)
+{
+    const int index = (path != nullptr) ? find(path) : -1;
+    return index < 0 || syncSlot(slots_[index], static_cast<size_t>(index));
+}
+
+bool FileHandlePool::syncAll()
+{
+    bool ok = true;
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        if (slots_[i].open)
+        {
+            ok = syncSlot(slots_[i], i) && ok;
+        }
+    }
+    return ok;
+}
+
+bool FileHandlePool::close(const char *path)
+{
+    const int index = (path != nullptr) ? find(path) : -1;
+    return index < 0 || closeSlot(slots_[index], static_cast<size_t>(index));
+}
+
+bool FileHandlePool::closeAll()
+{
+    bool ok = true;
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        ok = closeSlot(slots_[i], i) && ok;
+    }
+    return ok;
+}
+
+void FileHandlePool::tick(uint32_t nowMs)
+{
+    for (size_t i = 0U; i < SLOTS; ++i)
+    {
+        Slot &s = slots_[i];
+        if (!s.open)
+        {
+            continue;
+        }
+        if (nowMs - s.lastUseMs >= IDLE_CLOSE_MS)
+        {
+            (void)closeSlot(s, i);
+        }
+        else if ((s.buffered > 0U || s.dirty) && nowMs - s.dirtySinceMs >= SYNC_MS)
+        {
+            (void)syncSlot(s, i);
+            s.dirtySinceMs = nowMs;
+        }
+    }
+}
+
+size_t FileHandlePool::openCount() const
+{
+    size_t n = 0U;
+    for (const Slot &s : slots_)
+    {
+        n += s.open ? 1U : 0U;
+    }
+    return n;
+}
+
+} // namespace hackos::storage
@@ -0,0 +1,433 @@
+/**
+ * @file ram_disk.cpp
+ * @brief Bounded in-memory file store (see ram_disk.h).
+ */
+
+#include "storage/ram_disk.h"
+
+#include <cstring>
+#include <new>
+
+namespace hackos::storage {
+
+namespace
+{
+
+/// @brief Part of @p path below directory @p dir, or nullptr if not inside.
+const char *childRest(const char *path, const char *dir)
+{
+    size_t dirLen = strlen(dir);
+    while (dirLen > 0U && dir[dirLen - 1U] == '/')
+    {
+        --dirLen;
+    }
+    if (strncmp(path, dir, dirLen) != 0 || path[dirLen] != '/' || path[dirLen + 1U] == '\0')
+    {
+        return nullptr;
+    }
+    return path + dirLen + 1U;
+}
+
+size_t roundUp(size_t n)
+{
+    return (n + RamDisk::GRANULE - 1U) / RamDisk::GRANULE * RamDisk::GRANULE;
+}
+
+} // namespace
+
+RamDisk::RamDisk(size_t budgetBytes)
+    : files_{}, budget_(budgetBytes), used_(0U), clock_(0U), stats_{}
+{
+}
+
+RamDisk::~RamDisk()
+{
+    for (File &f : files_)
+    {
+        delete[] f.data;
+    }
+}
+
+void RamDisk::setBudget(size_t bytes)
+{
+    budget_ = bytes;
+    (void)makeRoom(0U, nullptr);
+}
+
+// ── Internals ────────────────────────────────────────────────────────────────
+
+int RamDisk::find(const char *path) const
+{
+    for (size_t i = 0U; i < MAX_FILES; ++i)
+    {
+        const File &f = files_[i];
+        if (f.used && !f.removed && strcmp(f.path, path) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool RamDisk::valid(int handle) const
+{
+    return handle >= 0 && static_cast<size_t>(handle) < MAX_FILES &&
+           files_[handle].used && files_[handle].refs > 0U;
+}
+
+void RamDisk::touch(File &f)
+{
+    f.lastUse = ++clock_;
+}
+
+void RamDisk::freeFile(File &f)
+{
+    delete[] f.data;
+    used_ -= f.capacity;
+    f.data = nullptr;
+    f.capacity = 0U;
+    f.size = 0U;
+}
+
+RamDisk::File *RamDisk::victim(const File *keep, bool holdingBytes)
+{
+    File *lru = nullptr;
+    for (File &f : files_)
+    {
+        if (!f.used || f.removed || f.refs > 0U || f.pinned || &f == keep ||
+            (holdingBytes && f.capacity == 0U))
+        {
+            continue;
+        }
+        if (lru == nullptr || static_cast<int32_t>(f.lastUse - lru->lastUse) < 0)
+        {
+            lru = &f;
+        }
+    }
+    return lru;
+}
+
+void RamDisk::evict(File &f)
+{
+    freeFile(f);
+    f.used = false;
+    ++stats_.evictions;
+}
+
+bool RamDisk::makeRoom(size_t bytes, const File *keep)
+{
+    while (used_ + bytes > budget_)
+    {
+        File *f = victim(keep, true);
+        if (f == nullptr)
+        {
+            return false;
+        }
+        evict(*f);
+    }
+    return true;
+}
+
+bool RamDisk::reserve(File &f, size_t need)
+{
+    if (need <= f.capacity)
+    {
+        return true;
+    }
+    // Doubling first, then just enough.
+    size_t newCap = roundUp((need > f.capacity * 2U) ? need : f.capacity * 2U);
+    if (!makeRoom(newCap - f.capacity, &f))
+    {
+        newCap = roundUp(need);
+        if (!makeRoom(newCap - f.capacity, &f))
+        {
+            return false;
+        }
+    }
+    auto *data = new (std::nothrow) uint8_t[newCap];
+    if (data == nullptr)
+    {
+        return false;
+    }
+    if (f.size > 0U)
+    {
+        memcpy(data, f.data, f.size);
+    }
+    delete[] f.data;
+    used_ += newCap - f.capacity;
+    f.data = data;
+    f.capacity = newCap;
+    stats_.peakBytes = (used_ > stats_.peakBytes) ? used_ : stats_.peakBytes;
+    return true;
+}
+
+// ── Handles ──────────────────────────────────────────────────────────────────
+
+int RamDisk::open(const char *path, bool create, bool truncate)
+{
+    if (path == nullptr || path[0] != '/')
+    {
+        return -1;
+    }
+    const size_t len = strlen(path);
+    if (len < 2U || len >= MAX_PATH || path[len - 1U] == '/')
+    {
+        return -1;
+    }
+
+    int index = find(path);
+    if (index < 0)
+    {
+        if (!create || isDir(path))
+        {
+            return -1;
+        }
+        // A parent path may not be a file.
+        for (size_t i = 1U; i < len; ++i)
+        {
+            if (path[i] != '/')
+            {
+                continue;
+            }
+            for (const File &f : files_)
+            {
+                if (f.used && !f.removed && strncmp(f.path, path, i) == 0 && f.path[i] == '\0')
+                {
+                    return -1;
+                }
+            }
+        }
+
+        for (size_t i = 0U; i < MAX_FILES && index < 0; ++i)
+        {
+            index = files_[i].used ? -1 : static_cast<int>(i);
+        }
+        if (index < 0)
+        {
+            // Every slot taken: the LRU file gives up its slot.
+            File *lru = victim(nullptr, false);
+            if (lru == nullptr)
+            {
+                return -1;
+            }
+            evict(*lru);
+            index = static_cast<int>(lru - files_);
+        }
+        File &f = files_[index];
+        memcpy(f.path, path, len + 1U);
+        f.data = nullptr;
+        f.size = 0U;
+        f.capacity = 0U;
+        f.refs = 0U;
+        f.used = true;
+        f.pinned = false;
+        f.removed = false;
+    }
+
+    File &f = files_[index];
+    if (f.refs == UINT8_MAX)
+    {
+        return -1;
+    }
+    if (truncate)
+    {
+        freeFile(f);
+    }
+    ++f.refs;
+    touch(f);
+    return index;
+}
+
+void RamDisk::release(int handle)
+{
+    if (!valid(handle))
+    {
+        return;
+    }
+    File &f = files_[handle];
+    --f.refs;
+    if (f.refs == 0U && f.removed)
+    {
+        freeFile(f);
+        f.used = false;
+    }
+}
+
+size_t RamDisk::read(int handle, size_t pos, uint8_t *buf, size_t len)
+{
+    if (!valid(handle) || buf == nullptr)
+    {
+        return 0U;
+    }
+    File &f = files_[handle];
+    touch(f);
+    if (pos >= f.size)
+    {
+        return 0U;
+    }
+    const size_t n = (len < f.size - pos) ? len : f.size - pos;
+    memcpy(buf, f.data + pos, n);
+    return n;
+}
+
+size_t RamDisk::write(int handle, size_t pos, const uint8_t *data, size_t len)
+{
+    if (!valid(handle) || data == nullptr || len == 0U)
+    {
+        return 0U;
+    }
+    File &f = files_[handle];
+    touch(f);
+    size_t n = len;
+    if (!reserve(f, pos + len))
+    {
+        // Take what is left of the budget (reserve() has evicted all it can).
+        ++stats_.shortWrites;
+        const size_t room = (budget_ > used_) ? (budget_ - used_) / GRANULE * GRANULE : 0U;
+        if (room > 0U)
+        {
+            (void)reserve(f, f.capacity + room);
+        }
+        n = (f.capacity > pos) ? f.capacity - pos : 0U;
+        n = (n < len) ? n : len;
+        if (n == 0U)
+        {
+            return 0U;
+        }
+    }
+    if (pos > f.size)
+    {
+        memset(f.data + f.size, 0, pos - f.size);
+    }
+    memcpy(f.data + pos, data, n);
+    f.size = (pos + n > f.size) ? pos + n : f.size;
+    return n;
+}
+
+size_t RamDisk::size(int handle) const
+{
+    return valid(handle) ? files_[handle].size : 0U;
+}
+
+const char *RamDisk::path(int handle) const
+{
+    return valid(handle) ? files_[handle].path : "";
+}
+
+// ── Paths ────────────────────────────────────────────────────────────────────
+
+bool RamDisk::isDir(const char *path) const
+{
+    if (path == nullptr)
+    {
+        return false;
+    }
+    if (path[0] == '\0' || strcmp(path, "/") == 0)
+    {
+        return true;
+    }
+    for (const File &f : files_)
+    {
+        if (f.used && !f.removed && childRest(f.path, path) != nullptr)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RamDisk::exists(const char *path) const
+{
+    return path != nullptr && (find(path) >= 0 || isDir(path));
+}
+
+bool RamDisk::remove(const char *path)
+{
+    const int index = (path != nullptr) ? find(path) : -1;
+    if (index < 0)
+    {
+        return false;
+    }
+    File &f = files_[index];
+    f.removed = true;
+    if (f.refs == 0U)
+    {
+        freeFile(f);
+        f.used = false;
+    }
+    return true;
+}
+
+bool RamDisk::rename(const char *from, const char *to)
+{
+    const int index = (from != nullptr) ? find(from) : -1;
+    if (index < 0 || to == nullptr || to[0] != '/' || strlen(to) >= MAX_PATH || isDir(to))
+    {
+        return false;
+    }
+    if (strcmp(from, to) == 0)
+    {
+        return true;
+    }
+    (void)remove(to);
+    File &f = files_[index];
+    strncpy(f.path, to, MAX_PATH - 1U);
+    f.path[MAX_PATH - 1U] = '\0';
+    return true;
+}
+
+bool RamDisk::pin(const char *path, bool pinned)
+{
+    const int index = (path != nullptr) ? find(path) : -1;
+    if (index < 0)
+    {
+        return false;
+    }
+    files_[index].pinned = pinned;
+    return true;
+}
+
+bool RamDisk::nextEntry(const char *dir, size_t &cursor, char *name, size_t nameCap,
+                        bool &isDir, uint32_t &size) const
+{
+    if (dir == nullptr || name == nullptr || nameCap == 0U)
+    {
+        return false;
+    }
+    for (size_t i = cursor; i < MAX_FILES; ++i)
+    {
+        const File &f = files_[i];
+        const char *rest = (f.used && !f.removed) ? childRest(f.path, dir) : nullptr;
+        if (rest == nullptr)
+        {
+            continue;
+        }
+        const char *slash = strchr(rest, '/');
+        const size_t compLen = (slash != nullptr) ? static_cast<size_t>(slash - rest) : strlen(rest);
+
+        // A sub-directory is reported once, at its first file.
+        bool seen = false;
+        for (size_t j = 0U; j < i && slash != nullptr && !seen; ++j)
+        {
+            const File &g = files_[j];
+            const char *other = (g.used && !g.removed) ? childRest(g.path, dir) : nullptr;
+            seen = other != nullptr && strncmp(other, rest, compLen) == 0 && other[compLen] == '/';
+        }
+        if (seen)
+        {
+            continue;
+        }
+
+        const size_t n = (compLen < nameCap - 1U) ? compLen : nameCap - 1U;
+        memcpy(name, rest, n);
+        name[n] = '\0';
+        isDir = slash != nullptr;
+        size = isDir ? 0U : static_cast<uint32_t>(f.size);
+        cursor = i + 1U;
+        return true;
+    }
+    cursor = MAX_FILES;
+    return false;
+}
+
+} // namespace hackos::storage
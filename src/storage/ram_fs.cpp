@@ -0,0 +1,330 @@
+/**
+ * @file ram_fs.cpp
+ * @brief fs::FSImpl / fs::FileImpl adapters for RamDisk (see ram_fs.h).
+ */
+
+#include "storage/ram_fs.h"
+
+#include <cstdio>
+#include <cstring>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <new>
+
+namespace hackos::storage {
+
+namespace
+{
+
+/// @brief The `/ram/` mutex, created on first use.
+SemaphoreHandle_t ramMutex()
+{
+    static StaticSemaphore_t buf;
+    static SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic(&buf);
+    return mutex;
+}
+
+const char *baseName(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return (slash != nullptr && slash[1] != '\0') ? slash + 1 : path;
+}
+
+// ── RamFile ──────────────────────────────────────────────────────────────────
+
+/// @brief Open RamDisk file; holds one RamDisk reference until close().
+class RamFile final : public fs::FileImpl
+{
+public:
+    RamFile(RamDisk &disk, int handle, bool canRead, bool canWrite, bool append)
+        : disk_(disk), handle_(handle), pos_(0U),
+          canRead_(canRead), canWrite_(canWrite), append_(append)
+    {
+    }
+
+    ~RamFile() override { close(); }
+
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        if (!canWrite_ || handle_ < 0)
+        {
+            return 0U;
+        }
+        RamDiskLock lock;
+        if (append_)
+        {
+            pos_ = disk_.size(handle_);
+        }
+        const size_t n = disk_.write(handle_, pos_, buf, size);
+        pos_ += n;
+        return n;
+    }
+
+    size_t read(uint8_t *buf, size_t size) override
+    {
+        if (!canRead_ || handle_ < 0)
+        {
+            return 0U;
+        }
+        RamDiskLock lock;
+        const size_t n = disk_.read(handle_, pos_, buf, size);
+        pos_ += n;
+        return n;
+    }
+
+    void flush() override {}
+
+    bool seek(uint32_t pos, fs::SeekMode mode) override
+    {
+        if (handle_ < 0)
+        {
+            return false;
+        }
+        switch (mode)
+        {
+        case fs::SeekSet:
+            pos_ = pos;
+            break;
+        case fs::SeekCur:
+            pos_ += pos;
+            break;
+        case fs::SeekEnd:
+        {
+            RamDiskLock lock;
+            pos_ = disk_.size(handle_) + pos;
+            break;
+        }
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    size_t position() const override { return pos_; }
+    size_t size() const override
+    {
+        RamDiskLock lock;
+        return disk_.size(handle_);
+    }
+
+    void close() override
+    {
+        if (handle_ >= 0)
+        {
+            RamDiskLock lock;
+            disk_.release(handle_);
+            handle_ = -1;
+        }
+    }
+
+    time_t getLastWrite() override { return 0; }
+
+    const char *path() const override
+    {
+        RamDiskLock lock;
+        return disk_.path(handle_);
+    }
+
+    const char *name() const override { return baseName(path()); }
+    bool isDirectory() override { return false; }
+    fs::FileImplPtr openNextFile(const char *) override { return fs::FileImplPtr(); }
+    void rewindDirectory() override {}
+    operator bool() override { return handle_ >= 0; }
+
+    // Not present on every core release, hence no `override`.
+    bool setBufferSize(size_t) { return true; }
+    String getNextFileName() { return String(""); }
+    String getNextFileName(bool *isDir)
+    {
+        if (isDir != nullptr)
+        {
+            *isDir = false;
+        }
+        return String("");
+    }
+
+private:
+    RamDisk &disk_;
+    int handle_;
+    size_t pos_;
+    bool canRead_;
+    bool canWrite_;
+    bool append_;
+};
+
+// ── RamDir ───────────────────────────────────────────────────────────────────
+
+/// @brief Directory handle iterating RamDisk::nextEntry().
+class RamDir final : public fs::FileImpl
+{
+public:
+    RamDir(RamDisk &disk, const char *path)
+        : disk_(disk), cursor_(0U), open_(true)
+    {
+        strncpy(path_, path, sizeof(path_) - 1U);
+        path_[sizeof(path_) - 1U] = '\0';
+    }
+
+    size_t write(const uint8_t *, size_t) override { return 0U; }
+    size_t read(uint8_t *, size_t) override { return 0U; }
+    void flush() override {}
+    bool seek(uint32_t, fs::SeekMode) override { return false; }
+    size_t position() const override { return 0U; }
+    size_t size() const override { return 0U; }
+    void close() override { open_ = false; }
+    time_t getLastWrite() override { return 0; }
+    const char *path() const override { return path_; }
+    const char *name() const override { return baseName(path_); }
+    bool isDirectory() override { return true; }
+    void rewindDirectory() override { cursor_ = 0U; }
+    operator bool() override { return open_; }
+
+    fs::FileImplPtr openNextFile(const char *) override
+    {
+        RamDiskLock lock;
+        char child[RamDisk::MAX_PATH];
+        bool isDir = false;
+        if (!nextChild(child, isDir))
+        {
+            return fs::FileImplPtr();
+        }
+        if (isDir)
+        {
+            return fs::FileImplPtr(new (std::nothrow) RamDir(disk_, child));
+        }
+        const int handle = disk_.open(child, false, false);
+        if (handle < 0)
+        {
+            return fs::FileImplPtr();
+        }
+        return fs::FileImplPtr(new (std::nothrow) RamFile(disk_, handle, true, false, false));
+    }
+
+    bool setBufferSize(size_t) { return false; }
+    String getNextFileName() { return getNextFileName(nullptr); }
+    String getNextFileName(bool *isDir)
+    {
+        char child[RamDisk::MAX_PATH];
+        bool dir = false;
+        bool found = false;
+        {
+            RamDiskLock lock;
+            found = nextChild(child, dir);
+        }
+        if (isDir != nullptr)
+        {
+            *isDir = dir;
+        }
+        return String(found ? child : "");
+    }
+
+private:
+    /// Full path of the next entry (caller holds RamDiskLock).
+    bool nextChild(char *child, bool &isDir)
+    {
+        char name[RamDisk::MAX_PATH];
+        uint32_t size = 0U;
+        if (!open_ || !disk_.nextEntry(path_, cursor_, name, sizeof(name), isDir, size))
+        {
+            return false;
+        }
+        size_t len = strlen(path_);
+        while (len > 0U && path_[len - 1U] == '/')
+        {
+            --len;
+        }
+        snprintf(child, RamDisk::MAX_PATH, "%.*s/%s", static_cast<int>(len), path_, name);
+        return true;
+    }
+
+    RamDisk &disk_;
+    char path_[RamDisk::MAX_PATH];
+    size_t cursor_;
+    bool open_;
+};
+
+} // namespace
+
+// ── RamDiskLock ──────────────────────────────────────────────────────────────
+
+RamDiskLock::RamDiskLock()
+{
+    xSemaphoreTake(ramMutex(), portMAX_DELAY);
+}
+
+RamDiskLock::~RamDiskLock()
+{
+    xSemaphoreGive(ramMutex());
+}
+
+// ── RamFs ────────────────────────────────────────────────────────────────────
+
+RamFs::RamFs(RamDisk &disk)
+    : disk_(disk)
+{
+}
+
+fs::FileImplPtr RamFs::open(const char *path, const char *mode, const bool)
+{
+    if (path == nullptr || mode == nullptr)
+    {
+        return fs::FileImplPtr();
+    }
+    const bool plus = strchr(mode, '+') != nullptr;
+    RamDiskLock lock;
+    if (disk_.isDir(path))
+    {
+        return (mode[0] == 'r' && !plus) ? fs::FileImplPtr(new (std::nothrow) RamDir(disk_, path))
+                                         : fs::FileImplPtr();
+    }
+
+    const bool canRead = mode[0] == 'r' || plus;
+    const bool canWrite = mode[0] != 'r' || plus;
+    const bool create = mode[0] == 'w' || mode[0] == 'a';
+    const int handle = disk_.open(path, create, mode[0] == 'w');
+    if (handle < 0)
+    {
+        return fs::FileImplPtr();
+    }
+    auto *file = new (std::nothrow) RamFile(disk_, handle, canRead, canWrite, mode[0] == 'a');
+    if (file == nullptr)
+    {
+        disk_.release(handle);
+    }
+    return fs::FileImplPtr(file);
+}
+
+bool RamFs::exists(const char *path)
+{
+    RamDiskLock lock;
+    return disk_.exists(path);
+}
+
+bool RamFs::rename(const char *pathFrom, const char *pathTo)
+{
+    RamDiskLock lock;
+    return disk_.rename(pathFrom, pathTo);
+}
+
+bool RamFs::remove(const char *path)
+{
+    RamDiskLock lock;
+    return disk_.remove(path);
+}
+
+bool RamFs::mkdir(const char *)
+{
+    return true;
+}
+
+bool RamFs::rmdir(const char *path)
+{
+    size_t cursor = 0U;
+    char name[RamDisk::MAX_PATH];
+    bool isDir = false;
+    uint32_t size = 0U;
+    RamDiskLock lock;
+    return !disk_.nextEntry(path, cursor, name, sizeof(name), isDir, size);
+}
+
+} // namespace hackos::storage
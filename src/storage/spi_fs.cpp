@@ -0,0 +1,200 @@
+/**
+ * @file spi_fs.cpp
+ * @brief Arbitrated SD access (see spi_fs.h).
+ */
+
+#include "storage/spi_fs.h"
+
+#include <SD.h>
+#include <new>
+
+#include "core/system_core.h"
+
+namespace hackos::storage {
+
+namespace
+{
+
+using hackos::core::BusPriority;
+using hackos::core::SpiClient;
+using hackos::core::SpiLease;
+
+// ── SpiFile ──────────────────────────────────────────────────────────────────
+
+/// @brief SD file whose calls each hold the bus.
+class SpiFile final : public fs::FileImpl
+{
+public:
+    explicit SpiFile(const fs::File &file) : file_(file) {}
+
+    ~SpiFile() override { close(); }
+
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::BULK);
+        size_t done = 0U;
+        while (done < size)
+        {
+            const size_t want = (size - done < SpiFs::SLICE_BYTES) ? size - done
+                                                                    : SpiFs::SLICE_BYTES;
+            const size_t n = file_.write(buf + done, want);
+            done += n;
+            if (n != want)
+            {
+                break;
+            }
+            if (done < size)
+            {
+                lease.yield();
+            }
+        }
+        return done;
+    }
+
+    size_t read(uint8_t *buf, size_t size) override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+        size_t done = 0U;
+        while (done < size)
+        {
+            const size_t want = (size - done < SpiFs::SLICE_BYTES) ? size - done
+                                                                    : SpiFs::SLICE_BYTES;
+            const size_t n = file_.read(buf + done, want);
+            done += n;
+            if (n != want)
+            {
+                break;
+            }
+            if (done < size)
+            {
+                lease.yield();
+            }
+        }
+        return done;
+    }
+
+    void flush() override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::BULK);
+        file_.flush();
+    }
+
+    bool seek(uint32_t pos, fs::SeekMode mode) override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);   // may flush
+        return file_.seek(pos, mode);
+    }
+
+    size_t position() const override { return file_.position(); }
+    size_t size() const override { return file_.size(); }
+
+    void close() override
+    {
+        if (file_)
+        {
+            SpiLease lease(SpiClient::SD, BusPriority::BULK);
+            file_.close();
+        }
+    }
+
+    time_t getLastWrite() override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+        return file_.getLastWrite();
+    }
+
+    const char *path() const override { return file_.path(); }
+    const char *name() const override { return file_.name(); }
+    bool isDirectory() override { return file_.isDirectory(); }
+
+    fs::FileImplPtr openNextFile(const char *mode) override
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+        fs::File next = file_.openNextFile(mode);
+        if (!next)
+        {
+            return fs::FileImplPtr();
+        }
+        return fs::FileImplPtr(new (std::nothrow) SpiFile(next));
+    }
+
+    void rewindDirectory() override { file_.rewindDirectory(); }
+    operator bool() override { return static_cast<bool>(file_); }
+
+    // Not present on every core release, hence no `override`.
+    bool setBufferSize(size_t) { return false; }
+    String getNextFileName() { return getNextFileName(nullptr); }
+    String getNextFileName(bool *isDir)
+    {
+        SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+        fs::File next = file_.openNextFile("r");
+        if (isDir != nullptr)
+        {
+            *isDir = next && next.isDirectory();
+        }
+        const String name(next ? next.path() : "");
+        next.close();
+        return name;
+    }
+
+private:
+    fs::File file_;
+};
+
+} // namespace
+
+// ── SpiFs ────────────────────────────────────────────────────────────────────
+
+SpiFs::SpiFs(fs::FS &inner)
+    : inner_(inner)
+{
+}
+
+fs::FileImplPtr SpiFs::open(const char *path, const char *mode, const bool create)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    fs::File file = inner_.open(path, mode, create);
+    if (!file)
+    {
+        return fs::FileImplPtr();
+    }
+    return fs::FileImplPtr(new (std::nothrow) SpiFile(file));
+}
+
+bool SpiFs::exists(const char *path)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    return inner_.exists(path);
+}
+
+bool SpiFs::rename(const char *pathFrom, const char *pathTo)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    return inner_.rename(pathFrom, pathTo);
+}
+
+bool SpiFs::remove(const char *path)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    return inner_.remove(path);
+}
+
+bool SpiFs::mkdir(const char *path)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    return inner_.mkdir(path);
+}
+
+bool SpiFs::rmdir(const char *path)
+{
+    SpiLease lease(SpiClient::SD, BusPriority::NORMAL);
+    return inner_.rmdir(path);
+}
+
+fs::FS &sdFs()
+{
+    static fs::FS fs(fs::FSImplPtr(new (std::nothrow) SpiFs(SD)));
+    return fs;
+}
+
+} // namespace hackos::storage
@@ -1,16 +1,239 @@
 #include "storage/vfs.h"
 
-#include <SD.h>
+#include <Arduino.h>
 #include <LittleFS.h>
+#include <cstdio>
 #include <cstring>
 #include <esp_log.h>
+#include <new>
+#include <unistd.h>
 
+#include "core/system_core.h"
 #include "hardware/storage.h"
+#include "storage/durable_log.h"
+#include "storage/ram_fs.h"
+#include "storage/spi_fs.h"
 
 static constexpr const char *TAG_VFS = "VFS";
 
 namespace hackos::storage {
 
+namespace
+{
+
+// ── Write-back journal ───────────────────────────────────────────────────────
+
+constexpr const char *WB_DIR = "/wb";   // on LittleFS
+constexpr const char *WB_JOURNAL = "/wb/journal";
+constexpr const char *WB_STATE = "/wb/state";
+constexpr const char *WB_DEFAULT_PREFIX = "/ext/captures/";
+constexpr uint32_t WB_POLL_MS = 500U;
+constexpr uint32_t WB_SD_IDLE_MS = 250U;     ///< Card quiet this long before a batch
+constexpr uint32_t WB_MAX_AGE_MS = 10000U;   ///< Migrate a partial batch after this
+constexpr uint32_t WB_TASK_STACK = 4096U;
+constexpr UBaseType_t WB_TASK_PRIO = 1U;     ///< IO_Task priority (system_core.h)
+constexpr BaseType_t WB_TASK_CORE = 0;
+
+/// @brief TierVolume over an Arduino fs::FS.
+///
+/// The flash volume keeps the journal open between appends (flush() makes
+/// each record durable) and closes it before any other access to it.  The
+/// SD volume appends through StorageManager's handle pool, so a target
+/// file stays open across batches and sync() commits each one.
+class FsVolume final : public TierVolume
+{
+public:
+    FsVolume(fs::FS &fs, bool isSd) : fs_(fs), isSd_(isSd), cached_(), cachedPath_{} {}
+
+    bool available() override
+    {
+        return !isSd_ || StorageManager::instance().isMounted();
+    }
+
+    int32_t size(const char *path) override
+    {
+        settle(path);
+        fs::File f = fs_.open(path, "r");
+        if (!f)
+        {
+            return -1;
+        }
+        const int32_t n = static_cast<int32_t>(f.size());
+        f.close();
+        return n;
+    }
+
+    size_t read(const char *path, uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        settle(path);
+        fs::File f = fs_.open(path, "r");
+        if (!f)
+        {
+            return 0U;
+        }
+        const size_t n = f.seek(offset) ? f.read(buf, len) : 0U;
+        f.close();
+        return n;
+    }
+
+    bool append(const char *path, const uint8_t *data, size_t len) override
+    {
+        if (isSd_)
+        {
+            return StorageManager::instance().appendChunk(path, data, len);
+        }
+        if (!cached_ || std::strcmp(cachedPath_, path) != 0)
+        {
+            closeCached(nullptr);
+            cached_ = fs_.open(path, "a");
+            if (!cached_)
+            {
+                return false;
+            }
+            std::strncpy(cachedPath_, path, sizeof(cachedPath_) - 1U);
+        }
+        const bool ok = cached_.write(data, len) == len;
+        cached_.flush();
+        if (!ok)
+        {
+            closeCached(nullptr);
+        }
+        return ok;
+    }
+
+    bool sync(const char *path) override
+    {
+        // Flash: append() already flushed.
+        return !isSd_ || StorageManager::instance().sync(path);
+    }
+
+    bool replace(const char *path, const uint8_t *data, size_t len) override
+    {
+        detach(path);
+        fs::File f = fs_.open(path, "w");
+        if (!f)
+        {
+            return false;
+        }
+        const bool ok = f.write(data, len) == len;
+        f.close();
+        return ok;
+    }
+
+    bool remove(const char *path) override
+    {
+        detach(path);
+        return fs_.remove(path);
+    }
+
+private:
+    /// Make appended data of @p path visible to another handle.
+    void settle(const char *path)
+    {
+        if (isSd_)
+        {
+            (void)StorageManager::instance().sync(path);
+        }
+        else
+        {
+            closeCached(path);
+        }
+    }
+
+    /// No handle of ours may stay open on @p path.
+    void detach(const char *path)
+    {
+        if (isSd_)
+        {
+            (void)StorageManager::instance().close(path);
+        }
+        else
+        {
+            closeCached(path);
+        }
+    }
+
+    /// Close the cached handle (if it is @p path, or any for nullptr).
+    void closeCached(const char *path)
+    {
+        if (cached_ && (path == nullptr || std::strcmp(cachedPath_, path) == 0))
+        {
+            cached_.close();
+            cachedPath_[0] = '\0';
+        }
+    }
+
+    fs::FS &fs_;
+    bool isSd_;
+    fs::File cached_;
+    char cachedPath_[WriteBackJournal::MAX_PATH];
+};
+
+FsVolume g_flashVolume(LittleFS, false);
+FsVolume g_sdVolume(sdFs(), true);
+
+// ── Capture recovery ─────────────────────────────────────────────────────────
+
+constexpr const char *SD_MOUNT_POINT = "/sd";          // SD.begin() default
+constexpr const char *FLASH_MOUNT_POINT = "/littlefs"; // LittleFS.begin() default
+constexpr size_t MAX_SIDECARS = 8U;
+
+/// @brief Read-only TierVolume over virtual paths; keeps one file open
+///        across the chunked reads of a recovery scan.
+class CaptureView final : public TierVolume
+{
+public:
+    CaptureView() : file_(), path_{} {}
+
+    bool available() override { return true; }
+
+    int32_t size(const char *path) override
+    {
+        return select(path) ? static_cast<int32_t>(file_.size()) : -1;
+    }
+
+    size_t read(const char *path, uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        return (select(path) && file_.seek(offset)) ? file_.read(buf, len) : 0U;
+    }
+
+    bool append(const char *, const uint8_t *, size_t) override { return false; }
+    bool sync(const char *) override { return false; }
+    bool replace(const char *, const uint8_t *, size_t) override { return false; }
+    bool remove(const char *) override { return false; }
+
+    void close()
+    {
+        if (file_)
+        {
+            file_.close();
+        }
+        path_[0] = '\0';
+    }
+
+private:
+    bool select(const char *path)
+    {
+        if (file_ && std::strcmp(path_, path) == 0)
+        {
+            return true;
+        }
+        close();
+        file_ = VirtualFS::instance().open(path, "r");
+        if (!file_)
+        {
+            return false;
+        }
+        std::strncpy(path_, path, sizeof(path_) - 1U);
+        return true;
+    }
+
+    fs::File file_;
+    char path_[DurableLog::MAX_PATH];
+};
+
+} // namespace
+
 // ── Singleton ────────────────────────────────────────────────────────────────
 
 VirtualFS &VirtualFS::instance()
@@ -22,7 +245,19 @@ VirtualFS &VirtualFS::instance()
 VirtualFS::VirtualFS()
     : sdMounted_(false),
       flashMounted_(false),
-      lastError_("Not initialized")
+      lastError_("Not initialized"),
+      ramDisk_(RAM_DISK_BUDGET),
+      ramFs_(fs::FSImplPtr(new (std::nothrow) RamFs(ramDisk_))),
+      journal_(nullptr),
+      journalMutex_(nullptr),
+      journalMutexBuf_{},
+      migrateMutex_(nullptr),
+      migrateMutexBuf_{},
+      writeBackTask_(nullptr),
+      writeBack_{},
+      writeBackCount_(0U),
+      lastSdUseMs_(0U),
+      oldestPendingMs_(0U)
 {
 }
 
@@ -51,8 +286,19 @@ bool VirtualFS::init()
     {
         flashMounted_ = true;
         ESP_LOGI(TAG_VFS, "LittleFS mounted – /int paths available");
+        (void)recoverCaptures();
+        (void)addWriteBack(WB_DEFAULT_PREFIX);
+        startWriteBack();
     }
 
+    size_t ramBudget = 0U;
+    {
+        RamDiskLock lock;
+        ramBudget = ramDisk_.budget();
+    }
+    ESP_LOGI(TAG_VFS, "RAM disk – /ram paths available (%u byte budget)",
+             static_cast<unsigned>(ramBudget));
+
     lastError_ = (sdMounted_ || flashMounted_) ? "OK" : "No storage available";
     return sdMounted_ || flashMounted_;
 }
@@ -75,6 +321,11 @@ StorageType VirtualFS::resolveStorage(const char *path)
     {
         return StorageType::FLASH;
     }
+    if (std::strncmp(path, "/ram", 4U) == 0 &&
+        (path[4] == '/' || path[4] == '\0'))
+    {
+        return StorageType::RAM;
+    }
     return StorageType::UNKNOWN;
 }
 
@@ -84,9 +335,8 @@ const char *VirtualFS::stripPrefix(const char *path)
     {
         return "/";
     }
-    // Skip the 4-character prefix ("/ext" or "/int").
-    if ((std::strncmp(path, "/ext", 4U) == 0 || std::strncmp(path, "/int", 4U) == 0) &&
-        (path[4] == '/' || path[4] == '\0'))
+    // Skip the 4-character prefix ("/ext", "/int" or "/ram").
+    if (resolveStorage(path) != StorageType::UNKNOWN)
     {
         const char *rest = path + 4;
         return (*rest != '\0') ? rest : "/";
@@ -99,9 +349,11 @@ fs::FS *VirtualFS::getFS(StorageType type)
     switch (type)
     {
     case StorageType::SD_CARD:
-        return sdMounted_ ? &SD : nullptr;
+        return sdMounted_ ? &sdFs() : nullptr;
     case StorageType::FLASH:
         return flashMounted_ ? &LittleFS : nullptr;
+    case StorageType::RAM:
+        return &ramFs_;
     default:
         return nullptr;
     }
@@ -118,7 +370,17 @@ fs::File VirtualFS::open(const char *path, const char *mode)
         lastError_ = "open: storage unavailable or bad path";
         return fs::File();
     }
+    if (isWriteBack(path))
+    {
+        (void)syncWriteBack();   // readers and writers see journaled bytes
+    }
+    noteSdUse(st);
     const char *localPath = stripPrefix(path);
+    if (st == StorageType::SD_CARD && mode != nullptr && std::strcmp(mode, "r") != 0)
+    {
+        // No second write handle next to the append pool's.
+        (void)StorageManager::instance().close(localPath);
+    }
     fs::File f = fs->open(localPath, mode);
     if (!f)
     {
@@ -140,6 +402,7 @@ bool VirtualFS::exists(const char *path)
         lastError_ = "exists: storage unavailable or bad path";
         return false;
     }
+    noteSdUse(st);
     return fs->exists(stripPrefix(path));
 }
 
@@ -152,6 +415,7 @@ bool VirtualFS::mkdir(const char *path)
         lastError_ = "mkdir: storage unavailable or bad path";
         return false;
     }
+    noteSdUse(st);
     const char *localPath = stripPrefix(path);
     if (fs->exists(localPath))
     {
@@ -176,6 +440,16 @@ bool VirtualFS::remove(const char *path)
         lastError_ = "remove: storage unavailable or bad path";
         return false;
     }
+    if (isWriteBack(path))
+    {
+        (void)syncWriteBack();   // or migration would re-create it
+    }
+    noteSdUse(st);
+    if (st == StorageType::SD_CARD)
+    {
+        // The pool would keep writing into the freed clusters.
+        (void)StorageManager::instance().close(stripPrefix(path));
+    }
     if (!fs->remove(stripPrefix(path)))
     {
         lastError_ = "remove: failed";
@@ -201,6 +475,11 @@ size_t VirtualFS::listDir(const char *path, DirEntry *entries, size_t maxEntries
         lastError_ = "listDir: storage unavailable or bad path";
         return 0U;
     }
+    if (st == StorageType::SD_CARD)
+    {
+        (void)syncWriteBack();   // sizes include journaled bytes
+    }
+    noteSdUse(st);
 
     const char *localPath = stripPrefix(path);
     fs::File dir = fs->open(localPath);
@@ -238,10 +517,283 @@ size_t VirtualFS::listDir(const char *path, DirEntry *entries, size_t maxEntries
     return count;
 }
 
+// ── Capture recovery ─────────────────────────────────────────────────────────
+
+size_t VirtualFS::recoverCaptures()
+{
+    if (!flashMounted_)
+    {
+        return 0U;
+    }
+    DirEntry entries[MAX_SIDECARS];
+    const size_t count = listDir(DURABLE_DIR, entries, MAX_SIDECARS);
+    CaptureView captures;
+    size_t trimmed = 0U;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (entries[i].isDir)
+        {
+            continue;
+        }
+        char sidecar[96];
+        std::snprintf(sidecar, sizeof(sidecar), "%s/%s", DURABLE_DIR, entries[i].name);
+        DurableLog::Recovered rec;
+        const bool found = DurableLog::recover(g_flashVolume, stripPrefix(sidecar), captures, rec);
+        captures.close();   // before truncating the capture
+        if (!found)
+        {
+            ESP_LOGW(TAG_VFS, "recover: %s unreadable – dropped", sidecar);
+            (void)remove(sidecar);
+            continue;
+        }
+        if (getFS(resolveStorage(rec.path)) == nullptr)
+        {
+            ESP_LOGW(TAG_VFS, "recover: %s not mounted – retry next boot", rec.path);
+            continue;
+        }
+        if (rec.size > static_cast<int32_t>(rec.keep))
+        {
+            if (truncateFile(rec.path, rec.keep))
+            {
+                ++trimmed;
+                ESP_LOGI(TAG_VFS, "recover: %s cut to %lu B (%ld torn)", rec.path,
+                         static_cast<unsigned long>(rec.keep),
+                         static_cast<long>(rec.size - static_cast<int32_t>(rec.keep)));
+            }
+            else
+            {
+                ESP_LOGE(TAG_VFS, "recover: cannot truncate %s", rec.path);
+            }
+        }
+        (void)remove(sidecar);
+    }
+    return trimmed;
+}
+
+bool VirtualFS::truncateFile(const char *path, uint32_t len)
+{
+    const char *mount = nullptr;
+    switch (resolveStorage(path))
+    {
+    case StorageType::SD_CARD:
+        mount = SD_MOUNT_POINT;
+        break;
+    case StorageType::FLASH:
+        mount = FLASH_MOUNT_POINT;
+        break;
+    default:
+        return false;   // /ram never outlives a power cut
+    }
+    char full[96];
+    std::snprintf(full, sizeof(full), "%s%s", mount, stripPrefix(path));
+    if (mount == SD_MOUNT_POINT)
+    {
+        core::SpiLease lease(core::SpiClient::SD, core::BusPriority::NORMAL);
+        return ::truncate(full, static_cast<off_t>(len)) == 0;
+    }
+    return ::truncate(full, static_cast<off_t>(len)) == 0;
+}
+
+// ── Write-back appends ───────────────────────────────────────────────────────
+
+bool VirtualFS::addWriteBack(const char *prefix)
+{
+    if (prefix == nullptr || resolveStorage(prefix) != StorageType::SD_CARD ||
+        writeBackCount_ >= MAX_WRITE_BACK_PREFIXES)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < writeBackCount_; ++i)
+    {
+        if (std::strcmp(writeBack_[i], prefix) == 0)
+        {
+            return true;
+        }
+    }
+    writeBack_[writeBackCount_++] = prefix;
+    return true;
+}
+
+bool VirtualFS::isWriteBack(const char *path) const
+{
+    if (journal_ == nullptr || path == nullptr)
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < writeBackCount_; ++i)
+    {
+        if (std::strncmp(path, writeBack_[i], std::strlen(writeBack_[i])) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VirtualFS::noteSdUse(StorageType type)
+{
+    if (type == StorageType::SD_CARD)
+    {
+        lastSdUseMs_ = millis();
+    }
+}
+
+void VirtualFS::startWriteBack()
+{
+    if (journal_ != nullptr)
+    {
+        return;
+    }
+    journalMutex_ = xSemaphoreCreateMutexStatic(&journalMutexBuf_);
+    migrateMutex_ = xSemaphoreCreateMutexStatic(&migrateMutexBuf_);
+    (void)LittleFS.mkdir(WB_DIR);
+    auto *journal = new (std::nothrow) WriteBackJournal(g_flashVolume, g_sdVolume,
+                                                        WB_JOURNAL, WB_STATE);
+    if (journal == nullptr || journalMutex_ == nullptr || migrateMutex_ == nullptr)
+    {
+        ESP_LOGE(TAG_VFS, "write-back: init failed – appends go straight to SD");
+        delete journal;
+        return;
+    }
+    (void)journal->begin();
+    oldestPendingMs_ = millis();
+    journal_ = journal;
+
+    if (xTaskCreatePinnedToCore(writeBackTask, "io_wb", WB_TASK_STACK, this, WB_TASK_PRIO,
+                                &writeBackTask_, WB_TASK_CORE) != pdPASS)
+    {
+        writeBackTask_ = nullptr;
+        ESP_LOGE(TAG_VFS, "write-back: task create failed – journal drains on access only");
+    }
+    ESP_LOGI(TAG_VFS, "write-back journal: %lu bytes pending%s",
+             static_cast<unsigned long>(journal->pendingBytes()),
+             (journal->stats().replays > 0U) ? ", replaying interrupted batch" : "");
+}
+
+bool VirtualFS::append(const char *path, const uint8_t *data, size_t len)
+{
+    if (path == nullptr || data == nullptr || len == 0U)
+    {
+        lastError_ = "append: bad args";
+        return false;
+    }
+
+    if (isWriteBack(path))
+    {
+        xSemaphoreTake(journalMutex_, portMAX_DELAY);
+        const bool wasEmpty = journal_->pendingBytes() == 0U;
+        const bool ok = journal_->append(stripPrefix(path), data, len);
+        if (ok && wasEmpty)
+        {
+            oldestPendingMs_ = millis();
+        }
+        const bool batchReady = journal_->pendingBytes() >= WriteBackJournal::BATCH_BYTES;
+        xSemaphoreGive(journalMutex_);
+        if (ok)
+        {
+            if (batchReady && writeBackTask_ != nullptr)
+            {
+                xTaskNotifyGive(writeBackTask_);
+            }
+            lastError_ = "OK";
+            return true;
+        }
+        // Too large or journal full: open() below drains first, so the
+        // direct write still lands after every journaled record.
+    }
+
+    fs::File f = open(path, "a");
+    if (!f)
+    {
+        return false;
+    }
+    const size_t written = f.write(data, len);
+    f.close();
+    lastError_ = (written == len) ? "OK" : "append: short write";
+    return written == len;
+}
+
+bool VirtualFS::migrateStep(bool force)
+{
+    if (journal_ == nullptr || !StorageManager::instance().isMounted())
+    {
+        return false;
+    }
+    const uint32_t now = millis();
+    if (!force && now - lastSdUseMs_ < WB_SD_IDLE_MS)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(migrateMutex_, portMAX_DELAY);
+    xSemaphoreTake(journalMutex_, portMAX_DELAY);
+    const uint32_t pending = journal_->pendingBytes();
+    const bool due = pending > 0U &&
+                     (force || pending >= WriteBackJournal::BATCH_BYTES ||
+                      now - oldestPendingMs_ >= WB_MAX_AGE_MS);
+    const bool prepared = due && journal_->prepare();
+    xSemaphoreGive(journalMutex_);
+
+    // The SD write runs without the journal lock: appends keep flowing.
+    bool moved = false;
+    if (prepared && journal_->writeOut())
+    {
+        xSemaphoreTake(journalMutex_, portMAX_DELAY);
+        moved = journal_->commit();
+        oldestPendingMs_ = now;
+        xSemaphoreGive(journalMutex_);
+    }
+    xSemaphoreGive(migrateMutex_);
+    if (prepared && !moved)
+    {
+        ESP_LOGW(TAG_VFS, "write-back: batch to SD failed, retrying later");
+    }
+    return moved;
+}
+
+bool VirtualFS::syncWriteBack()
+{
+    while (writeBackPending() > 0U)
+    {
+        if (!migrateStep(true))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t VirtualFS::writeBackPending()
+{
+    if (journal_ == nullptr)
+    {
+        return 0U;
+    }
+    xSemaphoreTake(journalMutex_, portMAX_DELAY);
+    const uint32_t pending = journal_->pendingBytes();
+    xSemaphoreGive(journalMutex_);
+    return pending;
+}
+
+void VirtualFS::writeBackTask(void *arg)
+{
+    auto *self = static_cast<VirtualFS *>(arg);
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WB_POLL_MS));
+        while (self->migrateStep(false))
+        {
+            vTaskDelay(pdMS_TO_TICKS(1U));
+        }
+    }
+}
+
 // ── Status ───────────────────────────────────────────────────────────────────
 
 bool VirtualFS::sdMounted() const { return sdMounted_; }
 bool VirtualFS::flashMounted() const { return flashMounted_; }
 const char *VirtualFS::lastError() const { return lastError_; }
+RamDisk &VirtualFS::ramDisk() { return ramDisk_; }
 
 } // namespace hackos::storage
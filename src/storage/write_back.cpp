@@ -0,0 +1,370 @@
+/**
+ * @file write_back.cpp
+ * @brief Flash journal with batched SD migration (see write_back.h).
+ */
+
+#include "storage/write_back.h"
+
+#include <cstring>
+
+#include "storage/crc32.h"
+
+namespace hackos::storage {
+
+namespace
+{
+
+constexpr uint8_t MAGIC0 = 'W';
+constexpr uint8_t MAGIC1 = 'B';
+constexpr uint32_t STATE_MAGIC = 0x31534257U;   // "WBS1"
+constexpr size_t STATE_SIZE =
+    16U + WriteBackJournal::BATCH_PATHS * (WriteBackJournal::MAX_PATH + 4U) + 4U;
+
+void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, static_cast<uint16_t>(v));
+    put16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t get16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+} // namespace
+
+WriteBackJournal::WriteBackJournal(TierVolume &flash, TierVolume &sd,
+                                   const char *journalPath, const char *statePath)
+    : flash_(flash), sd_(sd), journalPath_(journalPath), statePath_(statePath),
+      committed_(0U), end_(0U), intent_(false), intentEnd_(0U), targetCount_(0U),
+      targets_{}, batchLen_(0U), batch_{}, out_{}, record_{}, stats_{}
+{
+}
+
+// ── State file ───────────────────────────────────────────────────────────────
+
+bool WriteBackJournal::loadState()
+{
+    uint8_t buf[STATE_SIZE];
+    committed_ = 0U;
+    intent_ = false;
+    intentEnd_ = 0U;
+    targetCount_ = 0U;
+    if (flash_.size(statePath_) != static_cast<int32_t>(STATE_SIZE) ||
+        flash_.read(statePath_, 0U, buf, STATE_SIZE) != STATE_SIZE ||
+        get32(buf) != STATE_MAGIC ||
+        get32(buf + STATE_SIZE - 4U) != crc32(0U, buf, STATE_SIZE - 4U) ||
+        buf[12] > BATCH_PATHS)
+    {
+        return false;
+    }
+    committed_ = get32(buf + 4);
+    intentEnd_ = get32(buf + 8);
+    intent_ = intentEnd_ != 0U;
+    targetCount_ = intent_ ? buf[12] : 0U;
+    for (size_t i = 0U; i < targetCount_; ++i)
+    {
+        const uint8_t *t = buf + 16U + i * (MAX_PATH + 4U);
+        memcpy(targets_[i].path, t, MAX_PATH);
+        targets_[i].path[MAX_PATH - 1U] = '\0';
+        targets_[i].sizeBefore = static_cast<int32_t>(get32(t + MAX_PATH));
+    }
+    return true;
+}
+
+bool WriteBackJournal::saveState()
+{
+    uint8_t buf[STATE_SIZE] = {};
+    put32(buf, STATE_MAGIC);
+    put32(buf + 4, committed_);
+    put32(buf + 8, intent_ ? intentEnd_ : 0U);
+    buf[12] = static_cast<uint8_t>(intent_ ? targetCount_ : 0U);
+    for (size_t i = 0U; intent_ && i < targetCount_; ++i)
+    {
+        uint8_t *t = buf + 16U + i * (MAX_PATH + 4U);
+        memcpy(t, targets_[i].path, MAX_PATH);
+        put32(t + MAX_PATH, static_cast<uint32_t>(targets_[i].sizeBefore));
+    }
+    put32(buf + STATE_SIZE - 4U, crc32(0U, buf, STATE_SIZE - 4U));
+    return flash_.replace(statePath_, buf, STATE_SIZE);
+}
+
+void WriteBackJournal::reset()
+{
+    (void)flash_.remove(journalPath_);
+    committed_ = 0U;
+    end_ = 0U;
+    intent_ = false;
+    targetCount_ = 0U;
+    (void)saveState();
+}
+
+bool WriteBackJournal::begin()
+{
+    (void)loadState();
+    const int32_t size = flash_.size(journalPath_);
+    end_ = (size > 0) ? static_cast<uint32_t>(size) : 0U;
+
+    // A journal shorter than the state says was dropped after its last
+    // batch reached the SD (see commit()).
+    if (end_ < committed_ || (intent_ && end_ < intentEnd_) ||
+        (end_ > 0U && end_ == committed_ && !intent_))
+    {
+        reset();
+        return true;
+    }
+    if (intent_)
+    {
+        ++stats_.replays;
+    }
+    return true;
+}
+
+// ── Records ──────────────────────────────────────────────────────────────────
+
+bool WriteBackJournal::append(const char *path, const uint8_t *data, size_t len)
+{
+    const size_t pathLen = (path != nullptr) ? strlen(path) : 0U;
+    const size_t recLen = HEADER_SIZE + pathLen + len;
+    if (pathLen == 0U || pathLen >= MAX_PATH || data == nullptr || len == 0U ||
+        len > MAX_RECORD_DATA || end_ + recLen > JOURNAL_LIMIT)
+    {
+        ++stats_.rejected;
+        return false;
+    }
+
+    record_[0] = MAGIC0;
+    record_[1] = MAGIC1;
+    record_[2] = static_cast<uint8_t>(pathLen);
+    record_[3] = 0U;
+    put16(record_ + 4, static_cast<uint16_t>(len));
+    put16(record_ + 6, 0U);
+    memcpy(record_ + HEADER_SIZE, path, pathLen);
+    memcpy(record_ + HEADER_SIZE + pathLen, data, len);
+    uint32_t crc = crc32(0U, record_, 8U);
+    crc = crc32(crc, record_ + HEADER_SIZE, pathLen + len);
+    put32(record_ + 8, crc);
+
+    if (!flash_.append(journalPath_, record_, recLen) || !flash_.sync(journalPath_))
+    {
+        // Whatever landed is skipped as torn on migration.
+        const int32_t size = flash_.size(journalPath_);
+        end_ = (size > 0) ? static_cast<uint32_t>(size) : end_;
+        ++stats_.rejected;
+        return false;
+    }
+    end_ += static_cast<uint32_t>(recLen);
+    ++stats_.appends;
+    return true;
+}
+
+int WriteBackJournal::recordAt(size_t pos, size_t avail, bool atEnd, const char **path,
+                               size_t *pathLen, const uint8_t **data, size_t *dataLen) const
+{
+    const uint8_t *r = batch_ + pos;
+    if (avail < HEADER_SIZE)
+    {
+        return atEnd ? -1 : 0;
+    }
+    const size_t pl = r[2];
+    const size_t dl = get16(r + 4);
+    if (r[0] != MAGIC0 || r[1] != MAGIC1 || pl == 0U || pl >= MAX_PATH || dl == 0U ||
+        dl > MAX_RECORD_DATA || r[3] != 0U)
+    {
+        return -1;
+    }
+    const size_t total = HEADER_SIZE + pl + dl;
+    if (total > avail)
+    {
+        return atEnd ? -1 : 0;
+    }
+    uint32_t crc = crc32(0U, r, 8U);
+    crc = crc32(crc, r + HEADER_SIZE, pl + dl);
+    if (crc != get32(r + 8))
+    {
+        return -1;
+    }
+    *path = reinterpret_cast<const char *>(r + HEADER_SIZE);
+    *pathLen = pl;
+    *data = r + HEADER_SIZE + pl;
+    *dataLen = dl;
+    return static_cast<int>(total);
+}
+
+// ── Migration ────────────────────────────────────────────────────────────────
+
+bool WriteBackJournal::prepare()
+{
+    if (intent_)
+    {
+        // Replay: reload the batch the state file describes.
+        batchLen_ = intentEnd_ - committed_;
+        return batchLen_ <= sizeof(batch_) &&
+               flash_.read(journalPath_, committed_, batch_, batchLen_) == batchLen_;
+    }
+    if (committed_ >= end_)
+    {
+        return false;
+    }
+
+    const uint32_t pending = end_ - committed_;
+    const size_t readLen = (pending < sizeof(batch_)) ? pending : sizeof(batch_);
+    if (flash_.read(journalPath_, committed_, batch_, readLen) != readLen)
+    {
+        return false;
+    }
+    const bool atEnd = readLen == pending;
+
+    size_t pos = 0U;
+    size_t dataTotal = 0U;
+    targetCount_ = 0U;
+    while (pos < readLen)
+    {
+        const char *path = nullptr;
+        const uint8_t *data = nullptr;
+        size_t pathLen = 0U;
+        size_t dataLen = 0U;
+        const int n = recordAt(pos, readLen - pos, atEnd, &path, &pathLen, &data, &dataLen);
+        if (n == 0)
+        {
+            break;
+        }
+        if (n < 0)
+        {
+            ++pos;
+            ++stats_.skippedBytes;
+            continue;
+        }
+        if (dataTotal > 0U && dataTotal + dataLen > BATCH_BYTES)
+        {
+            break;
+        }
+        size_t t = 0U;
+        while (t < targetCount_ &&
+               (strncmp(targets_[t].path, path, pathLen) != 0 || targets_[t].path[pathLen] != '\0'))
+        {
+            ++t;
+        }
+        if (t == targetCount_)
+        {
+            if (targetCount_ == BATCH_PATHS)
+            {
+                break;
+            }
+            memcpy(targets_[t].path, path, pathLen);
+            targets_[t].path[pathLen] = '\0';
+            const int32_t size = sd_.size(targets_[t].path);
+            targets_[t].sizeBefore = (size > 0) ? size : 0;
+            ++targetCount_;
+        }
+        dataTotal += dataLen;
+        pos += static_cast<size_t>(n);
+    }
+    if (pos == 0U)
+    {
+        return false;
+    }
+
+    batchLen_ = pos;
+    intentEnd_ = committed_ + static_cast<uint32_t>(pos);
+    intent_ = true;
+    if (!saveState())
+    {
+        intent_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool WriteBackJournal::writeOut()
+{
+    if (!intent_ || !sd_.available())
+    {
+        return false;
+    }
+    for (size_t t = 0U; t < targetCount_; ++t)
+    {
+        const Target &target = targets_[t];
+        const size_t pathLen = strlen(target.path);
+        size_t n = 0U;
+        size_t pos = 0U;
+        while (pos < batchLen_)
+        {
+            const char *path = nullptr;
+            const uint8_t *data = nullptr;
+            size_t pl = 0U;
+            size_t dl = 0U;
+            const int len = recordAt(pos, batchLen_ - pos, true, &path, &pl, &data, &dl);
+            if (len < 0)
+            {
+                ++pos;
+                continue;
+            }
+            if (pl == pathLen && memcmp(path, target.path, pl) == 0 && n + dl <= sizeof(out_))
+            {
+                memcpy(out_ + n, data, dl);
+                n += dl;
+            }
+            pos += static_cast<size_t>(len);
+        }
+
+        // Bytes a crashed earlier attempt already appended.
+        const int32_t size = sd_.size(target.path);
+        int32_t grown = (size > target.sizeBefore) ? size - target.sizeBefore : 0;
+        grown = (static_cast<size_t>(grown) > n) ? static_cast<int32_t>(n) : grown;
+        const size_t done = static_cast<size_t>(grown);
+        // Durable before commit() may advance past these records.
+        if (done < n && (!sd_.append(target.path, out_ + done, n - done) ||
+                         !sd_.sync(target.path)))
+        {
+            return false;
+        }
+        stats_.migratedBytes += static_cast<uint32_t>(n - done);
+    }
+    return true;
+}
+
+bool WriteBackJournal::commit()
+{
+    if (!intent_)
+    {
+        return false;
+    }
+    committed_ = intentEnd_;
+    intent_ = false;
+    targetCount_ = 0U;
+    ++stats_.batches;
+    if (committed_ >= end_)
+    {
+        // Drained.  A crash between these two steps is caught by begin().
+        (void)flash_.remove(journalPath_);
+        committed_ = 0U;
+        end_ = 0U;
+    }
+    return saveState();
+}
+
+bool WriteBackJournal::migrateAll()
+{
+    while (intent_ || committed_ < end_)
+    {
+        if (!prepare() || !writeOut() || !commit())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace hackos::storage
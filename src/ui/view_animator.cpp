@@ -11,34 +11,49 @@
 namespace hackos {
 namespace ui {
 
+namespace
+{
+
+constexpr const char *SCRATCH_SCENES = "anim";
+
+} // namespace
+
 ViewAnimator::ViewAnimator()
-    : dir_(Direction::LEFT)
+    : scenes_()
+    , dir_(Direction::LEFT)
     , durationMs_(200U)
     , elapsedMs_(0U)
     , active_(false)
 {
-    memset(bufOut_, 0, BUF_SIZE);
-    memset(bufIn_,  0, BUF_SIZE);
+}
+
+bool ViewAnimator::holdScenes()
+{
+    return scenes_.acquire(SCRATCH_SCENES);
 }
 
 void ViewAnimator::captureOutgoing(const uint8_t *src)
 {
-    if (src != nullptr)
+    if (src != nullptr && holdScenes())
     {
-        memcpy(bufOut_, src, BUF_SIZE);
+        memcpy(scenes_->out, src, BUF_SIZE);
     }
 }
 
 void ViewAnimator::captureIncoming(const uint8_t *src)
 {
-    if (src != nullptr)
+    if (src != nullptr && holdScenes())
     {
-        memcpy(bufIn_, src, BUF_SIZE);
+        memcpy(scenes_->in, src, BUF_SIZE);
     }
 }
 
 void ViewAnimator::startSlide(Direction dir, uint16_t durationMs)
 {
+    if (!scenes_)
+    {
+        return;
+    }
     dir_        = dir;
     durationMs_ = (durationMs > 0U) ? durationMs : 1U;
     elapsedMs_  = 0U;
@@ -56,8 +71,8 @@ bool ViewAnimator::tick(uint8_t *dst, uint16_t frameDelta)
     if (elapsedMs_ >= durationMs_)
     {
         // Animation complete – copy incoming buffer directly.
-        memcpy(dst, bufIn_, BUF_SIZE);
-        active_ = false;
+        memcpy(dst, scenes_->in, BUF_SIZE);
+        cancel();
         return false;
     }
 
@@ -92,11 +107,11 @@ bool ViewAnimator::tick(uint8_t *dst, uint16_t frameDelta)
 
             if (srcOutX >= 0 && srcOutX < SCREEN_W)
             {
-                pixel = readPixel(bufOut_, srcOutX, y);
+                pixel = readPixel(scenes_->out, srcOutX, y);
             }
             else if (srcInX >= 0 && srcInX < SCREEN_W)
             {
-                pixel = readPixel(bufIn_, srcInX, y);
+                pixel = readPixel(scenes_->in, srcInX, y);
             }
 
             if (pixel)
@@ -117,6 +132,7 @@ bool ViewAnimator::isAnimating() const
 void ViewAnimator::cancel()
 {
     active_ = false;
+    scenes_.release();
 }
 
 // ── Pixel helpers (SSD1306 page-addressing) ──────────────────────────────────
@@ -0,0 +1,242 @@
+/**
+ * @file adc_dsp_bench.cpp
+ * @brief Host tool: accuracy and throughput of the ADC block kernels.
+ *
+ * Synthetic 12-bit signals are run through the kernels the AdcStream
+ * worker uses:
+ *
+ *  - blockStats against a double-precision reference
+ *  - unpackI2sAdc pair order and channel masking
+ *  - Oversampler: error of a DC level under 1.5 LSB noise for 4^0..4^4
+ *  - FirDecimator: pass-band and alias-band gain of the default low-pass
+ *  - throughput of every kernel in samples per second
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/adc_dsp_bench.cpp \
+ *      src/hardware/adc/adc_dsp.cpp -o adc_dsp_bench
+ *  ./adc_dsp_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "hardware/adc/adc_dsp.h"
+
+using hackos::adc::AdcBlockStats;
+using hackos::adc::FirDecimator;
+using hackos::adc::Oversampler;
+
+namespace
+{
+
+constexpr size_t BLOCK = 512U;            ///< AdcStream::BLOCK_SAMPLES
+constexpr size_t SIGNAL_SAMPLES = 1U << 20;
+constexpr size_t FIR_TAPS = 31U;          ///< AdcStream::FIR_TAPS
+constexpr double PI = 3.14159265358979323846;
+
+std::mt19937 g_rng(1U);
+
+uint16_t quantise(double v)
+{
+    const double r = std::floor(v + 0.5);
+    return static_cast<uint16_t>(r < 0.0 ? 0.0 : (r > 4095.0 ? 4095.0 : r));
+}
+
+std::vector<uint16_t> noisyDc(double level, double sigma, size_t n)
+{
+    std::normal_distribution<double> noise(0.0, sigma);
+    std::vector<uint16_t> s(n);
+    for (uint16_t &v : s)
+    {
+        v = quantise(level + noise(g_rng));
+    }
+    return s;
+}
+
+std::vector<uint16_t> tone(double cyclesPerSample, double amplitude, size_t n)
+{
+    std::vector<uint16_t> s(n);
+    for (size_t i = 0U; i < n; ++i)
+    {
+        s[i] = quantise(2048.0 + amplitude * std::sin(2.0 * PI * cyclesPerSample * i));
+    }
+    return s;
+}
+
+/// Sine amplitude (√2 × RMS about the mean) after the filter settles.
+double amplitude(const std::vector<uint16_t> &s, size_t skip)
+{
+    double mean = 0.0;
+    for (size_t i = skip; i < s.size(); ++i)
+    {
+        mean += s[i];
+    }
+    mean /= static_cast<double>(s.size() - skip);
+    double var = 0.0;
+    for (size_t i = skip; i < s.size(); ++i)
+    {
+        var += (s[i] - mean) * (s[i] - mean);
+    }
+    return std::sqrt(2.0 * var / static_cast<double>(s.size() - skip));
+}
+
+template <typename Fn>
+double nsPerSample(size_t samples, int passes, Fn fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < passes; ++p)
+    {
+        fn();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    return ns / passes / static_cast<double>(samples);
+}
+
+bool checkStats()
+{
+    const std::vector<uint16_t> s = noisyDc(1234.3, 7.0, BLOCK);
+    AdcBlockStats st;
+    hackos::adc::blockStats(s.data(), s.size(), &st);
+
+    double mean = 0.0;
+    for (uint16_t v : s)
+    {
+        mean += v;
+    }
+    mean /= s.size();
+    double var = 0.0;
+    for (uint16_t v : s)
+    {
+        var += (v - mean) * (v - mean);
+    }
+    const double rms = std::sqrt(var / s.size());
+
+    const double meanErr = std::fabs(st.meanQ4 / 16.0 - mean);
+    const double rmsErr = std::fabs(st.acRmsQ4 / 16.0 - rms);
+    const bool ok = meanErr <= 1.0 / 16.0 && rmsErr <= 1.0 / 16.0;
+    std::printf("blockStats   mean %.3f (ref %.3f)  rms %.3f (ref %.3f)  %s\n",
+                st.meanQ4 / 16.0, mean, st.acRmsQ4 / 16.0, rms, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool checkUnpack()
+{
+    // Channel 6 in the top nibble, pairs swapped as the I2S FIFO delivers.
+    uint16_t words[4] = {0x6000U | 2U, 0x6000U | 1U, 0x6000U | 4U, 0x6000U | 3U};
+    const size_t n = hackos::adc::unpackI2sAdc(words, 4U);
+    const bool ok = n == 4U && words[0] == 1U && words[1] == 2U && words[2] == 3U &&
+                    words[3] == 4U;
+    std::printf("unpackI2sAdc %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+void reportOversampling()
+{
+    const double level = 1000.37;
+    const std::vector<uint16_t> s = noisyDc(level, 1.5, SIGNAL_SAMPLES);
+    std::vector<uint16_t> out(SIGNAL_SAMPLES);
+
+    std::printf("\noversampling of a DC level under 1.5 LSB noise:\n");
+    for (uint8_t bits = 0U; bits <= Oversampler::MAX_EXTRA_BITS; ++bits)
+    {
+        Oversampler os;
+        os.configure(bits);
+        const size_t n = os.process(s.data(), s.size(), out.data());
+        double err2 = 0.0;
+        const double scale = static_cast<double>(1U << bits);
+        for (size_t i = 0U; i < n; ++i)
+        {
+            const double e = out[i] / scale - level;
+            err2 += e * e;
+        }
+        const double rms = std::sqrt(err2 / n);
+        std::printf("  x%-4lu %2u bit  rms error %.3f LSB12  (~%.1f effective bits)\n",
+                    static_cast<unsigned long>(os.factor()), 12U + bits, rms,
+                    12.0 - std::log2(rms * std::sqrt(12.0)));
+    }
+}
+
+bool reportFir()
+{
+    constexpr uint8_t M = 4U;
+    FirDecimator fir;
+    fir.configureLowpass(FIR_TAPS, M);
+    std::vector<uint16_t> out(SIGNAL_SAMPLES / M + 1U);
+
+    // Pass band: 0.1 of the output rate.  Alias band: a tone that would
+    // fold onto the same output frequency without the filter.
+    const double inPass = 0.1 / M;
+    const double inAlias = 1.0 / M - inPass;
+    std::vector<uint16_t> pass = tone(inPass, 1500.0, 1U << 16);
+    std::vector<uint16_t> alias = tone(inAlias, 1500.0, 1U << 16);
+
+    fir.reset();
+    out.resize(fir.process(pass.data(), pass.size(), out.data()));
+    const double gPass = amplitude(out, FIR_TAPS) / 1500.0;
+    out.resize(SIGNAL_SAMPLES / M + 1U);
+    fir.reset();
+    out.resize(fir.process(alias.data(), alias.size(), out.data()));
+    const double gAlias = amplitude(out, FIR_TAPS) / 1500.0;
+
+    const double passDb = 20.0 * std::log10(gPass);
+    // A residue below half an LSB quantises away; report that floor.
+    const double floorDb = 20.0 * std::log10(0.5 / 1500.0);
+    const double aliasDb = (gAlias > 0.0) ? 20.0 * std::log10(gAlias) : floorDb;
+    const bool ok = passDb > -0.5 && aliasDb < -40.0;
+    std::printf("\nFIR %zu taps /%u: pass band %.2f dB, alias band %s%.1f dB  %s\n", FIR_TAPS,
+                M, passDb, (gAlias > 0.0) ? "" : "< ", aliasDb, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+void reportThroughput()
+{
+    const std::vector<uint16_t> s = noisyDc(2000.0, 3.0, BLOCK);
+    std::vector<uint16_t> work(BLOCK);
+    constexpr int PASSES = 20000;
+    volatile uint32_t sink = 0U;
+
+    std::printf("\nthroughput (%zu-sample blocks):\n", BLOCK);
+    const double stats = nsPerSample(BLOCK, PASSES, [&] {
+        AdcBlockStats st;
+        hackos::adc::blockStats(s.data(), s.size(), &st);
+        sink = sink + st.meanQ4;
+    });
+    const double unpack = nsPerSample(BLOCK, PASSES, [&] {
+        work.assign(s.begin(), s.end());
+        hackos::adc::unpackI2sAdc(work.data(), work.size());
+        sink = sink + work[0];
+    });
+    Oversampler os;
+    os.configure(2U);
+    const double over = nsPerSample(BLOCK, PASSES, [&] {
+        sink = sink + static_cast<uint32_t>(os.process(s.data(), s.size(), work.data()));
+    });
+    FirDecimator fir;
+    fir.configureLowpass(FIR_TAPS, 4U);
+    const double firNs = nsPerSample(BLOCK, PASSES, [&] {
+        sink = sink + static_cast<uint32_t>(fir.process(s.data(), s.size(), work.data()));
+    });
+
+    std::printf("  blockStats      %6.2f ns/sample  %7.1f MS/s\n", stats, 1000.0 / stats);
+    std::printf("  unpackI2sAdc    %6.2f ns/sample  %7.1f MS/s\n", unpack, 1000.0 / unpack);
+    std::printf("  Oversampler x16 %6.2f ns/sample  %7.1f MS/s\n", over, 1000.0 / over);
+    std::printf("  FIR %zu taps /4  %6.2f ns/sample  %7.1f MS/s\n", FIR_TAPS, firNs,
+                1000.0 / firNs);
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = checkStats();
+    ok &= checkUnpack();
+    reportOversampling();
+    ok &= reportFir();
+    reportThroughput();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,635 @@
+/**
+ * @file containers_bench.cpp
+ * @brief Host tool: fixed-capacity containers against std:: models, plus
+ *        the cost of the hand-rolled code they replace.
+ *
+ *  1. constexpr: each container is built and queried in a constant
+ *     expression (static_assert, so this part "runs" at compile time).
+ *  2. Differential: random operation streams applied to each container and
+ *     to a std:: model (vector, deque, map, unordered_map, string, list);
+ *     every result and the full contents must agree.  Build with
+ *     -DHACKOS_DEBUG to run the same streams with the bounds checks on.
+ *  3. Throughput on table sizes the firmware uses:
+ *     - lookup in 64 entries: linear array scan vs FlatMap vs FixedHashMap
+ *     - erase from an 8-entry observer list: manual shift vs erase() vs
+ *       eraseUnordered()
+ *     - 24-char name copy: strncpy + terminate vs InlineString::assign()
+ *     - last-N history: RingDeque vs std::deque
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/containers_bench.cpp -o containers_bench
+ *  ./containers_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/containers/fixed_hash_map.h"
+#include "core/containers/flat_map.h"
+#include "core/containers/inline_string.h"
+#include "core/containers/intrusive_list.h"
+#include "core/containers/ring_deque.h"
+#include "core/containers/static_vector.h"
+
+using hackos::core::FixedHashMap;
+using hackos::core::FlatMap;
+using hackos::core::InlineString;
+using hackos::core::IntrusiveList;
+using hackos::core::IntrusiveNode;
+using hackos::core::RingDeque;
+using hackos::core::StaticVector;
+
+namespace
+{
+
+// ── 1. constexpr ─────────────────────────────────────────────────────────────
+
+constexpr StaticVector<int, 8U> makeVector()
+{
+    StaticVector<int, 8U> v;
+    for (int i = 0; i < 6; ++i)
+    {
+        v.push(i * 10);
+    }
+    v.erase(1U);
+    v.insert(0U, -1);
+    v.eraseUnordered(2U);
+    (void)v.removeIf([](int x) { return x == 50; });
+    return v;
+}
+static_assert(makeVector().size() == 4U && makeVector()[0] == -1 && makeVector()[2] == 30 &&
+                  makeVector().back() == 40,
+              "StaticVector constexpr");
+
+constexpr InlineString<8U> NAME("hackos-device");
+static_assert(NAME.size() == 8U && NAME == "hackos-d" && NAME.startsWith("hack"),
+              "InlineString constexpr truncation");
+
+constexpr FlatMap<int, int, 8U> makeFlat()
+{
+    FlatMap<int, int, 8U> m;
+    m.insert(5, 50);
+    m.insert(1, 10);
+    m.insert(3, 30);
+    m.set(3, 33);
+    m.erase(1);
+    return m;
+}
+static_assert(makeFlat().size() == 2U && *makeFlat().find(3) == 33 && !makeFlat().contains(1) &&
+                  makeFlat().at(0U).key == 3,
+              "FlatMap constexpr");
+
+constexpr FixedHashMap<uint32_t, int, 16U> makeHash()
+{
+    FixedHashMap<uint32_t, int, 16U> m;
+    for (uint32_t k = 0U; k < 12U; ++k)
+    {
+        m.insert(k * 16U, static_cast<int>(k));   // one home slot without mixing
+    }
+    const bool overfull = m.insert(999U, 0);   // MAX_SIZE = 12
+    m.erase(32U);
+    m.set(999U, overfull ? 1 : -1);
+    return m;
+}
+static_assert(makeHash().size() == 12U && !makeHash().contains(32U) && *makeHash().find(176U) == 11 &&
+                  *makeHash().find(999U) == -1,
+              "FixedHashMap constexpr");
+
+constexpr RingDeque<int, 4U> makeDeque()
+{
+    RingDeque<int, 4U> d;
+    d.pushBack(1);
+    d.pushBack(2);
+    d.pushFront(0);
+    d.pushBack(3);
+    d.pushBackOverwrite(4);
+    d.popBack();
+    return d;
+}
+static_assert(makeDeque().size() == 3U && makeDeque().front() == 1 && makeDeque().back() == 3,
+              "RingDeque constexpr");
+
+// ── 2. Differential ──────────────────────────────────────────────────────────
+
+uint32_t g_failures = 0U;
+
+void expect(bool cond, const char *what, uint32_t step)
+{
+    if (!cond && g_failures++ < 10U)
+    {
+        std::printf("  mismatch: %s at step %u\n", what, step);
+    }
+}
+
+void diffStaticVector(std::mt19937 &rng, uint32_t steps)
+{
+    StaticVector<uint16_t, 16U> v;
+    std::vector<uint16_t> m;
+    for (uint32_t s = 0U; s < steps; ++s)
+    {
+        const uint16_t x = static_cast<uint16_t>(rng() % 32U);
+        switch (rng() % 7U)
+        {
+        case 0:
+        case 1:
+            expect(v.push(x) == (m.size() < 16U), "StaticVector push", s);
+            if (m.size() < 16U)
+            {
+                m.push_back(x);
+            }
+            break;
+        case 2:
+        {
+            const size_t at = rng() % (m.size() + 2U);
+            const bool ok = m.size() < 16U && at <= m.size();
+            expect(v.insert(at, x) == ok, "StaticVector insert", s);
+            if (ok)
+            {
+                m.insert(m.begin() + static_cast<std::ptrdiff_t>(at), x);
+            }
+            break;
+        }
+        case 3:
+            if (!m.empty())
+            {
+                const size_t i = rng() % m.size();
+                v.erase(i);
+                m.erase(m.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            break;
+        case 4:
+            if (!m.empty())
+            {
+                const size_t i = rng() % m.size();
+                v.eraseUnordered(i);
+                m[i] = m.back();
+                m.pop_back();
+            }
+            break;
+        case 5:
+        {
+            auto it = std::find(m.begin(), m.end(), x);
+            expect(v.remove(x) == (it != m.end()), "StaticVector remove", s);
+            if (it != m.end())
+            {
+                m.erase(it);
+            }
+            break;
+        }
+        default:
+            expect(v.pop() == !m.empty(), "StaticVector pop", s);
+            if (!m.empty())
+            {
+                m.pop_back();
+            }
+            break;
+        }
+        expect(v.size() == m.size() && std::equal(m.begin(), m.end(), v.begin()),
+               "StaticVector contents", s);
+    }
+}
+
+void diffRingDeque(std::mt19937 &rng, uint32_t steps)
+{
+    RingDeque<uint32_t, 13U> d;
+    std::deque<uint32_t> m;
+    for (uint32_t s = 0U; s < steps; ++s)
+    {
+        const uint32_t x = rng();
+        uint32_t out = 0U;
+        switch (rng() % 6U)
+        {
+        case 0:
+            expect(d.pushBack(x) == (m.size() < 13U), "RingDeque pushBack", s);
+            if (m.size() < 13U)
+            {
+                m.push_back(x);
+            }
+            break;
+        case 1:
+            expect(d.pushFront(x) == (m.size() < 13U), "RingDeque pushFront", s);
+            if (m.size() < 13U)
+            {
+                m.push_front(x);
+            }
+            break;
+        case 2:
+            expect(d.pushBackOverwrite(x) == (m.size() == 13U), "RingDeque overwrite", s);
+            if (m.size() == 13U)
+            {
+                m.pop_front();
+            }
+            m.push_back(x);
+            break;
+        case 3:
+            expect(d.popFront(out) == !m.empty() && (m.empty() || out == m.front()),
+                   "RingDeque popFront", s);
+            if (!m.empty())
+            {
+                m.pop_front();
+            }
+            break;
+        default:
+            expect(d.popBack(out) == !m.empty() && (m.empty() || out == m.back()),
+                   "RingDeque popBack", s);
+            if (!m.empty())
+            {
+                m.pop_back();
+            }
+            break;
+        }
+        bool same = d.size() == m.size();
+        for (size_t i = 0U; same && i < m.size(); ++i)
+        {
+            same = d[i] == m[i];
+        }
+        expect(same, "RingDeque contents", s);
+    }
+}
+
+template <typename Map>
+void diffMap(std::mt19937 &rng, uint32_t steps, uint32_t keySpace, const char *name)
+{
+    Map t;
+    std::map<uint32_t, uint32_t> m;
+    const size_t cap = Map::capacity();
+    for (uint32_t s = 0U; s < steps; ++s)
+    {
+        const uint32_t k = rng() % keySpace;
+        const uint32_t v = rng();
+        const bool has = m.count(k) != 0U;
+        switch (rng() % 4U)
+        {
+        case 0:
+            expect(t.insert(k, v) == (!has && m.size() < cap), name, s);
+            if (!has && m.size() < cap)
+            {
+                m[k] = v;
+            }
+            break;
+        case 1:
+            expect(t.set(k, v) == (has || m.size() < cap), name, s);
+            if (has || m.size() < cap)
+            {
+                m[k] = v;
+            }
+            break;
+        case 2:
+            expect(t.erase(k) == has, name, s);
+            m.erase(k);
+            break;
+        default:
+        {
+            const uint32_t *got = t.find(k);
+            expect((got != nullptr) == has && (!has || *got == m[k]), name, s);
+            break;
+        }
+        }
+        expect(t.size() == m.size(), name, s);
+    }
+    for (const auto &kv : m)
+    {
+        const uint32_t *got = t.find(kv.first);
+        expect(got != nullptr && *got == kv.second, name, steps);
+    }
+}
+
+void diffInlineString(std::mt19937 &rng, uint32_t steps)
+{
+    InlineString<12U> a;
+    std::string m;
+    char word[20] = {};
+    for (uint32_t s = 0U; s < steps; ++s)
+    {
+        const size_t len = rng() % 8U;
+        for (size_t i = 0U; i < len; ++i)
+        {
+            word[i] = static_cast<char>('a' + rng() % 26U);
+        }
+        word[len] = '\0';
+        switch (rng() % 4U)
+        {
+        case 0:
+            expect(a.assign(word) == (len <= 12U), "InlineString assign", s);
+            m.assign(word, len > 12U ? 12U : len);
+            break;
+        case 1:
+        {
+            const bool fits = m.size() + len <= 12U;
+            expect(a.append(word) == fits, "InlineString append", s);
+            m += std::string(word).substr(0U, 12U - m.size());
+            break;
+        }
+        case 2:
+        {
+            char tmp[40];
+            std::snprintf(tmp, sizeof(tmp), "%u:%s", static_cast<unsigned>(s % 100U), word);
+            const bool fits = m.size() + std::strlen(tmp) <= 12U;
+            expect(a.appendf("%u:%s", static_cast<unsigned>(s % 100U), word) == fits,
+                   "InlineString appendf", s);
+            m += std::string(tmp).substr(0U, 12U - m.size());
+            break;
+        }
+        default:
+            a.truncate(len);
+            if (len < m.size())
+            {
+                m.resize(len);
+            }
+            break;
+        }
+        expect(a.size() == m.size() && std::strlen(a.c_str()) == m.size() && a == m.c_str() &&
+                   a.startsWith(m.substr(0U, m.size() / 2U).c_str()),
+               "InlineString contents", s);
+    }
+}
+
+struct Item
+{
+    IntrusiveNode link;
+    uint32_t id;
+};
+
+void diffIntrusiveList(std::mt19937 &rng, uint32_t steps)
+{
+    static Item items[32];
+    IntrusiveList<Item, &Item::link> list;
+    std::list<uint32_t> m;
+    for (uint32_t i = 0U; i < 32U; ++i)
+    {
+        items[i].id = i;
+    }
+    for (uint32_t s = 0U; s < steps; ++s)
+    {
+        Item &it = items[rng() % 32U];
+        const bool on = IntrusiveList<Item, &Item::link>::linked(it);
+        expect(on == (std::find(m.begin(), m.end(), it.id) != m.end()), "IntrusiveList linked", s);
+        switch (rng() % 4U)
+        {
+        case 0:
+            if (!on)
+            {
+                list.pushBack(it);
+                m.push_back(it.id);
+            }
+            break;
+        case 1:
+            if (!on)
+            {
+                list.pushFront(it);
+                m.push_front(it.id);
+            }
+            break;
+        case 2:
+            if (on)
+            {
+                list.remove(it);
+                m.remove(it.id);
+            }
+            break;
+        default:
+        {
+            const Item *p = list.popFront();
+            expect((p != nullptr) == !m.empty() && (p == nullptr || p->id == m.front()),
+                   "IntrusiveList popFront", s);
+            if (!m.empty())
+            {
+                m.pop_front();
+            }
+            break;
+        }
+        }
+        bool same = list.size() == m.size();
+        auto mi = m.begin();
+        for (const Item &x : list)
+        {
+            same = same && mi != m.end() && x.id == *mi;
+            ++mi;
+        }
+        expect(same, "IntrusiveList contents", s);
+    }
+    list.clear();
+}
+
+// ── 3. Throughput ────────────────────────────────────────────────────────────
+
+template <typename Fn>
+double nsPer(uint32_t n, Fn fn)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+volatile uint32_t g_sink = 0U;
+
+void throughput()
+{
+    std::mt19937 rng(3U);
+    constexpr size_t ENTRIES = 64U;
+    constexpr uint32_t N = 4000000U;
+
+    // Lookup: AP table keyed by the low 32 bits of a BSSID.
+    uint32_t keys[ENTRIES];
+    struct Row
+    {
+        uint32_t key;
+        uint32_t value;
+    } rows[ENTRIES];
+    FlatMap<uint32_t, uint32_t, ENTRIES> flat;
+    FixedHashMap<uint32_t, uint32_t, 128U> hash;
+    for (size_t i = 0U; i < ENTRIES; ++i)
+    {
+        keys[i] = rng();
+        rows[i] = {keys[i], static_cast<uint32_t>(i)};
+        flat.insert(keys[i], static_cast<uint32_t>(i));
+        hash.insert(keys[i], static_cast<uint32_t>(i));
+    }
+    uint32_t probes[1024];
+    for (uint32_t &p : probes)
+    {
+        p = (rng() % 4U == 0U) ? rng() : keys[rng() % ENTRIES];   // 25 % misses
+    }
+    const double linear = nsPer(N, [&] {
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            const uint32_t k = probes[i & 1023U];
+            for (const Row &r : rows)
+            {
+                if (r.key == k)
+                {
+                    acc += r.value;
+                    break;
+                }
+            }
+        }
+        g_sink = acc;
+    });
+    const double binary = nsPer(N, [&] {
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            const uint32_t *v = flat.find(probes[i & 1023U]);
+            acc += (v != nullptr) ? *v : 0U;
+        }
+        g_sink = acc;
+    });
+    const double hashed = nsPer(N, [&] {
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            const uint32_t *v = hash.find(probes[i & 1023U]);
+            acc += (v != nullptr) ? *v : 0U;
+        }
+        g_sink = acc;
+    });
+    std::printf("Lookup, %zu entries: linear %.1f ns, FlatMap %.1f ns, FixedHashMap %.1f ns "
+                "(max probe %zu)\n",
+                ENTRIES, linear, binary, hashed, hash.maxProbe());
+
+    // Erase + re-add on an 8-entry observer list.
+    void *handles[8];
+    for (size_t i = 0U; i < 8U; ++i)
+    {
+        handles[i] = &handles[i];
+    }
+    const double manual = nsPer(N, [&] {
+        void *arr[8];
+        size_t count = 8U;
+        std::memcpy(arr, handles, sizeof(arr));
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            void *h = handles[i & 7U];
+            for (size_t j = 0U; j < count; ++j)
+            {
+                if (arr[j] == h)
+                {
+                    for (size_t k = j; k + 1U < count; ++k)
+                    {
+                        arr[k] = arr[k + 1U];
+                    }
+                    --count;
+                    break;
+                }
+            }
+            arr[count++] = h;
+        }
+        g_sink = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(arr[0]));
+    });
+    const double ordered = nsPer(N, [&] {
+        StaticVector<void *, 8U> v;
+        for (void *h : handles)
+        {
+            v.push(h);
+        }
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            void *h = handles[i & 7U];
+            v.remove(h);
+            v.push(h);
+        }
+        g_sink = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(v[0]));
+    });
+    const double unordered = nsPer(N, [&] {
+        StaticVector<void *, 8U> v;
+        for (void *h : handles)
+        {
+            v.push(h);
+        }
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            void *h = handles[i & 7U];
+            v.eraseUnordered(v.indexOf(h));
+            v.push(h);
+        }
+        g_sink = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(v[0]));
+    });
+    std::printf("Remove + add, 8 observers: manual shift %.1f ns, erase() %.1f ns, "
+                "eraseUnordered() %.1f ns\n",
+                manual, ordered, unordered);
+
+    // Name copy.
+    const char *names[4] = {"Flipper-Zero-Lab", "ESP32_HackOS_AccessPoint_5G", "tv", "garage-door-433"};
+    const double strn = nsPer(N, [&] {
+        char buf[25];
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            std::strncpy(buf, names[i & 3U], sizeof(buf) - 1U);
+            buf[sizeof(buf) - 1U] = '\0';
+            acc += static_cast<uint8_t>(buf[1]);
+        }
+        g_sink = acc;
+    });
+    const double inl = nsPer(N, [&] {
+        InlineString<24U> s;
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            s.assign(names[i & 3U]);
+            acc += static_cast<uint8_t>(s.c_str()[1]);
+        }
+        g_sink = acc;
+    });
+    std::printf("Name copy, 24 chars: strncpy %.1f ns, InlineString::assign %.1f ns\n", strn, inl);
+
+    // Last-64 history.
+    const double ring = nsPer(N, [&] {
+        RingDeque<uint32_t, 64U> d;
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            d.pushBackOverwrite(i);
+            acc += d.front();
+        }
+        g_sink = acc;
+    });
+    const double stdq = nsPer(N, [&] {
+        std::deque<uint32_t> d;
+        uint32_t acc = 0U;
+        for (uint32_t i = 0U; i < N; ++i)
+        {
+            if (d.size() == 64U)
+            {
+                d.pop_front();
+            }
+            d.push_back(i);
+            acc += d.front();
+        }
+        g_sink = acc;
+    });
+    std::printf("History of 64: RingDeque %.1f ns, std::deque %.1f ns (host)\n", ring, stdq);
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("Bounds checks: %s\n", HACKOS_CONTAINER_CHECKS ? "on" : "off");
+    std::mt19937 rng(2024U);
+    constexpr uint32_t STEPS = 200000U;
+    diffStaticVector(rng, STEPS);
+    diffRingDeque(rng, STEPS);
+    diffMap<FlatMap<uint32_t, uint32_t, 24U>>(rng, STEPS, 40U, "FlatMap");
+    diffMap<FixedHashMap<uint32_t, uint32_t, 32U>>(rng, STEPS, 40U, "FixedHashMap");
+    diffMap<FixedHashMap<uint32_t, uint32_t, 64U>>(rng, STEPS, 1000U, "FixedHashMap sparse");
+    diffInlineString(rng, STEPS);
+    diffIntrusiveList(rng, STEPS);
+    std::printf("Differential: 7 containers x %u random ops, %u mismatches  %s\n", STEPS,
+                g_failures, (g_failures == 0U) ? "ok" : "FAIL");
+
+    throughput();
+    std::printf("%s\n", (g_failures == 0U) ? "all ok" : "FAILED");
+    return (g_failures == 0U) ? 0 : 1;
+}
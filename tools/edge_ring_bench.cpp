@@ -0,0 +1,263 @@
+/**
+ * @file edge_ring_bench.cpp
+ * @brief Host tool: correctness and cost of the shared edge ring.
+ *
+ * Feeds a synthetic Princeton-style OOK train (350 µs base at 240 MHz
+ * cycle timestamps) into an EdgeRing the way the EdgeCapture ISR does and
+ * checks:
+ *
+ *  - pulses read back match the train exactly with the filter off
+ *  - injected 2-8 µs noise spikes are removed by a 20 µs glitch window
+ *    without disturbing the real pulses
+ *  - two readers see identical pulses; a reader that falls behind skips
+ *    ahead and reports the edges it lost
+ *  - producer cost per edge (what the ISR adds after its timestamp)
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/edge_ring_bench.cpp \
+ *      src/hardware/edge/edge_ring.cpp -o edge_ring_bench
+ *  ./edge_ring_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "hardware/edge/edge_ring.h"
+
+using hackos::edge::EdgeReader;
+using hackos::edge::EdgeRing;
+using hackos::edge::EdgeRingStats;
+
+namespace
+{
+
+constexpr uint32_t CYCLES_PER_US = 240U;
+constexpr uint32_t BASE_US = 350U;
+constexpr int32_t MAX_US = 100000;
+constexpr size_t RING_EDGES = 1024U;
+
+struct Edge
+{
+    uint32_t cycles;
+    uint8_t level;
+};
+
+/// Frames of sync + 24 bits; returns the edges and the expected pulses.
+void buildTrain(size_t frames, uint32_t startCycles, std::vector<Edge> *edges,
+                std::vector<int32_t> *pulses)
+{
+    std::mt19937 rng(7U);
+    uint32_t t = startCycles;
+    auto pulse = [&](uint32_t highUs, uint32_t lowUs) {
+        edges->push_back({t, 1U});
+        t += highUs * CYCLES_PER_US;
+        edges->push_back({t, 0U});
+        t += lowUs * CYCLES_PER_US;
+        pulses->push_back(static_cast<int32_t>(highUs));
+        pulses->push_back(-static_cast<int32_t>(lowUs));
+    };
+    for (size_t f = 0U; f < frames; ++f)
+    {
+        pulse(BASE_US, 31U * BASE_US);
+        const uint32_t code = rng() & 0xFFFFFFU;
+        for (int b = 23; b >= 0; --b)
+        {
+            if ((code >> b) & 1U)
+            {
+                pulse(3U * BASE_US, BASE_US);
+            }
+            else
+            {
+                pulse(BASE_US, 3U * BASE_US);
+            }
+        }
+    }
+    edges->push_back({t, 1U}); // closes the last LOW
+}
+
+/// Insert a short opposite pulse inside every @p every-th pulse.
+std::vector<Edge> withSpikes(const std::vector<Edge> &clean, size_t every, size_t *spikes)
+{
+    std::mt19937 rng(11U);
+    std::vector<Edge> out;
+    *spikes = 0U;
+    for (size_t i = 0U; i + 1U < clean.size(); ++i)
+    {
+        out.push_back(clean[i]);
+        if (i % every == every - 1U)
+        {
+            const uint32_t span = clean[i + 1U].cycles - clean[i].cycles;
+            const uint32_t at = clean[i].cycles + span / 2U;
+            const uint32_t width = (2U + rng() % 7U) * CYCLES_PER_US;
+            const uint8_t inv = static_cast<uint8_t>(clean[i].level ^ 1U);
+            out.push_back({at, inv});
+            out.push_back({at + width, clean[i].level});
+            ++*spikes;
+        }
+    }
+    out.push_back(clean.back());
+    return out;
+}
+
+std::vector<int32_t> drain(EdgeReader &r)
+{
+    std::vector<int32_t> got;
+    int32_t buf[100];
+    size_t n;
+    while ((n = r.readPulses(buf, 100U, MAX_US)) > 0U)
+    {
+        got.insert(got.end(), buf, buf + n);
+    }
+    return got;
+}
+
+bool checkClean()
+{
+    std::vector<Edge> edges;
+    std::vector<int32_t> expect;
+    buildTrain(3U, 0xFFF00000U, &edges, &expect); // crosses the 32-bit wrap
+
+    std::vector<uint32_t> buf(RING_EDGES);
+    EdgeRing ring;
+    ring.attach(buf.data(), buf.size());
+    EdgeReader a;
+    EdgeReader b;
+    a.attach(&ring, CYCLES_PER_US);
+    b.attach(&ring, CYCLES_PER_US);
+
+    std::vector<int32_t> gotA;
+    for (size_t i = 0U; i < edges.size(); ++i)
+    {
+        ring.onEdge(edges[i].cycles, edges[i].level);
+        if (i % 17U == 0U) // a reader polling mid-stream
+        {
+            const std::vector<int32_t> part = drain(a);
+            gotA.insert(gotA.end(), part.begin(), part.end());
+        }
+    }
+    const std::vector<int32_t> rest = drain(a);
+    gotA.insert(gotA.end(), rest.begin(), rest.end());
+    const std::vector<int32_t> gotB = drain(b);
+
+    const bool ok = gotA == expect && gotB == expect;
+    std::printf("clean train   %zu pulses, 2 readers, wrap-around  %s\n", expect.size(),
+                ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool checkGlitch()
+{
+    std::vector<Edge> clean;
+    std::vector<int32_t> expect;
+    buildTrain(3U, 1000U, &clean, &expect);
+    size_t spikes = 0U;
+    const std::vector<Edge> noisy = withSpikes(clean, 5U, &spikes);
+
+    std::vector<uint32_t> buf(RING_EDGES);
+    EdgeRing ring;
+    ring.attach(buf.data(), buf.size());
+
+    // Unfiltered: every spike splits a pulse in three.
+    ring.reset(0U);
+    EdgeReader raw;
+    raw.attach(&ring, CYCLES_PER_US);
+    for (const Edge &e : noisy)
+    {
+        ring.onEdge(e.cycles, e.level);
+    }
+    const size_t rawPulses = drain(raw).size();
+
+    ring.reset(20U * CYCLES_PER_US);
+    EdgeReader r;
+    r.attach(&ring, CYCLES_PER_US);
+    for (const Edge &e : noisy)
+    {
+        ring.onEdge(e.cycles, e.level);
+    }
+    ring.settle(noisy.back().cycles + 20U * CYCLES_PER_US);
+    const std::vector<int32_t> got = drain(r);
+    EdgeRingStats st;
+    ring.stats(&st);
+
+    // Both edges of a spike fall inside one pulse, so dropping them leaves
+    // that pulse whole: the filtered train must equal the clean one.
+    const bool ok = got == expect && st.glitches == 2U * spikes;
+    std::printf("glitch filter %zu spikes: %zu pulses unfiltered -> %zu, %lu edges dropped  %s\n",
+                spikes, rawPulses, got.size(), static_cast<unsigned long>(st.glitches),
+                ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool checkLapping()
+{
+    std::vector<Edge> edges;
+    std::vector<int32_t> expect;
+    buildTrain(40U, 0U, &edges, &expect);
+
+    std::vector<uint32_t> buf(RING_EDGES);
+    EdgeRing ring;
+    ring.attach(buf.data(), buf.size());
+    EdgeReader slow;
+    slow.attach(&ring, CYCLES_PER_US);
+    for (const Edge &e : edges)
+    {
+        ring.onEdge(e.cycles, e.level);
+    }
+    const std::vector<int32_t> got = drain(slow);
+
+    // The reader keeps the newest RING_EDGES edges: one seeds, the rest
+    // become pulses that must match the tail of the train.
+    const size_t lostExpect = edges.size() - RING_EDGES;
+    bool ok = slow.lost() == lostExpect && got.size() == RING_EDGES - 1U;
+    for (size_t i = 0U; ok && i < got.size(); ++i)
+    {
+        ok = got[i] == expect[expect.size() - got.size() + i];
+    }
+    std::printf("lapped reader %zu edges into %zu slots: lost %lu, kept %zu  %s\n", edges.size(),
+                RING_EDGES, static_cast<unsigned long>(slow.lost()), got.size(),
+                ok ? "ok" : "FAIL");
+    return ok;
+}
+
+void reportCost()
+{
+    std::vector<Edge> edges;
+    std::vector<int32_t> expect;
+    buildTrain(200U, 0U, &edges, &expect);
+    std::vector<uint32_t> buf(RING_EDGES);
+    EdgeRing ring;
+    ring.attach(buf.data(), buf.size());
+
+    constexpr int PASSES = 200;
+    for (uint32_t window : {0U, 20U * CYCLES_PER_US})
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < PASSES; ++p)
+        {
+            ring.reset(window);
+            for (const Edge &e : edges)
+            {
+                ring.onEdge(e.cycles, e.level);
+            }
+        }
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+        std::printf("onEdge, filter %-3s %6.2f ns/edge\n", window ? "on" : "off",
+                    ns / PASSES / static_cast<double>(edges.size()));
+    }
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = checkClean();
+    ok &= checkGlitch();
+    ok &= checkLapping();
+    std::printf("\n");
+    reportCost();
+    return ok ? 0 : 1;
+}
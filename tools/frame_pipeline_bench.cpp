@@ -0,0 +1,327 @@
+/**
+ * @file frame_pipeline_bench.cpp
+ * @brief Host tool: synchronous OLED flush vs FramePipeline on a modelled
+ *        400 kHz I2C bus.
+ *
+ * Bus model: 9 bit times (22.5 µs) per byte including ACK, one address
+ * byte plus 40 µs of START / STOP and driver set-up per transaction.
+ *
+ *  - sync:     present() runs Adafruit_SSD1306::display(): one command
+ *              transaction and the whole 1 KiB in 127-byte transactions,
+ *              while the renderer waits
+ *  - pipeline: present() copies the frame into a FramePipeline slot and
+ *              returns; a driver sends changed pages only (one 7-byte
+ *              command and two 64-byte data transactions each)
+ *
+ * Workloads: full-screen animation (every page changes), menu (two pages
+ * change per frame) and a clock (one page), each at several compose times.
+ * The fake panel applies every page the driver sends and NAKs 0.2 % of
+ * them; after each completed frame its RAM must equal that frame unless a
+ * page of that very frame failed.
+ *
+ * Stalled bus: each page takes 40 ms (the bus held by another device), so
+ * the renderer runs out of PRESENT_WAIT_MS and overwrites the queued
+ * frame with replaceQueued().  Once the driver drains, the panel must show
+ * the newest frame rendered, and sent + superseded must equal submitted.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/frame_pipeline_bench.cpp \
+ *      src/hardware/display/frame_pipeline.cpp -o frame_pipeline_bench
+ *  ./frame_pipeline_bench
+ * @endcode
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "hardware/display/frame_pipeline.h"
+
+using hackos::display::FramePipeline;
+
+namespace
+{
+
+constexpr uint32_t SIM_US = 20U * 1000U * 1000U;
+constexpr double BYTE_US = 22.5;
+constexpr double TXN_OVERHEAD_US = 40.0;
+constexpr size_t WIDTH = FramePipeline::WIDTH;
+constexpr size_t PAGES = FramePipeline::PAGES;
+constexpr size_t FRAME = FramePipeline::FRAME_BYTES;
+constexpr uint32_t NAK_PER_MILLE = 2U;
+constexpr uint32_t PRESENT_WAIT_US = 100000U;   ///< DisplayManager::PRESENT_WAIT_MS
+constexpr uint32_t STALLED_PAGE_US = 40000U;
+
+uint32_t txnUs(size_t payload)
+{
+    return static_cast<uint32_t>(TXN_OVERHEAD_US + static_cast<double>(payload + 1U) * BYTE_US);
+}
+
+/// Adafruit_SSD1306::display(): addressing commands, then 127-byte chunks.
+uint32_t syncFrameUs()
+{
+    uint32_t us = txnUs(7U);
+    for (size_t sent = 0U; sent < FRAME; sent += 126U)
+    {
+        us += txnUs(1U + ((FRAME - sent < 126U) ? FRAME - sent : 126U));
+    }
+    return us;
+}
+
+/// DisplayManager::sendPage(): one command and two data transactions.
+uint32_t pageUs()
+{
+    return txnUs(7U) + 2U * txnUs(1U + 64U);
+}
+
+enum class Workload
+{
+    ANIMATION,
+    MENU,
+    CLOCK,
+};
+
+/// Frame @p n of @p w.
+void render(Workload w, uint32_t n, uint8_t *frame)
+{
+    switch (w)
+    {
+    case Workload::ANIMATION:
+        for (size_t i = 0U; i < FRAME; ++i)
+        {
+            frame[i] = static_cast<uint8_t>(i * 7U + n * 13U);
+        }
+        break;
+    case Workload::MENU:
+    {
+        // Static items, a cursor bar moving over pages 1..6 every 3 frames.
+        std::memset(frame, 0, FRAME);
+        for (size_t i = 0U; i < FRAME; i += 3U)
+        {
+            frame[i] = 0x3CU;
+        }
+        const size_t cursor = 1U + (n / 3U) % 6U;
+        std::memset(frame + cursor * WIDTH, 0xFF, WIDTH);
+        break;
+    }
+    case Workload::CLOCK:
+        std::memset(frame, 0x81, FRAME);
+        for (size_t x = 0U; x < 40U; ++x)
+        {
+            frame[3U * WIDTH + 44U + x] = static_cast<uint8_t>(n / 30U + x);   // seconds
+        }
+        break;
+    }
+}
+
+struct Result
+{
+    double fps;
+    double blockedPct;
+    uint32_t occupancy[FramePipeline::SLOTS + 1U];
+    double skippedPct;
+    uint32_t errors;
+    uint32_t superseded;
+    bool ok;
+};
+
+/// @param pageCostUs  Time per page on the wire, 0 for the I2C model.
+Result runPipeline(Workload w, uint32_t composeUs, uint32_t pageCostUs = 0U)
+{
+    static FramePipeline pipe;
+    pipe = FramePipeline();
+    std::mt19937 rng(5U);
+    std::vector<uint8_t> panel(FRAME, 0U);
+    std::deque<std::vector<uint8_t>> inFlight;   // frames submitted, oldest first
+    std::deque<uint32_t> inFlightNo;
+    uint32_t lastShown = UINT32_MAX;
+    std::vector<uint8_t> frame(FRAME);
+
+    uint32_t now = 0U;
+    uint32_t frameNo = 0U;
+    uint32_t renderAt = composeUs;   // renderer's next present()
+    bool waiting = false;
+    uint32_t waitStart = 0U;
+    uint64_t blockedUs = 0U;
+    bool sending = false;
+    uint32_t sendDoneAt = 0U;
+    uint8_t page = 0U;
+    const uint8_t *data = nullptr;
+    bool frameHadError = false;
+    uint32_t seenCompleted = 0U;
+    uint32_t errors = 0U;
+    bool ok = true;
+
+    auto checkCompleted = [&]() {
+        while (seenCompleted != pipe.completed())
+        {
+            ++seenCompleted;
+            if (!frameHadError && std::memcmp(panel.data(), inFlight.front().data(), FRAME) != 0)
+            {
+                ok = false;
+            }
+            inFlight.pop_front();
+            lastShown = inFlightNo.front();
+            inFlightNo.pop_front();
+            frameHadError = false;
+        }
+    };
+    auto present = [&]() {
+        uint8_t *slot = pipe.acquire();
+        if (slot == nullptr && waiting && now - waitStart >= PRESENT_WAIT_US)
+        {
+            slot = pipe.replaceQueued(now);
+            if (slot != nullptr)
+            {
+                inFlight.pop_back();   // never reaches the panel
+                inFlightNo.pop_back();
+            }
+        }
+        if (slot == nullptr)
+        {
+            if (!waiting)
+            {
+                waiting = true;
+                waitStart = now;
+            }
+            return;
+        }
+        if (waiting)
+        {
+            blockedUs += now - waitStart;
+            waiting = false;
+        }
+        render(w, frameNo++, frame.data());
+        std::memcpy(slot, frame.data(), FRAME);
+        inFlight.push_back(frame);
+        inFlightNo.push_back(frameNo - 1U);
+        pipe.submit(now);
+        checkCompleted();
+        renderAt = now + composeUs;
+    };
+
+    pipe.resetStats(0U);
+    const uint32_t pageCost = (pageCostUs != 0U) ? pageCostUs : pageUs();
+    // Past SIM_US the renderer stops and the driver drains the queue.
+    while (now < SIM_US || sending || pipe.inFlight() > 0U)
+    {
+        if (!sending && pipe.nextPage(&page, &data))
+        {
+            sending = true;
+            sendDoneAt = now + pageCost;
+        }
+        const bool rendering = now < SIM_US;
+        uint32_t next = UINT32_MAX;
+        if (rendering)
+        {
+            next = waiting ? waitStart + PRESENT_WAIT_US : renderAt;
+            next = (next > now) ? next : now;   // already past the wait
+        }
+        if (sending && sendDoneAt < next)
+        {
+            next = sendDoneAt;
+        }
+        if (next == UINT32_MAX)
+        {
+            ok = false;   // renderer waiting on an idle driver
+            break;
+        }
+        now = next;
+
+        if (sending && sendDoneAt == now)
+        {
+            const bool nak = rng() % 1000U < NAK_PER_MILLE;
+            if (nak)
+            {
+                ++errors;
+                frameHadError = true;
+            }
+            else
+            {
+                std::memcpy(panel.data() + page * WIDTH, data, WIDTH);
+            }
+            sending = false;
+            pipe.pageDone(!nak, now);
+            checkCompleted();
+            if (waiting && rendering)
+            {
+                present();
+            }
+        }
+        if (rendering && (waiting ? now - waitStart >= PRESENT_WAIT_US : renderAt == now))
+        {
+            present();
+        }
+    }
+    if (waiting)
+    {
+        blockedUs += SIM_US - waitStart;
+    }
+
+    const FramePipeline::Stats &st = pipe.stats();
+    Result r{};
+    r.fps = pipe.fpsTenths(now) / 10.0;
+    r.blockedPct = 100.0 * static_cast<double>(blockedUs) / now;
+    for (size_t n = 0U; n <= FramePipeline::SLOTS; ++n)
+    {
+        r.occupancy[n] = static_cast<uint32_t>(100.0 * st.occupancyUs[n] / now + 0.5);
+    }
+    r.skippedPct = 100.0 * st.pagesSkipped / (static_cast<double>(st.submitted) * PAGES);
+    r.errors = errors;
+    r.superseded = st.superseded;
+    // The newest frame always reaches the panel; only queued ones are lost.
+    r.ok = ok && errors == st.pageErrors && lastShown == frameNo - 1U &&
+           st.sent + st.superseded == st.submitted;
+    return r;
+}
+
+} // namespace
+
+int main()
+{
+    const uint32_t sync = syncFrameUs();
+    std::printf("I2C 400 kHz model: full frame %.1f ms synchronous, %.2f ms per page\n",
+                sync / 1000.0, pageUs() / 1000.0);
+    std::printf("%-10s %8s %9s %9s %10s %13s %8s %6s\n", "workload", "compose", "sync fps",
+                "pipe fps", "blocked", "in flight 0/1/2", "skipped", "check");
+
+    const struct
+    {
+        const char *name;
+        Workload w;
+    } loads[] = {
+        {"animation", Workload::ANIMATION},
+        {"menu", Workload::MENU},
+        {"clock", Workload::CLOCK},
+    };
+    const uint32_t composes[] = {5000U, 15000U, 33000U};
+
+    bool ok = true;
+    for (const auto &load : loads)
+    {
+        for (uint32_t compose : composes)
+        {
+            const double syncFps = 1e6 / (compose + sync);
+            const Result r = runPipeline(load.w, compose);
+            ok &= r.ok && r.fps >= syncFps;
+            std::printf("%-10s %5.1f ms %9.1f %9.1f %8.1f %% %5u/%3u/%3u %% %6.1f %% %6s\n",
+                        load.name, compose / 1000.0, syncFps, r.fps, r.blockedPct,
+                        r.occupancy[0], r.occupancy[1], r.occupancy[2], r.skippedPct,
+                        r.ok ? "ok" : "FAIL");
+        }
+    }
+
+    std::printf("\nstalled bus (%.0f ms per page), renderer waits at most %.0f ms:\n",
+                STALLED_PAGE_US / 1000.0, PRESENT_WAIT_US / 1000.0);
+    for (const auto &load : loads)
+    {
+        const Result r = runPipeline(load.w, 5000U, STALLED_PAGE_US);
+        ok &= r.ok && r.superseded > 0U;
+        std::printf("%-10s %9.1f fps %8.1f %% blocked %6u superseded %6s\n", load.name, r.fps,
+                    r.blockedPct, r.superseded, r.ok ? "ok" : "FAIL");
+    }
+    std::printf("%s\n", ok ? "all ok" : "FAILED");
+    return ok ? 0 : 1;
+}
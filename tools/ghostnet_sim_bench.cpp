@@ -0,0 +1,364 @@
+/**
+ * @file ghostnet_sim_bench.cpp
+ * @brief Host tool: GhostNet protocol figures from the GhostNetSimulator.
+ *
+ * Runs the real GhostNetManager protocol code on N virtual nodes over the
+ * simulated ESP-NOW medium (virtual clock, 1 Mbps shared airtime):
+ *
+ *  1. Convergence per topology (mesh, line, ring, grid, star) with nodes
+ *     booting over 5 s: time until every node knows all its neighbours.
+ *  2. Loss / latency sweep on a 16-node grid: convergence, chat latency
+ *     and delivery ratio, and host CPU per node.
+ *  3. Sync throughput on a 6-node mesh at increasing offered load: bytes
+ *     delivered per receiver, airtime use and frames the TX queue refused.
+ *  4. Distributed channel survey (GhostSurvey) on a 9-node mesh over a
+ *     synthetic 2.4 GHz band: 20 APs on 13 channels at known frame rates.
+ *
+ * Required: every lossless topology converges, every chat reaches every
+ * neighbour on lossless links, a run repeated with the same seed gives
+ * the same report (the simulator is deterministic apart from CPU time),
+ * and the survey plan covers every channel exactly once, the Master's
+ * merged view finds all APs and every channel's frame rate within 10 %.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/ghostnet_sim_bench.cpp \
+ *      src/core/ghostnet_sim.cpp src/core/ghostnet_manager.cpp \
+ *      src/core/ghostnet_survey.cpp -o ghostnet_sim_bench
+ *  ./ghostnet_sim_bench
+ * @endcode
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "core/ghostnet_sim.h"
+#include "core/ghostnet_survey.h"
+#include "host/bench_check.h"
+
+using hackos::bench::finish;
+using hackos::bench::require;
+using hackos::core::GhostNetSimulator;
+using hackos::core::GhostSimConfig;
+using hackos::core::GhostSimReport;
+using hackos::core::GhostSimTopology;
+using hackos::core::GhostSurvey;
+using hackos::core::SURVEY_CHANNEL_COUNT;
+using hackos::core::SurveyFrameKind;
+using hackos::core::SurveyRole;
+using hackos::core::surveyChannelBit;
+
+namespace
+{
+
+constexpr uint32_t CONVERGE_TIMEOUT_MS = 120000U;
+constexpr uint32_t CHAT_SETTLE_MS = 2000U;
+
+/// Chat from every node in turn; returns the deliveries a lossless run must see.
+uint32_t chatRound(GhostNetSimulator &sim)
+{
+    uint32_t expected = 0U;
+    for (size_t i = 0U; i < sim.nodeCount(); ++i)
+    {
+        expected += static_cast<uint32_t>(sim.node(i)->peerCount());
+        (void)sim.sendChat(i, "ping");
+        sim.runFor(100U);
+    }
+    sim.runFor(CHAT_SETTLE_MS);
+    return expected;
+}
+
+// ── 1. Topologies ────────────────────────────────────────────────────────────
+
+struct TopologyCase
+{
+    const char *name;
+    GhostSimTopology topology;
+    size_t nodes;
+};
+
+void topologies()
+{
+    static const TopologyCase CASES[] = {
+        {"mesh", GhostSimTopology::FULL_MESH, 9U},
+        {"line", GhostSimTopology::LINE, 12U},
+        {"ring", GhostSimTopology::RING, 12U},
+        {"grid", GhostSimTopology::GRID, 16U},
+        {"star", GhostSimTopology::STAR, 9U},
+        {"grid", GhostSimTopology::GRID, 32U},
+    };
+
+    std::printf("Convergence (boot spread 5 s, beacon 5 s, lossless, 2 ms links)\n");
+    std::printf("  %-5s %5s %11s %8s %9s %8s %10s\n", "topo", "nodes", "converge_ms", "frames",
+                "chat_avg", "chat_ok", "cpu_us/node");
+    for (const TopologyCase &c : CASES)
+    {
+        GhostSimConfig cfg;
+        cfg.nodeCount = c.nodes;
+        cfg.seed = 7U;
+        GhostNetSimulator sim(cfg);
+        require(sim.isReady(), "simulator allocation");
+        sim.setTopology(c.topology);
+        sim.start();
+        const bool converged = sim.runUntilConverged(CONVERGE_TIMEOUT_MS);
+        const uint32_t expected = chatRound(sim);
+        const GhostSimReport r = sim.report();
+        std::printf("  %-5s %5zu %11u %8u %7u ms %4u/%-3u %10llu\n", c.name, c.nodes,
+                    r.convergenceMs, r.framesTx, r.chatLatencyAvgMs, r.chatDeliveries, expected,
+                    static_cast<unsigned long long>(r.cpuUsTotal / c.nodes));
+        require(converged, "lossless topology converges");
+        require(r.chatDeliveries == expected, "every chat reaches every neighbour");
+    }
+}
+
+// ── 2. Loss / latency ────────────────────────────────────────────────────────
+
+void lossSweep()
+{
+    static const uint8_t LOSS[] = {0U, 10U, 30U, 50U};
+    static const uint16_t LATENCY[] = {2U, 20U};
+
+    std::printf("\nLoss / latency, 16-node grid\n");
+    std::printf("  %4s %6s %11s %9s %9s %9s %10s\n", "loss", "lat_ms", "converge_ms", "chat_avg",
+                "chat_max", "delivered", "cpu_us/node");
+    for (const uint16_t latency : LATENCY)
+    {
+        for (const uint8_t loss : LOSS)
+        {
+            GhostSimConfig cfg;
+            cfg.nodeCount = 16U;
+            cfg.seed = 11U;
+            cfg.defaultLossPct = loss;
+            cfg.defaultLatencyMs = latency;
+            GhostNetSimulator sim(cfg);
+            sim.setTopology(GhostSimTopology::GRID);
+            sim.start();
+            const bool converged = sim.runUntilConverged(CONVERGE_TIMEOUT_MS);
+            const uint32_t expected = chatRound(sim);
+            const GhostSimReport r = sim.report();
+            char conv[16];
+            std::snprintf(conv, sizeof(conv), converged ? "%u" : ">%u",
+                          converged ? r.convergenceMs : CONVERGE_TIMEOUT_MS);
+            std::printf("  %3u%% %6u %11s %6u ms %6u ms %8.0f%% %10llu\n", loss, latency, conv,
+                        r.chatLatencyAvgMs, r.chatLatencyMaxMs,
+                        (expected > 0U) ? 100.0 * r.chatDeliveries / expected : 0.0,
+                        static_cast<unsigned long long>(r.cpuUsTotal / cfg.nodeCount));
+            if (loss == 0U)
+            {
+                require(converged && r.chatDeliveries == expected, "lossless grid delivers");
+                require(r.chatLatencyMaxMs <= latency + 5U, "chat latency = link latency + airtime");
+            }
+        }
+    }
+}
+
+// ── 3. Sync throughput ───────────────────────────────────────────────────────
+
+void syncThroughput()
+{
+    static const uint32_t OFFERED_BPS[] = {2000U, 5000U, 10000U, 20000U, 50000U, 100000U};
+    constexpr uint32_t RUN_MS = 10000U;
+    constexpr uint32_t STEP_MS = 10U;
+
+    std::printf("\nSync throughput, 6-node mesh, node 0 sending\n");
+    std::printf("  %9s %13s %9s %7s %10s\n", "offered", "delivered/rx", "accepted", "air%",
+                "queue_drop");
+    for (const uint32_t offered : OFFERED_BPS)
+    {
+        GhostSimConfig cfg;
+        cfg.nodeCount = 6U;
+        cfg.seed = 3U;
+        GhostNetSimulator sim(cfg);
+        sim.start();
+        (void)sim.runUntilConverged(CONVERGE_TIMEOUT_MS);
+        sim.resetMetrics();   // measure the sync phase only
+
+        const size_t perStep = offered * STEP_MS / 1000U;
+        for (uint32_t t = 0U; t < RUN_MS; t += STEP_MS)
+        {
+            (void)sim.sendSync(0U, perStep);
+            sim.runFor(STEP_MS);
+        }
+        const GhostSimReport r = sim.report();
+        const uint32_t perRx = r.syncThroughputBps / static_cast<uint32_t>(cfg.nodeCount - 1U);
+        std::printf("  %6u B/s %9u B/s %8.0f%% %6u%% %10u\n", offered, perRx,
+                    100.0 * r.syncBytesSent / (static_cast<double>(perStep) * (RUN_MS / STEP_MS)),
+                    r.airtimeBusyPct, r.framesAirtimeDrop);
+        if (offered <= 5000U)
+        {
+            require(r.syncBytesDelivered == r.syncBytesSent * (cfg.nodeCount - 1U),
+                    "light sync load reaches every peer");
+        }
+    }
+}
+
+// ── 4. Channel survey ────────────────────────────────────────────────────────
+
+constexpr size_t SURVEY_NODES = 9U;
+constexpr size_t SURVEY_APS = 20U;
+constexpr uint8_t SURVEY_HOME = 6U;
+constexpr uint32_t SURVEY_RUN_MS = 30000U;
+constexpr uint32_t SURVEY_STEP_MS = 10U;
+
+/// Synthetic band: frames per 10 ms step on @p ch (mgmt, data, ctrl).
+void channelLoad(uint8_t ch, uint32_t &mgmt, uint32_t &data, uint32_t &ctrl)
+{
+    mgmt = 1U + ch % 3U;
+    data = (ch == 1U || ch == 6U || ch == 11U) ? 8U : ch % 4U;
+    ctrl = ch % 2U;
+}
+
+uint8_t apChannel(size_t ap) { return static_cast<uint8_t>(1U + (ap * 5U) % SURVEY_CHANNEL_COUNT); }
+
+/// Feed what a radio tuned to @p ch hears during one step.
+void hear(GhostSurvey &survey, uint8_t ch, uint32_t step)
+{
+    uint32_t mgmt = 0U;
+    uint32_t data = 0U;
+    uint32_t ctrl = 0U;
+    channelLoad(ch, mgmt, data, ctrl);
+    for (uint32_t i = 0U; i < mgmt; ++i)
+    {
+        survey.recordFrame(ch, SurveyFrameKind::MGMT, -60);
+    }
+    for (uint32_t i = 0U; i < data; ++i)
+    {
+        survey.recordFrame(ch, SurveyFrameKind::DATA, -70);
+    }
+    for (uint32_t i = 0U; i < ctrl; ++i)
+    {
+        survey.recordFrame(ch, SurveyFrameKind::CTRL, -75);
+    }
+    // Every AP beacons once per 100 ms (ten steps), staggered by index.
+    for (size_t ap = 0U; ap < SURVEY_APS; ++ap)
+    {
+        if (apChannel(ap) == ch && (step % 10U) == ap % 10U)
+        {
+            const uint8_t bssid[6] = {0x02U, 0xA9U, 0U, 0U, 0U, static_cast<uint8_t>(ap)};
+            char ssid[16];
+            std::snprintf(ssid, sizeof(ssid), "ap-%02zu", ap);
+            survey.recordAp(ch, bssid, ssid, static_cast<int8_t>(-40 - static_cast<int>(ap)));
+        }
+    }
+}
+
+void channelSurvey()
+{
+    GhostSimConfig cfg;
+    cfg.nodeCount = SURVEY_NODES;
+    cfg.seed = 5U;
+    GhostNetSimulator sim(cfg);
+    sim.start();
+    require(sim.runUntilConverged(CONVERGE_TIMEOUT_MS), "survey mesh converges");
+    sim.resetMetrics();
+
+    GhostSurvey *surveys[SURVEY_NODES];
+    for (size_t i = 0U; i < SURVEY_NODES; ++i)
+    {
+        surveys[i] = new GhostSurvey(*sim.node(i));
+        sim.node(i)->setServiceHandler(surveys[i]);
+    }
+    require(surveys[0]->startMaster(SURVEY_HOME, GhostSurvey::DEFAULT_DWELL_MS, sim.nowMs()),
+            "survey master starts");
+
+    for (uint32_t step = 0U; step * SURVEY_STEP_MS < SURVEY_RUN_MS; ++step)
+    {
+        sim.runFor(SURVEY_STEP_MS);
+        for (GhostSurvey *s : surveys)
+        {
+            s->tick(sim.nowMs());
+            if (s->isRunning() && s->radioChannel() != 0U)
+            {
+                hear(*s, s->radioChannel(), step);
+            }
+        }
+    }
+
+    uint16_t covered = surveyChannelBit(SURVEY_HOME);
+    bool disjoint = true;
+    size_t nodes = 0U;
+    for (size_t i = 1U; i < SURVEY_NODES; ++i)
+    {
+        if (surveys[i]->role() == SurveyRole::NODE)
+        {
+            ++nodes;
+            disjoint = disjoint && (covered & surveys[i]->assignedMask()) == 0U;
+            covered = static_cast<uint16_t>(covered | surveys[i]->assignedMask());
+        }
+    }
+
+    const hackos::core::SurveyView &view = surveys[0]->view();
+    const GhostSimReport r = sim.report();
+    std::printf("\nChannel survey, %zu-node mesh, home %u, %u s: %zu nodes joined, %u digests, "
+                "%u APs of %zu, airtime %u%%\n",
+                SURVEY_NODES, SURVEY_HOME, SURVEY_RUN_MS / 1000U, nodes, view.digestsMerged(),
+                static_cast<unsigned>(view.apCount()), SURVEY_APS, r.airtimeBusyPct);
+    std::printf("  %2s %9s %9s %8s %8s\n", "ch", "listen_ms", "reporter", "true/s", "seen/s");
+    bool ratesOk = true;
+    for (uint8_t ch = 1U; ch <= SURVEY_CHANNEL_COUNT; ++ch)
+    {
+        uint32_t mgmt = 0U;
+        uint32_t data = 0U;
+        uint32_t ctrl = 0U;
+        channelLoad(ch, mgmt, data, ctrl);
+        const uint32_t truth = (mgmt + data + ctrl) * (1000U / SURVEY_STEP_MS);
+        const uint32_t seen = view.frameRate(ch);
+        const hackos::core::SurveyChannelSummary *sum = view.channel(ch);
+        std::printf("  %2u %9u %9u %8u %8u\n", ch, sum->listenMs, sum->reporter, truth, seen);
+        ratesOk = ratesOk && sum->listenMs > 0U && seen * 10U >= truth * 9U &&
+                  seen * 10U <= truth * 11U;
+    }
+    require(nodes == SURVEY_NODES - 1U, "every peer joins the survey");
+    require(disjoint && covered == 0x1FFFU, "plan covers each channel exactly once");
+    require(view.apCount() == SURVEY_APS, "master view finds every AP");
+    require(ratesOk, "channel frame rates within 10 %");
+
+    for (size_t i = 0U; i < SURVEY_NODES; ++i)
+    {
+        sim.node(i)->setServiceHandler(nullptr);
+        delete surveys[i];
+    }
+    sim.runFor(1000U);   // late service frames must find no handler
+}
+
+// ── Determinism ──────────────────────────────────────────────────────────────
+
+GhostSimReport lossyRun()
+{
+    GhostSimConfig cfg;
+    cfg.nodeCount = 12U;
+    cfg.seed = 99U;
+    cfg.defaultLossPct = 20U;
+    GhostNetSimulator sim(cfg);
+    sim.setTopology(GhostSimTopology::RING);
+    sim.start();
+    (void)sim.runUntilConverged(CONVERGE_TIMEOUT_MS);
+    (void)chatRound(sim);
+    GhostSimReport r = sim.report();
+    r.cpuUsTotal = 0U;
+    r.cpuUsMaxNode = 0U;
+    return r;
+}
+
+void determinism()
+{
+    const GhostSimReport a = lossyRun();
+    const GhostSimReport b = lossyRun();
+    const bool same = a.convergenceMs == b.convergenceMs && a.framesTx == b.framesTx &&
+                      a.framesDelivered == b.framesDelivered && a.framesLost == b.framesLost &&
+                      a.chatDeliveries == b.chatDeliveries &&
+                      a.chatLatencyMaxMs == b.chatLatencyMaxMs;
+    std::printf("\nSame seed twice (12-node ring, 20%% loss): %s\n", same ? "identical" : "DIFFERENT");
+    require(same, "same seed reproduces the run");
+}
+
+} // namespace
+
+int main()
+{
+    topologies();
+    lossSweep();
+    syncThroughput();
+    channelSurvey();
+    determinism();
+    return finish();
+}
@@ -0,0 +1,40 @@
+/**
+ * @file bench_check.h
+ * @brief Pass / fail bookkeeping shared by the host benches in tools/.
+ *
+ * require() prints a FAIL line and marks the run failed; finish() prints
+ * the closing "all ok" / "FAILED" line and returns main()'s exit code.
+ * Benches include it as `"host/bench_check.h"`, relative to tools/, so the
+ * compile line needs no extra flag.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace hackos::bench {
+
+/// @brief false once any require() failed.
+inline bool &passed()
+{
+    static bool ok = true;
+    return ok;
+}
+
+inline void require(bool cond, const char *what)
+{
+    if (!cond)
+    {
+        std::printf("  FAIL: %s\n", what);
+        passed() = false;
+    }
+}
+
+/// @brief Print the verdict; @return the process exit code.
+inline int finish()
+{
+    std::printf("%s\n", passed() ? "all ok" : "FAILED");
+    return passed() ? 0 : 1;
+}
+
+} // namespace hackos::bench
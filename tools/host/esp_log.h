@@ -0,0 +1,16 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for the ESP-IDF logging macros.
+ *
+ * Lets firmware sources that only log (e.g. nfc_reader.cpp) build into
+ * the host tools: add `-Itools/host` to the compile line.  Messages are
+ * discarded.
+ */
+
+#pragma once
+
+#define ESP_LOGE(tag, ...) ((void)(tag))
+#define ESP_LOGW(tag, ...) ((void)(tag))
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#define ESP_LOGD(tag, ...) ((void)(tag))
+#define ESP_LOGV(tag, ...) ((void)(tag))
@@ -0,0 +1,136 @@
+/**
+ * @file irdb_compile.cpp
+ * @brief Host build tool: compile IR code CSV files into a `.irdb` database.
+ *
+ * Uses the same IrCodeDbBuilder as the device, with a larger run buffer.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/irdb_compile.cpp \
+ *      src/hardware/ir/ir_code_db.cpp -o irdb_compile
+ *  ./irdb_compile tv_bgone.irdb data/ir/tv_bgone.csv more_codes.csv
+ * @endcode
+ */
+
+#include <cstdio>
+#include <new>
+
+#include "hardware/ir/ir_code_db.h"
+
+namespace
+{
+
+/// Records sorted in RAM per run (16 MiB).
+constexpr size_t RUN_RECORDS = 1U << 20;
+
+class FileSink final : public hackos::ir::IrByteSink
+{
+public:
+    explicit FileSink(std::FILE *f) : f_(f) {}
+
+    bool write(const uint8_t *data, size_t len) override
+    {
+        return std::fwrite(data, 1U, len, f_) == len;
+    }
+
+private:
+    std::FILE *f_;
+};
+
+class FileSource final : public hackos::ir::IrByteSource
+{
+public:
+    explicit FileSource(std::FILE *f) : f_(f), size_(0U)
+    {
+        std::fseek(f_, 0L, SEEK_END);
+        size_ = static_cast<uint32_t>(std::ftell(f_));
+    }
+
+    uint32_t size() const override { return size_; }
+
+    size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        if (std::fseek(f_, static_cast<long>(offset), SEEK_SET) != 0)
+        {
+            return 0U;
+        }
+        return std::fread(buf, 1U, len, f_);
+    }
+
+private:
+    std::FILE *f_;
+    uint32_t size_;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <out.irdb> <codes.csv>...\n", argv[0]);
+        return 2;
+    }
+
+    auto *runBuf = new (std::nothrow) hackos::ir::IrCodeRecord[RUN_RECORDS];
+    auto *builder = new (std::nothrow) hackos::ir::IrCodeDbBuilder(runBuf, RUN_RECORDS);
+    std::FILE *runs = std::tmpfile();
+    if (runBuf == nullptr || builder == nullptr || runs == nullptr)
+    {
+        std::fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    FileSink runSink(runs);
+    builder->begin(runSink);
+    bool ok = true;
+    for (int i = 2; ok && i < argc; ++i)
+    {
+        std::FILE *in = std::fopen(argv[i], "rb");
+        if (in == nullptr)
+        {
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            ok = false;
+            break;
+        }
+        char chunk[4096];
+        char last = '\n';
+        size_t n = 0U;
+        while (ok && (n = std::fread(chunk, 1U, sizeof(chunk), in)) > 0U)
+        {
+            ok = builder->feed(chunk, n);
+            last = chunk[n - 1U];
+        }
+        std::fclose(in);
+        if (ok && last != '\n')
+        {
+            ok = builder->feed("\n", 1U); // keep the next file's first line separate
+        }
+    }
+    ok = ok && builder->finish();
+    std::fflush(runs);
+
+    std::FILE *out = ok ? std::fopen(argv[1], "wb") : nullptr;
+    if (out != nullptr)
+    {
+        FileSink outSink(out);
+        FileSource runSource(runs);
+        ok = builder->write(outSink, runSource);
+        ok = (std::fclose(out) == 0) && ok;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    std::printf("%s: %u codes, %u protocols, %u runs, %u lines skipped\n",
+                ok ? argv[1] : "FAILED",
+                static_cast<unsigned>(builder->recordCount()),
+                static_cast<unsigned>(builder->protocolCount()),
+                static_cast<unsigned>(builder->runCount()),
+                static_cast<unsigned>(builder->skippedLines()));
+
+    std::fclose(runs);
+    delete builder;
+    delete[] runBuf;
+    return ok ? 0 : 1;
+}
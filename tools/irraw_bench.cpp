@@ -0,0 +1,510 @@
+/**
+ * @file irraw_bench.cpp
+ * @brief Host tool: compression ratio and decode speed of the raw IR codec
+ *        over AC and TV captures.
+ *
+ * Without arguments the corpus is synthetic: TV remotes (NEC with repeat
+ * codes, Samsung32 sent twice, Sony SIRC sent three times, RC5) and AC
+ * remotes (Daikin-, Mitsubishi-, Gree- and Panasonic-like state frames),
+ * every timing jittered by up to ±JITTER_US as IRrecv captures are.
+ * Flipper-style `.ir` files given on the command line are used instead.
+ *
+ * Every raw signal is encoded the way IR Tools saves it – at the tolerance
+ * (default IR_RAW_TOLERANCE_US), retried once doubled – decoded again and
+ * compared with the original.  Required: no signal rejected, every timing
+ * back within the tolerance it was encoded at, and each set smaller than
+ * the 16-bit array IRsend::sendRaw() takes.  Sizes are also reported
+ * against Pronto hex.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/irraw_bench.cpp \
+ *      src/hardware/ir/ir_raw_codec.cpp -o irraw_bench
+ *  ./irraw_bench [-t tolerance_us] [ac_remotes.ir tv_remotes.ir ...]
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "hardware/ir/ir_raw_codec.h"
+
+namespace
+{
+
+/// Decode passes per signal for the timing figure.
+constexpr int DECODE_PASSES = 200;
+
+constexpr size_t LINE_MAX = 16384U;
+constexpr int JITTER_US = 60;
+
+struct Totals
+{
+    size_t signals;
+    size_t rejected;
+    size_t retried;      ///< Needed twice the tolerance
+    size_t mismatches;
+    size_t timings;
+    size_t arrayBytes;
+    size_t prontoBytes;
+    size_t encodedBytes;
+    double decodeNs;
+
+    void add(const Totals &t)
+    {
+        signals += t.signals;
+        rejected += t.rejected;
+        retried += t.retried;
+        mismatches += t.mismatches;
+        timings += t.timings;
+        arrayBytes += t.arrayBytes;
+        prontoBytes += t.prontoBytes;
+        encodedBytes += t.encodedBytes;
+        decodeNs += t.decodeNs;
+    }
+
+    bool ok() const
+    {
+        return signals > 0U && rejected == 0U && mismatches == 0U && encodedBytes < arrayBytes;
+    }
+};
+
+/// Pronto hex: 4 header words + one word per timing, "XXXX " each.
+size_t prontoSize(size_t count)
+{
+    return (4U + count) * 5U;
+}
+
+void benchSignal(const uint16_t *timings, size_t count, unsigned khz, uint16_t tolerance,
+                 Totals *t)
+{
+    static hackos::ir::IrRawEncoder enc;
+    static hackos::ir::IrRawDecoder dec;
+    static uint8_t blob[hackos::ir::IR_RAW_MAX_BYTES];
+    static uint16_t out[hackos::ir::IR_RAW_MAX_TIMINGS];
+
+    // As IrToolsApp::performRawSave(): once more at twice the tolerance.
+    size_t len = 0U;
+    uint16_t used = tolerance;
+    bool ok = enc.encode(timings, count, static_cast<uint8_t>(khz), used, blob, sizeof(blob),
+                         &len);
+    if (!ok)
+    {
+        used = static_cast<uint16_t>(2U * tolerance);
+        ok = enc.encode(timings, count, static_cast<uint8_t>(khz), used, blob, sizeof(blob),
+                        &len);
+        t->retried += ok ? 1U : 0U;
+    }
+    if (!ok || !dec.begin(blob, len))
+    {
+        ++t->rejected;
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t n = 0U;
+    for (int pass = 0; pass < DECODE_PASSES; ++pass)
+    {
+        n = dec.decode(out, hackos::ir::IR_RAW_MAX_TIMINGS);
+    }
+    const auto ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+
+    bool match = (n == count);
+    for (size_t i = 0U; match && i < count; ++i)
+    {
+        const int diff = static_cast<int>(out[i]) - static_cast<int>(timings[i]);
+        match = (diff <= used && -diff <= used);
+    }
+
+    ++t->signals;
+    t->mismatches += match ? 0U : 1U;
+    t->timings += count;
+    t->arrayBytes += 2U * count;
+    t->prontoBytes += prontoSize(count);
+    t->encodedBytes += len;
+    t->decodeNs += ns / DECODE_PASSES;
+}
+
+/// Parse one `.ir` file; raw signals are benchmarked as they complete.
+bool benchFile(const char *path, uint16_t tolerance, Totals *t)
+{
+    std::FILE *f = std::fopen(path, "r");
+    if (f == nullptr)
+    {
+        return false;
+    }
+
+    static char line[LINE_MAX];
+    static uint16_t timings[hackos::ir::IR_RAW_MAX_TIMINGS];
+    bool raw = false;
+    unsigned khz = 38U;
+    while (std::fgets(line, sizeof(line), f) != nullptr)
+    {
+        if (std::strncmp(line, "type:", 5) == 0)
+        {
+            raw = (std::strstr(line, "raw") != nullptr);
+            khz = 38U;
+        }
+        else if (std::strncmp(line, "frequency:", 10) == 0)
+        {
+            khz = static_cast<unsigned>((std::strtoul(line + 10, nullptr, 10) + 500U) / 1000U);
+        }
+        else if (raw && std::strncmp(line, "data:", 5) == 0)
+        {
+            size_t count = 0U;
+            char *p = line + 5;
+            char *end = nullptr;
+            for (unsigned long v = std::strtoul(p, &end, 10); end != p;
+                 v = std::strtoul(p, &end, 10))
+            {
+                if (count == hackos::ir::IR_RAW_MAX_TIMINGS)
+                {
+                    break;
+                }
+                timings[count++] = static_cast<uint16_t>(v > 0xFFFFUL ? 0xFFFFUL : v);
+                p = end;
+            }
+            if (count > 0U)
+            {
+                benchSignal(timings, count, khz, tolerance, t);
+            }
+            raw = false;
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+// ── Synthetic corpus ─────────────────────────────────────────────────────────
+
+/// Mark/space list as IRrecv would capture it.
+class Capture
+{
+public:
+    explicit Capture(std::mt19937 &rng) : rng_(rng) {}
+
+    void mark(uint16_t us) { push(us, true); }
+    void space(uint16_t us) { push(us, false); }
+
+    /// Pulse-distance bits, LSB first: mark, then a short or long space.
+    void bits(uint64_t value, unsigned count, uint16_t markUs, uint16_t zeroUs, uint16_t oneUs)
+    {
+        for (unsigned i = 0U; i < count; ++i)
+        {
+            mark(markUs);
+            space(((value >> i) & 1U) != 0U ? oneUs : zeroUs);
+        }
+    }
+
+    void bytes(const std::vector<uint8_t> &data, uint16_t markUs, uint16_t zeroUs,
+               uint16_t oneUs)
+    {
+        for (uint8_t b : data)
+        {
+            bits(b, 8U, markUs, zeroUs, oneUs);
+        }
+    }
+
+    const std::vector<uint16_t> &timings() const { return timings_; }
+
+private:
+    /// Adjacent levels of the same kind merge (Manchester codes).
+    void push(uint16_t us, bool isMark)
+    {
+        if (timings_.empty() && !isMark)
+        {
+            return;   // capture starts at the first mark
+        }
+        const int jitter = static_cast<int>(rng_() % (2U * JITTER_US + 1U)) - JITTER_US;
+        const uint16_t v = static_cast<uint16_t>(us + jitter);
+        if (!timings_.empty() && ((timings_.size() % 2U == 1U) == isMark))
+        {
+            timings_.back() = static_cast<uint16_t>(timings_.back() + v);
+        }
+        else
+        {
+            timings_.push_back(v);
+        }
+    }
+
+    std::mt19937 &rng_;
+    std::vector<uint16_t> timings_;
+};
+
+std::vector<uint16_t> nec(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const uint32_t addr = rng() & 0xFFU;
+    const uint32_t cmd = rng() & 0xFFU;
+    c.mark(9000U);
+    c.space(4500U);
+    c.bits(addr | ((addr ^ 0xFFU) << 8) | (cmd << 16) | ((cmd ^ 0xFFU) << 24), 32U, 560U, 560U,
+           1690U);
+    c.mark(560U);
+    for (int r = 0; r < 2; ++r)   // held key: repeat codes
+    {
+        c.space(39500U);
+        c.mark(9000U);
+        c.space(2250U);
+        c.mark(560U);
+    }
+    return c.timings();
+}
+
+std::vector<uint16_t> samsung(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const uint32_t code = rng();
+    for (int r = 0; r < 2; ++r)
+    {
+        if (r > 0)
+        {
+            c.space(46000U);
+        }
+        c.mark(4500U);
+        c.space(4500U);
+        c.bits(code, 32U, 560U, 560U, 1690U);
+        c.mark(560U);
+    }
+    return c.timings();
+}
+
+std::vector<uint16_t> sony(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const uint32_t code = rng() & 0xFFFU;
+    for (int r = 0; r < 3; ++r)
+    {
+        if (r > 0)
+        {
+            c.space(25800U);
+        }
+        c.mark(2400U);
+        for (unsigned i = 0U; i < 12U; ++i)   // pulse-width: the mark varies
+        {
+            c.space(600U);
+            c.mark(((code >> i) & 1U) != 0U ? 1200U : 600U);
+        }
+    }
+    return c.timings();
+}
+
+std::vector<uint16_t> rc5(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const uint32_t code = 0x3000U | (rng() & 0x7FFU);   // two start bits, toggle, addr, cmd
+    for (int r = 0; r < 2; ++r)
+    {
+        if (r > 0)
+        {
+            c.space(60000U);
+        }
+        for (int i = 13; i >= 0; --i)
+        {
+            // Manchester, 889 µs halves: 1 = space then mark.
+            const bool one = ((code >> i) & 1U) != 0U;
+            if (one)
+            {
+                c.space(889U);
+                c.mark(889U);
+            }
+            else
+            {
+                c.mark(889U);
+                c.space(889U);
+            }
+        }
+    }
+    // A trailing space never shows in a capture.
+    std::vector<uint16_t> t = c.timings();
+    if (t.size() % 2U == 0U)
+    {
+        t.pop_back();
+    }
+    return t;
+}
+
+/// AC state: mostly fixed bytes, a few settings, a checksum.
+std::vector<uint8_t> acState(std::mt19937 &rng, size_t len, uint8_t id)
+{
+    std::vector<uint8_t> s(len, 0U);
+    s[0] = 0x11U;
+    s[1] = 0xDAU;
+    s[2] = id;
+    const size_t settings = 5U + rng() % 4U;
+    for (size_t i = 0U; i < settings; ++i)
+    {
+        s[3U + rng() % (len - 4U)] = static_cast<uint8_t>(rng());
+    }
+    uint8_t sum = 0U;
+    for (size_t i = 0U; i + 1U < len; ++i)
+    {
+        sum = static_cast<uint8_t>(sum + s[i]);
+    }
+    s[len - 1U] = sum;
+    return s;
+}
+
+std::vector<uint16_t> daikin(std::mt19937 &rng)
+{
+    Capture c(rng);
+    c.bytes(acState(rng, 8U, 0x27U), 428U, 428U, 1280U);   // leader frame
+    c.mark(428U);
+    c.space(29000U);
+    c.mark(3500U);
+    c.space(1728U);
+    c.bytes(acState(rng, 19U, 0x42U), 428U, 428U, 1280U);
+    c.mark(428U);
+    return c.timings();
+}
+
+std::vector<uint16_t> mitsubishi(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const std::vector<uint8_t> state = acState(rng, 18U, 0x23U);
+    for (int r = 0; r < 2; ++r)
+    {
+        if (r > 0)
+        {
+            c.space(17100U);
+        }
+        c.mark(3400U);
+        c.space(1750U);
+        c.bytes(state, 450U, 420U, 1300U);
+        c.mark(440U);
+    }
+    return c.timings();
+}
+
+std::vector<uint16_t> gree(std::mt19937 &rng)
+{
+    Capture c(rng);
+    const std::vector<uint8_t> state = acState(rng, 8U, 0x50U);
+    for (int r = 0; r < 2; ++r)
+    {
+        if (r > 0)
+        {
+            c.space(40000U);
+        }
+        c.mark(9000U);
+        c.space(4500U);
+        c.bytes({state[0], state[1], state[2], state[3]}, 620U, 540U, 1600U);
+        c.bits(0x2U, 3U, 620U, 540U, 1600U);
+        c.mark(620U);
+        c.space(19980U);
+        c.bytes({state[4], state[5], state[6], state[7]}, 620U, 540U, 1600U);
+        c.mark(620U);
+    }
+    return c.timings();
+}
+
+std::vector<uint16_t> panasonic(std::mt19937 &rng)
+{
+    Capture c(rng);
+    c.mark(3500U);
+    c.space(1750U);
+    c.bytes({0x02U, 0x20U, 0xE0U, 0x04U, 0x00U, 0x00U, 0x00U, 0x06U}, 435U, 435U, 1300U);
+    c.mark(435U);
+    c.space(10000U);
+    c.mark(3500U);
+    c.space(1750U);
+    c.bytes(acState(rng, 19U, 0x04U), 435U, 435U, 1300U);
+    c.mark(435U);
+    return c.timings();
+}
+
+void report(const char *name, const Totals &t)
+{
+    std::printf("%-34s %3zu sig %6zu timings %6zu B -> %5zu B  x%.1f (pronto x%.1f)  %s\n",
+                name, t.signals, t.timings, t.arrayBytes, t.encodedBytes,
+                static_cast<double>(t.arrayBytes) / t.encodedBytes,
+                static_cast<double>(t.prontoBytes) / t.encodedBytes, t.ok() ? "ok" : "FAIL");
+}
+
+using Generator = std::vector<uint16_t> (*)(std::mt19937 &);
+
+/// @p perGen captures from each of @p gens, reported as one set.
+Totals benchSet(const char *name, const Generator *gens, size_t count, size_t perGen,
+                uint16_t tolerance, std::mt19937 &rng)
+{
+    Totals t{};
+    for (size_t g = 0U; g < count; ++g)
+    {
+        for (size_t i = 0U; i < perGen; ++i)
+        {
+            const std::vector<uint16_t> s = gens[g](rng);
+            benchSignal(s.data(), s.size(), 38U, tolerance, &t);
+        }
+    }
+    report(name, t);
+    return t;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint16_t tolerance = hackos::ir::IR_RAW_TOLERANCE_US;
+    int first = 1;
+    if (argc > 2 && std::strcmp(argv[1], "-t") == 0)
+    {
+        tolerance = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 10));
+        first = 3;
+    }
+
+    Totals total{};
+    bool ok = true;
+    if (first >= argc)
+    {
+        std::printf("synthetic corpus, jitter ±%d us\n", JITTER_US);
+        std::mt19937 rng(83U);
+        const Generator tv[] = {nec, samsung, sony, rc5};
+        const Generator ac[] = {daikin, mitsubishi, gree, panasonic};
+        const Totals tvTotals =
+            benchSet("TV (NEC/Samsung/Sony/RC5)", tv, 4U, 10U, tolerance, rng);
+        const Totals acTotals =
+            benchSet("AC (Daikin/Mitsu/Gree/Panasonic)", ac, 4U, 12U, tolerance, rng);
+        ok = tvTotals.ok() && acTotals.ok();
+        total.add(tvTotals);
+        total.add(acTotals);
+    }
+    for (int i = first; i < argc; ++i)
+    {
+        Totals t{};
+        if (!benchFile(argv[i], tolerance, &t))
+        {
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        if (t.signals > 0U)
+        {
+            report(argv[i], t);
+        }
+        total.add(t);
+    }
+
+    if (total.signals == 0U)
+    {
+        std::printf("no raw signals (%zu rejected)\nFAILED\n", total.rejected);
+        return 1;
+    }
+    std::printf("\ntolerance %u us: %zu signals, %zu rejected, %zu retried at %u us, "
+                "%zu mismatches\n",
+                static_cast<unsigned>(tolerance), total.signals, total.rejected, total.retried,
+                2U * tolerance, total.mismatches);
+    std::printf("size: %zu B as uint16 array, %zu B Pronto, %zu B encoded "
+                "(x%.2f / x%.2f)\n",
+                total.arrayBytes, total.prontoBytes, total.encodedBytes,
+                static_cast<double>(total.arrayBytes) / total.encodedBytes,
+                static_cast<double>(total.prontoBytes) / total.encodedBytes);
+    std::printf("decode: %.1f ns per timing, %.2f us per signal\n",
+                total.decodeNs / total.timings, total.decodeNs / total.signals / 1000.0);
+
+    ok = ok && total.ok();
+    std::printf("%s\n", ok ? "all ok" : "FAILED");
+    return ok ? 0 : 1;
+}
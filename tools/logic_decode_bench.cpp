@@ -0,0 +1,367 @@
+/**
+ * @file logic_decode_bench.cpp
+ * @brief Host tool: correctness and throughput of the streaming bus
+ *        decoders on synthetic waveforms.
+ *
+ * Each protocol is synthesised as a transition stream at the sampler's
+ * default rate (2 MS/s), decoded, compared with the payload and then
+ * decoded repeatedly for a transitions/second figure:
+ *
+ *  - UART 115200 8N1 with auto-baud and ±1 tick edge jitter
+ *  - I2C 100 kHz write transactions (address ACK, data ACK, final NACK)
+ *  - SPI 250 kHz in all four CPOL/CPHA modes, MOSI + MISO + CS
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/logic_decode_bench.cpp \
+ *      src/hardware/logic/bus_decoders.cpp -o logic_decode_bench
+ *  ./logic_decode_bench [-v uart.vcd]
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "hardware/logic/bus_decoders.h"
+
+using hackos::logic::BusDecoder;
+using hackos::logic::BusEvent;
+using hackos::logic::BusEventType;
+using hackos::logic::LogicEdge;
+
+namespace
+{
+
+constexpr uint32_t RATE_HZ = 2000000U;
+constexpr size_t PAYLOAD_BYTES = 4096U;
+constexpr int DECODE_PASSES = 50;
+
+// ── Waveform synthesis ───────────────────────────────────────────────────────
+
+class Wave
+{
+public:
+    explicit Wave(uint8_t idle) : state_(idle), tick_(0.0)
+    {
+        edges_.push_back({0U, idle, idle});
+    }
+
+    void set(uint8_t channel, bool high)
+    {
+        const uint8_t bit = static_cast<uint8_t>(1U << channel);
+        const uint8_t next = high ? static_cast<uint8_t>(state_ | bit)
+                                  : static_cast<uint8_t>(state_ & ~bit);
+        if (next == state_)
+        {
+            return;
+        }
+        const uint64_t t = static_cast<uint64_t>(tick_);
+        LogicEdge &last = edges_.back();
+        if (last.tick == t && edges_.size() > 1U)
+        {
+            last.changed = static_cast<uint8_t>(last.changed ^ last.state ^ next);
+            last.state = next;
+        }
+        else
+        {
+            edges_.push_back({t, next, static_cast<uint8_t>(state_ ^ next)});
+        }
+        state_ = next;
+    }
+
+    void hold(double ticks) { tick_ += ticks; }
+
+    uint64_t tick() const { return static_cast<uint64_t>(tick_); }
+    const std::vector<LogicEdge> &edges() const { return edges_; }
+
+private:
+    std::vector<LogicEdge> edges_;
+    uint8_t state_;
+    double tick_;
+};
+
+/// Channel 0 = TX line, idle high.
+void synthUart(Wave &w, const std::vector<uint8_t> &payload, uint32_t baud)
+{
+    const double bit = static_cast<double>(RATE_HZ) / baud;
+    w.hold(50.0 * bit);
+    for (size_t i = 0U; i < payload.size(); ++i)
+    {
+        const double jitter = static_cast<double>(std::rand() % 3 - 1);
+        w.hold(jitter);
+        w.set(0U, false);
+        w.hold(bit - jitter);
+        for (unsigned b = 0U; b < 8U; ++b)
+        {
+            w.set(0U, ((payload[i] >> b) & 1U) != 0U);
+            w.hold(bit);
+        }
+        w.set(0U, true);
+        w.hold(bit * ((i % 16U == 15U) ? 20.0 : 1.0)); // idle gap every 16 bytes
+    }
+}
+
+/// Channel 0 = SDA, channel 1 = SCL; 16-byte writes to 0x50.
+void synthI2c(Wave &w, const std::vector<uint8_t> &payload, uint32_t hz)
+{
+    const double q = static_cast<double>(RATE_HZ) / hz / 4.0;
+    auto clockBit = [&](bool bit) {
+        w.set(0U, bit);
+        w.hold(q);
+        w.set(1U, true);
+        w.hold(2.0 * q);
+        w.set(1U, false);
+        w.hold(q);
+    };
+    auto sendByte = [&](uint8_t v, bool nack) {
+        for (int b = 7; b >= 0; --b)
+        {
+            clockBit(((v >> b) & 1U) != 0U);
+        }
+        clockBit(nack);
+    };
+
+    w.hold(40.0 * q);
+    for (size_t i = 0U; i < payload.size(); i += 16U)
+    {
+        w.set(0U, false); // START
+        w.hold(q);
+        w.set(1U, false);
+        w.hold(q);
+        sendByte(0x50U << 1, false);
+        for (size_t k = i; k < i + 16U && k < payload.size(); ++k)
+        {
+            sendByte(payload[k], k + 1U == i + 16U);
+        }
+        w.set(0U, false);
+        w.hold(q);
+        w.set(1U, true);
+        w.hold(q);
+        w.set(0U, true); // STOP
+        w.hold(20.0 * q);
+    }
+}
+
+/// Channel 0 = CLK, 1 = MOSI, 2 = MISO (payload inverted), 3 = CS.
+void synthSpi(Wave &w, const std::vector<uint8_t> &payload, uint32_t hz, bool cpol,
+              bool cpha)
+{
+    const double half = static_cast<double>(RATE_HZ) / hz / 2.0;
+    w.hold(8.0 * half);
+    for (size_t i = 0U; i < payload.size(); i += 32U)
+    {
+        w.set(3U, false);
+        w.hold(half);
+        for (size_t k = i; k < i + 32U && k < payload.size(); ++k)
+        {
+            const uint8_t mosi = payload[k];
+            const uint8_t miso = static_cast<uint8_t>(~payload[k]);
+            for (int b = 7; b >= 0; --b)
+            {
+                // CPHA 0: data set up before the leading edge.
+                // CPHA 1: data changes on the leading edge.
+                if (cpha)
+                {
+                    w.set(0U, !cpol);
+                }
+                w.set(1U, ((mosi >> b) & 1U) != 0U);
+                w.set(2U, ((miso >> b) & 1U) != 0U);
+                w.hold(half);
+                w.set(0U, cpha ? cpol : !cpol);
+                w.hold(half);
+                if (!cpha)
+                {
+                    w.set(0U, cpol);
+                }
+            }
+        }
+        w.hold(half);
+        w.set(3U, true);
+        w.hold(6.0 * half);
+    }
+}
+
+// ── Decoding ─────────────────────────────────────────────────────────────────
+
+class Collect : public hackos::logic::BusEventSink
+{
+public:
+    void onBusEvent(const BusEvent &e) override { events.push_back(e); }
+    std::vector<BusEvent> events;
+};
+
+double decodeNsPerEdge(BusDecoder &dec, const Wave &w, uint64_t end)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < DECODE_PASSES; ++pass)
+    {
+        dec.reset();
+        for (const LogicEdge &e : w.edges())
+        {
+            dec.feed(e);
+        }
+        dec.finish(end);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    return ns / DECODE_PASSES / static_cast<double>(w.edges().size());
+}
+
+bool report(const char *name, const Wave &w, size_t mismatches, double nsPerEdge)
+{
+    const double seconds = static_cast<double>(w.tick()) / RATE_HZ;
+    const double busEdgesPerS = static_cast<double>(w.edges().size()) / seconds;
+    std::printf("%-18s %7zu edges  %s  %6.1f ns/edge  %6.2f M edges/s  (x%.0f real time)\n",
+                name, w.edges().size(), mismatches == 0U ? "ok  " : "FAIL", nsPerEdge,
+                1000.0 / nsPerEdge, 1e9 / nsPerEdge / busEdgesPerS);
+    return mismatches == 0U;
+}
+
+class FileSink : public hackos::logic::LogicTextSink
+{
+public:
+    explicit FileSink(std::FILE *f) : f_(f) {}
+    bool write(const char *text, size_t len) override
+    {
+        return std::fwrite(text, 1U, len, f_) == len;
+    }
+
+private:
+    std::FILE *f_;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *vcdPath = nullptr;
+    if (argc == 3 && std::strcmp(argv[1], "-v") == 0)
+    {
+        vcdPath = argv[2];
+    }
+    else if (argc != 1)
+    {
+        std::fprintf(stderr, "usage: %s [-v uart.vcd]\n", argv[0]);
+        return 2;
+    }
+
+    std::srand(1U);
+    std::vector<uint8_t> payload(PAYLOAD_BYTES);
+    for (uint8_t &b : payload)
+    {
+        b = static_cast<uint8_t>(std::rand());
+    }
+    bool ok = true;
+
+    // ── UART ─────────────────────────────────────────────────────────────
+    {
+        Wave w(0x01U);
+        synthUart(w, payload, 115200U);
+        Collect out;
+        hackos::logic::UartConfig cfg;
+        hackos::logic::UartDecoder dec(out, cfg, RATE_HZ);
+        for (const LogicEdge &e : w.edges())
+        {
+            dec.feed(e);
+        }
+        dec.finish(w.tick());
+
+        size_t bad = (out.events.size() == payload.size()) ? 0U : 1U;
+        for (size_t i = 0U; bad == 0U && i < payload.size(); ++i)
+        {
+            bad += (out.events[i].value != payload[i] || out.events[i].flags != 0U) ? 1U : 0U;
+        }
+        std::printf("uart auto-baud: %lu\n", static_cast<unsigned long>(dec.baud()));
+        ok &= report("uart 115200 8N1", w, bad, decodeNsPerEdge(dec, w, w.tick()));
+
+        if (vcdPath != nullptr)
+        {
+            std::FILE *f = std::fopen(vcdPath, "w");
+            if (f == nullptr)
+            {
+                std::fprintf(stderr, "cannot open %s\n", vcdPath);
+                return 1;
+            }
+            FileSink sink(f);
+            hackos::logic::VcdWriter vcd(sink, RATE_HZ);
+            const char *names[] = {"TX"};
+            bool written = vcd.begin(names, 1U, w.edges().front().state);
+            for (const LogicEdge &e : w.edges())
+            {
+                written = written && vcd.edge(e);
+            }
+            written = written && vcd.finish(w.tick());
+            std::fclose(f);
+            std::printf("vcd: %s %s\n", vcdPath, written ? "written" : "FAILED");
+        }
+    }
+
+    // ── I2C ──────────────────────────────────────────────────────────────
+    {
+        Wave w(0x03U);
+        synthI2c(w, payload, 100000U);
+        Collect out;
+        hackos::logic::I2cDecoder dec(out, 0U, 1U);
+        for (const LogicEdge &e : w.edges())
+        {
+            dec.feed(e);
+        }
+
+        size_t bad = 0U;
+        size_t data = 0U;
+        for (const BusEvent &e : out.events)
+        {
+            if (e.type == BusEventType::I2C_ADDRESS)
+            {
+                bad += (e.value != 0x50U || (e.flags & hackos::logic::BUS_FLAG_READ) != 0U);
+            }
+            else if (e.type == BusEventType::I2C_DATA)
+            {
+                const bool last = (data % 16U) == 15U;
+                const bool nack = (e.flags & hackos::logic::BUS_FLAG_NACK) != 0U;
+                bad += (data >= payload.size() || e.value != payload[data] || nack != last);
+                ++data;
+            }
+        }
+        bad += (data != payload.size()) ? 1U : 0U;
+        ok &= report("i2c 100k", w, bad, decodeNsPerEdge(dec, w, w.tick()));
+    }
+
+    // ── SPI, all modes ───────────────────────────────────────────────────
+    for (unsigned mode = 0U; mode < 4U; ++mode)
+    {
+        const bool cpol = (mode & 2U) != 0U;
+        const bool cpha = (mode & 1U) != 0U;
+        Wave w(static_cast<uint8_t>(0x08U | (cpol ? 0x01U : 0U)));
+        synthSpi(w, payload, 250000U, cpol, cpha);
+
+        Collect out;
+        hackos::logic::SpiConfig cfg;
+        cfg.clk = 0U;
+        cfg.mosi = 1U;
+        cfg.miso = 2U;
+        cfg.cs = 3U;
+        cfg.cpol = cpol;
+        cfg.cpha = cpha;
+        hackos::logic::SpiDecoder dec(out, cfg);
+        for (const LogicEdge &e : w.edges())
+        {
+            dec.feed(e);
+        }
+
+        size_t bad = (out.events.size() == payload.size()) ? 0U : 1U;
+        for (size_t i = 0U; bad == 0U && i < payload.size(); ++i)
+        {
+            const BusEvent &e = out.events[i];
+            bad += (e.value != payload[i] || e.value2 != static_cast<uint8_t>(~payload[i]) ||
+                    e.flags != 0U) ? 1U : 0U;
+        }
+        char name[24];
+        std::snprintf(name, sizeof(name), "spi 250k mode %u", mode);
+        ok &= report(name, w, bad, decodeNsPerEdge(dec, w, w.tick()));
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file nfc_dump_bench.cpp
+ * @brief Host tool: .bin ↔ .nfc conversion, block diff and hex pager check.
+ *
+ *  1. Round trip: random Mifare 1K / 4K and NTAG213/215/216 dumps go
+ *     .bin → .nfc → .bin through every pairing of chunk sizes (1 byte up
+ *     to the whole file) and must come back byte-identical with the same
+ *     UID / ATQA / SAK / kind.  Unreadable units (`??`) and a short last
+ *     unit must survive as zero-filled units counted in unknownUnits().
+ *  2. Diff: plain data changes, sector trailer changes and value-block
+ *     increments between two 1K dumps, fed in odd chunk sizes; counters,
+ *     the changed-unit bitmap and decoded before/after values must match,
+ *     and value deltas must survive when more than MAX_DELTAS units change.
+ *  3. Hex pager over a 4K dump (4× the app's DUMP_BUF_SIZE) and an NTAG215
+ *     dump with a short last row: every row must match the file, and the
+ *     reads per row must stay at one window per half window scrolled.
+ *
+ * Also reports conversion throughput.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/nfc_dump_bench.cpp \
+ *      src/hardware/nfc/nfc_dump.cpp -o nfc_dump_bench
+ *  ./nfc_dump_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hardware/nfc/nfc_dump.h"
+#include "host/bench_check.h"
+
+using hackos::bench::finish;
+using hackos::bench::require;
+using hackos::nfc::mifareDecodeValue;
+using hackos::nfc::mifareIsTrailer;
+using hackos::nfc::NfcBinToFlipper;
+using hackos::nfc::NfcBlockDelta;
+using hackos::nfc::NfcByteSink;
+using hackos::nfc::NfcDumpDiff;
+using hackos::nfc::NfcDumpInfo;
+using hackos::nfc::NfcDumpKind;
+using hackos::nfc::NfcFlipperToBin;
+using hackos::nfc::NfcHexPager;
+using hackos::nfc::NfcMemorySource;
+using hackos::nfc::nfcUnitSize;
+
+namespace
+{
+
+/// nfc_tools_app.cpp: DUMP_BUF_SIZE = 64 blocks × 16 bytes.
+constexpr size_t DUMP_BUF_SIZE = 1024U;
+
+class VectorSink final : public NfcByteSink
+{
+public:
+    bool write(const uint8_t *data, size_t len) override
+    {
+        bytes.insert(bytes.end(), data, data + len);
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+};
+
+struct DumpCase
+{
+    const char *name;
+    NfcDumpKind kind;
+    uint16_t units;
+};
+
+const DumpCase CASES[] = {
+    {"Mifare 1K", NfcDumpKind::MIFARE_CLASSIC_1K, 64U},
+    {"Mifare 4K", NfcDumpKind::MIFARE_CLASSIC_4K, 256U},
+    {"NTAG213", NfcDumpKind::NTAG, 45U},
+    {"NTAG215", NfcDumpKind::NTAG, 135U},
+    {"NTAG216", NfcDumpKind::NTAG, 231U},
+};
+
+const size_t CHUNKS[] = {1U, 3U, 16U, 61U, 512U, 1U << 20};
+
+NfcDumpInfo makeInfo(const DumpCase &c, std::mt19937 &rng)
+{
+    NfcDumpInfo info = {};
+    info.kind = c.kind;
+    info.uidLen = (c.kind == NfcDumpKind::NTAG) ? 7U : 4U;
+    for (uint8_t i = 0U; i < info.uidLen; ++i)
+    {
+        info.uid[i] = static_cast<uint8_t>(rng());
+    }
+    info.atqa[0] = 0x00U;
+    info.atqa[1] = (c.kind == NfcDumpKind::NTAG) ? 0x44U : 0x04U;
+    info.sak = (c.kind == NfcDumpKind::NTAG) ? 0x00U
+               : (c.kind == NfcDumpKind::MIFARE_CLASSIC_4K) ? 0x18U : 0x08U;
+    info.units = c.units;
+    return info;
+}
+
+std::vector<uint8_t> toNfc(const NfcDumpInfo &info, const std::vector<uint8_t> &bin, size_t chunk,
+                           size_t unknownUnit = SIZE_MAX)
+{
+    VectorSink sink;
+    NfcBinToFlipper enc(sink);
+    (void)enc.begin(info);
+    const size_t unit = nfcUnitSize(info.kind);
+    for (size_t off = 0U; off < bin.size();)
+    {
+        if (unknownUnit != SIZE_MAX && off == unknownUnit * unit)
+        {
+            (void)enc.feedUnknown();
+            off += unit;
+            continue;
+        }
+        size_t n = (bin.size() - off < chunk) ? bin.size() - off : chunk;
+        if (unknownUnit != SIZE_MAX && off < unknownUnit * unit && off + n > unknownUnit * unit)
+        {
+            n = unknownUnit * unit - off;
+        }
+        (void)enc.feed(bin.data() + off, n);
+        off += n;
+    }
+    require(enc.finish(), "encoder sink writes");
+    return sink.bytes;
+}
+
+std::vector<uint8_t> toBin(const std::vector<uint8_t> &nfc, size_t chunk, NfcFlipperToBin &dec,
+                           VectorSink &sink)
+{
+    dec.begin();
+    for (size_t off = 0U; off < nfc.size(); off += chunk)
+    {
+        const size_t n = (nfc.size() - off < chunk) ? nfc.size() - off : chunk;
+        (void)dec.feed(reinterpret_cast<const char *>(nfc.data()) + off, n);
+    }
+    require(dec.finish(), "decoder sink writes");
+    return sink.bytes;
+}
+
+bool sameInfo(const NfcDumpInfo &a, const NfcDumpInfo &b)
+{
+    return a.kind == b.kind && a.uidLen == b.uidLen && std::memcmp(a.uid, b.uid, a.uidLen) == 0 &&
+           a.atqa[0] == b.atqa[0] && a.atqa[1] == b.atqa[1] && a.sak == b.sak;
+}
+
+// ── 1. Round trip ────────────────────────────────────────────────────────────
+
+void roundTrip()
+{
+    std::mt19937 rng(80U);
+    std::printf("Round trip .bin -> .nfc -> .bin (%zu x %zu chunk pairings per dump)\n",
+                sizeof(CHUNKS) / sizeof(CHUNKS[0]), sizeof(CHUNKS) / sizeof(CHUNKS[0]));
+    std::printf("  %-10s %6s %7s %9s %9s\n", "dump", "bin", "nfc", "enc MB/s", "dec MB/s");
+    for (const DumpCase &c : CASES)
+    {
+        const NfcDumpInfo info = makeInfo(c, rng);
+        std::vector<uint8_t> bin(static_cast<size_t>(c.units) * nfcUnitSize(c.kind));
+        for (uint8_t &b : bin)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+
+        bool identical = true;
+        bool header = true;
+        size_t nfcSize = 0U;
+        for (const size_t encChunk : CHUNKS)
+        {
+            const std::vector<uint8_t> nfc = toNfc(info, bin, encChunk);
+            nfcSize = nfc.size();
+            if (c.kind == NfcDumpKind::NTAG)
+            {
+                const std::string text(nfc.begin(), nfc.end());
+                header = header && text.find(std::string("NTAG/Ultralight type: ") + c.name +
+                                             "\n") != std::string::npos;
+            }
+            for (const size_t decChunk : CHUNKS)
+            {
+                VectorSink sink;
+                NfcFlipperToBin dec(sink);
+                identical = identical && toBin(nfc, decChunk, dec, sink) == bin &&
+                            dec.unknownUnits() == 0U && dec.unitsWritten() == c.units;
+                header = header && dec.sawHeader() && sameInfo(dec.info(), info);
+            }
+        }
+
+        // Throughput with app-sized chunks.
+        constexpr int REPS = 200;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < REPS; ++r)
+        {
+            (void)toNfc(info, bin, 512U);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const std::vector<uint8_t> nfc = toNfc(info, bin, 512U);
+        for (int r = 0; r < REPS; ++r)
+        {
+            VectorSink sink;
+            NfcFlipperToBin dec(sink);
+            (void)toBin(nfc, 512U, dec, sink);
+        }
+        const auto t2 = std::chrono::steady_clock::now();
+        const double encS = std::chrono::duration<double>(t1 - t0).count();
+        const double decS = std::chrono::duration<double>(t2 - t1).count();
+        std::printf("  %-10s %6zu %7zu %9.1f %9.1f\n", c.name, bin.size(), nfcSize,
+                    REPS * bin.size() / encS / 1e6, REPS * nfc.size() / decS / 1e6);
+        require(identical, "round trip is byte-identical for every chunking");
+        require(header, "type line, UID / ATQA / SAK / kind survive");
+    }
+
+    // Unreadable unit and short last unit.
+    const DumpCase &c = CASES[0];
+    const NfcDumpInfo info = makeInfo(c, rng);
+    std::vector<uint8_t> bin(static_cast<size_t>(c.units) * 16U - 5U, 0xA5U);
+    const std::vector<uint8_t> nfc = toNfc(info, bin, 7U, 9U);
+    VectorSink sink;
+    NfcFlipperToBin dec(sink);
+    const std::vector<uint8_t> back = toBin(nfc, 5U, dec, sink);
+    std::vector<uint8_t> expect(static_cast<size_t>(c.units) * 16U, 0xA5U);
+    std::memset(&expect[9U * 16U], 0, 16U);
+    std::memset(&expect[expect.size() - 5U], 0, 5U);
+    std::printf("  unknown block 9 + 5-byte short tail: %u units, %u unknown\n",
+                dec.unitsWritten(), dec.unknownUnits());
+    require(back == expect && dec.unknownUnits() == 2U, "unknown units zero-filled and counted");
+
+    // Last line without newline.
+    std::vector<uint8_t> cut = toNfc(info, std::vector<uint8_t>(32U, 0x11U), 32U);
+    cut.pop_back();
+    VectorSink sink2;
+    NfcFlipperToBin dec2(sink2);
+    require(toBin(cut, 64U, dec2, sink2) == std::vector<uint8_t>(32U, 0x11U),
+            "final line without newline is parsed");
+}
+
+// ── 2. Diff ──────────────────────────────────────────────────────────────────
+
+void encodeValue(uint8_t *block, int32_t value, uint8_t addr)
+{
+    const uint32_t v = static_cast<uint32_t>(value);
+    for (size_t i = 0U; i < 4U; ++i)
+    {
+        block[i] = static_cast<uint8_t>(v >> (8U * i));
+        block[4U + i] = static_cast<uint8_t>(~v >> (8U * i));
+        block[8U + i] = block[i];
+    }
+    block[12] = addr;
+    block[13] = static_cast<uint8_t>(~addr);
+    block[14] = addr;
+    block[15] = static_cast<uint8_t>(~addr);
+}
+
+void diff()
+{
+    std::mt19937 rng(81U);
+    std::vector<uint8_t> a(1024U);
+    for (uint8_t &b : a)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+    encodeValue(&a[5U * 16U], 100, 5U);
+    encodeValue(&a[9U * 16U], -20, 9U);
+    encodeValue(&a[13U * 16U], 7, 13U);
+
+    std::vector<uint8_t> b = a;
+    b[1U * 16U + 4U] ^= 0xFFU;                 // plain data
+    b[2U * 16U + 0U] ^= 0x01U;
+    b[2U * 16U + 15U] ^= 0x80U;
+    b[7U * 16U + 0U] ^= 0xFFU;                 // sector 1 trailer (key A)
+    encodeValue(&b[5U * 16U], 75, 5U);         // purse debited
+    encodeValue(&b[9U * 16U], 30, 9U);         // crosses zero
+    b[13U * 16U + 0U] ^= 0x01U;                // broken value block → plain change
+
+    bool ok = true;
+    for (const size_t chunk : {1U, 5U, 16U, 37U, 1024U})
+    {
+        NfcDumpDiff d;
+        d.begin(NfcDumpKind::MIFARE_CLASSIC_1K);
+        for (size_t off = 0U; off < a.size(); off += chunk)
+        {
+            const size_t n = (a.size() - off < chunk) ? a.size() - off : chunk;
+            d.feed(a.data() + off, b.data() + off, n);
+        }
+        ok = ok && d.unitsCompared() == 64U && d.changedUnits() == 6U && d.valueDeltas() == 2U &&
+             d.trailerChanges() == 1U && d.deltaCount() == 6U;
+        for (uint16_t u = 0U; u < 64U; ++u)
+        {
+            const bool want = u == 1U || u == 2U || u == 5U || u == 7U || u == 9U || u == 13U;
+            ok = ok && d.isChanged(u) == want;
+        }
+        for (size_t i = 0U; ok && i < d.deltaCount(); ++i)
+        {
+            const NfcBlockDelta &x = d.delta(i);
+            if (x.unit == 2U)
+            {
+                ok = x.byteMask == 0x8001U && !x.trailer && !x.value;
+            }
+            else if (x.unit == 5U)
+            {
+                ok = x.value && x.before == 100 && x.after == 75;
+            }
+            else if (x.unit == 7U)
+            {
+                ok = x.trailer && !x.value;
+            }
+            else if (x.unit == 9U)
+            {
+                ok = x.value && x.before == -20 && x.after == 30;
+            }
+            else if (x.unit == 13U)
+            {
+                ok = !x.value;
+            }
+        }
+    }
+    std::printf("\nDiff, 1K dump, 6 changed blocks in 5 chunkings: %s\n", ok ? "ok" : "MISMATCH");
+    require(ok, "diff counters, bitmap and value decoding");
+
+    // Overflow: a plain change in every data block from 14 on, then the two
+    // value deltas last.
+    std::vector<uint8_t> c = a;
+    for (uint16_t u = 14U; u < 64U; ++u)
+    {
+        if (!mifareIsTrailer(u))
+        {
+            c[u * 16U + 3U] ^= 0x5AU;
+        }
+    }
+    encodeValue(&c[5U * 16U], 1, 5U);
+    encodeValue(&c[9U * 16U], 2, 9U);
+    NfcDumpDiff d;
+    d.begin(NfcDumpKind::MIFARE_CLASSIC_1K);
+    // Value blocks compared last, as a live re-read of those blocks would.
+    for (uint16_t u = 0U; u < 64U; ++u)
+    {
+        if (u != 5U && u != 9U)
+        {
+            d.compareUnit(u, &a[u * 16U], &c[u * 16U]);
+        }
+    }
+    d.compareUnit(5U, &a[5U * 16U], &c[5U * 16U]);
+    d.compareUnit(9U, &a[9U * 16U], &c[9U * 16U]);
+    size_t kept = 0U;
+    for (size_t i = 0U; i < d.deltaCount(); ++i)
+    {
+        kept += d.delta(i).value ? 1U : 0U;
+    }
+    std::printf("  %u changes, %zu kept in detail, %zu of 2 value deltas kept\n", d.changedUnits(),
+                d.deltaCount(), kept);
+    require(d.deltaCount() == NfcDumpDiff::MAX_DELTAS && kept == 2U,
+            "value deltas displace plain changes when full");
+
+    // Value block round trip helper sanity.
+    int32_t v = 0;
+    uint8_t addr = 0U;
+    require(mifareDecodeValue(&c[9U * 16U], &v, &addr) && v == 2 && addr == 9U, "value decode");
+}
+
+// ── 3. Hex pager ─────────────────────────────────────────────────────────────
+
+class CountingSource final : public hackos::nfc::NfcPageSource
+{
+public:
+    explicit CountingSource(const std::vector<uint8_t> &data)
+        : inner_(data.data(), static_cast<uint32_t>(data.size()))
+    {
+    }
+
+    uint32_t size() const override { return inner_.size(); }
+
+    size_t readAt(uint32_t offset, uint8_t *buf, size_t len) override
+    {
+        ++reads;
+        const size_t n = inner_.readAt(offset, buf, len);
+        bytes += n;
+        return n;
+    }
+
+    uint32_t reads = 0U;
+    uint64_t bytes = 0U;
+
+private:
+    NfcMemorySource inner_;
+};
+
+void pager()
+{
+    std::mt19937 rng(82U);
+    std::printf("\nHex pager (window %zu rows = %zu B)\n", NfcHexPager::WINDOW_ROWS,
+                NfcHexPager::WINDOW_ROWS * NfcHexPager::ROW_BYTES);
+    std::printf("  %-24s %6s %5s %6s %9s\n", "dump", "bytes", "rows", "reads", "B read");
+    for (const size_t size : {4U * DUMP_BUF_SIZE, size_t{540U}})
+    {
+        std::vector<uint8_t> file(size);
+        for (uint8_t &b : file)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+        CountingSource src(file);
+        NfcHexPager pg;
+        pg.attach(&src);
+        const uint32_t rows = pg.rowCount();
+
+        bool match = rows == (size + 15U) / 16U;
+        // Scroll down, then back up, one row at a time (the viewer's UP/DOWN).
+        for (uint32_t r = 0U; r < rows; ++r)
+        {
+            size_t len = 0U;
+            const uint8_t *p = pg.row(r, &len);
+            const size_t want = (size - r * 16U < 16U) ? size - r * 16U : 16U;
+            match = match && p != nullptr && len == want && std::memcmp(p, &file[r * 16U], len) == 0;
+        }
+        const uint32_t downReads = src.reads;
+        for (uint32_t r = rows; r-- > 0U;)
+        {
+            size_t len = 0U;
+            const uint8_t *p = pg.row(r, &len);
+            match = match && p != nullptr && std::memcmp(p, &file[r * 16U], len) == 0;
+        }
+        // Jumps (page up / down, home / end).
+        for (int i = 0; i < 200; ++i)
+        {
+            const uint32_t r = rng() % rows;
+            size_t len = 0U;
+            const uint8_t *p = pg.row(r, &len);
+            match = match && p != nullptr && std::memcmp(p, &file[r * 16U], len) == 0;
+        }
+        size_t len = 0U;
+        match = match && pg.row(rows, &len) == nullptr;
+
+        const char *name = (size > DUMP_BUF_SIZE) ? "Mifare 4K (4x DUMP_BUF)" : "NTAG215 (short row)";
+        std::printf("  %-24s %6zu %5u %6u %9llu   scroll down: %u reads\n", name, size, rows,
+                    src.reads, static_cast<unsigned long long>(src.bytes), downReads);
+        require(match, "every row matches the file");
+        // One refill per half window while scrolling.
+        require(downReads <= rows / (NfcHexPager::WINDOW_ROWS / 2U) + 1U,
+                "sequential scroll reads once per half window");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    roundTrip();
+    diff();
+    pager();
+    return finish();
+}
@@ -0,0 +1,323 @@
+/**
+ * @file plugin_vm_bench.cpp
+ * @brief Host tool: plugin script compiler / VM correctness and speed.
+ *
+ * Compiles scripts with VmCompiler and runs them on PluginVm against a
+ * fake backend (virtual ms clock, pin levels, recorded outputs), then
+ * checks:
+ *
+ *  - operator precedence, loops, nested repeat, if / else if chains
+ *  - a frequency sweep and a pin poll keep their wait timing
+ *  - an endless loop is preempted by the instruction budget
+ *  - division by zero, bad / refused pins and corrupt bytecode fault
+ *  - syntax errors are reported with a message and offset
+ *  - interpreter throughput (instructions / s, host)
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/plugin_vm_bench.cpp \
+ *      src/core/plugin_vm.cpp -o plugin_vm_bench
+ *  ./plugin_vm_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/plugin_vm.h"
+
+using hackos::core::PluginVm;
+using hackos::core::VmBackend;
+using hackos::core::VmCompiler;
+using hackos::core::VmOutput;
+using hackos::core::VmStatus;
+
+namespace
+{
+
+struct Out
+{
+    uint32_t ms;
+    VmOutput kind;
+    int32_t value;
+};
+
+class FakeBackend final : public VmBackend
+{
+public:
+    uint32_t nowMs() override { return now; }
+
+    bool pinWrite(uint8_t pin, bool high) override
+    {
+        if (pin >= 6U && pin <= 11U)   // flash pins: refused like on the device
+        {
+            return false;
+        }
+        levels[pin] = high ? 1 : 0;
+        writes.push_back({now, VmOutput::PRINT, pin * 10 + levels[pin]});
+        return true;
+    }
+
+    bool pinRead(uint8_t pin, int32_t &level) override
+    {
+        level = levels[pin];
+        return true;
+    }
+
+    bool adcRead(uint8_t pin, int32_t &value) override
+    {
+        value = 100 * pin;
+        return pin >= 32U && pin <= 39U;
+    }
+
+    bool tone(uint8_t pin, uint32_t hz) override
+    {
+        tones.push_back({now, VmOutput::FREQ, static_cast<int32_t>(pin * 100000U + hz)});
+        return true;
+    }
+
+    void output(VmOutput kind, int32_t value) override { outs.push_back({now, kind, value}); }
+
+    uint32_t now = 0U;
+    int32_t levels[64] = {};
+    std::vector<Out> outs;
+    std::vector<Out> writes;
+    std::vector<Out> tones;
+};
+
+bool compile(const char *src, std::vector<uint8_t> &code)
+{
+    VmCompiler c;
+    code.assign(512U, 0U);
+    size_t size = 0U;
+    if (!c.compile(src, strlen(src), code.data(), code.size(), size))
+    {
+        std::printf("  compile error at %zu: %s\n    %s\n", c.errorOffset(), c.error(), src);
+        return false;
+    }
+    code.resize(size);
+    return true;
+}
+
+/// Run to completion on the virtual clock; @p onTick may change inputs.
+template <typename Tick>
+VmStatus runTimed(PluginVm &vm, FakeBackend &hw, uint32_t untilMs, Tick onTick)
+{
+    uint32_t waitUs = 0U;
+    VmStatus s = vm.status();
+    while (hw.now <= untilMs)
+    {
+        s = vm.run(64U, waitUs);
+        if (s == VmStatus::DONE || s == VmStatus::FAULT)
+        {
+            return s;
+        }
+        const uint32_t wake = hw.now + ((s == VmStatus::WAITING) ? waitUs / 1000U : 1U);
+        while (hw.now < wake)
+        {
+            ++hw.now;
+            onTick(hw.now);
+        }
+    }
+    return s;
+}
+
+bool expectOuts(const char *name, const char *src, const std::vector<int32_t> &want)
+{
+    FakeBackend hw;
+    PluginVm vm(hw);
+    std::vector<uint8_t> code;
+    bool ok = compile(src, code) && vm.load(code.data(), code.size()) &&
+              runTimed(vm, hw, 100000U, [](uint32_t) {}) == VmStatus::DONE &&
+              hw.outs.size() == want.size();
+    for (size_t i = 0U; ok && i < want.size(); ++i)
+    {
+        ok = hw.outs[i].value == want[i];
+    }
+    std::printf("%-28s %3zu B code, %6lu instr  %s\n", name, code.size(),
+                static_cast<unsigned long>(vm.executed()), ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool checkLanguage()
+{
+    bool ok = expectOuts("precedence / operators",
+                         "print 1+2*3; print (1+2)*3; print -7/2; print 7%3; print 0x10\n"
+                         "print 5>3 && 2>1; print !0 || 0; print 10-4-3; print -(2-5)*2",
+                         {7, 9, -3, 1, 16, 1, 1, 3, 6});
+    ok &= expectOuts("while / fibonacci",
+                     "a = 0; b = 1; n = 0\n"
+                     "while n < 10 { print a; t = a + b; a = b; b = t; n = n + 1 }",
+                     {0, 1, 1, 2, 3, 5, 8, 13, 21, 34});
+    ok &= expectOuts("nested repeat / if-else if",
+                     "n = 0; repeat 10 { repeat 5 { n = n + 1 } }; print n\n"
+                     "repeat 0 { print 99 }\n"
+                     "k = 0; repeat 4 { if k == 0 { print 100 } else if k == 1 { print 101 } "
+                     "else { print 102 }; k = k + 1 }",
+                     {50, 100, 101, 102, 102});
+    ok &= expectOuts("comments / JSON escapes",
+                     "x = 3 // comment\\n print x \\t; // trailing",
+                     {3});
+    return ok;
+}
+
+bool checkTiming()
+{
+    // Sweep: five freq hints 200 ms apart.
+    FakeBackend hw;
+    PluginVm vm(hw);
+    std::vector<uint8_t> code;
+    bool ok = compile("f = 433000000; repeat 5 { freq f; f = f + 100000; wait 200 }", code) &&
+              vm.load(code.data(), code.size()) &&
+              runTimed(vm, hw, 10000U, [](uint32_t) {}) == VmStatus::DONE && hw.outs.size() == 5U;
+    for (size_t i = 0U; ok && i < hw.outs.size(); ++i)
+    {
+        ok = hw.outs[i].kind == VmOutput::FREQ && hw.outs[i].ms == i * 200U &&
+             hw.outs[i].value == 433000000 + static_cast<int32_t>(i) * 100000;
+    }
+    std::printf("sweep 5 x 200 ms              ends at %lu ms  %s\n",
+                static_cast<unsigned long>(hw.now), ok ? "ok" : "FAIL");
+
+    // Poll pin 4 every 10 ms; it rises at 55 ms, so pin 25 goes high at 60.
+    FakeBackend hw2;
+    PluginVm vm2(hw2);
+    bool ok2 = compile("while pin(4) == 0 { wait 10 }; out 25, 1; tone 27, 2000", code) &&
+               vm2.load(code.data(), code.size()) &&
+               runTimed(vm2, hw2, 1000U, [&](uint32_t ms) { hw2.levels[4] = (ms >= 55U) ? 1 : 0; }) ==
+                   VmStatus::DONE &&
+               hw2.writes.size() == 1U && hw2.writes[0].ms == 60U && hw2.writes[0].value == 251;
+    vm2.stop();   // cancel silences the tone left on
+    ok2 = ok2 && hw2.tones.size() == 2U && hw2.tones[1].value == 2700000;
+    std::printf("poll pin 4 / 10 ms            out at %lu ms, tone off on stop  %s\n",
+                hw2.writes.empty() ? 0UL : static_cast<unsigned long>(hw2.writes[0].ms),
+                ok2 ? "ok" : "FAIL");
+    return ok && ok2;
+}
+
+bool checkSandbox()
+{
+    bool ok = true;
+    const struct
+    {
+        const char *src;
+        const char *fault;
+    } FAULTS[] = {
+        {"x = 0; print 10 / x", "division by zero"},
+        {"out 99, 1", "bad pin"},
+        {"out 7, 1", "pin not allowed"},
+        {"print adc(4)", "pin not allowed"},
+    };
+    for (const auto &f : FAULTS)
+    {
+        FakeBackend hw;
+        PluginVm vm(hw);
+        std::vector<uint8_t> code;
+        uint32_t waitUs = 0U;
+        const bool hit = compile(f.src, code) && vm.load(code.data(), code.size()) &&
+                         vm.run(1000U, waitUs) == VmStatus::FAULT &&
+                         strcmp(vm.faultMessage(), f.fault) == 0;
+        std::printf("fault %-24s -> %s  %s\n", f.src, hit ? vm.faultMessage() : "-", hit ? "ok" : "FAIL");
+        ok &= hit;
+    }
+
+    // Endless loop: every run() returns after exactly the budget.
+    FakeBackend hw;
+    PluginVm vm(hw);
+    std::vector<uint8_t> code;
+    uint32_t waitUs = 0U;
+    bool budget = compile("x = 0; while 1 { x = x + 1 }", code) && vm.load(code.data(), code.size());
+    for (int i = 0; budget && i < 10; ++i)
+    {
+        budget = vm.run(256U, waitUs) == VmStatus::RUNNING;
+    }
+    budget = budget && vm.executed() == 2560U;
+    std::printf("endless loop, budget 256      10 slices, %lu instr, x = %ld  %s\n",
+                static_cast<unsigned long>(vm.executed()), static_cast<long>(vm.reg(0)),
+                budget ? "ok" : "FAIL");
+
+    // Corrupt bytecode: a jump into the middle of PUSH32 is rejected.
+    const uint8_t bad[] = {
+        static_cast<uint8_t>(hackos::core::VmOp::PUSH32), 1, 2, 3, 4,
+        static_cast<uint8_t>(hackos::core::VmOp::JMP), 2, 0,
+    };
+    const uint8_t badReg[] = {static_cast<uint8_t>(hackos::core::VmOp::LOAD), 200};
+    const bool verify = !vm.load(bad, sizeof(bad)) && !vm.load(badReg, sizeof(badReg));
+    std::printf("load() rejects corrupt code   %s\n", verify ? "ok" : "FAIL");
+    return ok && budget && verify;
+}
+
+bool checkErrors()
+{
+    const char *const BAD[] = {
+        "x = ",
+        "repeat 3 { wait 1",
+        "print y",
+        "if 1 { } else",
+        "print 99999999999",
+        "x == 1",
+        "out 25 1",
+        "wait = 3",
+        "print ((((((((((((((((((1))))))))))))))))))+1*(2+(3*(4+(5*(6+(7*(8+(9*(1+(2*(3+(4*(5+(6*(7+8))))))))))))))",
+    };
+    bool ok = true;
+    for (const char *src : BAD)
+    {
+        VmCompiler c;
+        uint8_t code[256];
+        size_t size = 0U;
+        const bool rejected = !c.compile(src, strlen(src), code, sizeof(code), size) && c.error() != nullptr;
+        std::printf("error %-26.26s -> @%zu %s  %s\n", src, c.errorOffset(),
+                    c.error() != nullptr ? c.error() : "-", rejected ? "ok" : "FAIL");
+        ok &= rejected;
+    }
+
+    // 256 B plugin budget: a long script fails cleanly.
+    std::string big;
+    for (int i = 0; i < 40; ++i)
+    {
+        big += "out 25, 1; wait 100000; ";
+    }
+    VmCompiler c;
+    uint8_t code[256];
+    size_t size = 0U;
+    const bool tooBig = !c.compile(big.c_str(), big.size(), code, sizeof(code), size) &&
+                        strcmp(c.error(), "script too large") == 0;
+    std::printf("error %-26s -> %s  %s\n", "40 statements in 256 B", c.error(), tooBig ? "ok" : "FAIL");
+    return ok && tooBig;
+}
+
+void benchmark()
+{
+    FakeBackend hw;
+    PluginVm vm(hw);
+    std::vector<uint8_t> code;
+    if (!compile("i = 0; s = 0; while i < 2000000 { s = s + i * 3 % 7; i = i + 1 }; print s", code) ||
+        !vm.load(code.data(), code.size()))
+    {
+        return;
+    }
+    uint32_t waitUs = 0U;
+    const auto t0 = std::chrono::steady_clock::now();
+    while (vm.run(256U, waitUs) == VmStatus::RUNNING)
+    {
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::printf("throughput: %lu instr in %.1f ms = %.0f M instr/s, %.2f ns/instr (host, budget 256)\n",
+                static_cast<unsigned long>(vm.executed()), ns / 1e6, vm.executed() / ns * 1e3,
+                ns / vm.executed());
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = checkLanguage();
+    ok &= checkTiming();
+    ok &= checkSandbox();
+    ok &= checkErrors();
+    benchmark();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file pn532_sim_bench.cpp
+ * @brief Host tool: NFCReader NTAG and Mifare dump flows on the PN532
+ *        simulator, with round trips and virtual time per flow.
+ *
+ *  1. NTAG read: NTAG213/215/216 dumps through readNtagPages() (FAST_READ
+ *     bursts) against the plain 4-page READ loop; Ultralight must go
+ *     straight to READ after its GET_VERSION NAK.  Every dump must match
+ *     the tag, also when one exchange is dropped mid-read.
+ *  2. NTAG write: a 215 image with a few pages changed, written with and
+ *     without skipUnchanged; only changed pages may be programmed.
+ *  3. Mifare 1K dump, as nfc_tools_app.cpp runs it (auth the first block
+ *     of each sector, then READ ×4), on a card keyed with three dictionary
+ *     keys: fixed default-key order (no cache), a cold reader, the same
+ *     card again (UID cache), a second card with the same keying (hit
+ *     order + previous-sector key), and a card with one unknown sector.
+ *
+ * Each flow runs under three Pn532SimTiming profiles.  Round trips are
+ * PN532 commands (select + exchange); time is the simulator's clock.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude -Itools/host tools/pn532_sim_bench.cpp \
+ *      src/hardware/nfc_reader.cpp src/hardware/nfc/pn532_sim.cpp \
+ *      src/hardware/nfc/mifare_keys.cpp -o pn532_sim_bench
+ *  ./pn532_sim_bench
+ * @endcode
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "hardware/nfc/pn532_sim.h"
+#include "hardware/nfc_reader.h"
+#include "host/bench_check.h"
+
+using hackos::bench::finish;
+using hackos::bench::require;
+using hackos::nfc::Pn532SimStats;
+using hackos::nfc::Pn532SimTiming;
+using hackos::nfc::Pn532Simulator;
+using hackos::nfc::SimTagType;
+
+namespace
+{
+
+struct Profile
+{
+    const char *name;
+    Pn532SimTiming timing;
+};
+
+Pn532SimTiming makeTiming(uint32_t frameUs, uint32_t timeoutUs)
+{
+    Pn532SimTiming t;
+    t.frameUs = frameUs;
+    t.timeoutUs = timeoutUs;
+    return t;
+}
+
+const Profile PROFILES[] = {
+    {"fast SPI", makeTiming(400U, 5000U)},
+    {"default", Pn532SimTiming()},
+    {"slow SPI", makeTiming(2500U, 15000U)},
+};
+
+/// Round trips: every command that crosses the host ↔ PN532 link.
+uint32_t roundTrips(const Pn532SimStats &s)
+{
+    return s.selects + s.exchanges;
+}
+
+double ms(uint64_t us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+// ── 1. NTAG read ─────────────────────────────────────────────────────────────
+
+struct NtagCase
+{
+    const char *name;
+    SimTagType type;
+    uint16_t pages;
+};
+
+const NtagCase NTAG_CASES[] = {
+    {"NTAG213", SimTagType::NTAG213, 45U},
+    {"NTAG215", SimTagType::NTAG215, 135U},
+    {"NTAG216", SimTagType::NTAG216, 231U},
+    {"Ultralight", SimTagType::ULTRALIGHT, 16U},
+};
+
+std::vector<uint8_t> randomNtagImage(uint16_t pages, std::mt19937 &rng)
+{
+    std::vector<uint8_t> img(static_cast<size_t>(pages) * NFCReader::NTAG_PAGE_SIZE);
+    for (uint8_t &b : img)
+    {
+        b = static_cast<uint8_t>(rng());
+    }
+    img[0] = 0x04U; // NXP manufacturer byte
+    return img;
+}
+
+/// Pre-FAST_READ dump: one READ (4 pages) per exchange.
+bool readLoopDump(Pn532Simulator &sim, uint16_t pages, uint8_t *out)
+{
+    uint8_t uid[7] = {};
+    uint8_t uidLen = 0U;
+    if (!sim.inListPassiveTarget(uid, &uidLen, 500U))
+    {
+        return false;
+    }
+    for (uint16_t p = 0U; p < pages; p = static_cast<uint16_t>(p + NFCReader::NTAG_READ_PAGES))
+    {
+        const uint8_t cmd[2] = {0x30U, static_cast<uint8_t>(p)};
+        uint8_t resp[16];
+        uint8_t respLen = sizeof(resp);
+        if (!sim.inDataExchange(cmd, sizeof(cmd), resp, &respLen) || respLen < 16U)
+        {
+            return false;
+        }
+        const uint16_t left = static_cast<uint16_t>(pages - p);
+        const uint16_t got = (left < 4U) ? left : 4U;
+        std::memcpy(out + static_cast<size_t>(p) * 4U, resp, static_cast<size_t>(got) * 4U);
+    }
+    return true;
+}
+
+void ntagRead()
+{
+    std::printf("\n-- NTAG read: READ loop vs readNtagPages() --\n");
+    std::printf("  %-9s %-10s %5s | %8s %9s | %8s %9s %-9s | %6s\n", "profile", "tag", "pages",
+                "READ rt", "READ ms", "bulk rt", "bulk ms", "mode", "speedup");
+
+    std::mt19937 rng(81U);
+    for (const Profile &prof : PROFILES)
+    {
+        for (const NtagCase &c : NTAG_CASES)
+        {
+            const std::vector<uint8_t> img = randomNtagImage(c.pages, rng);
+            std::vector<uint8_t> dump(img.size());
+
+            Pn532Simulator sim(prof.timing);
+            require(sim.loadNtagImage(c.type, img.data()), "load NTAG image");
+
+            // Baseline: plain READ loop straight on the transport.
+            uint64_t t0 = sim.nowUs();
+            require(readLoopDump(sim, c.pages, dump.data()), "READ loop dump");
+            const uint64_t loopUs = sim.nowUs() - t0;
+            const uint32_t loopRt = roundTrips(sim.stats());
+            require(dump == img, "READ loop dump matches the tag");
+
+            // NFCReader as the app drives it: select, size, bulk read.
+            std::fill(dump.begin(), dump.end(), 0U);
+            auto reader = std::make_unique<NFCReader>(sim);
+            require(reader->init(), "reader init");
+            sim.resetStats();
+            t0 = sim.nowUs();
+            uint8_t uid[7] = {};
+            uint8_t uidLen = 0U;
+            require(reader->readUID(uid, &uidLen), "select");
+            uint16_t pages = reader->ntagPageCount();
+            if (c.type == SimTagType::ULTRALIGHT)
+            {
+                require(pages == 0U, "Ultralight NAKs GET_VERSION");
+                pages = c.pages;
+            }
+            require(pages == c.pages, "GET_VERSION gives the page count");
+            const bool ok = reader->readNtagPages(0U, pages, dump.data());
+            const uint64_t bulkUs = sim.nowUs() - t0;
+            const uint32_t bulkRt = roundTrips(sim.stats());
+            const NtagOpStats &st = reader->lastNtagRead();
+
+            std::printf("  %-9s %-10s %5u | %8u %9.1f | %8u %9.1f %-9s | %5.2fx\n", prof.name,
+                        c.name, static_cast<unsigned>(c.pages), loopRt, ms(loopUs), bulkRt,
+                        ms(bulkUs), st.fastRead ? "FAST_READ" : "READ",
+                        static_cast<double>(loopUs) / static_cast<double>(bulkUs));
+
+            require(ok && st.ok, "readNtagPages succeeds");
+            require(dump == img, "bulk dump matches the tag");
+            if (c.type == SimTagType::ULTRALIGHT)
+            {
+                require(!st.fastRead, "Ultralight falls back to READ");
+                require(st.exchanges == c.pages / NFCReader::NTAG_READ_PAGES,
+                        "Ultralight: the GET_VERSION NAK skips FAST_READ");
+            }
+            else
+            {
+                const unsigned bursts = (c.pages + NFCReader::NTAG_FAST_READ_MAX_PAGES - 1U) /
+                                        NFCReader::NTAG_FAST_READ_MAX_PAGES;
+                require(st.fastRead && st.exchanges == bursts,
+                        "NTAG: one FAST_READ per 12 pages");
+                require(bulkUs < loopUs, "FAST_READ dump beats the READ loop");
+            }
+        }
+    }
+
+    // Tag briefly out of range during a bulk read: the reader may drop to
+    // READ or fail, but never return wrong data.
+    Pn532Simulator sim;
+    const std::vector<uint8_t> img = randomNtagImage(135U, rng);
+    require(sim.loadNtagImage(SimTagType::NTAG215, img.data()), "load NTAG215");
+    auto reader = std::make_unique<NFCReader>(sim);
+    require(reader->init(), "reader init");
+    uint8_t uid[7] = {};
+    uint8_t uidLen = 0U;
+    require(reader->readUID(uid, &uidLen), "select");
+    std::vector<uint8_t> dump(img.size());
+    sim.dropExchanges(1U);
+    const bool ok = reader->readNtagPages(0U, 135U, dump.data());
+    std::printf("  dropped exchange: %s, %u exchanges, %s\n", ok ? "recovered" : "failed",
+                static_cast<unsigned>(reader->lastNtagRead().exchanges),
+                reader->lastNtagRead().fastRead ? "FAST_READ" : "READ");
+    require(!ok || dump == img, "a recovered read still matches the tag");
+}
+
+// ── 2. NTAG write ────────────────────────────────────────────────────────────
+
+void ntagWrite()
+{
+    std::printf("\n-- NTAG215 write: user pages 4-129, 6 pages changed --\n");
+    std::printf("  %-9s %-14s %8s %8s %9s\n", "profile", "mode", "written", "rt", "ms");
+
+    constexpr uint8_t FIRST = 4U;
+    constexpr uint16_t COUNT = 126U;
+    std::mt19937 rng(215U);
+
+    for (const Profile &prof : PROFILES)
+    {
+        const std::vector<uint8_t> img = randomNtagImage(135U, rng);
+        std::vector<uint8_t> target = img;
+        const uint16_t changed[] = {4U, 5U, 17U, 60U, 61U, 129U};
+        for (uint16_t p : changed)
+        {
+            target[static_cast<size_t>(p) * 4U + 1U] ^= 0x5AU;
+        }
+
+        for (const bool skip : {false, true})
+        {
+            Pn532Simulator sim(prof.timing);
+            require(sim.loadNtagImage(SimTagType::NTAG215, img.data()), "load NTAG215");
+            auto reader = std::make_unique<NFCReader>(sim);
+            require(reader->init(), "reader init");
+            uint8_t uid[7] = {};
+            uint8_t uidLen = 0U;
+            require(reader->readUID(uid, &uidLen), "select");
+            sim.resetStats();
+            const uint64_t t0 = sim.nowUs();
+            const bool ok = reader->writeNtagPages(FIRST, COUNT,
+                                                   target.data() + FIRST * 4U, skip);
+            const uint64_t us = sim.nowUs() - t0;
+            const NtagOpStats &st = reader->lastNtagWrite();
+
+            std::printf("  %-9s %-14s %8u %8u %9.1f\n", prof.name,
+                        skip ? "skipUnchanged" : "write all", static_cast<unsigned>(st.written),
+                        roundTrips(sim.stats()), ms(us));
+            require(ok && st.ok, "writeNtagPages succeeds");
+            require(std::memcmp(sim.tagMemory(), target.data(), target.size()) == 0,
+                    "tag holds the new image");
+            require(st.written == (skip ? sizeof(changed) / sizeof(changed[0]) : COUNT),
+                    "skipUnchanged programs only the changed pages");
+            require(sim.stats().writes == st.written, "simulator saw the same writes");
+        }
+    }
+}
+
+// ── 3. Mifare 1K dump ────────────────────────────────────────────────────────
+
+constexpr uint8_t KEY_FF[6] = {0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU};
+constexpr uint8_t KEY_NFC_FORUM[6] = {0xD3U, 0xF7U, 0xD3U, 0xF7U, 0xD3U, 0xF7U};
+constexpr uint8_t KEY_NDEF[6] = {0x4DU, 0x3AU, 0x99U, 0xC3U, 0x51U, 0xDDU};
+constexpr uint8_t KEY_UNKNOWN[6] = {0x13U, 0x37U, 0xC0U, 0xFFU, 0xEEU, 0x42U};
+
+/// Sectors 0-5 factory key, 6-11 NFC Forum key, 12-15 NDEF key (dictionary
+/// positions 0, 3 and 5); @p unknownSector gets a key outside the dictionary.
+void loadKeyedCard(Pn532Simulator &sim, const uint8_t *uid, std::mt19937 &rng,
+                   int unknownSector = -1)
+{
+    require(sim.loadMifare1k(uid, 4U), "load Mifare 1K");
+    // Fill the data blocks so the dump check means something.
+    std::vector<uint8_t> img(sim.tagMemory(), sim.tagMemory() + sim.tagSize());
+    for (uint8_t b = 1U; b < NFCReader::MIFARE_1K_BLOCKS; ++b)
+    {
+        if (b % NFCReader::BLOCKS_PER_SECTOR == 3U)
+        {
+            continue;
+        }
+        for (uint8_t i = 0U; i < NFCReader::BYTES_PER_BLOCK; ++i)
+        {
+            img[static_cast<size_t>(b) * 16U + i] = static_cast<uint8_t>(rng());
+        }
+    }
+    require(sim.loadMifare1kImage(img.data()), "load Mifare 1K image");
+    for (uint8_t s = 0U; s < NFCReader::MIFARE_1K_SECTORS; ++s)
+    {
+        const uint8_t *key = (s < 6U) ? KEY_FF : (s < 12U) ? KEY_NFC_FORUM : KEY_NDEF;
+        if (static_cast<int>(s) == unknownSector)
+        {
+            key = KEY_UNKNOWN;
+        }
+        require(sim.setSectorKeyA(s, key), "set sector key");
+    }
+}
+
+struct DumpResult
+{
+    uint32_t roundTrips;
+    uint32_t auths;
+    uint32_t authFailures;
+    uint64_t us;
+    uint8_t sectorsOk;
+    uint8_t cachedSectors;
+    bool dataOk;
+};
+
+/// Blocks as they read back: key A of each trailer reads as zeros.
+bool sectorMatches(const Pn532Simulator &sim, uint8_t sector, const uint8_t *dump)
+{
+    const size_t off = static_cast<size_t>(sector) * 64U;
+    const uint8_t *mem = sim.tagMemory() + off;
+    const uint8_t zeros[6] = {};
+    return std::memcmp(dump + off, mem, 48U) == 0 &&
+           std::memcmp(dump + off + 48U, zeros, 6U) == 0 &&
+           std::memcmp(dump + off + 54U, mem + 54U, 10U) == 0;
+}
+
+/// nfc_tools_app.cpp stepDump(): select, then per sector
+/// authenticateBlockWithKeys() on the first block and READ ×4.
+DumpResult readerDump(NFCReader &reader, Pn532Simulator &sim)
+{
+    DumpResult r{};
+    uint8_t dump[1024] = {};
+    sim.resetStats();
+    const uint64_t t0 = sim.nowUs();
+    uint8_t uid[7] = {};
+    uint8_t uidLen = 0U;
+    r.dataOk = reader.readUID(uid, &uidLen);
+
+    for (uint8_t s = 0U; r.dataOk && s < NFCReader::MIFARE_1K_SECTORS; ++s)
+    {
+        const uint8_t first = static_cast<uint8_t>(s * NFCReader::BLOCKS_PER_SECTOR);
+        if (!reader.authenticateBlockWithKeys(uid, uidLen, first))
+        {
+            continue;
+        }
+        if (reader.lastMifareAuth().source == MifareKeySource::UID_CACHE)
+        {
+            ++r.cachedSectors;
+        }
+        bool ok = true;
+        for (uint8_t b = 0U; ok && b < NFCReader::BLOCKS_PER_SECTOR; ++b)
+        {
+            ok = reader.readBlock(static_cast<uint8_t>(first + b), dump + (first + b) * 16U);
+        }
+        if (ok)
+        {
+            ++r.sectorsOk;
+            r.dataOk = r.dataOk && sectorMatches(sim, s, dump);
+        }
+    }
+
+    r.us = sim.nowUs() - t0;
+    r.roundTrips = roundTrips(sim.stats());
+    r.auths = sim.stats().auths;
+    r.authFailures = sim.stats().authFailures;
+    return r;
+}
+
+/// Key handling before the dictionary and UID cache: every sector tries
+/// the default keys in fixed order, re-selecting after each failure.
+DumpResult fixedOrderDump(Pn532Simulator &sim)
+{
+    DumpResult r{};
+    uint8_t dump[1024] = {};
+    sim.resetStats();
+    const uint64_t t0 = sim.nowUs();
+    uint8_t uid[7] = {};
+    uint8_t uidLen = 0U;
+    r.dataOk = sim.inListPassiveTarget(uid, &uidLen, 500U);
+
+    for (uint8_t s = 0U; r.dataOk && s < NFCReader::MIFARE_1K_SECTORS; ++s)
+    {
+        const uint8_t first = static_cast<uint8_t>(s * NFCReader::BLOCKS_PER_SECTOR);
+        bool authed = false;
+        for (uint8_t k = 0U; !authed && k < NFCReader::NUM_DEFAULT_KEYS; ++k)
+        {
+            if (k > 0U && !sim.inListPassiveTarget(uid, &uidLen, 200U))
+            {
+                break;
+            }
+            uint8_t cmd[12] = {0x60U, first};
+            std::memcpy(cmd + 2, NFCReader::defaultKeys()[k], 6U);
+            std::memcpy(cmd + 8, uid + (uidLen - 4U), 4U);
+            uint8_t resp[4];
+            uint8_t respLen = sizeof(resp);
+            authed = sim.inDataExchange(cmd, sizeof(cmd), resp, &respLen);
+        }
+        if (!authed)
+        {
+            // Leave the card selected for the next sector.
+            (void)sim.inListPassiveTarget(uid, &uidLen, 200U);
+            continue;
+        }
+        bool ok = true;
+        for (uint8_t b = 0U; ok && b < NFCReader::BLOCKS_PER_SECTOR; ++b)
+        {
+            const uint8_t cmd[2] = {0x30U, static_cast<uint8_t>(first + b)};
+            uint8_t resp[16];
+            uint8_t respLen = sizeof(resp);
+            ok = sim.inDataExchange(cmd, sizeof(cmd), resp, &respLen) && respLen == 16U;
+            std::memcpy(dump + (first + b) * 16U, resp, 16U);
+        }
+        if (ok)
+        {
+            ++r.sectorsOk;
+            r.dataOk = r.dataOk && sectorMatches(sim, s, dump);
+        }
+    }
+
+    r.us = sim.nowUs() - t0;
+    r.roundTrips = roundTrips(sim.stats());
+    r.auths = sim.stats().auths;
+    r.authFailures = sim.stats().authFailures;
+    return r;
+}
+
+void printDump(const char *profile, const char *flow, const DumpResult &r)
+{
+    std::printf("  %-9s %-24s %3u/16 %6u %6u %6u %6u %9.1f\n", profile, flow,
+                static_cast<unsigned>(r.sectorsOk), static_cast<unsigned>(r.cachedSectors),
+                r.auths, r.authFailures, r.roundTrips, ms(r.us));
+}
+
+void mifareDump()
+{
+    std::printf("\n-- Mifare 1K dump: sectors keyed FF / D3F7 / 4D3A --\n");
+    std::printf("  %-9s %-24s %6s %6s %6s %6s %6s %9s\n", "profile", "flow", "ok", "cached",
+                "auths", "fail", "rt", "ms");
+
+    const uint8_t uidA[4] = {0xDEU, 0xADU, 0xBEU, 0xEFU};
+    const uint8_t uidB[4] = {0x01U, 0x23U, 0x45U, 0x67U};
+    const uint8_t uidC[4] = {0x89U, 0xABU, 0xCDU, 0xEFU};
+    std::mt19937 rng(79U);
+
+    for (const Profile &prof : PROFILES)
+    {
+        Pn532Simulator sim(prof.timing);
+
+        loadKeyedCard(sim, uidA, rng);
+        const DumpResult fixed = fixedOrderDump(sim);
+        printDump(prof.name, "fixed key order", fixed);
+
+        auto reader = std::make_unique<NFCReader>(sim);
+        require(reader->init(), "reader init");
+        const DumpResult cold = readerDump(*reader, sim);
+        printDump(prof.name, "cold reader", cold);
+        const DumpResult warm = readerDump(*reader, sim);
+        printDump(prof.name, "same card again", warm);
+
+        loadKeyedCard(sim, uidB, rng);
+        const DumpResult second = readerDump(*reader, sim);
+        printDump(prof.name, "second card, same keys", second);
+
+        loadKeyedCard(sim, uidC, rng, 9);
+        const DumpResult unknown = readerDump(*reader, sim);
+        printDump(prof.name, "sector 9 unknown key", unknown);
+
+        require(fixed.sectorsOk == 16U && fixed.dataOk, "fixed order reads every sector");
+        require(cold.sectorsOk == 16U && cold.dataOk, "cold reader reads every sector");
+        require(warm.sectorsOk == 16U && warm.dataOk, "warm reader reads every sector");
+        require(second.sectorsOk == 16U && second.dataOk, "second card reads every sector");
+        require(unknown.sectorsOk == 15U && unknown.dataOk,
+                "only the unknown sector is missing");
+
+        require(cold.auths < fixed.auths && cold.us < fixed.us,
+                "previous-sector key beats fixed order on a cold reader");
+        require(warm.cachedSectors == 16U && warm.auths == 16U && warm.authFailures == 0U,
+                "same card again: one cached auth per sector");
+        require(second.auths <= cold.auths, "hit order helps the next card");
+        // Unknown sector: every dictionary key once, plus the card must be
+        // re-selected for sector 10.
+        require(unknown.auths <= second.auths + NFCReader::NUM_DEFAULT_KEYS + 2U,
+                "an unknown sector costs one dictionary pass");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    ntagRead();
+    ntagWrite();
+    mifareDump();
+    return finish();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file ram_disk_bench.cpp
+ * @brief Host tool: RamDisk file semantics, eviction and throughput.
+ *
+ * Checks, on a 32 KiB budget like VirtualFS `/ram/`:
+ *
+ *  - write / read back / overwrite / gap fill / truncate
+ *  - implied directories in nextEntry() and remove-while-open
+ *  - LRU eviction spares open and pinned files and the budget holds
+ *  - a write that cannot fit comes up short instead of failing silently
+ *  - sequential write and read throughput in 128-byte chunks (the
+ *    BufferedWriter / FileSource chunk size)
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/ram_disk_bench.cpp \
+ *      src/storage/ram_disk.cpp -o ram_disk_bench
+ *  ./ram_disk_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "storage/ram_disk.h"
+
+using hackos::storage::RamDisk;
+
+namespace
+{
+
+constexpr size_t BUDGET = 32U * 1024U;
+
+bool report(const char *what, bool ok)
+{
+    std::printf("%-44s %s\n", what, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+std::vector<uint8_t> pattern(size_t len, uint8_t seed)
+{
+    std::vector<uint8_t> v(len);
+    for (size_t i = 0U; i < len; ++i)
+    {
+        v[i] = static_cast<uint8_t>(seed + i * 7U);
+    }
+    return v;
+}
+
+bool writeFile(RamDisk &disk, const char *path, const std::vector<uint8_t> &data)
+{
+    const int h = disk.open(path, true, true);
+    const bool ok = h >= 0 && disk.write(h, 0U, data.data(), data.size()) == data.size();
+    disk.release(h);
+    return ok;
+}
+
+bool checkSemantics()
+{
+    RamDisk disk(BUDGET);
+    const std::vector<uint8_t> a = pattern(1000U, 1U);
+    bool ok = writeFile(disk, "/t/a.bin", a);
+
+    int h = disk.open("/t/a.bin", false, false);
+    std::vector<uint8_t> back(1200U);
+    ok = ok && disk.read(h, 0U, back.data(), back.size()) == a.size() &&
+         std::memcmp(back.data(), a.data(), a.size()) == 0;
+
+    // Overwrite inside, then write past the end leaving a gap.
+    const uint8_t mark[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+    ok = ok && disk.write(h, 10U, mark, 4U) == 4U && disk.write(h, 1100U, mark, 4U) == 4U;
+    ok = ok && disk.size(h) == 1104U && disk.read(h, 10U, back.data(), 4U) == 4U &&
+         std::memcmp(back.data(), mark, 4U) == 0;
+    ok = ok && disk.read(h, 1000U, back.data(), 100U) == 100U && back[0] == 0U && back[99] == 0U;
+    disk.release(h);
+
+    h = disk.open("/t/a.bin", false, true);
+    ok = ok && h >= 0 && disk.size(h) == 0U;
+    disk.release(h);
+    ok = ok && disk.open("/t/missing", false, false) < 0;
+    ok = ok && disk.open("/t/a.bin/x", true, false) < 0;   // parent is a file
+    ok = report("write / read / overwrite / gap / truncate", ok);
+
+    // Directory listing: /t has a.bin and sub-directory d (reported once).
+    ok = writeFile(disk, "/t/d/1", a) && writeFile(disk, "/t/d/2", a) && writeFile(disk, "/u", a);
+    size_t cursor = 0U;
+    char name[RamDisk::MAX_PATH];
+    bool isDir = false;
+    uint32_t size = 0U;
+    std::string seen;
+    while (disk.nextEntry("/t", cursor, name, sizeof(name), isDir, size))
+    {
+        seen += std::string(name) + (isDir ? "/ " : " ");
+    }
+    ok = ok && seen == "a.bin d/ " && disk.isDir("/t/d") && !disk.isDir("/u") && disk.exists("/t");
+    ok = report("implied directories", ok);
+
+    // Remove while open: gone from the namespace, data readable until release.
+    h = disk.open("/u", false, false);
+    ok = disk.remove("/u") && !disk.exists("/u") && disk.read(h, 0U, back.data(), 10U) == 10U;
+    const size_t before = disk.usedBytes();
+    disk.release(h);
+    ok = ok && disk.usedBytes() < before;
+    ok = ok && disk.rename("/t/d/1", "/t/d/3") && disk.exists("/t/d/3") && !disk.exists("/t/d/1");
+    return report("remove while open / rename", ok);
+}
+
+bool checkEviction()
+{
+    RamDisk disk(BUDGET);
+    const std::vector<uint8_t> chunk = pattern(4000U, 3U);
+    char path[32];
+    bool ok = true;
+    for (int i = 0; i < 6; ++i)
+    {
+        std::snprintf(path, sizeof(path), "/e/%d", i);
+        ok = ok && writeFile(disk, path, chunk);
+    }
+    ok = ok && disk.pin("/e/0", true);
+    const int held = disk.open("/e/1", false, false);
+
+    // 6 × 4 KiB in use; 12 KiB more forces the oldest unprotected file out.
+    ok = ok && writeFile(disk, "/e/big", pattern(12000U, 5U));
+    ok = ok && disk.exists("/e/0") && disk.exists("/e/1") && !disk.exists("/e/2") &&
+         disk.exists("/e/3") && disk.usedBytes() <= BUDGET;
+    disk.release(held);
+    const bool lruOk = report("LRU eviction spares pinned / open files", ok);
+
+    // Nothing evictable left once everything is open: the write comes up short.
+    std::vector<int> handles;
+    for (const char *p : {"/e/0", "/e/1", "/e/4", "/e/5", "/e/big"})
+    {
+        handles.push_back(disk.open(p, false, false));
+    }
+    const int h = disk.open("/e/huge", true, true);
+    const std::vector<uint8_t> huge = pattern(BUDGET, 9U);
+    const size_t n = disk.write(h, 0U, huge.data(), huge.size());
+    ok = n > 0U && n < huge.size() && disk.usedBytes() <= BUDGET && disk.stats().shortWrites > 0U;
+    disk.release(h);
+    for (int held2 : handles)
+    {
+        disk.release(held2);
+    }
+    std::printf("  evictions=%u shortWrites=%u peak=%zu B\n",
+                static_cast<unsigned>(disk.stats().evictions),
+                static_cast<unsigned>(disk.stats().shortWrites), disk.stats().peakBytes);
+    return report("budget holds, full disk gives short write", ok) && lruOk;
+}
+
+void throughput()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t CHUNK = 128U;
+    constexpr size_t FILE_BYTES = 24U * 1024U;
+    constexpr int ROUNDS = 400;
+    RamDisk disk(BUDGET);
+    const std::vector<uint8_t> chunk = pattern(CHUNK, 1U);
+    uint8_t buf[CHUNK];
+
+    const auto t0 = Clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        const int h = disk.open("/bench", true, true);
+        for (size_t pos = 0U; pos < FILE_BYTES; pos += CHUNK)
+        {
+            (void)disk.write(h, pos, chunk.data(), CHUNK);
+        }
+        disk.release(h);
+    }
+    const auto t1 = Clock::now();
+    size_t sink = 0U;
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        const int h = disk.open("/bench", false, false);
+        for (size_t pos = 0U; pos < FILE_BYTES; pos += CHUNK)
+        {
+            sink += disk.read(h, pos, buf, CHUNK);
+        }
+        disk.release(h);
+    }
+    const auto t2 = Clock::now();
+
+    const double mb = static_cast<double>(FILE_BYTES) * ROUNDS / (1024.0 * 1024.0);
+    const double ws = std::chrono::duration<double>(t1 - t0).count();
+    const double rs = std::chrono::duration<double>(t2 - t1).count();
+    std::printf("throughput (128 B chunks): write %.0f MiB/s  read %.0f MiB/s  (%zu)\n",
+                mb / ws, mb / rs, sink);
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = checkSemantics();
+    ok &= checkEviction();
+    throughput();
+    std::printf("%s\n", ok ? "all ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file scratch_arena_bench.cpp
+ * @brief Host tool: replay app sessions against ScratchArena and check
+ *        that the borrowers fit Scratch::CAPACITY together.
+ *
+ *  1. Sessions: a user switches between the net forensics, hardware bridge
+ *     and Sub-GHz apps for simulated hours.  Every switch runs a scene
+ *     transition; inside the apps captures, sniffs and replays start and
+ *     stop at random.  Every lease is filled with its tag byte and checked
+ *     on release, so an overlap shows up as a corrupted block.
+ *  2. Fragmentation: random lease sizes and lifetimes up to the capacity;
+ *     counts refusals where the free bytes would have sufficed.
+ *  3. Cost of a lease / release pair with a few live leases.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/scratch_arena_bench.cpp \
+ *      src/core/scratch_arena.cpp -o scratch_arena_bench
+ *  ./scratch_arena_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/scratch_arena.h"
+#include "hardware/radio/signal_format.h"
+
+using hackos::core::ScratchArena;
+
+namespace
+{
+
+// Scratch::CAPACITY (scratch.h pulls in FreeRTOS).
+constexpr size_t CAPACITY = 10752U;
+
+// Borrower footprints, as laid out on the ESP32 (4-byte size_t).
+constexpr size_t NF_RING = 32U * (8U + 256U) + 2U * 4U;
+constexpr size_t HB_SNIFF = 512U + 2U * 4U;
+constexpr size_t SCENES = 2U * 1024U;
+constexpr size_t RADIO_RX = hackos::radio::MAX_RAW_SAMPLES * 4U + sizeof(hackos::radio::SignalRecord);
+constexpr size_t RADIO_TX = hackos::radio::MAX_RAW_SAMPLES * 4U;
+
+// Reserved before: every borrower statically (RADIO_RX's record was on
+// the worker stack).
+constexpr size_t STATIC_BEFORE = NF_RING + HB_SNIFF + SCENES + RADIO_RX + RADIO_TX;
+
+struct Live
+{
+    uint8_t *ptr;
+    size_t bytes;
+    uint8_t fill;
+};
+
+struct Checked
+{
+    ScratchArena &arena;
+    std::vector<Live> live;
+    uint32_t corrupt;
+    uint32_t misaligned;
+
+    uint8_t *lease(const char *tag, size_t bytes, uint8_t fill, uint32_t nowMs)
+    {
+        auto *p = static_cast<uint8_t *>(arena.lease(tag, bytes, nowMs));
+        if (p == nullptr)
+        {
+            return nullptr;
+        }
+        if ((reinterpret_cast<uintptr_t>(p) & (ScratchArena::ALIGN - 1U)) != 0U)
+        {
+            ++misaligned;
+        }
+        std::memset(p, fill, bytes);
+        live.push_back({p, bytes, fill});
+        return p;
+    }
+
+    void release(uint8_t *p, uint32_t nowMs)
+    {
+        if (p == nullptr)
+        {
+            return;   // counted when the lease was refused
+        }
+        for (size_t i = 0U; i < live.size(); ++i)
+        {
+            if (live[i].ptr != p)
+            {
+                continue;
+            }
+            for (size_t b = 0U; b < live[i].bytes; ++b)
+            {
+                if (p[b] != live[i].fill)
+                {
+                    ++corrupt;
+                    break;
+                }
+            }
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+            if (!arena.release(p, nowMs))
+            {
+                ++corrupt;
+            }
+            return;
+        }
+        ++corrupt;
+    }
+};
+
+// ── 1. Sessions ──────────────────────────────────────────────────────────────
+
+enum class App
+{
+    NET_FORENSICS,
+    HARDWARE_BRIDGE,
+    SUBGHZ,
+};
+
+bool runSessions(uint32_t hours)
+{
+    alignas(ScratchArena::ALIGN) static uint8_t block[CAPACITY];
+    ScratchArena arena(block, CAPACITY);
+    Checked chk{arena, {}, 0U, 0U};
+    std::mt19937 rng(99U);
+    auto within = [&](uint32_t lo, uint32_t hi) { return lo + rng() % (hi - lo + 1U); };
+
+    const uint32_t endMs = hours * 3600U * 1000U;
+    uint32_t now = 0U;
+    uint32_t switches = 0U;
+    uint32_t refused = 0U;
+
+    while (now < endMs)
+    {
+        // Transition into the next app: snapshots for 200 ms.
+        uint8_t *scenes = chk.lease("anim", SCENES, 0xA5U, now);
+        refused += (scenes == nullptr) ? 1U : 0U;
+        const App app = static_cast<App>(rng() % 3U);
+        ++switches;
+
+        const uint32_t sessionEnd = now + within(30000U, 600000U);
+        uint32_t t = now + 200U;
+        chk.release(scenes, t);
+
+        // Activities inside the app, each with its own lease.
+        while (t < sessionEnd)
+        {
+            const uint32_t len = within(1000U, 120000U);
+            switch (app)
+            {
+            case App::NET_FORENSICS:
+            {
+                uint8_t *ring = chk.lease("nf_ring", NF_RING, 0x11U, t);
+                refused += (ring == nullptr) ? 1U : 0U;
+                chk.release(ring, t + len);
+                break;
+            }
+            case App::HARDWARE_BRIDGE:
+            {
+                uint8_t *ring = chk.lease("hb_sniff", HB_SNIFF, 0x22U, t);
+                refused += (ring == nullptr) ? 1U : 0U;
+                chk.release(ring, t + len);
+                break;
+            }
+            case App::SUBGHZ:
+            {
+                uint8_t *rx = chk.lease("radio_rx", RADIO_RX, 0x33U, t);
+                refused += (rx == nullptr) ? 1U : 0U;
+                // Replays while capturing, with a transition on top.
+                for (uint32_t k = within(0U, 3U); k > 0U; --k)
+                {
+                    uint8_t *tx = chk.lease("radio_tx", RADIO_TX, 0x44U, t);
+                    uint8_t *anim = chk.lease("anim", SCENES, 0xA5U, t);
+                    refused += (tx == nullptr) ? 1U : 0U;
+                    refused += (anim == nullptr) ? 1U : 0U;
+                    chk.release(tx, t + 80U);
+                    chk.release(anim, t + 200U);
+                }
+                chk.release(rx, t + len);
+                break;
+            }
+            }
+            t += len + within(500U, 20000U);
+        }
+
+        // Leaving mid-capture: the ring is still held during the transition.
+        if (app == App::NET_FORENSICS && (rng() & 1U) != 0U)
+        {
+            uint8_t *ring = chk.lease("nf_ring", NF_RING, 0x11U, t);
+            uint8_t *anim = chk.lease("anim", SCENES, 0xA5U, t);
+            refused += (ring == nullptr || anim == nullptr) ? 1U : 0U;
+            chk.release(ring, t + 150U);
+            chk.release(anim, t + 200U);
+        }
+        now = t;
+    }
+
+    std::printf("Sessions: %u h, %u app switches, capacity %zu B (static before: %zu B, saves %zu B)\n",
+                hours, switches, CAPACITY, STATIC_BEFORE, STATIC_BEFORE - CAPACITY);
+    std::printf("  %-10s %8s %6s %9s %11s\n", "tag", "leases", "fails", "peak B", "max hold s");
+    for (size_t i = 0U; i < ScratchArena::MAX_TAGS; ++i)
+    {
+        const ScratchArena::TagStats &ts = arena.tagStats(i);
+        if (ts.tag == nullptr)
+        {
+            continue;
+        }
+        std::printf("  %-10s %8u %6u %9u %11.1f\n", ts.tag, ts.leases, ts.failures,
+                    ts.peakBytes, ts.maxHoldMs / 1000.0);
+    }
+    std::printf("  arena peak %zu / %zu B, refused %u, corrupt %u, misaligned %u, left %zu B\n",
+                arena.peak(), arena.capacity(), refused, chk.corrupt, chk.misaligned,
+                arena.used());
+
+    const bool ok = refused == 0U && chk.corrupt == 0U && chk.misaligned == 0U &&
+                    arena.used() == 0U && arena.leases() == 0U;
+    std::printf("  %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// ── 2. Fragmentation ─────────────────────────────────────────────────────────
+
+bool runFragmentation()
+{
+    alignas(ScratchArena::ALIGN) static uint8_t block[CAPACITY];
+    ScratchArena arena(block, CAPACITY);
+    Checked chk{arena, {}, 0U, 0U};
+    std::mt19937 rng(7U);
+
+    uint32_t attempts = 0U;
+    uint32_t refusedFull = 0U;   // not enough free bytes or lease slots
+    uint32_t refusedFrag = 0U;   // enough bytes, no single gap
+    for (uint32_t step = 0U; step < 200000U; ++step)
+    {
+        if (!chk.live.empty() && (rng() % 100U) < 45U)
+        {
+            chk.release(chk.live[rng() % chk.live.size()].ptr, step);
+            continue;
+        }
+        const size_t bytes = 16U + rng() % 3000U;
+        ++attempts;
+        const size_t freeBytes = arena.capacity() - arena.used();
+        const bool slot = arena.leases() < ScratchArena::MAX_LEASES;
+        const bool fitsFree = slot && ScratchArena::footprint(bytes) <= freeBytes;
+        const bool fitsGap = ScratchArena::footprint(bytes) <= arena.largestFree();
+        uint8_t *p = chk.lease("rand", bytes, static_cast<uint8_t>(step), step);
+        if (p == nullptr)
+        {
+            refusedFrag += fitsFree ? 1U : 0U;
+            refusedFull += fitsFree ? 0U : 1U;
+        }
+        if ((p != nullptr) != fitsGap)
+        {
+            ++chk.corrupt;   // largestFree() disagrees with lease()
+        }
+    }
+    while (!chk.live.empty())
+    {
+        chk.release(chk.live.back().ptr, 0U);
+    }
+
+    std::printf("Fragmentation: %u random leases (16..3015 B), refused %.1f %% full, %.1f %% fragmented\n",
+                attempts, 100.0 * refusedFull / attempts, 100.0 * refusedFrag / attempts);
+    const bool ok = chk.corrupt == 0U && chk.misaligned == 0U && arena.used() == 0U;
+    std::printf("  corrupt %u, misaligned %u  %s\n", chk.corrupt, chk.misaligned, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// ── 3. Cost ──────────────────────────────────────────────────────────────────
+
+void runCost()
+{
+    alignas(ScratchArena::ALIGN) static uint8_t block[CAPACITY];
+    ScratchArena arena(block, CAPACITY);
+    void *held[4];
+    const char *tags[4] = {"a", "b", "c", "d"};
+    for (size_t i = 0U; i < 4U; ++i)
+    {
+        held[i] = arena.lease(tags[i], 512U, 0U);
+    }
+
+    constexpr uint32_t N = 2000000U;
+    const auto t0 = std::chrono::steady_clock::now();
+    uintptr_t sink = 0U;
+    for (uint32_t i = 0U; i < N; ++i)
+    {
+        void *p = arena.lease("hot", 1024U + (i & 255U), i);
+        sink += reinterpret_cast<uintptr_t>(p);
+        arena.release(p, i);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    for (void *p : held)
+    {
+        arena.release(p, 0U);
+    }
+    std::printf("Cost: lease + release with 4 live leases: %.1f ns (host)%s\n", ns / N,
+                (sink == 1U) ? " " : "");
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = runSessions(48U);
+    ok &= runFragmentation();
+    runCost();
+    std::printf("%s\n", ok ? "all ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file spi_arbiter_bench.cpp
+ * @brief Host tool: SD / PN532 sharing of the SPI bus under SpiArbiter.
+ *
+ * Discrete-event model of the VSPI traffic, one simulated process per
+ * device driving the real SpiArbiter:
+ *
+ *  - SD: a 16 KiB capture flush every ~100 ms, 1.5 ms per 512-byte sector
+ *    (4 MHz clock plus card busy time)
+ *  - PN532: every ~300 ms, alternately an InListPassiveTarget that waits
+ *    out its 200 ms timeout on an empty field, and a card that is
+ *    selected (5 ms) and read with 16 InDataExchange commands of 1.2 ms
+ *    on the bus and 0.3 ms of CPU between them
+ *
+ * Three set-ups over 60 simulated seconds:
+ *
+ *  - mutex    – one priority, no deadlines, whole transfers (a FIFO mutex)
+ *  - priority – BusPriority / deadline hints, still whole transfers
+ *  - sliced   – as on the device: SD writes yield between sectors when
+ *               contended, the card search polls in 20 ms slices
+ *
+ * Reported: NFC exchange wait (p50 / p99 / max) and deadline misses, the
+ * longest SD wait, SD flush latency p99 and throughput, bus utilisation,
+ * and the arbiter's own histogram of NFC waits.  Required for "sliced":
+ * no exchange waits longer than one SD sector or misses its deadline,
+ * and the SD moves at least 95 % of the mutex set-up's bytes.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/spi_arbiter_bench.cpp \
+ *      src/core/spi_arbiter.cpp -o spi_arbiter_bench
+ *  ./spi_arbiter_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "core/spi_arbiter.h"
+
+using hackos::core::BusPriority;
+using hackos::core::SpiArbiter;
+
+namespace
+{
+
+constexpr uint32_t SIM_US = 60U * 1000U * 1000U;
+constexpr uint32_t SECTOR_US = 1500U;
+constexpr uint32_t SECTOR_BYTES = 512U;
+constexpr uint32_t FLUSH_SECTORS = 32U;
+constexpr uint32_t EXCHANGE_US = 1200U;
+constexpr uint32_t EXCHANGE_GAP_US = 300U;
+constexpr uint32_t EXCHANGES = 16U;
+constexpr uint32_t EXCHANGE_BUDGET_US = 2000U;
+constexpr uint32_t SEARCH_US = 200000U;
+constexpr uint32_t SEARCH_SLICE_US = 20000U;
+constexpr uint32_t SELECT_US = 5000U;
+constexpr uint8_t SD = 0U;
+constexpr uint8_t NFC = 1U;
+
+enum class Setup
+{
+    MUTEX,
+    PRIORITY,
+    SLICED,
+};
+
+/// One bus hold of a job.
+struct Hold
+{
+    BusPriority prio;
+    uint32_t budgetUs;
+    uint32_t us;
+    uint32_t gapUs;       ///< CPU time before the next hold
+    bool sameLease;       ///< Slice of the previous hold's lease (kept unless contended)
+    bool exchange;        ///< Counted as an NFC exchange
+};
+
+using Job = std::vector<Hold>;
+
+/// One simulated device: periodic jobs, cycling through @c jobs.
+struct Proc
+{
+    enum class State
+    {
+        IDLE,      ///< Until the next job arrives
+        GAP,       ///< CPU time between two holds
+        WAITING,   ///< Queued on the arbiter
+        HOLDING,
+    };
+
+    uint8_t client;
+    uint32_t periodUs;
+    std::vector<Job> jobs;
+
+    State state;
+    uint32_t eventUs;    ///< Next arrival / gap end / hold end
+    int ticket;
+    size_t job;
+    size_t hold;
+    uint32_t jobUs;      ///< Arrival of the running job
+    uint32_t requestUs;
+
+    uint32_t jobsDone;
+    uint32_t heldUs;
+    std::vector<uint32_t> exchangeWaits;
+    std::vector<uint32_t> latencies;
+};
+
+uint32_t percentile(std::vector<uint32_t> v, double q)
+{
+    if (v.empty())
+    {
+        return 0U;
+    }
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>(q * static_cast<double>(v.size() - 1U))];
+}
+
+uint32_t maxOf(const std::vector<uint32_t> &v)
+{
+    return v.empty() ? 0U : *std::max_element(v.begin(), v.end());
+}
+
+/// @p count holds of @p us each; slices after the first keep the lease if
+/// @p sameLease.
+void addHolds(Job &job, size_t count, BusPriority prio, uint32_t budgetUs, uint32_t us,
+              uint32_t gapUs, bool sameLease, bool exchange)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        job.push_back({prio, budgetUs, us, gapUs, sameLease && i > 0U, exchange});
+    }
+}
+
+class Sim
+{
+public:
+    explicit Sim(Setup setup) : rng_(7U), now_(0U)
+    {
+        const bool prio = setup != Setup::MUTEX;
+        const bool sliced = setup == Setup::SLICED;
+        const BusPriority latency = prio ? BusPriority::LATENCY : BusPriority::BULK;
+        const uint32_t budget = prio ? EXCHANGE_BUDGET_US : 0U;
+
+        // SD: one capture buffer flush, sector by sector under one lease.
+        Job flush;
+        addHolds(flush, sliced ? FLUSH_SECTORS : 1U, BusPriority::BULK, 0U,
+                 sliced ? SECTOR_US : SECTOR_US * FLUSH_SECTORS, 0U, true, false);
+        procs_.push_back(makeProc(SD, 100000U, {flush}, 3000U));
+
+        // NFC: alternately an empty field (search times out) and a card
+        // that is found and read.
+        Job empty;
+        addHolds(empty, sliced ? SEARCH_US / SEARCH_SLICE_US : 1U, BusPriority::BULK, 0U,
+                 sliced ? SEARCH_SLICE_US : SEARCH_US, 0U, false, false);
+        Job card;
+        addHolds(card, 1U, BusPriority::BULK, 0U, SELECT_US, EXCHANGE_GAP_US, false, false);
+        addHolds(card, EXCHANGES, latency, budget, EXCHANGE_US, EXCHANGE_GAP_US, false, true);
+        procs_.push_back(makeProc(NFC, 300000U, {empty, card}, 17000U));
+    }
+
+    void run()
+    {
+        while (now_ < SIM_US)
+        {
+            uint32_t next = UINT32_MAX;
+            for (const Proc &p : procs_)
+            {
+                if (p.state != Proc::State::WAITING)
+                {
+                    next = std::min(next, p.eventUs);
+                }
+            }
+            now_ = next;
+            for (Proc &p : procs_)
+            {
+                if (p.state != Proc::State::WAITING && p.eventUs == now_)
+                {
+                    step(p);
+                }
+            }
+        }
+    }
+
+    const Proc &proc(uint8_t client) const { return procs_[client]; }
+    const SpiArbiter &arbiter() const { return arbiter_; }
+    uint32_t now() const { return now_; }
+
+private:
+    static Proc makeProc(uint8_t client, uint32_t periodUs, std::vector<Job> jobs,
+                         uint32_t firstUs)
+    {
+        Proc p{};
+        p.client = client;
+        p.periodUs = periodUs;
+        p.jobs = std::move(jobs);
+        p.state = Proc::State::IDLE;
+        p.eventUs = firstUs;
+        p.ticket = -1;
+        return p;
+    }
+
+    static const Hold &current(const Proc &p) { return p.jobs[p.job][p.hold]; }
+
+    void step(Proc &p)
+    {
+        switch (p.state)
+        {
+        case Proc::State::IDLE:
+            p.jobUs = now_;
+            p.hold = 0U;
+            request(p);
+            break;
+        case Proc::State::GAP:
+            request(p);
+            break;
+        case Proc::State::HOLDING:
+        {
+            p.heldUs += current(p).us;
+            const uint32_t gapUs = current(p).gapUs;
+            ++p.hold;
+            const bool more = p.hold < p.jobs[p.job].size();
+            if (more && current(p).sameLease && !arbiter_.contended(now_))
+            {
+                p.eventUs = now_ + current(p).us;   // next slice, same lease
+                break;
+            }
+            arbiter_.release(p.ticket, now_);
+            p.ticket = -1;
+            dispatch();
+            if (!more)
+            {
+                finishJob(p);
+            }
+            else if (gapUs > 0U)
+            {
+                p.state = Proc::State::GAP;
+                p.eventUs = now_ + gapUs;
+            }
+            else
+            {
+                request(p);
+            }
+            break;
+        }
+        case Proc::State::WAITING:
+            break;
+        }
+    }
+
+    void request(Proc &p)
+    {
+        const Hold &h = current(p);
+        p.ticket = arbiter_.request(p.client, h.prio, h.budgetUs, now_);
+        p.requestUs = now_;
+        p.state = Proc::State::WAITING;
+        dispatch();
+    }
+
+    /// Hand a free bus to the arbiter's pick.
+    void dispatch()
+    {
+        const int granted = arbiter_.grant(now_);
+        if (granted < 0)
+        {
+            return;
+        }
+        for (Proc &p : procs_)
+        {
+            if (p.state == Proc::State::WAITING && p.ticket == granted)
+            {
+                p.state = Proc::State::HOLDING;
+                p.eventUs = now_ + current(p).us;
+                if (current(p).exchange)
+                {
+                    p.exchangeWaits.push_back(now_ - p.requestUs);
+                }
+                return;
+            }
+        }
+    }
+
+    void finishJob(Proc &p)
+    {
+        p.latencies.push_back(now_ - p.jobUs);
+        ++p.jobsDone;
+        p.job = (p.job + 1U) % p.jobs.size();
+        // Next arrival one period after this one, ±10 %, never in the past.
+        const uint32_t jitter = static_cast<uint32_t>(rng_() % (p.periodUs / 5U));
+        const uint32_t due = p.jobUs + p.periodUs - p.periodUs / 10U + jitter;
+        p.state = Proc::State::IDLE;
+        p.eventUs = std::max(due, now_ + 1U);
+    }
+
+    std::mt19937 rng_;
+    uint32_t now_;
+    SpiArbiter arbiter_;
+    std::vector<Proc> procs_;
+};
+
+struct Result
+{
+    uint32_t exchangeMax;
+    uint32_t misses;
+    uint64_t sdBytes;
+};
+
+Result runSetup(const char *label, Setup setup)
+{
+    Sim sim(setup);
+    sim.run();
+    const Proc &sd = sim.proc(SD);
+    const Proc &nfc = sim.proc(NFC);
+    const SpiArbiter::ClientStats &sdStats = sim.arbiter().stats(SD);
+    const SpiArbiter::ClientStats &nfcStats = sim.arbiter().stats(NFC);
+    const uint64_t sdBytes = static_cast<uint64_t>(sd.heldUs / SECTOR_US) * SECTOR_BYTES;
+
+    std::printf("%-9s exchange wait p50 %6u p99 %6u max %6u us  misses %3u | "
+                "SD wait max %6u us  flush p99 %6u us  %5.1f KiB/s | bus %4.1f%%\n",
+                label, percentile(nfc.exchangeWaits, 0.5), percentile(nfc.exchangeWaits, 0.99),
+                maxOf(nfc.exchangeWaits), nfcStats.deadlineMisses, sdStats.maxWaitUs,
+                percentile(sd.latencies, 0.99), sdBytes / 1024.0 / (sim.now() / 1e6),
+                sim.arbiter().utilisationPermille(sim.now()) / 10.0);
+
+    std::printf("          NFC wait histogram (us):");
+    for (size_t b = 0U; b < SpiArbiter::HIST_BUCKETS; ++b)
+    {
+        if (nfcStats.waitHist[b] != 0U)
+        {
+            if (b + 1U < SpiArbiter::HIST_BUCKETS)
+            {
+                std::printf(" <%u:%u", SpiArbiter::bucketLimitUs(b), nfcStats.waitHist[b]);
+            }
+            else
+            {
+                std::printf(" more:%u", nfcStats.waitHist[b]);
+            }
+        }
+    }
+    std::printf("\n");
+    return {maxOf(nfc.exchangeWaits), nfcStats.deadlineMisses, sdBytes};
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("60 s: SD 16 KiB flush / 100 ms; NFC every 300 ms alternately a 200 ms "
+                "empty-field search and a card read (%u exchanges)\n", EXCHANGES);
+    const Result mutex = runSetup("mutex", Setup::MUTEX);
+    (void)runSetup("priority", Setup::PRIORITY);
+    const Result sliced = runSetup("sliced", Setup::SLICED);
+
+    const bool latencyOk = sliced.exchangeMax <= SECTOR_US && sliced.misses == 0U;
+    const bool throughputOk = sliced.sdBytes * 100U >= mutex.sdBytes * 95U;
+    std::printf("sliced: exchange wait %s, SD throughput %s\n",
+                latencyOk ? "ok" : "FAIL", throughputOk ? "ok" : "FAIL");
+    return (latencyOk && throughputOk) ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file time_series_bench.cpp
+ * @brief Host tool: rollup accuracy, chart resolution and LTTB of TimeSeries.
+ *
+ * Feeds 8 h of a synthetic voltmeter trace (slow drift, ripple, short
+ * spikes; one sample per 50 ms like HardwareBridge) into the 7 × 128,
+ * factor 4 store and checks:
+ *
+ *  - every level's min / max / mean against a direct computation
+ *  - envelope() returns pixel-resolution columns for 6 s .. 6 h spans and
+ *    every spike in the span shows up in some column's max
+ *  - downsample() keeps both ends and the tallest spike
+ *  - push() and envelope() cost per call
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/time_series_bench.cpp \
+ *      src/core/time_series.cpp -o time_series_bench
+ *  ./time_series_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "core/time_series.h"
+
+using hackos::core::TimeSeriesBuffer;
+using hackos::core::TsBucket;
+using hackos::core::TsPoint;
+
+namespace
+{
+
+constexpr uint32_t PERIOD_MS = 50U;
+constexpr uint8_t FACTOR = 4U;
+constexpr size_t LEVELS = 7U;
+constexpr size_t CAPACITY = 128U;
+constexpr size_t WIDTH = 128U;
+
+using Series = TimeSeriesBuffer<LEVELS, CAPACITY>;
+
+std::vector<int16_t> makeTrace(size_t count, std::vector<size_t> *spikes)
+{
+    std::mt19937 rng(7U);
+    std::vector<int16_t> v(count);
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const double drift = 2000.0 + 600.0 * std::sin(static_cast<double>(i) / 40000.0);
+        const double ripple = 40.0 * std::sin(static_cast<double>(i) / 3.0);
+        v[i] = static_cast<int16_t>(drift + ripple + static_cast<double>(rng() % 21U) - 10.0);
+        if (rng() % 5000U == 0U)
+        {
+            v[i] = 4000;
+            spikes->push_back(i);
+        }
+    }
+    return v;
+}
+
+bool checkRollups(const Series &ts, const std::vector<int16_t> &trace)
+{
+    bool ok = true;
+    for (size_t level = 0U; ok && level < ts.levels(); ++level)
+    {
+        size_t span = 1U;
+        for (size_t k = 0U; k < level; ++k)
+        {
+            span *= FACTOR;
+        }
+        const size_t complete = trace.size() / span;
+        // Means are rounded per level, so allow one count per rollup step.
+        for (size_t age = 0U; ok && age < ts.count(level); ++age)
+        {
+            const size_t first = (complete - 1U - age) * span;
+            int16_t mn = trace[first];
+            int16_t mx = trace[first];
+            double sum = 0.0;
+            for (size_t i = first; i < first + span; ++i)
+            {
+                mn = std::min(mn, trace[i]);
+                mx = std::max(mx, trace[i]);
+                sum += trace[i];
+            }
+            const TsBucket &b = ts.at(level, age);
+            ok = b.min == mn && b.max == mx &&
+                 std::fabs(b.mean - sum / static_cast<double>(span)) <= static_cast<double>(level) + 0.5;
+        }
+    }
+    std::printf("rollups: %zu levels x %zu buckets = %zu B, %u min history  %s\n",
+                ts.levels(), ts.capacity(), ts.levels() * ts.capacity() * sizeof(TsBucket),
+                static_cast<unsigned>(ts.historyMs() / 60000U), ok ? "ok" : "FAIL");
+    return ok;
+}
+
+bool checkEnvelope(const Series &ts, size_t total, const std::vector<size_t> &spikes)
+{
+    bool ok = true;
+    for (uint32_t spanMs : {6400U, 60000U, 600000U, 3600000U, 6U * 3600000U})
+    {
+        std::vector<TsBucket> cols(WIDTH);
+        const size_t n = ts.envelope(spanMs, cols.data(), WIDTH);
+        // A spike well inside the span must reach 4000 in some column; the
+        // margin skips the newest coarse bucket that has not rolled up yet.
+        constexpr size_t MARGIN = 4096U; // FACTOR^(LEVELS-1)
+        const size_t spanSamples = spanMs / PERIOD_MS;
+        size_t inside = 0U;
+        size_t seen = 0U;
+        for (size_t s : spikes)
+        {
+            const size_t age = total - 1U - s;
+            inside += (age >= MARGIN && age + MARGIN < spanSamples) ? 1U : 0U;
+        }
+        for (size_t c = 0U; c < n; ++c)
+        {
+            seen += (cols[c].max >= 4000) ? 1U : 0U;
+        }
+        const bool thisOk = n == WIDTH && (inside == 0U || seen > 0U);
+        std::printf("  envelope %6lus: %zu columns, %zu spike columns  %s\n",
+                    static_cast<unsigned long>(spanMs / 1000U), n, seen, thisOk ? "ok" : "FAIL");
+        ok = ok && thisOk;
+    }
+    return ok;
+}
+
+bool checkLttb(const Series &ts)
+{
+    std::vector<TsPoint> pts(100U);
+    const size_t n = ts.downsample(3600000U, pts.data(), pts.size());
+    bool ok = n >= 32U && n <= pts.size() && pts[n - 1U].ageMs == 0U;
+    for (size_t i = 1U; ok && i < n; ++i)
+    {
+        ok = pts[i].ageMs < pts[i - 1U].ageMs;
+    }
+    std::printf("lttb 1 h -> %zu points, oldest %lus  %s\n", n,
+                static_cast<unsigned long>(pts[0].ageMs / 1000U), ok ? "ok" : "FAIL");
+
+    // A lone spike in an otherwise flat series must survive the reduction.
+    Series flat(PERIOD_MS, FACTOR);
+    for (int i = 0; i < 128; ++i)
+    {
+        flat.push(static_cast<int16_t>(i == 77 ? 3000 : 1000));
+    }
+    const size_t m = flat.downsample(6400U, pts.data(), 20U);
+    bool spike = false;
+    for (size_t i = 0U; i < m; ++i)
+    {
+        spike = spike || pts[i].value == 3000;
+    }
+    std::printf("lttb keeps spike in 128 -> %zu points  %s\n", m, spike ? "ok" : "FAIL");
+    return ok && spike;
+}
+
+} // namespace
+
+int main()
+{
+    const size_t total = 8U * 3600U * 1000U / PERIOD_MS;
+    std::vector<size_t> spikes;
+    const std::vector<int16_t> trace = makeTrace(total, &spikes);
+
+    Series ts(PERIOD_MS, FACTOR);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int16_t v : trace)
+    {
+        ts.push(v);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    bool ok = checkRollups(ts, trace);
+    ok &= checkEnvelope(ts, total, spikes);
+    ok &= checkLttb(ts);
+
+    TsBucket cols[WIDTH];
+    constexpr int RENDERS = 2000;
+    const auto t2 = std::chrono::steady_clock::now();
+    for (int i = 0; i < RENDERS; ++i)
+    {
+        (void)ts.envelope(3600000U, cols, WIDTH);
+    }
+    const auto t3 = std::chrono::steady_clock::now();
+    std::printf("push %.1f ns, envelope %.2f us (host)\n",
+                std::chrono::duration<double, std::nano>(t1 - t0).count() / total,
+                std::chrono::duration<double, std::micro>(t3 - t2).count() / RENDERS);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file transition_log_bench.cpp
+ * @brief Host tool: transition log density, encoder cost and drop
+ *        accounting on bursty SPI.
+ *
+ *  1. Bursty SPI (CLK, MOSI, CS; 8 samples per half clock, idle gaps of
+ *     2k-200k samples) fed through TransitionEncoder::feed() in 4 KiB
+ *     blocks and through edge() the way GpioSampler calls it.  Every edge
+ *     must read back with its exact tick, and the MOSI bytes decoded from
+ *     the rising CLK edges must match the bytes sent.  Reports samples per
+ *     byte, bytes per edge and ns per sample.
+ *  2. Drops: the same stream into a 64-byte ring drained by a slow
+ *     consumer.  records + dropped must equal the edges offered, bytes
+ *     drained must equal stats().bytes, and every surviving record must
+ *     carry the exact tick at which the port entered its state.
+ *  3. Keep-alive: edges 3.5 × 2^30 samples apart still decode to the right
+ *     absolute tick.
+ *
+ * @code
+ *  g++ -std=gnu++17 -O2 -Iinclude tools/transition_log_bench.cpp \
+ *      src/hardware/logic/transition_log.cpp -o transition_log_bench
+ *  ./transition_log_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "hardware/logic/transition_log.h"
+#include "host/bench_check.h"
+
+using hackos::bench::finish;
+using hackos::bench::require;
+using hackos::logic::LogicEdge;
+using hackos::logic::TransitionEncoder;
+using hackos::logic::TransitionReader;
+using hackos::logic::TransitionRing;
+using hackos::logic::TransitionStats;
+
+namespace
+{
+
+constexpr uint8_t CLK = 0x01U;
+constexpr uint8_t MOSI = 0x02U;
+constexpr uint8_t CS = 0x04U; ///< Active low
+constexpr uint32_t HALF_CLOCK = 8U;
+constexpr size_t TOTAL_SAMPLES = 5000000U;
+constexpr size_t BLOCK = 4096U;
+
+struct Capture
+{
+    std::vector<uint8_t> samples;
+    std::vector<uint8_t> bytes;   ///< MOSI bytes sent
+    std::vector<uint32_t> edges;  ///< Ticks where the port state changes
+};
+
+Capture bursty(uint32_t seed)
+{
+    Capture c;
+    c.samples.reserve(TOTAL_SAMPLES);
+    std::mt19937 rng(seed);
+    uint8_t state = CS;
+
+    auto hold = [&](uint32_t n) {
+        for (uint32_t i = 0U; i < n && c.samples.size() < TOTAL_SAMPLES; ++i)
+        {
+            c.samples.push_back(state);
+        }
+    };
+
+    while (c.samples.size() < TOTAL_SAMPLES)
+    {
+        hold(2000U + rng() % 198000U);
+        state = static_cast<uint8_t>(state & ~CS);
+        hold(HALF_CLOCK);
+        const uint32_t count = 1U + rng() % 8U;
+        for (uint32_t n = 0U; n < count && c.samples.size() < TOTAL_SAMPLES; ++n)
+        {
+            const uint8_t value = static_cast<uint8_t>(rng());
+            for (int bit = 7; bit >= 0; --bit)
+            {
+                state = static_cast<uint8_t>(((value >> bit) & 1U) ? (state | MOSI)
+                                                                    : (state & ~MOSI));
+                hold(HALF_CLOCK);
+                state = static_cast<uint8_t>(state | CLK);
+                hold(HALF_CLOCK);
+                state = static_cast<uint8_t>(state & ~CLK);
+            }
+            if (c.samples.size() < TOTAL_SAMPLES)
+            {
+                c.bytes.push_back(value);
+            }
+        }
+        hold(HALF_CLOCK);
+        state = static_cast<uint8_t>(state | CS);
+    }
+
+    for (size_t i = 1U; i < c.samples.size(); ++i)
+    {
+        if (c.samples[i] != c.samples[i - 1U])
+        {
+            c.edges.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return c;
+}
+
+/// MOSI bytes from the rising CLK edges while CS is low (MSB first).
+class SpiDecode
+{
+public:
+    void feed(const LogicEdge &e)
+    {
+        if ((e.state & CS) != 0U)
+        {
+            bits_ = 0U;
+            return;
+        }
+        if ((e.changed & CLK) != 0U && (e.state & CLK) != 0U)
+        {
+            shift_ = static_cast<uint8_t>((shift_ << 1) | ((e.state & MOSI) ? 1U : 0U));
+            if (++bits_ == 8U)
+            {
+                bytes.push_back(shift_);
+                bits_ = 0U;
+            }
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+
+private:
+    uint8_t shift_ = 0U;
+    uint8_t bits_ = 0U;
+};
+
+double nsPerSample(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double, std::nano>(d).count() /
+           static_cast<double>(TOTAL_SAMPLES);
+}
+
+// ── 1. Density and cost ──────────────────────────────────────────────────────
+
+void density(const Capture &c)
+{
+    std::printf("\n-- bursty SPI: %zu samples, %zu edges, %zu bytes on MOSI --\n",
+                c.samples.size(), c.edges.size(), c.bytes.size());
+    std::printf("  %-8s %8s %8s %10s %10s %8s %s\n", "path", "records", "bytes",
+                "samples/B", "bytes/edge", "ns/smp", "decoded");
+
+    // Big enough for the whole capture, so only the encoder is timed.
+    std::vector<uint8_t> buf(65536U);
+
+    for (const bool viaFeed : {true, false})
+    {
+        TransitionRing ring;
+        require(ring.attach(buf.data(), buf.size()), "attach ring");
+        TransitionEncoder enc(ring);
+
+        auto best = std::chrono::steady_clock::duration::max();
+        for (int rep = 0; rep < 5; ++rep)
+        {
+            ring.reset();
+            const auto t0 = std::chrono::steady_clock::now();
+            enc.begin(c.samples[0]);
+            if (viaFeed)
+            {
+                for (size_t i = 0U; i < c.samples.size(); i += BLOCK)
+                {
+                    enc.feed(&c.samples[i], std::min(BLOCK, c.samples.size() - i));
+                }
+            }
+            else
+            {
+                // GpioSampler: one edge() per sample read.
+                for (size_t i = 0U; i < c.samples.size(); ++i)
+                {
+                    enc.edge(static_cast<uint32_t>(i), c.samples[i]);
+                }
+            }
+            best = std::min(best, std::chrono::steady_clock::now() - t0);
+        }
+
+        const TransitionStats st = enc.stats();
+        TransitionReader reader(ring);
+        SpiDecode spi;
+        LogicEdge e;
+        size_t n = 0U;
+        bool exact = reader.next(&e) && e.tick == 0U && e.state == c.samples[0];
+        while (reader.next(&e))
+        {
+            exact = exact && n < c.edges.size() && e.tick == c.edges[n] &&
+                    e.state == c.samples[e.tick];
+            ++n;
+            spi.feed(e);
+        }
+
+        std::printf("  %-8s %8u %8u %10.0f %10.2f %8.2f %zu/%zu\n",
+                    viaFeed ? "feed()" : "edge()", st.records, st.bytes,
+                    static_cast<double>(c.samples.size()) / st.bytes,
+                    static_cast<double>(st.bytes) / static_cast<double>(c.edges.size()),
+                    nsPerSample(best), spi.bytes.size(), c.bytes.size());
+
+        require(st.dropped == 0U && st.records == c.edges.size() + 1U,
+                "one record per edge plus the start record");
+        require(exact && n == c.edges.size(), "every edge reads back with its tick");
+        require(spi.bytes == c.bytes, "all MOSI bytes decode from the log");
+        // Edges inside a burst are 8 samples apart (2 bytes); each burst
+        // start costs a longer delta.
+        require(st.bytes <= 2U * st.records + 2U * (c.bytes.size() + 1U),
+                "about 2 bytes per edge");
+    }
+}
+
+// ── 2. Drop accounting ───────────────────────────────────────────────────────
+
+void drops(const Capture &c)
+{
+    std::printf("\n-- 64-byte ring, consumer drains 32 bytes every N samples --\n");
+    std::printf("  %6s %8s %8s %8s %8s %6s\n", "N", "records", "dropped", "drained", "hiwater",
+                "exact");
+
+    for (const size_t every : {size_t{64U}, size_t{256U}, size_t{1024U}, size_t{8192U}})
+    {
+        uint8_t buf[64];
+        TransitionRing ring;
+        require(ring.attach(buf, sizeof(buf)), "attach ring");
+        TransitionEncoder enc(ring);
+        TransitionReader reader(ring);
+        enc.begin(c.samples[0]);
+
+        size_t drained = 0U;
+        size_t records = 0U;
+        bool exact = true;
+        auto drain = [&](size_t maxBytes) {
+            const size_t start = ring.used();
+            LogicEdge e;
+            while (start - ring.used() < maxBytes && reader.next(&e))
+            {
+                ++records;
+                // The record marks the tick at which the port entered its
+                // state, even when intermediate states were dropped.
+                exact = exact && e.tick < c.samples.size() && c.samples[e.tick] == e.state &&
+                        (e.tick == 0U || c.samples[e.tick - 1U] != e.state);
+            }
+            drained += start - ring.used();
+        };
+
+        for (size_t i = 0U; i < c.samples.size(); i += every)
+        {
+            enc.feed(&c.samples[i], std::min(every, c.samples.size() - i));
+            drain(32U);
+        }
+        drain(SIZE_MAX);
+
+        const TransitionStats st = enc.stats();
+        std::printf("  %6zu %8u %8u %8zu %8zu %6s\n", every, st.records, st.dropped, drained,
+                    st.highWater, exact ? "yes" : "NO");
+
+        require(st.records + st.dropped == c.edges.size() + 1U,
+                "records + dropped = edges offered");
+        require(records == st.records && drained == st.bytes,
+                "the consumer sees exactly the stored records");
+        require(st.highWater <= sizeof(buf), "high water within the ring");
+        require(exact, "surviving records keep exact ticks");
+    }
+}
+
+// ── 3. Keep-alive over long idle ─────────────────────────────────────────────
+
+void keepAlive()
+{
+    std::printf("\n-- keep-alive: edges 3.5 x 2^30 samples apart --\n");
+    uint8_t buf[64];
+    TransitionRing ring;
+    require(ring.attach(buf, sizeof(buf)), "attach ring");
+    TransitionEncoder enc(ring);
+    TransitionReader reader(ring);
+
+    const uint32_t far = 3U * TransitionEncoder::KEEPALIVE_TICKS +
+                         TransitionEncoder::KEEPALIVE_TICKS / 2U;
+    enc.begin(0U);
+    for (uint32_t t = 0U; t < far; t += TransitionEncoder::KEEPALIVE_TICKS / 4U)
+    {
+        enc.keepAlive(t);
+    }
+    enc.edge(far, CLK);
+
+    LogicEdge e{};
+    LogicEdge last{};
+    size_t n = 0U;
+    while (reader.next(&e))
+    {
+        last = e;
+        ++n;
+    }
+    std::printf("  %zu records, %u bytes, last edge at tick %llu\n", n, enc.stats().bytes,
+                static_cast<unsigned long long>(last.tick));
+    require(last.tick == far && last.state == CLK && last.changed == CLK,
+            "edge after long idle keeps its absolute tick");
+    require(n == 5U, "one keep-alive record per 2^30 samples");
+}
+
+} // namespace
+
+int main()
+{
+    const Capture c = bursty(84U);
+    density(c);
+    drops(c);
+    keepAlive();
+    return finish();
+}